@@ -56,6 +56,7 @@ typedef struct {
 	u32 max_mrt_count;
 	b8 float_render_targets;
 	b8 compute_available;
+	b8 multi_draw_indirect;
 	u32 max_texture_size;
 	u32 max_texture_units;
 } se_capabilities;
@@ -9,7 +9,8 @@ typedef enum {
 	SE_EXT_FEATURE_INSTANCING = 1 << 0,
 	SE_EXT_FEATURE_MULTI_RENDER_TARGET = 1 << 1,
 	SE_EXT_FEATURE_FLOAT_RENDER_TARGET = 1 << 2,
-	SE_EXT_FEATURE_COMPUTE = 1 << 3
+	SE_EXT_FEATURE_COMPUTE = 1 << 3,
+	SE_EXT_FEATURE_MULTI_DRAW_INDIRECT = 1 << 4
 } se_ext_feature;
 
 extern const char *se_ext_feature_name(const se_ext_feature feature);
@@ -12,12 +12,39 @@ typedef struct { s_vec2 position; f32 radius; } se_circle;
 // 3D
 typedef struct { s_vec3 min, max; } se_box_3d;
 typedef struct { s_vec3 position; f32 radius; } se_sphere;
+// Planes as (normal, distance) with normals pointing inside: left, right, bottom, top, near, far.
+typedef struct { s_vec4 planes[6]; } se_frustum;
 
 extern void se_box_2d_make(se_box_2d *out_box, const s_mat3 *transform);
 extern b8 se_box_2d_is_inside(const se_box_2d *a, const s_vec2 *p);
 extern b8 se_box_2d_intersects(const se_box_2d *a, const se_box_2d *b);
+// `points` is a closed polygon (last vertex joins the first), convex or not.
+extern b8 se_box_2d_intersects_polygon(const se_box_2d *box, const s_vec2 *points, const u32 point_count);
 extern b8 se_box_3d_intersects(const se_box_3d *a, const se_box_3d *b);
 extern b8 se_circle_intersects(const se_circle *a, const se_circle *b);
 extern b8 se_sphere_intersects(const se_sphere *a, const se_sphere *b);
+extern void se_box_3d_transform(se_box_3d *out_box, const se_box_3d *box, const s_mat4 *transform);
+extern void se_box_3d_merge(se_box_3d *out_box, const se_box_3d *box);
+// Extracts the planes of a GL clip volume (-w <= x, y, z <= w) from a view-projection matrix.
+extern void se_frustum_from_matrix(se_frustum *out_frustum, const s_mat4 *view_projection);
+// Conservative: boxes straddling a frustum corner may be reported as intersecting.
+extern b8 se_frustum_intersects_box_3d(const se_frustum *frustum, const se_box_3d *box);
+// Near face then far face, each as left-bottom, right-bottom, right-top, left-top. False when
+// the planes do not close a volume.
+extern b8 se_frustum_get_corners(const se_frustum *frustum, s_vec3 out_corners[8]);
+
+// Shadows
+#define SE_SHADOW_MAX_CASCADES 4
+
+// Writes `cascade_count + 1` view distances from `near` to `far`. `lambda` blends uniform (0)
+// and logarithmic (1) spacing.
+extern b8 se_shadow_cascade_splits(const f32 near, const f32 far, const u32 cascade_count, const f32 lambda, f32 *out_splits);
+// Orthographic light view-projection around the bounding sphere of `corners`. The sphere keeps
+// the size fixed as the camera turns and the center is snapped to whole texels of a
+// `resolution` map, so shadow edges do not shimmer. `caster_distance` extends the volume
+// toward the light for casters outside the corners.
+extern b8 se_shadow_fit_directional(const s_vec3 corners[8], const s_vec3 *light_direction, const u32 resolution, const f32 caster_distance, s_mat4 *out_view_projection);
+// Perspective light view-projection for a spot cone; `cone_angle` is the full angle in radians.
+extern b8 se_shadow_fit_spot(const s_vec3 *position, const s_vec3 *direction, const f32 cone_angle, const f32 near, const f32 range, s_mat4 *out_view_projection);
 
 #endif // SE_MATH_H
@@ -7,6 +7,7 @@
 #include "se_shader.h"
 #include "se_quad.h"
 #include "se_camera.h"
+#include "se_math.h"
 
 typedef enum {
 	SE_MESH_DATA_NONE = 0,
@@ -35,6 +36,9 @@ typedef struct {
 	se_shader_handle shader;
 	s_mat4 matrix;
 	se_mesh_data_flags data_flags;
+	// Vertex positions in mesh space, before `matrix`.
+	se_box_3d bounds;
+	b8 has_bounds;
 } se_mesh;
 typedef s_array(se_mesh, se_meshes);
 
@@ -60,6 +64,9 @@ extern void se_model_rotate(const se_model_handle model, const s_vec3 *v);
 extern void se_model_scale(const se_model_handle model, const s_vec3 *v);
 extern sz se_model_get_mesh_count(const se_model_handle model);
 extern se_shader_handle se_model_get_mesh_shader(const se_model_handle model, const sz mesh_index);
+// Union of the mesh bounds after each mesh's matrix; false when no mesh has bounds.
+extern b8 se_model_get_bounds(const se_model_handle model, se_box_3d *out_bounds);
+extern void se_mesh_compute_bounds(se_mesh *mesh);
 extern b8 se_mesh_has_cpu_data(const se_mesh *mesh);
 extern b8 se_mesh_has_gpu_data(const se_mesh *mesh);
 extern void se_mesh_discard_cpu_data(se_mesh *mesh);
@@ -4,6 +4,7 @@
 #define SE_RENDER_FRAME_H
 
 #include "se.h"
+#include "se_render_thread.h"
 
 typedef struct {
 	u64 submitted_frames;
@@ -12,9 +13,21 @@ typedef struct {
 	u32 queue_depth;
 	u64 last_command_count;
 	u64 last_command_bytes;
+	u32 last_secondary_packets;
+	u64 last_secondary_command_count;
 	f64 last_submit_wait_ms;
 	f64 last_execute_ms;
 	f64 last_present_ms;
+	// Submit-to-present time of the last presented frame.
+	f64 last_frame_latency_ms;
+	u32 packet_count;
+	u32 max_frames_in_flight;
+	f64 packet_execute_ms[SE_RENDER_THREAD_MAX_PACKET_COUNT];
+	f64 packet_latency_ms[SE_RENDER_THREAD_MAX_PACKET_COUNT];
+	se_render_thread_command_stats last_command_stats[SE_RENDER_THREAD_COMMAND_KIND_COUNT];
+	u32 last_sync_calls;
+	f64 last_sync_stall_ms;
+	se_render_thread_pacing_stats pacing;
 } se_render_frame_stats;
 
 extern void se_render_frame_begin(se_window_handle window);
@@ -22,4 +35,98 @@ extern void se_render_frame_submit(se_window_handle window);
 extern void se_render_frame_wait_presented(se_window_handle window);
 extern b8 se_render_frame_get_stats(se_window_handle window, se_render_frame_stats* out_stats);
 
+// Binds secondary packet `slot` to the calling thread; its GL calls are recorded there until
+// se_render_frame_secondary_end. Slots are spliced into the frame in slot order at submit.
+extern b8 se_render_frame_secondary_begin(se_window_handle window, u32 slot);
+extern b8 se_render_frame_secondary_end(void);
+// Splices `slot` at the current point of the frame instead of at submit.
+extern b8 se_render_frame_execute_secondary(se_window_handle window, u32 slot);
+
+// Submission bucket: draws are pushed with a 64-bit sort key and replayed in key order on
+// flush, so their GL calls reach the frame packet grouped by state. Not thread-safe; use one
+// bucket per recording thread or pass.
+typedef struct se_render_bucket se_render_bucket;
+typedef void (*se_render_bucket_draw_fn)(const void* payload);
+
+typedef struct {
+	u32 max_draws;
+	u32 max_payload_bytes;
+} se_render_bucket_config;
+
+#define SE_RENDER_BUCKET_CONFIG_DEFAULTS ((se_render_bucket_config){ \
+	.max_draws = 4096u, \
+	.max_payload_bytes = 256u * 1024u \
+})
+
+// Key layout, high to low: layer (4 bits), pass (4), translucent flag (1), then
+// shader (16), material (20), depth (19) for opaque draws, or inverted depth (32), shader (23)
+// for translucent ones. Depth is clamped to [0, 1] (NaN counts as 0): opaque sorts front to back,
+// translucent back to front, and translucent draws follow opaque ones of the same pass.
+extern u64 se_render_sort_key_opaque(u32 layer, u32 pass, u32 shader, u32 material, f32 depth);
+extern u64 se_render_sort_key_translucent(u32 layer, u32 pass, f32 depth, u32 shader);
+extern b8 se_render_sort_key_is_translucent(u64 key);
+
+extern se_render_bucket* se_render_bucket_create(const se_render_bucket_config* config);
+extern void se_render_bucket_destroy(se_render_bucket* bucket);
+// Copies `payload_bytes` of `payload`; `fn` receives the copy when the bucket is flushed.
+extern b8 se_render_bucket_push(se_render_bucket* bucket, u64 key, se_render_bucket_draw_fn fn, const void* payload, u32 payload_bytes);
+// Radix-sorts the pushed draws by key (stable for equal keys), runs them, then empties the bucket.
+extern b8 se_render_bucket_flush(se_render_bucket* bucket);
+extern void se_render_bucket_clear(se_render_bucket* bucket);
+extern u32 se_render_bucket_get_count(const se_render_bucket* bucket);
+
+// Mesh batcher: meshes are laid out back to back in shared vertex and index arenas and draws
+// become indirect commands, grouped by shader in first-use order. Draws of the same mesh and
+// shader merge into one command with consecutive instances. Pure CPU, no GL calls.
+typedef struct se_draw_batcher se_draw_batcher;
+
+// Same layout as GL's DrawElementsIndirectCommand.
+typedef struct {
+	u32 count;
+	u32 instance_count;
+	u32 first_index;
+	i32 base_vertex;
+	u32 base_instance;
+} se_draw_indirect_command;
+
+typedef struct {
+	u64 key;
+	u32 vertex_count;
+	u32 index_count;
+	u32 first_vertex;
+	u32 first_index;
+} se_draw_batch_mesh;
+
+typedef struct {
+	u64 shader;
+	u32 first_command;
+	u32 command_count;
+	u32 instance_count;
+} se_draw_batch;
+
+typedef struct {
+	u32 max_meshes;
+	u32 max_draws;
+} se_draw_batcher_config;
+
+#define SE_DRAW_BATCHER_CONFIG_DEFAULTS ((se_draw_batcher_config){ \
+	.max_meshes = 1024u, \
+	.max_draws = 4096u \
+})
+
+extern se_draw_batcher* se_draw_batcher_create(const se_draw_batcher_config* config);
+extern void se_draw_batcher_destroy(se_draw_batcher* batcher);
+// Returns the arena slot of `key`, adding it after the existing meshes; UINT32_MAX when full.
+extern u32 se_draw_batcher_add_mesh(se_draw_batcher* batcher, u64 key, u32 vertex_count, u32 index_count);
+// `user` is handed back by se_draw_batcher_get_draw_order in instance order.
+extern b8 se_draw_batcher_add_draw(se_draw_batcher* batcher, u64 shader, u32 mesh, u32 instance_count, u32 user);
+extern b8 se_draw_batcher_build(se_draw_batcher* batcher);
+extern const se_draw_batch_mesh* se_draw_batcher_get_meshes(const se_draw_batcher* batcher, u32* out_count, u32* out_vertex_total, u32* out_index_total);
+extern const se_draw_indirect_command* se_draw_batcher_get_commands(const se_draw_batcher* batcher, u32* out_count);
+extern const se_draw_batch* se_draw_batcher_get_batches(const se_draw_batcher* batcher, u32* out_count);
+extern const u32* se_draw_batcher_get_draw_order(const se_draw_batcher* batcher, u32* out_count);
+// Drops the draws; meshes stay so their arena offsets remain valid across frames.
+extern void se_draw_batcher_clear_draws(se_draw_batcher* batcher);
+extern void se_draw_batcher_clear(se_draw_batcher* batcher);
+
 #endif // SE_RENDER_FRAME_H
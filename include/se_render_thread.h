@@ -4,23 +4,102 @@
 #define SE_RENDER_THREAD_H
 
 #include "se.h"
+#include "se_defines.h"
 
 #define SE_RENDER_THREAD_NULL S_HANDLE_NULL
 
+#define SE_RENDER_THREAD_MIN_PACKET_COUNT 2u
+#define SE_RENDER_THREAD_MAX_PACKET_COUNT 4u
+#define SE_RENDER_THREAD_CAPTURE_MAX_COMMAND_TYPES 128u
+
 typedef s_handle se_render_thread_handle;
 
+typedef enum {
+	// One frame in flight; extra packets only let recording start before the previous present.
+	SE_RENDER_THREAD_MODE_LOW_LATENCY = 0,
+	// Up to packet_count - 1 frames in flight, trading latency for fewer submit stalls.
+	// Submit never waits for present in this mode, whatever `wait_on_submit` says.
+	SE_RENDER_THREAD_MODE_THROUGHPUT
+} se_render_thread_mode;
+
+typedef enum {
+	// Frames in flight come from `mode` and the producer blocks per `wait_on_submit`.
+	SE_RENDER_THREAD_PACING_FIXED = 0,
+	// Never blocks on present; at most `target_frames_in_flight` frames are queued.
+	SE_RENDER_THREAD_PACING_FRAMES_IN_FLIGHT,
+	// Re-picks frames in flight each submit from smoothed producer and render-thread frame
+	// times so that the estimated input-to-present latency stays under `latency_budget_ms`.
+	SE_RENDER_THREAD_PACING_LATENCY_BUDGET
+} se_render_thread_pacing;
+
+// Dispatch entry points grouped by what they cost the render thread.
+typedef enum {
+	SE_RENDER_THREAD_COMMAND_DRAW = 0,
+	SE_RENDER_THREAD_COMMAND_UPLOAD,
+	SE_RENDER_THREAD_COMMAND_STATE,
+	SE_RENDER_THREAD_COMMAND_RESOURCE,
+	// Calls that fell back to a blocking round-trip instead of being recorded.
+	SE_RENDER_THREAD_COMMAND_SYNC,
+	SE_RENDER_THREAD_COMMAND_KIND_COUNT
+} se_render_thread_command_kind;
+
 typedef struct {
+	u64 count;
+	u64 payload_bytes;
+	f64 execute_ms;
+} se_render_thread_command_stats;
+
+typedef struct {
+	u32 packet_count;
+	se_render_thread_mode mode;
 	u32 max_commands_per_frame;
 	u32 max_command_bytes_per_frame;
+	u32 max_secondary_packets;
+	u32 secondary_commands_per_packet;
+	u32 secondary_command_bytes_per_packet;
+	// Blobs at least this large go to pooled blocks instead of the packet payload.
+	u32 large_block_threshold;
+	// Free block bytes kept across frames; blocks released beyond this are freed.
+	u32 block_pool_bytes;
+	// Block each submit until that frame is presented; only honoured in low-latency mode.
 	b8 wait_on_submit;
+	se_render_thread_pacing pacing;
+	// Clamped to packet_count - 1.
+	u32 target_frames_in_flight;
+	f64 latency_budget_ms;
 } se_render_thread_config;
 
 #define SE_RENDER_THREAD_CONFIG_DEFAULTS ((se_render_thread_config){ \
+	.packet_count = 2u, \
+	.mode = SE_RENDER_THREAD_MODE_LOW_LATENCY, \
 	.max_commands_per_frame = 4096u, \
 	.max_command_bytes_per_frame = 4u * 1024u * 1024u, \
-	.wait_on_submit = true \
+	.max_secondary_packets = 8u, \
+	.secondary_commands_per_packet = 1024u, \
+	.secondary_command_bytes_per_packet = 512u * 1024u, \
+	.large_block_threshold = 64u * 1024u, \
+	.block_pool_bytes = 32u * 1024u * 1024u, \
+	.wait_on_submit = true, \
+	.pacing = SE_RENDER_THREAD_PACING_FIXED, \
+	.target_frames_in_flight = 1u, \
+	.latency_budget_ms = 50.0 \
 })
 
+typedef struct {
+	se_render_thread_pacing pacing;
+	// Smoothed producer work per frame (begin to begin minus waits on the render thread) and
+	// render-thread time (execute + present).
+	f64 producer_frame_ms;
+	f64 render_frame_ms;
+	f64 estimated_latency_ms;
+	// Decision applied to the last submitted frame.
+	u32 frames_in_flight;
+	b8 wait_for_present;
+	b8 render_bound;
+	u64 adjustments;
+	u64 over_budget_frames;
+} se_render_thread_pacing_stats;
+
 typedef struct {
 	b8 running;
 	b8 stopping;
@@ -31,15 +110,93 @@ typedef struct {
 	u32 queue_depth;
 	u64 last_command_count;
 	u64 last_command_bytes;
+	u32 last_secondary_packets;
+	u64 last_secondary_command_count;
+	u64 secondary_overflows;
+	u64 payload_high_water_bytes;
+	u64 proxy_names_created;
+	u32 live_proxy_names;
+	// GL state changes dropped because the render thread already had that state bound.
+	u64 redundant_state_skips;
+	u64 last_redundant_state_skips;
+	u64 captured_frames;
+	b8 capturing;
+	se_render_thread_command_stats command_stats[SE_RENDER_THREAD_COMMAND_KIND_COUNT];
+	se_render_thread_command_stats last_command_stats[SE_RENDER_THREAD_COMMAND_KIND_COUNT];
+	u64 sync_calls;
+	f64 sync_stall_ms;
+	// Round-trips issued while recording the last submitted frame and the time callers blocked.
+	u32 last_sync_calls;
+	f64 last_sync_stall_ms;
+	// Entry point of the most recent round-trip, NULL when it is not a dispatch command.
+	const c8* last_sync_command;
+	u64 block_bytes_in_use;
+	u64 block_high_water_bytes;
+	u64 block_pool_bytes;
+	u64 block_allocations;
+	u64 block_reuses;
 	f64 last_submit_wait_ms;
 	f64 last_execute_ms;
 	f64 last_present_ms;
+	f64 last_frame_latency_ms;
+	u32 packet_count;
+	u32 max_frames_in_flight;
+	f64 packet_execute_ms[SE_RENDER_THREAD_MAX_PACKET_COUNT];
+	f64 packet_latency_ms[SE_RENDER_THREAD_MAX_PACKET_COUNT];
+	se_render_thread_pacing_stats pacing;
+	// Recording mistakes caught in SE_RENDER_QUEUE_VALIDATION builds; always zero otherwise.
+	u64 validation_errors;
+	const c8* last_validation_command;
+	const c8* last_validation_tag;
+	// "file:line" of the engine GL call that recorded the failing command.
+	const c8* last_validation_site;
 } se_render_thread_diagnostics;
 
+typedef struct {
+	c8 name[SE_MAX_NAME_LENGTH];
+	// Commands executed over all replay iterations.
+	u64 count;
+	// Bytes stored in the capture for this command type.
+	u64 payload_bytes;
+	u64 blob_bytes;
+	f64 total_ms;
+	f64 max_ms;
+} se_render_thread_capture_command_stats;
+
+typedef struct {
+	u32 frame_count;
+	u32 iterations;
+	u64 command_count;
+	u64 payload_bytes;
+	u64 blob_bytes;
+	// Commands whose name is not known to this build; they are not executed.
+	u64 skipped_commands;
+	// Commands whose payload points at memory of the capturing process; they are not executed.
+	u64 rejected_commands;
+	f64 total_ms;
+	f64 captured_execute_ms;
+	u32 command_type_count;
+	se_render_thread_capture_command_stats command_types[SE_RENDER_THREAD_CAPTURE_MAX_COMMAND_TYPES];
+} se_render_thread_capture_report;
+
 extern se_render_thread_handle se_render_thread_start(se_window_handle window, const se_render_thread_config* config);
 extern void se_render_thread_stop(se_render_thread_handle thread);
 extern b8 se_render_thread_is_running(se_render_thread_handle thread);
 extern void se_render_thread_wait_idle(se_render_thread_handle thread);
 extern b8 se_render_thread_get_diagnostics(se_render_thread_handle thread, se_render_thread_diagnostics* out_diag);
+// Names the recording site for commands recorded on the calling thread until the tag changes;
+// validation reports carry it next to the engine source line of the GL call, which is captured
+// automatically. `tag` must outlive the frame. Returns the previous tag.
+// A no-op returning NULL unless built with SE_RENDER_QUEUE_VALIDATION.
+extern const c8* se_render_thread_set_caller_tag(const c8* tag);
+
+// Serializes the next `frame_count` executed packets (0 = until capture_end) to a binary file.
+extern b8 se_render_thread_capture_begin(se_render_thread_handle thread, const c8* path, u32 frame_count);
+extern void se_render_thread_capture_end(se_render_thread_handle thread);
+// Runs a capture `iterations` times on the calling thread's GL and reports per-command cost.
+// Needs the render thread stopped; the terminal backend replays headless with no-op GL.
+// Objects the capture creates get fresh names each iteration; ones created before it started
+// resolve through the live proxy table.
+extern b8 se_render_thread_replay_capture(const c8* path, u32 iterations, se_render_thread_capture_report* out_report);
 
 #endif // SE_RENDER_THREAD_H
@@ -15,8 +15,13 @@
 typedef struct s_json s_json;
 
 #define SE_MAX_SCENES 128
-#define SE_MAX_2D_OBJECTS 1024
-#define SE_MAX_3D_OBJECTS 1024
+// Object pools grow on demand; these limits only stop runaway creation.
+#ifndef SE_MAX_2D_OBJECTS
+#define SE_MAX_2D_OBJECTS (1u << 20)
+#endif
+#ifndef SE_MAX_3D_OBJECTS
+#define SE_MAX_3D_OBJECTS (1u << 20)
+#endif
 
 typedef i32 se_instance_id;
 typedef s_array(se_instance_id, se_instance_ids);
@@ -24,6 +29,20 @@ typedef s_array(s_mat4, se_transforms);
 typedef s_array(s_mat4, se_buffers);
 typedef s_array(b8, se_instance_actives);
 
+// Instance ids pack a reusable index with a generation that is bumped whenever the index is
+// released, so an id kept past se_object_*_remove_instance stops resolving. Released indices
+// are reused oldest first and only once enough of them are queued, so a stale id would need
+// thousands of remove/add cycles on one object before its generation comes round again.
+typedef struct {
+	// Dense slot per id index, -1 while the index is free.
+	se_instance_ids slots;
+	se_instance_ids generations;
+	// FIFO of released indices kept as two stacks: releases push onto `released`, which is
+	// reversed into `reusable` when that runs dry.
+	se_instance_ids released;
+	se_instance_ids reusable;
+} se_instance_id_map;
+
 typedef b8 (*se_scene_pick_filter_2d)(se_object_2d_handle object, void* user_data);
 typedef b8 (*se_scene_pick_filter_3d)(se_object_3d_handle object, void* user_data);
 typedef s_handle se_scene_3d_custom_render_handle;
@@ -36,13 +55,28 @@ typedef struct {
 	f32 distance;
 } se_scene_pick_hit_3d;
 
+typedef struct {
+	se_object_2d_handle object;
+	// -1 for custom objects, which have no instances.
+	se_instance_id instance_id;
+} se_scene_instance_2d;
+
+typedef struct {
+	se_object_3d_handle object;
+	se_instance_id instance_id;
+} se_scene_instance_3d;
+
 typedef struct {
 	se_instance_ids ids;
 	se_transforms transforms;
 	se_buffers buffers;
 	se_instance_actives actives;
 	se_instance_ids free_indices;
+	// Position of each inactive slot in `free_indices`, -1 for active slots.
+	se_instance_ids free_positions;
 	se_buffers metadata;
+	se_instance_id_map id_map;
+	// Id indices handed out so far.
 	se_instance_id next_id;
 } se_instances;
 
@@ -53,22 +87,48 @@ typedef struct {
 	se_buffers buffers;
 	se_instance_actives actives;
 	se_instance_ids free_indices;
+	// Position of each inactive slot in `free_indices`, -1 for active slots.
+	se_instance_ids free_positions;
 	se_buffers metadata;
+	se_instance_id_map id_map;
+	// Id indices handed out so far.
 	se_instance_id next_id;
 } se_instances_2d;
 
 typedef void (*se_object_custom_callback)(void *data);
 
+// Largest payload accepted by se_object_custom_set_data.
 #define SE_OBJECT_CUSTOM_DATA_SIZE (16 * 1024)
 
+// Filled by callers and copied by se_object_*_create_custom.
 typedef struct {
 	se_object_custom_callback render;
 	sz data_size;
 	u8 data[SE_OBJECT_CUSTOM_DATA_SIZE];
 } se_object_custom;
 
+// Custom payload as stored on objects: `data` is a heap copy of `data_size` bytes, or NULL
+// when the payload is empty.
+typedef struct {
+	se_object_custom_callback render;
+	sz data_size;
+	void* data;
+} se_object_custom_data;
+
+typedef struct {
+	u32 count;
+	u32 capacity;
+	// Pool slots, including unused ones.
+	sz object_bytes;
+	sz custom_data_bytes;
+	// Reserved instance and render arrays of live objects.
+	sz instance_bytes;
+} se_object_pool_stats;
+
 typedef struct se_object_2d {
 	s_mat3 transform;
+	// Bumped when the object's boxes change so scene spatial indices can refit them.
+	u32 spatial_revision;
 	union {
 		struct {
 			se_quad quad;
@@ -76,8 +136,11 @@ typedef struct se_object_2d {
 			se_instances_2d instances;
 			se_transforms_2d render_transforms;
 			se_buffers render_buffers;
+			// Instance slots moved since spatial_log_revision, as on se_object_3d.
+			se_instance_ids spatial_moved;
+			u32 spatial_log_revision;
 		};
-		se_object_custom custom;
+		se_object_custom_data custom;
 	};
 	b8 is_custom : 1;
 	b8 is_visible : 1;
@@ -87,8 +150,26 @@ typedef s_array(se_object_2d, se_objects_2d);
 typedef se_object_2d_handle se_object_2d_ptr;
 typedef s_array(se_object_2d_handle, se_objects_2d_ptr);
 
+typedef s_array(se_object_3d_handle, se_objects_3d_ptr);
+
+#define SE_OBJECT_3D_MAX_LODS 4
+
+typedef enum {
+	// Thresholds are camera distances in world units, growing with each level.
+	SE_LOD_METRIC_DISTANCE = 0,
+	// Thresholds are projected bounds diameters over the viewport height, shrinking with each level.
+	SE_LOD_METRIC_SCREEN_SIZE
+} se_lod_metric;
+
 typedef struct se_object_3d {
+	// World transform. Equals local_transform for root objects; for children it is a cache
+	// refreshed from the parent chain when world_dirty is set.
 	s_mat4 transform;
+	s_mat4 local_transform;
+	se_object_3d_handle parent;
+	// Parent instance the object follows, or -1 to follow the parent object itself.
+	se_instance_id parent_instance;
+	se_objects_3d_ptr children;
 	union {
 		struct {
 			se_model_handle model;
@@ -97,16 +178,30 @@ typedef struct se_object_3d {
 			se_transforms render_transforms;
 			se_buffers render_buffers;
 			se_buffers render_metadata;
+			// Instance slots that survived the last instance-level frustum cull.
+			se_instance_ids visible_instances;
+			// World-space bounds of every active instance, refreshed when instances change.
+			se_box_3d bounds;
+			// Instance slots moved since spatial_log_revision; scene spatial indices replay
+			// them instead of refitting every instance. Cleared when the whole object changes.
+			se_instance_ids spatial_moved;
+			u32 spatial_revision;
+			u32 spatial_log_revision;
+			// Coarser models beyond level 0, NULL until se_object_3d_add_lod.
+			struct se_object_3d_lods* lods;
 		};
-		se_object_custom custom;
+		se_object_custom_data custom;
 	};
 	b8 is_custom : 1;
 	b8 is_visible : 1;
+	b8 has_bounds : 1;
+	// Drawn after opaque objects, back to front, with blending on and depth writes off.
+	b8 is_translucent : 1;
+	b8 world_dirty : 1;
 } se_object_3d;
 
 typedef s_array(se_object_3d, se_objects_3d);
 typedef se_object_3d_handle se_object_3d_ptr;
-typedef s_array(se_object_3d_handle, se_objects_3d_ptr);
 
 typedef struct {
 	se_scene_3d_custom_render_callback callback;
@@ -117,12 +212,122 @@ typedef s_array(se_scene_3d_custom_render_entry, se_scene_3d_custom_render_entri
 typedef struct se_scene_2d {
 	se_objects_2d_ptr objects;
 	se_framebuffer_handle output;
+	struct se_scene_spatial* spatial;
 } se_scene_2d;
 
 typedef s_array(se_scene_2d, se_scenes_2d);
 typedef se_scene_2d_handle se_scene_2d_ptr;
 typedef s_array(se_scene_2d_handle, se_scenes_2d_ptr);
 
+typedef struct {
+	u32 batches;
+	u32 commands;
+	u32 instances;
+	u32 arena_meshes;
+	b8 multi_draw_indirect;
+} se_scene_3d_batch_stats;
+
+typedef struct {
+	u32 objects_tested;
+	u32 objects_culled;
+	u32 instances_tested;
+	u32 instances_culled;
+} se_scene_3d_cull_stats;
+
+typedef struct {
+	u32 draws;
+	u32 shader_switches;
+	u32 vao_binds;
+	// Uniform values sent by shader switches, globals included.
+	u32 uniform_uploads;
+	// Draws of the depth prepass and shadow passes, not included in `draws`.
+	u32 depth_draws;
+} se_scene_3d_draw_stats;
+
+typedef struct {
+	u32 objects;
+	// Instances drawn at each level of detail.
+	u32 instances[SE_OBJECT_3D_MAX_LODS];
+	// Instances whose level changed since their previous frame.
+	u32 switches;
+} se_scene_3d_lod_stats;
+
+#define SE_SCENE_3D_MAX_RENDER_PASSES 8
+
+typedef enum {
+	// Opaque meshes write depth only, so the main pass shades each visible pixel once.
+	SE_RENDER_PASS_DEPTH_PREPASS = 0,
+	SE_RENDER_PASS_SHADOW_DIRECTIONAL,
+	SE_RENDER_PASS_SHADOW_SPOT,
+	SE_RENDER_PASS_MAIN
+} se_render_pass_kind;
+
+// Largest side of a shadow map, all cascades included.
+#define SE_SHADOW_MAX_RESOLUTION 8192u
+// Cascades of one shadow pass are packed two per row.
+#define SE_SHADOW_ATLAS_COLUMNS(cascade_count) ((cascade_count) > 1u ? 2u : 1u)
+#define SE_SHADOW_ATLAS_ROWS(cascade_count) (((cascade_count) + 1u) / 2u)
+
+typedef struct {
+	se_render_pass_kind kind;
+	// Shadow passes: the direction light travels in; spot lights also use the position.
+	s_vec3 light_direction;
+	s_vec3 light_position;
+	// Texels per side of each cascade; cascades share one map of at most SE_SHADOW_MAX_RESOLUTION
+	// texels per side.
+	u32 resolution;
+	// Directional: cascades split the camera range per se_shadow_cascade_splits.
+	u32 cascade_count;
+	f32 cascade_lambda;
+	// Directional: how far from the camera shadows reach, 0 for the camera far plane.
+	// Spot: the light's range.
+	f32 distance;
+	// Directional: depth added toward the light for casters outside the camera view.
+	f32 caster_distance;
+	// Spot: full cone angle in radians and near plane.
+	f32 spot_angle;
+	f32 spot_near;
+	// Shadow passes: glPolygonOffset factor and units, pushing caster depth away from the light
+	// so lit surfaces do not shadow themselves.
+	f32 slope_bias;
+	f32 depth_bias;
+} se_render_pass;
+
+#define SE_RENDER_PASS_MAIN_DEFAULTS ((se_render_pass){ .kind = SE_RENDER_PASS_MAIN })
+#define SE_RENDER_PASS_DEPTH_PREPASS_DEFAULTS ((se_render_pass){ .kind = SE_RENDER_PASS_DEPTH_PREPASS })
+#define SE_RENDER_PASS_SHADOW_DIRECTIONAL_DEFAULTS ((se_render_pass){ \
+	.kind = SE_RENDER_PASS_SHADOW_DIRECTIONAL, \
+	.light_direction = { -0.4f, -1.0f, -0.3f }, \
+	.resolution = 1024u, \
+	.cascade_count = 3u, \
+	.cascade_lambda = 0.75f, \
+	.distance = 100.0f, \
+	.caster_distance = 50.0f, \
+	.slope_bias = 2.0f, \
+	.depth_bias = 1.0f \
+})
+#define SE_RENDER_PASS_SHADOW_SPOT_DEFAULTS ((se_render_pass){ \
+	.kind = SE_RENDER_PASS_SHADOW_SPOT, \
+	.light_direction = { 0.0f, -1.0f, 0.0f }, \
+	.resolution = 1024u, \
+	.cascade_count = 1u, \
+	.distance = 25.0f, \
+	.spot_angle = 0.8f, \
+	.spot_near = 0.1f, \
+	.slope_bias = 2.0f, \
+	.depth_bias = 1.0f \
+})
+
+typedef struct {
+	// Cascades tile a grid SE_SHADOW_ATLAS_COLUMNS(cascade_count) wide: cascade i covers column
+	// i % 2 and row i / 2.
+	u32 depth_texture;
+	u32 cascade_count;
+	s_mat4 view_projections[SE_SHADOW_MAX_CASCADES];
+	// Cascade i covers camera distances cascade_splits[i] to cascade_splits[i + 1].
+	f32 cascade_splits[SE_SHADOW_MAX_CASCADES + 1];
+} se_shadow_map;
+
 typedef struct se_scene_3d {
 	se_objects_3d_ptr objects;
 	se_camera_handle camera;
@@ -131,8 +336,19 @@ typedef struct se_scene_3d {
 	se_framebuffer_handle output;
 	se_scene_3d_custom_render_entries custom_renders;
 	s_mat4 last_vp;
+	struct se_scene_3d_batch* batch;
+	struct se_scene_spatial* spatial;
+	struct se_scene_3d_draw_list* draw_list;
+	struct se_scene_3d_render_passes* render_passes;
+	se_scene_3d_cull_stats cull_stats;
+	se_scene_3d_draw_stats draw_stats;
+	se_scene_3d_lod_stats lod_stats;
 	b8 enable_culling : 1;
 	b8 has_last_vp : 1;
+	b8 enable_batching : 1;
+	b8 world_space_instances : 1;
+	b8 enable_frustum_culling : 1;
+	b8 enable_instance_culling : 1;
 } se_scene_3d;
 
 typedef s_array(se_scene_3d, se_scenes_3d);
@@ -143,6 +359,7 @@ typedef s_array(se_scene_3d_handle, se_scenes_3d_ptr);
 extern se_object_2d_handle se_object_2d_create(const c8 *fragment_shader_path, const s_mat3 *transform, const sz max_instances_count);
 extern se_object_2d_handle se_object_2d_create_custom(se_object_custom *custom, const s_mat3 *transform);
 extern void se_object_custom_set_data(se_object_custom *custom, const void *data, const sz size);
+extern b8 se_object_2d_get_pool_stats(se_object_pool_stats* out_stats);
 extern void se_object_2d_destroy(const se_object_2d_handle object);
 extern void se_object_2d_set_transform(const se_object_2d_handle object, const s_mat3 *transform);
 extern s_mat3 se_object_2d_get_transform(const se_object_2d_handle object);
@@ -155,6 +372,7 @@ extern void se_object_2d_set_shader(const se_object_2d_handle object, const se_s
 extern se_shader_handle se_object_2d_get_shader(const se_object_2d_handle object);
 extern void se_object_2d_update_uniforms(const se_object_2d_handle object);
 extern se_instance_id se_object_2d_add_instance(const se_object_2d_handle object, const s_mat3 *transform, const s_mat4 *buffer);
+// Moves the last instance into the freed slot; ids stay valid, slot indices do not.
 extern b8 se_object_2d_remove_instance(const se_object_2d_handle object, const se_instance_id instance_id);
 extern i32 se_object_2d_get_instance_index(const se_object_2d_handle object, const se_instance_id instance_id);
 extern void se_object_2d_set_transform_by_id(const se_object_2d_handle object, const se_instance_id instance_id, const s_mat3 *transform);
@@ -177,6 +395,7 @@ extern b8 se_object_2d_from_json(const se_object_2d_handle object, const s_json*
 extern b8 se_object_2d_from_json_file(const se_object_2d_handle object, const c8* path);
 
 // 2D scene functions
+// `object_count` only pre-sizes the object list and may be 0; scenes grow as objects are added.
 extern se_scene_2d_handle se_scene_2d_create(const s_vec2 *size, const u16 object_count);
 extern void se_scene_2d_set_fit_to_window(const se_scene_2d_handle scene, const se_window_handle window, const s_vec2 *ratio);
 extern void se_scene_2d_destroy(const se_scene_2d_handle scene);
@@ -192,6 +411,11 @@ extern void se_scene_2d_draw(const se_scene_2d_handle scene, const se_window_han
 extern void se_scene_2d_add_object(const se_scene_2d_handle scene, const se_object_2d_handle object);
 extern void se_scene_2d_remove_object(const se_scene_2d_handle scene, const se_object_2d_handle object);
 extern b8 se_scene_2d_pick_object(const se_scene_2d_handle scene, const s_vec2* point_ndc, se_scene_pick_filter_2d filter, void* user_data, se_object_2d_handle* out_object);
+// Box selection in the same space as se_scene_2d_pick_object. Every instance whose box touches
+// the rect or polygon is reported; the return value is the match count, of which at most
+// `max_instances` are written.
+extern u32 se_scene_2d_query_rect(const se_scene_2d_handle scene, const se_box_2d* rect, se_scene_pick_filter_2d filter, void* user_data, se_scene_instance_2d* out_instances, const u32 max_instances);
+extern u32 se_scene_2d_query_polygon(const se_scene_2d_handle scene, const s_vec2* points, const u32 point_count, se_scene_pick_filter_2d filter, void* user_data, se_scene_instance_2d* out_instances, const u32 max_instances);
 extern s_json* se_scene_2d_to_json(const se_scene_2d_handle scene);
 // Saves a scene JSON snapshot using the engine's platform-aware writable path rules.
 extern b8 se_scene_2d_to_json_file(const se_scene_2d_handle scene, const c8* path);
@@ -200,6 +424,7 @@ extern b8 se_scene_2d_from_json(const se_scene_2d_handle scene, const s_json* ro
 extern b8 se_scene_2d_from_json_file(const se_scene_2d_handle scene, const c8* path);
 
 // 3D scene functions
+// `object_count` only pre-sizes the object list and may be 0; scenes grow as objects are added.
 extern se_scene_3d_handle se_scene_3d_create(const s_vec2 *size, const u16 object_count);
 extern se_scene_3d_handle se_scene_3d_create_for_window(const se_window_handle window, const u16 object_count);
 extern void se_scene_3d_set_fit_to_window(const se_scene_3d_handle scene, const se_window_handle window, const s_vec2 *ratio);
@@ -215,14 +440,65 @@ extern se_object_3d_handle se_scene_3d_add_model(const se_scene_3d_handle scene,
 extern void se_scene_3d_remove_object(const se_scene_3d_handle scene, const se_object_3d_handle object);
 extern b8 se_scene_3d_pick_instance_screen(const se_scene_3d_handle scene, const f32 screen_x, const f32 screen_y, const f32 viewport_width, const f32 viewport_height, const f32 pick_radius, se_scene_pick_filter_3d filter, void* user_data, se_scene_pick_hit_3d* out_hit);
 extern b8 se_scene_3d_pick_object_screen(const se_scene_3d_handle scene, const f32 screen_x, const f32 screen_y, const f32 viewport_width, const f32 viewport_height, const f32 pick_radius, se_scene_pick_filter_3d filter, void* user_data, se_object_3d_handle* out_object, f32* out_distance);
+// Queries run on a bounding-volume hierarchy over instance bounds that is refit lazily from
+// the instances changed since the previous query. They return the number of matches, writing
+// at most `max_instances` of them.
+extern u32 se_scene_3d_query_box(const se_scene_3d_handle scene, const se_box_3d* box, se_scene_pick_filter_3d filter, void* user_data, se_scene_instance_3d* out_instances, const u32 max_instances);
+extern u32 se_scene_3d_query_frustum(const se_scene_3d_handle scene, const se_frustum* frustum, se_scene_pick_filter_3d filter, void* user_data, se_scene_instance_3d* out_instances, const u32 max_instances);
+// Drag selection in screen pixels (origin top-left, as in the pick functions): instances whose
+// projected bounds touch the rect or polygon, seen through the scene camera.
+extern u32 se_scene_3d_query_screen_rect(const se_scene_3d_handle scene, const f32 x0, const f32 y0, const f32 x1, const f32 y1, const f32 viewport_width, const f32 viewport_height, se_scene_pick_filter_3d filter, void* user_data, se_scene_instance_3d* out_instances, const u32 max_instances);
+extern u32 se_scene_3d_query_screen_polygon(const se_scene_3d_handle scene, const s_vec2* points, const u32 point_count, const f32 viewport_width, const f32 viewport_height, se_scene_pick_filter_3d filter, void* user_data, se_scene_instance_3d* out_instances, const u32 max_instances);
 extern void se_scene_3d_set_camera(const se_scene_3d_handle scene, const se_camera_handle camera);
 extern se_camera_handle se_scene_3d_get_camera(const se_scene_3d_handle scene);
 extern b8 se_scene_3d_get_output_depth_texture(const se_scene_3d_handle scene, u32* out_depth_texture);
 extern void se_scene_3d_set_culling(const se_scene_3d_handle scene, const b8 enabled);
+// Skips objects whose instance bounds are outside the camera frustum. With `per_instance`,
+// instances of the remaining objects are tested too and the survivors are compacted into the
+// instance buffers, which are then re-uploaded every frame.
+extern void se_scene_3d_set_frustum_culling(const se_scene_3d_handle scene, const b8 enabled, const b8 per_instance);
+// Counts from the last se_scene_3d_render_to_buffer call.
+extern b8 se_scene_3d_get_cull_stats(const se_scene_3d_handle scene, se_scene_3d_cull_stats* out_stats);
+// Meshes are drawn sorted by shader, then vertex array, then depth, and each shader's uniforms
+// are applied once per group. Counts from the last se_scene_3d_render_to_buffer call.
+extern b8 se_scene_3d_get_draw_stats(const se_scene_3d_handle scene, se_scene_3d_draw_stats* out_stats);
+// Counts from the last se_scene_3d_render_to_buffer call, for objects with more than one level.
+extern b8 se_scene_3d_get_lod_stats(const se_scene_3d_handle scene, se_scene_3d_lod_stats* out_stats);
+// Packs the scene's meshes into shared vertex/index arenas and draws them per shader with
+// glMultiDrawElementsIndirect, or one base-vertex draw per mesh where that is unsupported.
+// Mesh geometry is copied into the arena the first time it is seen, so it must not change.
+extern void se_scene_3d_set_batching(const se_scene_3d_handle scene, const b8 enabled);
+extern b8 se_scene_3d_get_batch_stats(const se_scene_3d_handle scene, se_scene_3d_batch_stats* out_stats);
+// Instance buffers hold world matrices and are only re-uploaded when instances change; the
+// camera's view-projection is set once per frame as the `u_view_proj` mat4 uniform instead.
+// Mesh shaders must apply it themselves, see shaders/scene_3d_world_vertex.glsl. Turning it off
+// while shadow passes or a depth prepass are set fails with SE_RESULT_INVALID_ARGUMENT.
+extern void se_scene_3d_set_world_space_instances(const se_scene_3d_handle scene, const b8 enabled);
+// Passes run in list order and the list must end with its only SE_RENDER_PASS_MAIN; scenes
+// start with just the main pass. Shadow passes render the opaque objects inside each light's
+// volume into per-pass depth maps with a depth-only shader, so while one is set instances are
+// culled per object rather than per instance. Shadow passes and the depth prepass need
+// world-space instances, otherwise the call fails with SE_RESULT_INVALID_ARGUMENT. After a depth
+// prepass the main pass tests with GL_LEQUAL and writes no depth, so mesh shaders must declare
+// `invariant gl_Position` and compute it as (u_view_proj * instance) * position, like
+// shaders/scene_3d_world_vertex.glsl; anything else can fail the depth test per pixel.
+// Scenes with extra passes skip batching.
+extern b8 se_scene_3d_set_render_passes(const se_scene_3d_handle scene, const se_render_pass* passes, const u32 pass_count);
+// Returns the pass count, writing at most `max_passes` of them.
+extern u32 se_scene_3d_get_render_passes(const se_scene_3d_handle scene, se_render_pass* out_passes, const u32 max_passes);
+// Depth map and matrices of shadow pass `pass_index` from the last se_scene_3d_render_to_buffer call.
+extern b8 se_scene_3d_get_shadow_map(const se_scene_3d_handle scene, const u32 pass_index, se_shadow_map* out_shadow_map);
+// Pass setup without GL or context state.
+extern b8 se_render_passes_validate(const se_render_pass* passes, const u32 pass_count);
+// Fits the light matrices and cascade splits of a shadow pass to a camera; `depth_texture` is
+// left untouched.
+extern b8 se_render_pass_fit_shadow(const se_render_pass* pass, const s_mat4* camera_view_projection, const f32 camera_near, const f32 camera_far, se_shadow_map* out_shadow_map);
 extern void se_scene_3d_add_post_process_buffer(const se_scene_3d_handle scene, const se_render_buffer_handle buffer);
 extern void se_scene_3d_remove_post_process_buffer(const se_scene_3d_handle scene, const se_render_buffer_handle buffer);
 extern se_scene_3d_custom_render_handle se_scene_3d_register_custom_render(const se_scene_3d_handle scene, se_scene_3d_custom_render_callback callback, void* user_data);
 extern b8 se_scene_3d_unregister_custom_render(const se_scene_3d_handle scene, const se_scene_3d_custom_render_handle callback_handle);
+// Parent links between objects of the scene are saved; objects parented outside it are saved
+// as roots with their local transform.
 extern s_json* se_scene_3d_to_json(const se_scene_3d_handle scene);
 // Saves a scene JSON snapshot using the engine's platform-aware writable path rules.
 extern b8 se_scene_3d_to_json_file(const se_scene_3d_handle scene, const c8* path);
@@ -234,13 +510,24 @@ extern b8 se_scene_3d_from_json_file(const se_scene_3d_handle scene, const c8* p
 extern se_object_3d_handle se_object_3d_create(const se_model_handle model, const s_mat4 *transform, const sz max_instances_count);
 extern se_object_3d_handle se_object_3d_create_custom(se_object_custom *custom, const s_mat4 *transform);
 extern void se_object_3d_destroy(const se_object_3d_handle object);
+extern b8 se_object_3d_get_pool_stats(se_object_pool_stats* out_stats);
+// Transform setters are relative to the parent and mark the object's subtree dirty; world
+// transforms are recomputed along dirty subtrees when read or rendered.
 extern void se_object_3d_set_transform(const se_object_3d_handle object, const s_mat4 *transform);
 extern void se_object_3d_set_location(const se_object_3d_handle object, const s_vec3 *location);
 extern void se_object_3d_set_rotation(const se_object_3d_handle object, const s_vec3 *rotation);
 extern void se_object_3d_set_scale(const se_object_3d_handle object, const s_vec3 *scale);
+// Returns the world transform.
 extern s_mat4 se_object_3d_get_transform(const se_object_3d_handle object);
+extern s_mat4 se_object_3d_get_local_transform(const se_object_3d_handle object);
+// Attaches `object` under `parent`, or under one of its instances when `parent_instance_id` is
+// not -1; the local transform is kept. S_HANDLE_NULL detaches. Fails on cycles. A child whose
+// parent instance is removed follows the parent object until it is re-attached.
+extern b8 se_object_3d_set_parent(const se_object_3d_handle object, const se_object_3d_handle parent, const se_instance_id parent_instance_id);
+extern se_object_3d_handle se_object_3d_get_parent(const se_object_3d_handle object, se_instance_id* out_parent_instance_id);
 extern b8 se_object_3d_reserve_instances(const se_object_3d_handle object, const sz instance_capacity);
 extern se_instance_id se_object_3d_add_instance(const se_object_3d_handle object, const s_mat4 *transform, const s_mat4 *buffer);
+// Moves the last instance into the freed slot; ids stay valid, slot indices do not.
 extern b8 se_object_3d_remove_instance(const se_object_3d_handle object, const se_instance_id instance_id);
 extern i32 se_object_3d_get_instance_index(const se_object_3d_handle object, const se_instance_id instance_id);
 extern void se_object_3d_set_transform_by_id(const se_object_3d_handle object, const se_instance_id instance_id, const s_mat4 *transform);
@@ -255,6 +542,16 @@ extern b8 se_object_3d_get_metadata_by_id(const se_object_3d_handle object, cons
 extern void se_object_3d_set_instances_dirty(const se_object_3d_handle object, const b8 dirty);
 extern b8 se_object_3d_are_instances_dirty(const se_object_3d_handle object);
 extern sz se_object_3d_get_instance_count(const se_object_3d_handle object);
+extern void se_object_3d_set_translucent(const se_object_3d_handle object, const b8 translucent);
+// Level 0 is the object's own model; each call appends a coarser level that instances switch to
+// past `threshold`, per the object's se_lod_metric. Levels are picked per instance at render
+// time, and an instance only changes level once it is past the boundary by the hysteresis
+// fraction. Scenes holding objects with levels skip batching. Levels are not saved to JSON.
+extern b8 se_object_3d_add_lod(const se_object_3d_handle object, const se_model_handle model, const f32 threshold);
+extern void se_object_3d_clear_lods(const se_object_3d_handle object);
+extern u32 se_object_3d_get_lod_count(const se_object_3d_handle object);
+// Defaults to SE_LOD_METRIC_DISTANCE with a hysteresis of 0.1. Clears the levels when the metric changes.
+extern b8 se_object_3d_set_lod_metric(const se_object_3d_handle object, const se_lod_metric metric, const f32 hysteresis);
 extern s_json* se_object_3d_to_json(const se_object_3d_handle object);
 extern b8 se_object_3d_to_json_file(const se_object_3d_handle object, const c8* path);
 extern b8 se_object_3d_from_json(const se_object_3d_handle object, const s_json* root);
@@ -7,8 +7,10 @@
 #include "se_defines.h"
 
 #define SE_WORKER_TASK_NULL S_HANDLE_NULL
+#define SE_WORKER_GROUP_NULL S_HANDLE_NULL
 
 typedef s_handle se_worker_task;
+typedef s_handle se_worker_group;
 
 typedef struct se_worker_pool se_worker_pool;
 
@@ -19,12 +21,20 @@ typedef struct {
 	u32 thread_count;
 	u32 queue_capacity;
 	u32 max_tasks;
+	// Rounded up to whole pages; each fiber stack also gets an inaccessible guard page below
+	// it, so an overflow faults instead of corrupting memory.
+	u32 fiber_stack_size;
+	// Runs tasks on fibers so a task waiting on another task yields its worker thread
+	// instead of blocking it. Linux only; other platforms keep blocking waits.
+	b8 use_fibers;
 } se_worker_config;
 
 #define SE_WORKER_CONFIG_DEFAULTS ((se_worker_config){ \
 	.thread_count = 4u, \
 	.queue_capacity = 1024u, \
-	.max_tasks = 4096u \
+	.max_tasks = 4096u, \
+	.fiber_stack_size = 256u * 1024u, \
+	.use_fibers = false \
 })
 
 typedef struct {
@@ -34,10 +44,16 @@ typedef struct {
 	u32 pending_tasks;
 	u32 active_tasks;
 	u32 tracked_tasks;
+	u32 tracked_groups;
 	u64 submitted_tasks;
+	u64 submitted_batches;
 	u64 completed_tasks;
+	u32 fiber_count;
+	u32 suspended_fibers;
+	u64 fiber_yields;
 	b8 running : 1;
 	b8 stopping : 1;
+	b8 fibers : 1;
 } se_worker_diagnostics;
 
 extern se_worker_pool* se_worker_create(const se_worker_config* config);
@@ -49,6 +65,12 @@ extern b8 se_worker_wait(se_worker_pool* pool, se_worker_task task, void** out_r
 extern b8 se_worker_release(se_worker_pool* pool, se_worker_task task);
 extern b8 se_worker_wait_idle(se_worker_pool* pool);
 
+// Submits `count` tasks running `fn` with `user_data_array[i]` under one lock acquisition.
+// The batch is all-or-nothing; `out_tasks` is optional and stays valid until the group is waited.
+extern se_worker_group se_worker_submit_batch(se_worker_pool* pool, se_worker_task_fn fn, void** user_data_array, u32 count, se_worker_task* out_tasks);
+// Blocks until every task of the group is done, then releases the group and its member tasks.
+extern b8 se_worker_wait_group(se_worker_pool* pool, se_worker_group group);
+
 extern b8 se_worker_parallel_for(se_worker_pool* pool, u32 count, u32 batch_size, se_worker_for_fn fn, void* user_data);
 
 extern b8 se_worker_get_diagnostics(se_worker_pool* pool, se_worker_diagnostics* out_diagnostics);
@@ -0,0 +1,9 @@
+#version 300 es
+
+precision mediump float;
+
+out vec4 frag_color;
+
+void main() {
+	frag_color = vec4(1.0);
+}
@@ -0,0 +1,15 @@
+#version 300 es
+
+layout(location = 0) in vec3 in_position;
+layout(location = 3) in mat4 in_instance_world;
+
+uniform mat4 u_view_proj;
+
+// Keeps the depth prepass and main pass positions bit-identical for the GL_LEQUAL test.
+invariant gl_Position;
+
+void main() {
+	// Same order as scene_3d_world_vertex.glsl, so the main pass can depth test with GL_LEQUAL.
+	mat4 mvp = u_view_proj * in_instance_world;
+	gl_Position = mvp * vec4(in_position, 1.0);
+}
@@ -0,0 +1,26 @@
+#version 300 es
+
+layout(location = 0) in vec3 in_position;
+layout(location = 1) in vec3 in_normal;
+layout(location = 2) in vec2 in_tex_coord;
+layout(location = 3) in mat4 in_instance_world;
+
+uniform mat4 u_view_proj;
+
+// Must match scene_3d_depth_vert.glsl bit for bit after a depth prepass.
+invariant gl_Position;
+
+out vec2 tex_coord;
+out vec3 clip_position;
+out vec3 clip_normal;
+
+void main() {
+	mat4 mvp = u_view_proj * in_instance_world;
+	vec4 clip = mvp * vec4(in_position, 1.0);
+	gl_Position = clip;
+
+	mat3 normal_matrix = mat3(transpose(inverse(mvp)));
+	clip_normal = normalize(normal_matrix * in_normal);
+	clip_position = clip.xyz;
+	tex_coord = in_tex_coord;
+}
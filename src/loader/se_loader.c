@@ -196,6 +196,7 @@ static b8 se_gltf_mesh_finalize(se_mesh *mesh, const char *source_path, const se
 
 	mesh->matrix = s_mat4_identity;
 	mesh->shader = S_HANDLE_NULL;
+	se_mesh_compute_bounds(mesh);
 	mesh->gpu.vertex_count = (u32)s_array_get_size(&mesh->cpu.vertices);
 	mesh->gpu.index_count = (u32)s_array_get_size(&mesh->cpu.indices);
 
@@ -1,6 +1,6 @@
 // Syphax-Engine - Ougi Washi
 
-#if defined(SE_RENDER_BACKEND_OPENGL) || defined(SE_RENDER_BACKEND_GLES)
+#if defined(SE_RENDER_BACKEND_OPENGL) || defined(SE_RENDER_BACKEND_GLES) || defined(SE_RENDER_BACKEND_SOFTWARE)
 
 #include "se_gl.h"
 #include "se_debug.h"
@@ -11,6 +11,8 @@
 #include "syphax/s_files.h"
 #if defined(SE_RENDER_BACKEND_GLES)
 #include <EGL/egl.h>
+#elif defined(SE_RENDER_BACKEND_SOFTWARE)
+#include "render/se_gl_soft.h"
 #endif
 #include <fcntl.h>
 #include <stdio.h>
@@ -20,7 +22,7 @@
 #include <sys/stat.h>
 #include <unistd.h>
 
-#if !defined(SE_WINDOW_BACKEND_TERMINAL)
+#if !defined(SE_WINDOW_BACKEND_TERMINAL) && !defined(SE_RENDER_BACKEND_SOFTWARE)
 static void *se_gl_get_proc_address(const char *name) {
 	return se_window_backend_get_gl_proc_address(name);
 }
@@ -115,8 +117,16 @@ PFNGLCHECKFRAMEBUFFERSTATUS se_glCheckFramebufferStatus = NULL;
 PFNGLGENERATEMIPMAP se_glGenerateMipmap = NULL;
 PFNGLBLITFRAMEBUFFER se_glBlitFramebuffer = NULL;
 PFNGLREADBUFFER se_glReadBuffer = NULL;
-
-#if defined(SE_WINDOW_BACKEND_TERMINAL)
+PFNGLBUFFERSTORAGE se_glBufferStorage = NULL;
+PFNGLMAPBUFFERRANGE se_glMapBufferRange = NULL;
+PFNGLFENCESYNC se_glFenceSync = NULL;
+PFNGLCLIENTWAITSYNC se_glClientWaitSync = NULL;
+PFNGLDELETESYNC se_glDeleteSync = NULL;
+PFNGLCOPYBUFFERSUBDATA se_glCopyBufferSubData = NULL;
+PFNGLDRAWELEMENTSINSTANCEDBASEVERTEX se_glDrawElementsInstancedBaseVertex = NULL;
+PFNGLMULTIDRAWELEMENTSINDIRECT se_glMultiDrawElementsIndirect = NULL;
+
+#if defined(SE_WINDOW_BACKEND_TERMINAL) && !defined(SE_RENDER_BACKEND_SOFTWARE)
 static GLuint se_gl_terminal_next_id = 1u;
 
 static GLuint se_gl_terminal_generate_id(void) {
@@ -485,6 +495,63 @@ static void APIENTRY se_gl_terminal_read_buffer(const GLenum src) {
 	(void)src;
 }
 
+static void APIENTRY se_gl_terminal_buffer_storage(const GLenum target, const GLsizeiptr size, const void* data, const GLbitfield flags) {
+	(void)target;
+	(void)size;
+	(void)data;
+	(void)flags;
+}
+
+static void* APIENTRY se_gl_terminal_map_buffer_range(const GLenum target, const GLintptr offset, const GLsizeiptr length, const GLbitfield access) {
+	(void)target;
+	(void)offset;
+	(void)length;
+	(void)access;
+	return NULL;
+}
+
+static GLsync APIENTRY se_gl_terminal_fence_sync(const GLenum condition, const GLbitfield flags) {
+	(void)condition;
+	(void)flags;
+	return NULL;
+}
+
+static GLenum APIENTRY se_gl_terminal_client_wait_sync(const GLsync sync, const GLbitfield flags, const GLuint64 timeout) {
+	(void)sync;
+	(void)flags;
+	(void)timeout;
+	return GL_ALREADY_SIGNALED;
+}
+
+static void APIENTRY se_gl_terminal_delete_sync(const GLsync sync) {
+	(void)sync;
+}
+
+static void APIENTRY se_gl_terminal_copy_buffer_sub_data(const GLenum read_target, const GLenum write_target, const GLintptr read_offset, const GLintptr write_offset, const GLsizeiptr size) {
+	(void)read_target;
+	(void)write_target;
+	(void)read_offset;
+	(void)write_offset;
+	(void)size;
+}
+
+static void APIENTRY se_gl_terminal_draw_elements_instanced_base_vertex(const GLenum mode, const GLsizei count, const GLenum type, const void* indices, const GLsizei instance_count, const GLint base_vertex) {
+	(void)mode;
+	(void)count;
+	(void)type;
+	(void)indices;
+	(void)instance_count;
+	(void)base_vertex;
+}
+
+static void APIENTRY se_gl_terminal_multi_draw_elements_indirect(const GLenum mode, const GLenum type, const void* indirect, const GLsizei draw_count, const GLsizei stride) {
+	(void)mode;
+	(void)type;
+	(void)indirect;
+	(void)draw_count;
+	(void)stride;
+}
+
 static b8 se_init_opengl_terminal(void) {
 	se_glDeleteBuffers = se_gl_terminal_delete_buffers;
 	se_glGenBuffers = se_gl_terminal_gen_buffers;
@@ -543,9 +610,17 @@ static b8 se_init_opengl_terminal(void) {
 	se_glGenerateMipmap = se_gl_terminal_generate_mipmap;
 	se_glBlitFramebuffer = se_gl_terminal_blit_framebuffer;
 	se_glReadBuffer = se_gl_terminal_read_buffer;
+	se_glBufferStorage = se_gl_terminal_buffer_storage;
+	se_glMapBufferRange = se_gl_terminal_map_buffer_range;
+	se_glFenceSync = se_gl_terminal_fence_sync;
+	se_glClientWaitSync = se_gl_terminal_client_wait_sync;
+	se_glDeleteSync = se_gl_terminal_delete_sync;
+	se_glCopyBufferSubData = se_gl_terminal_copy_buffer_sub_data;
+	se_glDrawElementsInstancedBaseVertex = se_gl_terminal_draw_elements_instanced_base_vertex;
+	se_glMultiDrawElementsIndirect = se_gl_terminal_multi_draw_elements_indirect;
 	return true;
 }
-#endif // SE_WINDOW_BACKEND_TERMINAL
+#endif // SE_WINDOW_BACKEND_TERMINAL && !SE_RENDER_BACKEND_SOFTWARE
 
 #define SE_GL_ASSIGN(func, func_type, name, fallback) \
 	func = (func_type)se_gl_get_proc_address(name); \
@@ -557,8 +632,16 @@ static b8 se_init_opengl_terminal(void) {
 		return false; \
 	}
 
+#define SE_GL_ASSIGN_OPTIONAL(func, func_type, name, fallback) \
+	func = (func_type)se_gl_get_proc_address(name); \
+	if (!func) { \
+		func = (func_type)(fallback); \
+	}
+
 b8 se_init_opengl(void) {
-#if defined(SE_WINDOW_BACKEND_TERMINAL)
+#if defined(SE_RENDER_BACKEND_SOFTWARE)
+	return se_gl_soft_init();
+#elif defined(SE_WINDOW_BACKEND_TERMINAL)
 	return se_init_opengl_terminal();
 #elif defined(SE_RENDER_BACKEND_GLES)
 	SE_GL_ASSIGN(se_glDeleteBuffers, PFNGLDELETEBUFFERS, "glDeleteBuffers", glDeleteBuffers);
@@ -618,6 +701,17 @@ b8 se_init_opengl(void) {
 	SE_GL_ASSIGN(se_glGenerateMipmap, PFNGLGENERATEMIPMAP, "glGenerateMipmap", glGenerateMipmap);
 	SE_GL_ASSIGN(se_glBlitFramebuffer, PFNGLBLITFRAMEBUFFER, "glBlitFramebuffer", glBlitFramebuffer);
 	SE_GL_ASSIGN(se_glReadBuffer, PFNGLREADBUFFER, "glReadBuffer", glReadBuffer);
+	SE_GL_ASSIGN_OPTIONAL(se_glBufferStorage, PFNGLBUFFERSTORAGE, "glBufferStorageEXT", NULL);
+	SE_GL_ASSIGN_OPTIONAL(se_glMapBufferRange, PFNGLMAPBUFFERRANGE, "glMapBufferRange", glMapBufferRange);
+	SE_GL_ASSIGN_OPTIONAL(se_glFenceSync, PFNGLFENCESYNC, "glFenceSync", glFenceSync);
+	SE_GL_ASSIGN_OPTIONAL(se_glClientWaitSync, PFNGLCLIENTWAITSYNC, "glClientWaitSync", glClientWaitSync);
+	SE_GL_ASSIGN_OPTIONAL(se_glDeleteSync, PFNGLDELETESYNC, "glDeleteSync", glDeleteSync);
+	SE_GL_ASSIGN_OPTIONAL(se_glCopyBufferSubData, PFNGLCOPYBUFFERSUBDATA, "glCopyBufferSubData", glCopyBufferSubData);
+	SE_GL_ASSIGN_OPTIONAL(se_glDrawElementsInstancedBaseVertex, PFNGLDRAWELEMENTSINSTANCEDBASEVERTEX, "glDrawElementsInstancedBaseVertex", NULL);
+	if (!se_glDrawElementsInstancedBaseVertex) {
+		SE_GL_ASSIGN_OPTIONAL(se_glDrawElementsInstancedBaseVertex, PFNGLDRAWELEMENTSINSTANCEDBASEVERTEX, "glDrawElementsInstancedBaseVertexEXT", NULL);
+	}
+	SE_GL_ASSIGN_OPTIONAL(se_glMultiDrawElementsIndirect, PFNGLMULTIDRAWELEMENTSINDIRECT, "glMultiDrawElementsIndirectEXT", NULL);
 #else
 	SE_GL_ASSIGN(se_glDeleteBuffers, PFNGLDELETEBUFFERS, "glDeleteBuffers", NULL);
 	SE_GL_ASSIGN(se_glGenBuffers, PFNGLGENBUFFERS, "glGenBuffers", NULL);
@@ -676,6 +770,14 @@ b8 se_init_opengl(void) {
 	SE_GL_ASSIGN(se_glGenerateMipmap, PFNGLGENERATEMIPMAP, "glGenerateMipmap", NULL);
 	SE_GL_ASSIGN(se_glBlitFramebuffer, PFNGLBLITFRAMEBUFFER, "glBlitFramebuffer", NULL);
 	SE_GL_ASSIGN(se_glReadBuffer, PFNGLREADBUFFER, "glReadBuffer", NULL);
+	SE_GL_ASSIGN_OPTIONAL(se_glBufferStorage, PFNGLBUFFERSTORAGE, "glBufferStorage", NULL);
+	SE_GL_ASSIGN_OPTIONAL(se_glMapBufferRange, PFNGLMAPBUFFERRANGE, "glMapBufferRange", NULL);
+	SE_GL_ASSIGN_OPTIONAL(se_glFenceSync, PFNGLFENCESYNC, "glFenceSync", NULL);
+	SE_GL_ASSIGN_OPTIONAL(se_glClientWaitSync, PFNGLCLIENTWAITSYNC, "glClientWaitSync", NULL);
+	SE_GL_ASSIGN_OPTIONAL(se_glDeleteSync, PFNGLDELETESYNC, "glDeleteSync", NULL);
+	SE_GL_ASSIGN_OPTIONAL(se_glCopyBufferSubData, PFNGLCOPYBUFFERSUBDATA, "glCopyBufferSubData", NULL);
+	SE_GL_ASSIGN_OPTIONAL(se_glDrawElementsInstancedBaseVertex, PFNGLDRAWELEMENTSINSTANCEDBASEVERTEX, "glDrawElementsInstancedBaseVertex", NULL);
+	SE_GL_ASSIGN_OPTIONAL(se_glMultiDrawElementsIndirect, PFNGLMULTIDRAWELEMENTSINDIRECT, "glMultiDrawElementsIndirect", NULL);
 #endif
 	return true;
 }
@@ -698,12 +800,17 @@ b8 se_render_init(void) {
 	}
 	se_render_initialized = true;
 	se_render_generation++;
+	se_gl_state_cache_invalidate();
 	return true;
 }
 
 void se_render_shutdown(void) {
 	se_render_initialized = false;
+	se_gl_state_cache_invalidate();
 	se_is_blending = false;
+#if defined(SE_RENDER_BACKEND_SOFTWARE)
+	se_gl_soft_shutdown();
+#endif
 }
 
 b8 se_render_has_context(void) {
@@ -977,4 +1084,4 @@ void se_quad_destroy(se_quad *quad) {
 	quad->instance_buffers_dirty = false;
 }
 
-#endif // SE_RENDER_BACKEND_OPENGL || SE_RENDER_BACKEND_GLES
+#endif // SE_RENDER_BACKEND_OPENGL || SE_RENDER_BACKEND_GLES || SE_RENDER_BACKEND_SOFTWARE
@@ -143,6 +143,31 @@ typedef void(APIENTRY *PFNGLBLITFRAMEBUFFER)(GLint srcX0, GLint srcY0,
 											 GLint dstX1, GLint dstY1,
 											 GLbitfield mask, GLenum filter);
 typedef void(APIENTRY *PFNGLREADBUFFER)(GLenum src);
+typedef void(APIENTRY *PFNGLBUFFERSTORAGE)(GLenum target, GLsizeiptr size,
+										 const void *data, GLbitfield flags);
+typedef void *(APIENTRY *PFNGLMAPBUFFERRANGE)(GLenum target, GLintptr offset,
+											 GLsizeiptr length,
+											 GLbitfield access);
+typedef GLsync(APIENTRY *PFNGLFENCESYNC)(GLenum condition, GLbitfield flags);
+typedef GLenum(APIENTRY *PFNGLCLIENTWAITSYNC)(GLsync sync, GLbitfield flags,
+											 GLuint64 timeout);
+typedef void(APIENTRY *PFNGLDELETESYNC)(GLsync sync);
+typedef void(APIENTRY *PFNGLCOPYBUFFERSUBDATA)(GLenum readTarget,
+											 GLenum writeTarget,
+											 GLintptr readOffset,
+											 GLintptr writeOffset,
+											 GLsizeiptr size);
+typedef void(APIENTRY *PFNGLDRAWELEMENTSINSTANCEDBASEVERTEX)(GLenum mode,
+															 GLsizei count,
+															 GLenum type,
+															 const void *indices,
+															 GLsizei instancecount,
+															 GLint basevertex);
+typedef void(APIENTRY *PFNGLMULTIDRAWELEMENTSINDIRECT)(GLenum mode,
+													 GLenum type,
+													 const void *indirect,
+													 GLsizei drawcount,
+													 GLsizei stride);
 
 extern PFNGLDELETEBUFFERS se_glDeleteBuffers;
 extern PFNGLGENBUFFERS se_glGenBuffers;
@@ -201,6 +226,15 @@ extern PFNGLCHECKFRAMEBUFFERSTATUS se_glCheckFramebufferStatus;
 extern PFNGLGENERATEMIPMAP se_glGenerateMipmap;
 extern PFNGLBLITFRAMEBUFFER se_glBlitFramebuffer;
 extern PFNGLREADBUFFER se_glReadBuffer;
+// Optional entry points, NULL when the driver does not expose them.
+extern PFNGLBUFFERSTORAGE se_glBufferStorage;
+extern PFNGLMAPBUFFERRANGE se_glMapBufferRange;
+extern PFNGLFENCESYNC se_glFenceSync;
+extern PFNGLCLIENTWAITSYNC se_glClientWaitSync;
+extern PFNGLDELETESYNC se_glDeleteSync;
+extern PFNGLCOPYBUFFERSUBDATA se_glCopyBufferSubData;
+extern PFNGLDRAWELEMENTSINSTANCEDBASEVERTEX se_glDrawElementsInstancedBaseVertex;
+extern PFNGLMULTIDRAWELEMENTSINDIRECT se_glMultiDrawElementsIndirect;
 
 #if defined(SE_GL_NO_DISPATCH_WRAPPERS)
 
@@ -259,8 +293,22 @@ extern PFNGLREADBUFFER se_glReadBuffer;
 #define glCheckFramebufferStatus se_glCheckFramebufferStatus
 #define glGenerateMipmap se_glGenerateMipmap
 #define glBlitFramebuffer se_glBlitFramebuffer
+#define glCopyBufferSubData se_glCopyBufferSubData
+#define glDrawElementsInstancedBaseVertex se_glDrawElementsInstancedBaseVertex
+#define glMultiDrawElementsIndirect se_glMultiDrawElementsIndirect
+
+#else
 
+// Validation builds note the engine source line of each dispatched GL call so render queue
+// reports point at it; the wrapper is a comma expression, so it still calls like a function.
+#if defined(SE_RENDER_QUEUE_VALIDATION)
+extern void se_render_queue_set_call_site(const c8* site);
+#define SE_GL_SITE_LINE_(line) #line
+#define SE_GL_SITE_LINE(line) SE_GL_SITE_LINE_(line)
+#define SE_GL_SITE(fn) (se_render_queue_set_call_site(__FILE__ ":" SE_GL_SITE_LINE(__LINE__)), fn)
 #else
+#define SE_GL_SITE(fn) fn
+#endif
 
 extern void se_gl_dispatchDeleteBuffers(GLsizei n, const GLuint *buffers);
 extern void se_gl_dispatchGenBuffers(GLsizei n, GLuint *buffers);
@@ -293,6 +341,9 @@ extern void se_gl_dispatchGetShaderInfoLog(GLuint shader, GLsizei bufSize, GLsiz
 extern void se_gl_dispatchGetProgramiv(GLuint program, GLenum pname, GLint *params);
 extern void se_gl_dispatchGetProgramInfoLog(GLuint program, GLsizei bufSize, GLsizei *length, GLchar *infoLog);
 extern void se_gl_dispatchDrawElementsInstanced(GLenum mode, GLsizei count, GLenum type, const void *indices, GLsizei primcount);
+extern void se_gl_dispatchDrawElementsInstancedBaseVertex(GLenum mode, GLsizei count, GLenum type, const void *indices, GLsizei primcount, GLint basevertex);
+extern void se_gl_dispatchMultiDrawElementsIndirect(GLenum mode, GLenum type, const void *indirect, GLsizei drawcount, GLsizei stride);
+extern void se_gl_dispatchCopyBufferSubData(GLenum readTarget, GLenum writeTarget, GLintptr readOffset, GLintptr writeOffset, GLsizeiptr size);
 extern void *se_gl_dispatchMapBuffer(GLenum target, GLenum access);
 extern GLboolean se_gl_dispatchUnmapBuffer(GLenum target);
 extern GLint se_gl_dispatchGetUniformLocation(GLuint program, const GLchar *name);
@@ -323,6 +374,7 @@ extern void se_gl_dispatchDepthMask(GLboolean flag);
 extern void se_gl_dispatchStencilMask(GLuint mask);
 extern void se_gl_dispatchDepthFunc(GLenum func);
 extern void se_gl_dispatchCullFace(GLenum mode);
+extern void se_gl_dispatchPolygonOffset(GLfloat factor, GLfloat units);
 extern void se_gl_dispatchFrontFace(GLenum mode);
 extern void se_gl_dispatchDrawElements(GLenum mode, GLsizei count, GLenum type, const void *indices);
 extern void se_gl_dispatchBindTexture(GLenum target, GLuint texture);
@@ -342,94 +394,109 @@ extern void se_gl_dispatchReadBuffer(GLenum src);
 extern void se_gl_dispatchReadPixels(GLint x, GLint y, GLsizei width, GLsizei height, GLenum format, GLenum type, void *pixels);
 extern const GLubyte* se_gl_dispatchGetString(GLenum name);
 
-#define glDeleteBuffers se_gl_dispatchDeleteBuffers
-#define glGenBuffers se_gl_dispatchGenBuffers
-#define glBindBuffer se_gl_dispatchBindBuffer
-#define glBufferSubData se_gl_dispatchBufferSubData
-#define glBufferData se_gl_dispatchBufferData
-#define glUseProgram se_gl_dispatchUseProgram
-#define glCreateShader se_gl_dispatchCreateShader
-#define glShaderSource se_gl_dispatchShaderSource
-#define glCompileShader se_gl_dispatchCompileShader
-#define glCreateProgram se_gl_dispatchCreateProgram
-#define glLinkProgram se_gl_dispatchLinkProgram
-#define glAttachShader se_gl_dispatchAttachShader
-#define glDeleteProgram se_gl_dispatchDeleteProgram
-#define glDeleteShader se_gl_dispatchDeleteShader
-#define glGenRenderbuffers se_gl_dispatchGenRenderbuffers
-#define glBindFramebuffer se_gl_dispatchBindFramebuffer
-#define glFramebufferRenderbuffer se_gl_dispatchFramebufferRenderbuffer
+#define glDeleteBuffers SE_GL_SITE(se_gl_dispatchDeleteBuffers)
+#define glGenBuffers SE_GL_SITE(se_gl_dispatchGenBuffers)
+#define glBindBuffer SE_GL_SITE(se_gl_dispatchBindBuffer)
+#define glBufferSubData SE_GL_SITE(se_gl_dispatchBufferSubData)
+#define glBufferData SE_GL_SITE(se_gl_dispatchBufferData)
+#define glUseProgram SE_GL_SITE(se_gl_dispatchUseProgram)
+#define glCreateShader SE_GL_SITE(se_gl_dispatchCreateShader)
+#define glShaderSource SE_GL_SITE(se_gl_dispatchShaderSource)
+#define glCompileShader SE_GL_SITE(se_gl_dispatchCompileShader)
+#define glCreateProgram SE_GL_SITE(se_gl_dispatchCreateProgram)
+#define glLinkProgram SE_GL_SITE(se_gl_dispatchLinkProgram)
+#define glAttachShader SE_GL_SITE(se_gl_dispatchAttachShader)
+#define glDeleteProgram SE_GL_SITE(se_gl_dispatchDeleteProgram)
+#define glDeleteShader SE_GL_SITE(se_gl_dispatchDeleteShader)
+#define glGenRenderbuffers SE_GL_SITE(se_gl_dispatchGenRenderbuffers)
+#define glBindFramebuffer SE_GL_SITE(se_gl_dispatchBindFramebuffer)
+#define glFramebufferRenderbuffer SE_GL_SITE(se_gl_dispatchFramebufferRenderbuffer)
 #define glFramebufferTexture se_glFramebufferTexture
-#define glBindVertexArray se_gl_dispatchBindVertexArray
-#define glGenVertexArrays se_gl_dispatchGenVertexArrays
-#define glDeleteVertexArrays se_gl_dispatchDeleteVertexArrays
-#define glVertexAttribPointer se_gl_dispatchVertexAttribPointer
-#define glEnableVertexAttribArray se_gl_dispatchEnableVertexAttribArray
+#define glBindVertexArray SE_GL_SITE(se_gl_dispatchBindVertexArray)
+#define glGenVertexArrays SE_GL_SITE(se_gl_dispatchGenVertexArrays)
+#define glDeleteVertexArrays SE_GL_SITE(se_gl_dispatchDeleteVertexArrays)
+#define glVertexAttribPointer SE_GL_SITE(se_gl_dispatchVertexAttribPointer)
+#define glEnableVertexAttribArray SE_GL_SITE(se_gl_dispatchEnableVertexAttribArray)
 #define glDisableVertexAttribArray se_glDisableVertexAttribArray
-#define glVertexAttribDivisor se_gl_dispatchVertexAttribDivisor
-#define glDrawArraysInstanced se_gl_dispatchDrawArraysInstanced
-#define glGenFramebuffers se_gl_dispatchGenFramebuffers
-#define glFramebufferTexture2D se_gl_dispatchFramebufferTexture2D
-#define glGetShaderiv se_gl_dispatchGetShaderiv
-#define glGetShaderInfoLog se_gl_dispatchGetShaderInfoLog
-#define glGetProgramiv se_gl_dispatchGetProgramiv
-#define glGetProgramInfoLog se_gl_dispatchGetProgramInfoLog
-#define glDrawElementsInstanced se_gl_dispatchDrawElementsInstanced
-#define glMapBuffer se_gl_dispatchMapBuffer
-#define glUnmapBuffer se_gl_dispatchUnmapBuffer
-#define glGetUniformLocation se_gl_dispatchGetUniformLocation
-#define glUniform1i se_gl_dispatchUniform1i
-#define glUniform1f se_gl_dispatchUniform1f
-#define glUniform1fv se_gl_dispatchUniform1fv
-#define glUniform2fv se_gl_dispatchUniform2fv
-#define glUniform3fv se_gl_dispatchUniform3fv
-#define glUniform4fv se_gl_dispatchUniform4fv
+#define glVertexAttribDivisor SE_GL_SITE(se_gl_dispatchVertexAttribDivisor)
+#define glDrawArraysInstanced SE_GL_SITE(se_gl_dispatchDrawArraysInstanced)
+#define glGenFramebuffers SE_GL_SITE(se_gl_dispatchGenFramebuffers)
+#define glFramebufferTexture2D SE_GL_SITE(se_gl_dispatchFramebufferTexture2D)
+#define glGetShaderiv SE_GL_SITE(se_gl_dispatchGetShaderiv)
+#define glGetShaderInfoLog SE_GL_SITE(se_gl_dispatchGetShaderInfoLog)
+#define glGetProgramiv SE_GL_SITE(se_gl_dispatchGetProgramiv)
+#define glGetProgramInfoLog SE_GL_SITE(se_gl_dispatchGetProgramInfoLog)
+#define glDrawElementsInstanced SE_GL_SITE(se_gl_dispatchDrawElementsInstanced)
+#define glDrawElementsInstancedBaseVertex SE_GL_SITE(se_gl_dispatchDrawElementsInstancedBaseVertex)
+#define glMultiDrawElementsIndirect SE_GL_SITE(se_gl_dispatchMultiDrawElementsIndirect)
+#define glCopyBufferSubData SE_GL_SITE(se_gl_dispatchCopyBufferSubData)
+#define glMapBuffer SE_GL_SITE(se_gl_dispatchMapBuffer)
+#define glUnmapBuffer SE_GL_SITE(se_gl_dispatchUnmapBuffer)
+#define glGetUniformLocation SE_GL_SITE(se_gl_dispatchGetUniformLocation)
+#define glUniform1i SE_GL_SITE(se_gl_dispatchUniform1i)
+#define glUniform1f SE_GL_SITE(se_gl_dispatchUniform1f)
+#define glUniform1fv SE_GL_SITE(se_gl_dispatchUniform1fv)
+#define glUniform2fv SE_GL_SITE(se_gl_dispatchUniform2fv)
+#define glUniform3fv SE_GL_SITE(se_gl_dispatchUniform3fv)
+#define glUniform4fv SE_GL_SITE(se_gl_dispatchUniform4fv)
 #define glUniform1iv se_glUniform1iv
 #define glUniform2iv se_glUniform2iv
 #define glUniform3iv se_glUniform3iv
 #define glUniform4iv se_glUniform4iv
-#define glUniformMatrix3fv se_gl_dispatchUniformMatrix3fv
-#define glUniformMatrix4fv se_gl_dispatchUniformMatrix4fv
-#define glBindRenderbuffer se_gl_dispatchBindRenderbuffer
-#define glDeleteRenderbuffers se_gl_dispatchDeleteRenderbuffers
-#define glDeleteFramebuffers se_gl_dispatchDeleteFramebuffers
-#define glRenderbufferStorage se_gl_dispatchRenderbufferStorage
-#define glCheckFramebufferStatus se_gl_dispatchCheckFramebufferStatus
-#define glGenerateMipmap se_gl_dispatchGenerateMipmap
-#define glBlitFramebuffer se_gl_dispatchBlitFramebuffer
+#define glUniformMatrix3fv SE_GL_SITE(se_gl_dispatchUniformMatrix3fv)
+#define glUniformMatrix4fv SE_GL_SITE(se_gl_dispatchUniformMatrix4fv)
+#define glBindRenderbuffer SE_GL_SITE(se_gl_dispatchBindRenderbuffer)
+#define glDeleteRenderbuffers SE_GL_SITE(se_gl_dispatchDeleteRenderbuffers)
+#define glDeleteFramebuffers SE_GL_SITE(se_gl_dispatchDeleteFramebuffers)
+#define glRenderbufferStorage SE_GL_SITE(se_gl_dispatchRenderbufferStorage)
+#define glCheckFramebufferStatus SE_GL_SITE(se_gl_dispatchCheckFramebufferStatus)
+#define glGenerateMipmap SE_GL_SITE(se_gl_dispatchGenerateMipmap)
+#define glBlitFramebuffer SE_GL_SITE(se_gl_dispatchBlitFramebuffer)
 
-#define glEnable se_gl_dispatchEnable
-#define glDisable se_gl_dispatchDisable
-#define glBlendEquation se_gl_dispatchBlendEquation
-#define glBlendFunc se_gl_dispatchBlendFunc
-#define glClear se_gl_dispatchClear
-#define glClearColor se_gl_dispatchClearColor
-#define glColorMask se_gl_dispatchColorMask
-#define glDepthMask se_gl_dispatchDepthMask
-#define glStencilMask se_gl_dispatchStencilMask
-#define glDepthFunc se_gl_dispatchDepthFunc
-#define glCullFace se_gl_dispatchCullFace
-#define glFrontFace se_gl_dispatchFrontFace
-#define glDrawElements se_gl_dispatchDrawElements
-#define glBindTexture se_gl_dispatchBindTexture
-#define glDeleteTextures se_gl_dispatchDeleteTextures
-#define glGenTextures se_gl_dispatchGenTextures
-#define glTexImage2D se_gl_dispatchTexImage2D
-#define glTexImage3D se_gl_dispatchTexImage3D
-#define glTexParameteri se_gl_dispatchTexParameteri
-#define glActiveTexture se_gl_dispatchActiveTexture
-#define glViewport se_gl_dispatchViewport
-#define glGetIntegerv se_gl_dispatchGetIntegerv
-#define glGetBooleanv se_gl_dispatchGetBooleanv
-#define glGetFloatv se_gl_dispatchGetFloatv
-#define glIsEnabled se_gl_dispatchIsEnabled
-#define glPixelStorei se_gl_dispatchPixelStorei
-#define glReadBuffer se_gl_dispatchReadBuffer
-#define glReadPixels se_gl_dispatchReadPixels
-#define glGetString se_gl_dispatchGetString
+#define glEnable SE_GL_SITE(se_gl_dispatchEnable)
+#define glDisable SE_GL_SITE(se_gl_dispatchDisable)
+#define glBlendEquation SE_GL_SITE(se_gl_dispatchBlendEquation)
+#define glBlendFunc SE_GL_SITE(se_gl_dispatchBlendFunc)
+#define glClear SE_GL_SITE(se_gl_dispatchClear)
+#define glClearColor SE_GL_SITE(se_gl_dispatchClearColor)
+#define glColorMask SE_GL_SITE(se_gl_dispatchColorMask)
+#define glDepthMask SE_GL_SITE(se_gl_dispatchDepthMask)
+#define glStencilMask SE_GL_SITE(se_gl_dispatchStencilMask)
+#define glDepthFunc SE_GL_SITE(se_gl_dispatchDepthFunc)
+#define glCullFace SE_GL_SITE(se_gl_dispatchCullFace)
+#define glPolygonOffset SE_GL_SITE(se_gl_dispatchPolygonOffset)
+#define glFrontFace SE_GL_SITE(se_gl_dispatchFrontFace)
+#define glDrawElements SE_GL_SITE(se_gl_dispatchDrawElements)
+#define glBindTexture SE_GL_SITE(se_gl_dispatchBindTexture)
+#define glDeleteTextures SE_GL_SITE(se_gl_dispatchDeleteTextures)
+#define glGenTextures SE_GL_SITE(se_gl_dispatchGenTextures)
+#define glTexImage2D SE_GL_SITE(se_gl_dispatchTexImage2D)
+#define glTexImage3D SE_GL_SITE(se_gl_dispatchTexImage3D)
+#define glTexParameteri SE_GL_SITE(se_gl_dispatchTexParameteri)
+#define glActiveTexture SE_GL_SITE(se_gl_dispatchActiveTexture)
+#define glViewport SE_GL_SITE(se_gl_dispatchViewport)
+#define glGetIntegerv SE_GL_SITE(se_gl_dispatchGetIntegerv)
+#define glGetBooleanv SE_GL_SITE(se_gl_dispatchGetBooleanv)
+#define glGetFloatv SE_GL_SITE(se_gl_dispatchGetFloatv)
+#define glIsEnabled SE_GL_SITE(se_gl_dispatchIsEnabled)
+#define glPixelStorei SE_GL_SITE(se_gl_dispatchPixelStorei)
+#define glReadBuffer SE_GL_SITE(se_gl_dispatchReadBuffer)
+#define glReadPixels SE_GL_SITE(se_gl_dispatchReadPixels)
+#define glGetString SE_GL_SITE(se_gl_dispatchGetString)
 
 #endif
 
+// Write-once uploads: fill the returned memory, then commit. With the render thread running
+// the memory is the queued command's own blob, so the data is not copied again before GL.
+extern void* se_gl_buffer_data_reserve(GLenum target, GLsizeiptr size, GLenum usage);
+extern void* se_gl_buffer_sub_data_reserve(GLenum target, GLintptr offset, GLsizeiptr size);
+extern void se_gl_buffer_upload_commit(void* data);
+
+// Binds, enables, blend/depth state and the viewport are filtered against a per-thread shadow of
+// the context. Invalidate whenever a context is made current or may have been touched elsewhere.
+extern void se_gl_state_cache_invalidate(void);
+extern u64 se_gl_state_cache_take_skipped(void);
+
 extern b8 se_init_opengl(void);
 
 #endif // SE_GL_H
@@ -4,9 +4,14 @@
 #include "se_gl.h"
 
 #include "render/se_render_queue.h"
+#include <stdatomic.h>
 #include <stddef.h>
+#include <string.h>
 
 static b8 se_gl_dispatch_direct(void) {
+	if (se_render_queue_is_recording_secondary()) {
+		return false;
+	}
 	return !se_render_queue_is_running() || se_render_queue_is_render_thread();
 }
 
@@ -23,6 +28,284 @@ static b8 se_gl_dispatch_record_async_blob(const se_render_queue_sync_fn fn,
 	return se_render_queue_record_async_blob(fn, payload, payload_bytes, pointer_patch_offset, blob, blob_bytes);
 }
 
+#define SE_GL_STATE_UNKNOWN 0xFFFFFFFFu
+#define SE_GL_STATE_TEXTURE_UNITS 32u
+#define SE_GL_STATE_TEXTURE_TARGETS 4u
+#define SE_GL_STATE_CAPS 8u
+
+// Shadow of the GL state seen by the thread issuing GL calls; the epoch drops every
+// thread's shadow when the context changes hands.
+typedef struct {
+	u32 epoch;
+	u32 program;
+	u32 vertex_array;
+	u32 array_buffer;
+	u32 element_array_buffer;
+	u32 active_texture_unit;
+	u32 textures[SE_GL_STATE_TEXTURE_UNITS][SE_GL_STATE_TEXTURE_TARGETS];
+	u32 caps[SE_GL_STATE_CAPS];
+	u32 cap_values[SE_GL_STATE_CAPS];
+	u32 cap_count;
+	u32 blend_equation;
+	u32 blend_sfactor;
+	u32 blend_dfactor;
+	u32 depth_func;
+	u32 depth_mask;
+	i32 viewport[4];
+	b8 viewport_known;
+	u64 skipped;
+} se_gl_state_cache;
+
+static _Atomic u32 g_se_gl_state_epoch = 1u;
+static SE_THREAD_LOCAL se_gl_state_cache g_se_gl_state = {0};
+
+static se_gl_state_cache* se_gl_state(void) {
+	se_gl_state_cache* state = &g_se_gl_state;
+	const u32 epoch = atomic_load_explicit(&g_se_gl_state_epoch, memory_order_acquire);
+	if (state->epoch != epoch) {
+		const u64 skipped = state->skipped;
+		memset(state, 0xFF, sizeof(*state));
+		state->cap_count = 0u;
+		state->viewport_known = false;
+		state->skipped = skipped;
+		state->epoch = epoch;
+	}
+	return state;
+}
+
+void se_gl_state_cache_invalidate(void) {
+	atomic_fetch_add_explicit(&g_se_gl_state_epoch, 1u, memory_order_release);
+}
+
+u64 se_gl_state_cache_take_skipped(void) {
+	const u64 skipped = g_se_gl_state.skipped;
+	g_se_gl_state.skipped = 0u;
+	return skipped;
+}
+
+static b8 se_gl_state_skip(se_gl_state_cache* state, u32* slot, const u32 value) {
+	if (*slot == value) {
+		state->skipped++;
+		return true;
+	}
+	*slot = value;
+	return false;
+}
+
+static i32 se_gl_state_texture_target_index(const GLenum target) {
+	switch (target) {
+		case GL_TEXTURE_2D: return 0;
+		case GL_TEXTURE_3D: return 1;
+		case GL_TEXTURE_CUBE_MAP: return 2;
+		case GL_TEXTURE_2D_ARRAY: return 3;
+		default: return -1;
+	}
+}
+
+static void se_gl_state_forget_name(const GLuint name) {
+	se_gl_state_cache* state = se_gl_state();
+	if (name == 0u) {
+		return;
+	}
+	if (state->program == name) state->program = SE_GL_STATE_UNKNOWN;
+	if (state->vertex_array == name) {
+		state->vertex_array = SE_GL_STATE_UNKNOWN;
+		state->element_array_buffer = SE_GL_STATE_UNKNOWN;
+	}
+	if (state->array_buffer == name) state->array_buffer = SE_GL_STATE_UNKNOWN;
+	if (state->element_array_buffer == name) state->element_array_buffer = SE_GL_STATE_UNKNOWN;
+	for (u32 unit = 0u; unit < SE_GL_STATE_TEXTURE_UNITS; ++unit) {
+		for (u32 target = 0u; target < SE_GL_STATE_TEXTURE_TARGETS; ++target) {
+			if (state->textures[unit][target] == name) {
+				state->textures[unit][target] = SE_GL_STATE_UNKNOWN;
+			}
+		}
+	}
+}
+
+static void se_gl_state_use_program(const GLuint program) {
+	se_gl_state_cache* state = se_gl_state();
+	if (!se_gl_state_skip(state, &state->program, program)) {
+		glUseProgram(program);
+	}
+}
+
+static void se_gl_state_bind_buffer(const GLenum target, const GLuint buffer) {
+	se_gl_state_cache* state = se_gl_state();
+	u32* slot = target == GL_ARRAY_BUFFER ? &state->array_buffer :
+		target == GL_ELEMENT_ARRAY_BUFFER ? &state->element_array_buffer : NULL;
+	if (!slot || !se_gl_state_skip(state, slot, buffer)) {
+		glBindBuffer(target, buffer);
+	}
+}
+
+static void se_gl_state_bind_vertex_array(const GLuint array) {
+	se_gl_state_cache* state = se_gl_state();
+	if (se_gl_state_skip(state, &state->vertex_array, array)) {
+		return;
+	}
+	// The element array binding is VAO state.
+	state->element_array_buffer = SE_GL_STATE_UNKNOWN;
+	glBindVertexArray(array);
+}
+
+static void se_gl_state_active_texture(const GLenum texture) {
+	se_gl_state_cache* state = se_gl_state();
+	if (!se_gl_state_skip(state, &state->active_texture_unit, (u32)(texture - GL_TEXTURE0))) {
+		glActiveTexture(texture);
+	}
+}
+
+static void se_gl_state_bind_texture(const GLenum target, const GLuint texture) {
+	se_gl_state_cache* state = se_gl_state();
+	const i32 target_index = se_gl_state_texture_target_index(target);
+	const u32 unit = state->active_texture_unit;
+	if (target_index < 0 || unit >= SE_GL_STATE_TEXTURE_UNITS ||
+		!se_gl_state_skip(state, &state->textures[unit][target_index], texture)) {
+		glBindTexture(target, texture);
+	}
+}
+
+static void se_gl_state_set_cap(const GLenum cap, const b8 enabled) {
+	se_gl_state_cache* state = se_gl_state();
+	u32* slot = NULL;
+	for (u32 i = 0u; i < state->cap_count; ++i) {
+		if (state->caps[i] == cap) {
+			slot = &state->cap_values[i];
+			break;
+		}
+	}
+	if (!slot && state->cap_count < SE_GL_STATE_CAPS) {
+		state->caps[state->cap_count] = cap;
+		slot = &state->cap_values[state->cap_count++];
+		*slot = SE_GL_STATE_UNKNOWN;
+	}
+	if (slot && se_gl_state_skip(state, slot, enabled ? 1u : 0u)) {
+		return;
+	}
+	if (enabled) {
+		glEnable(cap);
+	} else {
+		glDisable(cap);
+	}
+}
+
+static void se_gl_state_blend_equation(const GLenum mode) {
+	se_gl_state_cache* state = se_gl_state();
+	if (!se_gl_state_skip(state, &state->blend_equation, mode)) {
+		glBlendEquation(mode);
+	}
+}
+
+static void se_gl_state_blend_func(const GLenum sfactor, const GLenum dfactor) {
+	se_gl_state_cache* state = se_gl_state();
+	if (state->blend_sfactor == sfactor && state->blend_dfactor == dfactor) {
+		state->skipped++;
+		return;
+	}
+	state->blend_sfactor = sfactor;
+	state->blend_dfactor = dfactor;
+	glBlendFunc(sfactor, dfactor);
+}
+
+static void se_gl_state_depth_func(const GLenum func) {
+	se_gl_state_cache* state = se_gl_state();
+	if (!se_gl_state_skip(state, &state->depth_func, func)) {
+		glDepthFunc(func);
+	}
+}
+
+static void se_gl_state_depth_mask(const GLboolean flag) {
+	se_gl_state_cache* state = se_gl_state();
+	if (!se_gl_state_skip(state, &state->depth_mask, flag ? 1u : 0u)) {
+		glDepthMask(flag);
+	}
+}
+
+static void se_gl_state_viewport(const GLint x, const GLint y, const GLsizei width, const GLsizei height) {
+	se_gl_state_cache* state = se_gl_state();
+	if (state->viewport_known &&
+		state->viewport[0] == x && state->viewport[1] == y &&
+		state->viewport[2] == width && state->viewport[3] == height) {
+		state->skipped++;
+		return;
+	}
+	state->viewport[0] = x;
+	state->viewport[1] = y;
+	state->viewport[2] = width;
+	state->viewport[3] = height;
+	state->viewport_known = true;
+	glViewport(x, y, width, height);
+}
+
+static void se_gl_delete_textures(const GLsizei n, const GLuint* textures) {
+	if (!textures || n <= 0) {
+		return;
+	}
+	for (GLsizei i = 0; i < n; ++i) {
+		se_gl_state_forget_name(textures[i]);
+	}
+	glDeleteTextures(n, textures);
+}
+
+// Proxy names stand in for GL names created while recording; they resolve on execution.
+static GLuint se_gl_name(const GLuint name) {
+	return (GLuint)se_render_queue_proxy_resolve((u32)name);
+}
+
+static void se_gl_delete_names(PFNGLDELETEBUFFERS delete_fn, const GLsizei n, const GLuint* ids) {
+	if (!delete_fn || !ids || n <= 0) {
+		return;
+	}
+	GLuint names[64];
+	GLsizei offset = 0;
+	while (offset < n) {
+		const GLsizei count = (n - offset) < 64 ? (n - offset) : 64;
+		for (GLsizei i = 0; i < count; ++i) {
+			names[i] = se_gl_name(ids[offset + i]);
+			se_render_queue_proxy_release((u32)ids[offset + i]);
+			se_gl_state_forget_name(names[i]);
+		}
+		delete_fn(count, names);
+		offset += count;
+	}
+}
+
+static void se_gl_delete_program_name(const GLuint program) {
+	se_gl_state_forget_name(se_gl_name(program));
+	glDeleteProgram(se_gl_name(program));
+	se_render_queue_proxy_release((u32)program);
+}
+
+static void se_gl_delete_shader_name(const GLuint shader) {
+	glDeleteShader(se_gl_name(shader));
+	se_render_queue_proxy_release((u32)shader);
+}
+
+static b8 se_gl_dispatch_reserve_proxies(const GLsizei n, GLuint* out_names) {
+	if (n <= 0 || !out_names) {
+		return false;
+	}
+	for (GLsizei i = 0; i < n; ++i) {
+		out_names[i] = (GLuint)se_render_queue_proxy_reserve();
+		if (out_names[i] == 0u) {
+			for (GLsizei j = 0; j < i; ++j) {
+				se_render_queue_proxy_release((u32)out_names[j]);
+				out_names[j] = 0u;
+			}
+			return false;
+		}
+	}
+	return true;
+}
+
+static void se_gl_dispatch_release_proxies(const GLsizei n, GLuint* names) {
+	for (GLsizei i = 0; i < n; ++i) {
+		se_render_queue_proxy_release((u32)names[i]);
+		names[i] = 0u;
+	}
+}
+
 static b8 se_gl_dispatch_compute_blob_bytes_i32(const i32 count, const u32 unit_size, u32* out_bytes) {
 	if (!out_bytes || count <= 0) {
 		return false;
@@ -84,6 +367,11 @@ typedef struct {
 	GLenum type;
 } se_gl_create_shader_payload;
 
+typedef struct {
+	GLenum type;
+	GLuint proxy;
+} se_gl_create_shader_proxy_payload;
+
 typedef struct {
 	GLuint shader;
 	GLsizei count;
@@ -193,6 +481,31 @@ typedef struct {
 	GLsizei instance_count;
 } se_gl_draw_elements_instanced_payload;
 
+typedef struct {
+	GLenum mode;
+	GLsizei count;
+	GLenum type;
+	const void* indices;
+	GLsizei instance_count;
+	GLint base_vertex;
+} se_gl_draw_elements_instanced_base_vertex_payload;
+
+typedef struct {
+	GLenum mode;
+	GLenum type;
+	const void* indirect;
+	GLsizei draw_count;
+	GLsizei stride;
+} se_gl_multi_draw_elements_indirect_payload;
+
+typedef struct {
+	GLenum read_target;
+	GLenum write_target;
+	GLintptr read_offset;
+	GLintptr write_offset;
+	GLsizeiptr size;
+} se_gl_copy_buffer_sub_data_payload;
+
 typedef struct {
 	GLenum mode;
 	GLsizei count;
@@ -256,6 +569,11 @@ typedef struct {
 	GLboolean a;
 } se_gl_color_mask_payload;
 
+typedef struct {
+	GLfloat factor;
+	GLfloat units;
+} se_gl_polygon_offset_payload;
+
 typedef struct {
 	GLbitfield mask;
 } se_gl_clear_payload;
@@ -335,14 +653,15 @@ typedef struct {
 static void se_gl_exec_delete_buffers(const void* payload, void* out_result) {
 	(void)out_result;
 	const se_gl_ids_in_payload* args = (const se_gl_ids_in_payload*)payload;
-	glDeleteBuffers(args->n, args->ids);
+	se_gl_delete_names(glDeleteBuffers, args->n, args->ids);
 }
 
 void se_gl_dispatchDeleteBuffers(GLsizei n, const GLuint *buffers) {
 	if (se_gl_dispatch_direct()) {
-		glDeleteBuffers(n, buffers);
+		se_gl_delete_names(glDeleteBuffers, n, buffers);
 		return;
 	}
+	SE_RENDER_QUEUE_VALIDATE(se_render_queue_validate_deleted("glDeleteBuffers", SE_RENDER_QUEUE_OBJECT_BUFFER, n, (const u32*)buffers));
 	const se_gl_ids_in_payload payload = {n, buffers};
 	u32 ids_bytes = 0u;
 	if (se_gl_dispatch_compute_blob_bytes_i32(n, (u32)sizeof(GLuint), &ids_bytes) && buffers != NULL) {
@@ -364,26 +683,51 @@ static void se_gl_exec_gen_buffers(const void* payload, void* out_result) {
 	glGenBuffers(args->n, args->ids);
 }
 
+static void se_gl_exec_gen_buffer_proxies(const void* payload, void* out_result) {
+	(void)out_result;
+	const se_gl_ids_in_payload* args = (const se_gl_ids_in_payload*)payload;
+	for (GLsizei i = 0; i < args->n; ++i) {
+		GLuint name = 0u;
+		glGenBuffers(1, &name);
+		se_render_queue_proxy_bind((u32)args->ids[i], (u32)name);
+	}
+}
+
 void se_gl_dispatchGenBuffers(GLsizei n, GLuint *buffers) {
 	if (se_gl_dispatch_direct()) {
 		glGenBuffers(n, buffers);
 		return;
 	}
+	u32 ids_bytes = 0u;
+	if (se_gl_dispatch_compute_blob_bytes_i32(n, (u32)sizeof(GLuint), &ids_bytes) && se_gl_dispatch_reserve_proxies(n, buffers)) {
+		const se_gl_ids_in_payload proxy_payload = {n, buffers};
+		if (se_gl_dispatch_record_async_blob(se_gl_exec_gen_buffer_proxies,
+			&proxy_payload,
+			(u32)sizeof(proxy_payload),
+			(u32)offsetof(se_gl_ids_in_payload, ids),
+			buffers,
+			ids_bytes)) {
+			return;
+		}
+		se_gl_dispatch_release_proxies(n, buffers);
+	}
 	const se_gl_ids_out_payload payload = {n, buffers};
 	(void)se_render_queue_call_sync_sized(se_gl_exec_gen_buffers, &payload, NULL, (u32)sizeof(payload));
+	SE_RENDER_QUEUE_VALIDATE(se_render_queue_validate_created(SE_RENDER_QUEUE_OBJECT_BUFFER, n, (const u32*)buffers));
 }
 
 static void se_gl_exec_bind_buffer(const void* payload, void* out_result) {
 	(void)out_result;
 	const se_gl_bind_payload* args = (const se_gl_bind_payload*)payload;
-	glBindBuffer(args->target, args->id);
+	se_gl_state_bind_buffer(args->target, se_gl_name(args->id));
 }
 
 void se_gl_dispatchBindBuffer(GLenum target, GLuint buffer) {
 	if (se_gl_dispatch_direct()) {
-		glBindBuffer(target, buffer);
+		se_gl_state_bind_buffer(target, se_gl_name(buffer));
 		return;
 	}
+	SE_RENDER_QUEUE_VALIDATE(se_render_queue_validate_bound("glBindBuffer", SE_RENDER_QUEUE_OBJECT_BUFFER, (u32)buffer));
 	const se_gl_bind_payload payload = {target, buffer};
 	if (se_gl_dispatch_record_async(se_gl_exec_bind_buffer, &payload, (u32)sizeof(payload))) {
 		return;
@@ -443,17 +787,50 @@ void se_gl_dispatchBufferData(GLenum target, GLsizeiptr size, const void *data,
 	(void)se_render_queue_call_sync_sized(se_gl_exec_buffer_data, &payload, NULL, (u32)sizeof(payload));
 }
 
+void* se_gl_buffer_data_reserve(GLenum target, GLsizeiptr size, GLenum usage) {
+	u32 blob_bytes = 0u;
+	if (!se_gl_dispatch_compute_blob_bytes_size(size, &blob_bytes)) {
+		return NULL;
+	}
+	const se_gl_buffer_data_payload payload = {target, size, NULL, usage};
+	return se_render_queue_reserve_blob(se_gl_exec_buffer_data,
+		&payload,
+		(u32)sizeof(payload),
+		(u32)offsetof(se_gl_buffer_data_payload, data),
+		blob_bytes);
+}
+
+void* se_gl_buffer_sub_data_reserve(GLenum target, GLintptr offset, GLsizeiptr size) {
+	u32 blob_bytes = 0u;
+	if (!se_gl_dispatch_compute_blob_bytes_size(size, &blob_bytes)) {
+		return NULL;
+	}
+	const se_gl_buffer_sub_data_payload payload = {target, offset, size, NULL};
+	return se_render_queue_reserve_blob(se_gl_exec_buffer_sub_data,
+		&payload,
+		(u32)sizeof(payload),
+		(u32)offsetof(se_gl_buffer_sub_data_payload, data),
+		blob_bytes);
+}
+
+void se_gl_buffer_upload_commit(void* data) {
+	if (data) {
+		(void)se_render_queue_commit_blob(data);
+	}
+}
+
 static void se_gl_exec_use_program(const void* payload, void* out_result) {
 	(void)out_result;
 	const se_gl_u32_payload* args = (const se_gl_u32_payload*)payload;
-	glUseProgram(args->value);
+	se_gl_state_use_program(se_gl_name(args->value));
 }
 
 void se_gl_dispatchUseProgram(GLuint program) {
 	if (se_gl_dispatch_direct()) {
-		glUseProgram(program);
+		se_gl_state_use_program(se_gl_name(program));
 		return;
 	}
+	SE_RENDER_QUEUE_VALIDATE(se_render_queue_validate_bound("glUseProgram", SE_RENDER_QUEUE_OBJECT_PROGRAM, (u32)program));
 	const se_gl_u32_payload payload = {program};
 	if (se_gl_dispatch_record_async(se_gl_exec_use_program, &payload, (u32)sizeof(payload))) {
 		return;
@@ -468,27 +845,42 @@ static void se_gl_exec_create_shader(const void* payload, void* out_result) {
 	}
 }
 
+static void se_gl_exec_create_shader_proxy(const void* payload, void* out_result) {
+	(void)out_result;
+	const se_gl_create_shader_proxy_payload* args = (const se_gl_create_shader_proxy_payload*)payload;
+	se_render_queue_proxy_bind((u32)args->proxy, (u32)glCreateShader(args->type));
+}
+
 GLuint se_gl_dispatchCreateShader(GLenum type) {
 	if (se_gl_dispatch_direct()) {
 		return glCreateShader(type);
 	}
+	const GLuint proxy = (GLuint)se_render_queue_proxy_reserve();
+	if (proxy != 0u) {
+		const se_gl_create_shader_proxy_payload proxy_payload = {type, proxy};
+		if (se_gl_dispatch_record_async(se_gl_exec_create_shader_proxy, &proxy_payload, (u32)sizeof(proxy_payload))) {
+			return proxy;
+		}
+		se_render_queue_proxy_release((u32)proxy);
+	}
 	const se_gl_create_shader_payload payload = {type};
 	GLuint out_shader = 0;
 	if (!se_render_queue_call_sync_sized(se_gl_exec_create_shader, &payload, &out_shader, (u32)sizeof(payload))) {
 		return 0;
 	}
+	SE_RENDER_QUEUE_VALIDATE(se_render_queue_validate_created(SE_RENDER_QUEUE_OBJECT_SHADER, 1, (const u32*)&out_shader));
 	return out_shader;
 }
 
 static void se_gl_exec_shader_source(const void* payload, void* out_result) {
 	(void)out_result;
 	const se_gl_shader_source_payload* args = (const se_gl_shader_source_payload*)payload;
-	glShaderSource(args->shader, args->count, args->string, args->length);
+	glShaderSource(se_gl_name(args->shader), args->count, args->string, args->length);
 }
 
 void se_gl_dispatchShaderSource(GLuint shader, GLsizei count, const GLchar **string, const GLint *length) {
 	if (se_gl_dispatch_direct()) {
-		glShaderSource(shader, count, string, length);
+		glShaderSource(se_gl_name(shader), count, string, length);
 		return;
 	}
 	const se_gl_shader_source_payload payload = {shader, count, string, length};
@@ -498,14 +890,15 @@ void se_gl_dispatchShaderSource(GLuint shader, GLsizei count, const GLchar **str
 static void se_gl_exec_compile_shader(const void* payload, void* out_result) {
 	(void)out_result;
 	const se_gl_u32_payload* args = (const se_gl_u32_payload*)payload;
-	glCompileShader(args->value);
+	glCompileShader(se_gl_name(args->value));
 }
 
 void se_gl_dispatchCompileShader(GLuint shader) {
 	if (se_gl_dispatch_direct()) {
-		glCompileShader(shader);
+		glCompileShader(se_gl_name(shader));
 		return;
 	}
+	SE_RENDER_QUEUE_VALIDATE(se_render_queue_validate_used("glCompileShader", SE_RENDER_QUEUE_OBJECT_SHADER, (u32)shader));
 	const se_gl_u32_payload payload = {shader};
 	if (se_gl_dispatch_record_async(se_gl_exec_compile_shader, &payload, (u32)sizeof(payload))) {
 		return;
@@ -520,28 +913,44 @@ static void se_gl_exec_create_program(const void* payload, void* out_result) {
 	}
 }
 
+static void se_gl_exec_create_program_proxy(const void* payload, void* out_result) {
+	(void)out_result;
+	const se_gl_u32_payload* args = (const se_gl_u32_payload*)payload;
+	se_render_queue_proxy_bind((u32)args->value, (u32)glCreateProgram());
+}
+
 GLuint se_gl_dispatchCreateProgram(void) {
 	if (se_gl_dispatch_direct()) {
 		return glCreateProgram();
 	}
+	const GLuint proxy = (GLuint)se_render_queue_proxy_reserve();
+	if (proxy != 0u) {
+		const se_gl_u32_payload proxy_payload = {proxy};
+		if (se_gl_dispatch_record_async(se_gl_exec_create_program_proxy, &proxy_payload, (u32)sizeof(proxy_payload))) {
+			return proxy;
+		}
+		se_render_queue_proxy_release((u32)proxy);
+	}
 	GLuint out_program = 0;
 	if (!se_render_queue_call_sync_sized(se_gl_exec_create_program, NULL, &out_program, 0u)) {
 		return 0;
 	}
+	SE_RENDER_QUEUE_VALIDATE(se_render_queue_validate_created(SE_RENDER_QUEUE_OBJECT_PROGRAM, 1, (const u32*)&out_program));
 	return out_program;
 }
 
 static void se_gl_exec_link_program(const void* payload, void* out_result) {
 	(void)out_result;
 	const se_gl_u32_payload* args = (const se_gl_u32_payload*)payload;
-	glLinkProgram(args->value);
+	glLinkProgram(se_gl_name(args->value));
 }
 
 void se_gl_dispatchLinkProgram(GLuint program) {
 	if (se_gl_dispatch_direct()) {
-		glLinkProgram(program);
+		glLinkProgram(se_gl_name(program));
 		return;
 	}
+	SE_RENDER_QUEUE_VALIDATE(se_render_queue_validate_used("glLinkProgram", SE_RENDER_QUEUE_OBJECT_PROGRAM, (u32)program));
 	const se_gl_u32_payload payload = {program};
 	if (se_gl_dispatch_record_async(se_gl_exec_link_program, &payload, (u32)sizeof(payload))) {
 		return;
@@ -552,14 +961,16 @@ void se_gl_dispatchLinkProgram(GLuint program) {
 static void se_gl_exec_attach_shader(const void* payload, void* out_result) {
 	(void)out_result;
 	const se_gl_bind_payload* args = (const se_gl_bind_payload*)payload;
-	glAttachShader(args->target, args->id);
+	glAttachShader(se_gl_name(args->target), se_gl_name(args->id));
 }
 
 void se_gl_dispatchAttachShader(GLuint program, GLuint shader) {
 	if (se_gl_dispatch_direct()) {
-		glAttachShader(program, shader);
+		glAttachShader(se_gl_name(program), se_gl_name(shader));
 		return;
 	}
+	SE_RENDER_QUEUE_VALIDATE(se_render_queue_validate_used("glAttachShader", SE_RENDER_QUEUE_OBJECT_PROGRAM, (u32)program));
+	SE_RENDER_QUEUE_VALIDATE(se_render_queue_validate_used("glAttachShader", SE_RENDER_QUEUE_OBJECT_SHADER, (u32)shader));
 	const se_gl_bind_payload payload = {program, shader};
 	if (se_gl_dispatch_record_async(se_gl_exec_attach_shader, &payload, (u32)sizeof(payload))) {
 		return;
@@ -570,14 +981,15 @@ void se_gl_dispatchAttachShader(GLuint program, GLuint shader) {
 static void se_gl_exec_delete_program(const void* payload, void* out_result) {
 	(void)out_result;
 	const se_gl_u32_payload* args = (const se_gl_u32_payload*)payload;
-	glDeleteProgram(args->value);
+	se_gl_delete_program_name(args->value);
 }
 
 void se_gl_dispatchDeleteProgram(GLuint program) {
 	if (se_gl_dispatch_direct()) {
-		glDeleteProgram(program);
+		se_gl_delete_program_name(program);
 		return;
 	}
+	SE_RENDER_QUEUE_VALIDATE(se_render_queue_validate_deleted("glDeleteProgram", SE_RENDER_QUEUE_OBJECT_PROGRAM, 1, (const u32*)&program));
 	const se_gl_u32_payload payload = {program};
 	if (se_gl_dispatch_record_async(se_gl_exec_delete_program, &payload, (u32)sizeof(payload))) {
 		return;
@@ -588,14 +1000,15 @@ void se_gl_dispatchDeleteProgram(GLuint program) {
 static void se_gl_exec_delete_shader(const void* payload, void* out_result) {
 	(void)out_result;
 	const se_gl_u32_payload* args = (const se_gl_u32_payload*)payload;
-	glDeleteShader(args->value);
+	se_gl_delete_shader_name(args->value);
 }
 
 void se_gl_dispatchDeleteShader(GLuint shader) {
 	if (se_gl_dispatch_direct()) {
-		glDeleteShader(shader);
+		se_gl_delete_shader_name(shader);
 		return;
 	}
+	SE_RENDER_QUEUE_VALIDATE(se_render_queue_validate_deleted("glDeleteShader", SE_RENDER_QUEUE_OBJECT_SHADER, 1, (const u32*)&shader));
 	const se_gl_u32_payload payload = {shader};
 	if (se_gl_dispatch_record_async(se_gl_exec_delete_shader, &payload, (u32)sizeof(payload))) {
 		return;
@@ -616,6 +1029,7 @@ void se_gl_dispatchGenRenderbuffers(GLsizei n, GLuint *renderbuffers) {
 	}
 	const se_gl_ids_out_payload payload = {n, renderbuffers};
 	(void)se_render_queue_call_sync_sized(se_gl_exec_gen_renderbuffers, &payload, NULL, (u32)sizeof(payload));
+	SE_RENDER_QUEUE_VALIDATE(se_render_queue_validate_created(SE_RENDER_QUEUE_OBJECT_RENDERBUFFER, n, (const u32*)renderbuffers));
 }
 
 static void se_gl_exec_bind_framebuffer(const void* payload, void* out_result) {
@@ -629,6 +1043,7 @@ void se_gl_dispatchBindFramebuffer(GLenum target, GLuint framebuffer) {
 		glBindFramebuffer(target, framebuffer);
 		return;
 	}
+	SE_RENDER_QUEUE_VALIDATE(se_render_queue_validate_bound("glBindFramebuffer", SE_RENDER_QUEUE_OBJECT_FRAMEBUFFER, (u32)framebuffer));
 	const se_gl_bind_payload payload = {target, framebuffer};
 	if (se_gl_dispatch_record_async(se_gl_exec_bind_framebuffer, &payload, (u32)sizeof(payload))) {
 		return;
@@ -657,14 +1072,15 @@ void se_gl_dispatchFramebufferRenderbuffer(GLenum target, GLenum attachment, GLe
 static void se_gl_exec_bind_vertex_array(const void* payload, void* out_result) {
 	(void)out_result;
 	const se_gl_u32_payload* args = (const se_gl_u32_payload*)payload;
-	glBindVertexArray(args->value);
+	se_gl_state_bind_vertex_array(se_gl_name(args->value));
 }
 
 void se_gl_dispatchBindVertexArray(GLuint array) {
 	if (se_gl_dispatch_direct()) {
-		glBindVertexArray(array);
+		se_gl_state_bind_vertex_array(se_gl_name(array));
 		return;
 	}
+	SE_RENDER_QUEUE_VALIDATE(se_render_queue_validate_bound("glBindVertexArray", SE_RENDER_QUEUE_OBJECT_VERTEX_ARRAY, (u32)array));
 	const se_gl_u32_payload payload = {array};
 	if (se_gl_dispatch_record_async(se_gl_exec_bind_vertex_array, &payload, (u32)sizeof(payload))) {
 		return;
@@ -678,26 +1094,51 @@ static void se_gl_exec_gen_vertex_arrays(const void* payload, void* out_result)
 	glGenVertexArrays(args->n, args->ids);
 }
 
+static void se_gl_exec_gen_vertex_array_proxies(const void* payload, void* out_result) {
+	(void)out_result;
+	const se_gl_ids_in_payload* args = (const se_gl_ids_in_payload*)payload;
+	for (GLsizei i = 0; i < args->n; ++i) {
+		GLuint name = 0u;
+		glGenVertexArrays(1, &name);
+		se_render_queue_proxy_bind((u32)args->ids[i], (u32)name);
+	}
+}
+
 void se_gl_dispatchGenVertexArrays(GLsizei n, GLuint *arrays) {
 	if (se_gl_dispatch_direct()) {
 		glGenVertexArrays(n, arrays);
 		return;
 	}
+	u32 ids_bytes = 0u;
+	if (se_gl_dispatch_compute_blob_bytes_i32(n, (u32)sizeof(GLuint), &ids_bytes) && se_gl_dispatch_reserve_proxies(n, arrays)) {
+		const se_gl_ids_in_payload proxy_payload = {n, arrays};
+		if (se_gl_dispatch_record_async_blob(se_gl_exec_gen_vertex_array_proxies,
+			&proxy_payload,
+			(u32)sizeof(proxy_payload),
+			(u32)offsetof(se_gl_ids_in_payload, ids),
+			arrays,
+			ids_bytes)) {
+			return;
+		}
+		se_gl_dispatch_release_proxies(n, arrays);
+	}
 	const se_gl_ids_out_payload payload = {n, arrays};
 	(void)se_render_queue_call_sync_sized(se_gl_exec_gen_vertex_arrays, &payload, NULL, (u32)sizeof(payload));
+	SE_RENDER_QUEUE_VALIDATE(se_render_queue_validate_created(SE_RENDER_QUEUE_OBJECT_VERTEX_ARRAY, n, (const u32*)arrays));
 }
 
 static void se_gl_exec_delete_vertex_arrays(const void* payload, void* out_result) {
 	(void)out_result;
 	const se_gl_ids_in_payload* args = (const se_gl_ids_in_payload*)payload;
-	glDeleteVertexArrays(args->n, args->ids);
+	se_gl_delete_names(glDeleteVertexArrays, args->n, args->ids);
 }
 
 void se_gl_dispatchDeleteVertexArrays(GLsizei n, const GLuint *arrays) {
 	if (se_gl_dispatch_direct()) {
-		glDeleteVertexArrays(n, arrays);
+		se_gl_delete_names(glDeleteVertexArrays, n, arrays);
 		return;
 	}
+	SE_RENDER_QUEUE_VALIDATE(se_render_queue_validate_deleted("glDeleteVertexArrays", SE_RENDER_QUEUE_OBJECT_VERTEX_ARRAY, n, (const u32*)arrays));
 	const se_gl_ids_in_payload payload = {n, arrays};
 	u32 ids_bytes = 0u;
 	if (se_gl_dispatch_compute_blob_bytes_i32(n, (u32)sizeof(GLuint), &ids_bytes) && arrays != NULL) {
@@ -778,6 +1219,7 @@ void se_gl_dispatchDrawArraysInstanced(GLenum mode, GLint first, GLsizei count,
 		glDrawArraysInstanced(mode, first, count, instancecount);
 		return;
 	}
+	SE_RENDER_QUEUE_VALIDATE(se_render_queue_validate_draw("glDrawArraysInstanced"));
 	const se_gl_draw_arrays_instanced_payload payload = {mode, first, count, instancecount};
 	if (se_gl_dispatch_record_async(se_gl_exec_draw_arrays_instanced, &payload, (u32)sizeof(payload))) {
 		return;
@@ -798,6 +1240,7 @@ void se_gl_dispatchGenFramebuffers(GLsizei n, GLuint *framebuffers) {
 	}
 	const se_gl_ids_out_payload payload = {n, framebuffers};
 	(void)se_render_queue_call_sync_sized(se_gl_exec_gen_framebuffers, &payload, NULL, (u32)sizeof(payload));
+	SE_RENDER_QUEUE_VALIDATE(se_render_queue_validate_created(SE_RENDER_QUEUE_OBJECT_FRAMEBUFFER, n, (const u32*)framebuffers));
 }
 
 static void se_gl_exec_framebuffer_texture2d(const void* payload, void* out_result) {
@@ -821,12 +1264,12 @@ void se_gl_dispatchFramebufferTexture2D(GLenum target, GLenum attachment, GLenum
 static void se_gl_exec_get_shader_iv(const void* payload, void* out_result) {
 	(void)out_result;
 	const se_gl_shader_iv_payload* args = (const se_gl_shader_iv_payload*)payload;
-	glGetShaderiv(args->shader, args->pname, args->out_params);
+	glGetShaderiv(se_gl_name(args->shader), args->pname, args->out_params);
 }
 
 void se_gl_dispatchGetShaderiv(GLuint shader, GLenum pname, GLint *params) {
 	if (se_gl_dispatch_direct()) {
-		glGetShaderiv(shader, pname, params);
+		glGetShaderiv(se_gl_name(shader), pname, params);
 		return;
 	}
 	const se_gl_shader_iv_payload payload = {shader, pname, params};
@@ -836,12 +1279,12 @@ void se_gl_dispatchGetShaderiv(GLuint shader, GLenum pname, GLint *params) {
 static void se_gl_exec_get_shader_info_log(const void* payload, void* out_result) {
 	(void)out_result;
 	const se_gl_shader_log_payload* args = (const se_gl_shader_log_payload*)payload;
-	glGetShaderInfoLog(args->shader, args->buf_size, args->out_length, args->out_log);
+	glGetShaderInfoLog(se_gl_name(args->shader), args->buf_size, args->out_length, args->out_log);
 }
 
 void se_gl_dispatchGetShaderInfoLog(GLuint shader, GLsizei bufSize, GLsizei *length, GLchar *infoLog) {
 	if (se_gl_dispatch_direct()) {
-		glGetShaderInfoLog(shader, bufSize, length, infoLog);
+		glGetShaderInfoLog(se_gl_name(shader), bufSize, length, infoLog);
 		return;
 	}
 	const se_gl_shader_log_payload payload = {shader, bufSize, length, infoLog};
@@ -851,12 +1294,12 @@ void se_gl_dispatchGetShaderInfoLog(GLuint shader, GLsizei bufSize, GLsizei *len
 static void se_gl_exec_get_program_iv(const void* payload, void* out_result) {
 	(void)out_result;
 	const se_gl_program_iv_payload* args = (const se_gl_program_iv_payload*)payload;
-	glGetProgramiv(args->program, args->pname, args->out_params);
+	glGetProgramiv(se_gl_name(args->program), args->pname, args->out_params);
 }
 
 void se_gl_dispatchGetProgramiv(GLuint program, GLenum pname, GLint *params) {
 	if (se_gl_dispatch_direct()) {
-		glGetProgramiv(program, pname, params);
+		glGetProgramiv(se_gl_name(program), pname, params);
 		return;
 	}
 	const se_gl_program_iv_payload payload = {program, pname, params};
@@ -866,12 +1309,12 @@ void se_gl_dispatchGetProgramiv(GLuint program, GLenum pname, GLint *params) {
 static void se_gl_exec_get_program_info_log(const void* payload, void* out_result) {
 	(void)out_result;
 	const se_gl_program_log_payload* args = (const se_gl_program_log_payload*)payload;
-	glGetProgramInfoLog(args->program, args->buf_size, args->out_length, args->out_log);
+	glGetProgramInfoLog(se_gl_name(args->program), args->buf_size, args->out_length, args->out_log);
 }
 
 void se_gl_dispatchGetProgramInfoLog(GLuint program, GLsizei bufSize, GLsizei *length, GLchar *infoLog) {
 	if (se_gl_dispatch_direct()) {
-		glGetProgramInfoLog(program, bufSize, length, infoLog);
+		glGetProgramInfoLog(se_gl_name(program), bufSize, length, infoLog);
 		return;
 	}
 	const se_gl_program_log_payload payload = {program, bufSize, length, infoLog};
@@ -889,6 +1332,7 @@ void se_gl_dispatchDrawElementsInstanced(GLenum mode, GLsizei count, GLenum type
 		glDrawElementsInstanced(mode, count, type, indices, primcount);
 		return;
 	}
+	SE_RENDER_QUEUE_VALIDATE(se_render_queue_validate_draw("glDrawElementsInstanced"));
 	const se_gl_draw_elements_instanced_payload payload = {mode, count, type, indices, primcount};
 	if (se_gl_dispatch_record_async(se_gl_exec_draw_elements_instanced, &payload, (u32)sizeof(payload))) {
 		return;
@@ -896,6 +1340,62 @@ void se_gl_dispatchDrawElementsInstanced(GLenum mode, GLsizei count, GLenum type
 	(void)se_render_queue_call_sync_sized(se_gl_exec_draw_elements_instanced, &payload, NULL, (u32)sizeof(payload));
 }
 
+static void se_gl_exec_draw_elements_instanced_base_vertex(const void* payload, void* out_result) {
+	(void)out_result;
+	const se_gl_draw_elements_instanced_base_vertex_payload* args = (const se_gl_draw_elements_instanced_base_vertex_payload*)payload;
+	glDrawElementsInstancedBaseVertex(args->mode, args->count, args->type, args->indices, args->instance_count, args->base_vertex);
+}
+
+void se_gl_dispatchDrawElementsInstancedBaseVertex(GLenum mode, GLsizei count, GLenum type, const void *indices, GLsizei primcount, GLint basevertex) {
+	if (se_gl_dispatch_direct()) {
+		glDrawElementsInstancedBaseVertex(mode, count, type, indices, primcount, basevertex);
+		return;
+	}
+	SE_RENDER_QUEUE_VALIDATE(se_render_queue_validate_draw("glDrawElementsInstancedBaseVertex"));
+	const se_gl_draw_elements_instanced_base_vertex_payload payload = {mode, count, type, indices, primcount, basevertex};
+	if (se_gl_dispatch_record_async(se_gl_exec_draw_elements_instanced_base_vertex, &payload, (u32)sizeof(payload))) {
+		return;
+	}
+	(void)se_render_queue_call_sync_sized(se_gl_exec_draw_elements_instanced_base_vertex, &payload, NULL, (u32)sizeof(payload));
+}
+
+static void se_gl_exec_multi_draw_elements_indirect(const void* payload, void* out_result) {
+	(void)out_result;
+	const se_gl_multi_draw_elements_indirect_payload* args = (const se_gl_multi_draw_elements_indirect_payload*)payload;
+	glMultiDrawElementsIndirect(args->mode, args->type, args->indirect, args->draw_count, args->stride);
+}
+
+void se_gl_dispatchMultiDrawElementsIndirect(GLenum mode, GLenum type, const void *indirect, GLsizei drawcount, GLsizei stride) {
+	if (se_gl_dispatch_direct()) {
+		glMultiDrawElementsIndirect(mode, type, indirect, drawcount, stride);
+		return;
+	}
+	SE_RENDER_QUEUE_VALIDATE(se_render_queue_validate_draw("glMultiDrawElementsIndirect"));
+	const se_gl_multi_draw_elements_indirect_payload payload = {mode, type, indirect, drawcount, stride};
+	if (se_gl_dispatch_record_async(se_gl_exec_multi_draw_elements_indirect, &payload, (u32)sizeof(payload))) {
+		return;
+	}
+	(void)se_render_queue_call_sync_sized(se_gl_exec_multi_draw_elements_indirect, &payload, NULL, (u32)sizeof(payload));
+}
+
+static void se_gl_exec_copy_buffer_sub_data(const void* payload, void* out_result) {
+	(void)out_result;
+	const se_gl_copy_buffer_sub_data_payload* args = (const se_gl_copy_buffer_sub_data_payload*)payload;
+	glCopyBufferSubData(args->read_target, args->write_target, args->read_offset, args->write_offset, args->size);
+}
+
+void se_gl_dispatchCopyBufferSubData(GLenum readTarget, GLenum writeTarget, GLintptr readOffset, GLintptr writeOffset, GLsizeiptr size) {
+	if (se_gl_dispatch_direct()) {
+		glCopyBufferSubData(readTarget, writeTarget, readOffset, writeOffset, size);
+		return;
+	}
+	const se_gl_copy_buffer_sub_data_payload payload = {readTarget, writeTarget, readOffset, writeOffset, size};
+	if (se_gl_dispatch_record_async(se_gl_exec_copy_buffer_sub_data, &payload, (u32)sizeof(payload))) {
+		return;
+	}
+	(void)se_render_queue_call_sync_sized(se_gl_exec_copy_buffer_sub_data, &payload, NULL, (u32)sizeof(payload));
+}
+
 static void se_gl_exec_map_buffer(const void* payload, void* out_result) {
 	const se_gl_map_buffer_payload* args = (const se_gl_map_buffer_payload*)payload;
 	if (out_result) {
@@ -937,13 +1437,13 @@ GLboolean se_gl_dispatchUnmapBuffer(GLenum target) {
 static void se_gl_exec_get_uniform_location(const void* payload, void* out_result) {
 	const se_gl_uniform_loc_payload* args = (const se_gl_uniform_loc_payload*)payload;
 	if (out_result) {
-		*(GLint*)out_result = glGetUniformLocation(args->program, args->name);
+		*(GLint*)out_result = glGetUniformLocation(se_gl_name(args->program), args->name);
 	}
 }
 
 GLint se_gl_dispatchGetUniformLocation(GLuint program, const GLchar *name) {
 	if (se_gl_dispatch_direct()) {
-		return glGetUniformLocation(program, name);
+		return glGetUniformLocation(se_gl_name(program), name);
 	}
 	const se_gl_uniform_loc_payload payload = {program, name};
 	GLint out_location = -1;
@@ -1156,6 +1656,7 @@ void se_gl_dispatchBindRenderbuffer(GLenum target, GLuint renderbuffer) {
 		glBindRenderbuffer(target, renderbuffer);
 		return;
 	}
+	SE_RENDER_QUEUE_VALIDATE(se_render_queue_validate_bound("glBindRenderbuffer", SE_RENDER_QUEUE_OBJECT_RENDERBUFFER, (u32)renderbuffer));
 	const se_gl_bind_payload payload = {target, renderbuffer};
 	if (se_gl_dispatch_record_async(se_gl_exec_bind_renderbuffer, &payload, (u32)sizeof(payload))) {
 		return;
@@ -1174,6 +1675,7 @@ void se_gl_dispatchDeleteRenderbuffers(GLsizei n, const GLuint *renderbuffers) {
 		glDeleteRenderbuffers(n, renderbuffers);
 		return;
 	}
+	SE_RENDER_QUEUE_VALIDATE(se_render_queue_validate_deleted("glDeleteRenderbuffers", SE_RENDER_QUEUE_OBJECT_RENDERBUFFER, n, (const u32*)renderbuffers));
 	const se_gl_ids_in_payload payload = {n, renderbuffers};
 	u32 ids_bytes = 0u;
 	if (se_gl_dispatch_compute_blob_bytes_i32(n, (u32)sizeof(GLuint), &ids_bytes) && renderbuffers != NULL) {
@@ -1200,6 +1702,7 @@ void se_gl_dispatchDeleteFramebuffers(GLsizei n, const GLuint *framebuffers) {
 		glDeleteFramebuffers(n, framebuffers);
 		return;
 	}
+	SE_RENDER_QUEUE_VALIDATE(se_render_queue_validate_deleted("glDeleteFramebuffers", SE_RENDER_QUEUE_OBJECT_FRAMEBUFFER, n, (const u32*)framebuffers));
 	const se_gl_ids_in_payload payload = {n, framebuffers};
 	u32 ids_bytes = 0u;
 	if (se_gl_dispatch_compute_blob_bytes_i32(n, (u32)sizeof(GLuint), &ids_bytes) && framebuffers != NULL) {
@@ -1291,12 +1794,12 @@ void se_gl_dispatchBlitFramebuffer(GLint srcX0, GLint srcY0, GLint srcX1, GLint
 static void se_gl_exec_enable(const void* payload, void* out_result) {
 	(void)out_result;
 	const se_gl_enable_payload* args = (const se_gl_enable_payload*)payload;
-	glEnable(args->cap);
+	se_gl_state_set_cap(args->cap, true);
 }
 
 void se_gl_dispatchEnable(GLenum cap) {
 	if (se_gl_dispatch_direct()) {
-		glEnable(cap);
+		se_gl_state_set_cap(cap, true);
 		return;
 	}
 	const se_gl_enable_payload payload = {cap};
@@ -1309,12 +1812,12 @@ void se_gl_dispatchEnable(GLenum cap) {
 static void se_gl_exec_disable(const void* payload, void* out_result) {
 	(void)out_result;
 	const se_gl_enable_payload* args = (const se_gl_enable_payload*)payload;
-	glDisable(args->cap);
+	se_gl_state_set_cap(args->cap, false);
 }
 
 void se_gl_dispatchDisable(GLenum cap) {
 	if (se_gl_dispatch_direct()) {
-		glDisable(cap);
+		se_gl_state_set_cap(cap, false);
 		return;
 	}
 	const se_gl_enable_payload payload = {cap};
@@ -1327,12 +1830,12 @@ void se_gl_dispatchDisable(GLenum cap) {
 static void se_gl_exec_blend_equation(const void* payload, void* out_result) {
 	(void)out_result;
 	const se_gl_enable_payload* args = (const se_gl_enable_payload*)payload;
-	glBlendEquation(args->cap);
+	se_gl_state_blend_equation(args->cap);
 }
 
 void se_gl_dispatchBlendEquation(GLenum mode) {
 	if (se_gl_dispatch_direct()) {
-		glBlendEquation(mode);
+		se_gl_state_blend_equation(mode);
 		return;
 	}
 	const se_gl_enable_payload payload = {mode};
@@ -1345,12 +1848,12 @@ void se_gl_dispatchBlendEquation(GLenum mode) {
 static void se_gl_exec_blend_func(const void* payload, void* out_result) {
 	(void)out_result;
 	const se_gl_blend_func_payload* args = (const se_gl_blend_func_payload*)payload;
-	glBlendFunc(args->sfactor, args->dfactor);
+	se_gl_state_blend_func(args->sfactor, args->dfactor);
 }
 
 void se_gl_dispatchBlendFunc(GLenum sfactor, GLenum dfactor) {
 	if (se_gl_dispatch_direct()) {
-		glBlendFunc(sfactor, dfactor);
+		se_gl_state_blend_func(sfactor, dfactor);
 		return;
 	}
 	const se_gl_blend_func_payload payload = {sfactor, dfactor};
@@ -1417,12 +1920,12 @@ void se_gl_dispatchColorMask(GLboolean red, GLboolean green, GLboolean blue, GLb
 static void se_gl_exec_depth_mask(const void* payload, void* out_result) {
 	(void)out_result;
 	const se_gl_color_mask_payload* args = (const se_gl_color_mask_payload*)payload;
-	glDepthMask(args->r);
+	se_gl_state_depth_mask(args->r);
 }
 
 void se_gl_dispatchDepthMask(GLboolean flag) {
 	if (se_gl_dispatch_direct()) {
-		glDepthMask(flag);
+		se_gl_state_depth_mask(flag);
 		return;
 	}
 	const se_gl_color_mask_payload payload = {flag, 0, 0, 0};
@@ -1453,12 +1956,12 @@ void se_gl_dispatchStencilMask(GLuint mask) {
 static void se_gl_exec_depth_func(const void* payload, void* out_result) {
 	(void)out_result;
 	const se_gl_enable_payload* args = (const se_gl_enable_payload*)payload;
-	glDepthFunc(args->cap);
+	se_gl_state_depth_func(args->cap);
 }
 
 void se_gl_dispatchDepthFunc(GLenum func) {
 	if (se_gl_dispatch_direct()) {
-		glDepthFunc(func);
+		se_gl_state_depth_func(func);
 		return;
 	}
 	const se_gl_enable_payload payload = {func};
@@ -1486,6 +1989,24 @@ void se_gl_dispatchCullFace(GLenum mode) {
 	(void)se_render_queue_call_sync_sized(se_gl_exec_cull_face, &payload, NULL, (u32)sizeof(payload));
 }
 
+static void se_gl_exec_polygon_offset(const void* payload, void* out_result) {
+	(void)out_result;
+	const se_gl_polygon_offset_payload* args = (const se_gl_polygon_offset_payload*)payload;
+	glPolygonOffset(args->factor, args->units);
+}
+
+void se_gl_dispatchPolygonOffset(GLfloat factor, GLfloat units) {
+	if (se_gl_dispatch_direct()) {
+		glPolygonOffset(factor, units);
+		return;
+	}
+	const se_gl_polygon_offset_payload payload = {factor, units};
+	if (se_gl_dispatch_record_async(se_gl_exec_polygon_offset, &payload, (u32)sizeof(payload))) {
+		return;
+	}
+	(void)se_render_queue_call_sync_sized(se_gl_exec_polygon_offset, &payload, NULL, (u32)sizeof(payload));
+}
+
 static void se_gl_exec_front_face(const void* payload, void* out_result) {
 	(void)out_result;
 	const se_gl_enable_payload* args = (const se_gl_enable_payload*)payload;
@@ -1515,6 +2036,7 @@ void se_gl_dispatchDrawElements(GLenum mode, GLsizei count, GLenum type, const v
 		glDrawElements(mode, count, type, indices);
 		return;
 	}
+	SE_RENDER_QUEUE_VALIDATE(se_render_queue_validate_draw("glDrawElements"));
 	const se_gl_draw_elements_payload payload = {mode, count, type, indices};
 	if (se_gl_dispatch_record_async(se_gl_exec_draw_elements, &payload, (u32)sizeof(payload))) {
 		return;
@@ -1525,14 +2047,15 @@ void se_gl_dispatchDrawElements(GLenum mode, GLsizei count, GLenum type, const v
 static void se_gl_exec_bind_texture(const void* payload, void* out_result) {
 	(void)out_result;
 	const se_gl_bind_payload* args = (const se_gl_bind_payload*)payload;
-	glBindTexture(args->target, args->id);
+	se_gl_state_bind_texture(args->target, args->id);
 }
 
 void se_gl_dispatchBindTexture(GLenum target, GLuint texture) {
 	if (se_gl_dispatch_direct()) {
-		glBindTexture(target, texture);
+		se_gl_state_bind_texture(target, texture);
 		return;
 	}
+	SE_RENDER_QUEUE_VALIDATE(se_render_queue_validate_bound("glBindTexture", SE_RENDER_QUEUE_OBJECT_TEXTURE, (u32)texture));
 	const se_gl_bind_payload payload = {target, texture};
 	if (se_gl_dispatch_record_async(se_gl_exec_bind_texture, &payload, (u32)sizeof(payload))) {
 		return;
@@ -1543,14 +2066,15 @@ void se_gl_dispatchBindTexture(GLenum target, GLuint texture) {
 static void se_gl_exec_delete_textures(const void* payload, void* out_result) {
 	(void)out_result;
 	const se_gl_ids_in_payload* args = (const se_gl_ids_in_payload*)payload;
-	glDeleteTextures(args->n, args->ids);
+	se_gl_delete_textures(args->n, args->ids);
 }
 
 void se_gl_dispatchDeleteTextures(GLsizei n, const GLuint *textures) {
 	if (se_gl_dispatch_direct()) {
-		glDeleteTextures(n, textures);
+		se_gl_delete_textures(n, textures);
 		return;
 	}
+	SE_RENDER_QUEUE_VALIDATE(se_render_queue_validate_deleted("glDeleteTextures", SE_RENDER_QUEUE_OBJECT_TEXTURE, n, (const u32*)textures));
 	const se_gl_ids_in_payload payload = {n, textures};
 	u32 ids_bytes = 0u;
 	if (se_gl_dispatch_compute_blob_bytes_i32(n, (u32)sizeof(GLuint), &ids_bytes) && textures != NULL) {
@@ -1579,6 +2103,7 @@ void se_gl_dispatchGenTextures(GLsizei n, GLuint *textures) {
 	}
 	const se_gl_ids_out_payload payload = {n, textures};
 	(void)se_render_queue_call_sync_sized(se_gl_exec_gen_textures, &payload, NULL, (u32)sizeof(payload));
+	SE_RENDER_QUEUE_VALIDATE(se_render_queue_validate_created(SE_RENDER_QUEUE_OBJECT_TEXTURE, n, (const u32*)textures));
 }
 
 static void se_gl_exec_tex_image_2d(const void* payload, void* out_result) {
@@ -1632,12 +2157,12 @@ void se_gl_dispatchTexParameteri(GLenum target, GLenum pname, GLint param) {
 static void se_gl_exec_active_texture(const void* payload, void* out_result) {
 	(void)out_result;
 	const se_gl_enable_payload* args = (const se_gl_enable_payload*)payload;
-	glActiveTexture(args->cap);
+	se_gl_state_active_texture(args->cap);
 }
 
 void se_gl_dispatchActiveTexture(GLenum texture) {
 	if (se_gl_dispatch_direct()) {
-		glActiveTexture(texture);
+		se_gl_state_active_texture(texture);
 		return;
 	}
 	const se_gl_enable_payload payload = {texture};
@@ -1650,12 +2175,12 @@ void se_gl_dispatchActiveTexture(GLenum texture) {
 static void se_gl_exec_viewport(const void* payload, void* out_result) {
 	(void)out_result;
 	const se_gl_viewport_payload* args = (const se_gl_viewport_payload*)payload;
-	glViewport(args->x, args->y, args->width, args->height);
+	se_gl_state_viewport(args->x, args->y, args->width, args->height);
 }
 
 void se_gl_dispatchViewport(GLint x, GLint y, GLsizei width, GLsizei height) {
 	if (se_gl_dispatch_direct()) {
-		glViewport(x, y, width, height);
+		se_gl_state_viewport(x, y, width, height);
 		return;
 	}
 	const se_gl_viewport_payload payload = {x, y, width, height};
@@ -1798,3 +2323,105 @@ const GLubyte* se_gl_dispatchGetString(GLenum name) {
 	}
 	return out_string;
 }
+
+#define SE_GL_DISPATCH_COMMAND(fn, kind, payload) {fn, #fn, kind, (u32)sizeof(payload), 0u}
+#define SE_GL_DISPATCH_COMMAND_NO_PAYLOAD(fn, kind) {fn, #fn, kind, 0u, 0u}
+// Blob pointers are patched on replay and draw/attrib pointers are buffer offsets; these
+// payloads point at caller memory instead.
+#define SE_GL_DISPATCH_COMMAND_NO_REPLAY(fn, kind, payload) {fn, #fn, kind, (u32)sizeof(payload), SE_RENDER_QUEUE_COMMAND_NO_REPLAY}
+
+static const se_render_queue_command_info g_se_gl_dispatch_commands[] = {
+	SE_GL_DISPATCH_COMMAND(se_gl_exec_active_texture, SE_RENDER_THREAD_COMMAND_STATE, se_gl_enable_payload),
+	SE_GL_DISPATCH_COMMAND(se_gl_exec_attach_shader, SE_RENDER_THREAD_COMMAND_RESOURCE, se_gl_bind_payload),
+	SE_GL_DISPATCH_COMMAND(se_gl_exec_bind_buffer, SE_RENDER_THREAD_COMMAND_STATE, se_gl_bind_payload),
+	SE_GL_DISPATCH_COMMAND(se_gl_exec_bind_framebuffer, SE_RENDER_THREAD_COMMAND_STATE, se_gl_bind_payload),
+	SE_GL_DISPATCH_COMMAND(se_gl_exec_bind_renderbuffer, SE_RENDER_THREAD_COMMAND_STATE, se_gl_bind_payload),
+	SE_GL_DISPATCH_COMMAND(se_gl_exec_bind_texture, SE_RENDER_THREAD_COMMAND_STATE, se_gl_bind_payload),
+	SE_GL_DISPATCH_COMMAND(se_gl_exec_bind_vertex_array, SE_RENDER_THREAD_COMMAND_STATE, se_gl_u32_payload),
+	SE_GL_DISPATCH_COMMAND(se_gl_exec_blend_equation, SE_RENDER_THREAD_COMMAND_STATE, se_gl_enable_payload),
+	SE_GL_DISPATCH_COMMAND(se_gl_exec_blend_func, SE_RENDER_THREAD_COMMAND_STATE, se_gl_blend_func_payload),
+	SE_GL_DISPATCH_COMMAND(se_gl_exec_blit_framebuffer, SE_RENDER_THREAD_COMMAND_DRAW, se_gl_blit_framebuffer_payload),
+	SE_GL_DISPATCH_COMMAND(se_gl_exec_buffer_data, SE_RENDER_THREAD_COMMAND_UPLOAD, se_gl_buffer_data_payload),
+	SE_GL_DISPATCH_COMMAND(se_gl_exec_buffer_sub_data, SE_RENDER_THREAD_COMMAND_UPLOAD, se_gl_buffer_sub_data_payload),
+	SE_GL_DISPATCH_COMMAND(se_gl_exec_check_framebuffer_status, SE_RENDER_THREAD_COMMAND_STATE, se_gl_framebuffer_status_payload),
+	SE_GL_DISPATCH_COMMAND(se_gl_exec_clear, SE_RENDER_THREAD_COMMAND_DRAW, se_gl_clear_payload),
+	SE_GL_DISPATCH_COMMAND(se_gl_exec_clear_color, SE_RENDER_THREAD_COMMAND_STATE, se_gl_clear_color_payload),
+	SE_GL_DISPATCH_COMMAND(se_gl_exec_color_mask, SE_RENDER_THREAD_COMMAND_STATE, se_gl_color_mask_payload),
+	SE_GL_DISPATCH_COMMAND(se_gl_exec_compile_shader, SE_RENDER_THREAD_COMMAND_RESOURCE, se_gl_u32_payload),
+	SE_GL_DISPATCH_COMMAND(se_gl_exec_copy_buffer_sub_data, SE_RENDER_THREAD_COMMAND_UPLOAD, se_gl_copy_buffer_sub_data_payload),
+	SE_GL_DISPATCH_COMMAND_NO_PAYLOAD(se_gl_exec_create_program, SE_RENDER_THREAD_COMMAND_RESOURCE),
+	SE_GL_DISPATCH_COMMAND(se_gl_exec_create_program_proxy, SE_RENDER_THREAD_COMMAND_RESOURCE, se_gl_u32_payload),
+	SE_GL_DISPATCH_COMMAND(se_gl_exec_create_shader, SE_RENDER_THREAD_COMMAND_RESOURCE, se_gl_create_shader_payload),
+	SE_GL_DISPATCH_COMMAND(se_gl_exec_create_shader_proxy, SE_RENDER_THREAD_COMMAND_RESOURCE, se_gl_create_shader_proxy_payload),
+	SE_GL_DISPATCH_COMMAND(se_gl_exec_cull_face, SE_RENDER_THREAD_COMMAND_STATE, se_gl_enable_payload),
+	SE_GL_DISPATCH_COMMAND(se_gl_exec_delete_buffers, SE_RENDER_THREAD_COMMAND_RESOURCE, se_gl_ids_in_payload),
+	SE_GL_DISPATCH_COMMAND(se_gl_exec_delete_framebuffers, SE_RENDER_THREAD_COMMAND_RESOURCE, se_gl_ids_in_payload),
+	SE_GL_DISPATCH_COMMAND(se_gl_exec_delete_program, SE_RENDER_THREAD_COMMAND_RESOURCE, se_gl_u32_payload),
+	SE_GL_DISPATCH_COMMAND(se_gl_exec_delete_renderbuffers, SE_RENDER_THREAD_COMMAND_RESOURCE, se_gl_ids_in_payload),
+	SE_GL_DISPATCH_COMMAND(se_gl_exec_delete_shader, SE_RENDER_THREAD_COMMAND_RESOURCE, se_gl_u32_payload),
+	SE_GL_DISPATCH_COMMAND(se_gl_exec_delete_textures, SE_RENDER_THREAD_COMMAND_RESOURCE, se_gl_ids_in_payload),
+	SE_GL_DISPATCH_COMMAND(se_gl_exec_delete_vertex_arrays, SE_RENDER_THREAD_COMMAND_RESOURCE, se_gl_ids_in_payload),
+	SE_GL_DISPATCH_COMMAND(se_gl_exec_depth_func, SE_RENDER_THREAD_COMMAND_STATE, se_gl_enable_payload),
+	SE_GL_DISPATCH_COMMAND(se_gl_exec_depth_mask, SE_RENDER_THREAD_COMMAND_STATE, se_gl_color_mask_payload),
+	SE_GL_DISPATCH_COMMAND(se_gl_exec_disable, SE_RENDER_THREAD_COMMAND_STATE, se_gl_enable_payload),
+	SE_GL_DISPATCH_COMMAND(se_gl_exec_draw_arrays_instanced, SE_RENDER_THREAD_COMMAND_DRAW, se_gl_draw_arrays_instanced_payload),
+	SE_GL_DISPATCH_COMMAND(se_gl_exec_draw_elements, SE_RENDER_THREAD_COMMAND_DRAW, se_gl_draw_elements_payload),
+	SE_GL_DISPATCH_COMMAND(se_gl_exec_draw_elements_instanced, SE_RENDER_THREAD_COMMAND_DRAW, se_gl_draw_elements_instanced_payload),
+	SE_GL_DISPATCH_COMMAND(se_gl_exec_draw_elements_instanced_base_vertex, SE_RENDER_THREAD_COMMAND_DRAW, se_gl_draw_elements_instanced_base_vertex_payload),
+	SE_GL_DISPATCH_COMMAND(se_gl_exec_enable, SE_RENDER_THREAD_COMMAND_STATE, se_gl_enable_payload),
+	SE_GL_DISPATCH_COMMAND(se_gl_exec_enable_vertex_attrib_array, SE_RENDER_THREAD_COMMAND_STATE, se_gl_vertex_attrib_index_payload),
+	SE_GL_DISPATCH_COMMAND(se_gl_exec_framebuffer_renderbuffer, SE_RENDER_THREAD_COMMAND_RESOURCE, se_gl_framebuffer_renderbuffer_payload),
+	SE_GL_DISPATCH_COMMAND(se_gl_exec_framebuffer_texture2d, SE_RENDER_THREAD_COMMAND_RESOURCE, se_gl_framebuffer_texture2d_payload),
+	SE_GL_DISPATCH_COMMAND(se_gl_exec_front_face, SE_RENDER_THREAD_COMMAND_STATE, se_gl_enable_payload),
+	SE_GL_DISPATCH_COMMAND(se_gl_exec_gen_buffer_proxies, SE_RENDER_THREAD_COMMAND_RESOURCE, se_gl_ids_in_payload),
+	SE_GL_DISPATCH_COMMAND_NO_REPLAY(se_gl_exec_gen_buffers, SE_RENDER_THREAD_COMMAND_RESOURCE, se_gl_ids_out_payload),
+	SE_GL_DISPATCH_COMMAND_NO_REPLAY(se_gl_exec_gen_framebuffers, SE_RENDER_THREAD_COMMAND_RESOURCE, se_gl_ids_out_payload),
+	SE_GL_DISPATCH_COMMAND_NO_REPLAY(se_gl_exec_gen_renderbuffers, SE_RENDER_THREAD_COMMAND_RESOURCE, se_gl_ids_out_payload),
+	SE_GL_DISPATCH_COMMAND_NO_REPLAY(se_gl_exec_gen_textures, SE_RENDER_THREAD_COMMAND_RESOURCE, se_gl_ids_out_payload),
+	SE_GL_DISPATCH_COMMAND(se_gl_exec_gen_vertex_array_proxies, SE_RENDER_THREAD_COMMAND_RESOURCE, se_gl_ids_in_payload),
+	SE_GL_DISPATCH_COMMAND_NO_REPLAY(se_gl_exec_gen_vertex_arrays, SE_RENDER_THREAD_COMMAND_RESOURCE, se_gl_ids_out_payload),
+	SE_GL_DISPATCH_COMMAND(se_gl_exec_generate_mipmap, SE_RENDER_THREAD_COMMAND_UPLOAD, se_gl_framebuffer_status_payload),
+	SE_GL_DISPATCH_COMMAND_NO_REPLAY(se_gl_exec_get_booleanv, SE_RENDER_THREAD_COMMAND_STATE, se_gl_get_bool_payload),
+	SE_GL_DISPATCH_COMMAND_NO_REPLAY(se_gl_exec_get_floatv, SE_RENDER_THREAD_COMMAND_STATE, se_gl_get_float_payload),
+	SE_GL_DISPATCH_COMMAND_NO_REPLAY(se_gl_exec_get_integerv, SE_RENDER_THREAD_COMMAND_STATE, se_gl_get_int_payload),
+	SE_GL_DISPATCH_COMMAND_NO_REPLAY(se_gl_exec_get_program_info_log, SE_RENDER_THREAD_COMMAND_STATE, se_gl_program_log_payload),
+	SE_GL_DISPATCH_COMMAND_NO_REPLAY(se_gl_exec_get_program_iv, SE_RENDER_THREAD_COMMAND_STATE, se_gl_program_iv_payload),
+	SE_GL_DISPATCH_COMMAND_NO_REPLAY(se_gl_exec_get_shader_info_log, SE_RENDER_THREAD_COMMAND_STATE, se_gl_shader_log_payload),
+	SE_GL_DISPATCH_COMMAND_NO_REPLAY(se_gl_exec_get_shader_iv, SE_RENDER_THREAD_COMMAND_STATE, se_gl_shader_iv_payload),
+	SE_GL_DISPATCH_COMMAND(se_gl_exec_get_string, SE_RENDER_THREAD_COMMAND_STATE, se_gl_get_string_payload),
+	SE_GL_DISPATCH_COMMAND_NO_REPLAY(se_gl_exec_get_uniform_location, SE_RENDER_THREAD_COMMAND_STATE, se_gl_uniform_loc_payload),
+	SE_GL_DISPATCH_COMMAND(se_gl_exec_is_enabled, SE_RENDER_THREAD_COMMAND_STATE, se_gl_enable_payload),
+	SE_GL_DISPATCH_COMMAND(se_gl_exec_link_program, SE_RENDER_THREAD_COMMAND_RESOURCE, se_gl_u32_payload),
+	SE_GL_DISPATCH_COMMAND(se_gl_exec_map_buffer, SE_RENDER_THREAD_COMMAND_UPLOAD, se_gl_map_buffer_payload),
+	SE_GL_DISPATCH_COMMAND(se_gl_exec_multi_draw_elements_indirect, SE_RENDER_THREAD_COMMAND_DRAW, se_gl_multi_draw_elements_indirect_payload),
+	SE_GL_DISPATCH_COMMAND(se_gl_exec_pixel_store_i, SE_RENDER_THREAD_COMMAND_STATE, se_gl_pixel_store_i_payload),
+	SE_GL_DISPATCH_COMMAND(se_gl_exec_polygon_offset, SE_RENDER_THREAD_COMMAND_STATE, se_gl_polygon_offset_payload),
+	SE_GL_DISPATCH_COMMAND(se_gl_exec_read_buffer, SE_RENDER_THREAD_COMMAND_STATE, se_gl_enable_payload),
+	SE_GL_DISPATCH_COMMAND_NO_REPLAY(se_gl_exec_read_pixels, SE_RENDER_THREAD_COMMAND_UPLOAD, se_gl_read_pixels_payload),
+	SE_GL_DISPATCH_COMMAND(se_gl_exec_renderbuffer_storage, SE_RENDER_THREAD_COMMAND_RESOURCE, se_gl_renderbuffer_storage_payload),
+	SE_GL_DISPATCH_COMMAND_NO_REPLAY(se_gl_exec_shader_source, SE_RENDER_THREAD_COMMAND_RESOURCE, se_gl_shader_source_payload),
+	SE_GL_DISPATCH_COMMAND(se_gl_exec_stencil_mask, SE_RENDER_THREAD_COMMAND_STATE, se_gl_u32_payload),
+	SE_GL_DISPATCH_COMMAND_NO_REPLAY(se_gl_exec_tex_image_2d, SE_RENDER_THREAD_COMMAND_UPLOAD, se_gl_tex_image_2d_payload),
+	SE_GL_DISPATCH_COMMAND_NO_REPLAY(se_gl_exec_tex_image_3d, SE_RENDER_THREAD_COMMAND_UPLOAD, se_gl_tex_image_3d_payload),
+	SE_GL_DISPATCH_COMMAND(se_gl_exec_tex_param_i, SE_RENDER_THREAD_COMMAND_STATE, se_gl_tex_param_i_payload),
+	SE_GL_DISPATCH_COMMAND(se_gl_exec_uniform1f, SE_RENDER_THREAD_COMMAND_STATE, se_gl_uniform1f_payload),
+	SE_GL_DISPATCH_COMMAND(se_gl_exec_uniform1fv, SE_RENDER_THREAD_COMMAND_STATE, se_gl_uniform_fv_payload),
+	SE_GL_DISPATCH_COMMAND(se_gl_exec_uniform1i, SE_RENDER_THREAD_COMMAND_STATE, se_gl_uniform1i_payload),
+	SE_GL_DISPATCH_COMMAND(se_gl_exec_uniform2fv, SE_RENDER_THREAD_COMMAND_STATE, se_gl_uniform_fv_payload),
+	SE_GL_DISPATCH_COMMAND(se_gl_exec_uniform3fv, SE_RENDER_THREAD_COMMAND_STATE, se_gl_uniform_fv_payload),
+	SE_GL_DISPATCH_COMMAND(se_gl_exec_uniform4fv, SE_RENDER_THREAD_COMMAND_STATE, se_gl_uniform_fv_payload),
+	SE_GL_DISPATCH_COMMAND(se_gl_exec_uniform_matrix3fv, SE_RENDER_THREAD_COMMAND_STATE, se_gl_uniform_matrix_payload),
+	SE_GL_DISPATCH_COMMAND(se_gl_exec_uniform_matrix4fv, SE_RENDER_THREAD_COMMAND_STATE, se_gl_uniform_matrix_payload),
+	SE_GL_DISPATCH_COMMAND(se_gl_exec_unmap_buffer, SE_RENDER_THREAD_COMMAND_UPLOAD, se_gl_unmap_buffer_payload),
+	SE_GL_DISPATCH_COMMAND(se_gl_exec_use_program, SE_RENDER_THREAD_COMMAND_STATE, se_gl_u32_payload),
+	SE_GL_DISPATCH_COMMAND(se_gl_exec_vertex_attrib_divisor, SE_RENDER_THREAD_COMMAND_STATE, se_gl_vertex_attrib_divisor_payload),
+	SE_GL_DISPATCH_COMMAND(se_gl_exec_vertex_attrib_pointer, SE_RENDER_THREAD_COMMAND_STATE, se_gl_vertex_attrib_pointer_payload),
+	SE_GL_DISPATCH_COMMAND(se_gl_exec_viewport, SE_RENDER_THREAD_COMMAND_STATE, se_gl_viewport_payload)
+};
+
+const se_render_queue_command_info* se_gl_dispatch_get_commands(u32* out_count) {
+	if (out_count) {
+		*out_count = (u32)(sizeof(g_se_gl_dispatch_commands) / sizeof(g_se_gl_dispatch_commands[0]));
+	}
+	return g_se_gl_dispatch_commands;
+}
@@ -0,0 +1,2541 @@
+// Syphax-Engine - Ougi Washi
+
+#if defined(SE_RENDER_BACKEND_SOFTWARE)
+
+#define SE_GL_NO_DISPATCH_WRAPPERS
+#include "se_gl.h"
+
+#include "render/se_gl_soft.h"
+#include "render/se_soft_glsl.h"
+#include "se_debug.h"
+
+#include <errno.h>
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#define SE_GL_SOFT_LOG_SIZE 2048u
+#define SE_GL_SOFT_TEXTURE_2D 0u
+#define SE_GL_SOFT_TEXTURE_3D 1u
+#define SE_GL_SOFT_MAX_TEXTURE_SIZE 8192
+#define SE_GL_SOFT_MAX_3D_TEXTURE_SIZE 512
+#define SE_GL_SOFT_MAX_THREADS 64u
+// Vertices shaded per worker task, and per raster submission, so transient memory stays bounded.
+#define SE_GL_SOFT_VERTEX_BATCH 64u
+#define SE_GL_SOFT_SUBMIT_VERTICES 65536u
+
+typedef enum {
+	SE_GL_SOFT_CAP_BLEND = 0,
+	SE_GL_SOFT_CAP_DEPTH_TEST,
+	SE_GL_SOFT_CAP_CULL_FACE,
+	SE_GL_SOFT_CAP_POLYGON_OFFSET_FILL,
+	SE_GL_SOFT_CAP_SCISSOR_TEST,
+	SE_GL_SOFT_CAP_STENCIL_TEST,
+	SE_GL_SOFT_CAP_DITHER,
+	SE_GL_SOFT_CAP_MULTISAMPLE,
+	SE_GL_SOFT_CAP_FRAMEBUFFER_SRGB,
+	SE_GL_SOFT_CAP_PROGRAM_POINT_SIZE,
+	SE_GL_SOFT_CAP_COUNT
+} se_gl_soft_cap;
+
+// Object names index these tables; slot i holds name i + 1. Freed names are handed out again
+// only after the cursor wraps, so a stale name rarely aliases a new object.
+typedef struct {
+	void** items;
+	u32 capacity;
+	u32 count;
+	u32 cursor;
+} se_gl_soft_table;
+
+typedef struct {
+	u8* data;
+	sz size;
+	b8 mapped;
+} se_gl_soft_buffer;
+
+typedef struct {
+	GLuint buffer;
+	const u8* pointer;
+	GLint size;
+	GLenum type;
+	b8 normalized;
+	GLsizei stride;
+	GLuint divisor;
+	b8 enabled;
+} se_gl_soft_attrib;
+
+typedef struct {
+	se_gl_soft_attrib attribs[SE_SOFT_GLSL_MAX_ATTRIBUTES];
+	GLuint element_buffer;
+} se_gl_soft_vertex_array;
+
+// Allocated one by one so samplers and raster targets can keep pointers to the image.
+typedef struct {
+	GLenum target;
+	se_soft_image image;
+	se_soft_wrap wrap[3];
+	b8 linear;
+} se_gl_soft_texture;
+
+typedef struct {
+	se_soft_image image;
+} se_gl_soft_renderbuffer;
+
+typedef struct {
+	GLuint texture;
+	GLuint renderbuffer;
+} se_gl_soft_attachment;
+
+typedef struct {
+	se_gl_soft_attachment color;
+	se_gl_soft_attachment depth;
+} se_gl_soft_framebuffer;
+
+typedef struct {
+	GLenum type;
+	c8* source;
+	b8 compiled;
+	b8 delete_pending;
+	u32 attachments;
+	c8 log[SE_GL_SOFT_LOG_SIZE];
+} se_gl_soft_shader;
+
+typedef struct {
+	GLuint shaders[SE_SOFT_GLSL_STAGE_COUNT];
+	se_soft_glsl_program* program;
+	b8 delete_pending;
+	c8 log[SE_GL_SOFT_LOG_SIZE];
+} se_gl_soft_program;
+
+// Uniforms and samplers of one draw, kept until the raster flushes; the uniform copy follows.
+typedef struct se_gl_soft_snapshot {
+	struct se_gl_soft_snapshot* next;
+	se_soft_glsl_draw draw;
+} se_gl_soft_snapshot;
+
+// What a vertex-shading task reads: attribute sources resolved to memory up front so workers
+// never touch the object tables.
+typedef struct {
+	const u8* data;
+	sz available;
+	u32 stride;
+	u32 size;
+	GLenum type;
+	b8 normalized;
+	u32 divisor;
+} se_gl_soft_attrib_source;
+
+typedef struct {
+	const se_soft_glsl_draw* draw;
+	se_gl_soft_attrib_source sources[SE_SOFT_GLSL_MAX_ATTRIBUTES];
+	u32 attribute_mask;
+	u32 enabled_mask;
+	const u32* vertices;
+	u32 vertex_count;
+	u32 first_instance;
+	u32 total;
+	u32 scratch_bytes;
+	u32 vertex_floats;
+	f32* out;
+} se_gl_soft_vertex_job;
+
+typedef struct {
+	b8 initialized;
+	se_gl_soft_table buffers;
+	se_gl_soft_table vertex_arrays;
+	se_gl_soft_table textures;
+	se_gl_soft_table renderbuffers;
+	se_gl_soft_table framebuffers;
+	se_gl_soft_table shaders;
+	se_gl_soft_table programs;
+	se_gl_soft_vertex_array default_vertex_array;
+	GLuint vertex_array;
+	GLuint array_buffer;
+	GLuint copy_read_buffer;
+	GLuint copy_write_buffer;
+	GLuint uniform_buffer;
+	GLuint pixel_pack_buffer;
+	GLuint pixel_unpack_buffer;
+	GLuint draw_indirect_buffer;
+	GLuint texture_buffer;
+	GLuint program;
+	GLuint renderbuffer;
+	GLuint draw_framebuffer;
+	GLuint read_framebuffer;
+	GLenum read_buffer;
+	u32 active_texture;
+	GLuint bound_textures[SE_SOFT_GLSL_MAX_TEXTURE_UNITS][SE_SOFT_GLSL_SAMPLER_KIND_COUNT];
+	b8 caps[SE_GL_SOFT_CAP_COUNT];
+	GLenum blend_src_rgb;
+	GLenum blend_dst_rgb;
+	GLenum blend_src_alpha;
+	GLenum blend_dst_alpha;
+	GLenum blend_equation_rgb;
+	GLenum blend_equation_alpha;
+	GLenum depth_func;
+	b8 depth_mask;
+	b8 color_mask[4];
+	GLuint stencil_mask;
+	GLenum cull_mode;
+	GLenum front_face;
+	f32 polygon_offset_factor;
+	f32 polygon_offset_units;
+	i32 viewport[4];
+	f32 clear_color[4];
+	f32 clear_depth;
+	i32 pack_alignment;
+	i32 unpack_alignment;
+	GLenum error;
+	se_soft_image surface_color;
+	se_soft_image surface_depth;
+	se_soft_raster* raster;
+	se_worker_pool* workers;
+	se_soft_image* target_color;
+	se_soft_image* target_depth;
+	u32 target_width;
+	u32 target_height;
+	se_gl_soft_snapshot* snapshots;
+	u32* elements;
+	sz element_capacity;
+	u32* vertices;
+	sz vertex_capacity;
+	u32* triangles;
+	sz triangle_capacity;
+	u32* indices;
+	sz index_capacity;
+	f32* shaded;
+	sz shaded_capacity;
+} se_gl_soft_context;
+
+static se_gl_soft_context g_se_gl_soft = {0};
+
+static void se_gl_soft_error(const GLenum error) {
+	if (g_se_gl_soft.error == GL_NO_ERROR) {
+		g_se_gl_soft.error = error;
+	}
+}
+
+static b8 se_gl_soft_reserve(void** data, sz* capacity, const sz bytes) {
+	if (bytes <= *capacity) {
+		return true;
+	}
+	sz next = *capacity > 0u ? *capacity : 256u;
+	while (next < bytes) {
+		next *= 2u;
+	}
+	void* grown = realloc(*data, next);
+	if (!grown) {
+		return false;
+	}
+	*data = grown;
+	*capacity = next;
+	return true;
+}
+
+static GLuint se_gl_soft_table_add(se_gl_soft_table* table, void* item) {
+	u32 slot = UINT32_MAX;
+	for (u32 i = table->cursor; i < table->capacity; ++i) {
+		if (!table->items[i]) {
+			slot = i;
+			break;
+		}
+	}
+	if (slot == UINT32_MAX && table->count * 2u < table->capacity) {
+		for (u32 i = 0u; i < table->cursor && i < table->capacity; ++i) {
+			if (!table->items[i]) {
+				slot = i;
+				break;
+			}
+		}
+	}
+	if (slot == UINT32_MAX) {
+		const u32 capacity = table->capacity > 0u ? table->capacity * 2u : 64u;
+		void** items = (void**)realloc(table->items, sizeof(*items) * capacity);
+		if (!items) {
+			return 0u;
+		}
+		memset(items + table->capacity, 0, sizeof(*items) * (capacity - table->capacity));
+		slot = table->capacity;
+		table->items = items;
+		table->capacity = capacity;
+	}
+	table->items[slot] = item;
+	table->count++;
+	table->cursor = slot + 1u;
+	return slot + 1u;
+}
+
+static void* se_gl_soft_table_get(const se_gl_soft_table* table, const GLuint name) {
+	if (name == 0u || name > table->capacity) {
+		return NULL;
+	}
+	return table->items[name - 1u];
+}
+
+static void* se_gl_soft_table_remove(se_gl_soft_table* table, const GLuint name) {
+	void* item = se_gl_soft_table_get(table, name);
+	if (item) {
+		table->items[name - 1u] = NULL;
+		table->count--;
+	}
+	return item;
+}
+
+static void se_gl_soft_gen(se_gl_soft_table* table, const sz item_size, const GLsizei n, GLuint* out_names) {
+	if (n < 0) {
+		se_gl_soft_error(GL_INVALID_VALUE);
+		return;
+	}
+	if (!out_names) {
+		return;
+	}
+	for (GLsizei i = 0; i < n; ++i) {
+		void* item = calloc(1u, item_size);
+		const GLuint name = item ? se_gl_soft_table_add(table, item) : 0u;
+		if (name == 0u) {
+			free(item);
+			se_gl_soft_error(GL_OUT_OF_MEMORY);
+		}
+		out_names[i] = name;
+	}
+}
+
+// Pixels only change when the raster flushes; every snapshot is released with it.
+static void se_gl_soft_flush(void) {
+	if (g_se_gl_soft.raster) {
+		se_soft_raster_flush(g_se_gl_soft.raster);
+	}
+	while (g_se_gl_soft.snapshots) {
+		se_gl_soft_snapshot* next = g_se_gl_soft.snapshots->next;
+		free(g_se_gl_soft.snapshots);
+		g_se_gl_soft.snapshots = next;
+	}
+}
+
+// Called before texel storage is replaced or freed: pending draws may sample or target it.
+static void se_gl_soft_release_targets(void) {
+	se_gl_soft_flush();
+	if (g_se_gl_soft.raster) {
+		se_soft_raster_set_targets(g_se_gl_soft.raster, NULL, NULL);
+	}
+	g_se_gl_soft.target_color = NULL;
+	g_se_gl_soft.target_depth = NULL;
+	g_se_gl_soft.target_width = 0u;
+	g_se_gl_soft.target_height = 0u;
+}
+
+static se_gl_soft_vertex_array* se_gl_soft_current_vertex_array(void) {
+	se_gl_soft_vertex_array* vertex_array = se_gl_soft_table_get(&g_se_gl_soft.vertex_arrays, g_se_gl_soft.vertex_array);
+	return vertex_array ? vertex_array : &g_se_gl_soft.default_vertex_array;
+}
+
+static se_gl_soft_program* se_gl_soft_current_program(void) {
+	se_gl_soft_program* program = se_gl_soft_table_get(&g_se_gl_soft.programs, g_se_gl_soft.program);
+	return program && program->program ? program : NULL;
+}
+
+static GLuint* se_gl_soft_buffer_binding(const GLenum target) {
+	switch (target) {
+		case GL_ARRAY_BUFFER: return &g_se_gl_soft.array_buffer;
+		case GL_ELEMENT_ARRAY_BUFFER: return &se_gl_soft_current_vertex_array()->element_buffer;
+		case GL_COPY_READ_BUFFER: return &g_se_gl_soft.copy_read_buffer;
+		case GL_COPY_WRITE_BUFFER: return &g_se_gl_soft.copy_write_buffer;
+		case GL_UNIFORM_BUFFER: return &g_se_gl_soft.uniform_buffer;
+		case GL_PIXEL_PACK_BUFFER: return &g_se_gl_soft.pixel_pack_buffer;
+		case GL_PIXEL_UNPACK_BUFFER: return &g_se_gl_soft.pixel_unpack_buffer;
+		case GL_DRAW_INDIRECT_BUFFER: return &g_se_gl_soft.draw_indirect_buffer;
+		case GL_TEXTURE_BUFFER: return &g_se_gl_soft.texture_buffer;
+		default: return NULL;
+	}
+}
+
+static se_gl_soft_buffer* se_gl_soft_bound_buffer(const GLenum target) {
+	const GLuint* binding = se_gl_soft_buffer_binding(target);
+	if (!binding) {
+		se_gl_soft_error(GL_INVALID_ENUM);
+		return NULL;
+	}
+	se_gl_soft_buffer* buffer = se_gl_soft_table_get(&g_se_gl_soft.buffers, *binding);
+	if (!buffer) {
+		se_gl_soft_error(GL_INVALID_OPERATION);
+	}
+	return buffer;
+}
+
+static i32 se_gl_soft_texture_kind(const GLenum target) {
+	switch (target) {
+		case GL_TEXTURE_2D: return (i32)SE_GL_SOFT_TEXTURE_2D;
+		case GL_TEXTURE_3D: return (i32)SE_GL_SOFT_TEXTURE_3D;
+		default: return -1;
+	}
+}
+
+static se_gl_soft_texture* se_gl_soft_bound_texture(const GLenum target) {
+	const i32 kind = se_gl_soft_texture_kind(target);
+	if (kind < 0) {
+		se_gl_soft_error(GL_INVALID_ENUM);
+		return NULL;
+	}
+	se_gl_soft_texture* texture = se_gl_soft_table_get(&g_se_gl_soft.textures, g_se_gl_soft.bound_textures[g_se_gl_soft.active_texture][kind]);
+	if (!texture) {
+		se_gl_soft_error(GL_INVALID_OPERATION);
+	}
+	return texture;
+}
+
+static GLuint se_gl_soft_framebuffer_binding(const GLenum target) {
+	return target == GL_READ_FRAMEBUFFER ? g_se_gl_soft.read_framebuffer : g_se_gl_soft.draw_framebuffer;
+}
+
+static se_gl_soft_framebuffer* se_gl_soft_bound_framebuffer(const GLenum target) {
+	if (target != GL_FRAMEBUFFER && target != GL_DRAW_FRAMEBUFFER && target != GL_READ_FRAMEBUFFER) {
+		se_gl_soft_error(GL_INVALID_ENUM);
+		return NULL;
+	}
+	se_gl_soft_framebuffer* framebuffer = se_gl_soft_table_get(&g_se_gl_soft.framebuffers, se_gl_soft_framebuffer_binding(target));
+	if (!framebuffer) {
+		se_gl_soft_error(GL_INVALID_OPERATION);
+	}
+	return framebuffer;
+}
+
+static se_gl_soft_attachment* se_gl_soft_framebuffer_attachment(se_gl_soft_framebuffer* framebuffer, const GLenum attachment) {
+	switch (attachment) {
+		case GL_COLOR_ATTACHMENT0: return &framebuffer->color;
+		case GL_DEPTH_ATTACHMENT:
+		case GL_DEPTH_STENCIL_ATTACHMENT: return &framebuffer->depth;
+		default:
+			se_gl_soft_error(GL_INVALID_ENUM);
+			return NULL;
+	}
+}
+
+static se_soft_image* se_gl_soft_attachment_image(const se_gl_soft_attachment* attachment) {
+	se_soft_image* image = NULL;
+	if (attachment->texture != 0u) {
+		se_gl_soft_texture* texture = se_gl_soft_table_get(&g_se_gl_soft.textures, attachment->texture);
+		image = texture ? &texture->image : NULL;
+	} else if (attachment->renderbuffer != 0u) {
+		se_gl_soft_renderbuffer* renderbuffer = se_gl_soft_table_get(&g_se_gl_soft.renderbuffers, attachment->renderbuffer);
+		image = renderbuffer ? &renderbuffer->image : NULL;
+	}
+	return image && image->texels ? image : NULL;
+}
+
+static void se_gl_soft_framebuffer_images(const GLuint name, se_soft_image** out_color, se_soft_image** out_depth) {
+	*out_color = NULL;
+	*out_depth = NULL;
+	if (name == 0u) {
+		*out_color = g_se_gl_soft.surface_color.texels ? &g_se_gl_soft.surface_color : NULL;
+		*out_depth = g_se_gl_soft.surface_depth.texels ? &g_se_gl_soft.surface_depth : NULL;
+		return;
+	}
+	se_gl_soft_framebuffer* framebuffer = se_gl_soft_table_get(&g_se_gl_soft.framebuffers, name);
+	if (!framebuffer) {
+		return;
+	}
+	*out_color = se_gl_soft_attachment_image(&framebuffer->color);
+	se_soft_image* depth = se_gl_soft_attachment_image(&framebuffer->depth);
+	*out_depth = depth && depth->format == SE_SOFT_FORMAT_DEPTH32F ? depth : NULL;
+}
+
+// Points the raster at the draw framebuffer; a change of target finishes the previous one first.
+static b8 se_gl_soft_bind_targets(void) {
+	if (!g_se_gl_soft.raster) {
+		return false;
+	}
+	se_soft_image* color = NULL;
+	se_soft_image* depth = NULL;
+	se_gl_soft_framebuffer_images(g_se_gl_soft.draw_framebuffer, &color, &depth);
+	if (color && color->format == SE_SOFT_FORMAT_DEPTH32F) {
+		color = NULL;
+	}
+	const u32 width = color ? color->width : (depth ? depth->width : 0u);
+	const u32 height = color ? color->height : (depth ? depth->height : 0u);
+	if (color == g_se_gl_soft.target_color && depth == g_se_gl_soft.target_depth &&
+		width == g_se_gl_soft.target_width && height == g_se_gl_soft.target_height) {
+		return color || depth;
+	}
+	se_gl_soft_flush();
+	if (!se_soft_raster_set_targets(g_se_gl_soft.raster, color, depth)) {
+		se_gl_soft_error(GL_OUT_OF_MEMORY);
+		return false;
+	}
+	g_se_gl_soft.target_color = color;
+	g_se_gl_soft.target_depth = depth;
+	g_se_gl_soft.target_width = width;
+	g_se_gl_soft.target_height = height;
+	return color || depth;
+}
+
+static b8 se_gl_soft_image_format(const GLint internal_format, se_soft_format* out_format) {
+	switch (internal_format) {
+		case GL_RED:
+		case GL_R8:
+			*out_format = SE_SOFT_FORMAT_R8;
+			return true;
+		case GL_RG:
+		case GL_RG8:
+			*out_format = SE_SOFT_FORMAT_RG8;
+			return true;
+		case GL_RGB:
+		case GL_RGB8:
+		case GL_RGBA:
+		case GL_RGBA8:
+		case GL_SRGB:
+		case GL_SRGB8:
+		case GL_SRGB_ALPHA:
+		case GL_SRGB8_ALPHA8:
+			*out_format = SE_SOFT_FORMAT_RGBA8;
+			return true;
+		case GL_R16F:
+		case GL_R32F:
+			*out_format = SE_SOFT_FORMAT_R32F;
+			return true;
+		case GL_RG16F:
+		case GL_RG32F:
+		case GL_RGB16F:
+		case GL_RGB32F:
+		case GL_RGBA16F:
+		case GL_RGBA32F:
+		case GL_R11F_G11F_B10F:
+			*out_format = SE_SOFT_FORMAT_RGBA32F;
+			return true;
+		case GL_DEPTH_COMPONENT:
+		case GL_DEPTH_COMPONENT16:
+		case GL_DEPTH_COMPONENT24:
+		case GL_DEPTH_COMPONENT32:
+		case GL_DEPTH_COMPONENT32F:
+		case GL_DEPTH_STENCIL:
+		case GL_DEPTH24_STENCIL8:
+		case GL_DEPTH32F_STENCIL8:
+			*out_format = SE_SOFT_FORMAT_DEPTH32F;
+			return true;
+		default:
+			return false;
+	}
+}
+
+static u32 se_gl_soft_pixel_channels(const GLenum format) {
+	switch (format) {
+		case GL_RED:
+		case GL_DEPTH_COMPONENT: return 1u;
+		case GL_RG: return 2u;
+		case GL_RGB:
+		case GL_BGR: return 3u;
+		case GL_RGBA:
+		case GL_BGRA: return 4u;
+		default: return 0u;
+	}
+}
+
+static u32 se_gl_soft_type_bytes(const GLenum type) {
+	switch (type) {
+		case GL_UNSIGNED_BYTE:
+		case GL_BYTE: return 1u;
+		case GL_UNSIGNED_SHORT:
+		case GL_SHORT: return 2u;
+		case GL_UNSIGNED_INT:
+		case GL_INT:
+		case GL_FLOAT: return 4u;
+		default: return 0u;
+	}
+}
+
+static f32 se_gl_soft_read_component(const u8* source, const GLenum type, const b8 normalized) {
+	switch (type) {
+		case GL_FLOAT: {
+			f32 value = 0.0f;
+			memcpy(&value, source, sizeof(value));
+			return value;
+		}
+		case GL_UNSIGNED_BYTE:
+			return normalized ? (f32)source[0] / 255.0f : (f32)source[0];
+		case GL_BYTE: {
+			const f32 value = (f32)(i8)source[0];
+			return normalized ? fmaxf(value / 127.0f, -1.0f) : value;
+		}
+		case GL_UNSIGNED_SHORT: {
+			u16 value = 0u;
+			memcpy(&value, source, sizeof(value));
+			return normalized ? (f32)value / 65535.0f : (f32)value;
+		}
+		case GL_SHORT: {
+			i16 value = 0;
+			memcpy(&value, source, sizeof(value));
+			return normalized ? fmaxf((f32)value / 32767.0f, -1.0f) : (f32)value;
+		}
+		case GL_UNSIGNED_INT: {
+			u32 value = 0u;
+			memcpy(&value, source, sizeof(value));
+			return normalized ? (f32)((f64)value / 4294967295.0) : (f32)value;
+		}
+		case GL_INT: {
+			i32 value = 0;
+			memcpy(&value, source, sizeof(value));
+			return normalized ? fmaxf((f32)((f64)value / 2147483647.0), -1.0f) : (f32)value;
+		}
+		default:
+			return 0.0f;
+	}
+}
+
+static f32 se_gl_soft_clamp01(const f32 value) {
+	return value > 0.0f ? (value < 1.0f ? value : 1.0f) : 0.0f;
+}
+
+static void se_gl_soft_write_component(u8* destination, const GLenum type, const f32 value) {
+	switch (type) {
+		case GL_FLOAT:
+			memcpy(destination, &value, sizeof(value));
+			break;
+		case GL_UNSIGNED_BYTE:
+			destination[0] = (u8)(se_gl_soft_clamp01(value) * 255.0f + 0.5f);
+			break;
+		case GL_UNSIGNED_SHORT: {
+			const u16 unorm = (u16)(se_gl_soft_clamp01(value) * 65535.0f + 0.5f);
+			memcpy(destination, &unorm, sizeof(unorm));
+			break;
+		}
+		case GL_UNSIGNED_INT: {
+			const u32 unorm = (u32)((f64)se_gl_soft_clamp01(value) * 4294967295.0 + 0.5);
+			memcpy(destination, &unorm, sizeof(unorm));
+			break;
+		}
+		default:
+			break;
+	}
+}
+
+static sz se_gl_soft_row_stride(const u32 width, const u32 texel_bytes, const i32 alignment) {
+	const sz row = (sz)width * texel_bytes;
+	const sz align = alignment > 0 ? (sz)alignment : 1u;
+	return (row + align - 1u) / align * align;
+}
+
+static void se_gl_soft_upload(se_soft_image* image, const GLenum format, const GLenum type, const void* pixels) {
+	const u32 channels = se_gl_soft_pixel_channels(format);
+	const u32 type_bytes = se_gl_soft_type_bytes(type);
+	const sz stride = se_gl_soft_row_stride(image->width, channels * type_bytes, g_se_gl_soft.unpack_alignment);
+	const u8* source = (const u8*)pixels;
+	const b8 direct =
+		type == GL_UNSIGNED_BYTE &&
+		((image->format == SE_SOFT_FORMAT_RGBA8 && format == GL_RGBA) ||
+		 (image->format == SE_SOFT_FORMAT_RG8 && format == GL_RG) ||
+		 (image->format == SE_SOFT_FORMAT_R8 && format == GL_RED));
+	const sz texel_bytes = se_soft_format_texel_bytes(image->format);
+	for (u32 z = 0u; z < image->depth; ++z) {
+		for (u32 y = 0u; y < image->height; ++y) {
+			const u8* row = source + ((sz)z * image->height + y) * stride;
+			if (direct) {
+				memcpy(image->texels + (((sz)z * image->height + y) * image->width) * texel_bytes, row, (sz)image->width * texel_bytes);
+				continue;
+			}
+			for (u32 x = 0u; x < image->width; ++x) {
+				const u8* texel = row + (sz)x * channels * type_bytes;
+				f32 value[4] = {0.0f, 0.0f, 0.0f, 1.0f};
+				for (u32 c = 0u; c < channels; ++c) {
+					value[c] = se_gl_soft_read_component(texel + c * type_bytes, type, true);
+				}
+				if (format == GL_BGR || format == GL_BGRA) {
+					const f32 red = value[0];
+					value[0] = value[2];
+					value[2] = red;
+				}
+				se_soft_image_store(image, x, y, z, value);
+			}
+		}
+	}
+}
+
+// Shared by glTexImage2D/3D and glRenderbufferStorage: replaces the storage of `image`.
+static void se_gl_soft_image_define(se_soft_image* image, const GLint internal_format, const GLsizei width, const GLsizei height, const GLsizei depth,
+	const GLenum format, const GLenum type, const void* pixels) {
+	se_soft_format soft_format = SE_SOFT_FORMAT_NONE;
+	if (!se_gl_soft_image_format(internal_format, &soft_format)) {
+		se_gl_soft_error(GL_INVALID_VALUE);
+		return;
+	}
+	if (width < 0 || height < 0 || depth < 0 ||
+		width > SE_GL_SOFT_MAX_TEXTURE_SIZE || height > SE_GL_SOFT_MAX_TEXTURE_SIZE || depth > SE_GL_SOFT_MAX_TEXTURE_SIZE) {
+		se_gl_soft_error(GL_INVALID_VALUE);
+		return;
+	}
+	if (pixels && (se_gl_soft_pixel_channels(format) == 0u || se_gl_soft_type_bytes(type) == 0u)) {
+		se_gl_soft_error(GL_INVALID_ENUM);
+		return;
+	}
+	se_gl_soft_release_targets();
+	if (width == 0 || height == 0 || depth == 0) {
+		const se_soft_format kept = soft_format;
+		se_soft_image_free(image);
+		image->format = kept;
+		return;
+	}
+	if (!se_soft_image_alloc(image, (u32)width, (u32)height, (u32)depth, soft_format)) {
+		se_gl_soft_error(GL_OUT_OF_MEMORY);
+		return;
+	}
+	if (pixels) {
+		se_gl_soft_upload(image, format, type, pixels);
+	}
+}
+
+static se_soft_blend_factor se_gl_soft_blend_factor(const GLenum factor) {
+	switch (factor) {
+		case GL_ZERO: return SE_SOFT_BLEND_ZERO;
+		case GL_SRC_COLOR: return SE_SOFT_BLEND_SRC_COLOR;
+		case GL_ONE_MINUS_SRC_COLOR: return SE_SOFT_BLEND_ONE_MINUS_SRC_COLOR;
+		case GL_DST_COLOR: return SE_SOFT_BLEND_DST_COLOR;
+		case GL_ONE_MINUS_DST_COLOR: return SE_SOFT_BLEND_ONE_MINUS_DST_COLOR;
+		case GL_SRC_ALPHA: return SE_SOFT_BLEND_SRC_ALPHA;
+		case GL_ONE_MINUS_SRC_ALPHA: return SE_SOFT_BLEND_ONE_MINUS_SRC_ALPHA;
+		case GL_DST_ALPHA: return SE_SOFT_BLEND_DST_ALPHA;
+		case GL_ONE_MINUS_DST_ALPHA: return SE_SOFT_BLEND_ONE_MINUS_DST_ALPHA;
+		case GL_SRC_ALPHA_SATURATE: return SE_SOFT_BLEND_SRC_ALPHA_SATURATE;
+		default: return SE_SOFT_BLEND_ONE;
+	}
+}
+
+static b8 se_gl_soft_blend_factor_valid(const GLenum factor) {
+	return factor == GL_ONE || se_gl_soft_blend_factor(factor) != SE_SOFT_BLEND_ONE;
+}
+
+static b8 se_gl_soft_blend_equation(const GLenum mode, se_soft_blend_equation* out_equation) {
+	switch (mode) {
+		case GL_FUNC_ADD: *out_equation = SE_SOFT_BLEND_ADD; return true;
+		case GL_FUNC_SUBTRACT: *out_equation = SE_SOFT_BLEND_SUBTRACT; return true;
+		case GL_FUNC_REVERSE_SUBTRACT: *out_equation = SE_SOFT_BLEND_REVERSE_SUBTRACT; return true;
+		case GL_MIN: *out_equation = SE_SOFT_BLEND_MIN; return true;
+		case GL_MAX: *out_equation = SE_SOFT_BLEND_MAX; return true;
+		default: return false;
+	}
+}
+
+static i32 se_gl_soft_cap_index(const GLenum cap) {
+	switch (cap) {
+		case GL_BLEND: return SE_GL_SOFT_CAP_BLEND;
+		case GL_DEPTH_TEST: return SE_GL_SOFT_CAP_DEPTH_TEST;
+		case GL_CULL_FACE: return SE_GL_SOFT_CAP_CULL_FACE;
+		case GL_POLYGON_OFFSET_FILL: return SE_GL_SOFT_CAP_POLYGON_OFFSET_FILL;
+		case GL_SCISSOR_TEST: return SE_GL_SOFT_CAP_SCISSOR_TEST;
+		case GL_STENCIL_TEST: return SE_GL_SOFT_CAP_STENCIL_TEST;
+		case GL_DITHER: return SE_GL_SOFT_CAP_DITHER;
+		case GL_MULTISAMPLE: return SE_GL_SOFT_CAP_MULTISAMPLE;
+		case GL_FRAMEBUFFER_SRGB: return SE_GL_SOFT_CAP_FRAMEBUFFER_SRGB;
+		case GL_PROGRAM_POINT_SIZE: return SE_GL_SOFT_CAP_PROGRAM_POINT_SIZE;
+		default: return -1;
+	}
+}
+
+static void se_gl_soft_copy_log(const c8* log, const GLsizei buf_size, GLsizei* out_length, GLchar* out_log) {
+	const sz length = strlen(log);
+	GLsizei written = 0;
+	if (out_log && buf_size > 0) {
+		written = (GLsizei)(length < (sz)(buf_size - 1) ? length : (sz)(buf_size - 1));
+		memcpy(out_log, log, (sz)written);
+		out_log[written] = '\0';
+	}
+	if (out_length) {
+		*out_length = written;
+	}
+}
+
+static void se_gl_soft_shader_free(se_gl_soft_shader* shader) {
+	if (!shader) {
+		return;
+	}
+	free(shader->source);
+	free(shader);
+}
+
+static void se_gl_soft_program_free(const GLuint name) {
+	se_gl_soft_program* program = se_gl_soft_table_remove(&g_se_gl_soft.programs, name);
+	if (!program) {
+		return;
+	}
+	if (program->program) {
+		se_gl_soft_flush();
+		se_soft_glsl_program_destroy(program->program);
+	}
+	for (u32 stage = 0u; stage < SE_SOFT_GLSL_STAGE_COUNT; ++stage) {
+		se_gl_soft_shader* shader = se_gl_soft_table_get(&g_se_gl_soft.shaders, program->shaders[stage]);
+		if (!shader) {
+			continue;
+		}
+		shader->attachments--;
+		if (shader->attachments == 0u && shader->delete_pending) {
+			se_gl_soft_shader_free(se_gl_soft_table_remove(&g_se_gl_soft.shaders, program->shaders[stage]));
+		}
+	}
+	free(program);
+}
+
+// Buffers
+
+static void APIENTRY se_gl_soft_gen_buffers(const GLsizei n, GLuint* buffers) {
+	se_gl_soft_gen(&g_se_gl_soft.buffers, sizeof(se_gl_soft_buffer), n, buffers);
+}
+
+static void APIENTRY se_gl_soft_delete_buffers(const GLsizei n, const GLuint* buffers) {
+	if (n < 0) {
+		se_gl_soft_error(GL_INVALID_VALUE);
+		return;
+	}
+	for (GLsizei i = 0; buffers && i < n; ++i) {
+		se_gl_soft_buffer* buffer = se_gl_soft_table_remove(&g_se_gl_soft.buffers, buffers[i]);
+		if (!buffer) {
+			continue;
+		}
+		const GLenum targets[] = {
+			GL_ARRAY_BUFFER, GL_ELEMENT_ARRAY_BUFFER, GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, GL_UNIFORM_BUFFER,
+			GL_PIXEL_PACK_BUFFER, GL_PIXEL_UNPACK_BUFFER, GL_DRAW_INDIRECT_BUFFER, GL_TEXTURE_BUFFER
+		};
+		for (u32 t = 0u; t < sizeof(targets) / sizeof(targets[0]); ++t) {
+			GLuint* binding = se_gl_soft_buffer_binding(targets[t]);
+			if (*binding == buffers[i]) {
+				*binding = 0u;
+			}
+		}
+		free(buffer->data);
+		free(buffer);
+	}
+}
+
+static void APIENTRY se_gl_soft_bind_buffer(const GLenum target, const GLuint buffer) {
+	GLuint* binding = se_gl_soft_buffer_binding(target);
+	if (!binding) {
+		se_gl_soft_error(GL_INVALID_ENUM);
+		return;
+	}
+	if (buffer != 0u && !se_gl_soft_table_get(&g_se_gl_soft.buffers, buffer)) {
+		se_gl_soft_error(GL_INVALID_OPERATION);
+		return;
+	}
+	*binding = buffer;
+}
+
+static void APIENTRY se_gl_soft_buffer_data(const GLenum target, const GLsizeiptr size, const void* data, const GLenum usage) {
+	(void)usage;
+	se_gl_soft_buffer* buffer = se_gl_soft_bound_buffer(target);
+	if (!buffer) {
+		return;
+	}
+	if (size < 0) {
+		se_gl_soft_error(GL_INVALID_VALUE);
+		return;
+	}
+	u8* storage = size > 0 ? (u8*)malloc((sz)size) : NULL;
+	if (size > 0 && !storage) {
+		se_gl_soft_error(GL_OUT_OF_MEMORY);
+		return;
+	}
+	if (storage) {
+		if (data) {
+			memcpy(storage, data, (sz)size);
+		} else {
+			memset(storage, 0, (sz)size);
+		}
+	}
+	free(buffer->data);
+	buffer->data = storage;
+	buffer->size = (sz)size;
+	buffer->mapped = false;
+}
+
+static void APIENTRY se_gl_soft_buffer_sub_data(const GLenum target, const GLintptr offset, const GLsizeiptr size, const void* data) {
+	se_gl_soft_buffer* buffer = se_gl_soft_bound_buffer(target);
+	if (!buffer) {
+		return;
+	}
+	if (offset < 0 || size < 0 || (sz)offset > buffer->size || (sz)size > buffer->size - (sz)offset) {
+		se_gl_soft_error(GL_INVALID_VALUE);
+		return;
+	}
+	if (data && size > 0) {
+		memcpy(buffer->data + offset, data, (sz)size);
+	}
+}
+
+static void* APIENTRY se_gl_soft_map_buffer(const GLenum target, const GLenum access) {
+	(void)access;
+	se_gl_soft_buffer* buffer = se_gl_soft_bound_buffer(target);
+	if (!buffer) {
+		return NULL;
+	}
+	if (buffer->mapped) {
+		se_gl_soft_error(GL_INVALID_OPERATION);
+		return NULL;
+	}
+	buffer->mapped = true;
+	return buffer->data;
+}
+
+static GLboolean APIENTRY se_gl_soft_unmap_buffer(const GLenum target) {
+	se_gl_soft_buffer* buffer = se_gl_soft_bound_buffer(target);
+	if (!buffer) {
+		return GL_FALSE;
+	}
+	if (!buffer->mapped) {
+		se_gl_soft_error(GL_INVALID_OPERATION);
+		return GL_FALSE;
+	}
+	buffer->mapped = false;
+	return GL_TRUE;
+}
+
+static void APIENTRY se_gl_soft_copy_buffer_sub_data(const GLenum read_target, const GLenum write_target, const GLintptr read_offset, const GLintptr write_offset, const GLsizeiptr size) {
+	se_gl_soft_buffer* source = se_gl_soft_bound_buffer(read_target);
+	se_gl_soft_buffer* destination = se_gl_soft_bound_buffer(write_target);
+	if (!source || !destination) {
+		return;
+	}
+	if (read_offset < 0 || write_offset < 0 || size < 0 ||
+		(sz)read_offset > source->size || (sz)size > source->size - (sz)read_offset ||
+		(sz)write_offset > destination->size || (sz)size > destination->size - (sz)write_offset) {
+		se_gl_soft_error(GL_INVALID_VALUE);
+		return;
+	}
+	if (size > 0) {
+		memmove(destination->data + write_offset, source->data + read_offset, (sz)size);
+	}
+}
+
+// Vertex arrays
+
+static void APIENTRY se_gl_soft_gen_vertex_arrays(const GLsizei n, GLuint* arrays) {
+	se_gl_soft_gen(&g_se_gl_soft.vertex_arrays, sizeof(se_gl_soft_vertex_array), n, arrays);
+}
+
+static void APIENTRY se_gl_soft_delete_vertex_arrays(const GLsizei n, const GLuint* arrays) {
+	if (n < 0) {
+		se_gl_soft_error(GL_INVALID_VALUE);
+		return;
+	}
+	for (GLsizei i = 0; arrays && i < n; ++i) {
+		if (arrays[i] == g_se_gl_soft.vertex_array) {
+			g_se_gl_soft.vertex_array = 0u;
+		}
+		free(se_gl_soft_table_remove(&g_se_gl_soft.vertex_arrays, arrays[i]));
+	}
+}
+
+static void APIENTRY se_gl_soft_bind_vertex_array(const GLuint array) {
+	if (array != 0u && !se_gl_soft_table_get(&g_se_gl_soft.vertex_arrays, array)) {
+		se_gl_soft_error(GL_INVALID_OPERATION);
+		return;
+	}
+	g_se_gl_soft.vertex_array = array;
+}
+
+static void APIENTRY se_gl_soft_vertex_attrib_pointer(const GLuint index, const GLint size, const GLenum type, const GLboolean normalized, const GLsizei stride, const void* pointer) {
+	if (index >= SE_SOFT_GLSL_MAX_ATTRIBUTES || size < 1 || size > 4 || stride < 0) {
+		se_gl_soft_error(GL_INVALID_VALUE);
+		return;
+	}
+	if (se_gl_soft_type_bytes(type) == 0u) {
+		se_gl_soft_error(GL_INVALID_ENUM);
+		return;
+	}
+	se_gl_soft_attrib* attrib = &se_gl_soft_current_vertex_array()->attribs[index];
+	attrib->buffer = g_se_gl_soft.array_buffer;
+	attrib->pointer = (const u8*)pointer;
+	attrib->size = size;
+	attrib->type = type;
+	attrib->normalized = normalized == GL_TRUE;
+	attrib->stride = stride;
+}
+
+static void APIENTRY se_gl_soft_enable_vertex_attrib_array(const GLuint index) {
+	if (index >= SE_SOFT_GLSL_MAX_ATTRIBUTES) {
+		se_gl_soft_error(GL_INVALID_VALUE);
+		return;
+	}
+	se_gl_soft_current_vertex_array()->attribs[index].enabled = true;
+}
+
+static void APIENTRY se_gl_soft_disable_vertex_attrib_array(const GLuint index) {
+	if (index >= SE_SOFT_GLSL_MAX_ATTRIBUTES) {
+		se_gl_soft_error(GL_INVALID_VALUE);
+		return;
+	}
+	se_gl_soft_current_vertex_array()->attribs[index].enabled = false;
+}
+
+static void APIENTRY se_gl_soft_vertex_attrib_divisor(const GLuint index, const GLuint divisor) {
+	if (index >= SE_SOFT_GLSL_MAX_ATTRIBUTES) {
+		se_gl_soft_error(GL_INVALID_VALUE);
+		return;
+	}
+	se_gl_soft_current_vertex_array()->attribs[index].divisor = divisor;
+}
+
+// Shaders and programs
+
+static GLuint APIENTRY se_gl_soft_create_shader(const GLenum type) {
+	if (type != GL_VERTEX_SHADER && type != GL_FRAGMENT_SHADER) {
+		se_gl_soft_error(GL_INVALID_ENUM);
+		return 0u;
+	}
+	GLuint name = 0u;
+	se_gl_soft_gen(&g_se_gl_soft.shaders, sizeof(se_gl_soft_shader), 1, &name);
+	se_gl_soft_shader* shader = se_gl_soft_table_get(&g_se_gl_soft.shaders, name);
+	if (shader) {
+		shader->type = type;
+	}
+	return name;
+}
+
+static void APIENTRY se_gl_soft_shader_source(const GLuint shader, const GLsizei count, const GLchar** string, const GLint* length) {
+	se_gl_soft_shader* object = se_gl_soft_table_get(&g_se_gl_soft.shaders, shader);
+	if (!object) {
+		se_gl_soft_error(GL_INVALID_VALUE);
+		return;
+	}
+	if (count < 0 || (count > 0 && !string)) {
+		se_gl_soft_error(GL_INVALID_VALUE);
+		return;
+	}
+	sz total = 0u;
+	for (GLsizei i = 0; i < count; ++i) {
+		if (string[i]) {
+			total += length && length[i] >= 0 ? (sz)length[i] : strlen(string[i]);
+		}
+	}
+	c8* source = (c8*)malloc(total + 1u);
+	if (!source) {
+		se_gl_soft_error(GL_OUT_OF_MEMORY);
+		return;
+	}
+	sz write = 0u;
+	for (GLsizei i = 0; i < count; ++i) {
+		if (!string[i]) {
+			continue;
+		}
+		const sz part = length && length[i] >= 0 ? (sz)length[i] : strlen(string[i]);
+		memcpy(source + write, string[i], part);
+		write += part;
+	}
+	source[write] = '\0';
+	free(object->source);
+	object->source = source;
+}
+
+static void APIENTRY se_gl_soft_compile_shader(const GLuint shader) {
+	se_gl_soft_shader* object = se_gl_soft_table_get(&g_se_gl_soft.shaders, shader);
+	if (!object) {
+		se_gl_soft_error(GL_INVALID_VALUE);
+		return;
+	}
+	const se_soft_glsl_stage stage = object->type == GL_VERTEX_SHADER ? SE_SOFT_GLSL_VERTEX : SE_SOFT_GLSL_FRAGMENT;
+	object->log[0] = '\0';
+	object->compiled = object->source && se_soft_glsl_check(stage, object->source, object->log, sizeof(object->log));
+}
+
+static void APIENTRY se_gl_soft_delete_shader(const GLuint shader) {
+	se_gl_soft_shader* object = se_gl_soft_table_get(&g_se_gl_soft.shaders, shader);
+	if (!object) {
+		return;
+	}
+	if (object->attachments > 0u) {
+		object->delete_pending = true;
+		return;
+	}
+	se_gl_soft_shader_free(se_gl_soft_table_remove(&g_se_gl_soft.shaders, shader));
+}
+
+static void APIENTRY se_gl_soft_get_shader_iv(const GLuint shader, const GLenum pname, GLint* params) {
+	se_gl_soft_shader* object = se_gl_soft_table_get(&g_se_gl_soft.shaders, shader);
+	if (!object) {
+		se_gl_soft_error(GL_INVALID_VALUE);
+		return;
+	}
+	if (!params) {
+		return;
+	}
+	switch (pname) {
+		case GL_SHADER_TYPE: *params = (GLint)object->type; break;
+		case GL_DELETE_STATUS: *params = object->delete_pending ? GL_TRUE : GL_FALSE; break;
+		case GL_COMPILE_STATUS: *params = object->compiled ? GL_TRUE : GL_FALSE; break;
+		case GL_INFO_LOG_LENGTH: *params = object->log[0] ? (GLint)strlen(object->log) + 1 : 0; break;
+		case GL_SHADER_SOURCE_LENGTH: *params = object->source ? (GLint)strlen(object->source) + 1 : 0; break;
+		default: se_gl_soft_error(GL_INVALID_ENUM); break;
+	}
+}
+
+static void APIENTRY se_gl_soft_get_shader_info_log(const GLuint shader, const GLsizei buf_size, GLsizei* out_length, GLchar* out_log) {
+	se_gl_soft_shader* object = se_gl_soft_table_get(&g_se_gl_soft.shaders, shader);
+	if (!object) {
+		se_gl_soft_error(GL_INVALID_VALUE);
+		return;
+	}
+	se_gl_soft_copy_log(object->log, buf_size, out_length, out_log);
+}
+
+static GLuint APIENTRY se_gl_soft_create_program(void) {
+	GLuint name = 0u;
+	se_gl_soft_gen(&g_se_gl_soft.programs, sizeof(se_gl_soft_program), 1, &name);
+	return name;
+}
+
+static void APIENTRY se_gl_soft_attach_shader(const GLuint program, const GLuint shader) {
+	se_gl_soft_program* program_object = se_gl_soft_table_get(&g_se_gl_soft.programs, program);
+	se_gl_soft_shader* shader_object = se_gl_soft_table_get(&g_se_gl_soft.shaders, shader);
+	if (!program_object || !shader_object) {
+		se_gl_soft_error(GL_INVALID_VALUE);
+		return;
+	}
+	const u32 stage = shader_object->type == GL_VERTEX_SHADER ? SE_SOFT_GLSL_VERTEX : SE_SOFT_GLSL_FRAGMENT;
+	if (program_object->shaders[stage] != 0u) {
+		se_gl_soft_error(GL_INVALID_OPERATION);
+		return;
+	}
+	program_object->shaders[stage] = shader;
+	shader_object->attachments++;
+}
+
+static void APIENTRY se_gl_soft_link_program(const GLuint program) {
+	se_gl_soft_program* object = se_gl_soft_table_get(&g_se_gl_soft.programs, program);
+	if (!object) {
+		se_gl_soft_error(GL_INVALID_VALUE);
+		return;
+	}
+	if (object->program) {
+		se_gl_soft_flush();
+		se_soft_glsl_program_destroy(object->program);
+		object->program = NULL;
+	}
+	object->log[0] = '\0';
+	const se_gl_soft_shader* vertex = se_gl_soft_table_get(&g_se_gl_soft.shaders, object->shaders[SE_SOFT_GLSL_VERTEX]);
+	const se_gl_soft_shader* fragment = se_gl_soft_table_get(&g_se_gl_soft.shaders, object->shaders[SE_SOFT_GLSL_FRAGMENT]);
+	if (!vertex || !fragment || !vertex->compiled || !fragment->compiled) {
+		snprintf(object->log, sizeof(object->log), "link error: a compiled vertex and fragment shader must be attached");
+		return;
+	}
+	object->program = se_soft_glsl_program_create(vertex->source, fragment->source, object->log, sizeof(object->log));
+}
+
+static void APIENTRY se_gl_soft_use_program(const GLuint program) {
+	se_gl_soft_program* object = se_gl_soft_table_get(&g_se_gl_soft.programs, program);
+	if (program != 0u && (!object || !object->program)) {
+		se_gl_soft_error(GL_INVALID_OPERATION);
+		return;
+	}
+	const GLuint previous = g_se_gl_soft.program;
+	g_se_gl_soft.program = program;
+	se_gl_soft_program* previous_object = se_gl_soft_table_get(&g_se_gl_soft.programs, previous);
+	if (previous != program && previous_object && previous_object->delete_pending) {
+		se_gl_soft_program_free(previous);
+	}
+}
+
+static void APIENTRY se_gl_soft_delete_program(const GLuint program) {
+	se_gl_soft_program* object = se_gl_soft_table_get(&g_se_gl_soft.programs, program);
+	if (!object) {
+		return;
+	}
+	if (program == g_se_gl_soft.program) {
+		object->delete_pending = true;
+		return;
+	}
+	se_gl_soft_program_free(program);
+}
+
+static void APIENTRY se_gl_soft_get_program_iv(const GLuint program, const GLenum pname, GLint* params) {
+	se_gl_soft_program* object = se_gl_soft_table_get(&g_se_gl_soft.programs, program);
+	if (!object) {
+		se_gl_soft_error(GL_INVALID_VALUE);
+		return;
+	}
+	if (!params) {
+		return;
+	}
+	switch (pname) {
+		case GL_DELETE_STATUS: *params = object->delete_pending ? GL_TRUE : GL_FALSE; break;
+		case GL_LINK_STATUS:
+		case GL_VALIDATE_STATUS: *params = object->program ? GL_TRUE : GL_FALSE; break;
+		case GL_INFO_LOG_LENGTH: *params = object->log[0] ? (GLint)strlen(object->log) + 1 : 0; break;
+		case GL_ATTACHED_SHADERS: *params = (object->shaders[0] != 0u) + (object->shaders[1] != 0u); break;
+		default: se_gl_soft_error(GL_INVALID_ENUM); break;
+	}
+}
+
+static void APIENTRY se_gl_soft_get_program_info_log(const GLuint program, const GLsizei buf_size, GLsizei* out_length, GLchar* out_log) {
+	se_gl_soft_program* object = se_gl_soft_table_get(&g_se_gl_soft.programs, program);
+	if (!object) {
+		se_gl_soft_error(GL_INVALID_VALUE);
+		return;
+	}
+	se_gl_soft_copy_log(object->log, buf_size, out_length, out_log);
+}
+
+static GLint APIENTRY se_gl_soft_get_uniform_location(const GLuint program, const GLchar* name) {
+	se_gl_soft_program* object = se_gl_soft_table_get(&g_se_gl_soft.programs, program);
+	if (!object || !object->program) {
+		se_gl_soft_error(GL_INVALID_OPERATION);
+		return -1;
+	}
+	return name ? (GLint)se_soft_glsl_program_uniform_location(object->program, name) : -1;
+}
+
+static void se_gl_soft_uniform(const GLint location, const f32* floats, const i32* ints, const u32 components, const GLsizei count, const b8 transpose) {
+	if (location == -1) {
+		return;
+	}
+	se_gl_soft_program* program = se_gl_soft_current_program();
+	if (!program) {
+		se_gl_soft_error(GL_INVALID_OPERATION);
+		return;
+	}
+	if (count < 0) {
+		se_gl_soft_error(GL_INVALID_VALUE);
+		return;
+	}
+	if (count > 0 && !se_soft_glsl_program_set_uniform(program->program, location, floats, ints, components, (u32)count, transpose)) {
+		se_gl_soft_error(GL_INVALID_OPERATION);
+	}
+}
+
+static void APIENTRY se_gl_soft_uniform1i(const GLint location, const GLint v0) {
+	se_gl_soft_uniform(location, NULL, &v0, 1u, 1, false);
+}
+
+static void APIENTRY se_gl_soft_uniform1f(const GLint location, const GLfloat v0) {
+	se_gl_soft_uniform(location, &v0, NULL, 1u, 1, false);
+}
+
+static void APIENTRY se_gl_soft_uniform1fv(const GLint location, const GLsizei count, const GLfloat* value) {
+	se_gl_soft_uniform(location, value, NULL, 1u, count, false);
+}
+
+static void APIENTRY se_gl_soft_uniform2fv(const GLint location, const GLsizei count, const GLfloat* value) {
+	se_gl_soft_uniform(location, value, NULL, 2u, count, false);
+}
+
+static void APIENTRY se_gl_soft_uniform3fv(const GLint location, const GLsizei count, const GLfloat* value) {
+	se_gl_soft_uniform(location, value, NULL, 3u, count, false);
+}
+
+static void APIENTRY se_gl_soft_uniform4fv(const GLint location, const GLsizei count, const GLfloat* value) {
+	se_gl_soft_uniform(location, value, NULL, 4u, count, false);
+}
+
+static void APIENTRY se_gl_soft_uniform1iv(const GLint location, const GLsizei count, const GLint* value) {
+	se_gl_soft_uniform(location, NULL, value, 1u, count, false);
+}
+
+static void APIENTRY se_gl_soft_uniform2iv(const GLint location, const GLsizei count, const GLint* value) {
+	se_gl_soft_uniform(location, NULL, value, 2u, count, false);
+}
+
+static void APIENTRY se_gl_soft_uniform3iv(const GLint location, const GLsizei count, const GLint* value) {
+	se_gl_soft_uniform(location, NULL, value, 3u, count, false);
+}
+
+static void APIENTRY se_gl_soft_uniform4iv(const GLint location, const GLsizei count, const GLint* value) {
+	se_gl_soft_uniform(location, NULL, value, 4u, count, false);
+}
+
+static void APIENTRY se_gl_soft_uniform_matrix3fv(const GLint location, const GLsizei count, const GLboolean transpose, const GLfloat* value) {
+	se_gl_soft_uniform(location, value, NULL, 9u, count, transpose == GL_TRUE);
+}
+
+static void APIENTRY se_gl_soft_uniform_matrix4fv(const GLint location, const GLsizei count, const GLboolean transpose, const GLfloat* value) {
+	se_gl_soft_uniform(location, value, NULL, 16u, count, transpose == GL_TRUE);
+}
+
+// Textures, renderbuffers and framebuffers
+
+static void APIENTRY se_gl_soft_tex_image_3d(const GLenum target, const GLint level, const GLint internal_format, const GLsizei width, const GLsizei height, const GLsizei depth, const GLint border, const GLenum format, const GLenum type, const void* pixels) {
+	if (target != GL_TEXTURE_3D) {
+		se_gl_soft_error(GL_INVALID_ENUM);
+		return;
+	}
+	if (border != 0 || level < 0 || depth > SE_GL_SOFT_MAX_3D_TEXTURE_SIZE) {
+		se_gl_soft_error(GL_INVALID_VALUE);
+		return;
+	}
+	se_gl_soft_texture* texture = se_gl_soft_bound_texture(target);
+	// Only the base level is sampled, so mip levels are accepted and dropped.
+	if (!texture || level > 0) {
+		return;
+	}
+	se_gl_soft_image_define(&texture->image, internal_format, width, height, depth, format, type, pixels);
+}
+
+static void APIENTRY se_gl_soft_gen_renderbuffers(const GLsizei n, GLuint* renderbuffers) {
+	se_gl_soft_gen(&g_se_gl_soft.renderbuffers, sizeof(se_gl_soft_renderbuffer), n, renderbuffers);
+}
+
+static void APIENTRY se_gl_soft_bind_renderbuffer(const GLenum target, const GLuint renderbuffer) {
+	if (target != GL_RENDERBUFFER) {
+		se_gl_soft_error(GL_INVALID_ENUM);
+		return;
+	}
+	if (renderbuffer != 0u && !se_gl_soft_table_get(&g_se_gl_soft.renderbuffers, renderbuffer)) {
+		se_gl_soft_error(GL_INVALID_OPERATION);
+		return;
+	}
+	g_se_gl_soft.renderbuffer = renderbuffer;
+}
+
+static void APIENTRY se_gl_soft_delete_renderbuffers(const GLsizei n, const GLuint* renderbuffers) {
+	if (n < 0) {
+		se_gl_soft_error(GL_INVALID_VALUE);
+		return;
+	}
+	for (GLsizei i = 0; renderbuffers && i < n; ++i) {
+		se_gl_soft_renderbuffer* renderbuffer = se_gl_soft_table_remove(&g_se_gl_soft.renderbuffers, renderbuffers[i]);
+		if (!renderbuffer) {
+			continue;
+		}
+		if (g_se_gl_soft.renderbuffer == renderbuffers[i]) {
+			g_se_gl_soft.renderbuffer = 0u;
+		}
+		se_gl_soft_release_targets();
+		se_soft_image_free(&renderbuffer->image);
+		free(renderbuffer);
+	}
+}
+
+static void APIENTRY se_gl_soft_renderbuffer_storage(const GLenum target, const GLenum internalformat, const GLsizei width, const GLsizei height) {
+	if (target != GL_RENDERBUFFER) {
+		se_gl_soft_error(GL_INVALID_ENUM);
+		return;
+	}
+	se_gl_soft_renderbuffer* renderbuffer = se_gl_soft_table_get(&g_se_gl_soft.renderbuffers, g_se_gl_soft.renderbuffer);
+	if (!renderbuffer) {
+		se_gl_soft_error(GL_INVALID_OPERATION);
+		return;
+	}
+	se_gl_soft_image_define(&renderbuffer->image, (GLint)internalformat, width, height, 1, GL_NONE, GL_NONE, NULL);
+}
+
+static void APIENTRY se_gl_soft_gen_framebuffers(const GLsizei n, GLuint* framebuffers) {
+	se_gl_soft_gen(&g_se_gl_soft.framebuffers, sizeof(se_gl_soft_framebuffer), n, framebuffers);
+}
+
+static void APIENTRY se_gl_soft_bind_framebuffer(const GLenum target, const GLuint framebuffer) {
+	if (target != GL_FRAMEBUFFER && target != GL_DRAW_FRAMEBUFFER && target != GL_READ_FRAMEBUFFER) {
+		se_gl_soft_error(GL_INVALID_ENUM);
+		return;
+	}
+	if (framebuffer != 0u && !se_gl_soft_table_get(&g_se_gl_soft.framebuffers, framebuffer)) {
+		se_gl_soft_error(GL_INVALID_OPERATION);
+		return;
+	}
+	if (target != GL_READ_FRAMEBUFFER) {
+		g_se_gl_soft.draw_framebuffer = framebuffer;
+	}
+	if (target != GL_DRAW_FRAMEBUFFER) {
+		g_se_gl_soft.read_framebuffer = framebuffer;
+	}
+}
+
+static void APIENTRY se_gl_soft_delete_framebuffers(const GLsizei n, const GLuint* framebuffers) {
+	if (n < 0) {
+		se_gl_soft_error(GL_INVALID_VALUE);
+		return;
+	}
+	for (GLsizei i = 0; framebuffers && i < n; ++i) {
+		se_gl_soft_framebuffer* framebuffer = se_gl_soft_table_remove(&g_se_gl_soft.framebuffers, framebuffers[i]);
+		if (!framebuffer) {
+			continue;
+		}
+		if (g_se_gl_soft.draw_framebuffer == framebuffers[i]) {
+			g_se_gl_soft.draw_framebuffer = 0u;
+		}
+		if (g_se_gl_soft.read_framebuffer == framebuffers[i]) {
+			g_se_gl_soft.read_framebuffer = 0u;
+		}
+		free(framebuffer);
+	}
+}
+
+static void se_gl_soft_attach(const GLenum target, const GLenum attachment, const GLuint texture, const GLuint renderbuffer) {
+	se_gl_soft_framebuffer* framebuffer = se_gl_soft_bound_framebuffer(target);
+	if (!framebuffer) {
+		return;
+	}
+	if (attachment == GL_STENCIL_ATTACHMENT) {
+		return;
+	}
+	se_gl_soft_attachment* slot = se_gl_soft_framebuffer_attachment(framebuffer, attachment);
+	if (!slot) {
+		return;
+	}
+	if ((texture != 0u && !se_gl_soft_table_get(&g_se_gl_soft.textures, texture)) ||
+		(renderbuffer != 0u && !se_gl_soft_table_get(&g_se_gl_soft.renderbuffers, renderbuffer))) {
+		se_gl_soft_error(GL_INVALID_OPERATION);
+		return;
+	}
+	slot->texture = texture;
+	slot->renderbuffer = renderbuffer;
+}
+
+static void APIENTRY se_gl_soft_framebuffer_texture(const GLenum target, const GLenum attachment, const GLuint texture, const GLint level) {
+	if (level != 0) {
+		se_gl_soft_error(GL_INVALID_VALUE);
+		return;
+	}
+	se_gl_soft_attach(target, attachment, texture, 0u);
+}
+
+static void APIENTRY se_gl_soft_framebuffer_texture2d(const GLenum target, const GLenum attachment, const GLenum textarget, const GLuint texture, const GLint level) {
+	if (texture != 0u && textarget != GL_TEXTURE_2D) {
+		se_gl_soft_error(GL_INVALID_OPERATION);
+		return;
+	}
+	se_gl_soft_framebuffer_texture(target, attachment, texture, level);
+}
+
+static void APIENTRY se_gl_soft_framebuffer_renderbuffer(const GLenum target, const GLenum attachment, const GLenum renderbuffer_target, const GLuint renderbuffer) {
+	if (renderbuffer_target != GL_RENDERBUFFER) {
+		se_gl_soft_error(GL_INVALID_ENUM);
+		return;
+	}
+	se_gl_soft_attach(target, attachment, 0u, renderbuffer);
+}
+
+static GLenum APIENTRY se_gl_soft_check_framebuffer_status(const GLenum target) {
+	if (target != GL_FRAMEBUFFER && target != GL_DRAW_FRAMEBUFFER && target != GL_READ_FRAMEBUFFER) {
+		se_gl_soft_error(GL_INVALID_ENUM);
+		return 0u;
+	}
+	const GLuint name = se_gl_soft_framebuffer_binding(target);
+	if (name == 0u) {
+		return GL_FRAMEBUFFER_COMPLETE;
+	}
+	se_gl_soft_framebuffer* framebuffer = se_gl_soft_table_get(&g_se_gl_soft.framebuffers, name);
+	if (!framebuffer) {
+		return GL_FRAMEBUFFER_UNDEFINED;
+	}
+	const se_gl_soft_attachment* attachments[2] = {&framebuffer->color, &framebuffer->depth};
+	b8 any = false;
+	for (u32 i = 0u; i < 2u; ++i) {
+		if (attachments[i]->texture == 0u && attachments[i]->renderbuffer == 0u) {
+			continue;
+		}
+		const se_soft_image* image = se_gl_soft_attachment_image(attachments[i]);
+		if (!image || (i == 0u) == (image->format == SE_SOFT_FORMAT_DEPTH32F)) {
+			return GL_FRAMEBUFFER_INCOMPLETE_ATTACHMENT;
+		}
+		any = true;
+	}
+	return any ? GL_FRAMEBUFFER_COMPLETE : GL_FRAMEBUFFER_INCOMPLETE_MISSING_ATTACHMENT;
+}
+
+static void APIENTRY se_gl_soft_generate_mipmap(const GLenum target) {
+	// Only the base level is sampled, so there is nothing to build.
+	(void)se_gl_soft_bound_texture(target);
+}
+
+static void APIENTRY se_gl_soft_read_buffer(const GLenum src) {
+	switch (src) {
+		case GL_NONE:
+		case GL_FRONT:
+		case GL_BACK:
+		case GL_COLOR_ATTACHMENT0:
+			g_se_gl_soft.read_buffer = src;
+			break;
+		default:
+			se_gl_soft_error(GL_INVALID_ENUM);
+			break;
+	}
+}
+
+static void APIENTRY se_gl_soft_blit_framebuffer(const GLint src_x0, const GLint src_y0, const GLint src_x1, const GLint src_y1, const GLint dst_x0, const GLint dst_y0, const GLint dst_x1, const GLint dst_y1, const GLbitfield mask, const GLenum filter) {
+	if ((mask & ~(GLbitfield)(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT)) != 0u ||
+		(filter != GL_NEAREST && filter != GL_LINEAR)) {
+		se_gl_soft_error(GL_INVALID_ENUM);
+		return;
+	}
+	if (filter == GL_LINEAR && (mask & GL_DEPTH_BUFFER_BIT)) {
+		se_gl_soft_error(GL_INVALID_OPERATION);
+		return;
+	}
+	se_gl_soft_flush();
+	se_soft_image* source[2] = {NULL, NULL};
+	se_soft_image* destination[2] = {NULL, NULL};
+	se_gl_soft_framebuffer_images(g_se_gl_soft.read_framebuffer, &source[0], &source[1]);
+	se_gl_soft_framebuffer_images(g_se_gl_soft.draw_framebuffer, &destination[0], &destination[1]);
+	const i32 dst_w = dst_x1 - dst_x0;
+	const i32 dst_h = dst_y1 - dst_y0;
+	if (dst_w == 0 || dst_h == 0) {
+		return;
+	}
+	const f32 scale_x = (f32)(src_x1 - src_x0) / (f32)dst_w;
+	const f32 scale_y = (f32)(src_y1 - src_y0) / (f32)dst_h;
+	const i32 min_x = dst_x0 < dst_x1 ? dst_x0 : dst_x1;
+	const i32 max_x = dst_x0 < dst_x1 ? dst_x1 : dst_x0;
+	const i32 min_y = dst_y0 < dst_y1 ? dst_y0 : dst_y1;
+	const i32 max_y = dst_y0 < dst_y1 ? dst_y1 : dst_y0;
+	for (u32 plane = 0u; plane < 2u; ++plane) {
+		const GLbitfield bit = plane == 0u ? GL_COLOR_BUFFER_BIT : GL_DEPTH_BUFFER_BIT;
+		se_soft_image* from = source[plane];
+		se_soft_image* to = destination[plane];
+		if (!(mask & bit) || !from || !to || from == to) {
+			continue;
+		}
+		const se_soft_sampler sampler = {
+			.image = from,
+			.wrap = {SE_SOFT_WRAP_CLAMP, SE_SOFT_WRAP_CLAMP, SE_SOFT_WRAP_CLAMP},
+			.linear = filter == GL_LINEAR
+		};
+		for (i32 y = min_y < 0 ? 0 : min_y; y < max_y && y < (i32)to->height; ++y) {
+			const f32 sy = (f32)src_y0 + ((f32)y + 0.5f - (f32)dst_y0) * scale_y;
+			if (sy < 0.0f || sy >= (f32)from->height) {
+				continue;
+			}
+			for (i32 x = min_x < 0 ? 0 : min_x; x < max_x && x < (i32)to->width; ++x) {
+				const f32 sx = (f32)src_x0 + ((f32)x + 0.5f - (f32)dst_x0) * scale_x;
+				if (sx < 0.0f || sx >= (f32)from->width) {
+					continue;
+				}
+				f32 value[4];
+				if (sampler.linear) {
+					const f32 coords[2] = {sx / (f32)from->width, sy / (f32)from->height};
+					se_soft_sample(&sampler, coords, 2u, value);
+				} else {
+					se_soft_image_load(from, (u32)sx, (u32)sy, 0u, value);
+				}
+				se_soft_image_store(to, (u32)x, (u32)y, 0u, value);
+			}
+		}
+	}
+}
+
+// Draws
+
+static void se_gl_soft_fetch_attributes(const se_gl_soft_vertex_job* job, const u32 vertex, const u32 instance, f32 out_attributes[SE_SOFT_GLSL_MAX_ATTRIBUTES][4]) {
+	for (u32 location = 0u; location < SE_SOFT_GLSL_MAX_ATTRIBUTES; ++location) {
+		f32* value = out_attributes[location];
+		value[0] = 0.0f;
+		value[1] = 0.0f;
+		value[2] = 0.0f;
+		value[3] = 1.0f;
+		if (!(job->attribute_mask & (1u << location)) || !(job->enabled_mask & (1u << location))) {
+			continue;
+		}
+		const se_gl_soft_attrib_source* source = &job->sources[location];
+		const u32 element = source->divisor > 0u ? instance / source->divisor : vertex;
+		const u32 type_bytes = se_gl_soft_type_bytes(source->type);
+		const sz offset = (sz)element * source->stride;
+		if (offset > source->available || (sz)source->size * type_bytes > source->available - offset) {
+			continue;
+		}
+		for (u32 c = 0u; c < source->size; ++c) {
+			value[c] = se_gl_soft_read_component(source->data + offset + c * type_bytes, source->type, source->normalized);
+		}
+	}
+}
+
+static void se_gl_soft_shade_vertices(const u32 batch, void* user_data) {
+	const se_gl_soft_vertex_job* job = (const se_gl_soft_vertex_job*)user_data;
+	const u32 begin = batch * SE_GL_SOFT_VERTEX_BATCH;
+	const u32 end = begin + SE_GL_SOFT_VERTEX_BATCH < job->total ? begin + SE_GL_SOFT_VERTEX_BATCH : job->total;
+	void* scratch = malloc(job->scratch_bytes > 0u ? job->scratch_bytes : 1u);
+	if (!scratch) {
+		// A zero position has w == 0 and is clipped away.
+		memset(job->out + (sz)begin * job->vertex_floats, 0, sizeof(f32) * (sz)(end - begin) * job->vertex_floats);
+		return;
+	}
+	f32 attributes[SE_SOFT_GLSL_MAX_ATTRIBUTES][4];
+	for (u32 i = begin; i < end; ++i) {
+		const u32 vertex = job->vertices[i % job->vertex_count];
+		const u32 instance = job->first_instance + i / job->vertex_count;
+		se_gl_soft_fetch_attributes(job, vertex, instance, attributes);
+		se_soft_glsl_run_vertex(job->draw, scratch, (const f32(*)[4])attributes, (i32)vertex, (i32)instance, job->out + (sz)i * job->vertex_floats);
+	}
+	free(scratch);
+}
+
+static const se_soft_glsl_draw* se_gl_soft_snapshot_draw(const se_soft_glsl_program* program) {
+	const sz header = (sizeof(se_gl_soft_snapshot) + 15u) & ~(sz)15u;
+	se_gl_soft_snapshot* snapshot = (se_gl_soft_snapshot*)malloc(header + se_soft_glsl_program_uniform_bytes(program));
+	if (!snapshot) {
+		return NULL;
+	}
+	void* uniforms = (u8*)snapshot + header;
+	se_soft_glsl_program_copy_uniforms(program, uniforms);
+	snapshot->draw.program = program;
+	snapshot->draw.uniforms = uniforms;
+	for (u32 unit = 0u; unit < SE_SOFT_GLSL_MAX_TEXTURE_UNITS; ++unit) {
+		for (u32 kind = 0u; kind < SE_SOFT_GLSL_SAMPLER_KIND_COUNT; ++kind) {
+			se_soft_sampler* sampler = &snapshot->draw.samplers[unit][kind];
+			const se_gl_soft_texture* texture = se_gl_soft_table_get(&g_se_gl_soft.textures, g_se_gl_soft.bound_textures[unit][kind]);
+			memset(sampler, 0, sizeof(*sampler));
+			if (!texture || !texture->image.texels) {
+				continue;
+			}
+			sampler->image = &texture->image;
+			memcpy(sampler->wrap, texture->wrap, sizeof(sampler->wrap));
+			sampler->linear = texture->linear;
+		}
+	}
+	snapshot->next = g_se_gl_soft.snapshots;
+	g_se_gl_soft.snapshots = snapshot;
+	return &snapshot->draw;
+}
+
+static void se_gl_soft_fill_state(const se_gl_soft_program* program, const se_soft_glsl_draw* draw, se_soft_state* out_state) {
+	memset(out_state, 0, sizeof(*out_state));
+	out_state->fragment = se_soft_glsl_run_fragment;
+	out_state->shader = draw;
+	out_state->scratch_bytes = se_soft_glsl_program_scratch_bytes(program->program);
+	out_state->varying_count = se_soft_glsl_program_varying_count(program->program);
+	out_state->flat_varyings = se_soft_glsl_program_flat_varyings(program->program);
+	out_state->writes_depth = se_soft_glsl_program_writes_depth(program->program);
+	memcpy(out_state->viewport, g_se_gl_soft.viewport, sizeof(out_state->viewport));
+	out_state->cull = SE_SOFT_CULL_NONE;
+	if (g_se_gl_soft.caps[SE_GL_SOFT_CAP_CULL_FACE]) {
+		out_state->cull = g_se_gl_soft.cull_mode == GL_FRONT ? SE_SOFT_CULL_FRONT :
+			(g_se_gl_soft.cull_mode == GL_FRONT_AND_BACK ? SE_SOFT_CULL_FRONT_AND_BACK : SE_SOFT_CULL_BACK);
+	}
+	out_state->front_ccw = g_se_gl_soft.front_face == GL_CCW;
+	out_state->depth_test = g_se_gl_soft.caps[SE_GL_SOFT_CAP_DEPTH_TEST];
+	out_state->depth_write = g_se_gl_soft.depth_mask;
+	out_state->depth_func = (se_soft_depth_func)(g_se_gl_soft.depth_func - GL_NEVER);
+	out_state->blend = g_se_gl_soft.caps[SE_GL_SOFT_CAP_BLEND];
+	out_state->blend_src_rgb = se_gl_soft_blend_factor(g_se_gl_soft.blend_src_rgb);
+	out_state->blend_dst_rgb = se_gl_soft_blend_factor(g_se_gl_soft.blend_dst_rgb);
+	out_state->blend_src_alpha = se_gl_soft_blend_factor(g_se_gl_soft.blend_src_alpha);
+	out_state->blend_dst_alpha = se_gl_soft_blend_factor(g_se_gl_soft.blend_dst_alpha);
+	(void)se_gl_soft_blend_equation(g_se_gl_soft.blend_equation_rgb, &out_state->blend_equation_rgb);
+	(void)se_gl_soft_blend_equation(g_se_gl_soft.blend_equation_alpha, &out_state->blend_equation_alpha);
+	memcpy(out_state->color_mask, g_se_gl_soft.color_mask, sizeof(out_state->color_mask));
+	out_state->polygon_offset = g_se_gl_soft.caps[SE_GL_SOFT_CAP_POLYGON_OFFSET_FILL];
+	out_state->polygon_offset_factor = g_se_gl_soft.polygon_offset_factor;
+	out_state->polygon_offset_units = g_se_gl_soft.polygon_offset_units;
+}
+
+// Reads `count` element indices (plus `base_vertex`) from the element buffer, client memory, or
+// the `first` range for array draws.
+static b8 se_gl_soft_read_elements(const GLint first, const GLsizei count, const GLenum index_type, const void* indices, const GLint base_vertex) {
+	if (!se_gl_soft_reserve((void**)&g_se_gl_soft.elements, &g_se_gl_soft.element_capacity, sizeof(u32) * (sz)count)) {
+		se_gl_soft_error(GL_OUT_OF_MEMORY);
+		return false;
+	}
+	if (index_type == GL_NONE) {
+		if (first < 0) {
+			se_gl_soft_error(GL_INVALID_VALUE);
+			return false;
+		}
+		for (GLsizei i = 0; i < count; ++i) {
+			g_se_gl_soft.elements[i] = (u32)first + (u32)i;
+		}
+		return true;
+	}
+	const u32 index_bytes = index_type == GL_UNSIGNED_BYTE ? 1u : (index_type == GL_UNSIGNED_SHORT ? 2u : (index_type == GL_UNSIGNED_INT ? 4u : 0u));
+	if (index_bytes == 0u) {
+		se_gl_soft_error(GL_INVALID_ENUM);
+		return false;
+	}
+	const u8* source = (const u8*)indices;
+	const se_gl_soft_vertex_array* vertex_array = se_gl_soft_current_vertex_array();
+	if (vertex_array->element_buffer != 0u) {
+		const se_gl_soft_buffer* buffer = se_gl_soft_table_get(&g_se_gl_soft.buffers, vertex_array->element_buffer);
+		const sz offset = (sz)(uintptr_t)indices;
+		if (!buffer || offset > buffer->size || (sz)count * index_bytes > buffer->size - offset) {
+			se_gl_soft_error(GL_INVALID_OPERATION);
+			return false;
+		}
+		source = buffer->data + offset;
+	} else if (!source) {
+		se_gl_soft_error(GL_INVALID_OPERATION);
+		return false;
+	}
+	for (GLsizei i = 0; i < count; ++i) {
+		u32 value = 0u;
+		if (index_bytes == 1u) {
+			value = source[i];
+		} else if (index_bytes == 2u) {
+			u16 value16 = 0u;
+			memcpy(&value16, source + (sz)i * 2u, sizeof(value16));
+			value = value16;
+		} else {
+			memcpy(&value, source + (sz)i * 4u, sizeof(value));
+		}
+		const i64 vertex = (i64)value + base_vertex;
+		if (vertex < 0 || vertex > (i64)UINT32_MAX) {
+			se_gl_soft_error(GL_INVALID_OPERATION);
+			return false;
+		}
+		g_se_gl_soft.elements[i] = (u32)vertex;
+	}
+	return true;
+}
+
+// Splits the element list into triangles over `local` vertex slots. The last vertex of each
+// triangle is the provoking one, as GL's default convention requires for flat varyings.
+static u32 se_gl_soft_triangulate(const GLenum mode, const u32* local, const u32 count) {
+	const u32 triangle_count = mode == GL_TRIANGLES ? count / 3u : count - 2u;
+	if (!se_gl_soft_reserve((void**)&g_se_gl_soft.triangles, &g_se_gl_soft.triangle_capacity, sizeof(u32) * 3u * (sz)triangle_count)) {
+		se_gl_soft_error(GL_OUT_OF_MEMORY);
+		return 0u;
+	}
+	u32* out = g_se_gl_soft.triangles;
+	for (u32 t = 0u; t < triangle_count; ++t) {
+		if (mode == GL_TRIANGLES) {
+			out[t * 3u] = local[t * 3u];
+			out[t * 3u + 1u] = local[t * 3u + 1u];
+			out[t * 3u + 2u] = local[t * 3u + 2u];
+		} else if (mode == GL_TRIANGLE_STRIP) {
+			out[t * 3u] = local[(t & 1u) ? t + 1u : t];
+			out[t * 3u + 1u] = local[(t & 1u) ? t : t + 1u];
+			out[t * 3u + 2u] = local[t + 2u];
+		} else {
+			out[t * 3u] = local[0];
+			out[t * 3u + 1u] = local[t + 1u];
+			out[t * 3u + 2u] = local[t + 2u];
+		}
+	}
+	return triangle_count;
+}
+
+static void se_gl_soft_draw(const GLenum mode, const GLint first, const GLsizei count, const GLenum index_type, const void* indices, const GLsizei instance_count, const GLint base_vertex) {
+	if (mode != GL_TRIANGLES && mode != GL_TRIANGLE_STRIP && mode != GL_TRIANGLE_FAN) {
+		// Points and lines are not rasterized by this backend.
+		if (mode > GL_TRIANGLE_FAN) {
+			se_gl_soft_error(GL_INVALID_ENUM);
+		}
+		return;
+	}
+	if (count < 0 || instance_count < 0) {
+		se_gl_soft_error(GL_INVALID_VALUE);
+		return;
+	}
+	se_gl_soft_program* program = se_gl_soft_current_program();
+	if (!program) {
+		se_gl_soft_error(GL_INVALID_OPERATION);
+		return;
+	}
+	if (count < 3 || instance_count == 0 || !g_se_gl_soft.raster) {
+		return;
+	}
+	if (!se_gl_soft_read_elements(first, count, index_type, indices, base_vertex) || !se_gl_soft_bind_targets()) {
+		return;
+	}
+
+	// Indexed meshes are shaded once per distinct vertex when their index range is dense;
+	// otherwise every element is shaded on its own.
+	const u32 element_count = (u32)count;
+	u32 min_index = UINT32_MAX;
+	u32 max_index = 0u;
+	for (u32 i = 0u; i < element_count; ++i) {
+		const u32 value = g_se_gl_soft.elements[i];
+		min_index = value < min_index ? value : min_index;
+		max_index = value > max_index ? value : max_index;
+	}
+	const u64 range = (u64)max_index - min_index + 1u;
+	const b8 dense = range <= (u64)element_count * 2u + 64u;
+	const u32 vertex_count = dense ? (u32)range : element_count;
+	if (!se_gl_soft_reserve((void**)&g_se_gl_soft.vertices, &g_se_gl_soft.vertex_capacity, sizeof(u32) * (sz)vertex_count * 2u)) {
+		se_gl_soft_error(GL_OUT_OF_MEMORY);
+		return;
+	}
+	u32* local = g_se_gl_soft.vertices + vertex_count;
+	for (u32 i = 0u; i < vertex_count; ++i) {
+		g_se_gl_soft.vertices[i] = dense ? min_index + i : g_se_gl_soft.elements[i];
+	}
+	for (u32 i = 0u; i < element_count && i < vertex_count; ++i) {
+		local[i] = dense ? g_se_gl_soft.elements[i] - min_index : i;
+	}
+	if (dense) {
+		if (!se_gl_soft_reserve((void**)&g_se_gl_soft.elements, &g_se_gl_soft.element_capacity, sizeof(u32) * (sz)element_count)) {
+			se_gl_soft_error(GL_OUT_OF_MEMORY);
+			return;
+		}
+		for (u32 i = 0u; i < element_count; ++i) {
+			g_se_gl_soft.elements[i] -= min_index;
+		}
+		local = g_se_gl_soft.elements;
+	}
+	const u32 triangle_count = se_gl_soft_triangulate(mode, local, element_count);
+	if (triangle_count == 0u) {
+		return;
+	}
+
+	const se_soft_glsl_draw* draw = se_gl_soft_snapshot_draw(program->program);
+	if (!draw) {
+		se_gl_soft_error(GL_OUT_OF_MEMORY);
+		return;
+	}
+	se_soft_state state;
+	se_gl_soft_fill_state(program, draw, &state);
+
+	se_gl_soft_vertex_job job = {0};
+	job.draw = draw;
+	job.attribute_mask = se_soft_glsl_program_attribute_mask(program->program);
+	job.vertices = g_se_gl_soft.vertices;
+	job.vertex_count = vertex_count;
+	job.scratch_bytes = state.scratch_bytes;
+	job.vertex_floats = 4u + state.varying_count;
+	const se_gl_soft_vertex_array* vertex_array = se_gl_soft_current_vertex_array();
+	for (u32 location = 0u; location < SE_SOFT_GLSL_MAX_ATTRIBUTES; ++location) {
+		const se_gl_soft_attrib* attrib = &vertex_array->attribs[location];
+		if (!attrib->enabled || !(job.attribute_mask & (1u << location))) {
+			continue;
+		}
+		se_gl_soft_attrib_source* source = &job.sources[location];
+		source->size = (u32)attrib->size;
+		source->type = attrib->type;
+		source->normalized = attrib->normalized;
+		source->divisor = attrib->divisor;
+		source->stride = attrib->stride > 0 ? (u32)attrib->stride : (u32)attrib->size * se_gl_soft_type_bytes(attrib->type);
+		if (attrib->buffer == 0u) {
+			source->data = attrib->pointer;
+			source->available = attrib->pointer ? SIZE_MAX : 0u;
+		} else {
+			const se_gl_soft_buffer* buffer = se_gl_soft_table_get(&g_se_gl_soft.buffers, attrib->buffer);
+			const sz offset = (sz)(uintptr_t)attrib->pointer;
+			if (!buffer || !buffer->data || offset >= buffer->size) {
+				continue;
+			}
+			source->data = buffer->data + offset;
+			source->available = buffer->size - offset;
+		}
+		job.enabled_mask |= 1u << location;
+	}
+
+	// Instances are submitted in groups so the shaded vertices of one group stay bounded.
+	const u32 instances_per_submit = vertex_count < SE_GL_SOFT_SUBMIT_VERTICES ? SE_GL_SOFT_SUBMIT_VERTICES / vertex_count : 1u;
+	for (u32 instance = 0u; instance < (u32)instance_count; instance += instances_per_submit) {
+		const u32 remaining = (u32)instance_count - instance;
+		const u32 instances = remaining < instances_per_submit ? remaining : instances_per_submit;
+		const u64 total = (u64)vertex_count * instances;
+		if (!se_gl_soft_reserve((void**)&g_se_gl_soft.shaded, &g_se_gl_soft.shaded_capacity, sizeof(f32) * (sz)total * job.vertex_floats) ||
+			!se_gl_soft_reserve((void**)&g_se_gl_soft.indices, &g_se_gl_soft.index_capacity, sizeof(u32) * 3u * (sz)triangle_count * instances)) {
+			se_gl_soft_error(GL_OUT_OF_MEMORY);
+			return;
+		}
+		job.first_instance = instance;
+		job.total = (u32)total;
+		job.out = g_se_gl_soft.shaded;
+		const u32 batches = (job.total + SE_GL_SOFT_VERTEX_BATCH - 1u) / SE_GL_SOFT_VERTEX_BATCH;
+		if (!g_se_gl_soft.workers || batches == 1u ||
+			!se_worker_parallel_for(g_se_gl_soft.workers, batches, 1u, se_gl_soft_shade_vertices, &job)) {
+			for (u32 batch = 0u; batch < batches; ++batch) {
+				se_gl_soft_shade_vertices(batch, &job);
+			}
+		}
+		for (u32 i = 0u; i < instances; ++i) {
+			u32* out = g_se_gl_soft.indices + (sz)i * triangle_count * 3u;
+			for (u32 k = 0u; k < triangle_count * 3u; ++k) {
+				out[k] = g_se_gl_soft.triangles[k] + i * vertex_count;
+			}
+		}
+		if (!se_soft_raster_draw(g_se_gl_soft.raster, &state, g_se_gl_soft.shaded, job.vertex_floats, job.total,
+				g_se_gl_soft.indices, triangle_count * 3u * instances)) {
+			se_gl_soft_error(GL_OUT_OF_MEMORY);
+			return;
+		}
+	}
+}
+
+static void APIENTRY se_gl_soft_draw_arrays_instanced(const GLenum mode, const GLint first, const GLsizei count, const GLsizei instancecount) {
+	se_gl_soft_draw(mode, first, count, GL_NONE, NULL, instancecount, 0);
+}
+
+static void APIENTRY se_gl_soft_draw_elements_instanced(const GLenum mode, const GLsizei count, const GLenum type, const void* indices, const GLsizei primcount) {
+	if (type == GL_NONE) {
+		se_gl_soft_error(GL_INVALID_ENUM);
+		return;
+	}
+	se_gl_soft_draw(mode, 0, count, type, indices, primcount, 0);
+}
+
+static void APIENTRY se_gl_soft_draw_elements_instanced_base_vertex(const GLenum mode, const GLsizei count, const GLenum type, const void* indices, const GLsizei instance_count, const GLint base_vertex) {
+	if (type == GL_NONE) {
+		se_gl_soft_error(GL_INVALID_ENUM);
+		return;
+	}
+	se_gl_soft_draw(mode, 0, count, type, indices, instance_count, base_vertex);
+}
+
+// GL 1.x entry points. The engine calls these by name, so this backend provides the symbols
+// a driver library would.
+
+GLenum APIENTRY glGetError(void) {
+	const GLenum error = g_se_gl_soft.error;
+	g_se_gl_soft.error = GL_NO_ERROR;
+	return error;
+}
+
+const GLubyte* APIENTRY glGetString(GLenum name) {
+	switch (name) {
+		case GL_VENDOR: return (const GLubyte*)"Syphax-Engine";
+		case GL_RENDERER: return (const GLubyte*)"Syphax-Engine software rasterizer";
+		case GL_VERSION: return (const GLubyte*)"3.3 (software)";
+		case GL_SHADING_LANGUAGE_VERSION: return (const GLubyte*)"3.30";
+		case GL_EXTENSIONS: return (const GLubyte*)"";
+		default:
+			se_gl_soft_error(GL_INVALID_ENUM);
+			return NULL;
+	}
+}
+
+void APIENTRY glEnable(GLenum cap) {
+	const i32 index = se_gl_soft_cap_index(cap);
+	if (index < 0) {
+		se_gl_soft_error(GL_INVALID_ENUM);
+		return;
+	}
+	g_se_gl_soft.caps[index] = true;
+}
+
+void APIENTRY glDisable(GLenum cap) {
+	const i32 index = se_gl_soft_cap_index(cap);
+	if (index < 0) {
+		se_gl_soft_error(GL_INVALID_ENUM);
+		return;
+	}
+	g_se_gl_soft.caps[index] = false;
+}
+
+GLboolean APIENTRY glIsEnabled(GLenum cap) {
+	const i32 index = se_gl_soft_cap_index(cap);
+	if (index < 0) {
+		se_gl_soft_error(GL_INVALID_ENUM);
+		return GL_FALSE;
+	}
+	return g_se_gl_soft.caps[index] ? GL_TRUE : GL_FALSE;
+}
+
+void APIENTRY glBlendEquation(GLenum mode) {
+	se_soft_blend_equation equation = SE_SOFT_BLEND_ADD;
+	if (!se_gl_soft_blend_equation(mode, &equation)) {
+		se_gl_soft_error(GL_INVALID_ENUM);
+		return;
+	}
+	g_se_gl_soft.blend_equation_rgb = mode;
+	g_se_gl_soft.blend_equation_alpha = mode;
+}
+
+void APIENTRY glBlendFunc(GLenum sfactor, GLenum dfactor) {
+	if (!se_gl_soft_blend_factor_valid(sfactor) || !se_gl_soft_blend_factor_valid(dfactor)) {
+		se_gl_soft_error(GL_INVALID_ENUM);
+		return;
+	}
+	g_se_gl_soft.blend_src_rgb = sfactor;
+	g_se_gl_soft.blend_src_alpha = sfactor;
+	g_se_gl_soft.blend_dst_rgb = dfactor;
+	g_se_gl_soft.blend_dst_alpha = dfactor;
+}
+
+void APIENTRY glClearColor(GLclampf red, GLclampf green, GLclampf blue, GLclampf alpha) {
+	g_se_gl_soft.clear_color[0] = se_gl_soft_clamp01(red);
+	g_se_gl_soft.clear_color[1] = se_gl_soft_clamp01(green);
+	g_se_gl_soft.clear_color[2] = se_gl_soft_clamp01(blue);
+	g_se_gl_soft.clear_color[3] = se_gl_soft_clamp01(alpha);
+}
+
+void APIENTRY glClear(GLbitfield mask) {
+	if ((mask & ~(GLbitfield)(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT)) != 0u) {
+		se_gl_soft_error(GL_INVALID_VALUE);
+		return;
+	}
+	if (!se_gl_soft_bind_targets()) {
+		return;
+	}
+	se_gl_soft_flush();
+	const b8 color = (mask & GL_COLOR_BUFFER_BIT) != 0u;
+	const b8 depth = (mask & GL_DEPTH_BUFFER_BIT) != 0u && g_se_gl_soft.depth_mask;
+	se_soft_raster_clear(g_se_gl_soft.raster,
+		color ? g_se_gl_soft.clear_color : NULL,
+		g_se_gl_soft.color_mask,
+		depth ? &g_se_gl_soft.clear_depth : NULL);
+}
+
+void APIENTRY glColorMask(GLboolean red, GLboolean green, GLboolean blue, GLboolean alpha) {
+	g_se_gl_soft.color_mask[0] = red == GL_TRUE;
+	g_se_gl_soft.color_mask[1] = green == GL_TRUE;
+	g_se_gl_soft.color_mask[2] = blue == GL_TRUE;
+	g_se_gl_soft.color_mask[3] = alpha == GL_TRUE;
+}
+
+void APIENTRY glDepthMask(GLboolean flag) {
+	g_se_gl_soft.depth_mask = flag == GL_TRUE;
+}
+
+void APIENTRY glStencilMask(GLuint mask) {
+	g_se_gl_soft.stencil_mask = mask;
+}
+
+void APIENTRY glDepthFunc(GLenum func) {
+	if (func < GL_NEVER || func > GL_ALWAYS) {
+		se_gl_soft_error(GL_INVALID_ENUM);
+		return;
+	}
+	g_se_gl_soft.depth_func = func;
+}
+
+void APIENTRY glCullFace(GLenum mode) {
+	if (mode != GL_FRONT && mode != GL_BACK && mode != GL_FRONT_AND_BACK) {
+		se_gl_soft_error(GL_INVALID_ENUM);
+		return;
+	}
+	g_se_gl_soft.cull_mode = mode;
+}
+
+void APIENTRY glFrontFace(GLenum mode) {
+	if (mode != GL_CW && mode != GL_CCW) {
+		se_gl_soft_error(GL_INVALID_ENUM);
+		return;
+	}
+	g_se_gl_soft.front_face = mode;
+}
+
+void APIENTRY glPolygonOffset(GLfloat factor, GLfloat units) {
+	g_se_gl_soft.polygon_offset_factor = factor;
+	g_se_gl_soft.polygon_offset_units = units;
+}
+
+void APIENTRY glViewport(GLint x, GLint y, GLsizei width, GLsizei height) {
+	if (width < 0 || height < 0) {
+		se_gl_soft_error(GL_INVALID_VALUE);
+		return;
+	}
+	g_se_gl_soft.viewport[0] = x;
+	g_se_gl_soft.viewport[1] = y;
+	g_se_gl_soft.viewport[2] = width < SE_GL_SOFT_MAX_TEXTURE_SIZE ? width : SE_GL_SOFT_MAX_TEXTURE_SIZE;
+	g_se_gl_soft.viewport[3] = height < SE_GL_SOFT_MAX_TEXTURE_SIZE ? height : SE_GL_SOFT_MAX_TEXTURE_SIZE;
+}
+
+void APIENTRY glPixelStorei(GLenum pname, GLint param) {
+	if (pname != GL_PACK_ALIGNMENT && pname != GL_UNPACK_ALIGNMENT) {
+		se_gl_soft_error(GL_INVALID_ENUM);
+		return;
+	}
+	if (param != 1 && param != 2 && param != 4 && param != 8) {
+		se_gl_soft_error(GL_INVALID_VALUE);
+		return;
+	}
+	if (pname == GL_PACK_ALIGNMENT) {
+		g_se_gl_soft.pack_alignment = param;
+	} else {
+		g_se_gl_soft.unpack_alignment = param;
+	}
+}
+
+void APIENTRY glDrawElements(GLenum mode, GLsizei count, GLenum type, const GLvoid* indices) {
+	se_gl_soft_draw_elements_instanced(mode, count, type, indices, 1);
+}
+
+void APIENTRY glActiveTexture(GLenum texture) {
+	if (texture < GL_TEXTURE0 || texture >= GL_TEXTURE0 + SE_SOFT_GLSL_MAX_TEXTURE_UNITS) {
+		se_gl_soft_error(GL_INVALID_ENUM);
+		return;
+	}
+	g_se_gl_soft.active_texture = texture - GL_TEXTURE0;
+}
+
+void APIENTRY glGenTextures(GLsizei n, GLuint* textures) {
+	se_gl_soft_gen(&g_se_gl_soft.textures, sizeof(se_gl_soft_texture), n, textures);
+	for (GLsizei i = 0; textures && i < n; ++i) {
+		se_gl_soft_texture* texture = se_gl_soft_table_get(&g_se_gl_soft.textures, textures[i]);
+		if (!texture) {
+			continue;
+		}
+		texture->wrap[0] = SE_SOFT_WRAP_REPEAT;
+		texture->wrap[1] = SE_SOFT_WRAP_REPEAT;
+		texture->wrap[2] = SE_SOFT_WRAP_REPEAT;
+		texture->linear = true;
+	}
+}
+
+void APIENTRY glBindTexture(GLenum target, GLuint texture) {
+	const i32 kind = se_gl_soft_texture_kind(target);
+	if (kind < 0) {
+		se_gl_soft_error(GL_INVALID_ENUM);
+		return;
+	}
+	se_gl_soft_texture* object = se_gl_soft_table_get(&g_se_gl_soft.textures, texture);
+	if (texture != 0u && (!object || (object->target != 0u && object->target != target))) {
+		se_gl_soft_error(GL_INVALID_OPERATION);
+		return;
+	}
+	if (object) {
+		object->target = target;
+	}
+	g_se_gl_soft.bound_textures[g_se_gl_soft.active_texture][kind] = texture;
+}
+
+void APIENTRY glDeleteTextures(GLsizei n, const GLuint* textures) {
+	if (n < 0) {
+		se_gl_soft_error(GL_INVALID_VALUE);
+		return;
+	}
+	for (GLsizei i = 0; textures && i < n; ++i) {
+		se_gl_soft_texture* texture = se_gl_soft_table_remove(&g_se_gl_soft.textures, textures[i]);
+		if (!texture) {
+			continue;
+		}
+		for (u32 unit = 0u; unit < SE_SOFT_GLSL_MAX_TEXTURE_UNITS; ++unit) {
+			for (u32 kind = 0u; kind < SE_SOFT_GLSL_SAMPLER_KIND_COUNT; ++kind) {
+				if (g_se_gl_soft.bound_textures[unit][kind] == textures[i]) {
+					g_se_gl_soft.bound_textures[unit][kind] = 0u;
+				}
+			}
+		}
+		se_gl_soft_release_targets();
+		se_soft_image_free(&texture->image);
+		free(texture);
+	}
+}
+
+void APIENTRY glTexImage2D(GLenum target, GLint level, GLint internalFormat, GLsizei width, GLsizei height, GLint border, GLenum format, GLenum type, const GLvoid* pixels) {
+	if (target != GL_TEXTURE_2D) {
+		se_gl_soft_error(GL_INVALID_ENUM);
+		return;
+	}
+	if (border != 0 || level < 0) {
+		se_gl_soft_error(GL_INVALID_VALUE);
+		return;
+	}
+	se_gl_soft_texture* texture = se_gl_soft_bound_texture(target);
+	// Only the base level is sampled, so mip levels are accepted and dropped.
+	if (!texture || level > 0) {
+		return;
+	}
+	se_gl_soft_image_define(&texture->image, internalFormat, width, height, 1, format, type, pixels);
+}
+
+void APIENTRY glTexParameteri(GLenum target, GLenum pname, GLint param) {
+	se_gl_soft_texture* texture = se_gl_soft_bound_texture(target);
+	if (!texture) {
+		return;
+	}
+	switch (pname) {
+		case GL_TEXTURE_WRAP_S:
+		case GL_TEXTURE_WRAP_T:
+		case GL_TEXTURE_WRAP_R: {
+			se_soft_wrap wrap = SE_SOFT_WRAP_REPEAT;
+			switch (param) {
+				case GL_REPEAT: wrap = SE_SOFT_WRAP_REPEAT; break;
+				case GL_CLAMP_TO_EDGE:
+				case GL_CLAMP_TO_BORDER: wrap = SE_SOFT_WRAP_CLAMP; break;
+				case GL_MIRRORED_REPEAT: wrap = SE_SOFT_WRAP_MIRROR; break;
+				default:
+					se_gl_soft_error(GL_INVALID_ENUM);
+					return;
+			}
+			texture->wrap[pname == GL_TEXTURE_WRAP_S ? 0 : (pname == GL_TEXTURE_WRAP_T ? 1 : 2)] = wrap;
+			break;
+		}
+		case GL_TEXTURE_MAG_FILTER:
+			if (param != GL_NEAREST && param != GL_LINEAR) {
+				se_gl_soft_error(GL_INVALID_ENUM);
+				return;
+			}
+			texture->linear = param == GL_LINEAR;
+			break;
+		case GL_TEXTURE_MIN_FILTER:
+		case GL_TEXTURE_BASE_LEVEL:
+		case GL_TEXTURE_MAX_LEVEL:
+		case GL_TEXTURE_MIN_LOD:
+		case GL_TEXTURE_MAX_LOD:
+		case GL_TEXTURE_COMPARE_MODE:
+		case GL_TEXTURE_COMPARE_FUNC:
+			// Only the base level is sampled, with the magnification filter.
+			break;
+		default:
+			se_gl_soft_error(GL_INVALID_ENUM);
+			break;
+	}
+}
+
+void APIENTRY glReadPixels(GLint x, GLint y, GLsizei width, GLsizei height, GLenum format, GLenum type, GLvoid* pixels) {
+	const u32 channels = se_gl_soft_pixel_channels(format);
+	const u32 type_bytes = se_gl_soft_type_bytes(type);
+	if (channels == 0u || type_bytes == 0u || type == GL_BYTE || type == GL_SHORT || type == GL_INT) {
+		se_gl_soft_error(GL_INVALID_ENUM);
+		return;
+	}
+	if (width < 0 || height < 0) {
+		se_gl_soft_error(GL_INVALID_VALUE);
+		return;
+	}
+	se_gl_soft_flush();
+	se_soft_image* color = NULL;
+	se_soft_image* depth = NULL;
+	se_gl_soft_framebuffer_images(g_se_gl_soft.read_framebuffer, &color, &depth);
+	const se_soft_image* image = format == GL_DEPTH_COMPONENT ? depth : color;
+	if (!image || (format != GL_DEPTH_COMPONENT && g_se_gl_soft.read_buffer == GL_NONE)) {
+		se_gl_soft_error(GL_INVALID_OPERATION);
+		return;
+	}
+	if (!pixels) {
+		return;
+	}
+	const sz stride = se_gl_soft_row_stride((u32)width, channels * type_bytes, g_se_gl_soft.pack_alignment);
+	const b8 direct = image->format == SE_SOFT_FORMAT_RGBA8 && format == GL_RGBA && type == GL_UNSIGNED_BYTE;
+	for (GLsizei row = 0; row < height; ++row) {
+		u8* out = (u8*)pixels + (sz)row * stride;
+		const i64 source_y = (i64)y + row;
+		for (GLsizei column = 0; column < width; ++column) {
+			const i64 source_x = (i64)x + column;
+			u8* texel = out + (sz)column * channels * type_bytes;
+			if (source_x < 0 || source_y < 0 || source_x >= image->width || source_y >= image->height) {
+				memset(texel, 0, (sz)channels * type_bytes);
+				continue;
+			}
+			if (direct) {
+				memcpy(texel, image->texels + ((sz)source_y * image->width + (sz)source_x) * 4u, 4u);
+				continue;
+			}
+			f32 value[4];
+			se_soft_image_load(image, (u32)source_x, (u32)source_y, 0u, value);
+			if (format == GL_BGR || format == GL_BGRA) {
+				const f32 red = value[0];
+				value[0] = value[2];
+				value[2] = red;
+			}
+			for (u32 c = 0u; c < channels; ++c) {
+				se_gl_soft_write_component(texel + c * type_bytes, type, value[c]);
+			}
+		}
+	}
+}
+
+// State queries answer from one table of doubles so every glGet variant agrees.
+static u32 se_gl_soft_get(const GLenum pname, f64 out_values[4]) {
+	const i32 cap = se_gl_soft_cap_index(pname);
+	if (cap >= 0) {
+		out_values[0] = g_se_gl_soft.caps[cap] ? 1.0 : 0.0;
+		return 1u;
+	}
+	switch (pname) {
+		case GL_VIEWPORT:
+			for (u32 i = 0u; i < 4u; ++i) {
+				out_values[i] = g_se_gl_soft.viewport[i];
+			}
+			return 4u;
+		case GL_COLOR_WRITEMASK:
+			for (u32 i = 0u; i < 4u; ++i) {
+				out_values[i] = g_se_gl_soft.color_mask[i] ? 1.0 : 0.0;
+			}
+			return 4u;
+		case GL_COLOR_CLEAR_VALUE:
+			for (u32 i = 0u; i < 4u; ++i) {
+				out_values[i] = g_se_gl_soft.clear_color[i];
+			}
+			return 4u;
+		case GL_MAX_VIEWPORT_DIMS:
+			out_values[0] = SE_GL_SOFT_MAX_TEXTURE_SIZE;
+			out_values[1] = SE_GL_SOFT_MAX_TEXTURE_SIZE;
+			return 2u;
+		case GL_DEPTH_CLEAR_VALUE: out_values[0] = g_se_gl_soft.clear_depth; return 1u;
+		case GL_DEPTH_WRITEMASK: out_values[0] = g_se_gl_soft.depth_mask ? 1.0 : 0.0; return 1u;
+		case GL_DEPTH_FUNC: out_values[0] = g_se_gl_soft.depth_func; return 1u;
+		case GL_STENCIL_WRITEMASK: out_values[0] = g_se_gl_soft.stencil_mask; return 1u;
+		case GL_BLEND_SRC:
+		case GL_BLEND_SRC_RGB: out_values[0] = g_se_gl_soft.blend_src_rgb; return 1u;
+		case GL_BLEND_DST:
+		case GL_BLEND_DST_RGB: out_values[0] = g_se_gl_soft.blend_dst_rgb; return 1u;
+		case GL_BLEND_SRC_ALPHA: out_values[0] = g_se_gl_soft.blend_src_alpha; return 1u;
+		case GL_BLEND_DST_ALPHA: out_values[0] = g_se_gl_soft.blend_dst_alpha; return 1u;
+		case GL_BLEND_EQUATION_RGB: out_values[0] = g_se_gl_soft.blend_equation_rgb; return 1u;
+		case GL_BLEND_EQUATION_ALPHA: out_values[0] = g_se_gl_soft.blend_equation_alpha; return 1u;
+		case GL_CULL_FACE_MODE: out_values[0] = g_se_gl_soft.cull_mode; return 1u;
+		case GL_FRONT_FACE: out_values[0] = g_se_gl_soft.front_face; return 1u;
+		case GL_POLYGON_OFFSET_FACTOR: out_values[0] = g_se_gl_soft.polygon_offset_factor; return 1u;
+		case GL_POLYGON_OFFSET_UNITS: out_values[0] = g_se_gl_soft.polygon_offset_units; return 1u;
+		case GL_ACTIVE_TEXTURE: out_values[0] = GL_TEXTURE0 + g_se_gl_soft.active_texture; return 1u;
+		case GL_TEXTURE_BINDING_2D: out_values[0] = g_se_gl_soft.bound_textures[g_se_gl_soft.active_texture][SE_GL_SOFT_TEXTURE_2D]; return 1u;
+		case GL_TEXTURE_BINDING_3D: out_values[0] = g_se_gl_soft.bound_textures[g_se_gl_soft.active_texture][SE_GL_SOFT_TEXTURE_3D]; return 1u;
+		case GL_CURRENT_PROGRAM: out_values[0] = g_se_gl_soft.program; return 1u;
+		case GL_VERTEX_ARRAY_BINDING: out_values[0] = g_se_gl_soft.vertex_array; return 1u;
+		case GL_ARRAY_BUFFER_BINDING: out_values[0] = g_se_gl_soft.array_buffer; return 1u;
+		case GL_ELEMENT_ARRAY_BUFFER_BINDING: out_values[0] = se_gl_soft_current_vertex_array()->element_buffer; return 1u;
+		case GL_RENDERBUFFER_BINDING: out_values[0] = g_se_gl_soft.renderbuffer; return 1u;
+		case GL_DRAW_FRAMEBUFFER_BINDING: out_values[0] = g_se_gl_soft.draw_framebuffer; return 1u;
+		case GL_READ_FRAMEBUFFER_BINDING: out_values[0] = g_se_gl_soft.read_framebuffer; return 1u;
+		case GL_READ_BUFFER: out_values[0] = g_se_gl_soft.read_buffer; return 1u;
+		case GL_PACK_ALIGNMENT: out_values[0] = g_se_gl_soft.pack_alignment; return 1u;
+		case GL_UNPACK_ALIGNMENT: out_values[0] = g_se_gl_soft.unpack_alignment; return 1u;
+		case GL_MAJOR_VERSION: out_values[0] = 3.0; return 1u;
+		case GL_MINOR_VERSION: out_values[0] = 3.0; return 1u;
+		case GL_NUM_EXTENSIONS: out_values[0] = 0.0; return 1u;
+		case GL_MAX_COLOR_ATTACHMENTS:
+		case GL_MAX_DRAW_BUFFERS: out_values[0] = 1.0; return 1u;
+		case GL_MAX_TEXTURE_SIZE:
+		case GL_MAX_RENDERBUFFER_SIZE: out_values[0] = SE_GL_SOFT_MAX_TEXTURE_SIZE; return 1u;
+		case GL_MAX_3D_TEXTURE_SIZE: out_values[0] = SE_GL_SOFT_MAX_3D_TEXTURE_SIZE; return 1u;
+		case GL_MAX_COMBINED_TEXTURE_IMAGE_UNITS:
+		case GL_MAX_TEXTURE_IMAGE_UNITS:
+		case GL_MAX_VERTEX_TEXTURE_IMAGE_UNITS: out_values[0] = SE_SOFT_GLSL_MAX_TEXTURE_UNITS; return 1u;
+		case GL_MAX_VERTEX_ATTRIBS: out_values[0] = SE_SOFT_GLSL_MAX_ATTRIBUTES; return 1u;
+		default:
+			se_gl_soft_error(GL_INVALID_ENUM);
+			return 0u;
+	}
+}
+
+void APIENTRY glGetIntegerv(GLenum pname, GLint* params) {
+	f64 values[4] = {0.0, 0.0, 0.0, 0.0};
+	const u32 count = se_gl_soft_get(pname, values);
+	for (u32 i = 0u; params && i < count; ++i) {
+		params[i] = (GLint)llround(values[i]);
+	}
+}
+
+void APIENTRY glGetBooleanv(GLenum pname, GLboolean* params) {
+	f64 values[4] = {0.0, 0.0, 0.0, 0.0};
+	const u32 count = se_gl_soft_get(pname, values);
+	for (u32 i = 0u; params && i < count; ++i) {
+		params[i] = values[i] != 0.0 ? GL_TRUE : GL_FALSE;
+	}
+}
+
+void APIENTRY glGetFloatv(GLenum pname, GLfloat* params) {
+	f64 values[4] = {0.0, 0.0, 0.0, 0.0};
+	const u32 count = se_gl_soft_get(pname, values);
+	for (u32 i = 0u; params && i < count; ++i) {
+		params[i] = (GLfloat)values[i];
+	}
+}
+
+// Context
+
+static u32 se_gl_soft_thread_count(void) {
+	const c8* value = getenv("SE_SOFTWARE_THREADS");
+	if (value && value[0] != '\0') {
+		errno = 0;
+		c8* end = NULL;
+		const unsigned long parsed = strtoul(value, &end, 10);
+		if (errno == 0 && end != value && *end == '\0' && parsed > 0u) {
+			return parsed < SE_GL_SOFT_MAX_THREADS ? (u32)parsed : SE_GL_SOFT_MAX_THREADS;
+		}
+	}
+	const long online = sysconf(_SC_NPROCESSORS_ONLN);
+	if (online <= 1) {
+		return 1u;
+	}
+	return (u32)online < SE_GL_SOFT_MAX_THREADS ? (u32)online : SE_GL_SOFT_MAX_THREADS;
+}
+
+static void se_gl_soft_reset_state(void) {
+	g_se_gl_soft.read_buffer = GL_BACK;
+	g_se_gl_soft.caps[SE_GL_SOFT_CAP_DITHER] = true;
+	g_se_gl_soft.caps[SE_GL_SOFT_CAP_MULTISAMPLE] = true;
+	g_se_gl_soft.blend_src_rgb = GL_ONE;
+	g_se_gl_soft.blend_src_alpha = GL_ONE;
+	g_se_gl_soft.blend_dst_rgb = GL_ZERO;
+	g_se_gl_soft.blend_dst_alpha = GL_ZERO;
+	g_se_gl_soft.blend_equation_rgb = GL_FUNC_ADD;
+	g_se_gl_soft.blend_equation_alpha = GL_FUNC_ADD;
+	g_se_gl_soft.depth_func = GL_LESS;
+	g_se_gl_soft.depth_mask = true;
+	for (u32 i = 0u; i < 4u; ++i) {
+		g_se_gl_soft.color_mask[i] = true;
+	}
+	g_se_gl_soft.stencil_mask = 0xFFFFFFFFu;
+	g_se_gl_soft.cull_mode = GL_BACK;
+	g_se_gl_soft.front_face = GL_CCW;
+	g_se_gl_soft.clear_depth = 1.0f;
+	g_se_gl_soft.pack_alignment = 4;
+	g_se_gl_soft.unpack_alignment = 4;
+	g_se_gl_soft.error = GL_NO_ERROR;
+}
+
+b8 se_gl_soft_init(void) {
+	if (g_se_gl_soft.initialized) {
+		return true;
+	}
+	memset(&g_se_gl_soft, 0, sizeof(g_se_gl_soft));
+	se_gl_soft_reset_state();
+
+	const u32 threads = se_gl_soft_thread_count();
+	if (threads > 1u) {
+		se_worker_config worker_config = SE_WORKER_CONFIG_DEFAULTS;
+		worker_config.thread_count = threads;
+		g_se_gl_soft.workers = se_worker_create(&worker_config);
+		if (!g_se_gl_soft.workers) {
+			se_log("se_gl_soft_init :: worker pool unavailable, rasterizing on the calling thread");
+		}
+	}
+	se_soft_raster_config raster_config = SE_SOFT_RASTER_CONFIG_DEFAULTS;
+	raster_config.workers = g_se_gl_soft.workers;
+	g_se_gl_soft.raster = se_soft_raster_create(&raster_config);
+	if (!g_se_gl_soft.raster) {
+		se_worker_destroy(g_se_gl_soft.workers);
+		g_se_gl_soft.workers = NULL;
+		return false;
+	}
+	g_se_gl_soft.initialized = true;
+
+	se_glDeleteBuffers = se_gl_soft_delete_buffers;
+	se_glGenBuffers = se_gl_soft_gen_buffers;
+	se_glBindBuffer = se_gl_soft_bind_buffer;
+	se_glBufferSubData = se_gl_soft_buffer_sub_data;
+	se_glBufferData = se_gl_soft_buffer_data;
+	se_glUseProgram = se_gl_soft_use_program;
+	se_glCreateShader = se_gl_soft_create_shader;
+	se_glShaderSource = se_gl_soft_shader_source;
+	se_glCompileShader = se_gl_soft_compile_shader;
+	se_glCreateProgram = se_gl_soft_create_program;
+	se_glLinkProgram = se_gl_soft_link_program;
+	se_glAttachShader = se_gl_soft_attach_shader;
+	se_glDeleteProgram = se_gl_soft_delete_program;
+	se_glDeleteShader = se_gl_soft_delete_shader;
+	se_glGenRenderbuffers = se_gl_soft_gen_renderbuffers;
+	se_glBindFramebuffer = se_gl_soft_bind_framebuffer;
+	se_glFramebufferRenderbuffer = se_gl_soft_framebuffer_renderbuffer;
+	se_glFramebufferTexture = se_gl_soft_framebuffer_texture;
+	se_glBindVertexArray = se_gl_soft_bind_vertex_array;
+	se_glGenVertexArrays = se_gl_soft_gen_vertex_arrays;
+	se_glDeleteVertexArrays = se_gl_soft_delete_vertex_arrays;
+	se_glTexImage3D = se_gl_soft_tex_image_3d;
+	se_glVertexAttribPointer = se_gl_soft_vertex_attrib_pointer;
+	se_glEnableVertexAttribArray = se_gl_soft_enable_vertex_attrib_array;
+	se_glDisableVertexAttribArray = se_gl_soft_disable_vertex_attrib_array;
+	se_glVertexAttribDivisor = se_gl_soft_vertex_attrib_divisor;
+	se_glDrawArraysInstanced = se_gl_soft_draw_arrays_instanced;
+	se_glGenFramebuffers = se_gl_soft_gen_framebuffers;
+	se_glFramebufferTexture2D = se_gl_soft_framebuffer_texture2d;
+	se_glGetShaderiv = se_gl_soft_get_shader_iv;
+	se_glGetShaderInfoLog = se_gl_soft_get_shader_info_log;
+	se_glGetProgramiv = se_gl_soft_get_program_iv;
+	se_glGetProgramInfoLog = se_gl_soft_get_program_info_log;
+	se_glDrawElementsInstanced = se_gl_soft_draw_elements_instanced;
+	se_glMapBuffer = se_gl_soft_map_buffer;
+	se_glUnmapBuffer = se_gl_soft_unmap_buffer;
+	se_glGetUniformLocation = se_gl_soft_get_uniform_location;
+	se_glUniform1i = se_gl_soft_uniform1i;
+	se_glUniform1f = se_gl_soft_uniform1f;
+	se_glUniform1fv = se_gl_soft_uniform1fv;
+	se_glUniform2fv = se_gl_soft_uniform2fv;
+	se_glUniform3fv = se_gl_soft_uniform3fv;
+	se_glUniform4fv = se_gl_soft_uniform4fv;
+	se_glUniform1iv = se_gl_soft_uniform1iv;
+	se_glUniform2iv = se_gl_soft_uniform2iv;
+	se_glUniform3iv = se_gl_soft_uniform3iv;
+	se_glUniform4iv = se_gl_soft_uniform4iv;
+	se_glUniformMatrix3fv = se_gl_soft_uniform_matrix3fv;
+	se_glUniformMatrix4fv = se_gl_soft_uniform_matrix4fv;
+	se_glBindRenderbuffer = se_gl_soft_bind_renderbuffer;
+	se_glDeleteRenderbuffers = se_gl_soft_delete_renderbuffers;
+	se_glDeleteFramebuffers = se_gl_soft_delete_framebuffers;
+	se_glRenderbufferStorage = se_gl_soft_renderbuffer_storage;
+	se_glCheckFramebufferStatus = se_gl_soft_check_framebuffer_status;
+	se_glGenerateMipmap = se_gl_soft_generate_mipmap;
+	se_glBlitFramebuffer = se_gl_soft_blit_framebuffer;
+	se_glReadBuffer = se_gl_soft_read_buffer;
+	// Persistent mapping, fences and indirect draws stay unavailable; callers test for NULL.
+	se_glBufferStorage = NULL;
+	se_glMapBufferRange = NULL;
+	se_glFenceSync = NULL;
+	se_glClientWaitSync = NULL;
+	se_glDeleteSync = NULL;
+	se_glMultiDrawElementsIndirect = NULL;
+	se_glCopyBufferSubData = se_gl_soft_copy_buffer_sub_data;
+	se_glDrawElementsInstancedBaseVertex = se_gl_soft_draw_elements_instanced_base_vertex;
+	return true;
+}
+
+static void se_gl_soft_table_free(se_gl_soft_table* table) {
+	free(table->items);
+	memset(table, 0, sizeof(*table));
+}
+
+void se_gl_soft_shutdown(void) {
+	if (!g_se_gl_soft.initialized) {
+		return;
+	}
+	se_gl_soft_release_targets();
+	for (u32 i = 0u; i < g_se_gl_soft.programs.capacity; ++i) {
+		if (g_se_gl_soft.programs.items[i]) {
+			se_gl_soft_program_free(i + 1u);
+		}
+	}
+	for (u32 i = 0u; i < g_se_gl_soft.shaders.capacity; ++i) {
+		se_gl_soft_shader_free(g_se_gl_soft.shaders.items[i]);
+	}
+	for (u32 i = 0u; i < g_se_gl_soft.buffers.capacity; ++i) {
+		se_gl_soft_buffer* buffer = g_se_gl_soft.buffers.items[i];
+		if (buffer) {
+			free(buffer->data);
+			free(buffer);
+		}
+	}
+	for (u32 i = 0u; i < g_se_gl_soft.textures.capacity; ++i) {
+		se_gl_soft_texture* texture = g_se_gl_soft.textures.items[i];
+		if (texture) {
+			se_soft_image_free(&texture->image);
+			free(texture);
+		}
+	}
+	for (u32 i = 0u; i < g_se_gl_soft.renderbuffers.capacity; ++i) {
+		se_gl_soft_renderbuffer* renderbuffer = g_se_gl_soft.renderbuffers.items[i];
+		if (renderbuffer) {
+			se_soft_image_free(&renderbuffer->image);
+			free(renderbuffer);
+		}
+	}
+	for (u32 i = 0u; i < g_se_gl_soft.vertex_arrays.capacity; ++i) {
+		free(g_se_gl_soft.vertex_arrays.items[i]);
+	}
+	for (u32 i = 0u; i < g_se_gl_soft.framebuffers.capacity; ++i) {
+		free(g_se_gl_soft.framebuffers.items[i]);
+	}
+	se_gl_soft_table_free(&g_se_gl_soft.buffers);
+	se_gl_soft_table_free(&g_se_gl_soft.vertex_arrays);
+	se_gl_soft_table_free(&g_se_gl_soft.textures);
+	se_gl_soft_table_free(&g_se_gl_soft.renderbuffers);
+	se_gl_soft_table_free(&g_se_gl_soft.framebuffers);
+	se_gl_soft_table_free(&g_se_gl_soft.shaders);
+	se_gl_soft_table_free(&g_se_gl_soft.programs);
+	se_soft_image_free(&g_se_gl_soft.surface_color);
+	se_soft_image_free(&g_se_gl_soft.surface_depth);
+	se_soft_raster_destroy(g_se_gl_soft.raster);
+	se_worker_destroy(g_se_gl_soft.workers);
+	free(g_se_gl_soft.elements);
+	free(g_se_gl_soft.vertices);
+	free(g_se_gl_soft.triangles);
+	free(g_se_gl_soft.indices);
+	free(g_se_gl_soft.shaded);
+	memset(&g_se_gl_soft, 0, sizeof(g_se_gl_soft));
+	se_gl_soft_reset_state();
+}
+
+b8 se_gl_soft_set_surface_size(const u32 width, const u32 height) {
+	if (!g_se_gl_soft.initialized || width == 0u || height == 0u) {
+		se_set_last_error(SE_RESULT_INVALID_ARGUMENT);
+		return false;
+	}
+	const b8 first = g_se_gl_soft.surface_color.texels == NULL;
+	if (!first && g_se_gl_soft.surface_color.width == width && g_se_gl_soft.surface_color.height == height) {
+		se_set_last_error(SE_RESULT_OK);
+		return true;
+	}
+	se_gl_soft_release_targets();
+	if (!se_soft_image_alloc(&g_se_gl_soft.surface_color, width, height, 1u, SE_SOFT_FORMAT_RGBA8) ||
+		!se_soft_image_alloc(&g_se_gl_soft.surface_depth, width, height, 1u, SE_SOFT_FORMAT_DEPTH32F)) {
+		return false;
+	}
+	if (first) {
+		g_se_gl_soft.viewport[0] = 0;
+		g_se_gl_soft.viewport[1] = 0;
+		g_se_gl_soft.viewport[2] = (i32)width;
+		g_se_gl_soft.viewport[3] = (i32)height;
+	}
+	se_set_last_error(SE_RESULT_OK);
+	return true;
+}
+
+const u8* se_gl_soft_surface_pixels(u32* out_width, u32* out_height) {
+	se_gl_soft_flush();
+	if (out_width) {
+		*out_width = g_se_gl_soft.surface_color.width;
+	}
+	if (out_height) {
+		*out_height = g_se_gl_soft.surface_color.height;
+	}
+	return g_se_gl_soft.surface_color.texels;
+}
+
+#endif // SE_RENDER_BACKEND_SOFTWARE
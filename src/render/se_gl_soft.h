@@ -0,0 +1,21 @@
+// Syphax-Engine - Ougi Washi
+
+#ifndef SE_GL_SOFT_H
+#define SE_GL_SOFT_H
+
+#include "syphax/s_types.h"
+
+// GL 3.3 context implemented on the CPU by se_soft_raster and se_soft_glsl. se_init_opengl
+// points the se_gl function table at it; the GL 1.x entry points the engine calls directly are
+// defined by this backend too, so nothing links against a driver.
+extern b8 se_gl_soft_init(void);
+extern void se_gl_soft_shutdown(void);
+
+// Sizes the default framebuffer (RGBA8 colour plus depth). The first call also sets the viewport,
+// as making a context current does.
+extern b8 se_gl_soft_set_surface_size(u32 width, u32 height);
+// Finishes pending draws and returns the default framebuffer as RGBA8 rows, bottom row first.
+// Valid until the next GL call; NULL before the surface is sized.
+extern const u8* se_gl_soft_surface_pixels(u32* out_width, u32* out_height);
+
+#endif // SE_GL_SOFT_H
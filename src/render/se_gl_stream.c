@@ -0,0 +1,372 @@
+// Syphax-Engine - Ougi Washi
+
+#include "render/se_gl_stream.h"
+
+#include "render/se_render_queue.h"
+#include "se_graphics.h"
+#include "syphax/s_thread.h"
+
+#include <string.h>
+
+#ifndef GL_MAP_PERSISTENT_BIT
+#define GL_MAP_PERSISTENT_BIT 0x0040
+#endif
+#ifndef GL_MAP_COHERENT_BIT
+#define GL_MAP_COHERENT_BIT 0x0080
+#endif
+
+#define SE_GL_STREAM_CAPACITY_BYTES (8ull * 1024ull * 1024ull)
+#define SE_GL_STREAM_WAIT_TIMEOUT_NS 100000000ull
+
+typedef struct {
+	se_gl_stream_ring ring;
+	s_mutex mutex;
+	GLsync fences[SE_GL_STREAM_MAX_FRAMES];
+	b8 fence_ready[SE_GL_STREAM_MAX_FRAMES];
+	u8* mapped;
+	GLuint buffer;
+	u64 generation;
+	b8 mutex_ready;
+	b8 created;
+	b8 failed;
+	b8 persistent;
+	se_gl_stream_stats stats;
+} se_gl_stream;
+
+typedef struct {
+	u32 slot;
+} se_gl_stream_fence_payload;
+
+static se_gl_stream g_se_gl_stream = {0};
+
+void se_gl_stream_ring_init(se_gl_stream_ring* ring, const u64 capacity) {
+	if (!ring) {
+		return;
+	}
+	memset(ring, 0, sizeof(*ring));
+	ring->capacity = capacity;
+}
+
+se_gl_stream_alloc_result se_gl_stream_ring_alloc(se_gl_stream_ring* ring, const u64 size, const u64 alignment, u64* out_offset) {
+	if (!ring || !out_offset || size == 0u || size > ring->capacity) {
+		return SE_GL_STREAM_ALLOC_OVERFLOW;
+	}
+	const u64 align = alignment > 0u ? alignment : 1u;
+	u64 position = ((ring->head + align - 1u) / align) * align;
+	if ((position % ring->capacity) + size > ring->capacity) {
+		// Allocations never straddle the end of the buffer; the tail is skipped.
+		position = (position / ring->capacity + 1u) * ring->capacity;
+	}
+	if (position + size > ring->retired + ring->capacity) {
+		return ring->frame_count > 0u ? SE_GL_STREAM_ALLOC_WAIT : SE_GL_STREAM_ALLOC_OVERFLOW;
+	}
+	ring->head = position + size;
+	*out_offset = position % ring->capacity;
+	return SE_GL_STREAM_ALLOC_OK;
+}
+
+b8 se_gl_stream_ring_end_frame(se_gl_stream_ring* ring, u32* out_slot) {
+	if (!ring || ring->head == ring->fenced || ring->frame_count >= SE_GL_STREAM_MAX_FRAMES) {
+		return false;
+	}
+	const u32 slot = (ring->frame_first + ring->frame_count) % SE_GL_STREAM_MAX_FRAMES;
+	ring->frame_end[slot] = ring->head;
+	ring->frame_count++;
+	ring->fenced = ring->head;
+	if (out_slot) {
+		*out_slot = slot;
+	}
+	return true;
+}
+
+b8 se_gl_stream_ring_retire_oldest(se_gl_stream_ring* ring, u32* out_slot) {
+	if (!ring || ring->frame_count == 0u) {
+		return false;
+	}
+	const u32 slot = ring->frame_first;
+	ring->retired = ring->frame_end[slot];
+	ring->frame_first = (slot + 1u) % SE_GL_STREAM_MAX_FRAMES;
+	ring->frame_count--;
+	if (out_slot) {
+		*out_slot = slot;
+	}
+	return true;
+}
+
+static b8 se_gl_stream_run(const se_render_queue_sync_fn fn, const void* payload, const u32 payload_bytes, const b8 wait) {
+	if (!se_render_queue_is_running() || se_render_queue_is_render_thread()) {
+		fn(payload, NULL);
+		return true;
+	}
+	if (!wait && se_render_queue_record_async(fn, payload, payload_bytes)) {
+		return true;
+	}
+	return se_render_queue_call_sync_sized(fn, payload, NULL, payload_bytes);
+}
+
+static b8 se_gl_stream_supports_persistent(void) {
+	if (!se_glBufferStorage || !se_glMapBufferRange || !se_glFenceSync || !se_glClientWaitSync || !se_glDeleteSync) {
+		return false;
+	}
+#if defined(SE_RENDER_BACKEND_GLES)
+	const c8* extensions = (const c8*)glGetString(GL_EXTENSIONS);
+	return extensions && strstr(extensions, "GL_EXT_buffer_storage") != NULL;
+#else
+	GLint major = 0;
+	GLint minor = 0;
+	glGetIntegerv(GL_MAJOR_VERSION, &major);
+	glGetIntegerv(GL_MINOR_VERSION, &minor);
+	return major > 4 || (major == 4 && minor >= 4);
+#endif
+}
+
+static void se_gl_stream_release_oldest_locked(se_gl_stream* stream) {
+	u32 slot = 0u;
+	if (!se_gl_stream_ring_retire_oldest(&stream->ring, &slot)) {
+		return;
+	}
+	if (stream->fences[slot]) {
+		se_glDeleteSync(stream->fences[slot]);
+		stream->fences[slot] = NULL;
+	}
+	stream->fence_ready[slot] = false;
+}
+
+static void se_gl_stream_exec_create(const void* payload, void* out_result) {
+	(void)payload;
+	(void)out_result;
+	se_gl_stream* stream = &g_se_gl_stream;
+	// The ring belongs to the live queue; a replay must not swap its buffer out.
+	if (se_render_queue_is_replaying()) {
+		return;
+	}
+	const GLsizeiptr capacity = (GLsizeiptr)SE_GL_STREAM_CAPACITY_BYTES;
+	GLuint buffer = 0u;
+	glGenBuffers(1, &buffer);
+	glBindBuffer(GL_ARRAY_BUFFER, buffer);
+	stream->mapped = NULL;
+	if (se_gl_stream_supports_persistent()) {
+		const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+		se_glBufferStorage(GL_ARRAY_BUFFER, capacity, NULL, flags);
+		stream->mapped = (u8*)se_glMapBufferRange(GL_ARRAY_BUFFER, 0, capacity, flags);
+		if (!stream->mapped) {
+			// Immutable storage cannot be respecified, so the fallback needs a fresh name.
+			glDeleteBuffers(1, &buffer);
+			glGenBuffers(1, &buffer);
+			glBindBuffer(GL_ARRAY_BUFFER, buffer);
+		}
+	}
+	if (!stream->mapped) {
+		glBufferData(GL_ARRAY_BUFFER, capacity, NULL, GL_STREAM_DRAW);
+	}
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+	stream->buffer = buffer;
+	stream->persistent = stream->mapped != NULL;
+}
+
+static void se_gl_stream_exec_fence(const void* payload, void* out_result) {
+	(void)out_result;
+	const se_gl_stream_fence_payload* args = (const se_gl_stream_fence_payload*)payload;
+	se_gl_stream* stream = &g_se_gl_stream;
+	// Replayed slots belong to the recording process; the fence still costs what it did.
+	if (se_render_queue_is_replaying() || !stream->created || args->slot >= SE_GL_STREAM_MAX_FRAMES) {
+		if (se_glFenceSync && se_glDeleteSync) {
+			se_glDeleteSync(se_glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0));
+		}
+		return;
+	}
+	const GLsync fence = se_glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+	s_mutex_lock(&stream->mutex);
+	stream->fences[args->slot] = fence;
+	stream->fence_ready[args->slot] = true;
+	while (stream->ring.frame_count > 0u) {
+		const u32 oldest = stream->ring.frame_first;
+		if (!stream->fence_ready[oldest]) {
+			break;
+		}
+		if (stream->fences[oldest]) {
+			const GLenum status = se_glClientWaitSync(stream->fences[oldest], 0, 0);
+			if (status != GL_ALREADY_SIGNALED && status != GL_CONDITION_SATISFIED) {
+				break;
+			}
+		}
+		se_gl_stream_release_oldest_locked(stream);
+	}
+	s_mutex_unlock(&stream->mutex);
+}
+
+static void se_gl_stream_exec_wait(const void* payload, void* out_result) {
+	(void)payload;
+	(void)out_result;
+	se_gl_stream* stream = &g_se_gl_stream;
+	if (se_render_queue_is_replaying() || !stream->created) {
+		return;
+	}
+	s_mutex_lock(&stream->mutex);
+	if (stream->ring.frame_count > 0u) {
+		const GLsync fence = stream->fences[stream->ring.frame_first];
+		GLbitfield flags = GL_SYNC_FLUSH_COMMANDS_BIT;
+		while (fence) {
+			const GLenum status = se_glClientWaitSync(fence, flags, SE_GL_STREAM_WAIT_TIMEOUT_NS);
+			if (status != GL_TIMEOUT_EXPIRED) {
+				break;
+			}
+			flags = 0;
+		}
+		se_gl_stream_release_oldest_locked(stream);
+	}
+	s_mutex_unlock(&stream->mutex);
+}
+
+static const se_render_queue_command_info g_se_gl_stream_commands[] = {
+	{se_gl_stream_exec_create, "se_gl_stream_exec_create", SE_RENDER_THREAD_COMMAND_RESOURCE, 0u},
+	{se_gl_stream_exec_fence, "se_gl_stream_exec_fence", SE_RENDER_THREAD_COMMAND_UPLOAD, (u32)sizeof(se_gl_stream_fence_payload)},
+	{se_gl_stream_exec_wait, "se_gl_stream_exec_wait", SE_RENDER_THREAD_COMMAND_UPLOAD, 0u}
+};
+
+const se_render_queue_command_info* se_gl_stream_get_commands(u32* out_count) {
+	if (out_count) {
+		*out_count = (u32)(sizeof(g_se_gl_stream_commands) / sizeof(g_se_gl_stream_commands[0]));
+	}
+	return g_se_gl_stream_commands;
+}
+
+static b8 se_gl_stream_prepare(se_gl_stream* stream) {
+	if (!stream->mutex_ready) {
+		if (!s_mutex_init(&stream->mutex)) {
+			return false;
+		}
+		stream->mutex_ready = true;
+	}
+	const u64 generation = se_render_get_generation();
+	if ((stream->created || stream->failed) && stream->generation == generation) {
+		return stream->created;
+	}
+	// A new render generation means the previous context took the buffer and fences with it.
+	stream->created = false;
+	stream->failed = false;
+	stream->persistent = false;
+	stream->mapped = NULL;
+	stream->buffer = 0u;
+	memset(stream->fences, 0, sizeof(stream->fences));
+	memset(stream->fence_ready, 0, sizeof(stream->fence_ready));
+	se_gl_stream_ring_init(&stream->ring, SE_GL_STREAM_CAPACITY_BYTES);
+	if (!se_render_has_context()) {
+		return false;
+	}
+	stream->generation = generation;
+	if (!se_gl_stream_run(se_gl_stream_exec_create, NULL, 0u, true) || stream->buffer == 0u) {
+		stream->failed = true;
+		return false;
+	}
+	stream->created = true;
+	stream->stats.capacity_bytes = SE_GL_STREAM_CAPACITY_BYTES;
+	stream->stats.persistent = stream->persistent;
+	return true;
+}
+
+void* se_gl_stream_map(const GLsizeiptr size, const GLsizeiptr alignment, GLintptr* out_offset) {
+	if (size <= 0 || !out_offset || se_render_queue_is_recording_secondary()) {
+		return NULL;
+	}
+	se_gl_stream* stream = &g_se_gl_stream;
+	if (!se_gl_stream_prepare(stream)) {
+		return NULL;
+	}
+
+	u64 offset = 0u;
+	s_mutex_lock(&stream->mutex);
+	se_gl_stream_alloc_result result = se_gl_stream_ring_alloc(&stream->ring, (u64)size, (u64)alignment, &offset);
+	if (!stream->persistent && result != SE_GL_STREAM_ALLOC_OK) {
+		// Orphaning: the driver hands back fresh storage while queued draws keep the old one.
+		stream->stats.orphans++;
+		se_gl_stream_ring_init(&stream->ring, SE_GL_STREAM_CAPACITY_BYTES);
+		glBindBuffer(GL_ARRAY_BUFFER, stream->buffer);
+		glBufferData(GL_ARRAY_BUFFER, (GLsizeiptr)SE_GL_STREAM_CAPACITY_BYTES, NULL, GL_STREAM_DRAW);
+		result = se_gl_stream_ring_alloc(&stream->ring, (u64)size, (u64)alignment, &offset);
+	}
+	while (result == SE_GL_STREAM_ALLOC_WAIT) {
+		stream->stats.fence_waits++;
+		s_mutex_unlock(&stream->mutex);
+		const b8 waited = se_gl_stream_run(se_gl_stream_exec_wait, NULL, 0u, true);
+		s_mutex_lock(&stream->mutex);
+		if (!waited) {
+			result = SE_GL_STREAM_ALLOC_OVERFLOW;
+			break;
+		}
+		result = se_gl_stream_ring_alloc(&stream->ring, (u64)size, (u64)alignment, &offset);
+	}
+	if (result != SE_GL_STREAM_ALLOC_OK) {
+		stream->stats.overflows++;
+		s_mutex_unlock(&stream->mutex);
+		return NULL;
+	}
+	stream->stats.allocations++;
+	stream->stats.allocated_bytes += (u64)size;
+	s_mutex_unlock(&stream->mutex);
+
+	*out_offset = (GLintptr)offset;
+	if (stream->persistent) {
+		return stream->mapped + offset;
+	}
+	glBindBuffer(GL_ARRAY_BUFFER, stream->buffer);
+	return se_gl_buffer_sub_data_reserve(GL_ARRAY_BUFFER, (GLintptr)offset, size);
+}
+
+void se_gl_stream_commit(void* data) {
+	se_gl_stream* stream = &g_se_gl_stream;
+	if (!data || stream->persistent) {
+		// The mapping is coherent, so writes need no flush before the fenced draws.
+		return;
+	}
+	se_gl_buffer_upload_commit(data);
+}
+
+GLuint se_gl_stream_buffer(void) {
+	return g_se_gl_stream.buffer;
+}
+
+void se_gl_stream_end_frame(void) {
+	se_gl_stream* stream = &g_se_gl_stream;
+	if (!stream->created || !stream->persistent || se_render_queue_is_recording_secondary()) {
+		return;
+	}
+	// With the render thread running the recording side closes frames; a present on the render
+	// thread would fence commands that have not been issued yet.
+	if (se_render_queue_is_running() && se_render_queue_is_render_thread()) {
+		return;
+	}
+	if (stream->generation != se_render_get_generation()) {
+		return;
+	}
+	s_mutex_lock(&stream->mutex);
+	if (stream->ring.frame_count >= SE_GL_STREAM_MAX_FRAMES) {
+		stream->stats.fence_waits++;
+		s_mutex_unlock(&stream->mutex);
+		(void)se_gl_stream_run(se_gl_stream_exec_wait, NULL, 0u, true);
+		s_mutex_lock(&stream->mutex);
+	}
+	se_gl_stream_fence_payload payload = {0};
+	const b8 fenced = se_gl_stream_ring_end_frame(&stream->ring, &payload.slot);
+	if (fenced) {
+		stream->stats.frames_fenced++;
+	}
+	s_mutex_unlock(&stream->mutex);
+	if (fenced) {
+		(void)se_gl_stream_run(se_gl_stream_exec_fence, &payload, (u32)sizeof(payload), false);
+	}
+}
+
+void se_gl_stream_get_stats(se_gl_stream_stats* out_stats) {
+	if (!out_stats) {
+		return;
+	}
+	se_gl_stream* stream = &g_se_gl_stream;
+	if (!stream->mutex_ready) {
+		memset(out_stats, 0, sizeof(*out_stats));
+		return;
+	}
+	s_mutex_lock(&stream->mutex);
+	*out_stats = stream->stats;
+	s_mutex_unlock(&stream->mutex);
+}
@@ -0,0 +1,55 @@
+// Syphax-Engine - Ougi Washi
+
+#ifndef SE_GL_STREAM_H
+#define SE_GL_STREAM_H
+
+#include "render/se_gl.h"
+
+#define SE_GL_STREAM_MAX_FRAMES 8u
+
+// Positions only grow; the buffer offset is position % capacity. Everything below `retired`
+// has been consumed by the GPU, and each in-flight frame ends at frame_end[slot].
+typedef struct {
+	u64 capacity;
+	u64 head;
+	u64 retired;
+	u64 fenced;
+	u64 frame_end[SE_GL_STREAM_MAX_FRAMES];
+	u32 frame_first;
+	u32 frame_count;
+} se_gl_stream_ring;
+
+typedef enum {
+	SE_GL_STREAM_ALLOC_OK = 0,
+	SE_GL_STREAM_ALLOC_WAIT,
+	SE_GL_STREAM_ALLOC_OVERFLOW
+} se_gl_stream_alloc_result;
+
+typedef struct {
+	u64 capacity_bytes;
+	u64 allocations;
+	u64 allocated_bytes;
+	u64 frames_fenced;
+	u64 fence_waits;
+	u64 overflows;
+	u64 orphans;
+	b8 persistent;
+} se_gl_stream_stats;
+
+// Allocator bookkeeping with no GL calls. WAIT means the oldest in-flight frame has to retire
+// before the request fits; OVERFLOW means it cannot fit until the current frame is fenced.
+extern void se_gl_stream_ring_init(se_gl_stream_ring* ring, u64 capacity);
+extern se_gl_stream_alloc_result se_gl_stream_ring_alloc(se_gl_stream_ring* ring, u64 size, u64 alignment, u64* out_offset);
+extern b8 se_gl_stream_ring_end_frame(se_gl_stream_ring* ring, u32* out_slot);
+extern b8 se_gl_stream_ring_retire_oldest(se_gl_stream_ring* ring, u32* out_slot);
+
+// Per-frame streaming memory in one shared GL_ARRAY_BUFFER. The returned memory is written in
+// place and committed before the next map on the same thread; source it at the returned offset
+// of se_gl_stream_buffer(). NULL means the caller should upload through its own buffer.
+extern void* se_gl_stream_map(GLsizeiptr size, GLsizeiptr alignment, GLintptr* out_offset);
+extern void se_gl_stream_commit(void* data);
+extern GLuint se_gl_stream_buffer(void);
+extern void se_gl_stream_end_frame(void);
+extern void se_gl_stream_get_stats(se_gl_stream_stats* out_stats);
+
+#endif // SE_GL_STREAM_H
@@ -0,0 +1,424 @@
+// Syphax-Engine - Ougi Washi
+
+#include "render/se_render_capture.h"
+
+#include "render/se_gl.h"
+#include "se_graphics.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+
+#define SE_RENDER_CAPTURE_UNKNOWN_ID 0xFFFFFFFFu
+
+struct se_render_capture_writer {
+	FILE* file;
+	se_render_queue_sync_fn* ids;
+	u32 id_count;
+	u32 id_capacity;
+	b8 failed;
+};
+
+typedef struct {
+	se_render_queue_sync_fn fn;
+	u8* data;
+	u32 payload_bytes;
+	u32 type;
+	b8 rejected;
+} se_render_capture_replay_command;
+
+typedef struct {
+	const u8* data;
+	sz size;
+	sz cursor;
+} se_render_capture_reader;
+
+static f64 se_render_capture_now_seconds(void) {
+#if defined(_WIN32)
+	static LARGE_INTEGER frequency = {0};
+	if (frequency.QuadPart == 0) {
+		QueryPerformanceFrequency(&frequency);
+	}
+	LARGE_INTEGER value = {0};
+	QueryPerformanceCounter(&value);
+	if (frequency.QuadPart <= 0) {
+		return 0.0;
+	}
+	return (f64)value.QuadPart / (f64)frequency.QuadPart;
+#else
+	struct timespec ts = {0};
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (f64)ts.tv_sec + (f64)ts.tv_nsec / 1000000000.0;
+#endif
+}
+
+static const c8* se_render_capture_command_name(const se_render_queue_sync_fn fn) {
+	const se_render_queue_command_info* info = se_render_queue_command_info_for(fn);
+	return info ? info->name : "unknown";
+}
+
+static void se_render_capture_write(se_render_capture_writer* writer, const void* data, const sz size) {
+	if (writer->failed || size == 0u) {
+		return;
+	}
+	if (fwrite(data, 1, size, writer->file) != size) {
+		writer->failed = true;
+	}
+}
+
+static void se_render_capture_write_u32(se_render_capture_writer* writer, const u32 value) {
+	se_render_capture_write(writer, &value, sizeof(value));
+}
+
+static u32 se_render_capture_command_id(se_render_capture_writer* writer, const se_render_queue_sync_fn fn) {
+	for (u32 i = 0u; i < writer->id_count; ++i) {
+		if (writer->ids[i] == fn) {
+			return i;
+		}
+	}
+	if (writer->id_count >= SE_RENDER_THREAD_CAPTURE_MAX_COMMAND_TYPES) {
+		return SE_RENDER_CAPTURE_UNKNOWN_ID;
+	}
+	if (writer->id_count == writer->id_capacity) {
+		const u32 capacity = writer->id_capacity == 0u ? 32u : writer->id_capacity * 2u;
+		se_render_queue_sync_fn* ids = (se_render_queue_sync_fn*)realloc(writer->ids, sizeof(*ids) * (sz)capacity);
+		if (!ids) {
+			writer->failed = true;
+			return SE_RENDER_CAPTURE_UNKNOWN_ID;
+		}
+		writer->ids = ids;
+		writer->id_capacity = capacity;
+	}
+	const u32 id = writer->id_count++;
+	writer->ids[id] = fn;
+	const c8* name = se_render_capture_command_name(fn);
+	const u32 name_length = (u32)strlen(name);
+	se_render_capture_write_u32(writer, SE_RENDER_CAPTURE_RECORD_NAME);
+	se_render_capture_write_u32(writer, id);
+	se_render_capture_write_u32(writer, name_length);
+	se_render_capture_write(writer, name, name_length);
+	return id;
+}
+
+se_render_capture_writer* se_render_capture_open(const char* path) {
+	if (!path) {
+		se_set_last_error(SE_RESULT_INVALID_ARGUMENT);
+		return NULL;
+	}
+	se_render_capture_writer* writer = (se_render_capture_writer*)calloc(1u, sizeof(*writer));
+	if (!writer) {
+		se_set_last_error(SE_RESULT_OUT_OF_MEMORY);
+		return NULL;
+	}
+	writer->file = fopen(path, "wb");
+	if (!writer->file) {
+		free(writer);
+		se_set_last_error(SE_RESULT_IO);
+		return NULL;
+	}
+	se_render_capture_write(writer, SE_RENDER_CAPTURE_MAGIC, 8u);
+	se_render_capture_write_u32(writer, SE_RENDER_CAPTURE_VERSION);
+	se_render_capture_write_u32(writer, (u32)sizeof(void*));
+	if (writer->failed) {
+		se_render_capture_close(writer);
+		se_set_last_error(SE_RESULT_IO);
+		return NULL;
+	}
+	se_set_last_error(SE_RESULT_OK);
+	return writer;
+}
+
+void se_render_capture_close(se_render_capture_writer* writer) {
+	if (!writer) {
+		return;
+	}
+	if (writer->file) {
+		fclose(writer->file);
+	}
+	free(writer->ids);
+	free(writer);
+}
+
+b8 se_render_capture_write_frame_begin(se_render_capture_writer* writer, const u64 frame) {
+	if (!writer) {
+		return false;
+	}
+	se_render_capture_write_u32(writer, SE_RENDER_CAPTURE_RECORD_FRAME_BEGIN);
+	se_render_capture_write(writer, &frame, sizeof(frame));
+	return !writer->failed;
+}
+
+b8 se_render_capture_write_command(se_render_capture_writer* writer,
+	const se_render_queue_sync_fn fn,
+	const void* payload,
+	const u32 payload_bytes,
+	const u32 pointer_patch_offset,
+	const void* blob,
+	const u32 blob_bytes) {
+	if (!writer || !fn) {
+		return false;
+	}
+	const u32 id = se_render_capture_command_id(writer, fn);
+	const u32 stored_blob_bytes = blob ? blob_bytes : 0u;
+	se_render_capture_write_u32(writer, SE_RENDER_CAPTURE_RECORD_COMMAND);
+	se_render_capture_write_u32(writer, id);
+	se_render_capture_write_u32(writer, payload_bytes);
+	se_render_capture_write_u32(writer, pointer_patch_offset);
+	se_render_capture_write_u32(writer, stored_blob_bytes);
+	se_render_capture_write(writer, payload, payload_bytes);
+	se_render_capture_write(writer, blob, stored_blob_bytes);
+	return !writer->failed;
+}
+
+b8 se_render_capture_write_frame_end(se_render_capture_writer* writer, const f64 execute_ms) {
+	if (!writer) {
+		return false;
+	}
+	se_render_capture_write_u32(writer, SE_RENDER_CAPTURE_RECORD_FRAME_END);
+	se_render_capture_write(writer, &execute_ms, sizeof(execute_ms));
+	if (!writer->failed && fflush(writer->file) != 0) {
+		writer->failed = true;
+	}
+	return !writer->failed;
+}
+
+static b8 se_render_capture_read(se_render_capture_reader* reader, void* out_data, const sz size) {
+	if (reader->cursor + size > reader->size) {
+		return false;
+	}
+	memcpy(out_data, reader->data + reader->cursor, size);
+	reader->cursor += size;
+	return true;
+}
+
+static b8 se_render_capture_read_u32(se_render_capture_reader* reader, u32* out_value) {
+	return se_render_capture_read(reader, out_value, sizeof(*out_value));
+}
+
+static u8* se_render_capture_load_file(const char* path, sz* out_size) {
+	FILE* file = fopen(path, "rb");
+	if (!file) {
+		se_set_last_error(SE_RESULT_IO);
+		return NULL;
+	}
+	if (fseek(file, 0, SEEK_END) != 0) {
+		fclose(file);
+		se_set_last_error(SE_RESULT_IO);
+		return NULL;
+	}
+	const long file_size = ftell(file);
+	if (file_size <= 0 || fseek(file, 0, SEEK_SET) != 0) {
+		fclose(file);
+		se_set_last_error(SE_RESULT_IO);
+		return NULL;
+	}
+	u8* bytes = (u8*)malloc((sz)file_size);
+	if (!bytes) {
+		fclose(file);
+		se_set_last_error(SE_RESULT_OUT_OF_MEMORY);
+		return NULL;
+	}
+	const sz read_size = fread(bytes, 1, (sz)file_size, file);
+	fclose(file);
+	if (read_size != (sz)file_size) {
+		free(bytes);
+		se_set_last_error(SE_RESULT_IO);
+		return NULL;
+	}
+	*out_size = (sz)file_size;
+	return bytes;
+}
+
+static void se_render_capture_free_commands(se_render_capture_replay_command* commands, const u64 count) {
+	if (!commands) {
+		return;
+	}
+	for (u64 i = 0u; i < count; ++i) {
+		free(commands[i].data);
+	}
+	free(commands);
+}
+
+// Parses every record into standalone commands whose blob pointers point at their own copy.
+static b8 se_render_capture_parse(se_render_capture_reader* reader,
+	se_render_thread_capture_report* report,
+	se_render_capture_replay_command** out_commands,
+	u64* out_command_count) {
+	c8 magic[8] = {0};
+	u32 version = 0u;
+	u32 pointer_size = 0u;
+	if (!se_render_capture_read(reader, magic, sizeof(magic)) ||
+		memcmp(magic, SE_RENDER_CAPTURE_MAGIC, sizeof(magic)) != 0 ||
+		!se_render_capture_read_u32(reader, &version) ||
+		!se_render_capture_read_u32(reader, &pointer_size)) {
+		se_set_last_error(SE_RESULT_IO);
+		return false;
+	}
+	if (version != SE_RENDER_CAPTURE_VERSION || pointer_size != (u32)sizeof(void*)) {
+		se_set_last_error(SE_RESULT_UNSUPPORTED);
+		return false;
+	}
+
+	const se_render_queue_command_info* infos[SE_RENDER_THREAD_CAPTURE_MAX_COMMAND_TYPES] = {0};
+	se_render_capture_replay_command* commands = NULL;
+	u64 command_count = 0u;
+	u64 command_capacity = 0u;
+	while (reader->cursor < reader->size) {
+		u32 tag = 0u;
+		if (!se_render_capture_read_u32(reader, &tag)) {
+			break;
+		}
+		b8 ok = true;
+		if (tag == SE_RENDER_CAPTURE_RECORD_NAME) {
+			u32 id = 0u;
+			u32 name_length = 0u;
+			c8 name[SE_MAX_NAME_LENGTH] = {0};
+			ok = se_render_capture_read_u32(reader, &id) &&
+				se_render_capture_read_u32(reader, &name_length) &&
+				id < SE_RENDER_THREAD_CAPTURE_MAX_COMMAND_TYPES &&
+				name_length < sizeof(name) &&
+				se_render_capture_read(reader, name, name_length);
+			if (ok) {
+				infos[id] = se_render_queue_command_info_named(name);
+				memcpy(report->command_types[id].name, name, name_length + 1u);
+				if (id >= report->command_type_count) {
+					report->command_type_count = id + 1u;
+				}
+			}
+		} else if (tag == SE_RENDER_CAPTURE_RECORD_FRAME_BEGIN) {
+			u64 frame = 0u;
+			ok = se_render_capture_read(reader, &frame, sizeof(frame));
+			report->frame_count += ok ? 1u : 0u;
+		} else if (tag == SE_RENDER_CAPTURE_RECORD_FRAME_END) {
+			f64 execute_ms = 0.0;
+			ok = se_render_capture_read(reader, &execute_ms, sizeof(execute_ms));
+			report->captured_execute_ms += ok ? execute_ms : 0.0;
+		} else if (tag == SE_RENDER_CAPTURE_RECORD_COMMAND) {
+			u32 header[4] = {0};
+			ok = se_render_capture_read(reader, header, sizeof(header));
+			const u32 id = header[0];
+			const u32 payload_bytes = header[1];
+			const u32 patch_offset = header[2];
+			const u32 blob_bytes = header[3];
+			const se_render_queue_command_info* info = ok && id < SE_RENDER_THREAD_CAPTURE_MAX_COMMAND_TYPES ? infos[id] : NULL;
+			ok = ok && (sz)payload_bytes + (sz)blob_bytes <= reader->size - reader->cursor &&
+				(patch_offset == SE_RENDER_QUEUE_POINTER_PATCH_NONE || (sz)patch_offset + sizeof(void*) <= payload_bytes);
+			// Replay hands the payload to the command as its struct, so it must be at least that big.
+			ok = ok && (!info || payload_bytes >= info->payload_bytes);
+			if (ok && command_count == command_capacity) {
+				const u64 capacity = command_capacity == 0u ? 256u : command_capacity * 2u;
+				se_render_capture_replay_command* grown = (se_render_capture_replay_command*)realloc(commands, sizeof(*commands) * (sz)capacity);
+				ok = grown != NULL;
+				if (grown) {
+					commands = grown;
+					command_capacity = capacity;
+				}
+			}
+			u8* data = ok ? (u8*)malloc((sz)payload_bytes + (sz)blob_bytes + 1u) : NULL;
+			ok = ok && data != NULL;
+			if (ok) {
+				se_render_capture_read(reader, data, (sz)payload_bytes + (sz)blob_bytes);
+				if (patch_offset != SE_RENDER_QUEUE_POINTER_PATCH_NONE) {
+					// Without a blob the recorded pointer is an address in the capturing process.
+					void* blob = blob_bytes > 0u ? data + payload_bytes : NULL;
+					memcpy(data + patch_offset, &blob, sizeof(blob));
+				}
+				se_render_capture_replay_command* command = &commands[command_count++];
+				command->rejected = info && (info->flags & SE_RENDER_QUEUE_COMMAND_NO_REPLAY) != 0u;
+				command->fn = info && !command->rejected ? info->fn : NULL;
+				command->data = data;
+				command->payload_bytes = payload_bytes;
+				command->type = id;
+				if (id < SE_RENDER_THREAD_CAPTURE_MAX_COMMAND_TYPES) {
+					report->command_types[id].payload_bytes += payload_bytes;
+					report->command_types[id].blob_bytes += blob_bytes;
+				}
+				report->payload_bytes += payload_bytes;
+				report->blob_bytes += blob_bytes;
+			}
+		} else {
+			ok = false;
+		}
+		if (!ok) {
+			se_render_capture_free_commands(commands, command_count);
+			se_set_last_error(SE_RESULT_IO);
+			return false;
+		}
+	}
+	*out_commands = commands;
+	*out_command_count = command_count;
+	return true;
+}
+
+b8 se_render_capture_replay(const char* path, const u32 iterations, se_render_thread_capture_report* out_report) {
+	if (!path || !out_report) {
+		se_set_last_error(SE_RESULT_INVALID_ARGUMENT);
+		return false;
+	}
+	// The render thread would resolve proxies and run the stream ring alongside the replay.
+	if (se_render_queue_is_running()) {
+		se_set_last_error(SE_RESULT_UNSUPPORTED);
+		return false;
+	}
+	if (!se_render_init()) {
+		se_set_last_error(SE_RESULT_BACKEND_FAILURE);
+		return false;
+	}
+	sz size = 0u;
+	u8* bytes = se_render_capture_load_file(path, &size);
+	if (!bytes) {
+		return false;
+	}
+
+	memset(out_report, 0, sizeof(*out_report));
+	out_report->iterations = iterations > 0u ? iterations : 1u;
+	se_render_capture_reader reader = {bytes, size, 0u};
+	se_render_capture_replay_command* commands = NULL;
+	u64 command_count = 0u;
+	const b8 parsed = se_render_capture_parse(&reader, out_report, &commands, &command_count);
+	free(bytes);
+	if (!parsed) {
+		return false;
+	}
+
+	out_report->command_count = command_count;
+	if (!se_render_queue_replay_begin()) {
+		se_render_capture_free_commands(commands, command_count);
+		return false;
+	}
+	se_gl_state_cache_invalidate();
+	const f64 replay_begin = se_render_capture_now_seconds();
+	for (u32 iteration = 0u; iteration < out_report->iterations; ++iteration) {
+		for (u64 i = 0u; i < command_count; ++i) {
+			const se_render_capture_replay_command* command = &commands[i];
+			if (command->rejected) {
+				out_report->rejected_commands++;
+				continue;
+			}
+			if (!command->fn) {
+				out_report->skipped_commands++;
+				continue;
+			}
+			const f64 begin = se_render_capture_now_seconds();
+			command->fn(command->data, NULL);
+			const f64 elapsed_ms = (se_render_capture_now_seconds() - begin) * 1000.0;
+			se_render_thread_capture_command_stats* stats = &out_report->command_types[command->type];
+			stats->count++;
+			stats->total_ms += elapsed_ms;
+			if (elapsed_ms > stats->max_ms) {
+				stats->max_ms = elapsed_ms;
+			}
+		}
+	}
+	out_report->total_ms = (se_render_capture_now_seconds() - replay_begin) * 1000.0;
+	se_render_capture_free_commands(commands, command_count);
+	se_render_queue_replay_end();
+	se_gl_state_cache_invalidate();
+	se_set_last_error(SE_RESULT_OK);
+	return true;
+}
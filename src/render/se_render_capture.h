@@ -0,0 +1,36 @@
+// Syphax-Engine - Ougi Washi
+
+#ifndef SE_RENDER_CAPTURE_H
+#define SE_RENDER_CAPTURE_H
+
+#include "render/se_render_queue.h"
+
+// Capture files are a header followed by tagged records in native byte order; command ids
+// are defined per file by name records, so captures stay valid across builds and processes.
+#define SE_RENDER_CAPTURE_MAGIC "SERQCAP1"
+#define SE_RENDER_CAPTURE_VERSION 1u
+
+typedef enum {
+	SE_RENDER_CAPTURE_RECORD_NAME = 1,
+	SE_RENDER_CAPTURE_RECORD_FRAME_BEGIN = 2,
+	SE_RENDER_CAPTURE_RECORD_COMMAND = 3,
+	SE_RENDER_CAPTURE_RECORD_FRAME_END = 4
+} se_render_capture_record;
+
+typedef struct se_render_capture_writer se_render_capture_writer;
+
+extern se_render_capture_writer* se_render_capture_open(const char* path);
+extern void se_render_capture_close(se_render_capture_writer* writer);
+extern b8 se_render_capture_write_frame_begin(se_render_capture_writer* writer, u64 frame);
+extern b8 se_render_capture_write_command(se_render_capture_writer* writer,
+	se_render_queue_sync_fn fn,
+	const void* payload,
+	u32 payload_bytes,
+	u32 pointer_patch_offset,
+	const void* blob,
+	u32 blob_bytes);
+extern b8 se_render_capture_write_frame_end(se_render_capture_writer* writer, f64 execute_ms);
+
+extern b8 se_render_capture_replay(const char* path, u32 iterations, se_render_thread_capture_report* out_report);
+
+#endif // SE_RENDER_CAPTURE_H
@@ -2,11 +2,15 @@
 
 #include "render/se_render_queue.h"
 
+#include "render/se_gl.h"
+#include "render/se_render_capture.h"
+
 #include "se_debug.h"
 #include "se_graphics.h"
 #include "syphax/s_thread.h"
 #include "window/se_window_backend_internal.h"
 
+#include <stdint.h>
 #include <stdlib.h>
 #include <string.h>
 #if defined(_WIN32)
@@ -15,33 +19,98 @@
 #include <time.h>
 #endif
 
-#define SE_RENDER_QUEUE_PACKET_COUNT 2u
+#define SE_RENDER_QUEUE_DEFAULT_PACKET_COUNT 2u
 #define SE_RENDER_QUEUE_ALIGN_BYTES ((u32)sizeof(void*))
 #define SE_RENDER_QUEUE_DEFAULT_MAX_COMMANDS 4096u
 #define SE_RENDER_QUEUE_DEFAULT_MAX_COMMAND_BYTES (4u * 1024u * 1024u)
+#define SE_RENDER_QUEUE_DEFAULT_LARGE_BLOCK_THRESHOLD (64u * 1024u)
+#define SE_RENDER_QUEUE_DEFAULT_BLOCK_POOL_BYTES (32u * 1024u * 1024u)
+#define SE_RENDER_QUEUE_PROXY_CHUNK_SIZE 4096u
+#define SE_RENDER_QUEUE_PROXY_CHUNK_COUNT 256u
+#define SE_RENDER_QUEUE_DEFAULT_SECONDARY_COMMANDS 1024u
+#define SE_RENDER_QUEUE_DEFAULT_SECONDARY_BYTES (512u * 1024u)
+#define SE_RENDER_QUEUE_KIND_TABLE_SIZE 256u
+#define SE_RENDER_QUEUE_PACING_SMOOTHING 0.2
 
 typedef struct {
 	se_render_queue_sync_fn fn;
 	u32 payload_offset;
 	u32 payload_bytes;
+	u32 pointer_patch_offset;
+	u32 blob_bytes;
+	se_render_thread_command_kind kind;
+#if defined(SE_RENDER_QUEUE_VALIDATION)
+	const c8* tag;
+	const c8* site;
+#endif
 } se_render_queue_command;
 
 typedef struct {
+	u8* bytes;
+	u32 capacity;
+} se_render_queue_block;
+
+// Large blobs live in pooled blocks owned by the packet until it is reset, so the
+// packet payload only has to hold small commands.
+typedef struct {
+	s_mutex mutex;
+	se_render_queue_block* free_blocks;
+	u32 free_block_count;
+	u32 free_block_capacity;
+	u32 large_block_threshold;
+	u64 retain_bytes;
+	u64 pool_bytes;
+	u64 in_use_bytes;
+	u64 high_water_bytes;
+	u64 allocations;
+	u64 reuses;
+} se_render_queue_block_pool;
+
+typedef struct se_render_queue_packet {
 	se_render_queue_command* commands;
 	u8* payload_bytes;
 	u32 command_capacity;
 	u32 payload_capacity;
 	u32 command_count;
 	u32 payload_used;
+	// Frame packets own one secondary per slot; secondaries leave this NULL.
+	struct se_render_queue_packet* secondaries;
+	u32 secondary_count;
+	se_render_queue_block* blocks;
+	u32 block_count;
+	u32 block_capacity;
+	f64 submit_time;
+	f64 execute_ms;
+	f64 latency_ms;
+	// Commands executed for this frame plus the round-trips issued while it was recorded.
+	se_render_thread_command_stats command_stats[SE_RENDER_THREAD_COMMAND_KIND_COUNT];
 	b8 submitted;
+	b8 recording;
+	b8 spliced;
 } se_render_queue_packet;
 
+typedef struct {
+	u32 slot;
+} se_render_queue_secondary_payload;
+
+// A thread holds at most one open reservation; the command stays inert until committed.
+typedef struct {
+	se_render_queue_sync_fn fn;
+	se_render_queue_packet* packet;
+	u8* scratch;
+	void* blob;
+	u32 command_index;
+	b8 active;
+	b8 secondary;
+} se_render_queue_reservation;
+
 typedef struct {
 	s_mutex mutex;
 	s_cond work_ready;
 	s_cond started;
 	s_cond sync_done;
 	s_cond present_done;
+	s_cond recording_done;
 	s_thread thread;
 
 	b8 initialized;
@@ -63,13 +132,36 @@ typedef struct {
 	b8 sync_pending;
 	b8 sync_completed;
 
-	b8 present_pending;
-	i32 pending_packet_index;
+	// Submitted packets waiting for execute + present, oldest first.
+	u32 pending_packets[SE_RENDER_THREAD_MAX_PACKET_COUNT];
+	u32 pending_packet_head;
+	u32 pending_packet_count;
 	u32 record_packet_index;
-	se_render_queue_packet packets[SE_RENDER_QUEUE_PACKET_COUNT];
+	u32 packet_count;
+	u32 max_frames_in_flight;
+	se_render_thread_mode mode;
+	se_render_queue_packet packets[SE_RENDER_THREAD_MAX_PACKET_COUNT];
 
 	u32 max_commands_per_frame;
 	u32 max_command_bytes_per_frame;
+	u32 max_secondary_packets;
+	u32 secondary_commands_per_packet;
+	u32 secondary_command_bytes_per_packet;
+	u32 recording_secondaries;
+	u32 pending_reservations;
+	se_render_queue_block_pool block_pool;
+
+	// Proxy names: chunks never move, so the render thread resolves without locking.
+	// The table outlives stop/start because engine objects keep the proxy values.
+	u32* proxy_chunks[SE_RENDER_QUEUE_PROXY_CHUNK_COUNT];
+	u32 proxy_next;
+	u32* proxy_free;
+	u32 proxy_free_count;
+	u32 proxy_free_capacity;
+	u32 live_proxies;
+	// Capture replay binds into its own chunks, allocated on demand and freed when it ends.
+	u32* replay_proxy_chunks[SE_RENDER_QUEUE_PROXY_CHUNK_COUNT];
+	b8 replaying;
 
 	u64 submitted_frames;
 	u64 presented_frames;
@@ -78,12 +170,82 @@ typedef struct {
 	u64 last_command_bytes;
 	u64 current_command_count;
 	u64 current_command_bytes;
+	u32 last_secondary_packets;
+	u64 last_secondary_command_count;
+	u64 secondary_overflows;
+	u64 payload_high_water_bytes;
+	u64 proxy_names_created;
+	u64 redundant_state_skips;
+	u64 last_redundant_state_skips;
+	// Owned by the render thread while capture_busy; otherwise guarded by the mutex.
+	se_render_capture_writer* capture_writer;
+	u32 capture_frames_left;
+	b8 capture_unbounded;
+	b8 capture_busy;
+	u64 captured_frames;
+	// Open-addressed fn -> dispatch command table, filled once before the first start.
+	const se_render_queue_command_info* command_table[SE_RENDER_QUEUE_KIND_TABLE_SIZE];
+	b8 command_table_built;
+	se_render_thread_command_stats command_stats[SE_RENDER_THREAD_COMMAND_KIND_COUNT];
+	se_render_thread_command_stats last_command_stats[SE_RENDER_THREAD_COMMAND_KIND_COUNT];
+	u64 sync_calls;
+	f64 sync_stall_ms;
+	u32 frame_sync_calls;
+	f64 frame_sync_stall_ms;
+	u32 last_sync_calls;
+	f64 last_sync_stall_ms;
+	se_render_queue_sync_fn last_sync_fn;
 	f64 last_submit_wait_ms;
 	f64 last_execute_ms;
 	f64 last_present_ms;
+	f64 last_frame_latency_ms;
+	se_render_thread_pacing pacing;
+	u32 target_frames_in_flight;
+	f64 latency_budget_ms;
+	f64 frame_begin_time;
+	f64 producer_period_ms;
+	f64 producer_blocked_ms;
+	s_thread_id producer_thread_id;
+	se_render_thread_pacing_stats pacing_stats;
 } se_render_queue_runtime;
 
 static se_render_queue_runtime g_render_queue = {0};
+static SE_THREAD_LOCAL se_render_queue_packet* g_se_render_queue_tls_secondary = NULL;
+static SE_THREAD_LOCAL se_render_queue_reservation g_se_render_queue_tls_reservation = {0};
+// Filled by the render thread while executing, drained under the lock after each packet.
+static SE_THREAD_LOCAL se_render_thread_command_stats g_se_render_queue_tls_command_stats[SE_RENDER_THREAD_COMMAND_KIND_COUNT];
+
+#if defined(SE_RENDER_QUEUE_VALIDATION)
+typedef struct {
+	u32* names;
+	u32 capacity;
+	u32 count;
+} se_render_queue_name_set;
+
+// Names deleted by recorded commands, per object type, until the same name is handed out again.
+typedef struct {
+	s_mutex mutex;
+	se_render_queue_name_set deleted[SE_RENDER_QUEUE_OBJECT_TYPE_COUNT];
+	u64 errors;
+	const c8* last_command;
+	const c8* last_tag;
+	const c8* last_site;
+} se_render_queue_validation;
+
+// What the recording thread last bound; a slot is unknown until the thread binds it.
+typedef struct {
+	u32 names[SE_RENDER_QUEUE_OBJECT_TYPE_COUNT];
+	b8 known[SE_RENDER_QUEUE_OBJECT_TYPE_COUNT];
+} se_render_queue_validation_bindings;
+
+static se_render_queue_validation g_se_render_queue_validation = {0};
+static SE_THREAD_LOCAL se_render_queue_validation_bindings g_se_render_queue_tls_bindings = {0};
+static SE_THREAD_LOCAL const c8* g_se_render_queue_tls_caller_tag = NULL;
+// Engine source line of the calling thread's latest GL call, set by the se_gl.h wrappers.
+static SE_THREAD_LOCAL const c8* g_se_render_queue_tls_call_site = NULL;
+#endif
+
+static void se_render_queue_secondary_marker(const void* payload, void* out_result);
 
 static f64 se_render_queue_now_seconds(void) {
 #if defined(_WIN32)
@@ -123,27 +285,188 @@ static u32 se_render_queue_depth_locked(const se_render_queue_runtime* runtime)
 	return (u32)depth;
 }
 
+static f64 se_render_queue_smooth_ms(const f64 current, const f64 sample) {
+	return current > 0.0 ? current + (sample - current) * SE_RENDER_QUEUE_PACING_SMOOTHING : sample;
+}
+
+// Picks frames in flight and whether to block on present for the frame being submitted.
+static void se_render_queue_update_pacing_locked(se_render_queue_runtime* runtime, const f64 producer_ms) {
+	se_render_thread_pacing_stats* pacing = &runtime->pacing_stats;
+	pacing->producer_frame_ms = se_render_queue_smooth_ms(pacing->producer_frame_ms, producer_ms);
+	const f64 producer = pacing->producer_frame_ms;
+	const f64 render = pacing->render_frame_ms;
+	const u32 frame_limit = runtime->packet_count - 1u;
+	u32 frames = runtime->max_frames_in_flight;
+	b8 wait_for_present = runtime->wait_on_submit;
+	pacing->render_bound = render > producer;
+	if (runtime->pacing == SE_RENDER_THREAD_PACING_FRAMES_IN_FLIGHT) {
+		frames = runtime->target_frames_in_flight;
+		frames = frames < 1u ? 1u : (frames > frame_limit ? frame_limit : frames);
+		wait_for_present = false;
+	} else if (runtime->pacing == SE_RENDER_THREAD_PACING_LATENCY_BUDGET) {
+		// Each frame queued ahead adds one render-thread frame before this one presents.
+		frames = 1u;
+		while (frames < frame_limit && producer + render * (f64)(frames + 1u) <= runtime->latency_budget_ms) {
+			frames++;
+		}
+		// Still over budget with one frame in flight: a render-bound producer would stall at the
+		// next submit holding stale input, so it waits for present and samples input afterwards.
+		wait_for_present = pacing->render_bound && producer + render > runtime->latency_budget_ms;
+	}
+	if (frames != runtime->max_frames_in_flight) {
+		pacing->adjustments++;
+	}
+	runtime->max_frames_in_flight = frames;
+	pacing->frames_in_flight = frames;
+	pacing->wait_for_present = wait_for_present;
+	pacing->estimated_latency_ms = producer + render * (f64)(wait_for_present ? 1u : frames);
+	if (runtime->pacing == SE_RENDER_THREAD_PACING_LATENCY_BUDGET && pacing->estimated_latency_ms > runtime->latency_budget_ms) {
+		pacing->over_budget_frames++;
+	}
+}
+
+static u32 se_render_queue_block_size(const u32 bytes, const u32 minimum) {
+	u32 size = minimum > 0u ? minimum : 1u;
+	while (size < bytes && size < 0x80000000u) {
+		size <<= 1u;
+	}
+	return size < bytes ? bytes : size;
+}
+
+static u8* se_render_queue_acquire_block(se_render_queue_block_pool* pool, se_render_queue_packet* packet, const u32 bytes) {
+	if (packet->block_count >= packet->block_capacity) {
+		const u32 new_capacity = packet->block_capacity > 0u ? packet->block_capacity * 2u : 4u;
+		se_render_queue_block* blocks = (se_render_queue_block*)realloc(packet->blocks, sizeof(se_render_queue_block) * (sz)new_capacity);
+		if (!blocks) {
+			return NULL;
+		}
+		packet->blocks = blocks;
+		packet->block_capacity = new_capacity;
+	}
+
+	se_render_queue_block block = {0};
+	s_mutex_lock(&pool->mutex);
+	u32 best = pool->free_block_count;
+	for (u32 i = 0u; i < pool->free_block_count; ++i) {
+		if (pool->free_blocks[i].capacity >= bytes &&
+			(best == pool->free_block_count || pool->free_blocks[i].capacity < pool->free_blocks[best].capacity)) {
+			best = i;
+		}
+	}
+	if (best < pool->free_block_count) {
+		block = pool->free_blocks[best];
+		pool->free_blocks[best] = pool->free_blocks[--pool->free_block_count];
+		pool->pool_bytes -= block.capacity;
+		pool->reuses++;
+	} else {
+		block.capacity = se_render_queue_block_size(bytes, pool->large_block_threshold);
+		block.bytes = (u8*)malloc((sz)block.capacity);
+		if (!block.bytes) {
+			s_mutex_unlock(&pool->mutex);
+			return NULL;
+		}
+		pool->allocations++;
+	}
+	pool->in_use_bytes += block.capacity;
+	if (pool->in_use_bytes > pool->high_water_bytes) {
+		pool->high_water_bytes = pool->in_use_bytes;
+	}
+	s_mutex_unlock(&pool->mutex);
+
+	packet->blocks[packet->block_count++] = block;
+	return block.bytes;
+}
+
+static void se_render_queue_release_blocks(se_render_queue_block_pool* pool, se_render_queue_packet* packet) {
+	if (packet->block_count == 0u) {
+		return;
+	}
+	s_mutex_lock(&pool->mutex);
+	for (u32 i = 0u; i < packet->block_count; ++i) {
+		se_render_queue_block block = packet->blocks[i];
+		pool->in_use_bytes -= block.capacity;
+		if (pool->pool_bytes + block.capacity > pool->retain_bytes) {
+			free(block.bytes);
+			continue;
+		}
+		if (pool->free_block_count >= pool->free_block_capacity) {
+			const u32 new_capacity = pool->free_block_capacity > 0u ? pool->free_block_capacity * 2u : 8u;
+			se_render_queue_block* free_blocks = (se_render_queue_block*)realloc(pool->free_blocks, sizeof(se_render_queue_block) * (sz)new_capacity);
+			if (!free_blocks) {
+				free(block.bytes);
+				continue;
+			}
+			pool->free_blocks = free_blocks;
+			pool->free_block_capacity = new_capacity;
+		}
+		pool->free_blocks[pool->free_block_count++] = block;
+		pool->pool_bytes += block.capacity;
+	}
+	s_mutex_unlock(&pool->mutex);
+	packet->block_count = 0u;
+}
+
+static void se_render_queue_clear_block_pool(se_render_queue_block_pool* pool) {
+	s_mutex_lock(&pool->mutex);
+	for (u32 i = 0u; i < pool->free_block_count; ++i) {
+		free(pool->free_blocks[i].bytes);
+	}
+	free(pool->free_blocks);
+	pool->free_blocks = NULL;
+	pool->free_block_count = 0u;
+	pool->free_block_capacity = 0u;
+	pool->pool_bytes = 0u;
+	s_mutex_unlock(&pool->mutex);
+}
+
 static void se_render_queue_packet_reset(se_render_queue_packet* packet) {
 	if (!packet) {
 		return;
 	}
 	packet->command_count = 0u;
 	packet->payload_used = 0u;
+	se_render_queue_release_blocks(&g_render_queue.block_pool, packet);
+}
+
+static void se_render_queue_packet_free(se_render_queue_packet* packet) {
+	if (!packet) {
+		return;
+	}
+	se_render_queue_release_blocks(&g_render_queue.block_pool, packet);
+	if (packet->blocks) {
+		free(packet->blocks);
+	}
+	if (packet->secondaries) {
+		for (u32 i = 0u; i < packet->secondary_count; ++i) {
+			se_render_queue_packet_free(&packet->secondaries[i]);
+		}
+		free(packet->secondaries);
+	}
+	if (packet->commands) {
+		free(packet->commands);
+	}
+	if (packet->payload_bytes) {
+		free(packet->payload_bytes);
+	}
+	memset(packet, 0, sizeof(*packet));
+}
+
+static void se_render_queue_reset_secondaries(se_render_queue_packet* packet) {
+	if (!packet || !packet->secondaries) {
+		return;
+	}
+	for (u32 i = 0u; i < packet->secondary_count; ++i) {
+		se_render_queue_packet_reset(&packet->secondaries[i]);
+		packet->secondaries[i].spliced = false;
+	}
 }
 
 static void se_render_queue_release_packets(se_render_queue_runtime* runtime) {
 	if (!runtime) {
 		return;
 	}
-	for (u32 i = 0u; i < SE_RENDER_QUEUE_PACKET_COUNT; ++i) {
-		se_render_queue_packet* packet = &runtime->packets[i];
-		if (packet->commands) {
-			free(packet->commands);
-		}
-		if (packet->payload_bytes) {
-			free(packet->payload_bytes);
-		}
-		memset(packet, 0, sizeof(*packet));
+	for (u32 i = 0u; i < SE_RENDER_THREAD_MAX_PACKET_COUNT; ++i) {
+		se_render_queue_packet_free(&runtime->packets[i]);
 	}
 }
 
@@ -162,7 +485,7 @@ static b8 se_render_queue_allocate_packets(se_render_queue_runtime* runtime) {
 		return false;
 	}
 
-	for (u32 i = 0u; i < SE_RENDER_QUEUE_PACKET_COUNT; ++i) {
+	for (u32 i = 0u; i < runtime->packet_count; ++i) {
 		se_render_queue_packet* packet = &runtime->packets[i];
 		packet->commands = (se_render_queue_command*)malloc(sizeof(se_render_queue_command) * (sz)command_capacity);
 		packet->payload_bytes = (u8*)malloc((sz)payload_capacity);
@@ -174,19 +497,50 @@ static b8 se_render_queue_allocate_packets(se_render_queue_runtime* runtime) {
 		packet->payload_capacity = payload_capacity;
 		packet->submitted = false;
 		se_render_queue_packet_reset(packet);
+		if (runtime->max_secondary_packets > 0u) {
+			packet->secondaries = (se_render_queue_packet*)calloc((sz)runtime->max_secondary_packets, sizeof(se_render_queue_packet));
+			if (!packet->secondaries) {
+				se_render_queue_release_packets(runtime);
+				return false;
+			}
+			packet->secondary_count = runtime->max_secondary_packets;
+		}
 	}
 
 	return true;
 }
 
-static b8 se_render_queue_record_locked(se_render_queue_runtime* runtime,
-	const se_render_queue_sync_fn fn,
+// Secondary buffers are allocated on first use so unused slots cost nothing.
+static b8 se_render_queue_allocate_secondary(const se_render_queue_runtime* runtime, se_render_queue_packet* secondary) {
+	if (!runtime || !secondary) {
+		return false;
+	}
+	if (secondary->commands && secondary->payload_bytes) {
+		return true;
+	}
+	const u32 command_capacity = runtime->secondary_commands_per_packet > 0u ?
+		runtime->secondary_commands_per_packet : SE_RENDER_QUEUE_DEFAULT_SECONDARY_COMMANDS;
+	const u32 payload_capacity = runtime->secondary_command_bytes_per_packet > 0u ?
+		runtime->secondary_command_bytes_per_packet : SE_RENDER_QUEUE_DEFAULT_SECONDARY_BYTES;
+	secondary->commands = (se_render_queue_command*)malloc(sizeof(se_render_queue_command) * (sz)command_capacity);
+	secondary->payload_bytes = (u8*)malloc((sz)payload_capacity);
+	if (!secondary->commands || !secondary->payload_bytes) {
+		se_render_queue_packet_free(secondary);
+		return false;
+	}
+	secondary->command_capacity = command_capacity;
+	secondary->payload_capacity = payload_capacity;
+	se_render_queue_packet_reset(secondary);
+	return true;
+}
+
+static b8 se_render_queue_validate_record(const se_render_queue_sync_fn fn,
 	const void* payload,
 	const u32 payload_bytes,
 	const u32 pointer_patch_offset,
 	const void* blob,
 	const u32 blob_bytes) {
-	if (!runtime || !fn) {
+	if (!fn) {
 		se_set_last_error(SE_RESULT_INVALID_ARGUMENT);
 		return false;
 	}
@@ -203,22 +557,330 @@ static b8 se_render_queue_record_locked(se_render_queue_runtime* runtime,
 		se_set_last_error(SE_RESULT_INVALID_ARGUMENT);
 		return false;
 	}
+	return true;
+}
 
-	if (!runtime->running || runtime->failed || runtime->stopping) {
-		se_set_last_error(SE_RESULT_BACKEND_FAILURE);
-		return false;
+static u32 se_render_queue_command_slot(const se_render_queue_sync_fn fn) {
+	uintptr_t value = (uintptr_t)fn;
+	value ^= value >> 16;
+	value *= (uintptr_t)0x45D9F3Bu;
+	value ^= value >> 16;
+	return (u32)value & (SE_RENDER_QUEUE_KIND_TABLE_SIZE - 1u);
+}
+
+typedef const se_render_queue_command_info* (*se_render_queue_command_list_fn)(u32* out_count);
+
+// Every module that records commands into packets lists them here.
+static const se_render_queue_command_list_fn g_se_render_queue_command_lists[] = {
+	se_gl_dispatch_get_commands,
+	se_gl_stream_get_commands
+};
+
+#define SE_RENDER_QUEUE_COMMAND_LIST_COUNT ((u32)(sizeof(g_se_render_queue_command_lists) / sizeof(g_se_render_queue_command_lists[0])))
+
+static void se_render_queue_build_command_table(se_render_queue_runtime* runtime) {
+	if (runtime->command_table_built) {
+		return;
 	}
-	if (!runtime->frame_open) {
-		se_set_last_error(SE_RESULT_UNSUPPORTED);
-		return false;
+	u32 registered = 0u;
+	for (u32 list = 0u; list < SE_RENDER_QUEUE_COMMAND_LIST_COUNT; ++list) {
+		u32 count = 0u;
+		const se_render_queue_command_info* commands = g_se_render_queue_command_lists[list](&count);
+		for (u32 i = 0u; i < count && registered < SE_RENDER_QUEUE_KIND_TABLE_SIZE / 2u; ++i, ++registered) {
+			u32 slot = se_render_queue_command_slot(commands[i].fn);
+			while (runtime->command_table[slot]) {
+				slot = (slot + 1u) & (SE_RENDER_QUEUE_KIND_TABLE_SIZE - 1u);
+			}
+			runtime->command_table[slot] = &commands[i];
+		}
 	}
+	runtime->command_table_built = true;
+}
 
-	if (runtime->record_packet_index >= SE_RENDER_QUEUE_PACKET_COUNT) {
-		se_set_last_error(SE_RESULT_BACKEND_FAILURE);
+const se_render_queue_command_info* se_render_queue_command_info_for(const se_render_queue_sync_fn fn) {
+	for (u32 list = 0u; fn && list < SE_RENDER_QUEUE_COMMAND_LIST_COUNT; ++list) {
+		u32 count = 0u;
+		const se_render_queue_command_info* commands = g_se_render_queue_command_lists[list](&count);
+		for (u32 i = 0u; i < count; ++i) {
+			if (commands[i].fn == fn) {
+				return &commands[i];
+			}
+		}
+	}
+	return NULL;
+}
+
+const se_render_queue_command_info* se_render_queue_command_info_named(const c8* name) {
+	for (u32 list = 0u; name && list < SE_RENDER_QUEUE_COMMAND_LIST_COUNT; ++list) {
+		u32 count = 0u;
+		const se_render_queue_command_info* commands = g_se_render_queue_command_lists[list](&count);
+		for (u32 i = 0u; i < count; ++i) {
+			if (strcmp(commands[i].name, name) == 0) {
+				return &commands[i];
+			}
+		}
+	}
+	return NULL;
+}
+
+static const se_render_queue_command_info* se_render_queue_find_command(const se_render_queue_sync_fn fn) {
+	if (!fn) {
+		return NULL;
+	}
+	u32 slot = se_render_queue_command_slot(fn);
+	for (u32 probe = 0u; probe < SE_RENDER_QUEUE_KIND_TABLE_SIZE; ++probe) {
+		const se_render_queue_command_info* info = g_render_queue.command_table[slot];
+		if (!info) {
+			return NULL;
+		}
+		if (info->fn == fn) {
+			return info;
+		}
+		slot = (slot + 1u) & (SE_RENDER_QUEUE_KIND_TABLE_SIZE - 1u);
+	}
+	return NULL;
+}
+
+// Every recorder registers its commands, so the fallback only covers validation failures.
+static se_render_thread_command_kind se_render_queue_command_kind(const se_render_queue_sync_fn fn) {
+	const se_render_queue_command_info* info = se_render_queue_find_command(fn);
+	return info ? info->kind : SE_RENDER_THREAD_COMMAND_STATE;
+}
+
+#if defined(SE_RENDER_QUEUE_VALIDATION)
+static u32 se_render_queue_name_slot(const u32 name, const u32 capacity) {
+	return (name * 2654435761u) & (capacity - 1u);
+}
+
+static b8 se_render_queue_name_set_contains(const se_render_queue_name_set* set, const u32 name) {
+	if (set->count == 0u) {
 		return false;
 	}
-	se_render_queue_packet* packet = &runtime->packets[runtime->record_packet_index];
-	if (!packet->commands || !packet->payload_bytes || packet->submitted) {
+	for (u32 slot = se_render_queue_name_slot(name, set->capacity); set->names[slot] != 0u; slot = (slot + 1u) & (set->capacity - 1u)) {
+		if (set->names[slot] == name) {
+			return true;
+		}
+	}
+	return false;
+}
+
+static void se_render_queue_name_set_insert(se_render_queue_name_set* set, const u32 name) {
+	if ((set->count + 1u) * 2u > set->capacity) {
+		const u32 new_capacity = set->capacity > 0u ? set->capacity * 2u : 256u;
+		u32* names = (u32*)calloc(new_capacity, sizeof(u32));
+		if (!names) {
+			return;
+		}
+		for (u32 i = 0u; i < set->capacity; ++i) {
+			if (set->names[i] == 0u) {
+				continue;
+			}
+			u32 slot = se_render_queue_name_slot(set->names[i], new_capacity);
+			while (names[slot] != 0u) {
+				slot = (slot + 1u) & (new_capacity - 1u);
+			}
+			names[slot] = set->names[i];
+		}
+		free(set->names);
+		set->names = names;
+		set->capacity = new_capacity;
+	}
+	u32 slot = se_render_queue_name_slot(name, set->capacity);
+	while (set->names[slot] != 0u) {
+		if (set->names[slot] == name) {
+			return;
+		}
+		slot = (slot + 1u) & (set->capacity - 1u);
+	}
+	set->names[slot] = name;
+	set->count++;
+}
+
+// Backward-shift removal keeps probe chains intact without tombstones.
+static void se_render_queue_name_set_remove(se_render_queue_name_set* set, const u32 name) {
+	if (set->count == 0u) {
+		return;
+	}
+	const u32 mask = set->capacity - 1u;
+	u32 slot = se_render_queue_name_slot(name, set->capacity);
+	while (set->names[slot] != name) {
+		if (set->names[slot] == 0u) {
+			return;
+		}
+		slot = (slot + 1u) & mask;
+	}
+	u32 hole = slot;
+	for (u32 next = (hole + 1u) & mask; set->names[next] != 0u; next = (next + 1u) & mask) {
+		const u32 home = se_render_queue_name_slot(set->names[next], set->capacity);
+		if (((next - home) & mask) >= ((next - hole) & mask)) {
+			set->names[hole] = set->names[next];
+			hole = next;
+		}
+	}
+	set->names[hole] = 0u;
+	set->count--;
+}
+
+static void se_render_queue_validation_fail(const c8* command, const c8* tag, const c8* site, const c8* problem, const u32 value) {
+	se_render_queue_validation* validation = &g_se_render_queue_validation;
+	s_mutex_lock(&validation->mutex);
+	validation->errors++;
+	validation->last_command = command;
+	validation->last_tag = tag;
+	validation->last_site = site;
+	s_mutex_unlock(&validation->mutex);
+	se_debug_log(SE_DEBUG_LEVEL_ERROR, SE_DEBUG_CATEGORY_RENDER, "render queue validation: %s %s (%u), recorded at %s (%s)",
+		command ? command : "command",
+		problem,
+		value,
+		tag ? tag : "untagged",
+		site ? site : "unknown site");
+}
+
+static void se_render_queue_validation_reset(void) {
+	se_render_queue_validation* validation = &g_se_render_queue_validation;
+	s_mutex_lock(&validation->mutex);
+	for (u32 type = 0u; type < SE_RENDER_QUEUE_OBJECT_TYPE_COUNT; ++type) {
+		se_render_queue_name_set* set = &validation->deleted[type];
+		if (set->names) {
+			memset(set->names, 0, sizeof(u32) * (sz)set->capacity);
+		}
+		set->count = 0u;
+	}
+	validation->errors = 0u;
+	validation->last_command = NULL;
+	validation->last_tag = NULL;
+	validation->last_site = NULL;
+	s_mutex_unlock(&validation->mutex);
+}
+
+// Proxies share one namespace across object types.
+static void se_render_queue_validation_forget_proxy(const u32 proxy) {
+	se_render_queue_validation* validation = &g_se_render_queue_validation;
+	s_mutex_lock(&validation->mutex);
+	for (u32 type = 0u; type < SE_RENDER_QUEUE_OBJECT_TYPE_COUNT; ++type) {
+		se_render_queue_name_set_remove(&validation->deleted[type], proxy);
+	}
+	s_mutex_unlock(&validation->mutex);
+}
+
+static void se_render_queue_validate_payload(const se_render_queue_sync_fn fn, const u32 payload_bytes) {
+	const se_render_queue_command_info* info = se_render_queue_find_command(fn);
+	if (!info) {
+		se_render_queue_validation_fail(NULL, g_se_render_queue_tls_caller_tag, g_se_render_queue_tls_call_site, "is missing from the command tables", payload_bytes);
+	} else if (info->payload_bytes != payload_bytes) {
+		se_render_queue_validation_fail(info->name, g_se_render_queue_tls_caller_tag, g_se_render_queue_tls_call_site, "payload size does not match its struct", payload_bytes);
+	}
+}
+
+void se_render_queue_validate_created(const se_render_queue_object_type type, const i32 n, const u32* names) {
+	if (type >= SE_RENDER_QUEUE_OBJECT_TYPE_COUNT || !names || !g_render_queue.initialized) {
+		return;
+	}
+	se_render_queue_validation* validation = &g_se_render_queue_validation;
+	s_mutex_lock(&validation->mutex);
+	for (i32 i = 0; i < n; ++i) {
+		se_render_queue_name_set_remove(&validation->deleted[type], names[i]);
+	}
+	s_mutex_unlock(&validation->mutex);
+}
+
+void se_render_queue_validate_deleted(const c8* call, const se_render_queue_object_type type, const i32 n, const u32* names) {
+	if (type >= SE_RENDER_QUEUE_OBJECT_TYPE_COUNT || !names || !g_render_queue.initialized) {
+		return;
+	}
+	se_render_queue_validation* validation = &g_se_render_queue_validation;
+	se_render_queue_validation_bindings* bindings = &g_se_render_queue_tls_bindings;
+	for (i32 i = 0; i < n; ++i) {
+		const u32 name = names[i];
+		if (name == 0u) {
+			continue;
+		}
+		s_mutex_lock(&validation->mutex);
+		const b8 twice = se_render_queue_name_set_contains(&validation->deleted[type], name);
+		se_render_queue_name_set_insert(&validation->deleted[type], name);
+		s_mutex_unlock(&validation->mutex);
+		if (twice) {
+			se_render_queue_validation_fail(call, g_se_render_queue_tls_caller_tag, g_se_render_queue_tls_call_site, "deletes an object that was already deleted", name);
+		}
+		// GL unbinds deleted objects, except a program in use, which lives until replaced.
+		if (type != SE_RENDER_QUEUE_OBJECT_PROGRAM && bindings->known[type] && bindings->names[type] == name) {
+			bindings->names[type] = 0u;
+		}
+	}
+}
+
+void se_render_queue_validate_used(const c8* call, const se_render_queue_object_type type, const u32 name) {
+	if (type >= SE_RENDER_QUEUE_OBJECT_TYPE_COUNT || name == 0u || !g_render_queue.initialized) {
+		return;
+	}
+	se_render_queue_validation* validation = &g_se_render_queue_validation;
+	s_mutex_lock(&validation->mutex);
+	const b8 deleted = se_render_queue_name_set_contains(&validation->deleted[type], name);
+	s_mutex_unlock(&validation->mutex);
+	if (deleted) {
+		se_render_queue_validation_fail(call, g_se_render_queue_tls_caller_tag, g_se_render_queue_tls_call_site, "uses a deleted object", name);
+	}
+}
+
+void se_render_queue_validate_bound(const c8* call, const se_render_queue_object_type type, const u32 name) {
+	if (type >= SE_RENDER_QUEUE_OBJECT_TYPE_COUNT) {
+		return;
+	}
+	se_render_queue_validate_used(call, type, name);
+	g_se_render_queue_tls_bindings.names[type] = name;
+	g_se_render_queue_tls_bindings.known[type] = true;
+}
+
+void se_render_queue_validate_draw(const c8* call) {
+	const se_render_queue_validation_bindings* bindings = &g_se_render_queue_tls_bindings;
+	if (bindings->known[SE_RENDER_QUEUE_OBJECT_PROGRAM] && bindings->names[SE_RENDER_QUEUE_OBJECT_PROGRAM] == 0u) {
+		se_render_queue_validation_fail(call, g_se_render_queue_tls_caller_tag, g_se_render_queue_tls_call_site, "draws with no program in use", 0u);
+	}
+}
+
+#if !defined(SE_WINDOW_BACKEND_TERMINAL)
+// Render-thread half: ties a GL error back to the command and the site that recorded it.
+static void se_render_queue_validate_executed(const se_render_queue_command* command) {
+	const GLenum error = glGetError();
+	if (error == GL_NO_ERROR) {
+		return;
+	}
+	while (glGetError() != GL_NO_ERROR) {
+	}
+	const se_render_queue_command_info* info = se_render_queue_find_command(command->fn);
+	se_render_queue_validation_fail(info ? info->name : NULL, command->tag, command->site, "raised a GL error", (u32)error);
+}
+#endif
+#endif
+
+#if defined(SE_RENDER_QUEUE_VALIDATION)
+void se_render_queue_set_call_site(const c8* site) {
+	g_se_render_queue_tls_call_site = site;
+}
+#endif
+
+const c8* se_render_queue_set_caller_tag(const c8* tag) {
+#if defined(SE_RENDER_QUEUE_VALIDATION)
+	const c8* previous = g_se_render_queue_tls_caller_tag;
+	g_se_render_queue_tls_caller_tag = tag;
+	return previous;
+#else
+	(void)tag;
+	return NULL;
+#endif
+}
+
+// A NULL `blob` with non-zero `blob_bytes` reserves the space and returns it in `out_blob`.
+static b8 se_render_queue_packet_append(se_render_queue_packet* packet,
+	const se_render_queue_sync_fn fn,
+	const void* payload,
+	const u32 payload_bytes,
+	const u32 pointer_patch_offset,
+	const void* blob,
+	const u32 blob_bytes,
+	void** out_blob) {
+	if (!packet->commands || !packet->payload_bytes) {
 		se_set_last_error(SE_RESULT_BACKEND_FAILURE);
 		return false;
 	}
@@ -227,53 +889,241 @@ static b8 se_render_queue_record_locked(se_render_queue_runtime* runtime,
 		return false;
 	}
 
+	se_render_queue_block_pool* pool = &g_render_queue.block_pool;
+	const b8 use_block = blob_bytes > 0u &&
+		blob_bytes >= pool->large_block_threshold &&
+		pointer_patch_offset != SE_RENDER_QUEUE_POINTER_PATCH_NONE;
 	const u32 aligned_offset = se_render_queue_align_up(packet->payload_used, SE_RENDER_QUEUE_ALIGN_BYTES);
-	const u32 total_payload = payload_bytes + blob_bytes;
+	const u32 total_payload = payload_bytes + (use_block ? 0u : blob_bytes);
 	if (aligned_offset > packet->payload_capacity || total_payload > (packet->payload_capacity - aligned_offset)) {
 		se_set_last_error(SE_RESULT_CAPACITY_EXCEEDED);
 		return false;
 	}
+	u8* blob_dst = packet->payload_bytes + aligned_offset + payload_bytes;
+	if (use_block) {
+		blob_dst = se_render_queue_acquire_block(pool, packet, blob_bytes);
+		if (!blob_dst) {
+			se_set_last_error(SE_RESULT_OUT_OF_MEMORY);
+			return false;
+		}
+	}
 
 	se_render_queue_command* command = &packet->commands[packet->command_count];
 	command->fn = fn;
 	command->payload_offset = aligned_offset;
-	command->payload_bytes = total_payload;
+	command->payload_bytes = payload_bytes;
+	command->pointer_patch_offset = pointer_patch_offset;
+	command->blob_bytes = blob_bytes;
+	command->kind = se_render_queue_command_kind(fn);
+#if defined(SE_RENDER_QUEUE_VALIDATION)
+	command->tag = g_se_render_queue_tls_caller_tag;
+	command->site = g_se_render_queue_tls_call_site;
+#endif
 
 	u8* payload_dst = packet->payload_bytes + aligned_offset;
 	if (payload_bytes > 0u) {
 		memcpy(payload_dst, payload, payload_bytes);
 	}
 	if (blob_bytes > 0u) {
-		u8* blob_dst = payload_dst + payload_bytes;
-		memcpy(blob_dst, blob, blob_bytes);
+		if (blob) {
+			memcpy(blob_dst, blob, blob_bytes);
+		}
 		if (pointer_patch_offset != SE_RENDER_QUEUE_POINTER_PATCH_NONE) {
 			void** patch_ptr = (void**)(payload_dst + pointer_patch_offset);
 			*patch_ptr = blob_dst;
 		}
+		if (out_blob) {
+			*out_blob = blob_dst;
+		}
 	}
 
 	packet->command_count++;
 	packet->payload_used = aligned_offset + total_payload;
+	se_set_last_error(SE_RESULT_OK);
+	return true;
+}
+
+static se_render_queue_packet* se_render_queue_record_packet_locked(se_render_queue_runtime* runtime) {
+	if (!runtime->running || runtime->failed || runtime->stopping) {
+		se_set_last_error(SE_RESULT_BACKEND_FAILURE);
+		return NULL;
+	}
+	if (!runtime->frame_open) {
+		se_set_last_error(SE_RESULT_UNSUPPORTED);
+		return NULL;
+	}
+
+	if (runtime->record_packet_index >= runtime->packet_count) {
+		se_set_last_error(SE_RESULT_BACKEND_FAILURE);
+		return NULL;
+	}
+	se_render_queue_packet* packet = &runtime->packets[runtime->record_packet_index];
+	if (packet->submitted) {
+		se_set_last_error(SE_RESULT_BACKEND_FAILURE);
+		return NULL;
+	}
+	return packet;
+}
+
+static b8 se_render_queue_record_locked(se_render_queue_runtime* runtime,
+	const se_render_queue_sync_fn fn,
+	const void* payload,
+	const u32 payload_bytes,
+	const u32 pointer_patch_offset,
+	const void* blob,
+	const u32 blob_bytes) {
+	if (!runtime) {
+		se_set_last_error(SE_RESULT_INVALID_ARGUMENT);
+		return false;
+	}
+	if (!se_render_queue_validate_record(fn, payload, payload_bytes, pointer_patch_offset, blob, blob_bytes)) {
+		return false;
+	}
+	se_render_queue_packet* packet = se_render_queue_record_packet_locked(runtime);
+	if (!packet) {
+		return false;
+	}
+	if (!se_render_queue_packet_append(packet, fn, payload, payload_bytes, pointer_patch_offset, blob, blob_bytes, NULL)) {
+		return false;
+	}
+	runtime->current_command_count = packet->command_count;
+	runtime->current_command_bytes = packet->payload_used;
+	return true;
+}
+
+static void se_render_queue_secondary_marker(const void* payload, void* out_result) {
+	(void)payload;
+	(void)out_result;
+}
+
+static b8 se_render_queue_splice_secondary_locked(se_render_queue_runtime* runtime, se_render_queue_packet* packet, const u32 slot) {
+	const se_render_queue_secondary_payload marker = { .slot = slot };
+	if (!se_render_queue_packet_append(packet,
+		se_render_queue_secondary_marker,
+		&marker,
+		(u32)sizeof(marker),
+		SE_RENDER_QUEUE_POINTER_PATCH_NONE,
+		NULL,
+		0u,
+		NULL)) {
+		return false;
+	}
+	packet->secondaries[slot].spliced = true;
 	runtime->current_command_count = packet->command_count;
 	runtime->current_command_bytes = packet->payload_used;
-	se_set_last_error(SE_RESULT_OK);
 	return true;
 }
 
+// Secondaries being recorded and open reservations must land before a packet executes.
+static void se_render_queue_wait_recorders_locked(se_render_queue_runtime* runtime) {
+	while ((runtime->recording_secondaries > 0u || runtime->pending_reservations > 0u) && runtime->running && !runtime->failed) {
+		s_cond_wait(&runtime->recording_done, &runtime->mutex);
+	}
+}
+
 static void se_render_queue_execute_packet(const se_render_queue_packet* packet) {
 	if (!packet || !packet->commands || !packet->payload_bytes || packet->command_count == 0u) {
 		return;
 	}
+	se_render_thread_command_stats* stats = g_se_render_queue_tls_command_stats;
+	f64 command_begin = se_render_queue_now_seconds();
 	for (u32 i = 0u; i < packet->command_count; ++i) {
 		const se_render_queue_command* command = &packet->commands[i];
 		if (!command->fn) {
 			continue;
 		}
 		const void* command_payload = packet->payload_bytes + command->payload_offset;
+		if (command->fn == se_render_queue_secondary_marker) {
+			const se_render_queue_secondary_payload* marker = (const se_render_queue_secondary_payload*)command_payload;
+			if (packet->secondaries && marker->slot < packet->secondary_count) {
+				se_render_queue_execute_packet(&packet->secondaries[marker->slot]);
+			}
+			command_begin = se_render_queue_now_seconds();
+			continue;
+		}
 		command->fn(command_payload, NULL);
+#if defined(SE_RENDER_QUEUE_VALIDATION) && !defined(SE_WINDOW_BACKEND_TERMINAL)
+		se_render_queue_validate_executed(command);
+#endif
+		// One clock read per command: each command is charged the time since the previous one.
+		const f64 command_end = se_render_queue_now_seconds();
+		se_render_thread_command_stats* kind_stats = &stats[command->kind];
+		kind_stats->count++;
+		kind_stats->payload_bytes += (u64)command->payload_bytes + command->blob_bytes;
+		kind_stats->execute_ms += (command_end - command_begin) * 1000.0;
+		command_begin = command_end;
+	}
+}
+
+static void se_render_queue_add_command_stats(se_render_thread_command_stats* dst, const se_render_thread_command_stats* src) {
+	for (u32 kind = 0u; kind < SE_RENDER_THREAD_COMMAND_KIND_COUNT; ++kind) {
+		dst[kind].count += src[kind].count;
+		dst[kind].payload_bytes += src[kind].payload_bytes;
+		dst[kind].execute_ms += src[kind].execute_ms;
 	}
 }
 
+// Moves the render thread's executed-command stats into the lifetime totals and the packet
+// they belong to, if any.
+static void se_render_queue_drain_command_stats_locked(se_render_queue_runtime* runtime, se_render_queue_packet* packet) {
+	se_render_queue_add_command_stats(runtime->command_stats, g_se_render_queue_tls_command_stats);
+	if (packet) {
+		se_render_queue_add_command_stats(packet->command_stats, g_se_render_queue_tls_command_stats);
+	}
+	memset(g_se_render_queue_tls_command_stats, 0, sizeof(g_se_render_queue_tls_command_stats));
+}
+
+// The packet the producer is recording, or NULL between frames.
+static se_render_queue_packet* se_render_queue_open_packet_locked(se_render_queue_runtime* runtime) {
+	if (!runtime->frame_open || runtime->record_packet_index >= runtime->packet_count) {
+		return NULL;
+	}
+	return &runtime->packets[runtime->record_packet_index];
+}
+
+// Captures flatten secondaries in execution order, so replays see the same stream.
+static void se_render_queue_capture_packet(se_render_capture_writer* writer, const se_render_queue_packet* packet) {
+	if (!packet || !packet->commands || !packet->payload_bytes) {
+		return;
+	}
+	for (u32 i = 0u; i < packet->command_count; ++i) {
+		const se_render_queue_command* command = &packet->commands[i];
+		if (!command->fn) {
+			continue;
+		}
+		const u8* command_payload = packet->payload_bytes + command->payload_offset;
+		if (command->fn == se_render_queue_secondary_marker) {
+			const se_render_queue_secondary_payload* marker = (const se_render_queue_secondary_payload*)command_payload;
+			if (packet->secondaries && marker->slot < packet->secondary_count) {
+				se_render_queue_capture_packet(writer, &packet->secondaries[marker->slot]);
+			}
+			continue;
+		}
+		const void* blob = NULL;
+		if (command->blob_bytes > 0u) {
+			if (command->pointer_patch_offset != SE_RENDER_QUEUE_POINTER_PATCH_NONE) {
+				memcpy(&blob, command_payload + command->pointer_patch_offset, sizeof(blob));
+			} else {
+				blob = command_payload + command->payload_bytes;
+			}
+		}
+		(void)se_render_capture_write_command(writer,
+			command->fn,
+			command_payload,
+			command->payload_bytes,
+			command->pointer_patch_offset,
+			blob,
+			command->blob_bytes);
+	}
+}
+
+static void se_render_queue_capture_close_locked(se_render_queue_runtime* runtime) {
+	se_render_capture_close(runtime->capture_writer);
+	runtime->capture_writer = NULL;
+	runtime->capture_frames_left = 0u;
+	runtime->capture_unbounded = false;
+}
+
 typedef struct {
 	se_render_queue_packet* packet;
 } se_render_queue_flush_payload;
@@ -321,6 +1171,7 @@ static void* se_render_queue_thread_main(void* user_data) {
 	se_context* previous_context = se_push_tls_context(runtime->context);
 	const b8 attached = se_window_backend_render_thread_attach(runtime->window);
 	const b8 render_ready = attached ? se_render_init() : false;
+	se_gl_state_cache_invalidate();
 
 	s_mutex_lock(&runtime->mutex);
 	runtime->started_signal = true;
@@ -346,7 +1197,7 @@ static void* se_render_queue_thread_main(void* user_data) {
 		b8 do_present = false;
 
 		s_mutex_lock(&runtime->mutex);
-		while (!runtime->stopping && !runtime->sync_pending && runtime->pending_packet_index < 0 && !runtime->present_pending) {
+		while (!runtime->stopping && !runtime->sync_pending && runtime->pending_packet_count == 0u) {
 			s_cond_wait(&runtime->work_ready, &runtime->mutex);
 		}
 		if (runtime->sync_pending) {
@@ -355,11 +1206,11 @@ static void* se_render_queue_thread_main(void* user_data) {
 			sync_out_result = runtime->sync_out_result;
 			runtime->sync_pending = false;
 			runtime->sync_completed = false;
-		} else if (runtime->pending_packet_index >= 0 || runtime->present_pending) {
-			packet_index = runtime->pending_packet_index;
-			runtime->pending_packet_index = -1;
-			do_present = runtime->present_pending;
-			runtime->present_pending = false;
+		} else if (runtime->pending_packet_count > 0u) {
+			packet_index = (i32)runtime->pending_packets[runtime->pending_packet_head];
+			runtime->pending_packet_head = (runtime->pending_packet_head + 1u) % SE_RENDER_THREAD_MAX_PACKET_COUNT;
+			runtime->pending_packet_count--;
+			do_present = true;
 		} else if (runtime->stopping) {
 			s_mutex_unlock(&runtime->mutex);
 			break;
@@ -373,8 +1224,12 @@ static void* se_render_queue_thread_main(void* user_data) {
 			se_debug_trace_end_channel("render_queue_sync", SE_DEBUG_TRACE_CHANNEL_GPU);
 			const f64 execute_end = se_render_queue_now_seconds();
 
+			const u64 skipped = se_gl_state_cache_take_skipped();
 			s_mutex_lock(&runtime->mutex);
 			runtime->last_execute_ms = (execute_end - execute_begin) * 1000.0;
+			runtime->redundant_state_skips += skipped;
+			// Round-trips run while a frame records, so flushed commands count toward that frame.
+			se_render_queue_drain_command_stats_locked(runtime, se_render_queue_open_packet_locked(runtime));
 			runtime->sync_completed = true;
 			s_cond_broadcast(&runtime->sync_done);
 			s_mutex_unlock(&runtime->mutex);
@@ -387,9 +1242,35 @@ static void* se_render_queue_thread_main(void* user_data) {
 			se_render_queue_execute_packet(&runtime->packets[(u32)packet_index]);
 			se_debug_trace_end_channel("render_queue_execute", SE_DEBUG_TRACE_CHANNEL_GPU);
 			const f64 execute_end = se_render_queue_now_seconds();
+			const u64 skipped = se_gl_state_cache_take_skipped();
 			s_mutex_lock(&runtime->mutex);
 			runtime->last_execute_ms = (execute_end - execute_begin) * 1000.0;
+			runtime->packets[(u32)packet_index].execute_ms = runtime->last_execute_ms;
+			runtime->redundant_state_skips += skipped;
+			runtime->last_redundant_state_skips = skipped;
+			se_render_queue_packet* executed = &runtime->packets[(u32)packet_index];
+			se_render_queue_drain_command_stats_locked(runtime, executed);
+			memcpy(runtime->last_command_stats, executed->command_stats, sizeof(runtime->last_command_stats));
+			memset(executed->command_stats, 0, sizeof(executed->command_stats));
+			se_render_capture_writer* capture_writer = runtime->capture_writer;
+			const u64 capture_frame = runtime->presented_frames;
+			runtime->capture_busy = capture_writer != NULL;
 			s_mutex_unlock(&runtime->mutex);
+
+			if (capture_writer) {
+				const se_render_queue_packet* packet = &runtime->packets[(u32)packet_index];
+				b8 captured = se_render_capture_write_frame_begin(capture_writer, capture_frame);
+				se_render_queue_capture_packet(capture_writer, packet);
+				captured = se_render_capture_write_frame_end(capture_writer, packet->execute_ms) && captured;
+				s_mutex_lock(&runtime->mutex);
+				runtime->capture_busy = false;
+				runtime->captured_frames += captured ? 1u : 0u;
+				if (!captured || (!runtime->capture_unbounded && --runtime->capture_frames_left == 0u)) {
+					se_render_queue_capture_close_locked(runtime);
+				}
+				s_cond_broadcast(&runtime->present_done);
+				s_mutex_unlock(&runtime->mutex);
+			}
 		}
 
 		if (do_present) {
@@ -402,8 +1283,18 @@ static void* se_render_queue_thread_main(void* user_data) {
 			s_mutex_lock(&runtime->mutex);
 			runtime->presented_frames++;
 			runtime->last_present_ms = (present_end - present_begin) * 1000.0;
-			if (packet_index >= 0 && (u32)packet_index < SE_RENDER_QUEUE_PACKET_COUNT) {
-				runtime->packets[(u32)packet_index].submitted = false;
+			if (packet_index >= 0 && (u32)packet_index < runtime->packet_count) {
+				se_render_queue_packet* packet = &runtime->packets[(u32)packet_index];
+				packet->latency_ms = (present_end - packet->submit_time) * 1000.0;
+				runtime->last_frame_latency_ms = packet->latency_ms;
+				runtime->pacing_stats.render_frame_ms = se_render_queue_smooth_ms(runtime->pacing_stats.render_frame_ms,
+					packet->execute_ms + runtime->last_present_ms);
+				// Blocks go back to the pool now rather than when the packet is recorded again.
+				se_render_queue_release_blocks(&runtime->block_pool, packet);
+				for (u32 i = 0u; i < packet->secondary_count; ++i) {
+					se_render_queue_release_blocks(&runtime->block_pool, &packet->secondaries[i]);
+				}
+				packet->submitted = false;
 			}
 			s_cond_broadcast(&runtime->present_done);
 			s_mutex_unlock(&runtime->mutex);
@@ -411,19 +1302,22 @@ static void* se_render_queue_thread_main(void* user_data) {
 		}
 	}
 
+	// The next thread to own the context cannot trust this thread's shadow state.
+	se_gl_state_cache_invalidate();
 	se_window_backend_render_thread_detach();
 	se_pop_tls_context(previous_context);
 
 	s_mutex_lock(&runtime->mutex);
 	runtime->running = false;
 	runtime->sync_completed = true;
-	runtime->present_pending = false;
-	runtime->pending_packet_index = -1;
-	for (u32 i = 0u; i < SE_RENDER_QUEUE_PACKET_COUNT; ++i) {
+	runtime->pending_packet_head = 0u;
+	runtime->pending_packet_count = 0u;
+	for (u32 i = 0u; i < SE_RENDER_THREAD_MAX_PACKET_COUNT; ++i) {
 		runtime->packets[i].submitted = false;
 	}
 	s_cond_broadcast(&runtime->sync_done);
 	s_cond_broadcast(&runtime->present_done);
+	s_cond_broadcast(&runtime->recording_done);
 	s_mutex_unlock(&runtime->mutex);
 	return NULL;
 }
@@ -442,9 +1336,57 @@ static void se_render_queue_reset_for_start(se_render_queue_runtime* runtime,
 	runtime->stopping = false;
 	runtime->failed = false;
 	runtime->frame_open = false;
-	runtime->wait_on_submit = cfg.wait_on_submit;
+	// Throughput mode exists to keep frames queued, so blocking on each present would defeat it.
+	runtime->wait_on_submit = cfg.wait_on_submit && cfg.mode != SE_RENDER_THREAD_MODE_THROUGHPUT;
+	runtime->mode = cfg.mode;
+	runtime->packet_count = cfg.packet_count > 0u ? cfg.packet_count : SE_RENDER_QUEUE_DEFAULT_PACKET_COUNT;
+	if (runtime->packet_count < SE_RENDER_THREAD_MIN_PACKET_COUNT) {
+		runtime->packet_count = SE_RENDER_THREAD_MIN_PACKET_COUNT;
+	}
+	if (runtime->packet_count > SE_RENDER_THREAD_MAX_PACKET_COUNT) {
+		runtime->packet_count = SE_RENDER_THREAD_MAX_PACKET_COUNT;
+	}
+	// One packet always stays free for recording; low latency keeps a single frame in flight.
+	runtime->max_frames_in_flight = cfg.mode == SE_RENDER_THREAD_MODE_THROUGHPUT ? runtime->packet_count - 1u : 1u;
+	runtime->pacing = cfg.pacing;
+	runtime->target_frames_in_flight = cfg.target_frames_in_flight;
+	runtime->latency_budget_ms = cfg.latency_budget_ms;
+	runtime->frame_begin_time = 0.0;
+	runtime->producer_period_ms = 0.0;
+	runtime->producer_blocked_ms = 0.0;
+	memset(&runtime->producer_thread_id, 0, sizeof(runtime->producer_thread_id));
+	memset(&runtime->pacing_stats, 0, sizeof(runtime->pacing_stats));
+	runtime->pacing_stats.pacing = cfg.pacing;
+	runtime->pacing_stats.frames_in_flight = runtime->max_frames_in_flight;
+	runtime->pacing_stats.wait_for_present = cfg.pacing == SE_RENDER_THREAD_PACING_FIXED && runtime->wait_on_submit;
 	runtime->max_commands_per_frame = cfg.max_commands_per_frame;
 	runtime->max_command_bytes_per_frame = cfg.max_command_bytes_per_frame;
+	runtime->max_secondary_packets = cfg.max_secondary_packets;
+	runtime->secondary_commands_per_packet = cfg.secondary_commands_per_packet;
+	runtime->secondary_command_bytes_per_packet = cfg.secondary_command_bytes_per_packet;
+	runtime->recording_secondaries = 0u;
+	runtime->pending_reservations = 0u;
+	runtime->block_pool.large_block_threshold = cfg.large_block_threshold > 0u ?
+		cfg.large_block_threshold : SE_RENDER_QUEUE_DEFAULT_LARGE_BLOCK_THRESHOLD;
+	runtime->block_pool.retain_bytes = cfg.block_pool_bytes;
+	runtime->block_pool.in_use_bytes = 0u;
+	runtime->block_pool.high_water_bytes = 0u;
+	runtime->block_pool.allocations = 0u;
+	runtime->block_pool.reuses = 0u;
+	runtime->payload_high_water_bytes = 0u;
+	runtime->proxy_names_created = 0u;
+	runtime->redundant_state_skips = 0u;
+	runtime->last_redundant_state_skips = 0u;
+	runtime->captured_frames = 0u;
+	memset(runtime->command_stats, 0, sizeof(runtime->command_stats));
+	memset(runtime->last_command_stats, 0, sizeof(runtime->last_command_stats));
+	runtime->sync_calls = 0u;
+	runtime->sync_stall_ms = 0.0;
+	runtime->frame_sync_calls = 0u;
+	runtime->frame_sync_stall_ms = 0.0;
+	runtime->last_sync_calls = 0u;
+	runtime->last_sync_stall_ms = 0.0;
+	runtime->last_sync_fn = NULL;
 	runtime->submitted_frames = 0u;
 	runtime->presented_frames = 0u;
 	runtime->submit_stalls = 0u;
@@ -452,32 +1394,44 @@ static void se_render_queue_reset_for_start(se_render_queue_runtime* runtime,
 	runtime->last_command_bytes = 0u;
 	runtime->current_command_count = 0u;
 	runtime->current_command_bytes = 0u;
+	runtime->last_secondary_packets = 0u;
+	runtime->last_secondary_command_count = 0u;
+	runtime->secondary_overflows = 0u;
 	runtime->last_submit_wait_ms = 0.0;
 	runtime->last_execute_ms = 0.0;
 	runtime->last_present_ms = 0.0;
+	runtime->last_frame_latency_ms = 0.0;
 	runtime->sync_fn = NULL;
 	runtime->sync_payload = NULL;
 	runtime->sync_out_result = NULL;
 	runtime->sync_pending = false;
 	runtime->sync_completed = true;
-	runtime->present_pending = false;
-	runtime->pending_packet_index = -1;
+	runtime->pending_packet_head = 0u;
+	runtime->pending_packet_count = 0u;
 	runtime->record_packet_index = 0u;
 	runtime->started_signal = false;
-	for (u32 i = 0u; i < SE_RENDER_QUEUE_PACKET_COUNT; ++i) {
+	for (u32 i = 0u; i < SE_RENDER_THREAD_MAX_PACKET_COUNT; ++i) {
 		runtime->packets[i].submitted = false;
+		runtime->packets[i].execute_ms = 0.0;
+		runtime->packets[i].latency_ms = 0.0;
+		memset(runtime->packets[i].command_stats, 0, sizeof(runtime->packets[i].command_stats));
 		se_render_queue_packet_reset(&runtime->packets[i]);
 	}
 	memset(&runtime->render_thread_id, 0, sizeof(runtime->render_thread_id));
 }
 
 b8 se_render_queue_start(const se_window_handle window, const se_render_thread_config* config) {
-	if (window == S_HANDLE_NULL) {
+	if (window == S_HANDLE_NULL ||
+		(config && config->pacing == SE_RENDER_THREAD_PACING_LATENCY_BUDGET && !(config->latency_budget_ms > 0.0))) {
 		se_set_last_error(SE_RESULT_INVALID_ARGUMENT);
 		return false;
 	}
 
 	se_render_queue_runtime* runtime = &g_render_queue;
+	if (runtime->replaying) {
+		se_set_last_error(SE_RESULT_UNSUPPORTED);
+		return false;
+	}
 	if (!runtime->initialized) {
 		if (!s_mutex_init(&runtime->mutex)) {
 			se_set_last_error(SE_RESULT_BACKEND_FAILURE);
@@ -501,7 +1455,38 @@ b8 se_render_queue_start(const se_window_handle window, const se_render_thread_c
 			se_set_last_error(SE_RESULT_BACKEND_FAILURE);
 			return false;
 		}
-		if (!s_cond_init(&runtime->present_done)) {
+		if (!s_cond_init(&runtime->present_done)) {
+			s_cond_destroy(&runtime->sync_done);
+			s_cond_destroy(&runtime->started);
+			s_cond_destroy(&runtime->work_ready);
+			s_mutex_destroy(&runtime->mutex);
+			se_set_last_error(SE_RESULT_BACKEND_FAILURE);
+			return false;
+		}
+		if (!s_cond_init(&runtime->recording_done)) {
+			s_cond_destroy(&runtime->present_done);
+			s_cond_destroy(&runtime->sync_done);
+			s_cond_destroy(&runtime->started);
+			s_cond_destroy(&runtime->work_ready);
+			s_mutex_destroy(&runtime->mutex);
+			se_set_last_error(SE_RESULT_BACKEND_FAILURE);
+			return false;
+		}
+		if (!s_mutex_init(&runtime->block_pool.mutex)) {
+			s_cond_destroy(&runtime->recording_done);
+			s_cond_destroy(&runtime->present_done);
+			s_cond_destroy(&runtime->sync_done);
+			s_cond_destroy(&runtime->started);
+			s_cond_destroy(&runtime->work_ready);
+			s_mutex_destroy(&runtime->mutex);
+			se_set_last_error(SE_RESULT_BACKEND_FAILURE);
+			return false;
+		}
+#if defined(SE_RENDER_QUEUE_VALIDATION)
+		if (!s_mutex_init(&g_se_render_queue_validation.mutex)) {
+			s_mutex_destroy(&runtime->block_pool.mutex);
+			s_cond_destroy(&runtime->recording_done);
+			s_cond_destroy(&runtime->present_done);
 			s_cond_destroy(&runtime->sync_done);
 			s_cond_destroy(&runtime->started);
 			s_cond_destroy(&runtime->work_ready);
@@ -509,6 +1494,7 @@ b8 se_render_queue_start(const se_window_handle window, const se_render_thread_c
 			se_set_last_error(SE_RESULT_BACKEND_FAILURE);
 			return false;
 		}
+#endif
 		runtime->initialized = true;
 	}
 
@@ -519,6 +1505,10 @@ b8 se_render_queue_start(const se_window_handle window, const se_render_thread_c
 		return false;
 	}
 	se_render_queue_reset_for_start(runtime, window, config);
+	se_render_queue_build_command_table(runtime);
+#if defined(SE_RENDER_QUEUE_VALIDATION)
+	se_render_queue_validation_reset();
+#endif
 	if (!se_render_queue_allocate_packets(runtime)) {
 		s_mutex_unlock(&runtime->mutex);
 		se_set_last_error(SE_RESULT_BACKEND_FAILURE);
@@ -569,6 +1559,7 @@ void se_render_queue_stop(const se_window_handle window) {
 	s_cond_broadcast(&runtime->work_ready);
 	s_cond_broadcast(&runtime->sync_done);
 	s_cond_broadcast(&runtime->present_done);
+	s_cond_broadcast(&runtime->recording_done);
 	s_mutex_unlock(&runtime->mutex);
 
 	(void)s_thread_join(&runtime->thread, NULL);
@@ -578,8 +1569,11 @@ void se_render_queue_stop(const se_window_handle window) {
 	runtime->window = S_HANDLE_NULL;
 	runtime->context = NULL;
 	runtime->frame_open = false;
-	runtime->pending_packet_index = -1;
+	runtime->pending_packet_head = 0u;
+	runtime->pending_packet_count = 0u;
 	se_render_queue_release_packets(runtime);
+	se_render_queue_clear_block_pool(&runtime->block_pool);
+	se_render_queue_capture_close_locked(runtime);
 	s_mutex_unlock(&runtime->mutex);
 }
 
@@ -645,8 +1639,7 @@ void se_render_queue_wait_idle(const se_window_handle window) {
 	while (!runtime->sync_completed ||
 		runtime->sync_pending ||
 		runtime->submitted_frames > runtime->presented_frames ||
-		runtime->present_pending ||
-		runtime->pending_packet_index >= 0) {
+		runtime->pending_packet_count > 0u) {
 		if (!runtime->sync_completed || runtime->sync_pending) {
 			s_cond_wait(&runtime->sync_done, &runtime->mutex);
 		} else {
@@ -684,10 +1677,56 @@ b8 se_render_queue_get_diagnostics(const se_window_handle window, se_render_thre
 	out_diag->queue_depth = se_render_queue_depth_locked(runtime);
 	out_diag->last_command_count = runtime->last_command_count;
 	out_diag->last_command_bytes = runtime->last_command_bytes;
+	out_diag->last_secondary_packets = runtime->last_secondary_packets;
+	out_diag->last_secondary_command_count = runtime->last_secondary_command_count;
+	out_diag->secondary_overflows = runtime->secondary_overflows;
+	out_diag->payload_high_water_bytes = runtime->payload_high_water_bytes;
+	out_diag->proxy_names_created = runtime->proxy_names_created;
+	out_diag->live_proxy_names = runtime->live_proxies;
+	out_diag->redundant_state_skips = runtime->redundant_state_skips;
+	out_diag->captured_frames = runtime->captured_frames;
+	memcpy(out_diag->command_stats, runtime->command_stats, sizeof(out_diag->command_stats));
+	memcpy(out_diag->last_command_stats, runtime->last_command_stats, sizeof(out_diag->last_command_stats));
+	out_diag->sync_calls = runtime->sync_calls;
+	out_diag->sync_stall_ms = runtime->sync_stall_ms;
+	out_diag->last_sync_calls = runtime->last_sync_calls;
+	out_diag->last_sync_stall_ms = runtime->last_sync_stall_ms;
+	const se_render_queue_command_info* last_sync = se_render_queue_find_command(runtime->last_sync_fn);
+	out_diag->last_sync_command = last_sync ? last_sync->name : NULL;
+	out_diag->capturing = runtime->capture_writer != NULL;
+	out_diag->last_redundant_state_skips = runtime->last_redundant_state_skips;
+	s_mutex_lock(&runtime->block_pool.mutex);
+	out_diag->block_bytes_in_use = runtime->block_pool.in_use_bytes;
+	out_diag->block_high_water_bytes = runtime->block_pool.high_water_bytes;
+	out_diag->block_pool_bytes = runtime->block_pool.pool_bytes;
+	out_diag->block_allocations = runtime->block_pool.allocations;
+	out_diag->block_reuses = runtime->block_pool.reuses;
+	s_mutex_unlock(&runtime->block_pool.mutex);
 	out_diag->last_submit_wait_ms = runtime->last_submit_wait_ms;
 	out_diag->last_execute_ms = runtime->last_execute_ms;
 	out_diag->last_present_ms = runtime->last_present_ms;
+	out_diag->last_frame_latency_ms = runtime->last_frame_latency_ms;
+	out_diag->packet_count = runtime->packet_count;
+	out_diag->max_frames_in_flight = runtime->max_frames_in_flight;
+	for (u32 i = 0u; i < SE_RENDER_THREAD_MAX_PACKET_COUNT; ++i) {
+		out_diag->packet_execute_ms[i] = i < runtime->packet_count ? runtime->packets[i].execute_ms : 0.0;
+		out_diag->packet_latency_ms[i] = i < runtime->packet_count ? runtime->packets[i].latency_ms : 0.0;
+	}
+	out_diag->pacing = runtime->pacing_stats;
 	s_mutex_unlock(&runtime->mutex);
+#if defined(SE_RENDER_QUEUE_VALIDATION)
+	s_mutex_lock(&g_se_render_queue_validation.mutex);
+	out_diag->validation_errors = g_se_render_queue_validation.errors;
+	out_diag->last_validation_command = g_se_render_queue_validation.last_command;
+	out_diag->last_validation_tag = g_se_render_queue_validation.last_tag;
+	out_diag->last_validation_site = g_se_render_queue_validation.last_site;
+	s_mutex_unlock(&g_se_render_queue_validation.mutex);
+#else
+	out_diag->validation_errors = 0u;
+	out_diag->last_validation_command = NULL;
+	out_diag->last_validation_tag = NULL;
+	out_diag->last_validation_site = NULL;
+#endif
 
 	se_set_last_error(SE_RESULT_OK);
 	return true;
@@ -700,6 +1739,7 @@ void se_render_queue_begin_frame(const se_window_handle window) {
 		return;
 	}
 
+	const f64 begin_time = se_render_queue_now_seconds();
 	s_mutex_lock(&runtime->mutex);
 	if (!runtime->running || runtime->window != window || runtime->failed || runtime->frame_open) {
 		s_mutex_unlock(&runtime->mutex);
@@ -708,14 +1748,17 @@ void se_render_queue_begin_frame(const se_window_handle window) {
 	}
 
 	u32 packet_index = runtime->record_packet_index;
-	if (packet_index >= SE_RENDER_QUEUE_PACKET_COUNT) {
+	if (packet_index >= runtime->packet_count) {
 		packet_index = 0u;
 	}
+	f64 packet_wait_ms = 0.0;
 	if (runtime->packets[packet_index].submitted) {
-		packet_index = (packet_index + 1u) % SE_RENDER_QUEUE_PACKET_COUNT;
+		packet_index = (packet_index + 1u) % runtime->packet_count;
+		const f64 packet_wait_begin = se_render_queue_now_seconds();
 		while (runtime->packets[packet_index].submitted && runtime->running && !runtime->failed) {
 			s_cond_wait(&runtime->present_done, &runtime->mutex);
 		}
+		packet_wait_ms = (se_render_queue_now_seconds() - packet_wait_begin) * 1000.0;
 		if (!runtime->running || runtime->failed) {
 			s_mutex_unlock(&runtime->mutex);
 			se_set_last_error(SE_RESULT_BACKEND_FAILURE);
@@ -725,9 +1768,20 @@ void se_render_queue_begin_frame(const se_window_handle window) {
 
 	runtime->record_packet_index = packet_index;
 	se_render_queue_packet_reset(&runtime->packets[packet_index]);
+	se_render_queue_reset_secondaries(&runtime->packets[packet_index]);
 	runtime->frame_open = true;
 	runtime->current_command_count = 0u;
 	runtime->current_command_bytes = 0u;
+	// Pacing wants the producer's own work: begin to begin minus every wait on the render thread
+	// (free packets, submit depth, present and sync calls), or a render-bound frame reads as slow CPU.
+	if (runtime->frame_begin_time > 0.0) {
+		const f64 work_ms = (begin_time - runtime->frame_begin_time) * 1000.0 - runtime->producer_blocked_ms;
+		runtime->producer_period_ms = work_ms > 0.0 ? work_ms : 0.0;
+	}
+	runtime->frame_begin_time = begin_time;
+	// This frame's packet wait happened after `begin_time`, so it belongs to the next period.
+	runtime->producer_blocked_ms = packet_wait_ms;
+	runtime->producer_thread_id = s_thread_current_id();
 	s_mutex_unlock(&runtime->mutex);
 	se_set_last_error(SE_RESULT_OK);
 }
@@ -741,14 +1795,28 @@ void se_render_queue_submit_frame(const se_window_handle window) {
 
 	const f64 wait_begin = se_render_queue_now_seconds();
 	f64 wait_end = wait_begin;
+	// A thread still bound to a secondary would wait on its own recording below.
+	if (g_se_render_queue_tls_secondary || g_se_render_queue_tls_reservation.active) {
+		se_set_last_error(SE_RESULT_UNSUPPORTED);
+		return;
+	}
 	s_mutex_lock(&runtime->mutex);
 	if (!runtime->running || runtime->window != window || runtime->failed || !runtime->frame_open) {
 		s_mutex_unlock(&runtime->mutex);
 		se_set_last_error(SE_RESULT_BACKEND_FAILURE);
 		return;
 	}
+	se_render_queue_wait_recorders_locked(runtime);
+	// The first frame has no previous begin, so its recording time stands in for the period.
+	if (runtime->producer_period_ms > 0.0) {
+		se_render_queue_update_pacing_locked(runtime, runtime->producer_period_ms);
+	} else {
+		const f64 recording_ms = (wait_begin - runtime->frame_begin_time) * 1000.0 - runtime->producer_blocked_ms;
+		se_render_queue_update_pacing_locked(runtime, recording_ms > 0.0 ? recording_ms : 0.0);
+	}
 
-	while (runtime->submitted_frames > runtime->presented_frames) {
+	const f64 depth_wait_begin = se_render_queue_now_seconds();
+	while (se_render_queue_depth_locked(runtime) >= runtime->max_frames_in_flight) {
 		runtime->submit_stalls++;
 		s_cond_wait(&runtime->present_done, &runtime->mutex);
 		if (!runtime->running || runtime->failed) {
@@ -759,9 +1827,10 @@ void se_render_queue_submit_frame(const se_window_handle window) {
 	}
 	wait_end = se_render_queue_now_seconds();
 	runtime->last_submit_wait_ms = (wait_end - wait_begin) * 1000.0;
+	runtime->producer_blocked_ms += (wait_end - depth_wait_begin) * 1000.0;
 
 	const u32 packet_index = runtime->record_packet_index;
-	if (packet_index >= SE_RENDER_QUEUE_PACKET_COUNT) {
+	if (packet_index >= runtime->packet_count) {
 		s_mutex_unlock(&runtime->mutex);
 		se_set_last_error(SE_RESULT_BACKEND_FAILURE);
 		return;
@@ -773,19 +1842,53 @@ void se_render_queue_submit_frame(const se_window_handle window) {
 		return;
 	}
 
+	// Slots not spliced explicitly are appended in slot order so the frame is deterministic
+	// regardless of which worker finished first.
+	u32 secondary_packets = 0u;
+	u64 secondary_commands = 0u;
+	for (u32 i = 0u; i < packet->secondary_count; ++i) {
+		se_render_queue_packet* secondary = &packet->secondaries[i];
+		if (secondary->command_count == 0u) {
+			continue;
+		}
+		if (!secondary->spliced && !se_render_queue_splice_secondary_locked(runtime, packet, i)) {
+			runtime->secondary_overflows++;
+			se_render_queue_packet_reset(secondary);
+			continue;
+		}
+		secondary_packets++;
+		secondary_commands += secondary->command_count;
+		if (secondary->payload_used > runtime->payload_high_water_bytes) {
+			runtime->payload_high_water_bytes = secondary->payload_used;
+		}
+	}
+	if (packet->payload_used > runtime->payload_high_water_bytes) {
+		runtime->payload_high_water_bytes = packet->payload_used;
+	}
+
 	runtime->frame_open = false;
 	packet->submitted = true;
 	runtime->submitted_frames++;
 	runtime->last_command_count = packet->command_count;
 	runtime->last_command_bytes = packet->payload_used;
-	runtime->pending_packet_index = (i32)packet_index;
-	runtime->present_pending = true;
+	runtime->last_secondary_packets = secondary_packets;
+	runtime->last_secondary_command_count = secondary_commands;
+	runtime->last_sync_calls = runtime->frame_sync_calls;
+	runtime->last_sync_stall_ms = runtime->frame_sync_stall_ms;
+	runtime->frame_sync_calls = 0u;
+	runtime->frame_sync_stall_ms = 0.0;
+	packet->submit_time = se_render_queue_now_seconds();
+	const u32 pending_tail = (runtime->pending_packet_head + runtime->pending_packet_count) % SE_RENDER_THREAD_MAX_PACKET_COUNT;
+	runtime->pending_packets[pending_tail] = packet_index;
+	runtime->pending_packet_count++;
 	s_cond_signal(&runtime->work_ready);
 
-	if (runtime->wait_on_submit) {
+	if (runtime->pacing_stats.wait_for_present) {
+		const f64 present_wait_begin = se_render_queue_now_seconds();
 		while (runtime->submitted_frames > runtime->presented_frames) {
 			s_cond_wait(&runtime->present_done, &runtime->mutex);
 		}
+		runtime->producer_blocked_ms += (se_render_queue_now_seconds() - present_wait_begin) * 1000.0;
 	}
 	s_mutex_unlock(&runtime->mutex);
 	se_set_last_error(SE_RESULT_OK);
@@ -832,9 +1935,22 @@ b8 se_render_queue_get_frame_stats(const se_window_handle window, se_render_fram
 	out_stats->queue_depth = se_render_queue_depth_locked(runtime);
 	out_stats->last_command_count = runtime->last_command_count;
 	out_stats->last_command_bytes = runtime->last_command_bytes;
+	out_stats->last_secondary_packets = runtime->last_secondary_packets;
+	out_stats->last_secondary_command_count = runtime->last_secondary_command_count;
 	out_stats->last_submit_wait_ms = runtime->last_submit_wait_ms;
 	out_stats->last_execute_ms = runtime->last_execute_ms;
 	out_stats->last_present_ms = runtime->last_present_ms;
+	out_stats->last_frame_latency_ms = runtime->last_frame_latency_ms;
+	out_stats->packet_count = runtime->packet_count;
+	out_stats->max_frames_in_flight = runtime->max_frames_in_flight;
+	for (u32 i = 0u; i < SE_RENDER_THREAD_MAX_PACKET_COUNT; ++i) {
+		out_stats->packet_execute_ms[i] = i < runtime->packet_count ? runtime->packets[i].execute_ms : 0.0;
+		out_stats->packet_latency_ms[i] = i < runtime->packet_count ? runtime->packets[i].latency_ms : 0.0;
+	}
+	memcpy(out_stats->last_command_stats, runtime->last_command_stats, sizeof(out_stats->last_command_stats));
+	out_stats->last_sync_calls = runtime->last_sync_calls;
+	out_stats->last_sync_stall_ms = runtime->last_sync_stall_ms;
+	out_stats->pacing = runtime->pacing_stats;
 	s_mutex_unlock(&runtime->mutex);
 
 	se_set_last_error(SE_RESULT_OK);
@@ -852,12 +1968,18 @@ b8 se_render_queue_call_sync_sized(const se_render_queue_sync_fn fn, const void*
 		se_set_last_error(SE_RESULT_UNSUPPORTED);
 		return false;
 	}
+	if (g_se_render_queue_tls_secondary || g_se_render_queue_tls_reservation.active) {
+		// A round-trip would run ahead of the secondary's or the reservation's own commands.
+		se_set_last_error(SE_RESULT_UNSUPPORTED);
+		return false;
+	}
 	if (se_render_queue_is_render_thread()) {
 		fn(payload, out_result);
 		se_set_last_error(SE_RESULT_OK);
 		return true;
 	}
 
+	const f64 stall_begin = se_render_queue_now_seconds();
 	s_mutex_lock(&runtime->mutex);
 	if (!runtime->running || runtime->failed || runtime->stopping) {
 		s_mutex_unlock(&runtime->mutex);
@@ -865,7 +1987,7 @@ b8 se_render_queue_call_sync_sized(const se_render_queue_sync_fn fn, const void*
 		return false;
 	}
 
-	while (runtime->submitted_frames > runtime->presented_frames || runtime->present_pending) {
+	while (runtime->submitted_frames > runtime->presented_frames || runtime->pending_packet_count > 0u) {
 		s_cond_wait(&runtime->present_done, &runtime->mutex);
 		if (!runtime->running || runtime->failed || runtime->stopping) {
 			s_mutex_unlock(&runtime->mutex);
@@ -883,9 +2005,10 @@ b8 se_render_queue_call_sync_sized(const se_render_queue_sync_fn fn, const void*
 		}
 	}
 
-	if (runtime->frame_open && runtime->record_packet_index < SE_RENDER_QUEUE_PACKET_COUNT) {
+	if (runtime->frame_open && runtime->record_packet_index < runtime->packet_count) {
 		se_render_queue_packet* packet = &runtime->packets[runtime->record_packet_index];
 		if (packet->command_count > 0u) {
+			se_render_queue_wait_recorders_locked(runtime);
 			const se_render_queue_flush_payload flush_payload = {
 				.packet = packet
 			};
@@ -895,6 +2018,12 @@ b8 se_render_queue_call_sync_sized(const se_render_queue_sync_fn fn, const void*
 				return false;
 			}
 			se_render_queue_packet_reset(packet);
+			for (u32 i = 0u; i < packet->secondary_count; ++i) {
+				if (packet->secondaries[i].spliced) {
+					se_render_queue_packet_reset(&packet->secondaries[i]);
+					packet->secondaries[i].spliced = false;
+				}
+			}
 			runtime->current_command_count = 0u;
 			runtime->current_command_bytes = 0u;
 		}
@@ -903,6 +2032,29 @@ b8 se_render_queue_call_sync_sized(const se_render_queue_sync_fn fn, const void*
 	}
 
 	const b8 ok = se_render_queue_dispatch_sync_locked(runtime, fn, payload, out_result);
+	if (ok) {
+		// The caller's whole wait counts as stall: draining in-flight frames, the flush and the call.
+		const f64 stall_ms = (se_render_queue_now_seconds() - stall_begin) * 1000.0;
+		se_render_thread_command_stats* sync_stats = &runtime->command_stats[SE_RENDER_THREAD_COMMAND_SYNC];
+		sync_stats->count++;
+		sync_stats->payload_bytes += payload_bytes;
+		sync_stats->execute_ms += runtime->last_execute_ms;
+		se_render_queue_packet* open_packet = se_render_queue_open_packet_locked(runtime);
+		if (open_packet) {
+			se_render_thread_command_stats* frame_sync_stats = &open_packet->command_stats[SE_RENDER_THREAD_COMMAND_SYNC];
+			frame_sync_stats->count++;
+			frame_sync_stats->payload_bytes += payload_bytes;
+			frame_sync_stats->execute_ms += runtime->last_execute_ms;
+		}
+		runtime->sync_calls++;
+		runtime->sync_stall_ms += stall_ms;
+		runtime->frame_sync_calls++;
+		runtime->frame_sync_stall_ms += stall_ms;
+		if (runtime->frame_open && s_thread_id_equal(s_thread_current_id(), runtime->producer_thread_id)) {
+			runtime->producer_blocked_ms += stall_ms;
+		}
+		runtime->last_sync_fn = fn;
+	}
 	s_mutex_unlock(&runtime->mutex);
 
 	se_set_last_error(ok ? SE_RESULT_OK : SE_RESULT_BACKEND_FAILURE);
@@ -929,6 +2081,23 @@ b8 se_render_queue_record_async_blob(const se_render_queue_sync_fn fn,
 		se_set_last_error(SE_RESULT_UNSUPPORTED);
 		return false;
 	}
+#if defined(SE_RENDER_QUEUE_VALIDATION)
+	se_render_queue_validate_payload(fn, payload_bytes);
+#endif
+	se_render_queue_packet* secondary = g_se_render_queue_tls_secondary;
+	if (secondary) {
+		// The bound secondary is owned by this thread until it ends, so no lock is taken.
+		if (!se_render_queue_validate_record(fn, payload, payload_bytes, pointer_patch_offset, blob, blob_bytes)) {
+			return false;
+		}
+		if (!se_render_queue_packet_append(secondary, fn, payload, payload_bytes, pointer_patch_offset, blob, blob_bytes, NULL)) {
+			s_mutex_lock(&runtime->mutex);
+			runtime->secondary_overflows++;
+			s_mutex_unlock(&runtime->mutex);
+			return false;
+		}
+		return true;
+	}
 	if (se_render_queue_is_render_thread()) {
 		if (payload_bytes > 0u && payload == NULL) {
 			se_set_last_error(SE_RESULT_INVALID_ARGUMENT);
@@ -959,3 +2128,396 @@ b8 se_render_queue_record_async(const se_render_queue_sync_fn fn, const void* pa
 		NULL,
 		0u);
 }
+
+b8 se_render_queue_secondary_begin(const se_window_handle window, const u32 slot) {
+	se_render_queue_runtime* runtime = &g_render_queue;
+	if (!runtime->initialized) {
+		se_set_last_error(SE_RESULT_UNSUPPORTED);
+		return false;
+	}
+	if (g_se_render_queue_tls_secondary) {
+		se_set_last_error(SE_RESULT_UNSUPPORTED);
+		return false;
+	}
+
+	s_mutex_lock(&runtime->mutex);
+	if (!runtime->running || runtime->window != window || runtime->failed || runtime->stopping) {
+		s_mutex_unlock(&runtime->mutex);
+		se_set_last_error(SE_RESULT_BACKEND_FAILURE);
+		return false;
+	}
+	if (!runtime->frame_open || runtime->record_packet_index >= runtime->packet_count) {
+		s_mutex_unlock(&runtime->mutex);
+		se_set_last_error(SE_RESULT_UNSUPPORTED);
+		return false;
+	}
+	se_render_queue_packet* packet = &runtime->packets[runtime->record_packet_index];
+	if (slot >= packet->secondary_count) {
+		s_mutex_unlock(&runtime->mutex);
+		se_set_last_error(SE_RESULT_INVALID_ARGUMENT);
+		return false;
+	}
+	se_render_queue_packet* secondary = &packet->secondaries[slot];
+	if (secondary->recording) {
+		s_mutex_unlock(&runtime->mutex);
+		se_set_last_error(SE_RESULT_UNSUPPORTED);
+		return false;
+	}
+	if (!se_render_queue_allocate_secondary(runtime, secondary)) {
+		s_mutex_unlock(&runtime->mutex);
+		se_set_last_error(SE_RESULT_OUT_OF_MEMORY);
+		return false;
+	}
+	secondary->recording = true;
+	runtime->recording_secondaries++;
+	s_mutex_unlock(&runtime->mutex);
+
+	g_se_render_queue_tls_secondary = secondary;
+	se_set_last_error(SE_RESULT_OK);
+	return true;
+}
+
+b8 se_render_queue_secondary_end(void) {
+	se_render_queue_runtime* runtime = &g_render_queue;
+	se_render_queue_packet* secondary = g_se_render_queue_tls_secondary;
+	if (!runtime->initialized || !secondary || g_se_render_queue_tls_reservation.active) {
+		se_set_last_error(SE_RESULT_UNSUPPORTED);
+		return false;
+	}
+	g_se_render_queue_tls_secondary = NULL;
+
+	s_mutex_lock(&runtime->mutex);
+	secondary->recording = false;
+	if (runtime->recording_secondaries > 0u) {
+		runtime->recording_secondaries--;
+	}
+	s_cond_broadcast(&runtime->recording_done);
+	s_mutex_unlock(&runtime->mutex);
+	se_set_last_error(SE_RESULT_OK);
+	return true;
+}
+
+b8 se_render_queue_is_recording_secondary(void) {
+	return g_se_render_queue_tls_secondary != NULL;
+}
+
+b8 se_render_queue_record_secondary(const se_window_handle window, const u32 slot) {
+	se_render_queue_runtime* runtime = &g_render_queue;
+	if (!runtime->initialized || g_se_render_queue_tls_secondary) {
+		se_set_last_error(SE_RESULT_UNSUPPORTED);
+		return false;
+	}
+
+	s_mutex_lock(&runtime->mutex);
+	if (!runtime->running || runtime->window != window || runtime->failed || runtime->stopping) {
+		s_mutex_unlock(&runtime->mutex);
+		se_set_last_error(SE_RESULT_BACKEND_FAILURE);
+		return false;
+	}
+	if (!runtime->frame_open || runtime->record_packet_index >= runtime->packet_count) {
+		s_mutex_unlock(&runtime->mutex);
+		se_set_last_error(SE_RESULT_UNSUPPORTED);
+		return false;
+	}
+	se_render_queue_packet* packet = &runtime->packets[runtime->record_packet_index];
+	if (slot >= packet->secondary_count) {
+		s_mutex_unlock(&runtime->mutex);
+		se_set_last_error(SE_RESULT_INVALID_ARGUMENT);
+		return false;
+	}
+	if (packet->secondaries[slot].spliced) {
+		s_mutex_unlock(&runtime->mutex);
+		se_set_last_error(SE_RESULT_OK);
+		return true;
+	}
+	const b8 ok = se_render_queue_splice_secondary_locked(runtime, packet, slot);
+	s_mutex_unlock(&runtime->mutex);
+	return ok;
+}
+
+void* se_render_queue_reserve_blob(const se_render_queue_sync_fn fn,
+	const void* payload,
+	const u32 payload_bytes,
+	const u32 pointer_patch_offset,
+	const u32 blob_bytes) {
+	se_render_queue_reservation* reservation = &g_se_render_queue_tls_reservation;
+	if (!fn || blob_bytes == 0u || (payload_bytes > 0u && payload == NULL) ||
+		pointer_patch_offset == SE_RENDER_QUEUE_POINTER_PATCH_NONE ||
+		pointer_patch_offset + (u32)sizeof(void*) > payload_bytes) {
+		se_set_last_error(SE_RESULT_INVALID_ARGUMENT);
+		return NULL;
+	}
+	if (reservation->active) {
+		se_set_last_error(SE_RESULT_UNSUPPORTED);
+		return NULL;
+	}
+	memset(reservation, 0, sizeof(*reservation));
+	reservation->fn = fn;
+#if defined(SE_RENDER_QUEUE_VALIDATION)
+	if (g_render_queue.initialized) {
+		se_render_queue_validate_payload(fn, payload_bytes);
+	}
+#endif
+
+	se_render_queue_runtime* runtime = &g_render_queue;
+	se_render_queue_packet* secondary = g_se_render_queue_tls_secondary;
+	if (secondary) {
+		if (!se_render_queue_packet_append(secondary, NULL, payload, payload_bytes, pointer_patch_offset, NULL, blob_bytes, &reservation->blob)) {
+			return NULL;
+		}
+		reservation->packet = secondary;
+		reservation->command_index = secondary->command_count - 1u;
+		reservation->secondary = true;
+		reservation->active = true;
+		return reservation->blob;
+	}
+
+	if (!se_render_queue_is_running() || se_render_queue_is_render_thread()) {
+		// Direct mode: the command runs at commit from a scratch copy of the payload.
+		const u32 blob_offset = se_render_queue_align_up(payload_bytes, SE_RENDER_QUEUE_ALIGN_BYTES);
+		reservation->scratch = (u8*)malloc((sz)blob_offset + (sz)blob_bytes);
+		if (!reservation->scratch) {
+			se_set_last_error(SE_RESULT_OUT_OF_MEMORY);
+			return NULL;
+		}
+		memcpy(reservation->scratch, payload, payload_bytes);
+		reservation->blob = reservation->scratch + blob_offset;
+		*(void**)(reservation->scratch + pointer_patch_offset) = reservation->blob;
+		reservation->active = true;
+		se_set_last_error(SE_RESULT_OK);
+		return reservation->blob;
+	}
+
+	s_mutex_lock(&runtime->mutex);
+	se_render_queue_packet* packet = se_render_queue_record_packet_locked(runtime);
+	if (!packet || !se_render_queue_packet_append(packet, NULL, payload, payload_bytes, pointer_patch_offset, NULL, blob_bytes, &reservation->blob)) {
+		s_mutex_unlock(&runtime->mutex);
+		return NULL;
+	}
+	runtime->current_command_count = packet->command_count;
+	runtime->current_command_bytes = packet->payload_used;
+	runtime->pending_reservations++;
+	s_mutex_unlock(&runtime->mutex);
+	reservation->packet = packet;
+	reservation->command_index = packet->command_count - 1u;
+	reservation->active = true;
+	return reservation->blob;
+}
+
+b8 se_render_queue_commit_blob(void* blob) {
+	se_render_queue_reservation* reservation = &g_se_render_queue_tls_reservation;
+	if (!reservation->active || blob != reservation->blob) {
+		se_set_last_error(SE_RESULT_INVALID_ARGUMENT);
+		return false;
+	}
+	reservation->active = false;
+
+	if (reservation->scratch) {
+		reservation->fn(reservation->scratch, NULL);
+		free(reservation->scratch);
+		reservation->scratch = NULL;
+		se_set_last_error(SE_RESULT_OK);
+		return true;
+	}
+	// The command was appended without a function, so its kind is only known now.
+	se_render_queue_command* command = &reservation->packet->commands[reservation->command_index];
+	if (reservation->secondary) {
+		command->fn = reservation->fn;
+		command->kind = se_render_queue_command_kind(reservation->fn);
+		se_set_last_error(SE_RESULT_OK);
+		return true;
+	}
+
+	se_render_queue_runtime* runtime = &g_render_queue;
+	s_mutex_lock(&runtime->mutex);
+	command->fn = reservation->fn;
+	command->kind = se_render_queue_command_kind(reservation->fn);
+	if (runtime->pending_reservations > 0u) {
+		runtime->pending_reservations--;
+	}
+	s_cond_broadcast(&runtime->recording_done);
+	s_mutex_unlock(&runtime->mutex);
+	se_set_last_error(SE_RESULT_OK);
+	return true;
+}
+
+u32 se_render_queue_proxy_reserve(void) {
+	se_render_queue_runtime* runtime = &g_render_queue;
+	if (!runtime->initialized) {
+		return 0u;
+	}
+	s_mutex_lock(&runtime->mutex);
+	if (!runtime->running || runtime->failed) {
+		s_mutex_unlock(&runtime->mutex);
+		return 0u;
+	}
+	u32 index = 0u;
+	if (runtime->proxy_free_count > 0u) {
+		index = runtime->proxy_free[--runtime->proxy_free_count];
+	} else {
+		if (runtime->proxy_next >= SE_RENDER_QUEUE_PROXY_CHUNK_SIZE * SE_RENDER_QUEUE_PROXY_CHUNK_COUNT) {
+			s_mutex_unlock(&runtime->mutex);
+			return 0u;
+		}
+		index = runtime->proxy_next;
+		const u32 chunk = index / SE_RENDER_QUEUE_PROXY_CHUNK_SIZE;
+		if (!runtime->proxy_chunks[chunk]) {
+			runtime->proxy_chunks[chunk] = (u32*)calloc(SE_RENDER_QUEUE_PROXY_CHUNK_SIZE, sizeof(u32));
+			if (!runtime->proxy_chunks[chunk]) {
+				s_mutex_unlock(&runtime->mutex);
+				return 0u;
+			}
+		}
+		runtime->proxy_next++;
+	}
+	runtime->proxy_chunks[index / SE_RENDER_QUEUE_PROXY_CHUNK_SIZE][index % SE_RENDER_QUEUE_PROXY_CHUNK_SIZE] = 0u;
+	runtime->live_proxies++;
+	runtime->proxy_names_created++;
+	s_mutex_unlock(&runtime->mutex);
+#if defined(SE_RENDER_QUEUE_VALIDATION)
+	se_render_queue_validation_forget_proxy(SE_RENDER_QUEUE_PROXY_BIT | index);
+#endif
+	return SE_RENDER_QUEUE_PROXY_BIT | index;
+}
+
+void se_render_queue_proxy_bind(const u32 proxy, const u32 value) {
+	if ((proxy & SE_RENDER_QUEUE_PROXY_BIT) == 0u) {
+		return;
+	}
+	const u32 index = proxy & ~SE_RENDER_QUEUE_PROXY_BIT;
+	if (index >= SE_RENDER_QUEUE_PROXY_CHUNK_SIZE * SE_RENDER_QUEUE_PROXY_CHUNK_COUNT) {
+		return;
+	}
+	if (g_render_queue.replaying) {
+		u32** replay_chunk = &g_render_queue.replay_proxy_chunks[index / SE_RENDER_QUEUE_PROXY_CHUNK_SIZE];
+		if (!*replay_chunk) {
+			*replay_chunk = (u32*)calloc(SE_RENDER_QUEUE_PROXY_CHUNK_SIZE, sizeof(u32));
+		}
+		if (*replay_chunk) {
+			(*replay_chunk)[index % SE_RENDER_QUEUE_PROXY_CHUNK_SIZE] = value;
+		}
+		return;
+	}
+	u32* chunk = g_render_queue.proxy_chunks[index / SE_RENDER_QUEUE_PROXY_CHUNK_SIZE];
+	if (chunk) {
+		chunk[index % SE_RENDER_QUEUE_PROXY_CHUNK_SIZE] = value;
+	}
+}
+
+u32 se_render_queue_proxy_resolve(const u32 name) {
+	if ((name & SE_RENDER_QUEUE_PROXY_BIT) == 0u) {
+		return name;
+	}
+	const u32 index = name & ~SE_RENDER_QUEUE_PROXY_BIT;
+	if (index >= SE_RENDER_QUEUE_PROXY_CHUNK_SIZE * SE_RENDER_QUEUE_PROXY_CHUNK_COUNT) {
+		return 0u;
+	}
+	if (g_render_queue.replaying) {
+		const u32* replay_chunk = g_render_queue.replay_proxy_chunks[index / SE_RENDER_QUEUE_PROXY_CHUNK_SIZE];
+		const u32 value = replay_chunk ? replay_chunk[index % SE_RENDER_QUEUE_PROXY_CHUNK_SIZE] : 0u;
+		if (value != 0u) {
+			return value;
+		}
+	}
+	const u32* chunk = g_render_queue.proxy_chunks[index / SE_RENDER_QUEUE_PROXY_CHUNK_SIZE];
+	return chunk ? chunk[index % SE_RENDER_QUEUE_PROXY_CHUNK_SIZE] : 0u;
+}
+
+void se_render_queue_proxy_release(const u32 proxy) {
+	se_render_queue_runtime* runtime = &g_render_queue;
+	if ((proxy & SE_RENDER_QUEUE_PROXY_BIT) == 0u || !runtime->initialized) {
+		return;
+	}
+	const u32 index = proxy & ~SE_RENDER_QUEUE_PROXY_BIT;
+	s_mutex_lock(&runtime->mutex);
+	if (index >= runtime->proxy_next) {
+		s_mutex_unlock(&runtime->mutex);
+		return;
+	}
+	if (runtime->proxy_free_count >= runtime->proxy_free_capacity) {
+		const u32 new_capacity = runtime->proxy_free_capacity > 0u ? runtime->proxy_free_capacity * 2u : 256u;
+		u32* free_list = (u32*)realloc(runtime->proxy_free, sizeof(u32) * (sz)new_capacity);
+		if (!free_list) {
+			s_mutex_unlock(&runtime->mutex);
+			return;
+		}
+		runtime->proxy_free = free_list;
+		runtime->proxy_free_capacity = new_capacity;
+	}
+	runtime->proxy_free[runtime->proxy_free_count++] = index;
+	if (runtime->live_proxies > 0u) {
+		runtime->live_proxies--;
+	}
+	s_mutex_unlock(&runtime->mutex);
+}
+
+b8 se_render_queue_replay_begin(void) {
+	se_render_queue_runtime* runtime = &g_render_queue;
+	// A running render thread resolves proxies concurrently and owns the live stream ring.
+	if (runtime->replaying || se_render_queue_is_running()) {
+		se_set_last_error(SE_RESULT_UNSUPPORTED);
+		return false;
+	}
+	runtime->replaying = true;
+	se_set_last_error(SE_RESULT_OK);
+	return true;
+}
+
+void se_render_queue_replay_end(void) {
+	se_render_queue_runtime* runtime = &g_render_queue;
+	for (u32 i = 0u; i < SE_RENDER_QUEUE_PROXY_CHUNK_COUNT; ++i) {
+		free(runtime->replay_proxy_chunks[i]);
+		runtime->replay_proxy_chunks[i] = NULL;
+	}
+	runtime->replaying = false;
+}
+
+b8 se_render_queue_is_replaying(void) {
+	return g_render_queue.replaying;
+}
+
+b8 se_render_queue_capture_begin(const se_window_handle window, const char* path, const u32 frame_count) {
+	se_render_queue_runtime* runtime = &g_render_queue;
+	if (!path) {
+		se_set_last_error(SE_RESULT_INVALID_ARGUMENT);
+		return false;
+	}
+	if (!se_render_queue_is_running_for_window(window)) {
+		se_set_last_error(SE_RESULT_NOT_FOUND);
+		return false;
+	}
+	se_render_capture_writer* writer = se_render_capture_open(path);
+	if (!writer) {
+		return false;
+	}
+	s_mutex_lock(&runtime->mutex);
+	if (runtime->capture_writer) {
+		s_mutex_unlock(&runtime->mutex);
+		se_render_capture_close(writer);
+		se_set_last_error(SE_RESULT_UNSUPPORTED);
+		return false;
+	}
+	runtime->capture_writer = writer;
+	runtime->capture_frames_left = frame_count;
+	runtime->capture_unbounded = frame_count == 0u;
+	s_mutex_unlock(&runtime->mutex);
+	se_set_last_error(SE_RESULT_OK);
+	return true;
+}
+
+void se_render_queue_capture_end(const se_window_handle window) {
+	se_render_queue_runtime* runtime = &g_render_queue;
+	if (!runtime->initialized) {
+		return;
+	}
+	s_mutex_lock(&runtime->mutex);
+	if (runtime->window != window) {
+		s_mutex_unlock(&runtime->mutex);
+		return;
+	}
+	while (runtime->capture_busy) {
+		s_cond_wait(&runtime->present_done, &runtime->mutex);
+	}
+	se_render_queue_capture_close_locked(runtime);
+	s_mutex_unlock(&runtime->mutex);
+}
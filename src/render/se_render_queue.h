@@ -9,6 +9,31 @@
 typedef void (*se_render_queue_sync_fn)(const void* payload, void* out_result);
 
 #define SE_RENDER_QUEUE_POINTER_PATCH_NONE 0xFFFFFFFFu
+#define SE_RENDER_QUEUE_PROXY_BIT 0x80000000u
+// The payload points at recording-process memory outside its blob (out parameters, client
+// arrays, strings), so a capture cannot carry it and replay skips the command.
+#define SE_RENDER_QUEUE_COMMAND_NO_REPLAY 0x1u
+
+typedef struct {
+	se_render_queue_sync_fn fn;
+	const char* name;
+	se_render_thread_command_kind kind;
+	// Size of the fixed payload struct the command expects.
+	u32 payload_bytes;
+	// SE_RENDER_QUEUE_COMMAND_* bits.
+	u32 flags;
+} se_render_queue_command_info;
+
+typedef enum {
+	SE_RENDER_QUEUE_OBJECT_BUFFER = 0,
+	SE_RENDER_QUEUE_OBJECT_TEXTURE,
+	SE_RENDER_QUEUE_OBJECT_VERTEX_ARRAY,
+	SE_RENDER_QUEUE_OBJECT_FRAMEBUFFER,
+	SE_RENDER_QUEUE_OBJECT_RENDERBUFFER,
+	SE_RENDER_QUEUE_OBJECT_PROGRAM,
+	SE_RENDER_QUEUE_OBJECT_SHADER,
+	SE_RENDER_QUEUE_OBJECT_TYPE_COUNT
+} se_render_queue_object_type;
 
 extern b8 se_render_queue_start(se_window_handle window, const se_render_thread_config* config);
 extern void se_render_queue_stop(se_window_handle window);
@@ -34,4 +59,60 @@ extern b8 se_render_queue_record_async_blob(se_render_queue_sync_fn fn,
 	const void* blob,
 	u32 blob_bytes);
 
+// Recording-side checks for SE_RENDER_QUEUE_VALIDATION builds; SE_RENDER_QUEUE_VALIDATE drops
+// the call entirely otherwise. `call` names the GL entry point in reports.
+#if defined(SE_RENDER_QUEUE_VALIDATION)
+extern void se_render_queue_validate_created(se_render_queue_object_type type, i32 n, const u32* names);
+extern void se_render_queue_validate_deleted(const c8* call, se_render_queue_object_type type, i32 n, const u32* names);
+extern void se_render_queue_validate_used(const c8* call, se_render_queue_object_type type, u32 name);
+extern void se_render_queue_validate_bound(const c8* call, se_render_queue_object_type type, u32 name);
+extern void se_render_queue_validate_draw(const c8* call);
+#define SE_RENDER_QUEUE_VALIDATE(_call) _call
+#else
+#define SE_RENDER_QUEUE_VALIDATE(_call) ((void)0)
+#endif
+// Tags commands recorded on the calling thread; returns the previous tag.
+extern const c8* se_render_queue_set_caller_tag(const c8* tag);
+
+// Secondary packets: a thread bound to a slot records into it without the queue lock.
+extern b8 se_render_queue_secondary_begin(se_window_handle window, u32 slot);
+extern b8 se_render_queue_secondary_end(void);
+extern b8 se_render_queue_is_recording_secondary(void);
+extern b8 se_render_queue_record_secondary(se_window_handle window, u32 slot);
+
+// Reserves a blob command and returns its blob memory for the caller to fill in place; the
+// command runs only after se_render_queue_commit_blob. One open reservation per thread.
+extern void* se_render_queue_reserve_blob(se_render_queue_sync_fn fn,
+	const void* payload,
+	u32 payload_bytes,
+	u32 pointer_patch_offset,
+	u32 blob_bytes);
+extern b8 se_render_queue_commit_blob(void* blob);
+
+// Proxy object names handed out on the recording thread; the render thread binds the real
+// name when the creating command executes. Non-proxy names resolve to themselves.
+extern u32 se_render_queue_proxy_reserve(void);
+extern void se_render_queue_proxy_bind(u32 proxy, u32 value);
+extern u32 se_render_queue_proxy_resolve(u32 name);
+extern void se_render_queue_proxy_release(u32 proxy);
+
+// Capture replay runs commands on the calling thread while the queue is stopped. Proxies bound
+// in between land in a private table, falling back to the live one for objects created before
+// the capture, and commands that drive live-only state (the GL stream ring) leave it alone.
+extern b8 se_render_queue_replay_begin(void);
+extern void se_render_queue_replay_end(void);
+extern b8 se_render_queue_is_replaying(void);
+
+// Writes the next `frame_count` executed packets to `path`; 0 captures until capture_end.
+extern b8 se_render_queue_capture_begin(se_window_handle window, const char* path, u32 frame_count);
+extern void se_render_queue_capture_end(se_window_handle window);
+
+// Every command the GL dispatch layer records, by name, so captures can be replayed elsewhere.
+extern const se_render_queue_command_info* se_gl_dispatch_get_commands(u32* out_count);
+// Commands the GL streaming ring records or runs on the render thread.
+extern const se_render_queue_command_info* se_gl_stream_get_commands(u32* out_count);
+// Lookups across every recorder's command list; NULL when the command is not registered.
+extern const se_render_queue_command_info* se_render_queue_command_info_for(se_render_queue_sync_fn fn);
+extern const se_render_queue_command_info* se_render_queue_command_info_named(const c8* name);
+
 #endif // SE_RENDER_QUEUE_H
@@ -0,0 +1,4388 @@
+// Syphax-Engine - Ougi Washi
+
+#include "render/se_soft_glsl.h"
+
+#include <math.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define SE_SOFT_GLSL_NONE 0u
+#define SE_SOFT_GLSL_NAME_MAX 64u
+#define SE_SOFT_GLSL_MAX_PARAMS 16u
+#define SE_SOFT_GLSL_MAX_SCOPES 64u
+#define SE_SOFT_GLSL_MAX_CONDITIONALS 32u
+#define SE_SOFT_GLSL_MAX_MACRO_DEPTH 16u
+#define SE_SOFT_GLSL_MAX_ARRAY 65536u
+
+// Tokens
+
+typedef enum {
+	SE_SOFT_GLSL_TOKEN_EOF = 0,
+	SE_SOFT_GLSL_TOKEN_IDENT,
+	SE_SOFT_GLSL_TOKEN_INT,
+	SE_SOFT_GLSL_TOKEN_UINT,
+	SE_SOFT_GLSL_TOKEN_FLOAT,
+	SE_SOFT_GLSL_TOKEN_PUNCT
+} se_soft_glsl_token_kind;
+
+typedef struct {
+	u8 kind;
+	b8 line_start;
+	b8 spaced;
+	u32 line;
+	i64 integer;
+	f64 number;
+	c8 text[SE_SOFT_GLSL_NAME_MAX];
+} se_soft_glsl_token;
+
+typedef struct {
+	se_soft_glsl_token* items;
+	u32 count;
+	u32 capacity;
+} se_soft_glsl_tokens;
+
+// Types and values
+
+typedef union {
+	f32 f;
+	i32 i;
+} se_soft_glsl_value;
+
+typedef enum {
+	SE_SOFT_GLSL_VOID = 0,
+	SE_SOFT_GLSL_FLOAT,
+	SE_SOFT_GLSL_INT,
+	SE_SOFT_GLSL_UINT,
+	SE_SOFT_GLSL_BOOL,
+	SE_SOFT_GLSL_SAMPLER2D,
+	SE_SOFT_GLSL_SAMPLER3D,
+	SE_SOFT_GLSL_STRUCT
+} se_soft_glsl_base;
+
+// Vectors have `rows` components; matrices are `cols` columns of `rows` components.
+typedef struct {
+	u8 base;
+	u8 rows;
+	u8 cols;
+	u16 structure;
+	u32 array;
+} se_soft_glsl_type;
+
+typedef struct {
+	c8 name[SE_SOFT_GLSL_NAME_MAX];
+	se_soft_glsl_type type;
+	u32 offset;
+} se_soft_glsl_field;
+
+typedef struct {
+	c8 name[SE_SOFT_GLSL_NAME_MAX];
+	u32 first_field;
+	u32 field_count;
+	u32 slots;
+} se_soft_glsl_struct;
+
+typedef enum {
+	SE_SOFT_GLSL_LOCAL = 0,
+	SE_SOFT_GLSL_SHARED
+} se_soft_glsl_storage;
+
+typedef enum {
+	SE_SOFT_GLSL_QUALIFIER_NONE = 0,
+	SE_SOFT_GLSL_QUALIFIER_CONST,
+	SE_SOFT_GLSL_QUALIFIER_UNIFORM,
+	SE_SOFT_GLSL_QUALIFIER_IN,
+	SE_SOFT_GLSL_QUALIFIER_OUT,
+	SE_SOFT_GLSL_QUALIFIER_INOUT,
+	SE_SOFT_GLSL_QUALIFIER_BUILTIN
+} se_soft_glsl_qualifier;
+
+typedef struct {
+	c8 name[SE_SOFT_GLSL_NAME_MAX];
+	se_soft_glsl_type type;
+	u8 storage;
+	u8 qualifier;
+	b8 flat;
+	b8 constant;
+	i32 location;
+	u32 offset;
+} se_soft_glsl_variable;
+
+typedef struct {
+	c8 name[SE_SOFT_GLSL_NAME_MAX];
+	se_soft_glsl_type return_type;
+	u32 params[SE_SOFT_GLSL_MAX_PARAMS];
+	u32 param_count;
+	u32 body;
+	u32 return_slot;
+	b8 defined;
+} se_soft_glsl_function;
+
+// Nodes
+
+typedef enum {
+	SE_SOFT_GLSL_OP_NOP = 0,
+	SE_SOFT_GLSL_OP_REF,
+	SE_SOFT_GLSL_OP_INDEX,
+	SE_SOFT_GLSL_OP_FIELD,
+	SE_SOFT_GLSL_OP_SWIZZLE,
+	SE_SOFT_GLSL_OP_NEGATE,
+	SE_SOFT_GLSL_OP_NOT,
+	SE_SOFT_GLSL_OP_BIT_NOT,
+	SE_SOFT_GLSL_OP_BINARY,
+	SE_SOFT_GLSL_OP_MUL_MM,
+	SE_SOFT_GLSL_OP_MUL_MV,
+	SE_SOFT_GLSL_OP_MUL_VM,
+	SE_SOFT_GLSL_OP_EQUAL,
+	SE_SOFT_GLSL_OP_NOT_EQUAL,
+	SE_SOFT_GLSL_OP_LOGICAL_AND,
+	SE_SOFT_GLSL_OP_LOGICAL_OR,
+	SE_SOFT_GLSL_OP_LOGICAL_XOR,
+	SE_SOFT_GLSL_OP_SELECT,
+	SE_SOFT_GLSL_OP_ASSIGN,
+	SE_SOFT_GLSL_OP_PRE_INC,
+	SE_SOFT_GLSL_OP_PRE_DEC,
+	SE_SOFT_GLSL_OP_POST_INC,
+	SE_SOFT_GLSL_OP_POST_DEC,
+	SE_SOFT_GLSL_OP_CALL,
+	SE_SOFT_GLSL_OP_BUILTIN,
+	SE_SOFT_GLSL_OP_CONSTRUCT,
+	SE_SOFT_GLSL_OP_CONVERT,
+	SE_SOFT_GLSL_OP_SEQUENCE,
+	SE_SOFT_GLSL_OP_BLOCK,
+	SE_SOFT_GLSL_OP_EXPRESSION,
+	SE_SOFT_GLSL_OP_DECLARE,
+	SE_SOFT_GLSL_OP_IF,
+	SE_SOFT_GLSL_OP_FOR,
+	SE_SOFT_GLSL_OP_DO,
+	SE_SOFT_GLSL_OP_RETURN,
+	SE_SOFT_GLSL_OP_BREAK,
+	SE_SOFT_GLSL_OP_CONTINUE,
+	SE_SOFT_GLSL_OP_DISCARD
+} se_soft_glsl_op;
+
+typedef enum {
+	SE_SOFT_GLSL_BINARY_ADD = 0,
+	SE_SOFT_GLSL_BINARY_SUB,
+	SE_SOFT_GLSL_BINARY_MUL,
+	SE_SOFT_GLSL_BINARY_DIV,
+	SE_SOFT_GLSL_BINARY_MOD,
+	SE_SOFT_GLSL_BINARY_LESS,
+	SE_SOFT_GLSL_BINARY_GREATER,
+	SE_SOFT_GLSL_BINARY_LESS_EQUAL,
+	SE_SOFT_GLSL_BINARY_GREATER_EQUAL,
+	SE_SOFT_GLSL_BINARY_BIT_AND,
+	SE_SOFT_GLSL_BINARY_BIT_OR,
+	SE_SOFT_GLSL_BINARY_BIT_XOR,
+	SE_SOFT_GLSL_BINARY_SHIFT_LEFT,
+	SE_SOFT_GLSL_BINARY_SHIFT_RIGHT
+} se_soft_glsl_binary;
+
+typedef enum {
+	SE_SOFT_GLSL_CONSTRUCT_FLATTEN = 0,
+	SE_SOFT_GLSL_CONSTRUCT_BROADCAST,
+	SE_SOFT_GLSL_CONSTRUCT_DIAGONAL,
+	SE_SOFT_GLSL_CONSTRUCT_MATRIX,
+	SE_SOFT_GLSL_CONSTRUCT_AGGREGATE
+} se_soft_glsl_construct;
+
+// Child layout per op:
+//   REF          slot in `storage`; aux = variable + 1, or 0 for literals
+//   INDEX        a[b]; aux = element slots, c = element count
+//   FIELD        a at slot offset aux
+//   SWIZZLE      a; aux = four 2-bit components, c = component count
+//   unary ops    a
+//   BINARY       a op b; aux = se_soft_glsl_binary, c = bit 0/1 broadcast a/b
+//   MUL_*        a * b
+//   SELECT       a ? b : c
+//   ASSIGN       a = b
+//   *_INC/_DEC   a
+//   CALL         aux = function, arguments lists[a .. a + b)
+//   BUILTIN      aux = builtin, arguments lists[a .. a + b)
+//   CONSTRUCT    aux = se_soft_glsl_construct, arguments lists[a .. a + b)
+//   CONVERT      a, from operand_base
+//   SEQUENCE     a, b; yields b
+//   BLOCK        statements lists[a .. a + b)
+//   EXPRESSION   a
+//   DECLARE      variable a, initializer b
+//   IF           if (a) b else c
+//   FOR          for (a; b; c) d
+//   DO           do a while (b)
+//   RETURN       a; aux = function
+typedef struct {
+	u8 op;
+	u8 storage;
+	b8 constant;
+	u8 operand_base;
+	se_soft_glsl_type type;
+	u32 slot;
+	u32 a;
+	u32 b;
+	u32 c;
+	u32 d;
+	u32 aux;
+	u32 line;
+} se_soft_glsl_node;
+
+typedef enum {
+	SE_SOFT_GLSL_BUILTIN_VAR_POSITION = 0,
+	SE_SOFT_GLSL_BUILTIN_VAR_POINT_SIZE,
+	SE_SOFT_GLSL_BUILTIN_VAR_VERTEX_ID,
+	SE_SOFT_GLSL_BUILTIN_VAR_INSTANCE_ID,
+	SE_SOFT_GLSL_BUILTIN_VAR_FRAG_COORD,
+	SE_SOFT_GLSL_BUILTIN_VAR_FRONT_FACING,
+	SE_SOFT_GLSL_BUILTIN_VAR_FRAG_DEPTH,
+	SE_SOFT_GLSL_BUILTIN_VAR_POINT_COORD,
+	SE_SOFT_GLSL_BUILTIN_VAR_COUNT
+} se_soft_glsl_builtin_var;
+
+typedef struct {
+	se_soft_glsl_stage stage;
+	se_soft_glsl_node* nodes;
+	u32 node_count;
+	u32 node_capacity;
+	u32* lists;
+	u32 list_count;
+	u32 list_capacity;
+	se_soft_glsl_variable* variables;
+	u32 variable_count;
+	u32 variable_capacity;
+	se_soft_glsl_function* functions;
+	u32 function_count;
+	u32 function_capacity;
+	se_soft_glsl_struct* structs;
+	u32 struct_count;
+	u32 struct_capacity;
+	se_soft_glsl_field* fields;
+	u32 field_count;
+	u32 field_capacity;
+	// Uniforms, constants and literals; copied into every program snapshot.
+	se_soft_glsl_value* shared;
+	u32 shared_count;
+	u32 shared_capacity;
+	// Every variable and intermediate result has a fixed slot; GLSL forbids recursion.
+	u32 local_slots;
+	u32 global_init;
+	u32 main_function;
+	u32 builtin_vars[SE_SOFT_GLSL_BUILTIN_VAR_COUNT];
+	b8 writes_depth;
+} se_soft_glsl_module;
+
+static b8 se_soft_glsl_grow(void** data, u32* capacity, const u32 needed, const sz element_size) {
+	if (needed <= *capacity) {
+		return true;
+	}
+	u32 next = *capacity > 0u ? *capacity : 32u;
+	while (next < needed) {
+		next *= 2u;
+	}
+	void* grown = realloc(*data, element_size * (sz)next);
+	if (!grown) {
+		return false;
+	}
+	*data = grown;
+	*capacity = next;
+	return true;
+}
+
+static void se_soft_glsl_copy_name(c8 out_name[SE_SOFT_GLSL_NAME_MAX], const c8* name) {
+	snprintf(out_name, SE_SOFT_GLSL_NAME_MAX, "%s", name);
+}
+
+// Lexer
+
+static b8 se_soft_glsl_tokens_push(se_soft_glsl_tokens* tokens, const se_soft_glsl_token* token) {
+	if (!se_soft_glsl_grow((void**)&tokens->items, &tokens->capacity, tokens->count + 1u, sizeof(*tokens->items))) {
+		return false;
+	}
+	tokens->items[tokens->count++] = *token;
+	return true;
+}
+
+static b8 se_soft_glsl_is_ident_start(const c8 c) {
+	return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '_';
+}
+
+static b8 se_soft_glsl_is_digit(const c8 c) {
+	return c >= '0' && c <= '9';
+}
+
+static b8 se_soft_glsl_lex(const c8* source, se_soft_glsl_tokens* out_tokens, c8* log, const sz log_size) {
+	static const c8* punctuators[] = {
+		"<<=", ">>=",
+		"++", "--", "<=", ">=", "==", "!=", "&&", "||", "^^", "+=", "-=", "*=", "/=", "%=", "&=", "|=", "^=", "<<", ">>"
+	};
+	const c8* cursor = source;
+	u32 line = 1u;
+	b8 line_start = true;
+	b8 spaced = false;
+	while (*cursor) {
+		const c8 c = *cursor;
+		if (c == '\n') {
+			++line;
+			line_start = true;
+			spaced = true;
+			++cursor;
+			continue;
+		}
+		if (c == ' ' || c == '\t' || c == '\r' || c == '\f' || c == '\v') {
+			spaced = true;
+			++cursor;
+			continue;
+		}
+		if (c == '\\' && (cursor[1] == '\n' || (cursor[1] == '\r' && cursor[2] == '\n'))) {
+			cursor += cursor[1] == '\n' ? 2 : 3;
+			++line;
+			spaced = true;
+			continue;
+		}
+		if (c == '/' && cursor[1] == '/') {
+			while (*cursor && *cursor != '\n') {
+				++cursor;
+			}
+			spaced = true;
+			continue;
+		}
+		if (c == '/' && cursor[1] == '*') {
+			cursor += 2;
+			while (*cursor && !(cursor[0] == '*' && cursor[1] == '/')) {
+				if (*cursor == '\n') {
+					++line;
+				}
+				++cursor;
+			}
+			if (*cursor) {
+				cursor += 2;
+			}
+			spaced = true;
+			continue;
+		}
+		se_soft_glsl_token token = {0};
+		token.line = line;
+		token.line_start = line_start;
+		token.spaced = spaced;
+		line_start = false;
+		spaced = false;
+		if (se_soft_glsl_is_ident_start(c)) {
+			const c8* start = cursor;
+			while (se_soft_glsl_is_ident_start(*cursor) || se_soft_glsl_is_digit(*cursor)) {
+				++cursor;
+			}
+			const sz length = (sz)(cursor - start);
+			if (length >= SE_SOFT_GLSL_NAME_MAX) {
+				if (log && log_size > 0u) {
+					snprintf(log, log_size, "0:%u: error: identifier is too long", line);
+				}
+				return false;
+			}
+			token.kind = SE_SOFT_GLSL_TOKEN_IDENT;
+			memcpy(token.text, start, length);
+			token.text[length] = '\0';
+		} else if (se_soft_glsl_is_digit(c) || (c == '.' && se_soft_glsl_is_digit(cursor[1]))) {
+			const c8* start = cursor;
+			if (c == '0' && (cursor[1] == 'x' || cursor[1] == 'X')) {
+				c8* end = NULL;
+				token.integer = (i64)strtoull(cursor + 2, &end, 16);
+				cursor = end;
+				token.kind = SE_SOFT_GLSL_TOKEN_INT;
+			} else {
+				b8 is_float = false;
+				while (se_soft_glsl_is_digit(*cursor)) {
+					++cursor;
+				}
+				if (*cursor == '.') {
+					is_float = true;
+					++cursor;
+					while (se_soft_glsl_is_digit(*cursor)) {
+						++cursor;
+					}
+				}
+				if ((*cursor == 'e' || *cursor == 'E') &&
+					(se_soft_glsl_is_digit(cursor[1]) || ((cursor[1] == '+' || cursor[1] == '-') && se_soft_glsl_is_digit(cursor[2])))) {
+					is_float = true;
+					cursor += 2;
+					while (se_soft_glsl_is_digit(*cursor)) {
+						++cursor;
+					}
+				}
+				if (is_float) {
+					token.kind = SE_SOFT_GLSL_TOKEN_FLOAT;
+					token.number = strtod(start, NULL);
+				} else {
+					token.kind = SE_SOFT_GLSL_TOKEN_INT;
+					// A leading zero means octal, as in C.
+					token.integer = (i64)strtoull(start, NULL, start[0] == '0' ? 8 : 10);
+				}
+			}
+			if (*cursor == 'f' || *cursor == 'F') {
+				if (token.kind == SE_SOFT_GLSL_TOKEN_INT) {
+					token.kind = SE_SOFT_GLSL_TOKEN_FLOAT;
+					token.number = (f64)token.integer;
+				}
+				++cursor;
+			} else if ((cursor[0] == 'l' && cursor[1] == 'f') || (cursor[0] == 'L' && cursor[1] == 'F')) {
+				cursor += 2;
+			} else if ((*cursor == 'u' || *cursor == 'U') && token.kind == SE_SOFT_GLSL_TOKEN_INT) {
+				token.kind = SE_SOFT_GLSL_TOKEN_UINT;
+				++cursor;
+			}
+			const sz length = (sz)(cursor - start) < SE_SOFT_GLSL_NAME_MAX - 1u ? (sz)(cursor - start) : SE_SOFT_GLSL_NAME_MAX - 1u;
+			memcpy(token.text, start, length);
+			token.text[length] = '\0';
+		} else {
+			sz length = 1u;
+			for (u32 i = 0u; i < sizeof(punctuators) / sizeof(punctuators[0]); ++i) {
+				const sz candidate = strlen(punctuators[i]);
+				if (strncmp(cursor, punctuators[i], candidate) == 0) {
+					length = candidate;
+					break;
+				}
+			}
+			token.kind = SE_SOFT_GLSL_TOKEN_PUNCT;
+			memcpy(token.text, cursor, length);
+			token.text[length] = '\0';
+			cursor += length;
+		}
+		if (!se_soft_glsl_tokens_push(out_tokens, &token)) {
+			return false;
+		}
+	}
+	return true;
+}
+
+// Preprocessor: object-like macros and conditionals. Function-like macros are rejected.
+
+typedef struct {
+	c8 name[SE_SOFT_GLSL_NAME_MAX];
+	u32 first;
+	u32 count;
+	b8 defined;
+} se_soft_glsl_macro;
+
+typedef struct {
+	se_soft_glsl_macro* items;
+	u32 count;
+	u32 capacity;
+	se_soft_glsl_tokens bodies;
+} se_soft_glsl_macros;
+
+typedef struct {
+	const se_soft_glsl_token* tokens;
+	u32 count;
+	u32 pos;
+	const se_soft_glsl_macros* macros;
+	u32 depth;
+	b8 failed;
+} se_soft_glsl_condition;
+
+static const se_soft_glsl_macro* se_soft_glsl_find_macro(const se_soft_glsl_macros* macros, const c8* name) {
+	for (u32 i = macros->count; i > 0u; --i) {
+		const se_soft_glsl_macro* macro = &macros->items[i - 1u];
+		if (strcmp(macro->name, name) == 0) {
+			return macro->defined ? macro : NULL;
+		}
+	}
+	return NULL;
+}
+
+static b8 se_soft_glsl_define(se_soft_glsl_macros* macros, const c8* name, const se_soft_glsl_token* body, const u32 body_count) {
+	if (!se_soft_glsl_grow((void**)&macros->items, &macros->capacity, macros->count + 1u, sizeof(*macros->items))) {
+		return false;
+	}
+	se_soft_glsl_macro* macro = &macros->items[macros->count++];
+	memset(macro, 0, sizeof(*macro));
+	se_soft_glsl_copy_name(macro->name, name);
+	macro->first = macros->bodies.count;
+	macro->count = body_count;
+	macro->defined = true;
+	for (u32 i = 0u; i < body_count; ++i) {
+		if (!se_soft_glsl_tokens_push(&macros->bodies, &body[i])) {
+			return false;
+		}
+	}
+	return true;
+}
+
+static i64 se_soft_glsl_condition_expression(se_soft_glsl_condition* condition, u32 min_precedence);
+
+static const se_soft_glsl_token* se_soft_glsl_condition_next(se_soft_glsl_condition* condition) {
+	if (condition->pos >= condition->count) {
+		condition->failed = true;
+		return NULL;
+	}
+	return &condition->tokens[condition->pos++];
+}
+
+static b8 se_soft_glsl_condition_accept(se_soft_glsl_condition* condition, const c8* text) {
+	if (condition->pos < condition->count &&
+		condition->tokens[condition->pos].kind == SE_SOFT_GLSL_TOKEN_PUNCT &&
+		strcmp(condition->tokens[condition->pos].text, text) == 0) {
+		++condition->pos;
+		return true;
+	}
+	return false;
+}
+
+static i64 se_soft_glsl_condition_primary(se_soft_glsl_condition* condition) {
+	const se_soft_glsl_token* token = se_soft_glsl_condition_next(condition);
+	if (!token) {
+		return 0;
+	}
+	if (token->kind == SE_SOFT_GLSL_TOKEN_INT || token->kind == SE_SOFT_GLSL_TOKEN_UINT) {
+		return token->integer;
+	}
+	if (token->kind == SE_SOFT_GLSL_TOKEN_IDENT) {
+		if (strcmp(token->text, "defined") == 0) {
+			const b8 parenthesized = se_soft_glsl_condition_accept(condition, "(");
+			const se_soft_glsl_token* name = se_soft_glsl_condition_next(condition);
+			if (!name || name->kind != SE_SOFT_GLSL_TOKEN_IDENT || (parenthesized && !se_soft_glsl_condition_accept(condition, ")"))) {
+				condition->failed = true;
+				return 0;
+			}
+			return se_soft_glsl_find_macro(condition->macros, name->text) ? 1 : 0;
+		}
+		const se_soft_glsl_macro* macro = se_soft_glsl_find_macro(condition->macros, token->text);
+		if (!macro || macro->count == 0u || condition->depth >= SE_SOFT_GLSL_MAX_MACRO_DEPTH) {
+			return 0;
+		}
+		se_soft_glsl_condition nested = {
+			.tokens = &condition->macros->bodies.items[macro->first],
+			.count = macro->count,
+			.macros = condition->macros,
+			.depth = condition->depth + 1u
+		};
+		const i64 value = se_soft_glsl_condition_expression(&nested, 0u);
+		condition->failed |= nested.failed;
+		return value;
+	}
+	if (token->kind == SE_SOFT_GLSL_TOKEN_PUNCT) {
+		if (strcmp(token->text, "(") == 0) {
+			const i64 value = se_soft_glsl_condition_expression(condition, 0u);
+			if (!se_soft_glsl_condition_accept(condition, ")")) {
+				condition->failed = true;
+			}
+			return value;
+		}
+		if (strcmp(token->text, "!") == 0) {
+			return !se_soft_glsl_condition_primary(condition);
+		}
+		if (strcmp(token->text, "-") == 0) {
+			return -se_soft_glsl_condition_primary(condition);
+		}
+		if (strcmp(token->text, "+") == 0) {
+			return se_soft_glsl_condition_primary(condition);
+		}
+		if (strcmp(token->text, "~") == 0) {
+			return ~se_soft_glsl_condition_primary(condition);
+		}
+	}
+	condition->failed = true;
+	return 0;
+}
+
+static u32 se_soft_glsl_condition_precedence(const se_soft_glsl_token* token) {
+	static const struct {
+		const c8* text;
+		u32 precedence;
+	} operators[] = {
+		{ "||", 1u }, { "&&", 2u }, { "|", 3u }, { "^", 4u }, { "&", 5u },
+		{ "==", 6u }, { "!=", 6u }, { "<", 7u }, { ">", 7u }, { "<=", 7u }, { ">=", 7u },
+		{ "<<", 8u }, { ">>", 8u }, { "+", 9u }, { "-", 9u }, { "*", 10u }, { "/", 10u }, { "%", 10u }
+	};
+	if (token->kind != SE_SOFT_GLSL_TOKEN_PUNCT) {
+		return 0u;
+	}
+	for (u32 i = 0u; i < sizeof(operators) / sizeof(operators[0]); ++i) {
+		if (strcmp(token->text, operators[i].text) == 0) {
+			return operators[i].precedence;
+		}
+	}
+	return 0u;
+}
+
+static i64 se_soft_glsl_condition_expression(se_soft_glsl_condition* condition, const u32 min_precedence) {
+	i64 left = se_soft_glsl_condition_primary(condition);
+	while (!condition->failed && condition->pos < condition->count) {
+		const se_soft_glsl_token* token = &condition->tokens[condition->pos];
+		const u32 precedence = se_soft_glsl_condition_precedence(token);
+		if (precedence == 0u || precedence <= min_precedence) {
+			break;
+		}
+		++condition->pos;
+		const i64 right = se_soft_glsl_condition_expression(condition, precedence);
+		const c8* op = token->text;
+		if (strcmp(op, "||") == 0) left = left || right;
+		else if (strcmp(op, "&&") == 0) left = left && right;
+		else if (strcmp(op, "|") == 0) left = left | right;
+		else if (strcmp(op, "^") == 0) left = left ^ right;
+		else if (strcmp(op, "&") == 0) left = left & right;
+		else if (strcmp(op, "==") == 0) left = left == right;
+		else if (strcmp(op, "!=") == 0) left = left != right;
+		else if (strcmp(op, "<") == 0) left = left < right;
+		else if (strcmp(op, ">") == 0) left = left > right;
+		else if (strcmp(op, "<=") == 0) left = left <= right;
+		else if (strcmp(op, ">=") == 0) left = left >= right;
+		else if (strcmp(op, "<<") == 0) left = left << (right & 63);
+		else if (strcmp(op, ">>") == 0) left = left >> (right & 63);
+		else if (strcmp(op, "+") == 0) left = left + right;
+		else if (strcmp(op, "-") == 0) left = left - right;
+		else if (strcmp(op, "*") == 0) left = left * right;
+		else if (right == 0) condition->failed = true;
+		else if (strcmp(op, "/") == 0) left = left / right;
+		else left = left % right;
+	}
+	return left;
+}
+
+static b8 se_soft_glsl_expand(se_soft_glsl_tokens* out_tokens, const se_soft_glsl_macros* macros, const se_soft_glsl_token* token, const u32 line, const u32 depth) {
+	if (token->kind == SE_SOFT_GLSL_TOKEN_IDENT) {
+		if (strcmp(token->text, "__LINE__") == 0) {
+			se_soft_glsl_token number = *token;
+			number.kind = SE_SOFT_GLSL_TOKEN_INT;
+			number.integer = line;
+			number.line = line;
+			snprintf(number.text, sizeof(number.text), "%u", line);
+			return se_soft_glsl_tokens_push(out_tokens, &number);
+		}
+		const se_soft_glsl_macro* macro = se_soft_glsl_find_macro(macros, token->text);
+		if (macro && depth < SE_SOFT_GLSL_MAX_MACRO_DEPTH) {
+			for (u32 i = 0u; i < macro->count; ++i) {
+				if (!se_soft_glsl_expand(out_tokens, macros, &macros->bodies.items[macro->first + i], line, depth + 1u)) {
+					return false;
+				}
+			}
+			return true;
+		}
+	}
+	se_soft_glsl_token copy = *token;
+	copy.line = line;
+	copy.line_start = false;
+	return se_soft_glsl_tokens_push(out_tokens, &copy);
+}
+
+static b8 se_soft_glsl_preprocess(const se_soft_glsl_tokens* raw, se_soft_glsl_tokens* out_tokens, c8* log, const sz log_size) {
+	typedef struct {
+		b8 active;
+		b8 taken;
+		b8 parent_active;
+	} se_soft_glsl_conditional;
+	se_soft_glsl_conditional conditionals[SE_SOFT_GLSL_MAX_CONDITIONALS];
+	u32 conditional_count = 0u;
+	b8 active = true;
+	se_soft_glsl_macros macros = {0};
+	b8 ok = true;
+	u32 error_line = 0u;
+	const c8* error = NULL;
+	for (u32 i = 0u; i < raw->count && ok;) {
+		const se_soft_glsl_token* token = &raw->items[i];
+		if (!(token->kind == SE_SOFT_GLSL_TOKEN_PUNCT && token->line_start && strcmp(token->text, "#") == 0)) {
+			if (active) {
+				ok = se_soft_glsl_expand(out_tokens, &macros, token, token->line, 0u);
+			}
+			++i;
+			continue;
+		}
+		u32 end = i + 1u;
+		while (end < raw->count && !raw->items[end].line_start) {
+			++end;
+		}
+		const se_soft_glsl_token* args = &raw->items[i + 1u];
+		const u32 arg_count = end - i - 1u;
+		const c8* directive = arg_count > 0u ? args[0].text : "";
+		error_line = token->line;
+		if (strcmp(directive, "if") == 0 || strcmp(directive, "ifdef") == 0 || strcmp(directive, "ifndef") == 0) {
+			if (conditional_count >= SE_SOFT_GLSL_MAX_CONDITIONALS) {
+				error = "conditionals are nested too deeply";
+				break;
+			}
+			b8 value = false;
+			if (active) {
+				if (strcmp(directive, "if") == 0) {
+					se_soft_glsl_condition condition = { .tokens = args + 1, .count = arg_count - 1u, .macros = &macros };
+					value = se_soft_glsl_condition_expression(&condition, 0u) != 0;
+					if (condition.failed || condition.pos != condition.count) {
+						error = "invalid #if expression";
+						break;
+					}
+				} else {
+					if (arg_count < 2u || args[1].kind != SE_SOFT_GLSL_TOKEN_IDENT) {
+						error = "expected a macro name";
+						break;
+					}
+					value = (se_soft_glsl_find_macro(&macros, args[1].text) != NULL) == (strcmp(directive, "ifdef") == 0);
+				}
+			}
+			conditionals[conditional_count++] = (se_soft_glsl_conditional){ .active = active && value, .taken = active && value, .parent_active = active };
+			active = active && value;
+		} else if (strcmp(directive, "elif") == 0 || strcmp(directive, "else") == 0) {
+			if (conditional_count == 0u) {
+				error = "#elif or #else without #if";
+				break;
+			}
+			se_soft_glsl_conditional* conditional = &conditionals[conditional_count - 1u];
+			b8 value = false;
+			if (conditional->parent_active && !conditional->taken) {
+				value = true;
+				if (strcmp(directive, "elif") == 0) {
+					se_soft_glsl_condition condition = { .tokens = args + 1, .count = arg_count - 1u, .macros = &macros };
+					value = se_soft_glsl_condition_expression(&condition, 0u) != 0;
+					if (condition.failed || condition.pos != condition.count) {
+						error = "invalid #elif expression";
+						break;
+					}
+				}
+			}
+			conditional->active = value;
+			conditional->taken |= value;
+			active = value;
+		} else if (strcmp(directive, "endif") == 0) {
+			if (conditional_count == 0u) {
+				error = "#endif without #if";
+				break;
+			}
+			active = conditionals[--conditional_count].parent_active;
+		} else if (!active) {
+		} else if (strcmp(directive, "define") == 0) {
+			if (arg_count < 2u || args[1].kind != SE_SOFT_GLSL_TOKEN_IDENT) {
+				error = "expected a macro name";
+				break;
+			}
+			if (arg_count > 2u && strcmp(args[2].text, "(") == 0 && !args[2].spaced) {
+				error = "function-like macros are not supported";
+				break;
+			}
+			static const se_soft_glsl_token empty = {0};
+			ok = se_soft_glsl_define(&macros, args[1].text, arg_count > 2u ? args + 2 : &empty, arg_count - 2u);
+		} else if (strcmp(directive, "undef") == 0) {
+			if (arg_count < 2u || args[1].kind != SE_SOFT_GLSL_TOKEN_IDENT) {
+				error = "expected a macro name";
+				break;
+			}
+			ok = se_soft_glsl_define(&macros, args[1].text, NULL, 0u);
+			if (ok) {
+				macros.items[macros.count - 1u].defined = false;
+			}
+		} else if (strcmp(directive, "version") == 0) {
+			se_soft_glsl_token version = {0};
+			version.kind = SE_SOFT_GLSL_TOKEN_INT;
+			version.integer = arg_count > 1u ? args[1].integer : 110;
+			snprintf(version.text, sizeof(version.text), "%lld", (long long)version.integer);
+			ok = se_soft_glsl_define(&macros, "__VERSION__", &version, 1u);
+			if (ok && arg_count > 2u && strcmp(args[2].text, "es") == 0) {
+				se_soft_glsl_token one = version;
+				one.integer = 1;
+				snprintf(one.text, sizeof(one.text), "1");
+				ok = se_soft_glsl_define(&macros, "GL_ES", &one, 1u);
+			}
+		} else if (strcmp(directive, "error") == 0) {
+			error = "#error";
+			break;
+		} else if (strcmp(directive, "extension") != 0 && strcmp(directive, "pragma") != 0 &&
+			strcmp(directive, "line") != 0 && arg_count > 0u) {
+			error = "unknown preprocessor directive";
+			break;
+		}
+		i = end;
+	}
+	if (!error && ok && conditional_count > 0u) {
+		error = "missing #endif";
+	}
+	if (error && log && log_size > 0u) {
+		snprintf(log, log_size, "0:%u: error: %s", error_line, error);
+	}
+	free(macros.items);
+	free(macros.bodies.items);
+	return ok && !error;
+}
+
+// Types
+
+static const struct {
+	const c8* name;
+	u8 base;
+	u8 rows;
+	u8 cols;
+} se_soft_glsl_type_names[] = {
+	{ "void", SE_SOFT_GLSL_VOID, 0u, 0u },
+	{ "float", SE_SOFT_GLSL_FLOAT, 1u, 1u },
+	{ "int", SE_SOFT_GLSL_INT, 1u, 1u },
+	{ "uint", SE_SOFT_GLSL_UINT, 1u, 1u },
+	{ "bool", SE_SOFT_GLSL_BOOL, 1u, 1u },
+	{ "vec2", SE_SOFT_GLSL_FLOAT, 2u, 1u },
+	{ "vec3", SE_SOFT_GLSL_FLOAT, 3u, 1u },
+	{ "vec4", SE_SOFT_GLSL_FLOAT, 4u, 1u },
+	{ "ivec2", SE_SOFT_GLSL_INT, 2u, 1u },
+	{ "ivec3", SE_SOFT_GLSL_INT, 3u, 1u },
+	{ "ivec4", SE_SOFT_GLSL_INT, 4u, 1u },
+	{ "uvec2", SE_SOFT_GLSL_UINT, 2u, 1u },
+	{ "uvec3", SE_SOFT_GLSL_UINT, 3u, 1u },
+	{ "uvec4", SE_SOFT_GLSL_UINT, 4u, 1u },
+	{ "bvec2", SE_SOFT_GLSL_BOOL, 2u, 1u },
+	{ "bvec3", SE_SOFT_GLSL_BOOL, 3u, 1u },
+	{ "bvec4", SE_SOFT_GLSL_BOOL, 4u, 1u },
+	{ "mat2", SE_SOFT_GLSL_FLOAT, 2u, 2u },
+	{ "mat3", SE_SOFT_GLSL_FLOAT, 3u, 3u },
+	{ "mat4", SE_SOFT_GLSL_FLOAT, 4u, 4u },
+	{ "mat2x2", SE_SOFT_GLSL_FLOAT, 2u, 2u },
+	{ "mat2x3", SE_SOFT_GLSL_FLOAT, 3u, 2u },
+	{ "mat2x4", SE_SOFT_GLSL_FLOAT, 4u, 2u },
+	{ "mat3x2", SE_SOFT_GLSL_FLOAT, 2u, 3u },
+	{ "mat3x3", SE_SOFT_GLSL_FLOAT, 3u, 3u },
+	{ "mat3x4", SE_SOFT_GLSL_FLOAT, 4u, 3u },
+	{ "mat4x2", SE_SOFT_GLSL_FLOAT, 2u, 4u },
+	{ "mat4x3", SE_SOFT_GLSL_FLOAT, 3u, 4u },
+	{ "mat4x4", SE_SOFT_GLSL_FLOAT, 4u, 4u },
+	{ "sampler2D", SE_SOFT_GLSL_SAMPLER2D, 1u, 1u },
+	{ "sampler3D", SE_SOFT_GLSL_SAMPLER3D, 1u, 1u }
+};
+
+static se_soft_glsl_type se_soft_glsl_make_type(const u8 base, const u8 rows, const u8 cols) {
+	se_soft_glsl_type type = {0};
+	type.base = base;
+	type.rows = rows;
+	type.cols = cols;
+	return type;
+}
+
+static u32 se_soft_glsl_type_slots(const se_soft_glsl_module* module, const se_soft_glsl_type* type) {
+	u32 slots = 0u;
+	if (type->base == SE_SOFT_GLSL_STRUCT) {
+		slots = module->structs[type->structure].slots;
+	} else if (type->base != SE_SOFT_GLSL_VOID) {
+		slots = (u32)type->rows * (u32)type->cols;
+	}
+	return type->array > 0u ? slots * type->array : slots;
+}
+
+static b8 se_soft_glsl_type_equal(const se_soft_glsl_type* a, const se_soft_glsl_type* b) {
+	return a->base == b->base && a->rows == b->rows && a->cols == b->cols && a->array == b->array &&
+		(a->base != SE_SOFT_GLSL_STRUCT || a->structure == b->structure);
+}
+
+static b8 se_soft_glsl_is_numeric(const u8 base) {
+	return base == SE_SOFT_GLSL_FLOAT || base == SE_SOFT_GLSL_INT || base == SE_SOFT_GLSL_UINT;
+}
+
+static b8 se_soft_glsl_is_sampler(const u8 base) {
+	return base == SE_SOFT_GLSL_SAMPLER2D || base == SE_SOFT_GLSL_SAMPLER3D;
+}
+
+// Scalars and vectors of float, int, uint or bool.
+static b8 se_soft_glsl_is_vector(const se_soft_glsl_type* type) {
+	return type->array == 0u && type->cols == 1u && (se_soft_glsl_is_numeric(type->base) || type->base == SE_SOFT_GLSL_BOOL);
+}
+
+static b8 se_soft_glsl_is_scalar(const se_soft_glsl_type* type) {
+	return se_soft_glsl_is_vector(type) && type->rows == 1u;
+}
+
+static b8 se_soft_glsl_is_matrix(const se_soft_glsl_type* type) {
+	return type->array == 0u && type->cols > 1u && type->base == SE_SOFT_GLSL_FLOAT;
+}
+
+static u32 se_soft_glsl_components(const se_soft_glsl_type* type) {
+	return (u32)type->rows * (u32)type->cols;
+}
+
+static void se_soft_glsl_type_name(const se_soft_glsl_module* module, const se_soft_glsl_type* type, c8* out_name, const sz size) {
+	const c8* name = "?";
+	if (type->base == SE_SOFT_GLSL_STRUCT) {
+		name = module->structs[type->structure].name;
+	} else {
+		for (u32 i = 0u; i < sizeof(se_soft_glsl_type_names) / sizeof(se_soft_glsl_type_names[0]); ++i) {
+			if (se_soft_glsl_type_names[i].base == type->base && se_soft_glsl_type_names[i].rows == type->rows &&
+				se_soft_glsl_type_names[i].cols == type->cols) {
+				name = se_soft_glsl_type_names[i].name;
+				break;
+			}
+		}
+	}
+	if (type->array > 0u) {
+		snprintf(out_name, size, "%s[%u]", name, type->array);
+	} else {
+		snprintf(out_name, size, "%s", name);
+	}
+}
+
+static se_soft_glsl_value se_soft_glsl_convert_value(const u8 from, const u8 to, const se_soft_glsl_value value) {
+	se_soft_glsl_value out = value;
+	if (from == to) {
+		return out;
+	}
+	switch (to) {
+		case SE_SOFT_GLSL_FLOAT:
+			out.f = from == SE_SOFT_GLSL_UINT ? (f32)(u32)value.i : (from == SE_SOFT_GLSL_BOOL ? (value.i ? 1.0f : 0.0f) : (f32)value.i);
+			break;
+		case SE_SOFT_GLSL_INT:
+			if (from == SE_SOFT_GLSL_FLOAT) {
+				out.i = !(value.f == value.f) ? 0 : (value.f >= 2147483647.0f ? 2147483647 : (value.f <= -2147483648.0f ? (i32)(-2147483647 - 1) : (i32)value.f));
+			} else {
+				out.i = from == SE_SOFT_GLSL_BOOL ? (value.i != 0) : value.i;
+			}
+			break;
+		case SE_SOFT_GLSL_UINT:
+			if (from == SE_SOFT_GLSL_FLOAT) {
+				out.i = (i32)(!(value.f > 0.0f) ? 0u : (value.f >= 4294967295.0f ? 4294967295u : (u32)value.f));
+			} else {
+				out.i = from == SE_SOFT_GLSL_BOOL ? (value.i != 0) : value.i;
+			}
+			break;
+		case SE_SOFT_GLSL_BOOL:
+			out.i = from == SE_SOFT_GLSL_FLOAT ? value.f != 0.0f : value.i != 0;
+			break;
+		default:
+			break;
+	}
+	return out;
+}
+
+// Built-in functions
+
+typedef enum {
+	SE_SOFT_GLSL_FN_RADIANS = 0,
+	SE_SOFT_GLSL_FN_DEGREES,
+	SE_SOFT_GLSL_FN_SIN,
+	SE_SOFT_GLSL_FN_COS,
+	SE_SOFT_GLSL_FN_TAN,
+	SE_SOFT_GLSL_FN_ASIN,
+	SE_SOFT_GLSL_FN_ACOS,
+	SE_SOFT_GLSL_FN_ATAN,
+	SE_SOFT_GLSL_FN_SINH,
+	SE_SOFT_GLSL_FN_COSH,
+	SE_SOFT_GLSL_FN_TANH,
+	SE_SOFT_GLSL_FN_POW,
+	SE_SOFT_GLSL_FN_EXP,
+	SE_SOFT_GLSL_FN_LOG,
+	SE_SOFT_GLSL_FN_EXP2,
+	SE_SOFT_GLSL_FN_LOG2,
+	SE_SOFT_GLSL_FN_SQRT,
+	SE_SOFT_GLSL_FN_INVERSESQRT,
+	SE_SOFT_GLSL_FN_ABS,
+	SE_SOFT_GLSL_FN_SIGN,
+	SE_SOFT_GLSL_FN_FLOOR,
+	SE_SOFT_GLSL_FN_CEIL,
+	SE_SOFT_GLSL_FN_TRUNC,
+	SE_SOFT_GLSL_FN_ROUND,
+	SE_SOFT_GLSL_FN_ROUND_EVEN,
+	SE_SOFT_GLSL_FN_FRACT,
+	SE_SOFT_GLSL_FN_MOD,
+	SE_SOFT_GLSL_FN_MIN,
+	SE_SOFT_GLSL_FN_MAX,
+	SE_SOFT_GLSL_FN_CLAMP,
+	SE_SOFT_GLSL_FN_MIX,
+	SE_SOFT_GLSL_FN_STEP,
+	SE_SOFT_GLSL_FN_SMOOTHSTEP,
+	SE_SOFT_GLSL_FN_ISNAN,
+	SE_SOFT_GLSL_FN_ISINF,
+	SE_SOFT_GLSL_FN_FLOAT_BITS_TO_INT,
+	SE_SOFT_GLSL_FN_FLOAT_BITS_TO_UINT,
+	SE_SOFT_GLSL_FN_INT_BITS_TO_FLOAT,
+	SE_SOFT_GLSL_FN_UINT_BITS_TO_FLOAT,
+	SE_SOFT_GLSL_FN_LENGTH,
+	SE_SOFT_GLSL_FN_DISTANCE,
+	SE_SOFT_GLSL_FN_DOT,
+	SE_SOFT_GLSL_FN_CROSS,
+	SE_SOFT_GLSL_FN_NORMALIZE,
+	SE_SOFT_GLSL_FN_FACEFORWARD,
+	SE_SOFT_GLSL_FN_REFLECT,
+	SE_SOFT_GLSL_FN_REFRACT,
+	SE_SOFT_GLSL_FN_MATRIX_COMP_MULT,
+	SE_SOFT_GLSL_FN_OUTER_PRODUCT,
+	SE_SOFT_GLSL_FN_TRANSPOSE,
+	SE_SOFT_GLSL_FN_DETERMINANT,
+	SE_SOFT_GLSL_FN_INVERSE,
+	SE_SOFT_GLSL_FN_LESS_THAN,
+	SE_SOFT_GLSL_FN_LESS_THAN_EQUAL,
+	SE_SOFT_GLSL_FN_GREATER_THAN,
+	SE_SOFT_GLSL_FN_GREATER_THAN_EQUAL,
+	SE_SOFT_GLSL_FN_EQUAL,
+	SE_SOFT_GLSL_FN_NOT_EQUAL,
+	SE_SOFT_GLSL_FN_ANY,
+	SE_SOFT_GLSL_FN_ALL,
+	SE_SOFT_GLSL_FN_NOT,
+	SE_SOFT_GLSL_FN_TEXTURE,
+	SE_SOFT_GLSL_FN_TEXTURE_LOD,
+	SE_SOFT_GLSL_FN_TEXEL_FETCH,
+	SE_SOFT_GLSL_FN_TEXTURE_SIZE,
+	SE_SOFT_GLSL_FN_DFDX,
+	SE_SOFT_GLSL_FN_DFDY,
+	SE_SOFT_GLSL_FN_FWIDTH,
+	SE_SOFT_GLSL_FN_COUNT
+} se_soft_glsl_builtin;
+
+static const struct {
+	const c8* name;
+	u8 builtin;
+	u8 min_args;
+	u8 max_args;
+} se_soft_glsl_builtins[] = {
+	{ "radians", SE_SOFT_GLSL_FN_RADIANS, 1u, 1u },
+	{ "degrees", SE_SOFT_GLSL_FN_DEGREES, 1u, 1u },
+	{ "sin", SE_SOFT_GLSL_FN_SIN, 1u, 1u },
+	{ "cos", SE_SOFT_GLSL_FN_COS, 1u, 1u },
+	{ "tan", SE_SOFT_GLSL_FN_TAN, 1u, 1u },
+	{ "asin", SE_SOFT_GLSL_FN_ASIN, 1u, 1u },
+	{ "acos", SE_SOFT_GLSL_FN_ACOS, 1u, 1u },
+	{ "atan", SE_SOFT_GLSL_FN_ATAN, 1u, 2u },
+	{ "sinh", SE_SOFT_GLSL_FN_SINH, 1u, 1u },
+	{ "cosh", SE_SOFT_GLSL_FN_COSH, 1u, 1u },
+	{ "tanh", SE_SOFT_GLSL_FN_TANH, 1u, 1u },
+	{ "pow", SE_SOFT_GLSL_FN_POW, 2u, 2u },
+	{ "exp", SE_SOFT_GLSL_FN_EXP, 1u, 1u },
+	{ "log", SE_SOFT_GLSL_FN_LOG, 1u, 1u },
+	{ "exp2", SE_SOFT_GLSL_FN_EXP2, 1u, 1u },
+	{ "log2", SE_SOFT_GLSL_FN_LOG2, 1u, 1u },
+	{ "sqrt", SE_SOFT_GLSL_FN_SQRT, 1u, 1u },
+	{ "inversesqrt", SE_SOFT_GLSL_FN_INVERSESQRT, 1u, 1u },
+	{ "abs", SE_SOFT_GLSL_FN_ABS, 1u, 1u },
+	{ "sign", SE_SOFT_GLSL_FN_SIGN, 1u, 1u },
+	{ "floor", SE_SOFT_GLSL_FN_FLOOR, 1u, 1u },
+	{ "ceil", SE_SOFT_GLSL_FN_CEIL, 1u, 1u },
+	{ "trunc", SE_SOFT_GLSL_FN_TRUNC, 1u, 1u },
+	{ "round", SE_SOFT_GLSL_FN_ROUND, 1u, 1u },
+	{ "roundEven", SE_SOFT_GLSL_FN_ROUND_EVEN, 1u, 1u },
+	{ "fract", SE_SOFT_GLSL_FN_FRACT, 1u, 1u },
+	{ "mod", SE_SOFT_GLSL_FN_MOD, 2u, 2u },
+	{ "min", SE_SOFT_GLSL_FN_MIN, 2u, 2u },
+	{ "max", SE_SOFT_GLSL_FN_MAX, 2u, 2u },
+	{ "clamp", SE_SOFT_GLSL_FN_CLAMP, 3u, 3u },
+	{ "mix", SE_SOFT_GLSL_FN_MIX, 3u, 3u },
+	{ "step", SE_SOFT_GLSL_FN_STEP, 2u, 2u },
+	{ "smoothstep", SE_SOFT_GLSL_FN_SMOOTHSTEP, 3u, 3u },
+	{ "isnan", SE_SOFT_GLSL_FN_ISNAN, 1u, 1u },
+	{ "isinf", SE_SOFT_GLSL_FN_ISINF, 1u, 1u },
+	{ "floatBitsToInt", SE_SOFT_GLSL_FN_FLOAT_BITS_TO_INT, 1u, 1u },
+	{ "floatBitsToUint", SE_SOFT_GLSL_FN_FLOAT_BITS_TO_UINT, 1u, 1u },
+	{ "intBitsToFloat", SE_SOFT_GLSL_FN_INT_BITS_TO_FLOAT, 1u, 1u },
+	{ "uintBitsToFloat", SE_SOFT_GLSL_FN_UINT_BITS_TO_FLOAT, 1u, 1u },
+	{ "length", SE_SOFT_GLSL_FN_LENGTH, 1u, 1u },
+	{ "distance", SE_SOFT_GLSL_FN_DISTANCE, 2u, 2u },
+	{ "dot", SE_SOFT_GLSL_FN_DOT, 2u, 2u },
+	{ "cross", SE_SOFT_GLSL_FN_CROSS, 2u, 2u },
+	{ "normalize", SE_SOFT_GLSL_FN_NORMALIZE, 1u, 1u },
+	{ "faceforward", SE_SOFT_GLSL_FN_FACEFORWARD, 3u, 3u },
+	{ "reflect", SE_SOFT_GLSL_FN_REFLECT, 2u, 2u },
+	{ "refract", SE_SOFT_GLSL_FN_REFRACT, 3u, 3u },
+	{ "matrixCompMult", SE_SOFT_GLSL_FN_MATRIX_COMP_MULT, 2u, 2u },
+	{ "outerProduct", SE_SOFT_GLSL_FN_OUTER_PRODUCT, 2u, 2u },
+	{ "transpose", SE_SOFT_GLSL_FN_TRANSPOSE, 1u, 1u },
+	{ "determinant", SE_SOFT_GLSL_FN_DETERMINANT, 1u, 1u },
+	{ "inverse", SE_SOFT_GLSL_FN_INVERSE, 1u, 1u },
+	{ "lessThan", SE_SOFT_GLSL_FN_LESS_THAN, 2u, 2u },
+	{ "lessThanEqual", SE_SOFT_GLSL_FN_LESS_THAN_EQUAL, 2u, 2u },
+	{ "greaterThan", SE_SOFT_GLSL_FN_GREATER_THAN, 2u, 2u },
+	{ "greaterThanEqual", SE_SOFT_GLSL_FN_GREATER_THAN_EQUAL, 2u, 2u },
+	{ "equal", SE_SOFT_GLSL_FN_EQUAL, 2u, 2u },
+	{ "notEqual", SE_SOFT_GLSL_FN_NOT_EQUAL, 2u, 2u },
+	{ "any", SE_SOFT_GLSL_FN_ANY, 1u, 1u },
+	{ "all", SE_SOFT_GLSL_FN_ALL, 1u, 1u },
+	{ "not", SE_SOFT_GLSL_FN_NOT, 1u, 1u },
+	{ "texture", SE_SOFT_GLSL_FN_TEXTURE, 2u, 3u },
+	{ "texture2D", SE_SOFT_GLSL_FN_TEXTURE, 2u, 3u },
+	{ "texture3D", SE_SOFT_GLSL_FN_TEXTURE, 2u, 3u },
+	{ "textureLod", SE_SOFT_GLSL_FN_TEXTURE_LOD, 3u, 3u },
+	{ "texelFetch", SE_SOFT_GLSL_FN_TEXEL_FETCH, 3u, 3u },
+	{ "textureSize", SE_SOFT_GLSL_FN_TEXTURE_SIZE, 2u, 2u },
+	{ "dFdx", SE_SOFT_GLSL_FN_DFDX, 1u, 1u },
+	{ "dFdy", SE_SOFT_GLSL_FN_DFDY, 1u, 1u },
+	{ "fwidth", SE_SOFT_GLSL_FN_FWIDTH, 1u, 1u }
+};
+
+// Evaluation
+
+typedef enum {
+	SE_SOFT_GLSL_FLOW_NEXT = 0,
+	SE_SOFT_GLSL_FLOW_BREAK,
+	SE_SOFT_GLSL_FLOW_CONTINUE,
+	SE_SOFT_GLSL_FLOW_RETURN,
+	SE_SOFT_GLSL_FLOW_DISCARD
+} se_soft_glsl_flow;
+
+typedef struct {
+	const se_soft_glsl_module* module;
+	se_soft_glsl_value* memory;
+	const se_soft_glsl_value* shared;
+	const se_soft_glsl_draw* draw;
+	b8 discarded;
+} se_soft_glsl_exec;
+
+// A writable location: `count` slots from `base`, or the components `map` of `base` for swizzles.
+typedef struct {
+	se_soft_glsl_value* base;
+	u32 count;
+	u8 map[4];
+	b8 mapped;
+} se_soft_glsl_lvalue;
+
+static const se_soft_glsl_value* se_soft_glsl_eval(se_soft_glsl_exec* exec, u32 index);
+static se_soft_glsl_flow se_soft_glsl_exec_statement(se_soft_glsl_exec* exec, u32 index);
+
+static void se_soft_glsl_eval_lvalue(se_soft_glsl_exec* exec, const u32 index, se_soft_glsl_lvalue* out_lvalue) {
+	const se_soft_glsl_node* node = &exec->module->nodes[index];
+	switch (node->op) {
+		case SE_SOFT_GLSL_OP_INDEX: {
+			se_soft_glsl_eval_lvalue(exec, node->a, out_lvalue);
+			i32 element = se_soft_glsl_eval(exec, node->b)->i;
+			element = element < 0 ? 0 : ((u32)element >= node->c ? (i32)node->c - 1 : element);
+			if (out_lvalue->mapped) {
+				out_lvalue->map[0] = out_lvalue->map[element];
+				out_lvalue->count = 1u;
+			} else {
+				out_lvalue->base += (u32)element * node->aux;
+				out_lvalue->count = node->aux;
+			}
+			return;
+		}
+		case SE_SOFT_GLSL_OP_FIELD: {
+			se_soft_glsl_eval_lvalue(exec, node->a, out_lvalue);
+			const u32 count = se_soft_glsl_type_slots(exec->module, &node->type);
+			if (out_lvalue->mapped) {
+				for (u32 i = 0u; i < count; ++i) {
+					out_lvalue->map[i] = out_lvalue->map[node->aux + i];
+				}
+			} else {
+				out_lvalue->base += node->aux;
+			}
+			out_lvalue->count = count;
+			return;
+		}
+		case SE_SOFT_GLSL_OP_SWIZZLE: {
+			se_soft_glsl_eval_lvalue(exec, node->a, out_lvalue);
+			u8 map[4];
+			for (u32 i = 0u; i < node->c; ++i) {
+				const u32 component = (node->aux >> (2u * i)) & 3u;
+				map[i] = out_lvalue->mapped ? out_lvalue->map[component] : (u8)component;
+			}
+			memcpy(out_lvalue->map, map, sizeof(map));
+			out_lvalue->count = node->c;
+			out_lvalue->mapped = true;
+			return;
+		}
+		default:
+			out_lvalue->base = exec->memory + node->slot;
+			out_lvalue->count = se_soft_glsl_type_slots(exec->module, &node->type);
+			out_lvalue->mapped = false;
+			return;
+	}
+}
+
+static void se_soft_glsl_store(const se_soft_glsl_lvalue* lvalue, const se_soft_glsl_value* value) {
+	if (!lvalue->mapped) {
+		memmove(lvalue->base, value, sizeof(*value) * lvalue->count);
+		return;
+	}
+	// The source may alias the destination vector, as in v.yz = v.xy.
+	se_soft_glsl_value copy[4];
+	memcpy(copy, value, sizeof(*value) * lvalue->count);
+	for (u32 i = 0u; i < lvalue->count; ++i) {
+		lvalue->base[lvalue->map[i]] = copy[i];
+	}
+}
+
+static void se_soft_glsl_eval_binary(se_soft_glsl_exec* exec, const se_soft_glsl_node* node, se_soft_glsl_value* out) {
+	const se_soft_glsl_value* a = se_soft_glsl_eval(exec, node->a);
+	const se_soft_glsl_value* b = se_soft_glsl_eval(exec, node->b);
+	const u32 step_a = (node->c & 1u) ? 0u : 1u;
+	const u32 step_b = (node->c & 2u) ? 0u : 1u;
+	const u32 count = node->d;
+	if (node->operand_base == SE_SOFT_GLSL_FLOAT) {
+		for (u32 i = 0u; i < count; ++i) {
+			const f32 x = a[i * step_a].f;
+			const f32 y = b[i * step_b].f;
+			switch (node->aux) {
+				case SE_SOFT_GLSL_BINARY_ADD: out[i].f = x + y; break;
+				case SE_SOFT_GLSL_BINARY_SUB: out[i].f = x - y; break;
+				case SE_SOFT_GLSL_BINARY_MUL: out[i].f = x * y; break;
+				case SE_SOFT_GLSL_BINARY_DIV: out[i].f = x / y; break;
+				case SE_SOFT_GLSL_BINARY_LESS: out[i].i = x < y; break;
+				case SE_SOFT_GLSL_BINARY_GREATER: out[i].i = x > y; break;
+				case SE_SOFT_GLSL_BINARY_LESS_EQUAL: out[i].i = x <= y; break;
+				case SE_SOFT_GLSL_BINARY_GREATER_EQUAL: out[i].i = x >= y; break;
+				default: out[i].f = 0.0f; break;
+			}
+		}
+		return;
+	}
+	const b8 is_signed = node->operand_base == SE_SOFT_GLSL_INT;
+	for (u32 i = 0u; i < count; ++i) {
+		const i32 x = a[i * step_a].i;
+		const i32 y = b[i * step_b].i;
+		const u32 ux = (u32)x;
+		const u32 uy = (u32)y;
+		i32 result = 0;
+		switch (node->aux) {
+			case SE_SOFT_GLSL_BINARY_ADD: result = (i32)(ux + uy); break;
+			case SE_SOFT_GLSL_BINARY_SUB: result = (i32)(ux - uy); break;
+			case SE_SOFT_GLSL_BINARY_MUL: result = (i32)(ux * uy); break;
+			case SE_SOFT_GLSL_BINARY_DIV:
+				if (y != 0) {
+					result = is_signed ? ((y == -1) ? (i32)(0u - ux) : x / y) : (i32)(ux / uy);
+				}
+				break;
+			case SE_SOFT_GLSL_BINARY_MOD:
+				if (y != 0) {
+					result = is_signed ? ((y == -1) ? 0 : x % y) : (i32)(ux % uy);
+				}
+				break;
+			case SE_SOFT_GLSL_BINARY_LESS: result = is_signed ? x < y : ux < uy; break;
+			case SE_SOFT_GLSL_BINARY_GREATER: result = is_signed ? x > y : ux > uy; break;
+			case SE_SOFT_GLSL_BINARY_LESS_EQUAL: result = is_signed ? x <= y : ux <= uy; break;
+			case SE_SOFT_GLSL_BINARY_GREATER_EQUAL: result = is_signed ? x >= y : ux >= uy; break;
+			case SE_SOFT_GLSL_BINARY_BIT_AND: result = (i32)(ux & uy); break;
+			case SE_SOFT_GLSL_BINARY_BIT_OR: result = (i32)(ux | uy); break;
+			case SE_SOFT_GLSL_BINARY_BIT_XOR: result = (i32)(ux ^ uy); break;
+			case SE_SOFT_GLSL_BINARY_SHIFT_LEFT: result = (i32)(ux << (uy & 31u)); break;
+			case SE_SOFT_GLSL_BINARY_SHIFT_RIGHT: result = is_signed ? x >> (uy & 31u) : (i32)(ux >> (uy & 31u)); break;
+			default: break;
+		}
+		out[i].i = result;
+	}
+}
+
+// Gauss-Jordan elimination on a column-major n x n matrix; `out_inverse` may be NULL.
+static f32 se_soft_glsl_invert(const se_soft_glsl_value* matrix, const u32 n, se_soft_glsl_value* out_inverse) {
+	f64 m[4][8];
+	for (u32 r = 0u; r < n; ++r) {
+		for (u32 c = 0u; c < n; ++c) {
+			m[r][c] = matrix[c * n + r].f;
+			m[r][n + c] = r == c ? 1.0 : 0.0;
+		}
+	}
+	f64 determinant = 1.0;
+	for (u32 c = 0u; c < n; ++c) {
+		u32 pivot = c;
+		for (u32 r = c + 1u; r < n; ++r) {
+			if (fabs(m[r][c]) > fabs(m[pivot][c])) {
+				pivot = r;
+			}
+		}
+		if (m[pivot][c] == 0.0) {
+			determinant = 0.0;
+			break;
+		}
+		if (pivot != c) {
+			for (u32 k = 0u; k < 2u * n; ++k) {
+				const f64 swap = m[c][k];
+				m[c][k] = m[pivot][k];
+				m[pivot][k] = swap;
+			}
+			determinant = -determinant;
+		}
+		const f64 diagonal = m[c][c];
+		determinant *= diagonal;
+		for (u32 k = 0u; k < 2u * n; ++k) {
+			m[c][k] /= diagonal;
+		}
+		for (u32 r = 0u; r < n; ++r) {
+			if (r != c && m[r][c] != 0.0) {
+				const f64 factor = m[r][c];
+				for (u32 k = 0u; k < 2u * n; ++k) {
+					m[r][k] -= factor * m[c][k];
+				}
+			}
+		}
+	}
+	if (out_inverse) {
+		for (u32 r = 0u; r < n; ++r) {
+			for (u32 c = 0u; c < n; ++c) {
+				out_inverse[c * n + r].f = determinant == 0.0 ? 0.0f : (f32)m[r][n + c];
+			}
+		}
+	}
+	return (f32)determinant;
+}
+
+static void se_soft_glsl_sample(se_soft_glsl_exec* exec, const u32 sampler_node, const i32 unit, const se_soft_sampler** out_sampler, u32* out_dimensions) {
+	const b8 is_3d = exec->module->nodes[sampler_node].type.base == SE_SOFT_GLSL_SAMPLER3D;
+	*out_dimensions = is_3d ? 3u : 2u;
+	*out_sampler = NULL;
+	if (exec->draw && unit >= 0 && (u32)unit < SE_SOFT_GLSL_MAX_TEXTURE_UNITS) {
+		*out_sampler = &exec->draw->samplers[unit][is_3d ? SE_SOFT_GLSL_SAMPLER_3D : SE_SOFT_GLSL_SAMPLER_2D];
+	}
+}
+
+static void se_soft_glsl_eval_builtin(se_soft_glsl_exec* exec, const se_soft_glsl_node* node, se_soft_glsl_value* out) {
+	const se_soft_glsl_module* module = exec->module;
+	const u32* args = &module->lists[node->a];
+	const se_soft_glsl_value* v[3] = { NULL, NULL, NULL };
+	u32 n[3] = { 0u, 0u, 0u };
+	for (u32 k = 0u; k < node->b && k < 3u; ++k) {
+		v[k] = se_soft_glsl_eval(exec, args[k]);
+		n[k] = se_soft_glsl_components(&module->nodes[args[k]].type);
+	}
+	const u32 count = se_soft_glsl_components(&node->type);
+	const b8 is_float = node->operand_base == SE_SOFT_GLSL_FLOAT;
+	const b8 is_signed = node->operand_base == SE_SOFT_GLSL_INT;
+#define SE_SOFT_GLSL_X(i) (v[0][n[0] == 1u ? 0u : (i)])
+#define SE_SOFT_GLSL_Y(i) (v[1][n[1] == 1u ? 0u : (i)])
+#define SE_SOFT_GLSL_Z(i) (v[2][n[2] == 1u ? 0u : (i)])
+	switch (node->aux) {
+		case SE_SOFT_GLSL_FN_RADIANS: for (u32 i = 0u; i < count; ++i) out[i].f = SE_SOFT_GLSL_X(i).f * 0.017453292519943295f; break;
+		case SE_SOFT_GLSL_FN_DEGREES: for (u32 i = 0u; i < count; ++i) out[i].f = SE_SOFT_GLSL_X(i).f * 57.29577951308232f; break;
+		case SE_SOFT_GLSL_FN_SIN: for (u32 i = 0u; i < count; ++i) out[i].f = sinf(SE_SOFT_GLSL_X(i).f); break;
+		case SE_SOFT_GLSL_FN_COS: for (u32 i = 0u; i < count; ++i) out[i].f = cosf(SE_SOFT_GLSL_X(i).f); break;
+		case SE_SOFT_GLSL_FN_TAN: for (u32 i = 0u; i < count; ++i) out[i].f = tanf(SE_SOFT_GLSL_X(i).f); break;
+		case SE_SOFT_GLSL_FN_ASIN: for (u32 i = 0u; i < count; ++i) out[i].f = asinf(SE_SOFT_GLSL_X(i).f); break;
+		case SE_SOFT_GLSL_FN_ACOS: for (u32 i = 0u; i < count; ++i) out[i].f = acosf(SE_SOFT_GLSL_X(i).f); break;
+		case SE_SOFT_GLSL_FN_ATAN:
+			for (u32 i = 0u; i < count; ++i) {
+				out[i].f = node->b == 2u ? atan2f(SE_SOFT_GLSL_X(i).f, SE_SOFT_GLSL_Y(i).f) : atanf(SE_SOFT_GLSL_X(i).f);
+			}
+			break;
+		case SE_SOFT_GLSL_FN_SINH: for (u32 i = 0u; i < count; ++i) out[i].f = sinhf(SE_SOFT_GLSL_X(i).f); break;
+		case SE_SOFT_GLSL_FN_COSH: for (u32 i = 0u; i < count; ++i) out[i].f = coshf(SE_SOFT_GLSL_X(i).f); break;
+		case SE_SOFT_GLSL_FN_TANH: for (u32 i = 0u; i < count; ++i) out[i].f = tanhf(SE_SOFT_GLSL_X(i).f); break;
+		case SE_SOFT_GLSL_FN_POW: for (u32 i = 0u; i < count; ++i) out[i].f = powf(SE_SOFT_GLSL_X(i).f, SE_SOFT_GLSL_Y(i).f); break;
+		case SE_SOFT_GLSL_FN_EXP: for (u32 i = 0u; i < count; ++i) out[i].f = expf(SE_SOFT_GLSL_X(i).f); break;
+		case SE_SOFT_GLSL_FN_LOG: for (u32 i = 0u; i < count; ++i) out[i].f = logf(SE_SOFT_GLSL_X(i).f); break;
+		case SE_SOFT_GLSL_FN_EXP2: for (u32 i = 0u; i < count; ++i) out[i].f = exp2f(SE_SOFT_GLSL_X(i).f); break;
+		case SE_SOFT_GLSL_FN_LOG2: for (u32 i = 0u; i < count; ++i) out[i].f = log2f(SE_SOFT_GLSL_X(i).f); break;
+		case SE_SOFT_GLSL_FN_SQRT: for (u32 i = 0u; i < count; ++i) out[i].f = sqrtf(SE_SOFT_GLSL_X(i).f); break;
+		case SE_SOFT_GLSL_FN_INVERSESQRT: for (u32 i = 0u; i < count; ++i) out[i].f = 1.0f / sqrtf(SE_SOFT_GLSL_X(i).f); break;
+		case SE_SOFT_GLSL_FN_ABS:
+			for (u32 i = 0u; i < count; ++i) {
+				if (is_float) {
+					out[i].f = fabsf(SE_SOFT_GLSL_X(i).f);
+				} else {
+					out[i].i = SE_SOFT_GLSL_X(i).i < 0 ? (i32)(0u - (u32)SE_SOFT_GLSL_X(i).i) : SE_SOFT_GLSL_X(i).i;
+				}
+			}
+			break;
+		case SE_SOFT_GLSL_FN_SIGN:
+			for (u32 i = 0u; i < count; ++i) {
+				if (is_float) {
+					const f32 x = SE_SOFT_GLSL_X(i).f;
+					out[i].f = x > 0.0f ? 1.0f : (x < 0.0f ? -1.0f : 0.0f);
+				} else {
+					out[i].i = (SE_SOFT_GLSL_X(i).i > 0) - (SE_SOFT_GLSL_X(i).i < 0);
+				}
+			}
+			break;
+		case SE_SOFT_GLSL_FN_FLOOR: for (u32 i = 0u; i < count; ++i) out[i].f = floorf(SE_SOFT_GLSL_X(i).f); break;
+		case SE_SOFT_GLSL_FN_CEIL: for (u32 i = 0u; i < count; ++i) out[i].f = ceilf(SE_SOFT_GLSL_X(i).f); break;
+		case SE_SOFT_GLSL_FN_TRUNC: for (u32 i = 0u; i < count; ++i) out[i].f = truncf(SE_SOFT_GLSL_X(i).f); break;
+		case SE_SOFT_GLSL_FN_ROUND: for (u32 i = 0u; i < count; ++i) out[i].f = roundf(SE_SOFT_GLSL_X(i).f); break;
+		case SE_SOFT_GLSL_FN_ROUND_EVEN: for (u32 i = 0u; i < count; ++i) out[i].f = rintf(SE_SOFT_GLSL_X(i).f); break;
+		case SE_SOFT_GLSL_FN_FRACT: for (u32 i = 0u; i < count; ++i) out[i].f = SE_SOFT_GLSL_X(i).f - floorf(SE_SOFT_GLSL_X(i).f); break;
+		case SE_SOFT_GLSL_FN_MOD:
+			for (u32 i = 0u; i < count; ++i) {
+				const f32 x = SE_SOFT_GLSL_X(i).f;
+				const f32 y = SE_SOFT_GLSL_Y(i).f;
+				out[i].f = x - y * floorf(x / y);
+			}
+			break;
+		case SE_SOFT_GLSL_FN_MIN:
+		case SE_SOFT_GLSL_FN_MAX:
+		case SE_SOFT_GLSL_FN_CLAMP:
+			for (u32 i = 0u; i < count; ++i) {
+				se_soft_glsl_value x = SE_SOFT_GLSL_X(i);
+				const b8 has_lo = node->aux != SE_SOFT_GLSL_FN_MIN;
+				const b8 has_hi = node->aux != SE_SOFT_GLSL_FN_MAX;
+				const se_soft_glsl_value lo = SE_SOFT_GLSL_Y(i);
+				const se_soft_glsl_value hi = node->aux == SE_SOFT_GLSL_FN_CLAMP ? SE_SOFT_GLSL_Z(i) : SE_SOFT_GLSL_Y(i);
+				if (is_float) {
+					x.f = has_lo && lo.f > x.f ? lo.f : x.f;
+					x.f = has_hi && hi.f < x.f ? hi.f : x.f;
+				} else if (is_signed) {
+					x.i = has_lo && lo.i > x.i ? lo.i : x.i;
+					x.i = has_hi && hi.i < x.i ? hi.i : x.i;
+				} else {
+					x.i = has_lo && (u32)lo.i > (u32)x.i ? lo.i : x.i;
+					x.i = has_hi && (u32)hi.i < (u32)x.i ? hi.i : x.i;
+				}
+				out[i] = x;
+			}
+			break;
+		case SE_SOFT_GLSL_FN_MIX:
+			for (u32 i = 0u; i < count; ++i) {
+				const f32 x = SE_SOFT_GLSL_X(i).f;
+				const f32 y = SE_SOFT_GLSL_Y(i).f;
+				if (module->nodes[args[2]].type.base == SE_SOFT_GLSL_BOOL) {
+					out[i].f = SE_SOFT_GLSL_Z(i).i ? y : x;
+				} else {
+					const f32 a = SE_SOFT_GLSL_Z(i).f;
+					out[i].f = x * (1.0f - a) + y * a;
+				}
+			}
+			break;
+		case SE_SOFT_GLSL_FN_STEP: for (u32 i = 0u; i < count; ++i) out[i].f = SE_SOFT_GLSL_Y(i).f < SE_SOFT_GLSL_X(i).f ? 0.0f : 1.0f; break;
+		case SE_SOFT_GLSL_FN_SMOOTHSTEP:
+			for (u32 i = 0u; i < count; ++i) {
+				const f32 edge0 = SE_SOFT_GLSL_X(i).f;
+				f32 t = (SE_SOFT_GLSL_Z(i).f - edge0) / (SE_SOFT_GLSL_Y(i).f - edge0);
+				t = t > 0.0f ? (t < 1.0f ? t : 1.0f) : 0.0f;
+				out[i].f = t * t * (3.0f - 2.0f * t);
+			}
+			break;
+		case SE_SOFT_GLSL_FN_ISNAN: for (u32 i = 0u; i < count; ++i) out[i].i = isnan(SE_SOFT_GLSL_X(i).f) ? 1 : 0; break;
+		case SE_SOFT_GLSL_FN_ISINF: for (u32 i = 0u; i < count; ++i) out[i].i = isinf(SE_SOFT_GLSL_X(i).f) ? 1 : 0; break;
+		case SE_SOFT_GLSL_FN_FLOAT_BITS_TO_INT:
+		case SE_SOFT_GLSL_FN_FLOAT_BITS_TO_UINT:
+		case SE_SOFT_GLSL_FN_INT_BITS_TO_FLOAT:
+		case SE_SOFT_GLSL_FN_UINT_BITS_TO_FLOAT:
+			memmove(out, v[0], sizeof(*out) * count);
+			break;
+		case SE_SOFT_GLSL_FN_LENGTH:
+		case SE_SOFT_GLSL_FN_DISTANCE:
+		case SE_SOFT_GLSL_FN_DOT: {
+			f32 sum = 0.0f;
+			for (u32 i = 0u; i < n[0]; ++i) {
+				const f32 x = v[0][i].f;
+				const f32 y = node->aux == SE_SOFT_GLSL_FN_LENGTH ? x : v[1][i].f;
+				sum += node->aux == SE_SOFT_GLSL_FN_DISTANCE ? (x - y) * (x - y) : x * y;
+			}
+			out[0].f = node->aux == SE_SOFT_GLSL_FN_DOT ? sum : sqrtf(sum);
+			break;
+		}
+		case SE_SOFT_GLSL_FN_CROSS: {
+			const f32 ax = v[0][0].f, ay = v[0][1].f, az = v[0][2].f;
+			const f32 bx = v[1][0].f, by = v[1][1].f, bz = v[1][2].f;
+			out[0].f = ay * bz - az * by;
+			out[1].f = az * bx - ax * bz;
+			out[2].f = ax * by - ay * bx;
+			break;
+		}
+		case SE_SOFT_GLSL_FN_NORMALIZE: {
+			f32 sum = 0.0f;
+			for (u32 i = 0u; i < count; ++i) {
+				sum += v[0][i].f * v[0][i].f;
+			}
+			const f32 scale = 1.0f / sqrtf(sum);
+			for (u32 i = 0u; i < count; ++i) {
+				out[i].f = v[0][i].f * scale;
+			}
+			break;
+		}
+		case SE_SOFT_GLSL_FN_FACEFORWARD: {
+			f32 d = 0.0f;
+			for (u32 i = 0u; i < count; ++i) {
+				d += v[2][i].f * v[1][i].f;
+			}
+			for (u32 i = 0u; i < count; ++i) {
+				out[i].f = d < 0.0f ? v[0][i].f : -v[0][i].f;
+			}
+			break;
+		}
+		case SE_SOFT_GLSL_FN_REFLECT:
+		case SE_SOFT_GLSL_FN_REFRACT: {
+			f32 d = 0.0f;
+			for (u32 i = 0u; i < count; ++i) {
+				d += v[1][i].f * v[0][i].f;
+			}
+			if (node->aux == SE_SOFT_GLSL_FN_REFLECT) {
+				for (u32 i = 0u; i < count; ++i) {
+					out[i].f = v[0][i].f - 2.0f * d * v[1][i].f;
+				}
+				break;
+			}
+			const f32 eta = v[2][0].f;
+			const f32 k = 1.0f - eta * eta * (1.0f - d * d);
+			for (u32 i = 0u; i < count; ++i) {
+				out[i].f = k < 0.0f ? 0.0f : eta * v[0][i].f - (eta * d + sqrtf(k)) * v[1][i].f;
+			}
+			break;
+		}
+		case SE_SOFT_GLSL_FN_MATRIX_COMP_MULT: for (u32 i = 0u; i < count; ++i) out[i].f = v[0][i].f * v[1][i].f; break;
+		case SE_SOFT_GLSL_FN_OUTER_PRODUCT:
+			for (u32 c = 0u; c < node->type.cols; ++c) {
+				for (u32 r = 0u; r < node->type.rows; ++r) {
+					out[c * node->type.rows + r].f = v[0][r].f * v[1][c].f;
+				}
+			}
+			break;
+		case SE_SOFT_GLSL_FN_TRANSPOSE: {
+			se_soft_glsl_value copy[16];
+			memcpy(copy, v[0], sizeof(*out) * count);
+			for (u32 c = 0u; c < node->type.cols; ++c) {
+				for (u32 r = 0u; r < node->type.rows; ++r) {
+					out[c * node->type.rows + r] = copy[r * node->type.cols + c];
+				}
+			}
+			break;
+		}
+		case SE_SOFT_GLSL_FN_DETERMINANT: out[0].f = se_soft_glsl_invert(v[0], module->nodes[args[0]].type.rows, NULL); break;
+		case SE_SOFT_GLSL_FN_INVERSE: {
+			se_soft_glsl_value copy[16];
+			memcpy(copy, v[0], sizeof(*out) * count);
+			se_soft_glsl_invert(copy, node->type.rows, out);
+			break;
+		}
+		case SE_SOFT_GLSL_FN_LESS_THAN:
+		case SE_SOFT_GLSL_FN_LESS_THAN_EQUAL:
+		case SE_SOFT_GLSL_FN_GREATER_THAN:
+		case SE_SOFT_GLSL_FN_GREATER_THAN_EQUAL:
+		case SE_SOFT_GLSL_FN_EQUAL:
+		case SE_SOFT_GLSL_FN_NOT_EQUAL:
+			for (u32 i = 0u; i < count; ++i) {
+				const se_soft_glsl_value x = v[0][i];
+				const se_soft_glsl_value y = v[1][i];
+				i32 order = 0;
+				if (is_float) {
+					order = x.f < y.f ? -1 : (x.f > y.f ? 1 : (x.f == y.f ? 0 : 2));
+				} else if (is_signed || node->operand_base == SE_SOFT_GLSL_BOOL) {
+					order = x.i < y.i ? -1 : (x.i > y.i ? 1 : 0);
+				} else {
+					order = (u32)x.i < (u32)y.i ? -1 : ((u32)x.i > (u32)y.i ? 1 : 0);
+				}
+				switch (node->aux) {
+					case SE_SOFT_GLSL_FN_LESS_THAN: out[i].i = order == -1; break;
+					case SE_SOFT_GLSL_FN_LESS_THAN_EQUAL: out[i].i = order == -1 || order == 0; break;
+					case SE_SOFT_GLSL_FN_GREATER_THAN: out[i].i = order == 1; break;
+					case SE_SOFT_GLSL_FN_GREATER_THAN_EQUAL: out[i].i = order == 1 || order == 0; break;
+					case SE_SOFT_GLSL_FN_EQUAL: out[i].i = order == 0; break;
+					default: out[i].i = order != 0; break;
+				}
+			}
+			break;
+		case SE_SOFT_GLSL_FN_ANY:
+		case SE_SOFT_GLSL_FN_ALL: {
+			i32 result = node->aux == SE_SOFT_GLSL_FN_ALL;
+			for (u32 i = 0u; i < n[0]; ++i) {
+				result = node->aux == SE_SOFT_GLSL_FN_ALL ? (result && v[0][i].i) : (result || v[0][i].i);
+			}
+			out[0].i = result;
+			break;
+		}
+		case SE_SOFT_GLSL_FN_NOT: for (u32 i = 0u; i < count; ++i) out[i].i = !v[0][i].i; break;
+		case SE_SOFT_GLSL_FN_TEXTURE:
+		case SE_SOFT_GLSL_FN_TEXTURE_LOD: {
+			const se_soft_sampler* sampler = NULL;
+			u32 dimensions = 0u;
+			se_soft_glsl_sample(exec, args[0], v[0][0].i, &sampler, &dimensions);
+			f32 coords[3] = { v[1][0].f, v[1][1].f, dimensions == 3u ? v[1][2].f : 0.0f };
+			f32 color[4] = { 0.0f, 0.0f, 0.0f, 1.0f };
+			if (sampler) {
+				se_soft_sample(sampler, coords, dimensions, color);
+			}
+			for (u32 i = 0u; i < 4u; ++i) {
+				out[i].f = color[i];
+			}
+			break;
+		}
+		case SE_SOFT_GLSL_FN_TEXEL_FETCH: {
+			const se_soft_sampler* sampler = NULL;
+			u32 dimensions = 0u;
+			se_soft_glsl_sample(exec, args[0], v[0][0].i, &sampler, &dimensions);
+			f32 color[4] = { 0.0f, 0.0f, 0.0f, 1.0f };
+			const se_soft_image* image = sampler ? sampler->image : NULL;
+			const i32 x = v[1][0].i;
+			const i32 y = v[1][1].i;
+			const i32 z = dimensions == 3u ? v[1][2].i : 0;
+			if (image && image->texels && v[2][0].i == 0 && x >= 0 && y >= 0 && z >= 0 &&
+				(u32)x < image->width && (u32)y < image->height && (u32)z < image->depth) {
+				se_soft_image_load(image, (u32)x, (u32)y, (u32)z, color);
+			}
+			for (u32 i = 0u; i < 4u; ++i) {
+				out[i].f = color[i];
+			}
+			break;
+		}
+		case SE_SOFT_GLSL_FN_TEXTURE_SIZE: {
+			const se_soft_sampler* sampler = NULL;
+			u32 dimensions = 0u;
+			se_soft_glsl_sample(exec, args[0], v[0][0].i, &sampler, &dimensions);
+			const se_soft_image* image = sampler ? sampler->image : NULL;
+			const u32 lod = v[1][0].i > 0 ? (u32)v[1][0].i : 0u;
+			const u32 sizes[3] = { image ? image->width : 0u, image ? image->height : 0u, image ? image->depth : 0u };
+			for (u32 i = 0u; i < dimensions; ++i) {
+				const u32 size = lod < 32u ? sizes[i] >> lod : 0u;
+				out[i].i = (i32)(size > 0u || sizes[i] == 0u ? size : 1u);
+			}
+			break;
+		}
+		default:
+			// Derivatives: every fragment is shaded on its own, so there are no neighbours to difference.
+			for (u32 i = 0u; i < count; ++i) {
+				out[i].f = 0.0f;
+			}
+			break;
+	}
+#undef SE_SOFT_GLSL_X
+#undef SE_SOFT_GLSL_Y
+#undef SE_SOFT_GLSL_Z
+}
+
+static void se_soft_glsl_eval_construct(se_soft_glsl_exec* exec, const se_soft_glsl_node* node, se_soft_glsl_value* out) {
+	const se_soft_glsl_module* module = exec->module;
+	const u32* args = &module->lists[node->a];
+	const u32 total = se_soft_glsl_type_slots(module, &node->type);
+	const u8 base = node->type.base;
+	switch (node->aux) {
+		case SE_SOFT_GLSL_CONSTRUCT_BROADCAST:
+		case SE_SOFT_GLSL_CONSTRUCT_DIAGONAL: {
+			const se_soft_glsl_value value = se_soft_glsl_convert_value(module->nodes[args[0]].type.base, base, se_soft_glsl_eval(exec, args[0])[0]);
+			for (u32 i = 0u; i < total; ++i) {
+				const u32 column = i / node->type.rows;
+				const u32 row = i % node->type.rows;
+				if (node->aux == SE_SOFT_GLSL_CONSTRUCT_BROADCAST || column == row) {
+					out[i] = value;
+				} else {
+					out[i].f = 0.0f;
+				}
+			}
+			return;
+		}
+		case SE_SOFT_GLSL_CONSTRUCT_MATRIX: {
+			const se_soft_glsl_type* source_type = &module->nodes[args[0]].type;
+			const se_soft_glsl_value* source = se_soft_glsl_eval(exec, args[0]);
+			for (u32 c = 0u; c < node->type.cols; ++c) {
+				for (u32 r = 0u; r < node->type.rows; ++r) {
+					se_soft_glsl_value value = {0};
+					if (c < source_type->cols && r < source_type->rows) {
+						value = source[c * source_type->rows + r];
+					} else {
+						value.f = c == r ? 1.0f : 0.0f;
+					}
+					out[c * node->type.rows + r] = value;
+				}
+			}
+			return;
+		}
+		case SE_SOFT_GLSL_CONSTRUCT_AGGREGATE: {
+			u32 offset = 0u;
+			for (u32 k = 0u; k < node->b; ++k) {
+				const u32 slots = se_soft_glsl_type_slots(module, &module->nodes[args[k]].type);
+				memmove(out + offset, se_soft_glsl_eval(exec, args[k]), sizeof(*out) * slots);
+				offset += slots;
+			}
+			return;
+		}
+		default: {
+			u32 offset = 0u;
+			for (u32 k = 0u; k < node->b && offset < total; ++k) {
+				const se_soft_glsl_type* type = &module->nodes[args[k]].type;
+				const se_soft_glsl_value* value = se_soft_glsl_eval(exec, args[k]);
+				const u32 count = se_soft_glsl_components(type);
+				for (u32 i = 0u; i < count && offset < total; ++i) {
+					out[offset++] = se_soft_glsl_convert_value(type->base, base, value[i]);
+				}
+			}
+			return;
+		}
+	}
+}
+
+static void se_soft_glsl_eval_call(se_soft_glsl_exec* exec, const se_soft_glsl_node* node, se_soft_glsl_value* out) {
+	const se_soft_glsl_module* module = exec->module;
+	const se_soft_glsl_function* function = &module->functions[node->aux];
+	const u32* args = &module->lists[node->a];
+	const se_soft_glsl_value* values[SE_SOFT_GLSL_MAX_PARAMS];
+	// Evaluate every argument before binding any: a nested call to the same function reuses its parameter slots.
+	for (u32 k = 0u; k < node->b; ++k) {
+		const se_soft_glsl_variable* param = &module->variables[function->params[k]];
+		values[k] = param->qualifier == SE_SOFT_GLSL_QUALIFIER_OUT ? NULL : se_soft_glsl_eval(exec, args[k]);
+	}
+	for (u32 k = 0u; k < node->b; ++k) {
+		const se_soft_glsl_variable* param = &module->variables[function->params[k]];
+		if (values[k]) {
+			memmove(exec->memory + param->offset, values[k], sizeof(*out) * se_soft_glsl_type_slots(module, &param->type));
+		}
+	}
+	se_soft_glsl_exec_statement(exec, function->body);
+	for (u32 k = 0u; k < node->b; ++k) {
+		const se_soft_glsl_variable* param = &module->variables[function->params[k]];
+		if (param->qualifier == SE_SOFT_GLSL_QUALIFIER_OUT || param->qualifier == SE_SOFT_GLSL_QUALIFIER_INOUT) {
+			se_soft_glsl_lvalue lvalue;
+			se_soft_glsl_eval_lvalue(exec, args[k], &lvalue);
+			se_soft_glsl_store(&lvalue, exec->memory + param->offset);
+		}
+	}
+	if (function->return_type.base != SE_SOFT_GLSL_VOID) {
+		memcpy(out, exec->memory + function->return_slot, sizeof(*out) * se_soft_glsl_type_slots(module, &function->return_type));
+	}
+}
+
+static const se_soft_glsl_value* se_soft_glsl_eval(se_soft_glsl_exec* exec, const u32 index) {
+	const se_soft_glsl_module* module = exec->module;
+	const se_soft_glsl_node* node = &module->nodes[index];
+	se_soft_glsl_value* out = exec->memory + node->slot;
+	switch (node->op) {
+		case SE_SOFT_GLSL_OP_REF:
+			return node->storage == SE_SOFT_GLSL_SHARED ? exec->shared + node->slot : out;
+		case SE_SOFT_GLSL_OP_INDEX: {
+			const se_soft_glsl_value* base = se_soft_glsl_eval(exec, node->a);
+			i32 element = se_soft_glsl_eval(exec, node->b)->i;
+			element = element < 0 ? 0 : ((u32)element >= node->c ? (i32)node->c - 1 : element);
+			return base + (u32)element * node->aux;
+		}
+		case SE_SOFT_GLSL_OP_FIELD:
+			return se_soft_glsl_eval(exec, node->a) + node->aux;
+		case SE_SOFT_GLSL_OP_SWIZZLE: {
+			const se_soft_glsl_value* value = se_soft_glsl_eval(exec, node->a);
+			for (u32 i = 0u; i < node->c; ++i) {
+				out[i] = value[(node->aux >> (2u * i)) & 3u];
+			}
+			return out;
+		}
+		case SE_SOFT_GLSL_OP_NEGATE:
+		case SE_SOFT_GLSL_OP_BIT_NOT: {
+			const se_soft_glsl_value* value = se_soft_glsl_eval(exec, node->a);
+			const u32 count = se_soft_glsl_components(&node->type);
+			for (u32 i = 0u; i < count; ++i) {
+				if (node->op == SE_SOFT_GLSL_OP_BIT_NOT) {
+					out[i].i = ~value[i].i;
+				} else if (node->type.base == SE_SOFT_GLSL_FLOAT) {
+					out[i].f = -value[i].f;
+				} else {
+					out[i].i = (i32)(0u - (u32)value[i].i);
+				}
+			}
+			return out;
+		}
+		case SE_SOFT_GLSL_OP_NOT:
+			out[0].i = !se_soft_glsl_eval(exec, node->a)->i;
+			return out;
+		case SE_SOFT_GLSL_OP_BINARY:
+			se_soft_glsl_eval_binary(exec, node, out);
+			return out;
+		case SE_SOFT_GLSL_OP_MUL_MM:
+		case SE_SOFT_GLSL_OP_MUL_MV:
+		case SE_SOFT_GLSL_OP_MUL_VM: {
+			const se_soft_glsl_type* left_type = &module->nodes[node->a].type;
+			const se_soft_glsl_type* right_type = &module->nodes[node->b].type;
+			const se_soft_glsl_value* left = se_soft_glsl_eval(exec, node->a);
+			const se_soft_glsl_value* right = se_soft_glsl_eval(exec, node->b);
+			se_soft_glsl_value result[16];
+			if (node->op == SE_SOFT_GLSL_OP_MUL_VM) {
+				// Row vector times matrix: one dot product per column.
+				for (u32 c = 0u; c < right_type->cols; ++c) {
+					f32 sum = 0.0f;
+					for (u32 r = 0u; r < right_type->rows; ++r) {
+						sum += left[r].f * right[c * right_type->rows + r].f;
+					}
+					result[c].f = sum;
+				}
+			} else {
+				const u32 rows = left_type->rows;
+				const u32 inner = left_type->cols;
+				const u32 cols = node->op == SE_SOFT_GLSL_OP_MUL_MM ? right_type->cols : 1u;
+				for (u32 c = 0u; c < cols; ++c) {
+					for (u32 r = 0u; r < rows; ++r) {
+						f32 sum = 0.0f;
+						for (u32 k = 0u; k < inner; ++k) {
+							sum += left[k * rows + r].f * right[c * inner + k].f;
+						}
+						result[c * rows + r].f = sum;
+					}
+				}
+			}
+			memcpy(out, result, sizeof(*out) * se_soft_glsl_components(&node->type));
+			return out;
+		}
+		case SE_SOFT_GLSL_OP_EQUAL:
+		case SE_SOFT_GLSL_OP_NOT_EQUAL: {
+			const se_soft_glsl_type* type = &module->nodes[node->a].type;
+			const se_soft_glsl_value* left = se_soft_glsl_eval(exec, node->a);
+			const se_soft_glsl_value* right = se_soft_glsl_eval(exec, node->b);
+			const u32 slots = se_soft_glsl_type_slots(module, type);
+			b8 equal = true;
+			for (u32 i = 0u; i < slots && equal; ++i) {
+				equal = type->base == SE_SOFT_GLSL_FLOAT ? left[i].f == right[i].f : left[i].i == right[i].i;
+			}
+			out[0].i = node->op == SE_SOFT_GLSL_OP_EQUAL ? equal : !equal;
+			return out;
+		}
+		case SE_SOFT_GLSL_OP_LOGICAL_AND:
+			out[0].i = se_soft_glsl_eval(exec, node->a)->i && se_soft_glsl_eval(exec, node->b)->i;
+			return out;
+		case SE_SOFT_GLSL_OP_LOGICAL_OR:
+			out[0].i = se_soft_glsl_eval(exec, node->a)->i || se_soft_glsl_eval(exec, node->b)->i;
+			return out;
+		case SE_SOFT_GLSL_OP_LOGICAL_XOR:
+			out[0].i = !se_soft_glsl_eval(exec, node->a)->i != !se_soft_glsl_eval(exec, node->b)->i;
+			return out;
+		case SE_SOFT_GLSL_OP_SELECT:
+			return se_soft_glsl_eval(exec, se_soft_glsl_eval(exec, node->a)->i ? node->b : node->c);
+		case SE_SOFT_GLSL_OP_ASSIGN: {
+			const se_soft_glsl_value* value = se_soft_glsl_eval(exec, node->b);
+			se_soft_glsl_lvalue lvalue;
+			se_soft_glsl_eval_lvalue(exec, node->a, &lvalue);
+			se_soft_glsl_store(&lvalue, value);
+			return value;
+		}
+		case SE_SOFT_GLSL_OP_PRE_INC:
+		case SE_SOFT_GLSL_OP_PRE_DEC:
+		case SE_SOFT_GLSL_OP_POST_INC:
+		case SE_SOFT_GLSL_OP_POST_DEC: {
+			const u32 count = se_soft_glsl_components(&node->type);
+			const b8 increment = node->op == SE_SOFT_GLSL_OP_PRE_INC || node->op == SE_SOFT_GLSL_OP_POST_INC;
+			se_soft_glsl_value before[16];
+			se_soft_glsl_value after[16];
+			memcpy(before, se_soft_glsl_eval(exec, node->a), sizeof(*out) * count);
+			for (u32 i = 0u; i < count; ++i) {
+				if (node->type.base == SE_SOFT_GLSL_FLOAT) {
+					after[i].f = before[i].f + (increment ? 1.0f : -1.0f);
+				} else {
+					after[i].i = (i32)((u32)before[i].i + (increment ? 1u : 0xffffffffu));
+				}
+			}
+			se_soft_glsl_lvalue lvalue;
+			se_soft_glsl_eval_lvalue(exec, node->a, &lvalue);
+			se_soft_glsl_store(&lvalue, after);
+			const b8 post = node->op == SE_SOFT_GLSL_OP_POST_INC || node->op == SE_SOFT_GLSL_OP_POST_DEC;
+			memcpy(out, post ? before : after, sizeof(*out) * count);
+			return out;
+		}
+		case SE_SOFT_GLSL_OP_CALL:
+			se_soft_glsl_eval_call(exec, node, out);
+			return out;
+		case SE_SOFT_GLSL_OP_BUILTIN:
+			se_soft_glsl_eval_builtin(exec, node, out);
+			return out;
+		case SE_SOFT_GLSL_OP_CONSTRUCT:
+			se_soft_glsl_eval_construct(exec, node, out);
+			return out;
+		case SE_SOFT_GLSL_OP_CONVERT: {
+			const se_soft_glsl_value* value = se_soft_glsl_eval(exec, node->a);
+			const u32 count = se_soft_glsl_components(&node->type);
+			for (u32 i = 0u; i < count; ++i) {
+				out[i] = se_soft_glsl_convert_value(node->operand_base, node->type.base, value[i]);
+			}
+			return out;
+		}
+		case SE_SOFT_GLSL_OP_SEQUENCE:
+			se_soft_glsl_eval(exec, node->a);
+			return se_soft_glsl_eval(exec, node->b);
+		default:
+			return out;
+	}
+}
+
+static se_soft_glsl_flow se_soft_glsl_exec_loop_body(se_soft_glsl_exec* exec, const u32 body, b8* out_stop) {
+	const se_soft_glsl_flow flow = se_soft_glsl_exec_statement(exec, body);
+	*out_stop = flow == SE_SOFT_GLSL_FLOW_BREAK || flow == SE_SOFT_GLSL_FLOW_RETURN || flow == SE_SOFT_GLSL_FLOW_DISCARD;
+	return flow == SE_SOFT_GLSL_FLOW_BREAK ? SE_SOFT_GLSL_FLOW_NEXT : flow;
+}
+
+static se_soft_glsl_flow se_soft_glsl_exec_statement(se_soft_glsl_exec* exec, const u32 index) {
+	const se_soft_glsl_module* module = exec->module;
+	const se_soft_glsl_node* node = &module->nodes[index];
+	switch (node->op) {
+		case SE_SOFT_GLSL_OP_NOP:
+			return SE_SOFT_GLSL_FLOW_NEXT;
+		case SE_SOFT_GLSL_OP_BLOCK:
+			for (u32 i = 0u; i < node->b; ++i) {
+				const se_soft_glsl_flow flow = se_soft_glsl_exec_statement(exec, module->lists[node->a + i]);
+				if (flow != SE_SOFT_GLSL_FLOW_NEXT) {
+					return flow;
+				}
+				if (exec->discarded) {
+					return SE_SOFT_GLSL_FLOW_DISCARD;
+				}
+			}
+			return SE_SOFT_GLSL_FLOW_NEXT;
+		case SE_SOFT_GLSL_OP_DECLARE: {
+			const se_soft_glsl_variable* variable = &module->variables[node->a];
+			const u32 slots = se_soft_glsl_type_slots(module, &variable->type);
+			if (node->b != SE_SOFT_GLSL_NONE) {
+				memmove(exec->memory + variable->offset, se_soft_glsl_eval(exec, node->b), sizeof(se_soft_glsl_value) * slots);
+			} else {
+				memset(exec->memory + variable->offset, 0, sizeof(se_soft_glsl_value) * slots);
+			}
+			return SE_SOFT_GLSL_FLOW_NEXT;
+		}
+		case SE_SOFT_GLSL_OP_IF:
+			if (se_soft_glsl_eval(exec, node->a)->i) {
+				return se_soft_glsl_exec_statement(exec, node->b);
+			}
+			return node->c != SE_SOFT_GLSL_NONE ? se_soft_glsl_exec_statement(exec, node->c) : SE_SOFT_GLSL_FLOW_NEXT;
+		case SE_SOFT_GLSL_OP_FOR: {
+			if (node->a != SE_SOFT_GLSL_NONE) {
+				se_soft_glsl_exec_statement(exec, node->a);
+			}
+			for (;;) {
+				if (node->b != SE_SOFT_GLSL_NONE && !se_soft_glsl_eval(exec, node->b)->i) {
+					break;
+				}
+				b8 stop = false;
+				const se_soft_glsl_flow flow = se_soft_glsl_exec_loop_body(exec, node->d, &stop);
+				if (stop) {
+					return flow == SE_SOFT_GLSL_FLOW_CONTINUE ? SE_SOFT_GLSL_FLOW_NEXT : flow;
+				}
+				if (node->c != SE_SOFT_GLSL_NONE) {
+					se_soft_glsl_eval(exec, node->c);
+				}
+			}
+			return SE_SOFT_GLSL_FLOW_NEXT;
+		}
+		case SE_SOFT_GLSL_OP_DO: {
+			do {
+				b8 stop = false;
+				const se_soft_glsl_flow flow = se_soft_glsl_exec_loop_body(exec, node->a, &stop);
+				if (stop) {
+					return flow;
+				}
+			} while (se_soft_glsl_eval(exec, node->b)->i);
+			return SE_SOFT_GLSL_FLOW_NEXT;
+		}
+		case SE_SOFT_GLSL_OP_RETURN:
+			if (node->a != SE_SOFT_GLSL_NONE) {
+				const se_soft_glsl_function* function = &module->functions[node->aux];
+				memmove(exec->memory + function->return_slot, se_soft_glsl_eval(exec, node->a),
+					sizeof(se_soft_glsl_value) * se_soft_glsl_type_slots(module, &function->return_type));
+			}
+			return SE_SOFT_GLSL_FLOW_RETURN;
+		case SE_SOFT_GLSL_OP_BREAK:
+			return SE_SOFT_GLSL_FLOW_BREAK;
+		case SE_SOFT_GLSL_OP_CONTINUE:
+			return SE_SOFT_GLSL_FLOW_CONTINUE;
+		case SE_SOFT_GLSL_OP_DISCARD:
+			exec->discarded = true;
+			return SE_SOFT_GLSL_FLOW_DISCARD;
+		case SE_SOFT_GLSL_OP_EXPRESSION:
+			se_soft_glsl_eval(exec, node->a);
+			return exec->discarded ? SE_SOFT_GLSL_FLOW_DISCARD : SE_SOFT_GLSL_FLOW_NEXT;
+		default:
+			se_soft_glsl_eval(exec, index);
+			return SE_SOFT_GLSL_FLOW_NEXT;
+	}
+}
+
+// Parser
+
+#define SE_SOFT_GLSL_UNSIZED 0xffffffffu
+#define SE_SOFT_GLSL_MISSING 0xffffffffu
+
+typedef struct {
+	se_soft_glsl_module* module;
+	const se_soft_glsl_token* tokens;
+	u32 token_count;
+	u32 pos;
+	c8* log;
+	sz log_size;
+	b8 failed;
+	// Visible variables, innermost last; scope_marks[i] is where scope i starts.
+	u32* scope;
+	u32 scope_count;
+	u32 scope_capacity;
+	u32 scope_marks[SE_SOFT_GLSL_MAX_SCOPES];
+	u32 scope_depth;
+	// Statements and arguments being collected; the bottom holds global initializers.
+	u32* pending;
+	u32 pending_count;
+	u32 pending_capacity;
+	u32 function;
+	u32 loop_depth;
+	se_soft_glsl_value* fold_memory;
+	u32 fold_capacity;
+} se_soft_glsl_parser;
+
+typedef struct {
+	u8 qualifier;
+	b8 flat;
+	b8 any;
+	i32 location;
+} se_soft_glsl_qualifiers;
+
+static const se_soft_glsl_token se_soft_glsl_end_token = { .kind = SE_SOFT_GLSL_TOKEN_EOF, .text = "end of input" };
+
+static u32 se_soft_glsl_parse_expression(se_soft_glsl_parser* parser);
+static u32 se_soft_glsl_parse_assignment(se_soft_glsl_parser* parser);
+static u32 se_soft_glsl_parse_conditional(se_soft_glsl_parser* parser);
+static u32 se_soft_glsl_parse_statement(se_soft_glsl_parser* parser);
+
+static void se_soft_glsl_error(se_soft_glsl_parser* parser, const c8* format, ...) {
+	if (parser->failed) {
+		return;
+	}
+	parser->failed = true;
+	if (!parser->log || parser->log_size == 0u) {
+		return;
+	}
+	u32 line = 0u;
+	if (parser->token_count > 0u) {
+		line = parser->tokens[parser->pos < parser->token_count ? parser->pos : parser->token_count - 1u].line;
+	}
+	const int prefix = snprintf(parser->log, parser->log_size, "0:%u: error: ", line);
+	if (prefix < 0 || (sz)prefix >= parser->log_size) {
+		return;
+	}
+	va_list args;
+	va_start(args, format);
+	vsnprintf(parser->log + prefix, parser->log_size - (sz)prefix, format, args);
+	va_end(args);
+}
+
+static const se_soft_glsl_token* se_soft_glsl_peek_at(const se_soft_glsl_parser* parser, const u32 offset) {
+	const u32 index = parser->pos + offset;
+	if (parser->failed || index >= parser->token_count) {
+		return &se_soft_glsl_end_token;
+	}
+	return &parser->tokens[index];
+}
+
+static const se_soft_glsl_token* se_soft_glsl_peek(const se_soft_glsl_parser* parser) {
+	return se_soft_glsl_peek_at(parser, 0u);
+}
+
+static const se_soft_glsl_token* se_soft_glsl_next(se_soft_glsl_parser* parser) {
+	const se_soft_glsl_token* token = se_soft_glsl_peek(parser);
+	if (token->kind != SE_SOFT_GLSL_TOKEN_EOF) {
+		++parser->pos;
+	}
+	return token;
+}
+
+static b8 se_soft_glsl_is(const se_soft_glsl_token* token, const c8* text) {
+	return (token->kind == SE_SOFT_GLSL_TOKEN_PUNCT || token->kind == SE_SOFT_GLSL_TOKEN_IDENT) && strcmp(token->text, text) == 0;
+}
+
+static b8 se_soft_glsl_accept(se_soft_glsl_parser* parser, const c8* text) {
+	if (se_soft_glsl_is(se_soft_glsl_peek(parser), text)) {
+		se_soft_glsl_next(parser);
+		return true;
+	}
+	return false;
+}
+
+static b8 se_soft_glsl_expect(se_soft_glsl_parser* parser, const c8* text) {
+	if (se_soft_glsl_accept(parser, text)) {
+		return true;
+	}
+	se_soft_glsl_error(parser, "syntax error, expected '%s' before '%s'", text, se_soft_glsl_peek(parser)->text);
+	return false;
+}
+
+static b8 se_soft_glsl_expect_name(se_soft_glsl_parser* parser, c8 out_name[SE_SOFT_GLSL_NAME_MAX]) {
+	const se_soft_glsl_token* token = se_soft_glsl_peek(parser);
+	if (token->kind != SE_SOFT_GLSL_TOKEN_IDENT) {
+		se_soft_glsl_error(parser, "syntax error, expected an identifier before '%s'", token->text);
+		out_name[0] = '\0';
+		return false;
+	}
+	se_soft_glsl_copy_name(out_name, token->text);
+	se_soft_glsl_next(parser);
+	return true;
+}
+
+static b8 se_soft_glsl_push_pending(se_soft_glsl_parser* parser, const u32 node) {
+	if (!se_soft_glsl_grow((void**)&parser->pending, &parser->pending_capacity, parser->pending_count + 1u, sizeof(*parser->pending))) {
+		se_soft_glsl_error(parser, "out of memory");
+		return false;
+	}
+	parser->pending[parser->pending_count++] = node;
+	return true;
+}
+
+static u32 se_soft_glsl_commit_list(se_soft_glsl_parser* parser, const u32 first, const u32 count) {
+	se_soft_glsl_module* module = parser->module;
+	if (!se_soft_glsl_grow((void**)&module->lists, &module->list_capacity, module->list_count + count, sizeof(*module->lists))) {
+		se_soft_glsl_error(parser, "out of memory");
+		return 0u;
+	}
+	const u32 start = module->list_count;
+	if (count > 0u) {
+		memcpy(module->lists + start, parser->pending + first, sizeof(*module->lists) * count);
+	}
+	module->list_count += count;
+	return start;
+}
+
+static u32 se_soft_glsl_add_node(se_soft_glsl_parser* parser, const u8 op, const se_soft_glsl_type* type, const b8 result) {
+	se_soft_glsl_module* module = parser->module;
+	if (parser->failed && module->node_count > 0u) {
+		return SE_SOFT_GLSL_NONE;
+	}
+	if (!se_soft_glsl_grow((void**)&module->nodes, &module->node_capacity, module->node_count + 1u, sizeof(*module->nodes))) {
+		se_soft_glsl_error(parser, "out of memory");
+		return SE_SOFT_GLSL_NONE;
+	}
+	const u32 index = module->node_count++;
+	se_soft_glsl_node* node = &module->nodes[index];
+	memset(node, 0, sizeof(*node));
+	node->op = op;
+	if (type) {
+		node->type = *type;
+	}
+	node->line = se_soft_glsl_peek(parser)->line;
+	if (result) {
+		node->slot = module->local_slots;
+		module->local_slots += se_soft_glsl_type_slots(module, &node->type);
+	}
+	return index;
+}
+
+static b8 se_soft_glsl_alloc_shared(se_soft_glsl_parser* parser, const u32 slots, u32* out_offset) {
+	se_soft_glsl_module* module = parser->module;
+	if (!se_soft_glsl_grow((void**)&module->shared, &module->shared_capacity, module->shared_count + slots, sizeof(*module->shared))) {
+		se_soft_glsl_error(parser, "out of memory");
+		return false;
+	}
+	memset(module->shared + module->shared_count, 0, sizeof(*module->shared) * slots);
+	*out_offset = module->shared_count;
+	module->shared_count += slots;
+	return true;
+}
+
+// Evaluates a constant node once and turns it into a reference to the stored result.
+static u32 se_soft_glsl_fold(se_soft_glsl_parser* parser, const u32 index) {
+	se_soft_glsl_module* module = parser->module;
+	if (parser->failed || !module->nodes[index].constant || module->nodes[index].op == SE_SOFT_GLSL_OP_REF) {
+		return index;
+	}
+	if (!se_soft_glsl_grow((void**)&parser->fold_memory, &parser->fold_capacity, module->local_slots + 1u, sizeof(*parser->fold_memory))) {
+		se_soft_glsl_error(parser, "out of memory");
+		return index;
+	}
+	const u32 slots = se_soft_glsl_type_slots(module, &module->nodes[index].type);
+	se_soft_glsl_value* folded = malloc(sizeof(*folded) * (slots > 0u ? slots : 1u));
+	if (!folded) {
+		se_soft_glsl_error(parser, "out of memory");
+		return index;
+	}
+	se_soft_glsl_exec exec = { .module = module, .memory = parser->fold_memory, .shared = module->shared };
+	memcpy(folded, se_soft_glsl_eval(&exec, index), sizeof(*folded) * slots);
+	u32 offset = 0u;
+	if (se_soft_glsl_alloc_shared(parser, slots, &offset)) {
+		memcpy(module->shared + offset, folded, sizeof(*folded) * slots);
+		se_soft_glsl_node* node = &module->nodes[index];
+		node->op = SE_SOFT_GLSL_OP_REF;
+		node->storage = SE_SOFT_GLSL_SHARED;
+		node->slot = offset;
+		node->aux = 0u;
+	}
+	free(folded);
+	return index;
+}
+
+static u32 se_soft_glsl_literal(se_soft_glsl_parser* parser, const u8 base, const se_soft_glsl_value value) {
+	u32 offset = 0u;
+	if (!se_soft_glsl_alloc_shared(parser, 1u, &offset)) {
+		return SE_SOFT_GLSL_NONE;
+	}
+	parser->module->shared[offset] = value;
+	const se_soft_glsl_type type = se_soft_glsl_make_type(base, 1u, 1u);
+	const u32 index = se_soft_glsl_add_node(parser, SE_SOFT_GLSL_OP_REF, &type, false);
+	se_soft_glsl_node* node = &parser->module->nodes[index];
+	node->storage = SE_SOFT_GLSL_SHARED;
+	node->slot = offset;
+	node->constant = index != SE_SOFT_GLSL_NONE;
+	return index;
+}
+
+static u32 se_soft_glsl_int_literal(se_soft_glsl_parser* parser, const i32 value) {
+	se_soft_glsl_value literal;
+	literal.i = value;
+	return se_soft_glsl_literal(parser, SE_SOFT_GLSL_INT, literal);
+}
+
+// Scopes and variables
+
+static void se_soft_glsl_push_scope(se_soft_glsl_parser* parser) {
+	if (parser->scope_depth >= SE_SOFT_GLSL_MAX_SCOPES) {
+		se_soft_glsl_error(parser, "scopes are nested too deeply");
+		return;
+	}
+	parser->scope_marks[parser->scope_depth++] = parser->scope_count;
+}
+
+static void se_soft_glsl_pop_scope(se_soft_glsl_parser* parser) {
+	if (parser->scope_depth > 0u) {
+		parser->scope_count = parser->scope_marks[--parser->scope_depth];
+	}
+}
+
+static u32 se_soft_glsl_lookup(const se_soft_glsl_parser* parser, const c8* name) {
+	for (u32 i = parser->scope_count; i > 0u; --i) {
+		const u32 variable = parser->scope[i - 1u];
+		if (strcmp(parser->module->variables[variable].name, name) == 0) {
+			return variable;
+		}
+	}
+	return SE_SOFT_GLSL_MISSING;
+}
+
+// `allocate` false leaves the offset for the caller to point at existing storage.
+static u32 se_soft_glsl_add_variable(se_soft_glsl_parser* parser, const c8* name, const se_soft_glsl_type* type, const u8 qualifier, const u8 storage, const b8 allocate) {
+	se_soft_glsl_module* module = parser->module;
+	if (parser->failed) {
+		return SE_SOFT_GLSL_MISSING;
+	}
+	if (!se_soft_glsl_grow((void**)&module->variables, &module->variable_capacity, module->variable_count + 1u, sizeof(*module->variables))) {
+		se_soft_glsl_error(parser, "out of memory");
+		return SE_SOFT_GLSL_MISSING;
+	}
+	const u32 index = module->variable_count++;
+	se_soft_glsl_variable* variable = &module->variables[index];
+	memset(variable, 0, sizeof(*variable));
+	se_soft_glsl_copy_name(variable->name, name);
+	variable->type = *type;
+	variable->qualifier = qualifier;
+	variable->storage = storage;
+	variable->location = -1;
+	if (allocate) {
+		const u32 slots = se_soft_glsl_type_slots(module, type);
+		if (storage == SE_SOFT_GLSL_SHARED) {
+			u32 offset = 0u;
+			se_soft_glsl_alloc_shared(parser, slots, &offset);
+			module->variables[index].offset = offset;
+		} else {
+			module->variables[index].offset = module->local_slots;
+			module->local_slots += slots;
+		}
+	}
+	return index;
+}
+
+static void se_soft_glsl_push_name(se_soft_glsl_parser* parser, const u32 variable) {
+	if (!se_soft_glsl_grow((void**)&parser->scope, &parser->scope_capacity, parser->scope_count + 1u, sizeof(*parser->scope))) {
+		se_soft_glsl_error(parser, "out of memory");
+		return;
+	}
+	parser->scope[parser->scope_count++] = variable;
+}
+
+static u32 se_soft_glsl_declare(se_soft_glsl_parser* parser, const c8* name, const se_soft_glsl_type* type, const u8 qualifier, const u8 storage, const b8 allocate) {
+	const u32 mark = parser->scope_depth > 0u ? parser->scope_marks[parser->scope_depth - 1u] : 0u;
+	for (u32 i = mark; i < parser->scope_count; ++i) {
+		if (strcmp(parser->module->variables[parser->scope[i]].name, name) == 0) {
+			se_soft_glsl_error(parser, "'%s': redefinition", name);
+			return SE_SOFT_GLSL_MISSING;
+		}
+	}
+	if (type->array == SE_SOFT_GLSL_UNSIZED) {
+		se_soft_glsl_error(parser, "'%s': implicitly sized arrays need an initializer", name);
+		return SE_SOFT_GLSL_MISSING;
+	}
+	if (type->base == SE_SOFT_GLSL_VOID) {
+		se_soft_glsl_error(parser, "'%s': illegal use of type 'void'", name);
+		return SE_SOFT_GLSL_MISSING;
+	}
+	const u32 variable = se_soft_glsl_add_variable(parser, name, type, qualifier, storage, allocate);
+	if (variable != SE_SOFT_GLSL_MISSING) {
+		se_soft_glsl_push_name(parser, variable);
+	}
+	return variable;
+}
+
+static u32 se_soft_glsl_ref(se_soft_glsl_parser* parser, const u32 variable_index) {
+	se_soft_glsl_module* module = parser->module;
+	const se_soft_glsl_variable variable = module->variables[variable_index];
+	const u32 index = se_soft_glsl_add_node(parser, SE_SOFT_GLSL_OP_REF, &variable.type, false);
+	se_soft_glsl_node* node = &module->nodes[index];
+	if (index != SE_SOFT_GLSL_NONE) {
+		node->storage = variable.storage;
+		node->slot = variable.offset;
+		node->constant = variable.constant;
+		node->aux = variable_index + 1u;
+	}
+	if (module->builtin_vars[SE_SOFT_GLSL_BUILTIN_VAR_FRAG_DEPTH] == variable_index + 1u) {
+		module->writes_depth = true;
+	}
+	return index;
+}
+
+// Types
+
+static b8 se_soft_glsl_lookup_type(const se_soft_glsl_parser* parser, const se_soft_glsl_token* token, se_soft_glsl_type* out_type) {
+	if (token->kind != SE_SOFT_GLSL_TOKEN_IDENT) {
+		return false;
+	}
+	for (u32 i = 0u; i < sizeof(se_soft_glsl_type_names) / sizeof(se_soft_glsl_type_names[0]); ++i) {
+		if (strcmp(token->text, se_soft_glsl_type_names[i].name) == 0) {
+			*out_type = se_soft_glsl_make_type(se_soft_glsl_type_names[i].base, se_soft_glsl_type_names[i].rows, se_soft_glsl_type_names[i].cols);
+			return true;
+		}
+	}
+	for (u32 i = 0u; i < parser->module->struct_count; ++i) {
+		if (strcmp(token->text, parser->module->structs[i].name) == 0) {
+			*out_type = se_soft_glsl_make_type(SE_SOFT_GLSL_STRUCT, 1u, 1u);
+			out_type->structure = (u16)i;
+			return true;
+		}
+	}
+	return false;
+}
+
+static b8 se_soft_glsl_constant_int(se_soft_glsl_parser* parser, const u32 index, i32* out_value) {
+	const se_soft_glsl_node* node = &parser->module->nodes[index];
+	if (parser->failed) {
+		return false;
+	}
+	if (!node->constant || !se_soft_glsl_is_scalar(&node->type) || (node->type.base != SE_SOFT_GLSL_INT && node->type.base != SE_SOFT_GLSL_UINT)) {
+		se_soft_glsl_error(parser, "array size must be a constant integer expression");
+		return false;
+	}
+	*out_value = parser->module->shared[node->slot].i;
+	return true;
+}
+
+static void se_soft_glsl_parse_array_suffix(se_soft_glsl_parser* parser, se_soft_glsl_type* type) {
+	if (!se_soft_glsl_accept(parser, "[")) {
+		return;
+	}
+	if (type->array != 0u) {
+		se_soft_glsl_error(parser, "arrays of arrays are not supported");
+		return;
+	}
+	if (se_soft_glsl_accept(parser, "]")) {
+		type->array = SE_SOFT_GLSL_UNSIZED;
+		return;
+	}
+	i32 size = 0;
+	if (!se_soft_glsl_constant_int(parser, se_soft_glsl_parse_conditional(parser), &size)) {
+		return;
+	}
+	if (size <= 0 || (u32)size > SE_SOFT_GLSL_MAX_ARRAY) {
+		se_soft_glsl_error(parser, "array size must be between 1 and %u", SE_SOFT_GLSL_MAX_ARRAY);
+		return;
+	}
+	type->array = (u32)size;
+	se_soft_glsl_expect(parser, "]");
+}
+
+static void se_soft_glsl_parse_qualifiers(se_soft_glsl_parser* parser, se_soft_glsl_qualifiers* out_qualifiers) {
+	static const c8* ignored[] = { "smooth", "noperspective", "centroid", "invariant", "highp", "mediump", "lowp", "precise" };
+	memset(out_qualifiers, 0, sizeof(*out_qualifiers));
+	out_qualifiers->location = -1;
+	for (;;) {
+		const se_soft_glsl_token* token = se_soft_glsl_peek(parser);
+		if (token->kind != SE_SOFT_GLSL_TOKEN_IDENT) {
+			return;
+		}
+		const c8* word = token->text;
+		if (strcmp(word, "layout") == 0) {
+			se_soft_glsl_next(parser);
+			se_soft_glsl_expect(parser, "(");
+			do {
+				c8 name[SE_SOFT_GLSL_NAME_MAX];
+				if (!se_soft_glsl_expect_name(parser, name)) {
+					return;
+				}
+				if (se_soft_glsl_accept(parser, "=")) {
+					const se_soft_glsl_token* value = se_soft_glsl_next(parser);
+					if (strcmp(name, "location") == 0) {
+						out_qualifiers->location = (i32)value->integer;
+					}
+				}
+			} while (se_soft_glsl_accept(parser, ","));
+			se_soft_glsl_expect(parser, ")");
+			out_qualifiers->any = true;
+			continue;
+		}
+		if (strcmp(word, "const") == 0) {
+			out_qualifiers->qualifier = SE_SOFT_GLSL_QUALIFIER_CONST;
+		} else if (strcmp(word, "uniform") == 0) {
+			out_qualifiers->qualifier = SE_SOFT_GLSL_QUALIFIER_UNIFORM;
+		} else if (strcmp(word, "in") == 0 || strcmp(word, "attribute") == 0) {
+			out_qualifiers->qualifier = SE_SOFT_GLSL_QUALIFIER_IN;
+		} else if (strcmp(word, "out") == 0) {
+			out_qualifiers->qualifier = SE_SOFT_GLSL_QUALIFIER_OUT;
+		} else if (strcmp(word, "inout") == 0) {
+			out_qualifiers->qualifier = SE_SOFT_GLSL_QUALIFIER_INOUT;
+		} else if (strcmp(word, "varying") == 0) {
+			out_qualifiers->qualifier = parser->module->stage == SE_SOFT_GLSL_VERTEX ? SE_SOFT_GLSL_QUALIFIER_OUT : SE_SOFT_GLSL_QUALIFIER_IN;
+		} else if (strcmp(word, "flat") == 0) {
+			out_qualifiers->flat = true;
+		} else {
+			b8 known = false;
+			for (u32 i = 0u; i < sizeof(ignored) / sizeof(ignored[0]) && !known; ++i) {
+				known = strcmp(word, ignored[i]) == 0;
+			}
+			if (!known) {
+				return;
+			}
+		}
+		se_soft_glsl_next(parser);
+		out_qualifiers->any = true;
+	}
+}
+
+static void se_soft_glsl_parse_struct(se_soft_glsl_parser* parser, se_soft_glsl_type* out_type) {
+	se_soft_glsl_module* module = parser->module;
+	se_soft_glsl_expect(parser, "struct");
+	se_soft_glsl_struct structure = {0};
+	if (!se_soft_glsl_expect_name(parser, structure.name) || !se_soft_glsl_expect(parser, "{")) {
+		return;
+	}
+	structure.first_field = module->field_count;
+	while (!parser->failed && !se_soft_glsl_accept(parser, "}")) {
+		se_soft_glsl_qualifiers qualifiers;
+		se_soft_glsl_parse_qualifiers(parser, &qualifiers);
+		se_soft_glsl_type type;
+		if (!se_soft_glsl_lookup_type(parser, se_soft_glsl_peek(parser), &type)) {
+			se_soft_glsl_error(parser, "'%s': unknown type in structure", se_soft_glsl_peek(parser)->text);
+			return;
+		}
+		se_soft_glsl_next(parser);
+		se_soft_glsl_parse_array_suffix(parser, &type);
+		do {
+			se_soft_glsl_field field = {0};
+			if (!se_soft_glsl_expect_name(parser, field.name)) {
+				return;
+			}
+			field.type = type;
+			se_soft_glsl_parse_array_suffix(parser, &field.type);
+			if (field.type.array == SE_SOFT_GLSL_UNSIZED || field.type.base == SE_SOFT_GLSL_VOID || se_soft_glsl_is_sampler(field.type.base)) {
+				se_soft_glsl_error(parser, "'%s': invalid structure member", field.name);
+				return;
+			}
+			field.offset = structure.slots;
+			structure.slots += se_soft_glsl_type_slots(module, &field.type);
+			if (!se_soft_glsl_grow((void**)&module->fields, &module->field_capacity, module->field_count + 1u, sizeof(*module->fields))) {
+				se_soft_glsl_error(parser, "out of memory");
+				return;
+			}
+			module->fields[module->field_count++] = field;
+			++structure.field_count;
+		} while (se_soft_glsl_accept(parser, ","));
+		se_soft_glsl_expect(parser, ";");
+	}
+	if (parser->failed) {
+		return;
+	}
+	if (!se_soft_glsl_grow((void**)&module->structs, &module->struct_capacity, module->struct_count + 1u, sizeof(*module->structs))) {
+		se_soft_glsl_error(parser, "out of memory");
+		return;
+	}
+	*out_type = se_soft_glsl_make_type(SE_SOFT_GLSL_STRUCT, 1u, 1u);
+	out_type->structure = (u16)module->struct_count;
+	module->structs[module->struct_count++] = structure;
+}
+
+// Expressions
+
+static b8 se_soft_glsl_implicit(const u8 from, const u8 to) {
+	return from == to || (to == SE_SOFT_GLSL_FLOAT && (from == SE_SOFT_GLSL_INT || from == SE_SOFT_GLSL_UINT)) ||
+		(to == SE_SOFT_GLSL_UINT && from == SE_SOFT_GLSL_INT);
+}
+
+static b8 se_soft_glsl_all_constant(const se_soft_glsl_parser* parser, const u32* nodes, const u32 count) {
+	for (u32 i = 0u; i < count; ++i) {
+		if (!parser->module->nodes[nodes[i]].constant) {
+			return false;
+		}
+	}
+	return true;
+}
+
+static u32 se_soft_glsl_make_convert(se_soft_glsl_parser* parser, const u32 operand, const u8 base) {
+	se_soft_glsl_type type = parser->module->nodes[operand].type;
+	if (type.base == base || parser->failed) {
+		return operand;
+	}
+	const u8 from = type.base;
+	type.base = base;
+	const u32 index = se_soft_glsl_add_node(parser, SE_SOFT_GLSL_OP_CONVERT, &type, true);
+	se_soft_glsl_node* node = &parser->module->nodes[index];
+	node->a = operand;
+	node->operand_base = from;
+	node->constant = parser->module->nodes[operand].constant;
+	return se_soft_glsl_fold(parser, index);
+}
+
+static u32 se_soft_glsl_coerce(se_soft_glsl_parser* parser, const u32 operand, const se_soft_glsl_type* target) {
+	const se_soft_glsl_type type = parser->module->nodes[operand].type;
+	if (parser->failed || se_soft_glsl_type_equal(&type, target)) {
+		return operand;
+	}
+	if (type.array == 0u && target->array == 0u && type.rows == target->rows && type.cols == target->cols &&
+		se_soft_glsl_is_numeric(type.base) && se_soft_glsl_implicit(type.base, target->base)) {
+		return se_soft_glsl_make_convert(parser, operand, target->base);
+	}
+	c8 from_name[SE_SOFT_GLSL_NAME_MAX + 16u];
+	c8 to_name[SE_SOFT_GLSL_NAME_MAX + 16u];
+	se_soft_glsl_type_name(parser->module, &type, from_name, sizeof(from_name));
+	se_soft_glsl_type_name(parser->module, target, to_name, sizeof(to_name));
+	se_soft_glsl_error(parser, "cannot convert from '%s' to '%s'", from_name, to_name);
+	return operand;
+}
+
+// Converts mixed int, uint and float operands to a common base, as GLSL's implicit conversions allow.
+static void se_soft_glsl_unify(se_soft_glsl_parser* parser, u32* left, u32* right) {
+	const u8 left_base = parser->module->nodes[*left].type.base;
+	const u8 right_base = parser->module->nodes[*right].type.base;
+	if (left_base == right_base || !se_soft_glsl_is_numeric(left_base) || !se_soft_glsl_is_numeric(right_base)) {
+		return;
+	}
+	const u8 base = (left_base == SE_SOFT_GLSL_FLOAT || right_base == SE_SOFT_GLSL_FLOAT) ? SE_SOFT_GLSL_FLOAT : SE_SOFT_GLSL_UINT;
+	*left = se_soft_glsl_make_convert(parser, *left, base);
+	*right = se_soft_glsl_make_convert(parser, *right, base);
+}
+
+static b8 se_soft_glsl_float_arg(se_soft_glsl_parser* parser, u32* arg) {
+	const se_soft_glsl_type type = parser->module->nodes[*arg].type;
+	if (type.array == 0u && (type.base == SE_SOFT_GLSL_INT || type.base == SE_SOFT_GLSL_UINT)) {
+		*arg = se_soft_glsl_make_convert(parser, *arg, SE_SOFT_GLSL_FLOAT);
+	}
+	const se_soft_glsl_type converted = parser->module->nodes[*arg].type;
+	return converted.array == 0u && converted.base == SE_SOFT_GLSL_FLOAT;
+}
+
+static u32 se_soft_glsl_make_unary(se_soft_glsl_parser* parser, const u8 op, const u32 operand) {
+	const se_soft_glsl_type type = parser->module->nodes[operand].type;
+	b8 valid = false;
+	if (op == SE_SOFT_GLSL_OP_NEGATE) {
+		valid = type.array == 0u && se_soft_glsl_is_numeric(type.base);
+	} else if (op == SE_SOFT_GLSL_OP_NOT) {
+		valid = se_soft_glsl_is_scalar(&type) && type.base == SE_SOFT_GLSL_BOOL;
+	} else {
+		valid = se_soft_glsl_is_vector(&type) && (type.base == SE_SOFT_GLSL_INT || type.base == SE_SOFT_GLSL_UINT);
+	}
+	if (!valid) {
+		se_soft_glsl_error(parser, "wrong operand type for unary operator");
+		return operand;
+	}
+	const u32 index = se_soft_glsl_add_node(parser, op, &type, true);
+	se_soft_glsl_node* node = &parser->module->nodes[index];
+	node->a = operand;
+	node->constant = parser->module->nodes[operand].constant;
+	return se_soft_glsl_fold(parser, index);
+}
+
+static u32 se_soft_glsl_make_binary(se_soft_glsl_parser* parser, const c8* op, u32 left, u32 right) {
+	static const struct {
+		const c8* text;
+		u8 binary;
+	} operators[] = {
+		{ "+", SE_SOFT_GLSL_BINARY_ADD }, { "-", SE_SOFT_GLSL_BINARY_SUB }, { "*", SE_SOFT_GLSL_BINARY_MUL },
+		{ "/", SE_SOFT_GLSL_BINARY_DIV }, { "%", SE_SOFT_GLSL_BINARY_MOD }, { "<", SE_SOFT_GLSL_BINARY_LESS },
+		{ ">", SE_SOFT_GLSL_BINARY_GREATER }, { "<=", SE_SOFT_GLSL_BINARY_LESS_EQUAL }, { ">=", SE_SOFT_GLSL_BINARY_GREATER_EQUAL },
+		{ "&", SE_SOFT_GLSL_BINARY_BIT_AND }, { "|", SE_SOFT_GLSL_BINARY_BIT_OR }, { "^", SE_SOFT_GLSL_BINARY_BIT_XOR },
+		{ "<<", SE_SOFT_GLSL_BINARY_SHIFT_LEFT }, { ">>", SE_SOFT_GLSL_BINARY_SHIFT_RIGHT }
+	};
+	se_soft_glsl_module* module = parser->module;
+	if (parser->failed) {
+		return SE_SOFT_GLSL_NONE;
+	}
+	const se_soft_glsl_type bool_type = se_soft_glsl_make_type(SE_SOFT_GLSL_BOOL, 1u, 1u);
+	u8 op_code = SE_SOFT_GLSL_OP_BINARY;
+	if (strcmp(op, "&&") == 0 || strcmp(op, "||") == 0 || strcmp(op, "^^") == 0) {
+		op_code = op[0] == '&' ? SE_SOFT_GLSL_OP_LOGICAL_AND : (op[0] == '|' ? SE_SOFT_GLSL_OP_LOGICAL_OR : SE_SOFT_GLSL_OP_LOGICAL_XOR);
+		if (!se_soft_glsl_type_equal(&module->nodes[left].type, &bool_type) || !se_soft_glsl_type_equal(&module->nodes[right].type, &bool_type)) {
+			se_soft_glsl_error(parser, "'%s': wrong operand types, boolean expressions expected", op);
+			return left;
+		}
+	} else if (strcmp(op, "==") == 0 || strcmp(op, "!=") == 0) {
+		op_code = op[0] == '=' ? SE_SOFT_GLSL_OP_EQUAL : SE_SOFT_GLSL_OP_NOT_EQUAL;
+		se_soft_glsl_unify(parser, &left, &right);
+		const se_soft_glsl_type* left_type = &module->nodes[left].type;
+		if (!se_soft_glsl_type_equal(left_type, &module->nodes[right].type) || left_type->base == SE_SOFT_GLSL_VOID || se_soft_glsl_is_sampler(left_type->base)) {
+			se_soft_glsl_error(parser, "'%s': wrong operand types", op);
+			return left;
+		}
+	}
+	if (op_code != SE_SOFT_GLSL_OP_BINARY) {
+		const u32 index = se_soft_glsl_add_node(parser, op_code, &bool_type, true);
+		se_soft_glsl_node* node = &module->nodes[index];
+		node->a = left;
+		node->b = right;
+		node->constant = module->nodes[left].constant && module->nodes[right].constant;
+		return se_soft_glsl_fold(parser, index);
+	}
+	u8 binary = 0u;
+	b8 found = false;
+	for (u32 i = 0u; i < sizeof(operators) / sizeof(operators[0]) && !found; ++i) {
+		if (strcmp(op, operators[i].text) == 0) {
+			binary = operators[i].binary;
+			found = true;
+		}
+	}
+	const b8 shift = binary == SE_SOFT_GLSL_BINARY_SHIFT_LEFT || binary == SE_SOFT_GLSL_BINARY_SHIFT_RIGHT;
+	const b8 integer_only = shift || binary == SE_SOFT_GLSL_BINARY_MOD || binary == SE_SOFT_GLSL_BINARY_BIT_AND ||
+		binary == SE_SOFT_GLSL_BINARY_BIT_OR || binary == SE_SOFT_GLSL_BINARY_BIT_XOR;
+	const b8 compare = binary >= SE_SOFT_GLSL_BINARY_LESS && binary <= SE_SOFT_GLSL_BINARY_GREATER_EQUAL;
+	if (!shift) {
+		se_soft_glsl_unify(parser, &left, &right);
+	}
+	const se_soft_glsl_type left_type = module->nodes[left].type;
+	const se_soft_glsl_type right_type = module->nodes[right].type;
+	b8 valid = found && left_type.array == 0u && right_type.array == 0u &&
+		se_soft_glsl_is_numeric(left_type.base) && se_soft_glsl_is_numeric(right_type.base);
+	if (valid && integer_only) {
+		valid = left_type.base != SE_SOFT_GLSL_FLOAT && right_type.base != SE_SOFT_GLSL_FLOAT;
+	}
+	se_soft_glsl_type result = left_type;
+	u8 node_op = SE_SOFT_GLSL_OP_BINARY;
+	u32 broadcast = 0u;
+	if (valid && compare) {
+		valid = se_soft_glsl_is_scalar(&left_type) && se_soft_glsl_is_scalar(&right_type);
+		result = bool_type;
+	} else if (valid && binary == SE_SOFT_GLSL_BINARY_MUL && left_type.rows * left_type.cols > 1u && right_type.rows * right_type.cols > 1u &&
+		(se_soft_glsl_is_matrix(&left_type) || se_soft_glsl_is_matrix(&right_type))) {
+		if (se_soft_glsl_is_matrix(&left_type) && se_soft_glsl_is_matrix(&right_type)) {
+			valid = left_type.cols == right_type.rows;
+			node_op = SE_SOFT_GLSL_OP_MUL_MM;
+			result = se_soft_glsl_make_type(SE_SOFT_GLSL_FLOAT, left_type.rows, right_type.cols);
+		} else if (se_soft_glsl_is_matrix(&left_type)) {
+			valid = right_type.cols == 1u && right_type.rows == left_type.cols;
+			node_op = SE_SOFT_GLSL_OP_MUL_MV;
+			result = se_soft_glsl_make_type(SE_SOFT_GLSL_FLOAT, left_type.rows, 1u);
+		} else {
+			valid = left_type.cols == 1u && left_type.rows == right_type.rows;
+			node_op = SE_SOFT_GLSL_OP_MUL_VM;
+			result = se_soft_glsl_make_type(SE_SOFT_GLSL_FLOAT, right_type.cols, 1u);
+		}
+	} else if (valid) {
+		const b8 left_scalar = left_type.rows * left_type.cols == 1u;
+		const b8 right_scalar = right_type.rows * right_type.cols == 1u;
+		if (shift ? (right_scalar || (right_type.rows == left_type.rows && right_type.cols == left_type.cols)) :
+			se_soft_glsl_type_equal(&left_type, &right_type)) {
+			broadcast = right_scalar && !left_scalar ? 2u : 0u;
+		} else if (left_scalar && !shift) {
+			broadcast = 1u;
+			result = right_type;
+		} else if (right_scalar) {
+			broadcast = 2u;
+		} else {
+			valid = false;
+		}
+	}
+	if (!valid) {
+		c8 left_name[SE_SOFT_GLSL_NAME_MAX + 16u];
+		c8 right_name[SE_SOFT_GLSL_NAME_MAX + 16u];
+		se_soft_glsl_type_name(module, &left_type, left_name, sizeof(left_name));
+		se_soft_glsl_type_name(module, &right_type, right_name, sizeof(right_name));
+		se_soft_glsl_error(parser, "'%s': wrong operand types, no operation '%s' exists that takes a left-hand operand of type '%s' and a right operand of type '%s'",
+			op, op, left_name, right_name);
+		return left;
+	}
+	const u32 index = se_soft_glsl_add_node(parser, node_op, &result, true);
+	se_soft_glsl_node* node = &module->nodes[index];
+	node->a = left;
+	node->b = right;
+	node->aux = binary;
+	node->c = broadcast;
+	node->d = compare ? 1u : se_soft_glsl_components(&result);
+	node->operand_base = left_type.base;
+	node->constant = module->nodes[left].constant && module->nodes[right].constant;
+	return se_soft_glsl_fold(parser, index);
+}
+
+static u32 se_soft_glsl_make_field(se_soft_glsl_parser* parser, const u32 base, const u32 offset, const se_soft_glsl_type* type) {
+	const se_soft_glsl_node base_node = parser->module->nodes[base];
+	if (base_node.op == SE_SOFT_GLSL_OP_REF) {
+		const u32 index = se_soft_glsl_add_node(parser, SE_SOFT_GLSL_OP_REF, type, false);
+		se_soft_glsl_node* node = &parser->module->nodes[index];
+		if (index != SE_SOFT_GLSL_NONE) {
+			node->storage = base_node.storage;
+			node->slot = base_node.slot + offset;
+			node->constant = base_node.constant;
+			node->aux = base_node.aux;
+		}
+		return index;
+	}
+	const u32 index = se_soft_glsl_add_node(parser, SE_SOFT_GLSL_OP_FIELD, type, false);
+	se_soft_glsl_node* node = &parser->module->nodes[index];
+	node->a = base;
+	node->aux = offset;
+	node->constant = base_node.constant;
+	return se_soft_glsl_fold(parser, index);
+}
+
+static u32 se_soft_glsl_make_index(se_soft_glsl_parser* parser, const u32 base, const u32 subscript) {
+	se_soft_glsl_module* module = parser->module;
+	const se_soft_glsl_type type = module->nodes[base].type;
+	const se_soft_glsl_type subscript_type = module->nodes[subscript].type;
+	se_soft_glsl_type element = type;
+	u32 count = 0u;
+	if (type.array > 0u) {
+		element.array = 0u;
+		count = type.array;
+	} else if (se_soft_glsl_is_matrix(&type)) {
+		element.cols = 1u;
+		count = type.cols;
+	} else if (se_soft_glsl_is_vector(&type) && type.rows > 1u) {
+		element.rows = 1u;
+		count = type.rows;
+	} else {
+		se_soft_glsl_error(parser, "subscripted value is not an array, matrix or vector");
+		return base;
+	}
+	if (!se_soft_glsl_is_scalar(&subscript_type) || (subscript_type.base != SE_SOFT_GLSL_INT && subscript_type.base != SE_SOFT_GLSL_UINT)) {
+		se_soft_glsl_error(parser, "array index must be an integer scalar");
+		return base;
+	}
+	const u32 element_slots = se_soft_glsl_type_slots(module, &element);
+	if (module->nodes[subscript].constant) {
+		const i32 value = module->shared[module->nodes[subscript].slot].i;
+		if (value < 0 || (u32)value >= count) {
+			se_soft_glsl_error(parser, "index %d is out of range", value);
+			return base;
+		}
+		return se_soft_glsl_make_field(parser, base, (u32)value * element_slots, &element);
+	}
+	const u32 index = se_soft_glsl_add_node(parser, SE_SOFT_GLSL_OP_INDEX, &element, false);
+	se_soft_glsl_node* node = &module->nodes[index];
+	node->a = base;
+	node->b = subscript;
+	node->aux = element_slots;
+	node->c = count;
+	return index;
+}
+
+static u32 se_soft_glsl_make_member(se_soft_glsl_parser* parser, const u32 base, const c8* name) {
+	se_soft_glsl_module* module = parser->module;
+	const se_soft_glsl_type type = module->nodes[base].type;
+	if (type.base == SE_SOFT_GLSL_STRUCT && type.array == 0u) {
+		const se_soft_glsl_struct* structure = &module->structs[type.structure];
+		for (u32 i = 0u; i < structure->field_count; ++i) {
+			const se_soft_glsl_field field = module->fields[structure->first_field + i];
+			if (strcmp(field.name, name) == 0) {
+				return se_soft_glsl_make_field(parser, base, field.offset, &field.type);
+			}
+		}
+		se_soft_glsl_error(parser, "'%s': no such field in structure '%s'", name, structure->name);
+		return base;
+	}
+	if (!se_soft_glsl_is_vector(&type)) {
+		se_soft_glsl_error(parser, "'%s': field selection requires a structure or vector", name);
+		return base;
+	}
+	static const c8* sets[] = { "xyzw", "rgba", "stpq" };
+	const sz length = strlen(name);
+	u32 components[4] = {0};
+	i32 set = -1;
+	b8 contiguous = true;
+	for (sz i = 0u; i < length && i < 4u; ++i) {
+		const c8* found = NULL;
+		for (u32 s = 0u; s < 3u && !found; ++s) {
+			if ((set < 0 || (u32)set == s) && (found = strchr(sets[s], name[i])) != NULL && name[i] != '\0') {
+				set = (i32)s;
+			}
+		}
+		if (!found || (u32)(found - sets[set]) >= type.rows) {
+			se_soft_glsl_error(parser, "'%s': vector field selection out of range", name);
+			return base;
+		}
+		components[i] = (u32)(found - sets[set]);
+		contiguous = contiguous && components[i] == components[0] + (u32)i;
+	}
+	if (length == 0u || length > 4u) {
+		se_soft_glsl_error(parser, "'%s': illegal vector field selection", name);
+		return base;
+	}
+	const se_soft_glsl_type result = se_soft_glsl_make_type(type.base, (u8)length, 1u);
+	if (contiguous) {
+		return se_soft_glsl_make_field(parser, base, components[0], &result);
+	}
+	const u32 index = se_soft_glsl_add_node(parser, SE_SOFT_GLSL_OP_SWIZZLE, &result, true);
+	se_soft_glsl_node* node = &module->nodes[index];
+	node->a = base;
+	node->c = (u32)length;
+	for (u32 i = 0u; i < (u32)length; ++i) {
+		node->aux |= components[i] << (2u * i);
+	}
+	node->constant = module->nodes[base].constant;
+	return se_soft_glsl_fold(parser, index);
+}
+
+static b8 se_soft_glsl_is_lvalue(const se_soft_glsl_parser* parser, const u32 index) {
+	const se_soft_glsl_node* node = &parser->module->nodes[index];
+	switch (node->op) {
+		case SE_SOFT_GLSL_OP_REF:
+			return node->aux != 0u && node->storage == SE_SOFT_GLSL_LOCAL;
+		case SE_SOFT_GLSL_OP_INDEX:
+		case SE_SOFT_GLSL_OP_FIELD:
+			return se_soft_glsl_is_lvalue(parser, node->a);
+		case SE_SOFT_GLSL_OP_SWIZZLE:
+			for (u32 i = 0u; i < node->c; ++i) {
+				for (u32 j = i + 1u; j < node->c; ++j) {
+					if (((node->aux >> (2u * i)) & 3u) == ((node->aux >> (2u * j)) & 3u)) {
+						return false;
+					}
+				}
+			}
+			return se_soft_glsl_is_lvalue(parser, node->a);
+		default:
+			return false;
+	}
+}
+
+static void se_soft_glsl_check_lvalue(se_soft_glsl_parser* parser, const u32 index) {
+	if (!parser->failed && !se_soft_glsl_is_lvalue(parser, index)) {
+		se_soft_glsl_error(parser, "l-value required");
+	}
+}
+
+static u32 se_soft_glsl_make_construct(se_soft_glsl_parser* parser, se_soft_glsl_type type, const u32 first, const u32 count) {
+	se_soft_glsl_module* module = parser->module;
+	u32* args = parser->pending + first;
+	u32 mode = SE_SOFT_GLSL_CONSTRUCT_FLATTEN;
+	if (count == 0u) {
+		se_soft_glsl_error(parser, "constructor does not have any arguments");
+		return SE_SOFT_GLSL_NONE;
+	}
+	if (type.array > 0u) {
+		if (type.array == SE_SOFT_GLSL_UNSIZED) {
+			type.array = count;
+		}
+		if (count != type.array) {
+			se_soft_glsl_error(parser, "array constructor needs one argument per element");
+			return SE_SOFT_GLSL_NONE;
+		}
+		se_soft_glsl_type element = type;
+		element.array = 0u;
+		for (u32 k = 0u; k < count; ++k) {
+			args[k] = se_soft_glsl_coerce(parser, args[k], &element);
+		}
+		mode = SE_SOFT_GLSL_CONSTRUCT_AGGREGATE;
+	} else if (type.base == SE_SOFT_GLSL_STRUCT) {
+		const se_soft_glsl_struct structure = module->structs[type.structure];
+		if (count != structure.field_count) {
+			se_soft_glsl_error(parser, "'%s': wrong number of arguments to structure constructor", structure.name);
+			return SE_SOFT_GLSL_NONE;
+		}
+		for (u32 k = 0u; k < count; ++k) {
+			args[k] = se_soft_glsl_coerce(parser, args[k], &module->fields[structure.first_field + k].type);
+		}
+		mode = SE_SOFT_GLSL_CONSTRUCT_AGGREGATE;
+	} else if (type.base == SE_SOFT_GLSL_VOID || se_soft_glsl_is_sampler(type.base)) {
+		se_soft_glsl_error(parser, "cannot construct this type");
+		return SE_SOFT_GLSL_NONE;
+	} else {
+		const se_soft_glsl_type first_type = module->nodes[args[0]].type;
+		const u32 needed = se_soft_glsl_components(&type);
+		if (count == 1u && se_soft_glsl_is_scalar(&first_type)) {
+			mode = se_soft_glsl_is_matrix(&type) ? SE_SOFT_GLSL_CONSTRUCT_DIAGONAL : SE_SOFT_GLSL_CONSTRUCT_BROADCAST;
+		} else if (count == 1u && se_soft_glsl_is_matrix(&type) && se_soft_glsl_is_matrix(&first_type)) {
+			mode = SE_SOFT_GLSL_CONSTRUCT_MATRIX;
+		} else {
+			u32 total = 0u;
+			for (u32 k = 0u; k < count; ++k) {
+				const se_soft_glsl_type arg_type = module->nodes[args[k]].type;
+				if (!se_soft_glsl_is_vector(&arg_type) && !se_soft_glsl_is_matrix(&arg_type)) {
+					se_soft_glsl_error(parser, "constructor argument has an invalid type");
+					return SE_SOFT_GLSL_NONE;
+				}
+				if (total >= needed) {
+					se_soft_glsl_error(parser, "too many arguments to constructor");
+					return SE_SOFT_GLSL_NONE;
+				}
+				total += se_soft_glsl_components(&arg_type);
+			}
+			if (total < needed) {
+				se_soft_glsl_error(parser, "not enough data provided for construction");
+				return SE_SOFT_GLSL_NONE;
+			}
+		}
+	}
+	const b8 constant = se_soft_glsl_all_constant(parser, args, count);
+	const u32 list = se_soft_glsl_commit_list(parser, first, count);
+	const u32 index = se_soft_glsl_add_node(parser, SE_SOFT_GLSL_OP_CONSTRUCT, &type, true);
+	se_soft_glsl_node* node = &module->nodes[index];
+	node->aux = mode;
+	node->a = list;
+	node->b = count;
+	node->constant = constant;
+	return se_soft_glsl_fold(parser, index);
+}
+
+static u32 se_soft_glsl_make_builtin(se_soft_glsl_parser* parser, const u8 builtin, const c8* name, const u32 first, const u32 count) {
+	se_soft_glsl_module* module = parser->module;
+	u32* args = parser->pending + first;
+#define SE_SOFT_GLSL_T(k) (module->nodes[args[k]].type)
+	se_soft_glsl_type result = SE_SOFT_GLSL_T(0);
+	u8 operand_base = SE_SOFT_GLSL_FLOAT;
+	b8 valid = true;
+	switch (builtin) {
+		case SE_SOFT_GLSL_FN_ATAN:
+		case SE_SOFT_GLSL_FN_POW:
+		case SE_SOFT_GLSL_FN_MOD:
+		case SE_SOFT_GLSL_FN_DISTANCE:
+		case SE_SOFT_GLSL_FN_DOT:
+		case SE_SOFT_GLSL_FN_CROSS:
+		case SE_SOFT_GLSL_FN_REFLECT:
+		case SE_SOFT_GLSL_FN_STEP:
+			valid = se_soft_glsl_float_arg(parser, &args[0]);
+			if (count > 1u) {
+				valid = se_soft_glsl_float_arg(parser, &args[1]) && valid;
+			}
+			valid = valid && se_soft_glsl_is_vector(&SE_SOFT_GLSL_T(0));
+			if (valid && count > 1u) {
+				const b8 same = se_soft_glsl_type_equal(&SE_SOFT_GLSL_T(0), &SE_SOFT_GLSL_T(1));
+				if (builtin == SE_SOFT_GLSL_FN_MOD) {
+					valid = same || SE_SOFT_GLSL_T(1).rows == 1u;
+				} else if (builtin == SE_SOFT_GLSL_FN_STEP) {
+					valid = se_soft_glsl_is_vector(&SE_SOFT_GLSL_T(1)) && (same || SE_SOFT_GLSL_T(0).rows == 1u);
+					result = SE_SOFT_GLSL_T(1);
+				} else {
+					valid = same;
+				}
+			}
+			if (builtin == SE_SOFT_GLSL_FN_DISTANCE || builtin == SE_SOFT_GLSL_FN_DOT) {
+				result = se_soft_glsl_make_type(SE_SOFT_GLSL_FLOAT, 1u, 1u);
+			} else if (builtin == SE_SOFT_GLSL_FN_CROSS) {
+				valid = valid && SE_SOFT_GLSL_T(0).rows == 3u;
+			}
+			break;
+		case SE_SOFT_GLSL_FN_ABS:
+		case SE_SOFT_GLSL_FN_SIGN:
+			valid = se_soft_glsl_is_vector(&result) && se_soft_glsl_is_numeric(result.base);
+			operand_base = result.base;
+			break;
+		case SE_SOFT_GLSL_FN_MIN:
+		case SE_SOFT_GLSL_FN_MAX:
+		case SE_SOFT_GLSL_FN_CLAMP:
+			se_soft_glsl_unify(parser, &args[0], &args[1]);
+			if (count > 2u) {
+				se_soft_glsl_unify(parser, &args[0], &args[2]);
+				se_soft_glsl_unify(parser, &args[1], &args[2]);
+			}
+			result = SE_SOFT_GLSL_T(0);
+			operand_base = result.base;
+			valid = se_soft_glsl_is_vector(&result) && se_soft_glsl_is_numeric(result.base);
+			for (u32 k = 1u; k < count && valid; ++k) {
+				valid = se_soft_glsl_type_equal(&SE_SOFT_GLSL_T(k), &result) ||
+					(se_soft_glsl_is_scalar(&SE_SOFT_GLSL_T(k)) && SE_SOFT_GLSL_T(k).base == result.base);
+			}
+			break;
+		case SE_SOFT_GLSL_FN_MIX:
+		case SE_SOFT_GLSL_FN_SMOOTHSTEP:
+		case SE_SOFT_GLSL_FN_FACEFORWARD:
+		case SE_SOFT_GLSL_FN_REFRACT: {
+			const b8 select = builtin == SE_SOFT_GLSL_FN_MIX && SE_SOFT_GLSL_T(2).base == SE_SOFT_GLSL_BOOL;
+			for (u32 k = 0u; k < 3u; ++k) {
+				if (!(select && k == 2u)) {
+					valid = se_soft_glsl_float_arg(parser, &args[k]) && valid;
+				}
+			}
+			// The argument that fixes the result type; the others match it or are scalars.
+			const u32 shape = builtin == SE_SOFT_GLSL_FN_SMOOTHSTEP ? 2u : 0u;
+			result = SE_SOFT_GLSL_T(shape);
+			valid = valid && se_soft_glsl_is_vector(&result);
+			for (u32 k = 0u; k < 3u && valid; ++k) {
+				const se_soft_glsl_type arg_type = SE_SOFT_GLSL_T(k);
+				if (select && k == 2u) {
+					valid = se_soft_glsl_is_vector(&arg_type) && arg_type.rows == result.rows;
+				} else if (builtin == SE_SOFT_GLSL_FN_REFRACT && k == 2u) {
+					valid = se_soft_glsl_is_scalar(&arg_type);
+				} else if (builtin == SE_SOFT_GLSL_FN_FACEFORWARD || (builtin == SE_SOFT_GLSL_FN_MIX && k < 2u) || builtin == SE_SOFT_GLSL_FN_REFRACT) {
+					valid = se_soft_glsl_type_equal(&arg_type, &result);
+				} else {
+					valid = se_soft_glsl_type_equal(&arg_type, &result) || se_soft_glsl_is_scalar(&arg_type);
+				}
+			}
+			break;
+		}
+		case SE_SOFT_GLSL_FN_ISNAN:
+		case SE_SOFT_GLSL_FN_ISINF:
+		case SE_SOFT_GLSL_FN_FLOAT_BITS_TO_INT:
+		case SE_SOFT_GLSL_FN_FLOAT_BITS_TO_UINT:
+			valid = se_soft_glsl_float_arg(parser, &args[0]) && se_soft_glsl_is_vector(&SE_SOFT_GLSL_T(0));
+			result = SE_SOFT_GLSL_T(0);
+			result.base = builtin == SE_SOFT_GLSL_FN_FLOAT_BITS_TO_INT ? SE_SOFT_GLSL_INT :
+				(builtin == SE_SOFT_GLSL_FN_FLOAT_BITS_TO_UINT ? SE_SOFT_GLSL_UINT : SE_SOFT_GLSL_BOOL);
+			break;
+		case SE_SOFT_GLSL_FN_INT_BITS_TO_FLOAT:
+		case SE_SOFT_GLSL_FN_UINT_BITS_TO_FLOAT:
+			valid = se_soft_glsl_is_vector(&result) &&
+				result.base == (builtin == SE_SOFT_GLSL_FN_INT_BITS_TO_FLOAT ? SE_SOFT_GLSL_INT : SE_SOFT_GLSL_UINT);
+			result.base = SE_SOFT_GLSL_FLOAT;
+			break;
+		case SE_SOFT_GLSL_FN_LENGTH:
+			valid = se_soft_glsl_float_arg(parser, &args[0]) && se_soft_glsl_is_vector(&SE_SOFT_GLSL_T(0));
+			result = se_soft_glsl_make_type(SE_SOFT_GLSL_FLOAT, 1u, 1u);
+			break;
+		case SE_SOFT_GLSL_FN_MATRIX_COMP_MULT:
+			valid = se_soft_glsl_is_matrix(&result) && se_soft_glsl_type_equal(&result, &SE_SOFT_GLSL_T(1));
+			break;
+		case SE_SOFT_GLSL_FN_OUTER_PRODUCT:
+			valid = se_soft_glsl_float_arg(parser, &args[0]) && se_soft_glsl_float_arg(parser, &args[1]) &&
+				se_soft_glsl_is_vector(&SE_SOFT_GLSL_T(0)) && se_soft_glsl_is_vector(&SE_SOFT_GLSL_T(1)) &&
+				SE_SOFT_GLSL_T(0).rows > 1u && SE_SOFT_GLSL_T(1).rows > 1u;
+			result = se_soft_glsl_make_type(SE_SOFT_GLSL_FLOAT, SE_SOFT_GLSL_T(0).rows, SE_SOFT_GLSL_T(1).rows);
+			break;
+		case SE_SOFT_GLSL_FN_TRANSPOSE:
+			valid = se_soft_glsl_is_matrix(&result);
+			result = se_soft_glsl_make_type(SE_SOFT_GLSL_FLOAT, SE_SOFT_GLSL_T(0).cols, SE_SOFT_GLSL_T(0).rows);
+			break;
+		case SE_SOFT_GLSL_FN_DETERMINANT:
+		case SE_SOFT_GLSL_FN_INVERSE:
+			valid = se_soft_glsl_is_matrix(&result) && result.rows == result.cols;
+			if (builtin == SE_SOFT_GLSL_FN_DETERMINANT) {
+				result = se_soft_glsl_make_type(SE_SOFT_GLSL_FLOAT, 1u, 1u);
+			}
+			break;
+		case SE_SOFT_GLSL_FN_LESS_THAN:
+		case SE_SOFT_GLSL_FN_LESS_THAN_EQUAL:
+		case SE_SOFT_GLSL_FN_GREATER_THAN:
+		case SE_SOFT_GLSL_FN_GREATER_THAN_EQUAL:
+		case SE_SOFT_GLSL_FN_EQUAL:
+		case SE_SOFT_GLSL_FN_NOT_EQUAL:
+			se_soft_glsl_unify(parser, &args[0], &args[1]);
+			result = SE_SOFT_GLSL_T(0);
+			operand_base = result.base;
+			valid = se_soft_glsl_is_vector(&result) && se_soft_glsl_type_equal(&result, &SE_SOFT_GLSL_T(1)) &&
+				(se_soft_glsl_is_numeric(result.base) || builtin == SE_SOFT_GLSL_FN_EQUAL || builtin == SE_SOFT_GLSL_FN_NOT_EQUAL);
+			result.base = SE_SOFT_GLSL_BOOL;
+			break;
+		case SE_SOFT_GLSL_FN_ANY:
+		case SE_SOFT_GLSL_FN_ALL:
+		case SE_SOFT_GLSL_FN_NOT:
+			valid = se_soft_glsl_is_vector(&result) && result.base == SE_SOFT_GLSL_BOOL;
+			if (builtin != SE_SOFT_GLSL_FN_NOT) {
+				result.rows = 1u;
+			}
+			break;
+		case SE_SOFT_GLSL_FN_TEXTURE:
+		case SE_SOFT_GLSL_FN_TEXTURE_LOD:
+		case SE_SOFT_GLSL_FN_TEXEL_FETCH:
+		case SE_SOFT_GLSL_FN_TEXTURE_SIZE: {
+			const u8 dimensions = SE_SOFT_GLSL_T(0).base == SE_SOFT_GLSL_SAMPLER3D ? 3u : 2u;
+			valid = se_soft_glsl_is_sampler(SE_SOFT_GLSL_T(0).base) && SE_SOFT_GLSL_T(0).array == 0u;
+			if (builtin == SE_SOFT_GLSL_FN_TEXTURE_SIZE) {
+				valid = valid && se_soft_glsl_is_scalar(&SE_SOFT_GLSL_T(1)) && SE_SOFT_GLSL_T(1).base == SE_SOFT_GLSL_INT;
+				result = se_soft_glsl_make_type(SE_SOFT_GLSL_INT, dimensions, 1u);
+				break;
+			}
+			if (builtin == SE_SOFT_GLSL_FN_TEXEL_FETCH) {
+				valid = valid && se_soft_glsl_is_vector(&SE_SOFT_GLSL_T(1)) && SE_SOFT_GLSL_T(1).base == SE_SOFT_GLSL_INT &&
+					SE_SOFT_GLSL_T(1).rows == dimensions && se_soft_glsl_is_scalar(&SE_SOFT_GLSL_T(2)) && SE_SOFT_GLSL_T(2).base == SE_SOFT_GLSL_INT;
+			} else {
+				valid = se_soft_glsl_float_arg(parser, &args[1]) && valid && se_soft_glsl_is_vector(&SE_SOFT_GLSL_T(1)) &&
+					SE_SOFT_GLSL_T(1).rows == dimensions;
+				if (count > 2u) {
+					valid = se_soft_glsl_float_arg(parser, &args[2]) && valid && se_soft_glsl_is_scalar(&SE_SOFT_GLSL_T(2));
+				}
+			}
+			result = se_soft_glsl_make_type(SE_SOFT_GLSL_FLOAT, 4u, 1u);
+			break;
+		}
+		default:
+			// One float argument, result of the same type.
+			valid = se_soft_glsl_float_arg(parser, &args[0]) && se_soft_glsl_is_vector(&SE_SOFT_GLSL_T(0));
+			result = SE_SOFT_GLSL_T(0);
+			break;
+	}
+#undef SE_SOFT_GLSL_T
+	if (!valid) {
+		se_soft_glsl_error(parser, "no matching overloaded function found for '%s'", name);
+		return SE_SOFT_GLSL_NONE;
+	}
+	const b8 constant = builtin < SE_SOFT_GLSL_FN_TEXTURE && se_soft_glsl_all_constant(parser, args, count);
+	const u32 list = se_soft_glsl_commit_list(parser, first, count);
+	const u32 index = se_soft_glsl_add_node(parser, SE_SOFT_GLSL_OP_BUILTIN, &result, true);
+	se_soft_glsl_node* node = &module->nodes[index];
+	node->aux = builtin;
+	node->a = list;
+	node->b = count;
+	node->operand_base = operand_base;
+	node->constant = constant;
+	return se_soft_glsl_fold(parser, index);
+}
+
+static u32 se_soft_glsl_find_function(const se_soft_glsl_parser* parser, const c8* name, const u32* args, const u32 count, const b8 exact) {
+	const se_soft_glsl_module* module = parser->module;
+	for (u32 i = 0u; i < module->function_count; ++i) {
+		const se_soft_glsl_function* function = &module->functions[i];
+		if (function->param_count != count || strcmp(function->name, name) != 0) {
+			continue;
+		}
+		b8 match = true;
+		for (u32 k = 0u; k < count && match; ++k) {
+			const se_soft_glsl_variable* param = &module->variables[function->params[k]];
+			const se_soft_glsl_type* arg = &module->nodes[args[k]].type;
+			if (se_soft_glsl_type_equal(arg, &param->type)) {
+				continue;
+			}
+			match = !exact && param->qualifier != SE_SOFT_GLSL_QUALIFIER_OUT && param->qualifier != SE_SOFT_GLSL_QUALIFIER_INOUT &&
+				arg->array == 0u && param->type.array == 0u && arg->rows == param->type.rows && arg->cols == param->type.cols &&
+				se_soft_glsl_is_numeric(arg->base) && se_soft_glsl_implicit(arg->base, param->type.base);
+		}
+		if (match) {
+			return i;
+		}
+	}
+	return SE_SOFT_GLSL_MISSING;
+}
+
+static u32 se_soft_glsl_make_call(se_soft_glsl_parser* parser, const c8* name, const u32 first, const u32 count) {
+	se_soft_glsl_module* module = parser->module;
+	u32 function = se_soft_glsl_find_function(parser, name, parser->pending + first, count, true);
+	if (function == SE_SOFT_GLSL_MISSING) {
+		function = se_soft_glsl_find_function(parser, name, parser->pending + first, count, false);
+	}
+	if (function != SE_SOFT_GLSL_MISSING) {
+		for (u32 k = 0u; k < count; ++k) {
+			const se_soft_glsl_variable param = module->variables[module->functions[function].params[k]];
+			if (param.qualifier == SE_SOFT_GLSL_QUALIFIER_OUT || param.qualifier == SE_SOFT_GLSL_QUALIFIER_INOUT) {
+				se_soft_glsl_check_lvalue(parser, parser->pending[first + k]);
+			} else {
+				parser->pending[first + k] = se_soft_glsl_coerce(parser, parser->pending[first + k], &param.type);
+			}
+		}
+		const se_soft_glsl_type type = module->functions[function].return_type;
+		const u32 list = se_soft_glsl_commit_list(parser, first, count);
+		const u32 index = se_soft_glsl_add_node(parser, SE_SOFT_GLSL_OP_CALL, &type, type.base != SE_SOFT_GLSL_VOID);
+		se_soft_glsl_node* node = &module->nodes[index];
+		node->aux = function;
+		node->a = list;
+		node->b = count;
+		return index;
+	}
+	for (u32 i = 0u; i < module->function_count; ++i) {
+		if (strcmp(module->functions[i].name, name) == 0) {
+			se_soft_glsl_error(parser, "no matching overloaded function found for '%s'", name);
+			return SE_SOFT_GLSL_NONE;
+		}
+	}
+	for (u32 i = 0u; i < sizeof(se_soft_glsl_builtins) / sizeof(se_soft_glsl_builtins[0]); ++i) {
+		if (strcmp(se_soft_glsl_builtins[i].name, name) == 0) {
+			if (count < se_soft_glsl_builtins[i].min_args || count > se_soft_glsl_builtins[i].max_args) {
+				se_soft_glsl_error(parser, "no matching overloaded function found for '%s'", name);
+				return SE_SOFT_GLSL_NONE;
+			}
+			return se_soft_glsl_make_builtin(parser, se_soft_glsl_builtins[i].builtin, name, first, count);
+		}
+	}
+	se_soft_glsl_error(parser, "'%s': no matching overloaded function found", name);
+	return SE_SOFT_GLSL_NONE;
+}
+
+// Parses a parenthesized argument list after the opening '(' onto the pending stack.
+static u32 se_soft_glsl_parse_arguments(se_soft_glsl_parser* parser) {
+	const u32 first = parser->pending_count;
+	if (se_soft_glsl_accept(parser, ")")) {
+		return first;
+	}
+	if (se_soft_glsl_is(se_soft_glsl_peek(parser), "void") && se_soft_glsl_is(se_soft_glsl_peek_at(parser, 1u), ")")) {
+		se_soft_glsl_next(parser);
+		se_soft_glsl_next(parser);
+		return first;
+	}
+	do {
+		se_soft_glsl_push_pending(parser, se_soft_glsl_parse_assignment(parser));
+	} while (!parser->failed && se_soft_glsl_accept(parser, ","));
+	se_soft_glsl_expect(parser, ")");
+	return first;
+}
+
+static u32 se_soft_glsl_parse_primary(se_soft_glsl_parser* parser) {
+	const se_soft_glsl_token* token = se_soft_glsl_peek(parser);
+	se_soft_glsl_value value;
+	switch (token->kind) {
+		case SE_SOFT_GLSL_TOKEN_INT:
+		case SE_SOFT_GLSL_TOKEN_UINT:
+			se_soft_glsl_next(parser);
+			value.i = (i32)(u32)token->integer;
+			return se_soft_glsl_literal(parser, token->kind == SE_SOFT_GLSL_TOKEN_INT ? SE_SOFT_GLSL_INT : SE_SOFT_GLSL_UINT, value);
+		case SE_SOFT_GLSL_TOKEN_FLOAT:
+			se_soft_glsl_next(parser);
+			value.f = (f32)token->number;
+			return se_soft_glsl_literal(parser, SE_SOFT_GLSL_FLOAT, value);
+		case SE_SOFT_GLSL_TOKEN_IDENT: {
+			if (strcmp(token->text, "true") == 0 || strcmp(token->text, "false") == 0) {
+				se_soft_glsl_next(parser);
+				value.i = token->text[0] == 't';
+				return se_soft_glsl_literal(parser, SE_SOFT_GLSL_BOOL, value);
+			}
+			se_soft_glsl_type type;
+			if (se_soft_glsl_lookup_type(parser, token, &type)) {
+				se_soft_glsl_next(parser);
+				se_soft_glsl_parse_array_suffix(parser, &type);
+				if (!se_soft_glsl_expect(parser, "(")) {
+					return SE_SOFT_GLSL_NONE;
+				}
+				const u32 first = se_soft_glsl_parse_arguments(parser);
+				const u32 result = se_soft_glsl_make_construct(parser, type, first, parser->pending_count - first);
+				parser->pending_count = first;
+				return result;
+			}
+			se_soft_glsl_next(parser);
+			if (se_soft_glsl_accept(parser, "(")) {
+				const u32 first = se_soft_glsl_parse_arguments(parser);
+				const u32 result = se_soft_glsl_make_call(parser, token->text, first, parser->pending_count - first);
+				parser->pending_count = first;
+				return result;
+			}
+			const u32 variable = se_soft_glsl_lookup(parser, token->text);
+			if (variable == SE_SOFT_GLSL_MISSING) {
+				se_soft_glsl_error(parser, "'%s': undeclared identifier", token->text);
+				return SE_SOFT_GLSL_NONE;
+			}
+			return se_soft_glsl_ref(parser, variable);
+		}
+		default:
+			if (se_soft_glsl_accept(parser, "(")) {
+				const u32 result = se_soft_glsl_parse_expression(parser);
+				se_soft_glsl_expect(parser, ")");
+				return result;
+			}
+			se_soft_glsl_error(parser, "syntax error, unexpected '%s'", token->text);
+			return SE_SOFT_GLSL_NONE;
+	}
+}
+
+static u32 se_soft_glsl_make_step(se_soft_glsl_parser* parser, const u8 op, const u32 operand) {
+	const se_soft_glsl_type type = parser->module->nodes[operand].type;
+	se_soft_glsl_check_lvalue(parser, operand);
+	if (type.array != 0u || !se_soft_glsl_is_numeric(type.base)) {
+		se_soft_glsl_error(parser, "wrong operand type for increment or decrement");
+		return operand;
+	}
+	const u32 index = se_soft_glsl_add_node(parser, op, &type, true);
+	parser->module->nodes[index].a = operand;
+	return index;
+}
+
+static u32 se_soft_glsl_parse_postfix(se_soft_glsl_parser* parser) {
+	u32 node = se_soft_glsl_parse_primary(parser);
+	while (!parser->failed) {
+		if (se_soft_glsl_accept(parser, "[")) {
+			const u32 subscript = se_soft_glsl_parse_expression(parser);
+			se_soft_glsl_expect(parser, "]");
+			node = se_soft_glsl_make_index(parser, node, subscript);
+		} else if (se_soft_glsl_accept(parser, ".")) {
+			c8 name[SE_SOFT_GLSL_NAME_MAX];
+			if (!se_soft_glsl_expect_name(parser, name)) {
+				break;
+			}
+			if (strcmp(name, "length") == 0 && se_soft_glsl_accept(parser, "(")) {
+				se_soft_glsl_expect(parser, ")");
+				const se_soft_glsl_type type = parser->module->nodes[node].type;
+				node = se_soft_glsl_int_literal(parser, (i32)(type.array > 0u ? type.array : (type.cols > 1u ? type.cols : type.rows)));
+			} else {
+				node = se_soft_glsl_make_member(parser, node, name);
+			}
+		} else if (se_soft_glsl_accept(parser, "++")) {
+			node = se_soft_glsl_make_step(parser, SE_SOFT_GLSL_OP_POST_INC, node);
+		} else if (se_soft_glsl_accept(parser, "--")) {
+			node = se_soft_glsl_make_step(parser, SE_SOFT_GLSL_OP_POST_DEC, node);
+		} else {
+			break;
+		}
+	}
+	return node;
+}
+
+static u32 se_soft_glsl_parse_unary(se_soft_glsl_parser* parser) {
+	if (se_soft_glsl_accept(parser, "++")) {
+		return se_soft_glsl_make_step(parser, SE_SOFT_GLSL_OP_PRE_INC, se_soft_glsl_parse_unary(parser));
+	}
+	if (se_soft_glsl_accept(parser, "--")) {
+		return se_soft_glsl_make_step(parser, SE_SOFT_GLSL_OP_PRE_DEC, se_soft_glsl_parse_unary(parser));
+	}
+	if (se_soft_glsl_accept(parser, "-")) {
+		return se_soft_glsl_make_unary(parser, SE_SOFT_GLSL_OP_NEGATE, se_soft_glsl_parse_unary(parser));
+	}
+	if (se_soft_glsl_accept(parser, "+")) {
+		return se_soft_glsl_parse_unary(parser);
+	}
+	if (se_soft_glsl_accept(parser, "!")) {
+		return se_soft_glsl_make_unary(parser, SE_SOFT_GLSL_OP_NOT, se_soft_glsl_parse_unary(parser));
+	}
+	if (se_soft_glsl_accept(parser, "~")) {
+		return se_soft_glsl_make_unary(parser, SE_SOFT_GLSL_OP_BIT_NOT, se_soft_glsl_parse_unary(parser));
+	}
+	return se_soft_glsl_parse_postfix(parser);
+}
+
+static u32 se_soft_glsl_binary_precedence(const se_soft_glsl_token* token) {
+	static const struct {
+		const c8* text;
+		u32 precedence;
+	} operators[] = {
+		{ "||", 1u }, { "^^", 2u }, { "&&", 3u }, { "|", 4u }, { "^", 5u }, { "&", 6u },
+		{ "==", 7u }, { "!=", 7u }, { "<", 8u }, { ">", 8u }, { "<=", 8u }, { ">=", 8u },
+		{ "<<", 9u }, { ">>", 9u }, { "+", 10u }, { "-", 10u }, { "*", 11u }, { "/", 11u }, { "%", 11u }
+	};
+	if (token->kind != SE_SOFT_GLSL_TOKEN_PUNCT) {
+		return 0u;
+	}
+	for (u32 i = 0u; i < sizeof(operators) / sizeof(operators[0]); ++i) {
+		if (strcmp(token->text, operators[i].text) == 0) {
+			return operators[i].precedence;
+		}
+	}
+	return 0u;
+}
+
+static u32 se_soft_glsl_parse_binary(se_soft_glsl_parser* parser, const u32 min_precedence) {
+	u32 left = se_soft_glsl_parse_unary(parser);
+	while (!parser->failed) {
+		const se_soft_glsl_token* token = se_soft_glsl_peek(parser);
+		const u32 precedence = se_soft_glsl_binary_precedence(token);
+		if (precedence == 0u || precedence <= min_precedence) {
+			break;
+		}
+		se_soft_glsl_next(parser);
+		const u32 right = se_soft_glsl_parse_binary(parser, precedence);
+		left = se_soft_glsl_make_binary(parser, token->text, left, right);
+	}
+	return left;
+}
+
+static void se_soft_glsl_check_condition(se_soft_glsl_parser* parser, const u32 condition) {
+	const se_soft_glsl_type* type = &parser->module->nodes[condition].type;
+	if (!parser->failed && (!se_soft_glsl_is_scalar(type) || type->base != SE_SOFT_GLSL_BOOL)) {
+		se_soft_glsl_error(parser, "boolean expression expected");
+	}
+}
+
+static u32 se_soft_glsl_parse_conditional(se_soft_glsl_parser* parser) {
+	const u32 condition = se_soft_glsl_parse_binary(parser, 0u);
+	if (!se_soft_glsl_accept(parser, "?")) {
+		return condition;
+	}
+	se_soft_glsl_check_condition(parser, condition);
+	u32 when_true = se_soft_glsl_parse_expression(parser);
+	se_soft_glsl_expect(parser, ":");
+	u32 when_false = se_soft_glsl_parse_assignment(parser);
+	se_soft_glsl_unify(parser, &when_true, &when_false);
+	const se_soft_glsl_type type = parser->module->nodes[when_true].type;
+	if (!parser->failed && !se_soft_glsl_type_equal(&type, &parser->module->nodes[when_false].type)) {
+		se_soft_glsl_error(parser, "'?:': wrong operand types");
+		return condition;
+	}
+	const u32 index = se_soft_glsl_add_node(parser, SE_SOFT_GLSL_OP_SELECT, &type, false);
+	se_soft_glsl_node* node = &parser->module->nodes[index];
+	node->a = condition;
+	node->b = when_true;
+	node->c = when_false;
+	const u32 children[3] = { condition, when_true, when_false };
+	node->constant = se_soft_glsl_all_constant(parser, children, 3u);
+	return se_soft_glsl_fold(parser, index);
+}
+
+static u32 se_soft_glsl_parse_assignment(se_soft_glsl_parser* parser) {
+	static const c8* operators[] = { "=", "+=", "-=", "*=", "/=", "%=", "&=", "|=", "^=", "<<=", ">>=" };
+	const u32 left = se_soft_glsl_parse_conditional(parser);
+	const se_soft_glsl_token* token = se_soft_glsl_peek(parser);
+	if (token->kind != SE_SOFT_GLSL_TOKEN_PUNCT) {
+		return left;
+	}
+	b8 found = false;
+	for (u32 i = 0u; i < sizeof(operators) / sizeof(operators[0]) && !found; ++i) {
+		found = strcmp(token->text, operators[i]) == 0;
+	}
+	if (!found) {
+		return left;
+	}
+	se_soft_glsl_next(parser);
+	se_soft_glsl_check_lvalue(parser, left);
+	const u32 right = se_soft_glsl_parse_assignment(parser);
+	const se_soft_glsl_type type = parser->module->nodes[left].type;
+	u32 value = right;
+	if (strcmp(token->text, "=") != 0) {
+		c8 op[4] = {0};
+		memcpy(op, token->text, strlen(token->text) - 1u);
+		value = se_soft_glsl_make_binary(parser, op, left, right);
+	}
+	value = se_soft_glsl_coerce(parser, value, &type);
+	const u32 index = se_soft_glsl_add_node(parser, SE_SOFT_GLSL_OP_ASSIGN, &type, false);
+	se_soft_glsl_node* node = &parser->module->nodes[index];
+	node->a = left;
+	node->b = value;
+	return index;
+}
+
+static u32 se_soft_glsl_parse_expression(se_soft_glsl_parser* parser) {
+	u32 left = se_soft_glsl_parse_assignment(parser);
+	while (!parser->failed && se_soft_glsl_accept(parser, ",")) {
+		const u32 right = se_soft_glsl_parse_assignment(parser);
+		const se_soft_glsl_type type = parser->module->nodes[right].type;
+		const u32 index = se_soft_glsl_add_node(parser, SE_SOFT_GLSL_OP_SEQUENCE, &type, false);
+		parser->module->nodes[index].a = left;
+		parser->module->nodes[index].b = right;
+		left = index;
+	}
+	return left;
+}
+
+// Statements and declarations
+
+static u32 se_soft_glsl_make_statement(se_soft_glsl_parser* parser, const u8 op, const u32 a, const u32 b, const u32 c, const u32 d) {
+	const u32 index = se_soft_glsl_add_node(parser, op, NULL, false);
+	se_soft_glsl_node* node = &parser->module->nodes[index];
+	if (index != SE_SOFT_GLSL_NONE) {
+		node->a = a;
+		node->b = b;
+		node->c = c;
+		node->d = d;
+	}
+	return index;
+}
+
+// Wraps pending[first ..] into one statement and pops it.
+static u32 se_soft_glsl_make_block(se_soft_glsl_parser* parser, const u32 first) {
+	const u32 count = parser->pending_count - first;
+	u32 result = SE_SOFT_GLSL_NONE;
+	if (count == 1u) {
+		result = parser->pending[first];
+	} else if (count > 1u) {
+		result = se_soft_glsl_make_statement(parser, SE_SOFT_GLSL_OP_BLOCK, se_soft_glsl_commit_list(parser, first, count), count, 0u, 0u);
+	}
+	parser->pending_count = first;
+	return result;
+}
+
+static b8 se_soft_glsl_starts_declaration(const se_soft_glsl_parser* parser) {
+	static const c8* qualifiers[] = { "const", "struct", "highp", "mediump", "lowp", "precise", "invariant" };
+	const se_soft_glsl_token* token = se_soft_glsl_peek(parser);
+	se_soft_glsl_type type;
+	for (u32 i = 0u; i < sizeof(qualifiers) / sizeof(qualifiers[0]); ++i) {
+		if (se_soft_glsl_is(token, qualifiers[i])) {
+			return true;
+		}
+	}
+	// `vec3(...)` starts an expression statement, `vec3 v` a declaration.
+	if (!se_soft_glsl_lookup_type(parser, token, &type)) {
+		return false;
+	}
+	const se_soft_glsl_token* after = se_soft_glsl_peek_at(parser, 1u);
+	return after->kind == SE_SOFT_GLSL_TOKEN_IDENT || se_soft_glsl_is(after, "[");
+}
+
+// Resolves an unsized array from its initializer and converts the initializer to `type`.
+static u32 se_soft_glsl_parse_initializer(se_soft_glsl_parser* parser, se_soft_glsl_type* type) {
+	if (!se_soft_glsl_accept(parser, "=")) {
+		return SE_SOFT_GLSL_NONE;
+	}
+	const u32 init = se_soft_glsl_parse_assignment(parser);
+	if (type->array == SE_SOFT_GLSL_UNSIZED && parser->module->nodes[init].type.array > 0u) {
+		type->array = parser->module->nodes[init].type.array;
+	}
+	return se_soft_glsl_coerce(parser, init, type);
+}
+
+// Names a folded constant so reads of it fold as well.
+static void se_soft_glsl_declare_constant(se_soft_glsl_parser* parser, const c8* name, const se_soft_glsl_type* type, const u32 init) {
+	const u32 slot = parser->module->nodes[init].slot;
+	const u32 variable = se_soft_glsl_declare(parser, name, type, SE_SOFT_GLSL_QUALIFIER_CONST, SE_SOFT_GLSL_SHARED, false);
+	if (variable != SE_SOFT_GLSL_MISSING) {
+		parser->module->variables[variable].offset = slot;
+		parser->module->variables[variable].constant = true;
+	}
+}
+
+static u32 se_soft_glsl_parse_local_declaration(se_soft_glsl_parser* parser) {
+	se_soft_glsl_qualifiers qualifiers;
+	se_soft_glsl_type type;
+	se_soft_glsl_parse_qualifiers(parser, &qualifiers);
+	if (qualifiers.qualifier != SE_SOFT_GLSL_QUALIFIER_NONE && qualifiers.qualifier != SE_SOFT_GLSL_QUALIFIER_CONST) {
+		se_soft_glsl_error(parser, "storage qualifier not allowed on local variables");
+		return SE_SOFT_GLSL_NONE;
+	}
+	if (se_soft_glsl_is(se_soft_glsl_peek(parser), "struct")) {
+		se_soft_glsl_parse_struct(parser, &type);
+		if (se_soft_glsl_accept(parser, ";")) {
+			return SE_SOFT_GLSL_NONE;
+		}
+	} else if (se_soft_glsl_lookup_type(parser, se_soft_glsl_peek(parser), &type)) {
+		se_soft_glsl_next(parser);
+	} else {
+		se_soft_glsl_error(parser, "'%s': unknown type", se_soft_glsl_peek(parser)->text);
+		return SE_SOFT_GLSL_NONE;
+	}
+	se_soft_glsl_parse_array_suffix(parser, &type);
+	if (se_soft_glsl_is_sampler(type.base)) {
+		se_soft_glsl_error(parser, "samplers must be uniform");
+		return SE_SOFT_GLSL_NONE;
+	}
+	const u32 first = parser->pending_count;
+	do {
+		c8 name[SE_SOFT_GLSL_NAME_MAX];
+		if (!se_soft_glsl_expect_name(parser, name)) {
+			break;
+		}
+		se_soft_glsl_type variable_type = type;
+		se_soft_glsl_parse_array_suffix(parser, &variable_type);
+		const u32 init = se_soft_glsl_parse_initializer(parser, &variable_type);
+		if (qualifiers.qualifier == SE_SOFT_GLSL_QUALIFIER_CONST && init == SE_SOFT_GLSL_NONE) {
+			se_soft_glsl_error(parser, "'%s': const variables must be initialized", name);
+			break;
+		}
+		if (qualifiers.qualifier == SE_SOFT_GLSL_QUALIFIER_CONST && parser->module->nodes[init].constant) {
+			se_soft_glsl_declare_constant(parser, name, &variable_type, init);
+			continue;
+		}
+		const u32 variable = se_soft_glsl_declare(parser, name, &variable_type, SE_SOFT_GLSL_QUALIFIER_NONE, SE_SOFT_GLSL_LOCAL, true);
+		se_soft_glsl_push_pending(parser, se_soft_glsl_make_statement(parser, SE_SOFT_GLSL_OP_DECLARE, variable, init, 0u, 0u));
+	} while (!parser->failed && se_soft_glsl_accept(parser, ","));
+	se_soft_glsl_expect(parser, ";");
+	return se_soft_glsl_make_block(parser, first);
+}
+
+static u32 se_soft_glsl_parse_block(se_soft_glsl_parser* parser, const b8 new_scope) {
+	if (!se_soft_glsl_expect(parser, "{")) {
+		return SE_SOFT_GLSL_NONE;
+	}
+	if (new_scope) {
+		se_soft_glsl_push_scope(parser);
+	}
+	const u32 first = parser->pending_count;
+	while (!parser->failed && !se_soft_glsl_accept(parser, "}")) {
+		if (se_soft_glsl_peek(parser)->kind == SE_SOFT_GLSL_TOKEN_EOF) {
+			se_soft_glsl_error(parser, "syntax error, unexpected end of input, expected '}'");
+			break;
+		}
+		const u32 statement = se_soft_glsl_parse_statement(parser);
+		if (statement != SE_SOFT_GLSL_NONE) {
+			se_soft_glsl_push_pending(parser, statement);
+		}
+	}
+	if (new_scope) {
+		se_soft_glsl_pop_scope(parser);
+	}
+	// Always a BLOCK so the body of a function or loop can be checked for discard.
+	const u32 count = parser->pending_count - first;
+	const u32 list = se_soft_glsl_commit_list(parser, first, count);
+	parser->pending_count = first;
+	return se_soft_glsl_make_statement(parser, SE_SOFT_GLSL_OP_BLOCK, list, count, 0u, 0u);
+}
+
+static u32 se_soft_glsl_parse_substatement(se_soft_glsl_parser* parser) {
+	se_soft_glsl_push_scope(parser);
+	const u32 statement = se_soft_glsl_parse_statement(parser);
+	se_soft_glsl_pop_scope(parser);
+	return statement;
+}
+
+static u32 se_soft_glsl_parse_loop_body(se_soft_glsl_parser* parser) {
+	++parser->loop_depth;
+	const u32 body = se_soft_glsl_parse_substatement(parser);
+	--parser->loop_depth;
+	return body;
+}
+
+static u32 se_soft_glsl_parse_condition(se_soft_glsl_parser* parser) {
+	const u32 condition = se_soft_glsl_parse_expression(parser);
+	se_soft_glsl_check_condition(parser, condition);
+	return condition;
+}
+
+static u32 se_soft_glsl_parse_statement(se_soft_glsl_parser* parser) {
+	const se_soft_glsl_token* token = se_soft_glsl_peek(parser);
+	if (parser->failed) {
+		return SE_SOFT_GLSL_NONE;
+	}
+	if (se_soft_glsl_is(token, "{")) {
+		return se_soft_glsl_parse_block(parser, true);
+	}
+	if (se_soft_glsl_accept(parser, ";")) {
+		return SE_SOFT_GLSL_NONE;
+	}
+	if (se_soft_glsl_accept(parser, "if")) {
+		se_soft_glsl_expect(parser, "(");
+		const u32 condition = se_soft_glsl_parse_condition(parser);
+		se_soft_glsl_expect(parser, ")");
+		const u32 when_true = se_soft_glsl_parse_substatement(parser);
+		const u32 when_false = se_soft_glsl_accept(parser, "else") ? se_soft_glsl_parse_substatement(parser) : SE_SOFT_GLSL_NONE;
+		return se_soft_glsl_make_statement(parser, SE_SOFT_GLSL_OP_IF, condition, when_true, when_false, 0u);
+	}
+	if (se_soft_glsl_accept(parser, "for")) {
+		se_soft_glsl_push_scope(parser);
+		se_soft_glsl_expect(parser, "(");
+		u32 init = SE_SOFT_GLSL_NONE;
+		if (se_soft_glsl_starts_declaration(parser)) {
+			init = se_soft_glsl_parse_local_declaration(parser);
+		} else if (!se_soft_glsl_accept(parser, ";")) {
+			init = se_soft_glsl_make_statement(parser, SE_SOFT_GLSL_OP_EXPRESSION, se_soft_glsl_parse_expression(parser), 0u, 0u, 0u);
+			se_soft_glsl_expect(parser, ";");
+		}
+		const u32 condition = se_soft_glsl_is(se_soft_glsl_peek(parser), ";") ? SE_SOFT_GLSL_NONE : se_soft_glsl_parse_condition(parser);
+		se_soft_glsl_expect(parser, ";");
+		const u32 step = se_soft_glsl_is(se_soft_glsl_peek(parser), ")") ? SE_SOFT_GLSL_NONE : se_soft_glsl_parse_expression(parser);
+		se_soft_glsl_expect(parser, ")");
+		const u32 body = se_soft_glsl_parse_loop_body(parser);
+		se_soft_glsl_pop_scope(parser);
+		return se_soft_glsl_make_statement(parser, SE_SOFT_GLSL_OP_FOR, init, condition, step, body);
+	}
+	if (se_soft_glsl_accept(parser, "while")) {
+		se_soft_glsl_expect(parser, "(");
+		const u32 condition = se_soft_glsl_parse_condition(parser);
+		se_soft_glsl_expect(parser, ")");
+		const u32 body = se_soft_glsl_parse_loop_body(parser);
+		return se_soft_glsl_make_statement(parser, SE_SOFT_GLSL_OP_FOR, SE_SOFT_GLSL_NONE, condition, SE_SOFT_GLSL_NONE, body);
+	}
+	if (se_soft_glsl_accept(parser, "do")) {
+		const u32 body = se_soft_glsl_parse_loop_body(parser);
+		se_soft_glsl_expect(parser, "while");
+		se_soft_glsl_expect(parser, "(");
+		const u32 condition = se_soft_glsl_parse_condition(parser);
+		se_soft_glsl_expect(parser, ")");
+		se_soft_glsl_expect(parser, ";");
+		return se_soft_glsl_make_statement(parser, SE_SOFT_GLSL_OP_DO, body, condition, 0u, 0u);
+	}
+	if (se_soft_glsl_accept(parser, "return")) {
+		const u32 function = parser->function - 1u;
+		const se_soft_glsl_type return_type = parser->module->functions[function].return_type;
+		u32 value = SE_SOFT_GLSL_NONE;
+		if (!se_soft_glsl_is(se_soft_glsl_peek(parser), ";")) {
+			value = se_soft_glsl_coerce(parser, se_soft_glsl_parse_expression(parser), &return_type);
+		}
+		if ((value == SE_SOFT_GLSL_NONE) != (return_type.base == SE_SOFT_GLSL_VOID)) {
+			se_soft_glsl_error(parser, "'return': function return value does not match its declaration");
+		}
+		se_soft_glsl_expect(parser, ";");
+		const u32 index = se_soft_glsl_make_statement(parser, SE_SOFT_GLSL_OP_RETURN, value, 0u, 0u, 0u);
+		parser->module->nodes[index].aux = function;
+		return index;
+	}
+	if (se_soft_glsl_is(token, "break") || se_soft_glsl_is(token, "continue")) {
+		const u8 op = token->text[0] == 'b' ? SE_SOFT_GLSL_OP_BREAK : SE_SOFT_GLSL_OP_CONTINUE;
+		if (parser->loop_depth == 0u) {
+			se_soft_glsl_error(parser, "'%s': statement only allowed in loops", token->text);
+			return SE_SOFT_GLSL_NONE;
+		}
+		se_soft_glsl_next(parser);
+		se_soft_glsl_expect(parser, ";");
+		return se_soft_glsl_make_statement(parser, op, 0u, 0u, 0u, 0u);
+	}
+	if (se_soft_glsl_is(token, "discard")) {
+		if (parser->module->stage != SE_SOFT_GLSL_FRAGMENT) {
+			se_soft_glsl_error(parser, "'discard': only allowed in fragment shaders");
+			return SE_SOFT_GLSL_NONE;
+		}
+		se_soft_glsl_next(parser);
+		se_soft_glsl_expect(parser, ";");
+		return se_soft_glsl_make_statement(parser, SE_SOFT_GLSL_OP_DISCARD, 0u, 0u, 0u, 0u);
+	}
+	if (se_soft_glsl_is(token, "switch")) {
+		se_soft_glsl_error(parser, "'switch': statement not supported by the software backend");
+		return SE_SOFT_GLSL_NONE;
+	}
+	if (se_soft_glsl_starts_declaration(parser)) {
+		return se_soft_glsl_parse_local_declaration(parser);
+	}
+	const u32 expression = se_soft_glsl_parse_expression(parser);
+	se_soft_glsl_expect(parser, ";");
+	return se_soft_glsl_make_statement(parser, SE_SOFT_GLSL_OP_EXPRESSION, expression, 0u, 0u, 0u);
+}
+
+static void se_soft_glsl_parse_function(se_soft_glsl_parser* parser, const se_soft_glsl_type* return_type, const c8* name) {
+	se_soft_glsl_module* module = parser->module;
+	c8 names[SE_SOFT_GLSL_MAX_PARAMS][SE_SOFT_GLSL_NAME_MAX];
+	se_soft_glsl_type types[SE_SOFT_GLSL_MAX_PARAMS];
+	u8 qualifiers[SE_SOFT_GLSL_MAX_PARAMS];
+	u32 count = 0u;
+	if (se_soft_glsl_is(se_soft_glsl_peek(parser), "void") && se_soft_glsl_is(se_soft_glsl_peek_at(parser, 1u), ")")) {
+		se_soft_glsl_next(parser);
+	}
+	if (!se_soft_glsl_accept(parser, ")")) {
+		do {
+			se_soft_glsl_qualifiers parsed;
+			se_soft_glsl_parse_qualifiers(parser, &parsed);
+			if (count >= SE_SOFT_GLSL_MAX_PARAMS) {
+				se_soft_glsl_error(parser, "'%s': too many parameters", name);
+				return;
+			}
+			if (!se_soft_glsl_lookup_type(parser, se_soft_glsl_peek(parser), &types[count])) {
+				se_soft_glsl_error(parser, "'%s': unknown parameter type", se_soft_glsl_peek(parser)->text);
+				return;
+			}
+			se_soft_glsl_next(parser);
+			se_soft_glsl_parse_array_suffix(parser, &types[count]);
+			names[count][0] = '\0';
+			if (se_soft_glsl_peek(parser)->kind == SE_SOFT_GLSL_TOKEN_IDENT) {
+				se_soft_glsl_expect_name(parser, names[count]);
+				se_soft_glsl_parse_array_suffix(parser, &types[count]);
+			}
+			if (types[count].array == SE_SOFT_GLSL_UNSIZED || types[count].base == SE_SOFT_GLSL_VOID) {
+				se_soft_glsl_error(parser, "'%s': invalid parameter type", name);
+				return;
+			}
+			qualifiers[count] = parsed.qualifier == SE_SOFT_GLSL_QUALIFIER_OUT || parsed.qualifier == SE_SOFT_GLSL_QUALIFIER_INOUT ?
+				parsed.qualifier : SE_SOFT_GLSL_QUALIFIER_NONE;
+			++count;
+		} while (!parser->failed && se_soft_glsl_accept(parser, ","));
+		se_soft_glsl_expect(parser, ")");
+	}
+	if (parser->failed) {
+		return;
+	}
+	u32 index = SE_SOFT_GLSL_MISSING;
+	for (u32 i = 0u; i < module->function_count && index == SE_SOFT_GLSL_MISSING; ++i) {
+		const se_soft_glsl_function* function = &module->functions[i];
+		b8 same = function->param_count == count && strcmp(function->name, name) == 0;
+		for (u32 k = 0u; k < count && same; ++k) {
+			same = se_soft_glsl_type_equal(&module->variables[function->params[k]].type, &types[k]);
+		}
+		if (same) {
+			index = i;
+		}
+	}
+	if (index != SE_SOFT_GLSL_MISSING && !se_soft_glsl_type_equal(&module->functions[index].return_type, return_type)) {
+		se_soft_glsl_error(parser, "'%s': function return types differ between declarations", name);
+		return;
+	}
+	if (index == SE_SOFT_GLSL_MISSING) {
+		if (!se_soft_glsl_grow((void**)&module->functions, &module->function_capacity, module->function_count + 1u, sizeof(*module->functions))) {
+			se_soft_glsl_error(parser, "out of memory");
+			return;
+		}
+		index = module->function_count++;
+		se_soft_glsl_function* function = &module->functions[index];
+		memset(function, 0, sizeof(*function));
+		se_soft_glsl_copy_name(function->name, name);
+		function->return_type = *return_type;
+		function->param_count = count;
+		for (u32 k = 0u; k < count; ++k) {
+			const u32 param = se_soft_glsl_add_variable(parser, names[k], &types[k], qualifiers[k], SE_SOFT_GLSL_LOCAL, true);
+			module->functions[index].params[k] = param;
+		}
+		if (return_type->base != SE_SOFT_GLSL_VOID) {
+			module->functions[index].return_slot = module->local_slots;
+			module->local_slots += se_soft_glsl_type_slots(module, return_type);
+		}
+	}
+	if (se_soft_glsl_accept(parser, ";") || parser->failed) {
+		return;
+	}
+	if (module->functions[index].defined) {
+		se_soft_glsl_error(parser, "'%s': function already has a body", name);
+		return;
+	}
+	module->functions[index].defined = true;
+	se_soft_glsl_push_scope(parser);
+	for (u32 k = 0u; k < count; ++k) {
+		se_soft_glsl_variable* param = &module->variables[module->functions[index].params[k]];
+		se_soft_glsl_copy_name(param->name, names[k]);
+		param->qualifier = qualifiers[k];
+		if (names[k][0] != '\0') {
+			se_soft_glsl_push_name(parser, module->functions[index].params[k]);
+		}
+	}
+	parser->function = index + 1u;
+	// Parameters share the outermost scope of the body, so redeclaring one is an error.
+	const u32 body = se_soft_glsl_parse_block(parser, false);
+	parser->function = SE_SOFT_GLSL_NONE;
+	se_soft_glsl_pop_scope(parser);
+	module->functions[index].body = body;
+	if (strcmp(name, "main") == 0) {
+		if (count != 0u || return_type->base != SE_SOFT_GLSL_VOID) {
+			se_soft_glsl_error(parser, "'main': function must take no parameters and return void");
+			return;
+		}
+		module->main_function = index + 1u;
+	}
+}
+
+static void se_soft_glsl_declare_global(se_soft_glsl_parser* parser, const se_soft_glsl_qualifiers* qualifiers, const c8* name, const se_soft_glsl_type* type, const u32 init) {
+	se_soft_glsl_module* module = parser->module;
+	const u8 qualifier = qualifiers->qualifier;
+	const b8 constant_init = init != SE_SOFT_GLSL_NONE && module->nodes[init].constant;
+	if (se_soft_glsl_is_sampler(type->base) && qualifier != SE_SOFT_GLSL_QUALIFIER_UNIFORM) {
+		se_soft_glsl_error(parser, "'%s': samplers must be uniform", name);
+		return;
+	}
+	if (qualifier == SE_SOFT_GLSL_QUALIFIER_CONST) {
+		if (!constant_init) {
+			se_soft_glsl_error(parser, "'%s': global const initializers must be constant expressions", name);
+			return;
+		}
+		se_soft_glsl_declare_constant(parser, name, type, init);
+		return;
+	}
+	if (qualifier == SE_SOFT_GLSL_QUALIFIER_UNIFORM) {
+		const u32 variable = se_soft_glsl_declare(parser, name, type, qualifier, SE_SOFT_GLSL_SHARED, true);
+		if (variable == SE_SOFT_GLSL_MISSING || init == SE_SOFT_GLSL_NONE) {
+			return;
+		}
+		if (!constant_init) {
+			se_soft_glsl_error(parser, "'%s': uniform initializers must be constant expressions", name);
+			return;
+		}
+		memcpy(module->shared + module->variables[variable].offset, module->shared + module->nodes[init].slot,
+			sizeof(*module->shared) * se_soft_glsl_type_slots(module, type));
+		return;
+	}
+	if (qualifier == SE_SOFT_GLSL_QUALIFIER_IN || qualifier == SE_SOFT_GLSL_QUALIFIER_OUT) {
+		if (init != SE_SOFT_GLSL_NONE || type->base == SE_SOFT_GLSL_BOOL || type->base == SE_SOFT_GLSL_STRUCT) {
+			se_soft_glsl_error(parser, "'%s': invalid shader interface variable", name);
+			return;
+		}
+		const u32 variable = se_soft_glsl_declare(parser, name, type, qualifier, SE_SOFT_GLSL_LOCAL, true);
+		if (variable != SE_SOFT_GLSL_MISSING) {
+			module->variables[variable].location = qualifiers->location;
+			module->variables[variable].flat = qualifiers->flat || type->base != SE_SOFT_GLSL_FLOAT;
+		}
+		return;
+	}
+	if (qualifier != SE_SOFT_GLSL_QUALIFIER_NONE) {
+		se_soft_glsl_error(parser, "'%s': qualifier not allowed at global scope", name);
+		return;
+	}
+	// Plain globals are reinitialized by every invocation, in declaration order.
+	const u32 variable = se_soft_glsl_declare(parser, name, type, qualifier, SE_SOFT_GLSL_LOCAL, true);
+	se_soft_glsl_push_pending(parser, se_soft_glsl_make_statement(parser, SE_SOFT_GLSL_OP_DECLARE, variable, init, 0u, 0u));
+}
+
+static void se_soft_glsl_parse_global(se_soft_glsl_parser* parser) {
+	if (se_soft_glsl_accept(parser, ";")) {
+		return;
+	}
+	if (se_soft_glsl_accept(parser, "precision")) {
+		while (!parser->failed && !se_soft_glsl_accept(parser, ";")) {
+			if (se_soft_glsl_next(parser)->kind == SE_SOFT_GLSL_TOKEN_EOF) {
+				se_soft_glsl_error(parser, "syntax error, unexpected end of input");
+			}
+		}
+		return;
+	}
+	se_soft_glsl_qualifiers qualifiers;
+	se_soft_glsl_type type;
+	se_soft_glsl_parse_qualifiers(parser, &qualifiers);
+	const se_soft_glsl_token* token = se_soft_glsl_peek(parser);
+	if (se_soft_glsl_is(token, "struct")) {
+		se_soft_glsl_parse_struct(parser, &type);
+		if (se_soft_glsl_accept(parser, ";")) {
+			return;
+		}
+	} else if (se_soft_glsl_lookup_type(parser, token, &type)) {
+		se_soft_glsl_next(parser);
+	} else if (qualifiers.any && token->kind == SE_SOFT_GLSL_TOKEN_IDENT && se_soft_glsl_is(se_soft_glsl_peek_at(parser, 1u), ";")) {
+		// Redeclarations such as `invariant gl_Position;` change nothing here.
+		se_soft_glsl_next(parser);
+		se_soft_glsl_next(parser);
+		return;
+	} else {
+		se_soft_glsl_error(parser, "syntax error, unexpected '%s'", token->text);
+		return;
+	}
+	se_soft_glsl_parse_array_suffix(parser, &type);
+	if (se_soft_glsl_peek(parser)->kind == SE_SOFT_GLSL_TOKEN_IDENT && se_soft_glsl_is(se_soft_glsl_peek_at(parser, 1u), "(")) {
+		c8 name[SE_SOFT_GLSL_NAME_MAX];
+		se_soft_glsl_expect_name(parser, name);
+		se_soft_glsl_next(parser);
+		se_soft_glsl_parse_function(parser, &type, name);
+		return;
+	}
+	do {
+		c8 name[SE_SOFT_GLSL_NAME_MAX];
+		if (!se_soft_glsl_expect_name(parser, name)) {
+			return;
+		}
+		se_soft_glsl_type variable_type = type;
+		se_soft_glsl_parse_array_suffix(parser, &variable_type);
+		const u32 init = se_soft_glsl_parse_initializer(parser, &variable_type);
+		se_soft_glsl_declare_global(parser, &qualifiers, name, &variable_type, init);
+	} while (!parser->failed && se_soft_glsl_accept(parser, ","));
+	se_soft_glsl_expect(parser, ";");
+}
+
+static void se_soft_glsl_declare_builtins(se_soft_glsl_parser* parser) {
+	static const struct {
+		const c8* name;
+		u8 stage;
+		u8 base;
+		u8 rows;
+		u8 variable;
+	} builtins[] = {
+		{ "gl_Position", SE_SOFT_GLSL_VERTEX, SE_SOFT_GLSL_FLOAT, 4u, SE_SOFT_GLSL_BUILTIN_VAR_POSITION },
+		{ "gl_PointSize", SE_SOFT_GLSL_VERTEX, SE_SOFT_GLSL_FLOAT, 1u, SE_SOFT_GLSL_BUILTIN_VAR_POINT_SIZE },
+		{ "gl_VertexID", SE_SOFT_GLSL_VERTEX, SE_SOFT_GLSL_INT, 1u, SE_SOFT_GLSL_BUILTIN_VAR_VERTEX_ID },
+		{ "gl_InstanceID", SE_SOFT_GLSL_VERTEX, SE_SOFT_GLSL_INT, 1u, SE_SOFT_GLSL_BUILTIN_VAR_INSTANCE_ID },
+		{ "gl_FragCoord", SE_SOFT_GLSL_FRAGMENT, SE_SOFT_GLSL_FLOAT, 4u, SE_SOFT_GLSL_BUILTIN_VAR_FRAG_COORD },
+		{ "gl_FrontFacing", SE_SOFT_GLSL_FRAGMENT, SE_SOFT_GLSL_BOOL, 1u, SE_SOFT_GLSL_BUILTIN_VAR_FRONT_FACING },
+		{ "gl_FragDepth", SE_SOFT_GLSL_FRAGMENT, SE_SOFT_GLSL_FLOAT, 1u, SE_SOFT_GLSL_BUILTIN_VAR_FRAG_DEPTH },
+		{ "gl_PointCoord", SE_SOFT_GLSL_FRAGMENT, SE_SOFT_GLSL_FLOAT, 2u, SE_SOFT_GLSL_BUILTIN_VAR_POINT_COORD }
+	};
+	for (u32 i = 0u; i < sizeof(builtins) / sizeof(builtins[0]); ++i) {
+		if (builtins[i].stage != parser->module->stage) {
+			continue;
+		}
+		const se_soft_glsl_type type = se_soft_glsl_make_type(builtins[i].base, builtins[i].rows, 1u);
+		const u32 variable = se_soft_glsl_declare(parser, builtins[i].name, &type, SE_SOFT_GLSL_QUALIFIER_BUILTIN, SE_SOFT_GLSL_LOCAL, true);
+		if (variable != SE_SOFT_GLSL_MISSING) {
+			parser->module->builtin_vars[builtins[i].variable] = variable + 1u;
+		}
+	}
+}
+
+// Modules
+
+static void se_soft_glsl_module_free(se_soft_glsl_module* module) {
+	free(module->nodes);
+	free(module->lists);
+	free(module->variables);
+	free(module->functions);
+	free(module->structs);
+	free(module->fields);
+	free(module->shared);
+	memset(module, 0, sizeof(*module));
+}
+
+static b8 se_soft_glsl_compile(se_soft_glsl_module* module, const se_soft_glsl_stage stage, const c8* source, c8* log, const sz log_size) {
+	memset(module, 0, sizeof(*module));
+	module->stage = stage;
+	if (log && log_size > 0u) {
+		log[0] = '\0';
+	}
+	se_soft_glsl_tokens raw = {0};
+	se_soft_glsl_tokens tokens = {0};
+	b8 ok = source != NULL && se_soft_glsl_lex(source, &raw, log, log_size) && se_soft_glsl_preprocess(&raw, &tokens, log, log_size);
+	free(raw.items);
+	if (!ok) {
+		free(tokens.items);
+		return false;
+	}
+	se_soft_glsl_parser parser = {0};
+	parser.module = module;
+	parser.tokens = tokens.items;
+	parser.token_count = tokens.count;
+	parser.log = log;
+	parser.log_size = log_size;
+	// Node 0 is the NOP that SE_SOFT_GLSL_NONE refers to.
+	se_soft_glsl_add_node(&parser, SE_SOFT_GLSL_OP_NOP, NULL, false);
+	se_soft_glsl_push_scope(&parser);
+	se_soft_glsl_declare_builtins(&parser);
+	while (!parser.failed && se_soft_glsl_peek(&parser)->kind != SE_SOFT_GLSL_TOKEN_EOF) {
+		se_soft_glsl_parse_global(&parser);
+	}
+	if (!parser.failed && (module->main_function == SE_SOFT_GLSL_NONE || !module->functions[module->main_function - 1u].defined)) {
+		se_soft_glsl_error(&parser, "missing main function");
+	}
+	for (u32 i = 0u; i < module->node_count && !parser.failed; ++i) {
+		if (module->nodes[i].op == SE_SOFT_GLSL_OP_CALL && !module->functions[module->nodes[i].aux].defined) {
+			se_soft_glsl_error(&parser, "'%s': function has no body", module->functions[module->nodes[i].aux].name);
+		}
+	}
+	if (!parser.failed) {
+		const u32 count = parser.pending_count;
+		module->global_init = se_soft_glsl_make_statement(&parser, SE_SOFT_GLSL_OP_BLOCK, se_soft_glsl_commit_list(&parser, 0u, count), count, 0u, 0u);
+	}
+	ok = !parser.failed;
+	free(parser.scope);
+	free(parser.pending);
+	free(parser.fold_memory);
+	free(tokens.items);
+	if (!ok) {
+		se_soft_glsl_module_free(module);
+	}
+	return ok;
+}
+
+// Programs
+
+#define SE_SOFT_GLSL_UNIFORM_NAME_MAX 128u
+
+typedef struct {
+	c8 name[SE_SOFT_GLSL_UNIFORM_NAME_MAX];
+	// Slot in each stage's shared values, or -1 when that stage does not declare it.
+	i32 offsets[SE_SOFT_GLSL_STAGE_COUNT];
+	se_soft_glsl_type type;
+	// Array elements from this one to the end, for glUniform calls with count > 1.
+	u32 remaining;
+} se_soft_glsl_uniform;
+
+typedef struct {
+	u32 variable;
+	u32 location;
+	u32 locations;
+} se_soft_glsl_input;
+
+typedef struct {
+	u32 vertex_offset;
+	u32 fragment_offset;
+	u32 slots;
+	u32 target;
+	u8 base;
+} se_soft_glsl_varying;
+
+struct se_soft_glsl_program {
+	se_soft_glsl_module modules[SE_SOFT_GLSL_STAGE_COUNT];
+	se_soft_glsl_uniform* uniforms;
+	u32 uniform_count;
+	u32 uniform_capacity;
+	se_soft_glsl_input inputs[SE_SOFT_GLSL_MAX_ATTRIBUTES];
+	u32 input_count;
+	u32 attribute_mask;
+	se_soft_glsl_varying varyings[SE_SOFT_RASTER_MAX_VARYINGS];
+	u32 varying_count;
+	u32 varying_floats;
+	u64 flat_varyings;
+	// Fragment output variable + 1.
+	u32 output;
+	u32 scratch_bytes;
+};
+
+static void se_soft_glsl_link_error(c8* log, const sz log_size, const c8* format, ...) {
+	if (!log || log_size == 0u) {
+		return;
+	}
+	const int prefix = snprintf(log, log_size, "link error: ");
+	if (prefix < 0 || (sz)prefix >= log_size) {
+		return;
+	}
+	va_list args;
+	va_start(args, format);
+	vsnprintf(log + prefix, log_size - (sz)prefix, format, args);
+	va_end(args);
+}
+
+static b8 se_soft_glsl_add_uniform(se_soft_glsl_program* program, const u32 stage, const c8* name, const se_soft_glsl_type* type, const u32 offset, const u32 remaining, c8* log, const sz log_size) {
+	for (u32 i = 0u; i < program->uniform_count; ++i) {
+		se_soft_glsl_uniform* uniform = &program->uniforms[i];
+		if (strcmp(uniform->name, name) == 0) {
+			if (!se_soft_glsl_type_equal(&uniform->type, type) || uniform->remaining != remaining) {
+				se_soft_glsl_link_error(log, log_size, "uniform '%s' differs between shader stages", name);
+				return false;
+			}
+			uniform->offsets[stage] = (i32)offset;
+			return true;
+		}
+	}
+	if (!se_soft_glsl_grow((void**)&program->uniforms, &program->uniform_capacity, program->uniform_count + 1u, sizeof(*program->uniforms))) {
+		se_soft_glsl_link_error(log, log_size, "out of memory");
+		return false;
+	}
+	se_soft_glsl_uniform* uniform = &program->uniforms[program->uniform_count++];
+	memset(uniform, 0, sizeof(*uniform));
+	snprintf(uniform->name, sizeof(uniform->name), "%s", name);
+	for (u32 s = 0u; s < SE_SOFT_GLSL_STAGE_COUNT; ++s) {
+		uniform->offsets[s] = -1;
+	}
+	uniform->offsets[stage] = (i32)offset;
+	uniform->type = *type;
+	uniform->remaining = remaining;
+	return true;
+}
+
+// Gives every array element and struct member its own location, as glGetUniformLocation expects.
+static b8 se_soft_glsl_collect_uniform(se_soft_glsl_program* program, const u32 stage, const c8* name, const se_soft_glsl_type* type, const u32 offset, c8* log, const sz log_size) {
+	const se_soft_glsl_module* module = &program->modules[stage];
+	c8 member[SE_SOFT_GLSL_UNIFORM_NAME_MAX];
+	if (type->array > 0u) {
+		se_soft_glsl_type element = *type;
+		element.array = 0u;
+		const u32 slots = se_soft_glsl_type_slots(module, &element);
+		for (u32 i = 0u; i < type->array; ++i) {
+			snprintf(member, sizeof(member), "%s[%u]", name, i);
+			const b8 ok = element.base == SE_SOFT_GLSL_STRUCT ?
+				se_soft_glsl_collect_uniform(program, stage, member, &element, offset + i * slots, log, log_size) :
+				se_soft_glsl_add_uniform(program, stage, member, &element, offset + i * slots, type->array - i, log, log_size);
+			if (!ok) {
+				return false;
+			}
+		}
+		return true;
+	}
+	if (type->base == SE_SOFT_GLSL_STRUCT) {
+		const se_soft_glsl_struct* structure = &module->structs[type->structure];
+		for (u32 i = 0u; i < structure->field_count; ++i) {
+			const se_soft_glsl_field* field = &module->fields[structure->first_field + i];
+			snprintf(member, sizeof(member), "%s.%s", name, field->name);
+			if (!se_soft_glsl_collect_uniform(program, stage, member, &field->type, offset + field->offset, log, log_size)) {
+				return false;
+			}
+		}
+		return true;
+	}
+	return se_soft_glsl_add_uniform(program, stage, name, type, offset, 1u, log, log_size);
+}
+
+static b8 se_soft_glsl_link(se_soft_glsl_program* program, c8* log, const sz log_size) {
+	const se_soft_glsl_module* vertex = &program->modules[SE_SOFT_GLSL_VERTEX];
+	const se_soft_glsl_module* fragment = &program->modules[SE_SOFT_GLSL_FRAGMENT];
+	for (u32 stage = 0u; stage < SE_SOFT_GLSL_STAGE_COUNT; ++stage) {
+		const se_soft_glsl_module* module = &program->modules[stage];
+		for (u32 i = 0u; i < module->variable_count; ++i) {
+			const se_soft_glsl_variable* variable = &module->variables[i];
+			if (variable->qualifier == SE_SOFT_GLSL_QUALIFIER_UNIFORM &&
+				!se_soft_glsl_collect_uniform(program, stage, variable->name, &variable->type, variable->offset, log, log_size)) {
+				return false;
+			}
+		}
+		const u32 slots = module->local_slots > 0u ? module->local_slots : 1u;
+		if (slots * (u32)sizeof(se_soft_glsl_value) > program->scratch_bytes) {
+			program->scratch_bytes = slots * (u32)sizeof(se_soft_glsl_value);
+		}
+	}
+	// Explicit attribute locations first, then the lowest free ones in declaration order.
+	for (u32 pass = 0u; pass < 2u; ++pass) {
+		for (u32 i = 0u; i < vertex->variable_count; ++i) {
+			const se_soft_glsl_variable* variable = &vertex->variables[i];
+			if (variable->qualifier != SE_SOFT_GLSL_QUALIFIER_IN || (variable->location >= 0) != (pass == 0u)) {
+				continue;
+			}
+			const u32 locations = variable->type.cols * (variable->type.array > 0u ? variable->type.array : 1u);
+			u32 location = pass == 0u ? (u32)variable->location : 0u;
+			while (pass == 1u && location < SE_SOFT_GLSL_MAX_ATTRIBUTES && (program->attribute_mask >> location) & ((1u << locations) - 1u)) {
+				++location;
+			}
+			if (location + locations > SE_SOFT_GLSL_MAX_ATTRIBUTES || program->input_count >= SE_SOFT_GLSL_MAX_ATTRIBUTES) {
+				se_soft_glsl_link_error(log, log_size, "too many vertex attributes at '%s'", variable->name);
+				return false;
+			}
+			program->inputs[program->input_count++] = (se_soft_glsl_input){ .variable = i, .location = location, .locations = locations };
+			program->attribute_mask |= ((1u << locations) - 1u) << location;
+		}
+	}
+	for (u32 i = 0u; i < fragment->variable_count; ++i) {
+		const se_soft_glsl_variable* input = &fragment->variables[i];
+		if (input->qualifier == SE_SOFT_GLSL_QUALIFIER_OUT && (program->output == 0u || input->location == 0)) {
+			program->output = i + 1u;
+		}
+		if (input->qualifier != SE_SOFT_GLSL_QUALIFIER_IN) {
+			continue;
+		}
+		const se_soft_glsl_variable* output = NULL;
+		for (u32 j = 0u; j < vertex->variable_count && !output; ++j) {
+			if (vertex->variables[j].qualifier == SE_SOFT_GLSL_QUALIFIER_OUT && strcmp(vertex->variables[j].name, input->name) == 0) {
+				output = &vertex->variables[j];
+			}
+		}
+		if (!output || !se_soft_glsl_type_equal(&output->type, &input->type)) {
+			se_soft_glsl_link_error(log, log_size, "fragment input '%s' has no matching vertex output", input->name);
+			return false;
+		}
+		const u32 slots = se_soft_glsl_type_slots(fragment, &input->type);
+		if (program->varying_floats + slots > SE_SOFT_RASTER_MAX_VARYINGS) {
+			se_soft_glsl_link_error(log, log_size, "too many varying components at '%s'", input->name);
+			return false;
+		}
+		program->varyings[program->varying_count++] = (se_soft_glsl_varying){
+			.vertex_offset = output->offset,
+			.fragment_offset = input->offset,
+			.slots = slots,
+			.target = program->varying_floats,
+			.base = input->type.base
+		};
+		if (input->flat || output->flat) {
+			program->flat_varyings |= (slots >= 64u ? ~0ull : ((1ull << slots) - 1ull)) << program->varying_floats;
+		}
+		program->varying_floats += slots;
+	}
+	return true;
+}
+
+b8 se_soft_glsl_check(const se_soft_glsl_stage stage, const c8* source, c8* log, const sz log_size) {
+	se_soft_glsl_module module;
+	if (!se_soft_glsl_compile(&module, stage, source, log, log_size)) {
+		return false;
+	}
+	se_soft_glsl_module_free(&module);
+	return true;
+}
+
+se_soft_glsl_program* se_soft_glsl_program_create(const c8* vertex_source, const c8* fragment_source, c8* log, const sz log_size) {
+	se_soft_glsl_program* program = calloc(1u, sizeof(*program));
+	if (!program) {
+		se_soft_glsl_link_error(log, log_size, "out of memory");
+		return NULL;
+	}
+	if (!se_soft_glsl_compile(&program->modules[SE_SOFT_GLSL_VERTEX], SE_SOFT_GLSL_VERTEX, vertex_source, log, log_size) ||
+		!se_soft_glsl_compile(&program->modules[SE_SOFT_GLSL_FRAGMENT], SE_SOFT_GLSL_FRAGMENT, fragment_source, log, log_size) ||
+		!se_soft_glsl_link(program, log, log_size)) {
+		se_soft_glsl_program_destroy(program);
+		return NULL;
+	}
+	return program;
+}
+
+void se_soft_glsl_program_destroy(se_soft_glsl_program* program) {
+	if (!program) {
+		return;
+	}
+	for (u32 stage = 0u; stage < SE_SOFT_GLSL_STAGE_COUNT; ++stage) {
+		se_soft_glsl_module_free(&program->modules[stage]);
+	}
+	free(program->uniforms);
+	free(program);
+}
+
+i32 se_soft_glsl_program_uniform_location(const se_soft_glsl_program* program, const c8* name) {
+	if (!program || !name) {
+		return -1;
+	}
+	for (u32 i = 0u; i < program->uniform_count; ++i) {
+		if (strcmp(program->uniforms[i].name, name) == 0) {
+			return (i32)i;
+		}
+	}
+	const sz length = strlen(name);
+	if (length == 0u || name[length - 1u] == ']' || length + 4u > SE_SOFT_GLSL_UNIFORM_NAME_MAX) {
+		return -1;
+	}
+	c8 first[SE_SOFT_GLSL_UNIFORM_NAME_MAX];
+	snprintf(first, sizeof(first), "%s[0]", name);
+	for (u32 i = 0u; i < program->uniform_count; ++i) {
+		if (strcmp(program->uniforms[i].name, first) == 0) {
+			return (i32)i;
+		}
+	}
+	return -1;
+}
+
+b8 se_soft_glsl_program_set_uniform(se_soft_glsl_program* program, const i32 location, const f32* floats, const i32* ints, const u32 components, u32 count, const b8 transpose) {
+	if (location == -1) {
+		return true;
+	}
+	if (!program || location < 0 || (u32)location >= program->uniform_count || (!floats && !ints)) {
+		return false;
+	}
+	const se_soft_glsl_uniform* uniform = &program->uniforms[location];
+	const se_soft_glsl_type* type = &uniform->type;
+	if (components != se_soft_glsl_components(type)) {
+		return false;
+	}
+	if (count > uniform->remaining) {
+		count = uniform->remaining;
+	}
+	for (u32 stage = 0u; stage < SE_SOFT_GLSL_STAGE_COUNT; ++stage) {
+		if (uniform->offsets[stage] < 0) {
+			continue;
+		}
+		se_soft_glsl_value* out = program->modules[stage].shared + uniform->offsets[stage];
+		for (u32 e = 0u; e < count; ++e) {
+			for (u32 k = 0u; k < components; ++k) {
+				// Storage is column-major; a transposed upload arrives row by row.
+				const u32 source = e * components + (transpose ? (k % type->rows) * type->cols + k / type->rows : k);
+				se_soft_glsl_value* value = &out[e * components + k];
+				if (type->base == SE_SOFT_GLSL_FLOAT) {
+					value->f = floats ? floats[source] : (f32)ints[source];
+				} else if (type->base == SE_SOFT_GLSL_BOOL) {
+					value->i = floats ? floats[source] != 0.0f : ints[source] != 0;
+				} else {
+					value->i = floats ? (i32)floats[source] : ints[source];
+				}
+			}
+		}
+	}
+	return true;
+}
+
+u32 se_soft_glsl_program_uniform_bytes(const se_soft_glsl_program* program) {
+	if (!program) {
+		return 0u;
+	}
+	return (program->modules[SE_SOFT_GLSL_VERTEX].shared_count + program->modules[SE_SOFT_GLSL_FRAGMENT].shared_count) * (u32)sizeof(se_soft_glsl_value);
+}
+
+void se_soft_glsl_program_copy_uniforms(const se_soft_glsl_program* program, void* out_uniforms) {
+	if (!program || !out_uniforms) {
+		return;
+	}
+	const se_soft_glsl_module* vertex = &program->modules[SE_SOFT_GLSL_VERTEX];
+	const se_soft_glsl_module* fragment = &program->modules[SE_SOFT_GLSL_FRAGMENT];
+	se_soft_glsl_value* out = out_uniforms;
+	if (vertex->shared_count > 0u) {
+		memcpy(out, vertex->shared, sizeof(*out) * vertex->shared_count);
+	}
+	if (fragment->shared_count > 0u) {
+		memcpy(out + vertex->shared_count, fragment->shared, sizeof(*out) * fragment->shared_count);
+	}
+}
+
+u32 se_soft_glsl_program_attribute_mask(const se_soft_glsl_program* program) {
+	return program ? program->attribute_mask : 0u;
+}
+
+u32 se_soft_glsl_program_varying_count(const se_soft_glsl_program* program) {
+	return program ? program->varying_floats : 0u;
+}
+
+u64 se_soft_glsl_program_flat_varyings(const se_soft_glsl_program* program) {
+	return program ? program->flat_varyings : 0u;
+}
+
+b8 se_soft_glsl_program_writes_depth(const se_soft_glsl_program* program) {
+	return program ? program->modules[SE_SOFT_GLSL_FRAGMENT].writes_depth : false;
+}
+
+u32 se_soft_glsl_program_scratch_bytes(const se_soft_glsl_program* program) {
+	return program ? program->scratch_bytes : 0u;
+}
+
+static se_soft_glsl_value* se_soft_glsl_builtin_slot(const se_soft_glsl_module* module, se_soft_glsl_value* memory, const se_soft_glsl_builtin_var variable) {
+	const u32 index = module->builtin_vars[variable];
+	return index != 0u ? memory + module->variables[index - 1u].offset : NULL;
+}
+
+static void se_soft_glsl_run_main(se_soft_glsl_exec* exec) {
+	const se_soft_glsl_module* module = exec->module;
+	se_soft_glsl_exec_statement(exec, module->global_init);
+	if (!exec->discarded) {
+		se_soft_glsl_exec_statement(exec, module->functions[module->main_function - 1u].body);
+	}
+}
+
+void se_soft_glsl_run_vertex(const se_soft_glsl_draw* draw, void* scratch, const f32 attributes[SE_SOFT_GLSL_MAX_ATTRIBUTES][4], const i32 vertex_id, const i32 instance_id, f32* out_vertex) {
+	const se_soft_glsl_program* program = draw->program;
+	const se_soft_glsl_module* module = &program->modules[SE_SOFT_GLSL_VERTEX];
+	se_soft_glsl_value* memory = scratch;
+	for (u32 i = 0u; i < program->input_count; ++i) {
+		const se_soft_glsl_input* input = &program->inputs[i];
+		const se_soft_glsl_variable* variable = &module->variables[input->variable];
+		for (u32 l = 0u; l < input->locations; ++l) {
+			for (u32 r = 0u; r < variable->type.rows; ++r) {
+				se_soft_glsl_value* value = &memory[variable->offset + l * variable->type.rows + r];
+				const f32 source = attributes[input->location + l][r];
+				if (variable->type.base == SE_SOFT_GLSL_FLOAT) {
+					value->f = source;
+				} else {
+					value->i = (i32)source;
+				}
+			}
+		}
+	}
+	for (u32 i = 0u; i < program->varying_count; ++i) {
+		memset(memory + program->varyings[i].vertex_offset, 0, sizeof(*memory) * program->varyings[i].slots);
+	}
+	se_soft_glsl_value* position = se_soft_glsl_builtin_slot(module, memory, SE_SOFT_GLSL_BUILTIN_VAR_POSITION);
+	memset(position, 0, sizeof(*position) * 4u);
+	se_soft_glsl_builtin_slot(module, memory, SE_SOFT_GLSL_BUILTIN_VAR_VERTEX_ID)->i = vertex_id;
+	se_soft_glsl_builtin_slot(module, memory, SE_SOFT_GLSL_BUILTIN_VAR_INSTANCE_ID)->i = instance_id;
+	se_soft_glsl_exec exec = { .module = module, .memory = memory, .shared = draw->uniforms, .draw = draw };
+	se_soft_glsl_run_main(&exec);
+	for (u32 c = 0u; c < 4u; ++c) {
+		out_vertex[c] = position[c].f;
+	}
+	for (u32 i = 0u; i < program->varying_count; ++i) {
+		const se_soft_glsl_varying* varying = &program->varyings[i];
+		for (u32 k = 0u; k < varying->slots; ++k) {
+			const se_soft_glsl_value value = memory[varying->vertex_offset + k];
+			out_vertex[4u + varying->target + k] = varying->base == SE_SOFT_GLSL_FLOAT ? value.f : (f32)value.i;
+		}
+	}
+}
+
+b8 se_soft_glsl_run_fragment(const void* shader, void* scratch, const se_soft_fragment* fragment, f32 out_color[4], f32* inout_depth) {
+	const se_soft_glsl_draw* draw = shader;
+	const se_soft_glsl_program* program = draw->program;
+	const se_soft_glsl_module* module = &program->modules[SE_SOFT_GLSL_FRAGMENT];
+	se_soft_glsl_value* memory = scratch;
+	for (u32 i = 0u; i < program->varying_count; ++i) {
+		const se_soft_glsl_varying* varying = &program->varyings[i];
+		for (u32 k = 0u; k < varying->slots; ++k) {
+			const f32 source = fragment->varyings[varying->target + k];
+			if (varying->base == SE_SOFT_GLSL_FLOAT) {
+				memory[varying->fragment_offset + k].f = source;
+			} else {
+				memory[varying->fragment_offset + k].i = (i32)lrintf(source);
+			}
+		}
+	}
+	if (program->output != 0u) {
+		const se_soft_glsl_variable* output = &module->variables[program->output - 1u];
+		memset(memory + output->offset, 0, sizeof(*memory) * se_soft_glsl_type_slots(module, &output->type));
+	}
+	se_soft_glsl_value* frag_coord = se_soft_glsl_builtin_slot(module, memory, SE_SOFT_GLSL_BUILTIN_VAR_FRAG_COORD);
+	for (u32 c = 0u; c < 4u; ++c) {
+		frag_coord[c].f = fragment->frag_coord[c];
+	}
+	se_soft_glsl_builtin_slot(module, memory, SE_SOFT_GLSL_BUILTIN_VAR_FRONT_FACING)->i = fragment->front_facing;
+	se_soft_glsl_value* frag_depth = se_soft_glsl_builtin_slot(module, memory, SE_SOFT_GLSL_BUILTIN_VAR_FRAG_DEPTH);
+	frag_depth->f = *inout_depth;
+	se_soft_glsl_value* point_coord = se_soft_glsl_builtin_slot(module, memory, SE_SOFT_GLSL_BUILTIN_VAR_POINT_COORD);
+	point_coord[0].f = 0.0f;
+	point_coord[1].f = 0.0f;
+	se_soft_glsl_exec exec = {
+		.module = module,
+		.memory = memory,
+		.shared = (const se_soft_glsl_value*)draw->uniforms + program->modules[SE_SOFT_GLSL_VERTEX].shared_count,
+		.draw = draw
+	};
+	se_soft_glsl_run_main(&exec);
+	if (exec.discarded) {
+		return false;
+	}
+	out_color[0] = 0.0f;
+	out_color[1] = 0.0f;
+	out_color[2] = 0.0f;
+	out_color[3] = 1.0f;
+	if (program->output != 0u) {
+		const se_soft_glsl_variable* output = &module->variables[program->output - 1u];
+		for (u32 c = 0u; c < output->type.rows && c < 4u; ++c) {
+			const se_soft_glsl_value value = memory[output->offset + c];
+			out_color[c] = output->type.base == SE_SOFT_GLSL_FLOAT ? value.f : (f32)value.i;
+		}
+	}
+	if (module->writes_depth) {
+		*inout_depth = frag_depth->f;
+	}
+	return true;
+}
@@ -0,0 +1,63 @@
+// Syphax-Engine - Ougi Washi
+
+#ifndef SE_SOFT_GLSL_H
+#define SE_SOFT_GLSL_H
+
+#include "render/se_soft_raster.h"
+
+#define SE_SOFT_GLSL_MAX_ATTRIBUTES 16u
+#define SE_SOFT_GLSL_MAX_TEXTURE_UNITS 16u
+
+// Interpreter for the GLSL 3.30 / ES 3.00 subset the engine's shaders use: scalar, vector and
+// matrix types, structs, arrays, user functions with in/out/inout parameters, the usual control
+// flow, the common built-in functions and 2D/3D samplers. Derivatives evaluate to zero.
+typedef struct se_soft_glsl_program se_soft_glsl_program;
+
+typedef enum {
+	SE_SOFT_GLSL_VERTEX = 0,
+	SE_SOFT_GLSL_FRAGMENT,
+	SE_SOFT_GLSL_STAGE_COUNT
+} se_soft_glsl_stage;
+
+typedef enum {
+	SE_SOFT_GLSL_SAMPLER_2D = 0,
+	SE_SOFT_GLSL_SAMPLER_3D,
+	SE_SOFT_GLSL_SAMPLER_KIND_COUNT
+} se_soft_glsl_sampler_kind;
+
+// Everything one draw reads: the program, a snapshot of its uniforms taken with
+// se_soft_glsl_program_copy_uniforms, and the texture bound to each unit.
+typedef struct {
+	const se_soft_glsl_program* program;
+	const void* uniforms;
+	se_soft_sampler samplers[SE_SOFT_GLSL_MAX_TEXTURE_UNITS][SE_SOFT_GLSL_SAMPLER_KIND_COUNT];
+} se_soft_glsl_draw;
+
+// Compiles one stage to report errors, as glCompileShader does; `log` may be NULL.
+extern b8 se_soft_glsl_check(se_soft_glsl_stage stage, const c8* source, c8* log, sz log_size);
+extern se_soft_glsl_program* se_soft_glsl_program_create(const c8* vertex_source, const c8* fragment_source, c8* log, sz log_size);
+extern void se_soft_glsl_program_destroy(se_soft_glsl_program* program);
+
+// Locations follow glGetUniformLocation: arrays answer to "name" and "name[i]", struct members to "name.field".
+extern i32 se_soft_glsl_program_uniform_location(const se_soft_glsl_program* program, const c8* name);
+// Sets `count` array elements of `components` values each from `floats` or `ints`, converting
+// between float, int and bool as glUniform does. Location -1 is ignored.
+extern b8 se_soft_glsl_program_set_uniform(se_soft_glsl_program* program, i32 location, const f32* floats, const i32* ints, u32 components, u32 count, b8 transpose);
+extern u32 se_soft_glsl_program_uniform_bytes(const se_soft_glsl_program* program);
+extern void se_soft_glsl_program_copy_uniforms(const se_soft_glsl_program* program, void* out_uniforms);
+
+// Bit i is set when the vertex stage reads attribute location i.
+extern u32 se_soft_glsl_program_attribute_mask(const se_soft_glsl_program* program);
+extern u32 se_soft_glsl_program_varying_count(const se_soft_glsl_program* program);
+extern u64 se_soft_glsl_program_flat_varyings(const se_soft_glsl_program* program);
+extern b8 se_soft_glsl_program_writes_depth(const se_soft_glsl_program* program);
+// Per-invocation memory either stage needs; each concurrent invocation needs its own.
+extern u32 se_soft_glsl_program_scratch_bytes(const se_soft_glsl_program* program);
+
+// Runs the vertex stage for one vertex. `attributes` holds one vec4 per attribute location;
+// `out_vertex` receives the clip-space position followed by the varyings.
+extern void se_soft_glsl_run_vertex(const se_soft_glsl_draw* draw, void* scratch, const f32 attributes[SE_SOFT_GLSL_MAX_ATTRIBUTES][4], i32 vertex_id, i32 instance_id, f32* out_vertex);
+// se_soft_fragment_fn over a se_soft_glsl_draw.
+extern b8 se_soft_glsl_run_fragment(const void* draw, void* scratch, const se_soft_fragment* fragment, f32 out_color[4], f32* inout_depth);
+
+#endif // SE_SOFT_GLSL_H
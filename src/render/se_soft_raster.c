@@ -0,0 +1,918 @@
+// Syphax-Engine - Ougi Washi
+
+#include "render/se_soft_raster.h"
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define SE_SOFT_RASTER_VERTEX_FLOATS (4u + SE_SOFT_RASTER_MAX_VARYINGS)
+#define SE_SOFT_RASTER_CLIP_PLANES 6u
+#define SE_SOFT_RASTER_CLIP_MAX_VERTICES (3u + SE_SOFT_RASTER_CLIP_PLANES)
+#define SE_SOFT_RASTER_NEAR_W 0.00001f
+// Triangles are clipped to a band this many times the view volume so that edge functions are
+// evaluated on bounded coordinates; everything inside the band is trimmed by the viewport.
+#define SE_SOFT_RASTER_GUARD_BAND 4.0f
+// Minimum resolvable depth difference, used as the unit of glPolygonOffset.
+#define SE_SOFT_RASTER_DEPTH_UNIT (1.0f / 16777216.0f)
+#define SE_SOFT_RASTER_MAX_IMAGE_TEXELS (1u << 28)
+
+// Edge k is opposite vertex k; E(x, y) = a * x + b * y + c is positive inside.
+typedef struct {
+	f64 edge[3][3];
+	f64 inv_area;
+	f32 z[3];
+	f32 inv_w[3];
+	f32 z_offset;
+	u32 varyings;
+	u32 state;
+	u32 min_x;
+	u32 min_y;
+	u32 max_x;
+	u32 max_y;
+	b8 front;
+	b8 top_left[3];
+} se_soft_raster_triangle;
+
+typedef struct {
+	u32* items;
+	u32 count;
+	u32 capacity;
+	u64 fragments_shaded;
+	u64 fragments_written;
+} se_soft_raster_tile;
+
+struct se_soft_raster {
+	u32 tile_size;
+	se_worker_pool* workers;
+	se_soft_image* color;
+	se_soft_image* depth;
+	u32 width;
+	u32 height;
+	u32 tiles_x;
+	u32 tiles_y;
+	se_soft_raster_tile* tiles;
+	u32 tile_capacity;
+	u32* active_tiles;
+	u32 active_tile_count;
+	se_soft_raster_triangle* triangles;
+	u32 triangle_count;
+	u32 triangle_capacity;
+	se_soft_state* states;
+	u32 state_count;
+	u32 state_capacity;
+	f32* varyings;
+	u32 varying_count;
+	u32 varying_capacity;
+	u32 scratch_bytes;
+	se_soft_raster_stats stats;
+};
+
+// NaN clamps to 0 so shader arithmetic errors cannot reach the float to u8 conversion.
+static f32 se_soft_raster_clamp01(const f32 value) {
+	return value > 0.0f ? (value < 1.0f ? value : 1.0f) : 0.0f;
+}
+
+static u8 se_soft_raster_unorm8(const f32 value) {
+	return (u8)(se_soft_raster_clamp01(value) * 255.0f + 0.5f);
+}
+
+u32 se_soft_format_texel_bytes(const se_soft_format format) {
+	switch (format) {
+		case SE_SOFT_FORMAT_R8: return 1u;
+		case SE_SOFT_FORMAT_RG8: return 2u;
+		case SE_SOFT_FORMAT_RGBA8: return 4u;
+		case SE_SOFT_FORMAT_R32F: return 4u;
+		case SE_SOFT_FORMAT_RGBA32F: return 16u;
+		case SE_SOFT_FORMAT_DEPTH32F: return 4u;
+		default: return 0u;
+	}
+}
+
+b8 se_soft_image_alloc(se_soft_image* image, const u32 width, const u32 height, const u32 depth, const se_soft_format format) {
+	const u32 texel_bytes = se_soft_format_texel_bytes(format);
+	if (!image || texel_bytes == 0u || width == 0u || height == 0u || depth == 0u ||
+		(u64)width * height * depth > SE_SOFT_RASTER_MAX_IMAGE_TEXELS) {
+		se_set_last_error(SE_RESULT_INVALID_ARGUMENT);
+		return false;
+	}
+	u8* texels = (u8*)calloc((sz)width * height * depth, texel_bytes);
+	if (!texels) {
+		se_set_last_error(SE_RESULT_OUT_OF_MEMORY);
+		return false;
+	}
+	free(image->texels);
+	image->width = width;
+	image->height = height;
+	image->depth = depth;
+	image->format = format;
+	image->texels = texels;
+	se_set_last_error(SE_RESULT_OK);
+	return true;
+}
+
+void se_soft_image_free(se_soft_image* image) {
+	if (!image) {
+		return;
+	}
+	free(image->texels);
+	memset(image, 0, sizeof(*image));
+}
+
+void se_soft_image_load(const se_soft_image* image, const u32 x, const u32 y, const u32 z, f32 out_value[4]) {
+	out_value[0] = 0.0f;
+	out_value[1] = 0.0f;
+	out_value[2] = 0.0f;
+	out_value[3] = 1.0f;
+	if (!image || !image->texels || x >= image->width || y >= image->height || z >= image->depth) {
+		return;
+	}
+	const sz index = ((sz)z * image->height + y) * image->width + x;
+	const f32 unorm = 1.0f / 255.0f;
+	switch (image->format) {
+		case SE_SOFT_FORMAT_R8:
+			out_value[0] = (f32)image->texels[index] * unorm;
+			break;
+		case SE_SOFT_FORMAT_RG8:
+			out_value[0] = (f32)image->texels[index * 2u] * unorm;
+			out_value[1] = (f32)image->texels[index * 2u + 1u] * unorm;
+			break;
+		case SE_SOFT_FORMAT_RGBA8: {
+			const u8* texel = image->texels + index * 4u;
+			for (u32 i = 0u; i < 4u; ++i) {
+				out_value[i] = (f32)texel[i] * unorm;
+			}
+			break;
+		}
+		case SE_SOFT_FORMAT_R32F:
+		case SE_SOFT_FORMAT_DEPTH32F:
+			memcpy(out_value, image->texels + index * 4u, sizeof(f32));
+			break;
+		case SE_SOFT_FORMAT_RGBA32F:
+			memcpy(out_value, image->texels + index * 16u, sizeof(f32) * 4u);
+			break;
+		default:
+			break;
+	}
+}
+
+void se_soft_image_store(se_soft_image* image, const u32 x, const u32 y, const u32 z, const f32 value[4]) {
+	if (!image || !image->texels || x >= image->width || y >= image->height || z >= image->depth) {
+		return;
+	}
+	const sz index = ((sz)z * image->height + y) * image->width + x;
+	switch (image->format) {
+		case SE_SOFT_FORMAT_R8:
+			image->texels[index] = se_soft_raster_unorm8(value[0]);
+			break;
+		case SE_SOFT_FORMAT_RG8:
+			image->texels[index * 2u] = se_soft_raster_unorm8(value[0]);
+			image->texels[index * 2u + 1u] = se_soft_raster_unorm8(value[1]);
+			break;
+		case SE_SOFT_FORMAT_RGBA8: {
+			u8* texel = image->texels + index * 4u;
+			for (u32 i = 0u; i < 4u; ++i) {
+				texel[i] = se_soft_raster_unorm8(value[i]);
+			}
+			break;
+		}
+		case SE_SOFT_FORMAT_R32F:
+			memcpy(image->texels + index * 4u, value, sizeof(f32));
+			break;
+		case SE_SOFT_FORMAT_DEPTH32F: {
+			const f32 depth = se_soft_raster_clamp01(value[0]);
+			memcpy(image->texels + index * 4u, &depth, sizeof(f32));
+			break;
+		}
+		case SE_SOFT_FORMAT_RGBA32F:
+			memcpy(image->texels + index * 16u, value, sizeof(f32) * 4u);
+			break;
+		default:
+			break;
+	}
+}
+
+static i32 se_soft_wrap_coord(const i32 coord, const i32 size, const se_soft_wrap wrap) {
+	switch (wrap) {
+		case SE_SOFT_WRAP_REPEAT: {
+			const i32 wrapped = coord % size;
+			return wrapped < 0 ? wrapped + size : wrapped;
+		}
+		case SE_SOFT_WRAP_MIRROR: {
+			const i32 period = size * 2;
+			i32 wrapped = coord % period;
+			if (wrapped < 0) {
+				wrapped += period;
+			}
+			return wrapped < size ? wrapped : period - 1 - wrapped;
+		}
+		default:
+			return coord < 0 ? 0 : (coord >= size ? size - 1 : coord);
+	}
+}
+
+// Keeps NaN and huge coordinates away from the float to int conversions.
+static f32 se_soft_sample_position(const f32 coord, const u32 size) {
+	if (!isfinite(coord)) {
+		return 0.0f;
+	}
+	const f32 position = coord * (f32)size;
+	return position < -1048576.0f ? -1048576.0f : (position > 1048576.0f ? 1048576.0f : position);
+}
+
+void se_soft_sample(const se_soft_sampler* sampler, const f32* coords, const u32 coord_count, f32 out_color[4]) {
+	const se_soft_image* image = sampler ? sampler->image : NULL;
+	if (!image || !image->texels || !coords) {
+		out_color[0] = 0.0f;
+		out_color[1] = 0.0f;
+		out_color[2] = 0.0f;
+		out_color[3] = 1.0f;
+		return;
+	}
+	const u32 axes = coord_count >= 3u ? 3u : 2u;
+	const u32 size[3] = {image->width, image->height, image->depth};
+	i32 lo[3] = {0, 0, 0};
+	i32 hi[3] = {0, 0, 0};
+	f32 t[3] = {0.0f, 0.0f, 0.0f};
+	for (u32 axis = 0u; axis < axes; ++axis) {
+		const f32 position = se_soft_sample_position(coords[axis], size[axis]);
+		if (!sampler->linear) {
+			lo[axis] = se_soft_wrap_coord((i32)floorf(position), (i32)size[axis], sampler->wrap[axis]);
+			continue;
+		}
+		const f32 centered = position - 0.5f;
+		const f32 base = floorf(centered);
+		t[axis] = centered - base;
+		lo[axis] = se_soft_wrap_coord((i32)base, (i32)size[axis], sampler->wrap[axis]);
+		hi[axis] = se_soft_wrap_coord((i32)base + 1, (i32)size[axis], sampler->wrap[axis]);
+	}
+	if (!sampler->linear) {
+		se_soft_image_load(image, (u32)lo[0], (u32)lo[1], (u32)lo[2], out_color);
+		return;
+	}
+	const u32 corners = axes == 3u ? 8u : 4u;
+	out_color[0] = 0.0f;
+	out_color[1] = 0.0f;
+	out_color[2] = 0.0f;
+	out_color[3] = 0.0f;
+	for (u32 corner = 0u; corner < corners; ++corner) {
+		f32 weight = 1.0f;
+		u32 texel[3] = {0u, 0u, 0u};
+		for (u32 axis = 0u; axis < axes; ++axis) {
+			const b8 upper = (corner >> axis) & 1u;
+			texel[axis] = (u32)(upper ? hi[axis] : lo[axis]);
+			weight *= upper ? t[axis] : 1.0f - t[axis];
+		}
+		if (weight == 0.0f) {
+			continue;
+		}
+		f32 value[4];
+		se_soft_image_load(image, texel[0], texel[1], texel[2], value);
+		for (u32 i = 0u; i < 4u; ++i) {
+			out_color[i] += value[i] * weight;
+		}
+	}
+}
+
+static b8 se_soft_raster_grow(void** data, u32* capacity, const u32 needed, const sz element_size) {
+	if (needed <= *capacity) {
+		return true;
+	}
+	u32 next = *capacity > 0u ? *capacity : 64u;
+	while (next < needed) {
+		next *= 2u;
+	}
+	void* grown = realloc(*data, element_size * (sz)next);
+	if (!grown) {
+		return false;
+	}
+	*data = grown;
+	*capacity = next;
+	return true;
+}
+
+se_soft_raster* se_soft_raster_create(const se_soft_raster_config* config) {
+	const se_soft_raster_config defaults = SE_SOFT_RASTER_CONFIG_DEFAULTS;
+	const se_soft_raster_config cfg = config ? *config : defaults;
+	if (cfg.tile_size < 8u || cfg.tile_size > 256u) {
+		se_set_last_error(SE_RESULT_INVALID_ARGUMENT);
+		return NULL;
+	}
+	se_soft_raster* raster = (se_soft_raster*)calloc(1u, sizeof(*raster));
+	if (!raster) {
+		se_set_last_error(SE_RESULT_OUT_OF_MEMORY);
+		return NULL;
+	}
+	raster->tile_size = cfg.tile_size;
+	raster->workers = cfg.workers;
+	se_set_last_error(SE_RESULT_OK);
+	return raster;
+}
+
+void se_soft_raster_destroy(se_soft_raster* raster) {
+	if (!raster) {
+		return;
+	}
+	for (u32 i = 0u; i < raster->tile_capacity; ++i) {
+		free(raster->tiles[i].items);
+	}
+	free(raster->tiles);
+	free(raster->active_tiles);
+	free(raster->triangles);
+	free(raster->states);
+	free(raster->varyings);
+	free(raster);
+}
+
+b8 se_soft_raster_set_targets(se_soft_raster* raster, se_soft_image* color, se_soft_image* depth) {
+	if (!raster) {
+		se_set_last_error(SE_RESULT_INVALID_ARGUMENT);
+		return false;
+	}
+	if (color && !color->texels) {
+		color = NULL;
+	}
+	if (depth && !depth->texels) {
+		depth = NULL;
+	}
+	u32 width = 0u;
+	u32 height = 0u;
+	if (color) {
+		width = color->width;
+		height = color->height;
+	}
+	if (depth) {
+		width = width == 0u || depth->width < width ? depth->width : width;
+		height = height == 0u || depth->height < height ? depth->height : height;
+	}
+	if (color == raster->color && depth == raster->depth && width == raster->width && height == raster->height) {
+		se_set_last_error(SE_RESULT_OK);
+		return true;
+	}
+	se_soft_raster_flush(raster);
+
+	const u32 tiles_x = (width + raster->tile_size - 1u) / raster->tile_size;
+	const u32 tiles_y = (height + raster->tile_size - 1u) / raster->tile_size;
+	const u32 tile_count = tiles_x * tiles_y;
+	if (tile_count > raster->tile_capacity) {
+		se_soft_raster_tile* tiles = (se_soft_raster_tile*)realloc(raster->tiles, sizeof(*tiles) * tile_count);
+		if (!tiles) {
+			se_set_last_error(SE_RESULT_OUT_OF_MEMORY);
+			return false;
+		}
+		memset(tiles + raster->tile_capacity, 0, sizeof(*tiles) * (tile_count - raster->tile_capacity));
+		raster->tiles = tiles;
+		u32* active_tiles = (u32*)realloc(raster->active_tiles, sizeof(*active_tiles) * tile_count);
+		if (!active_tiles) {
+			raster->tile_capacity = tile_count;
+			se_set_last_error(SE_RESULT_OUT_OF_MEMORY);
+			return false;
+		}
+		raster->active_tiles = active_tiles;
+		raster->tile_capacity = tile_count;
+	}
+	raster->color = color;
+	raster->depth = depth;
+	raster->width = width;
+	raster->height = height;
+	raster->tiles_x = tiles_x;
+	raster->tiles_y = tiles_y;
+	se_set_last_error(SE_RESULT_OK);
+	return true;
+}
+
+static f32 se_soft_raster_plane_distance(const f32* vertex, const u32 plane) {
+	switch (plane) {
+		case 0u: return vertex[2] + vertex[3];
+		case 1u: return vertex[3] - SE_SOFT_RASTER_NEAR_W;
+		case 2u: return SE_SOFT_RASTER_GUARD_BAND * vertex[3] - vertex[0];
+		case 3u: return SE_SOFT_RASTER_GUARD_BAND * vertex[3] + vertex[0];
+		case 4u: return SE_SOFT_RASTER_GUARD_BAND * vertex[3] - vertex[1];
+		default: return SE_SOFT_RASTER_GUARD_BAND * vertex[3] + vertex[1];
+	}
+}
+
+// Sutherland-Hodgman against one clip plane; vertices are SE_SOFT_RASTER_VERTEX_FLOATS apart.
+static u32 se_soft_raster_clip_plane(const f32* in, const u32 in_count, f32* out, const u32 floats, const u32 plane) {
+	u32 out_count = 0u;
+	for (u32 i = 0u; i < in_count; ++i) {
+		const f32* a = in + i * SE_SOFT_RASTER_VERTEX_FLOATS;
+		const f32* b = in + ((i + 1u) % in_count) * SE_SOFT_RASTER_VERTEX_FLOATS;
+		const f32 da = se_soft_raster_plane_distance(a, plane);
+		const f32 db = se_soft_raster_plane_distance(b, plane);
+		if (da >= 0.0f) {
+			memcpy(out + out_count * SE_SOFT_RASTER_VERTEX_FLOATS, a, sizeof(f32) * floats);
+			out_count++;
+		}
+		if ((da >= 0.0f) != (db >= 0.0f)) {
+			const f32 t = da / (da - db);
+			f32* vertex = out + out_count * SE_SOFT_RASTER_VERTEX_FLOATS;
+			for (u32 k = 0u; k < floats; ++k) {
+				vertex[k] = a[k] + (b[k] - a[k]) * t;
+			}
+			out_count++;
+		}
+	}
+	return out_count;
+}
+
+static b8 se_soft_raster_bin_tile(se_soft_raster* raster, const u32 tile_index, const u32 triangle) {
+	se_soft_raster_tile* tile = &raster->tiles[tile_index];
+	if (!se_soft_raster_grow((void**)&tile->items, &tile->capacity, tile->count + 1u, sizeof(*tile->items))) {
+		return false;
+	}
+	if (tile->count == 0u) {
+		raster->active_tiles[raster->active_tile_count++] = tile_index;
+	}
+	tile->items[tile->count++] = triangle;
+	raster->stats.tile_bins++;
+	return true;
+}
+
+static b8 se_soft_raster_setup_triangle(se_soft_raster* raster, const se_soft_state* state, const u32 state_index, const f32* v0, const f32* v1, const f32* v2) {
+	f32 polygon[SE_SOFT_RASTER_CLIP_MAX_VERTICES * SE_SOFT_RASTER_VERTEX_FLOATS];
+	f32 clipped[SE_SOFT_RASTER_CLIP_MAX_VERTICES * SE_SOFT_RASTER_VERTEX_FLOATS];
+	const u32 varying_count = state->varying_count;
+	const u32 floats = 4u + varying_count;
+	const f32* corners[3] = {v0, v1, v2};
+	for (u32 i = 0u; i < 3u; ++i) {
+		f32* vertex = polygon + i * SE_SOFT_RASTER_VERTEX_FLOATS;
+		memcpy(vertex, corners[i], sizeof(f32) * floats);
+		// The last vertex provokes flat varyings; copying it keeps them exact through clipping.
+		for (u32 k = 0u; state->flat_varyings != 0u && k < varying_count; ++k) {
+			if (state->flat_varyings & (1ull << k)) {
+				vertex[4u + k] = v2[4u + k];
+			}
+		}
+	}
+
+	// Entirely on the outer side of one frustum plane: nothing to draw.
+	for (u32 axis = 0u; axis < 3u; ++axis) {
+		if ((v0[axis] > v0[3] && v1[axis] > v1[3] && v2[axis] > v2[3]) ||
+			(v0[axis] < -v0[3] && v1[axis] < -v1[3] && v2[axis] < -v2[3])) {
+			return true;
+		}
+	}
+
+	u32 count = 3u;
+	f32* current = polygon;
+	f32* spare = clipped;
+	b8 was_clipped = false;
+	for (u32 plane = 0u; plane < SE_SOFT_RASTER_CLIP_PLANES; ++plane) {
+		b8 outside = false;
+		for (u32 i = 0u; i < count; ++i) {
+			if (se_soft_raster_plane_distance(current + i * SE_SOFT_RASTER_VERTEX_FLOATS, plane) < 0.0f) {
+				outside = true;
+				break;
+			}
+		}
+		if (!outside) {
+			continue;
+		}
+		was_clipped = true;
+		count = se_soft_raster_clip_plane(current, count, spare, floats, plane);
+		f32* swap = current;
+		current = spare;
+		spare = swap;
+		if (count < 3u) {
+			raster->stats.triangles_clipped++;
+			return true;
+		}
+	}
+	if (was_clipped) {
+		raster->stats.triangles_clipped++;
+	}
+
+	// Window coordinates; non-flat varyings are pre-divided by w for perspective correction.
+	const f64 viewport_x = (f64)state->viewport[0];
+	const f64 viewport_y = (f64)state->viewport[1];
+	const f64 viewport_w = (f64)state->viewport[2];
+	const f64 viewport_h = (f64)state->viewport[3];
+	f64 screen_x[SE_SOFT_RASTER_CLIP_MAX_VERTICES];
+	f64 screen_y[SE_SOFT_RASTER_CLIP_MAX_VERTICES];
+	f32 screen_z[SE_SOFT_RASTER_CLIP_MAX_VERTICES];
+	f32 screen_inv_w[SE_SOFT_RASTER_CLIP_MAX_VERTICES];
+	for (u32 i = 0u; i < count; ++i) {
+		f32* vertex = current + i * SE_SOFT_RASTER_VERTEX_FLOATS;
+		const f32 inv_w = 1.0f / vertex[3];
+		screen_x[i] = viewport_x + ((f64)vertex[0] * inv_w * 0.5 + 0.5) * viewport_w;
+		screen_y[i] = viewport_y + ((f64)vertex[1] * inv_w * 0.5 + 0.5) * viewport_h;
+		screen_z[i] = vertex[2] * inv_w * 0.5f + 0.5f;
+		screen_inv_w[i] = inv_w;
+		for (u32 k = 0u; k < varying_count; ++k) {
+			if (!(state->flat_varyings & (1ull << k))) {
+				vertex[4u + k] *= inv_w;
+			}
+		}
+	}
+
+	i64 clip_x0 = state->viewport[0] > 0 ? state->viewport[0] : 0;
+	i64 clip_y0 = state->viewport[1] > 0 ? state->viewport[1] : 0;
+	i64 clip_x1 = (i64)state->viewport[0] + state->viewport[2];
+	i64 clip_y1 = (i64)state->viewport[1] + state->viewport[3];
+	clip_x1 = clip_x1 < (i64)raster->width ? clip_x1 : (i64)raster->width;
+	clip_y1 = clip_y1 < (i64)raster->height ? clip_y1 : (i64)raster->height;
+	if (clip_x0 >= clip_x1 || clip_y0 >= clip_y1) {
+		return true;
+	}
+
+	for (u32 i = 1u; i + 1u < count; ++i) {
+		u32 order[3] = {0u, i, i + 1u};
+		f64 area = (screen_x[order[1]] - screen_x[order[0]]) * (screen_y[order[2]] - screen_y[order[0]]) -
+			(screen_y[order[1]] - screen_y[order[0]]) * (screen_x[order[2]] - screen_x[order[0]]);
+		if (area == 0.0 || !isfinite(area)) {
+			continue;
+		}
+		const b8 front = state->front_ccw ? area > 0.0 : area < 0.0;
+		if (state->cull == SE_SOFT_CULL_FRONT_AND_BACK ||
+			(state->cull == SE_SOFT_CULL_BACK && !front) ||
+			(state->cull == SE_SOFT_CULL_FRONT && front)) {
+			raster->stats.triangles_culled++;
+			continue;
+		}
+		if (area < 0.0) {
+			order[1] = i + 1u;
+			order[2] = i;
+			area = -area;
+		}
+		f64 min_xf = screen_x[order[0]];
+		f64 max_xf = min_xf;
+		f64 min_yf = screen_y[order[0]];
+		f64 max_yf = min_yf;
+		for (u32 k = 1u; k < 3u; ++k) {
+			min_xf = fmin(min_xf, screen_x[order[k]]);
+			max_xf = fmax(max_xf, screen_x[order[k]]);
+			min_yf = fmin(min_yf, screen_y[order[k]]);
+			max_yf = fmax(max_yf, screen_y[order[k]]);
+		}
+		i64 min_x = (i64)floor(min_xf);
+		i64 min_y = (i64)floor(min_yf);
+		i64 max_x = (i64)floor(max_xf);
+		i64 max_y = (i64)floor(max_yf);
+		min_x = min_x < clip_x0 ? clip_x0 : min_x;
+		min_y = min_y < clip_y0 ? clip_y0 : min_y;
+		max_x = max_x >= clip_x1 ? clip_x1 - 1 : max_x;
+		max_y = max_y >= clip_y1 ? clip_y1 - 1 : max_y;
+		if (min_x > max_x || min_y > max_y) {
+			continue;
+		}
+
+		if (!se_soft_raster_grow((void**)&raster->triangles, &raster->triangle_capacity, raster->triangle_count + 1u, sizeof(*raster->triangles)) ||
+			!se_soft_raster_grow((void**)&raster->varyings, &raster->varying_capacity, raster->varying_count + varying_count * 3u, sizeof(*raster->varyings))) {
+			return false;
+		}
+		const u32 triangle_index = raster->triangle_count++;
+		se_soft_raster_triangle* triangle = &raster->triangles[triangle_index];
+		for (u32 k = 0u; k < 3u; ++k) {
+			const u32 a = order[(k + 1u) % 3u];
+			const u32 b = order[(k + 2u) % 3u];
+			const f64 edge_a = -(screen_y[b] - screen_y[a]);
+			const f64 edge_b = screen_x[b] - screen_x[a];
+			triangle->edge[k][0] = edge_a;
+			triangle->edge[k][1] = edge_b;
+			triangle->edge[k][2] = -(edge_a * screen_x[a] + edge_b * screen_y[a]);
+			// Top-left fill rule for counter-clockwise edges with y pointing up.
+			triangle->top_left[k] = screen_y[b] < screen_y[a] || (screen_y[b] == screen_y[a] && screen_x[b] < screen_x[a]);
+			triangle->z[k] = screen_z[order[k]];
+			triangle->inv_w[k] = screen_inv_w[order[k]];
+			memcpy(raster->varyings + raster->varying_count + k * varying_count,
+				current + order[k] * SE_SOFT_RASTER_VERTEX_FLOATS + 4u, sizeof(f32) * varying_count);
+		}
+		triangle->inv_area = 1.0 / area;
+		triangle->z_offset = 0.0f;
+		if (state->polygon_offset) {
+			const f64 x1 = screen_x[order[1]] - screen_x[order[0]];
+			const f64 y1 = screen_y[order[1]] - screen_y[order[0]];
+			const f64 x2 = screen_x[order[2]] - screen_x[order[0]];
+			const f64 y2 = screen_y[order[2]] - screen_y[order[0]];
+			const f64 z1 = (f64)triangle->z[1] - triangle->z[0];
+			const f64 z2 = (f64)triangle->z[2] - triangle->z[0];
+			const f64 dzdx = fabs((z1 * y2 - z2 * y1) / area);
+			const f64 dzdy = fabs((z2 * x1 - z1 * x2) / area);
+			triangle->z_offset = (f32)(state->polygon_offset_factor * fmax(dzdx, dzdy)) +
+				state->polygon_offset_units * SE_SOFT_RASTER_DEPTH_UNIT;
+		}
+		triangle->varyings = raster->varying_count;
+		raster->varying_count += varying_count * 3u;
+		triangle->state = state_index;
+		triangle->front = front;
+		triangle->min_x = (u32)min_x;
+		triangle->min_y = (u32)min_y;
+		triangle->max_x = (u32)max_x;
+		triangle->max_y = (u32)max_y;
+		raster->stats.triangles++;
+		for (u32 ty = triangle->min_y / raster->tile_size; ty <= triangle->max_y / raster->tile_size; ++ty) {
+			for (u32 tx = triangle->min_x / raster->tile_size; tx <= triangle->max_x / raster->tile_size; ++tx) {
+				if (!se_soft_raster_bin_tile(raster, ty * raster->tiles_x + tx, triangle_index)) {
+					return false;
+				}
+			}
+		}
+	}
+	return true;
+}
+
+b8 se_soft_raster_draw(se_soft_raster* raster, const se_soft_state* state, const f32* vertices, const u32 vertex_floats, const u32 vertex_count, const u32* indices, const u32 index_count) {
+	if (!raster || !state || !state->fragment || !vertices || state->varying_count > SE_SOFT_RASTER_MAX_VARYINGS ||
+		vertex_floats < 4u + state->varying_count) {
+		se_set_last_error(SE_RESULT_INVALID_ARGUMENT);
+		return false;
+	}
+	if (index_count < 3u || raster->width == 0u || raster->height == 0u ||
+		state->viewport[2] <= 0 || state->viewport[3] <= 0) {
+		se_set_last_error(SE_RESULT_OK);
+		return true;
+	}
+	if (!se_soft_raster_grow((void**)&raster->states, &raster->state_capacity, raster->state_count + 1u, sizeof(*raster->states))) {
+		se_set_last_error(SE_RESULT_OUT_OF_MEMORY);
+		return false;
+	}
+	const u32 state_index = raster->state_count++;
+	raster->states[state_index] = *state;
+	if (state->scratch_bytes > raster->scratch_bytes) {
+		raster->scratch_bytes = state->scratch_bytes;
+	}
+	raster->stats.draws++;
+	for (u32 i = 0u; i + 2u < index_count; i += 3u) {
+		const u32 i0 = indices ? indices[i] : i;
+		const u32 i1 = indices ? indices[i + 1u] : i + 1u;
+		const u32 i2 = indices ? indices[i + 2u] : i + 2u;
+		if (i0 >= vertex_count || i1 >= vertex_count || i2 >= vertex_count) {
+			se_set_last_error(SE_RESULT_INVALID_ARGUMENT);
+			return false;
+		}
+		if (!se_soft_raster_setup_triangle(raster, state, state_index,
+				vertices + (sz)i0 * vertex_floats, vertices + (sz)i1 * vertex_floats, vertices + (sz)i2 * vertex_floats)) {
+			se_set_last_error(SE_RESULT_OUT_OF_MEMORY);
+			return false;
+		}
+	}
+	se_set_last_error(SE_RESULT_OK);
+	return true;
+}
+
+static b8 se_soft_raster_depth_passes(const se_soft_depth_func func, const f32 depth, const f32 stored) {
+	switch (func) {
+		case SE_SOFT_DEPTH_NEVER: return false;
+		case SE_SOFT_DEPTH_LESS: return depth < stored;
+		case SE_SOFT_DEPTH_EQUAL: return depth == stored;
+		case SE_SOFT_DEPTH_LEQUAL: return depth <= stored;
+		case SE_SOFT_DEPTH_GREATER: return depth > stored;
+		case SE_SOFT_DEPTH_NOTEQUAL: return depth != stored;
+		case SE_SOFT_DEPTH_GEQUAL: return depth >= stored;
+		default: return true;
+	}
+}
+
+static f32 se_soft_raster_blend_factor(const se_soft_blend_factor factor, const f32 src[4], const f32 dst[4], const u32 channel) {
+	switch (factor) {
+		case SE_SOFT_BLEND_ZERO: return 0.0f;
+		case SE_SOFT_BLEND_ONE: return 1.0f;
+		case SE_SOFT_BLEND_SRC_COLOR: return src[channel];
+		case SE_SOFT_BLEND_ONE_MINUS_SRC_COLOR: return 1.0f - src[channel];
+		case SE_SOFT_BLEND_DST_COLOR: return dst[channel];
+		case SE_SOFT_BLEND_ONE_MINUS_DST_COLOR: return 1.0f - dst[channel];
+		case SE_SOFT_BLEND_SRC_ALPHA: return src[3];
+		case SE_SOFT_BLEND_ONE_MINUS_SRC_ALPHA: return 1.0f - src[3];
+		case SE_SOFT_BLEND_DST_ALPHA: return dst[3];
+		case SE_SOFT_BLEND_ONE_MINUS_DST_ALPHA: return 1.0f - dst[3];
+		case SE_SOFT_BLEND_SRC_ALPHA_SATURATE: return channel == 3u ? 1.0f : fminf(src[3], 1.0f - dst[3]);
+		default: return 1.0f;
+	}
+}
+
+static f32 se_soft_raster_blend_equation(const se_soft_blend_equation equation, const f32 src, const f32 dst, const f32 src_factor, const f32 dst_factor) {
+	switch (equation) {
+		case SE_SOFT_BLEND_SUBTRACT: return src * src_factor - dst * dst_factor;
+		case SE_SOFT_BLEND_REVERSE_SUBTRACT: return dst * dst_factor - src * src_factor;
+		case SE_SOFT_BLEND_MIN: return fminf(src, dst);
+		case SE_SOFT_BLEND_MAX: return fmaxf(src, dst);
+		default: return src * src_factor + dst * dst_factor;
+	}
+}
+
+static void se_soft_raster_write_color(const se_soft_state* state, se_soft_image* image, const u32 x, const u32 y, f32 color[4]) {
+	const b8 full_mask = state->color_mask[0] && state->color_mask[1] && state->color_mask[2] && state->color_mask[3];
+	if (!state->blend && full_mask) {
+		se_soft_image_store(image, x, y, 0u, color);
+		return;
+	}
+	f32 dst[4];
+	se_soft_image_load(image, x, y, 0u, dst);
+	if (state->blend) {
+		// Fixed-point targets clamp the source before blending.
+		if (image->format == SE_SOFT_FORMAT_R8 || image->format == SE_SOFT_FORMAT_RG8 || image->format == SE_SOFT_FORMAT_RGBA8) {
+			for (u32 i = 0u; i < 4u; ++i) {
+				color[i] = se_soft_raster_clamp01(color[i]);
+			}
+		}
+		f32 blended[4];
+		for (u32 i = 0u; i < 4u; ++i) {
+			const b8 alpha = i == 3u;
+			const f32 src_factor = se_soft_raster_blend_factor(alpha ? state->blend_src_alpha : state->blend_src_rgb, color, dst, i);
+			const f32 dst_factor = se_soft_raster_blend_factor(alpha ? state->blend_dst_alpha : state->blend_dst_rgb, color, dst, i);
+			blended[i] = se_soft_raster_blend_equation(alpha ? state->blend_equation_alpha : state->blend_equation_rgb,
+				color[i], dst[i], src_factor, dst_factor);
+		}
+		memcpy(color, blended, sizeof(blended));
+	}
+	for (u32 i = 0u; i < 4u; ++i) {
+		if (!state->color_mask[i]) {
+			color[i] = dst[i];
+		}
+	}
+	se_soft_image_store(image, x, y, 0u, color);
+}
+
+static void se_soft_raster_shade_tile(const u32 active_index, void* user_data) {
+	se_soft_raster* raster = (se_soft_raster*)user_data;
+	const u32 tile_index = raster->active_tiles[active_index];
+	se_soft_raster_tile* tile = &raster->tiles[tile_index];
+	const u32 tile_x0 = (tile_index % raster->tiles_x) * raster->tile_size;
+	const u32 tile_y0 = (tile_index / raster->tiles_x) * raster->tile_size;
+	const u32 tile_x1 = tile_x0 + raster->tile_size - 1u < raster->width ? tile_x0 + raster->tile_size - 1u : raster->width - 1u;
+	const u32 tile_y1 = tile_y0 + raster->tile_size - 1u < raster->height ? tile_y0 + raster->tile_size - 1u : raster->height - 1u;
+	se_soft_image* color_image = raster->color;
+	se_soft_image* depth_image = raster->depth;
+	f32* depth_texels = depth_image ? (f32*)depth_image->texels : NULL;
+
+	void* scratch = NULL;
+	if (raster->scratch_bytes > 0u) {
+		scratch = malloc(raster->scratch_bytes);
+		if (!scratch) {
+			return;
+		}
+	}
+	f32 varyings[SE_SOFT_RASTER_MAX_VARYINGS];
+	se_soft_fragment fragment = {0};
+	fragment.varyings = varyings;
+
+	for (u32 t = 0u; t < tile->count; ++t) {
+		const se_soft_raster_triangle* triangle = &raster->triangles[tile->items[t]];
+		const se_soft_state* state = &raster->states[triangle->state];
+		const u32 varying_count = state->varying_count;
+		const f32* corner_varyings = raster->varyings + triangle->varyings;
+		const b8 depth_test = state->depth_test && depth_texels;
+		const b8 early_depth = depth_test && !state->writes_depth;
+		const u32 x_begin = triangle->min_x > tile_x0 ? triangle->min_x : tile_x0;
+		const u32 x_end = triangle->max_x < tile_x1 ? triangle->max_x : tile_x1;
+		const u32 y_begin = triangle->min_y > tile_y0 ? triangle->min_y : tile_y0;
+		const u32 y_end = triangle->max_y < tile_y1 ? triangle->max_y : tile_y1;
+		if (x_begin > x_end || y_begin > y_end) {
+			continue;
+		}
+		fragment.front_facing = triangle->front;
+		for (u32 py = y_begin; py <= y_end; ++py) {
+			const f64 sy = (f64)py + 0.5;
+			for (u32 px = x_begin; px <= x_end; ++px) {
+				const f64 sx = (f64)px + 0.5;
+				f64 w[3];
+				b8 inside = true;
+				for (u32 k = 0u; k < 3u; ++k) {
+					w[k] = triangle->edge[k][0] * sx + triangle->edge[k][1] * sy + triangle->edge[k][2];
+					if (w[k] < 0.0 || (w[k] == 0.0 && !triangle->top_left[k])) {
+						inside = false;
+						break;
+					}
+				}
+				if (!inside) {
+					continue;
+				}
+				const f32 b0 = (f32)(w[0] * triangle->inv_area);
+				const f32 b1 = (f32)(w[1] * triangle->inv_area);
+				const f32 b2 = (f32)(w[2] * triangle->inv_area);
+				f32 depth = b0 * triangle->z[0] + b1 * triangle->z[1] + b2 * triangle->z[2];
+				if (depth < 0.0f || depth > 1.0f) {
+					continue;
+				}
+				depth = se_soft_raster_clamp01(depth + triangle->z_offset);
+				const sz pixel = (sz)py * (depth_image ? depth_image->width : 0u) + px;
+				if (early_depth && !se_soft_raster_depth_passes(state->depth_func, depth, depth_texels[pixel])) {
+					continue;
+				}
+				const f32 inv_w = b0 * triangle->inv_w[0] + b1 * triangle->inv_w[1] + b2 * triangle->inv_w[2];
+				const f32 w_interp = 1.0f / inv_w;
+				for (u32 k = 0u; k < varying_count; ++k) {
+					if (state->flat_varyings & (1ull << k)) {
+						varyings[k] = corner_varyings[k];
+						continue;
+					}
+					varyings[k] = (b0 * corner_varyings[k] + b1 * corner_varyings[varying_count + k] +
+						b2 * corner_varyings[2u * varying_count + k]) * w_interp;
+				}
+				fragment.frag_coord[0] = (f32)sx;
+				fragment.frag_coord[1] = (f32)sy;
+				fragment.frag_coord[2] = depth;
+				fragment.frag_coord[3] = inv_w;
+				f32 color[4] = {0.0f, 0.0f, 0.0f, 1.0f};
+				tile->fragments_shaded++;
+				if (!state->fragment(state->shader, scratch, &fragment, color, &depth)) {
+					continue;
+				}
+				if (state->writes_depth) {
+					depth = se_soft_raster_clamp01(depth);
+					if (depth_test && !se_soft_raster_depth_passes(state->depth_func, depth, depth_texels[pixel])) {
+						continue;
+					}
+				}
+				if (color_image) {
+					se_soft_raster_write_color(state, color_image, px, py, color);
+				}
+				if (depth_test && state->depth_write) {
+					depth_texels[pixel] = depth;
+				}
+				tile->fragments_written++;
+			}
+		}
+	}
+	free(scratch);
+}
+
+b8 se_soft_raster_flush(se_soft_raster* raster) {
+	if (!raster) {
+		se_set_last_error(SE_RESULT_INVALID_ARGUMENT);
+		return false;
+	}
+	if (raster->active_tile_count > 0u) {
+		// Tiles own disjoint pixels and replay their triangles in submission order, so any
+		// worker may take any tile and the result matches a single-threaded run.
+		if (!raster->workers || raster->active_tile_count == 1u ||
+			!se_worker_parallel_for(raster->workers, raster->active_tile_count, 1u, se_soft_raster_shade_tile, raster)) {
+			for (u32 i = 0u; i < raster->active_tile_count; ++i) {
+				se_soft_raster_shade_tile(i, raster);
+			}
+		}
+		for (u32 i = 0u; i < raster->active_tile_count; ++i) {
+			se_soft_raster_tile* tile = &raster->tiles[raster->active_tiles[i]];
+			raster->stats.fragments_shaded += tile->fragments_shaded;
+			raster->stats.fragments_written += tile->fragments_written;
+			tile->fragments_shaded = 0u;
+			tile->fragments_written = 0u;
+			tile->count = 0u;
+		}
+		raster->stats.flushes++;
+	}
+	raster->active_tile_count = 0u;
+	raster->triangle_count = 0u;
+	raster->state_count = 0u;
+	raster->varying_count = 0u;
+	raster->scratch_bytes = 0u;
+	se_set_last_error(SE_RESULT_OK);
+	return true;
+}
+
+b8 se_soft_raster_clear(se_soft_raster* raster, const f32* color, const b8 color_mask[4], const f32* depth) {
+	if (!raster) {
+		se_set_last_error(SE_RESULT_INVALID_ARGUMENT);
+		return false;
+	}
+	se_soft_raster_flush(raster);
+	se_soft_image* color_image = raster->color;
+	if (color && color_image) {
+		const b8 full_mask = !color_mask || (color_mask[0] && color_mask[1] && color_mask[2] && color_mask[3]);
+		const sz texel_count = (sz)color_image->width * color_image->height * color_image->depth;
+		if (full_mask) {
+			const u32 texel_bytes = se_soft_format_texel_bytes(color_image->format);
+			se_soft_image_store(color_image, 0u, 0u, 0u, color);
+			for (sz i = 1u; i < texel_count; ++i) {
+				memcpy(color_image->texels + i * texel_bytes, color_image->texels, texel_bytes);
+			}
+		} else {
+			for (u32 z = 0u; z < color_image->depth; ++z) {
+				for (u32 y = 0u; y < color_image->height; ++y) {
+					for (u32 x = 0u; x < color_image->width; ++x) {
+						f32 value[4];
+						se_soft_image_load(color_image, x, y, z, value);
+						for (u32 i = 0u; i < 4u; ++i) {
+							if (color_mask[i]) {
+								value[i] = color[i];
+							}
+						}
+						se_soft_image_store(color_image, x, y, z, value);
+					}
+				}
+			}
+		}
+	}
+	if (depth && raster->depth) {
+		const f32 value = se_soft_raster_clamp01(*depth);
+		f32* texels = (f32*)raster->depth->texels;
+		const sz texel_count = (sz)raster->depth->width * raster->depth->height * raster->depth->depth;
+		for (sz i = 0u; i < texel_count; ++i) {
+			texels[i] = value;
+		}
+	}
+	se_set_last_error(SE_RESULT_OK);
+	return true;
+}
+
+void se_soft_raster_get_stats(const se_soft_raster* raster, se_soft_raster_stats* out_stats) {
+	if (!out_stats) {
+		return;
+	}
+	if (!raster) {
+		memset(out_stats, 0, sizeof(*out_stats));
+		return;
+	}
+	*out_stats = raster->stats;
+}
@@ -0,0 +1,166 @@
+// Syphax-Engine - Ougi Washi
+
+#ifndef SE_SOFT_RASTER_H
+#define SE_SOFT_RASTER_H
+
+#include "se_worker.h"
+
+#define SE_SOFT_RASTER_MAX_VARYINGS 64u
+
+typedef struct se_soft_raster se_soft_raster;
+
+typedef enum {
+	SE_SOFT_FORMAT_NONE = 0,
+	SE_SOFT_FORMAT_R8,
+	SE_SOFT_FORMAT_RG8,
+	SE_SOFT_FORMAT_RGBA8,
+	SE_SOFT_FORMAT_R32F,
+	SE_SOFT_FORMAT_RGBA32F,
+	SE_SOFT_FORMAT_DEPTH32F
+} se_soft_format;
+
+// Row 0 is the bottom row, as for GL textures and window coordinates. 3D images store
+// `depth` slices of width * height texels back to back.
+typedef struct {
+	u32 width;
+	u32 height;
+	u32 depth;
+	se_soft_format format;
+	u8* texels;
+} se_soft_image;
+
+typedef enum {
+	SE_SOFT_WRAP_REPEAT = 0,
+	SE_SOFT_WRAP_CLAMP,
+	SE_SOFT_WRAP_MIRROR
+} se_soft_wrap;
+
+// Only the base level is sampled; an unbound image reads as (0, 0, 0, 1).
+typedef struct {
+	const se_soft_image* image;
+	se_soft_wrap wrap[3];
+	b8 linear;
+} se_soft_sampler;
+
+typedef struct {
+	f32 frag_coord[4];
+	const f32* varyings;
+	b8 front_facing;
+} se_soft_fragment;
+
+// Runs on worker threads: `scratch` is private to the calling thread and `shader` is shared
+// read-only. `inout_depth` holds the interpolated depth and may be replaced. Return false to discard.
+typedef b8 (*se_soft_fragment_fn)(const void* shader, void* scratch, const se_soft_fragment* fragment, f32 out_color[4], f32* inout_depth);
+
+typedef enum {
+	SE_SOFT_CULL_NONE = 0,
+	SE_SOFT_CULL_BACK,
+	SE_SOFT_CULL_FRONT,
+	SE_SOFT_CULL_FRONT_AND_BACK
+} se_soft_cull;
+
+typedef enum {
+	SE_SOFT_DEPTH_NEVER = 0,
+	SE_SOFT_DEPTH_LESS,
+	SE_SOFT_DEPTH_EQUAL,
+	SE_SOFT_DEPTH_LEQUAL,
+	SE_SOFT_DEPTH_GREATER,
+	SE_SOFT_DEPTH_NOTEQUAL,
+	SE_SOFT_DEPTH_GEQUAL,
+	SE_SOFT_DEPTH_ALWAYS
+} se_soft_depth_func;
+
+typedef enum {
+	SE_SOFT_BLEND_ZERO = 0,
+	SE_SOFT_BLEND_ONE,
+	SE_SOFT_BLEND_SRC_COLOR,
+	SE_SOFT_BLEND_ONE_MINUS_SRC_COLOR,
+	SE_SOFT_BLEND_DST_COLOR,
+	SE_SOFT_BLEND_ONE_MINUS_DST_COLOR,
+	SE_SOFT_BLEND_SRC_ALPHA,
+	SE_SOFT_BLEND_ONE_MINUS_SRC_ALPHA,
+	SE_SOFT_BLEND_DST_ALPHA,
+	SE_SOFT_BLEND_ONE_MINUS_DST_ALPHA,
+	SE_SOFT_BLEND_SRC_ALPHA_SATURATE
+} se_soft_blend_factor;
+
+typedef enum {
+	SE_SOFT_BLEND_ADD = 0,
+	SE_SOFT_BLEND_SUBTRACT,
+	SE_SOFT_BLEND_REVERSE_SUBTRACT,
+	SE_SOFT_BLEND_MIN,
+	SE_SOFT_BLEND_MAX
+} se_soft_blend_equation;
+
+// `shader` must stay alive until the next flush. Flat varyings, one bit per float, take the
+// value of the last vertex of each triangle.
+typedef struct {
+	se_soft_fragment_fn fragment;
+	const void* shader;
+	u32 scratch_bytes;
+	u32 varying_count;
+	u64 flat_varyings;
+	b8 writes_depth;
+	i32 viewport[4];
+	se_soft_cull cull;
+	b8 front_ccw;
+	b8 depth_test;
+	b8 depth_write;
+	se_soft_depth_func depth_func;
+	b8 blend;
+	se_soft_blend_factor blend_src_rgb;
+	se_soft_blend_factor blend_dst_rgb;
+	se_soft_blend_factor blend_src_alpha;
+	se_soft_blend_factor blend_dst_alpha;
+	se_soft_blend_equation blend_equation_rgb;
+	se_soft_blend_equation blend_equation_alpha;
+	b8 color_mask[4];
+	b8 polygon_offset;
+	f32 polygon_offset_factor;
+	f32 polygon_offset_units;
+} se_soft_state;
+
+typedef struct {
+	u32 tile_size;
+	// Tiles are shaded on this pool; NULL shades on the calling thread.
+	se_worker_pool* workers;
+} se_soft_raster_config;
+
+#define SE_SOFT_RASTER_CONFIG_DEFAULTS ((se_soft_raster_config){ \
+	.tile_size = 32u, \
+	.workers = NULL \
+})
+
+typedef struct {
+	u64 draws;
+	u64 triangles;
+	u64 triangles_clipped;
+	u64 triangles_culled;
+	u64 tile_bins;
+	u64 fragments_shaded;
+	u64 fragments_written;
+	u64 flushes;
+} se_soft_raster_stats;
+
+extern u32 se_soft_format_texel_bytes(se_soft_format format);
+// Allocates zeroed texels, replacing whatever the image held.
+extern b8 se_soft_image_alloc(se_soft_image* image, u32 width, u32 height, u32 depth, se_soft_format format);
+extern void se_soft_image_free(se_soft_image* image);
+extern void se_soft_image_load(const se_soft_image* image, u32 x, u32 y, u32 z, f32 out_value[4]);
+extern void se_soft_image_store(se_soft_image* image, u32 x, u32 y, u32 z, const f32 value[4]);
+// `coord_count` is 2 for 2D lookups and 3 for 3D lookups.
+extern void se_soft_sample(const se_soft_sampler* sampler, const f32* coords, u32 coord_count, f32 out_color[4]);
+
+extern se_soft_raster* se_soft_raster_create(const se_soft_raster_config* config);
+extern void se_soft_raster_destroy(se_soft_raster* raster);
+// Either target may be NULL. Changing targets, or their size, flushes pending draws first.
+extern b8 se_soft_raster_set_targets(se_soft_raster* raster, se_soft_image* color, se_soft_image* depth);
+// Triangles are clipped and binned into tiles immediately; pixels change on flush. Each vertex is a
+// clip-space position followed by `state->varying_count` varyings, `vertex_floats` apart.
+extern b8 se_soft_raster_draw(se_soft_raster* raster, const se_soft_state* state, const f32* vertices, u32 vertex_floats, u32 vertex_count, const u32* indices, u32 index_count);
+extern b8 se_soft_raster_flush(se_soft_raster* raster);
+// Flushes, then fills the whole targets. A NULL `color` or `depth` leaves that target alone.
+extern b8 se_soft_raster_clear(se_soft_raster* raster, const f32* color, const b8 color_mask[4], const f32* depth);
+extern void se_soft_raster_get_stats(const se_soft_raster* raster, se_soft_raster_stats* out_stats);
+
+#endif // SE_SOFT_RASTER_H
@@ -3,7 +3,7 @@
 #include "se_backend.h"
 #include "se_graphics.h"
 
-#if defined(SE_RENDER_BACKEND_OPENGL) || defined(SE_RENDER_BACKEND_GLES)
+#if defined(SE_RENDER_BACKEND_OPENGL) || defined(SE_RENDER_BACKEND_GLES) || defined(SE_RENDER_BACKEND_SOFTWARE)
 #include "render/se_gl.h"
 #include <stdio.h>
 #include <string.h>
@@ -14,6 +14,8 @@ static se_backend_render se_backend_render_current(void) {
 	return SE_BACKEND_RENDER_OPENGL;
 #elif defined(SE_RENDER_BACKEND_GLES)
 	return SE_BACKEND_RENDER_GLES;
+#elif defined(SE_RENDER_BACKEND_SOFTWARE)
+	return SE_BACKEND_RENDER_SOFTWARE;
 #elif defined(SE_RENDER_BACKEND_VULKAN)
 	return SE_BACKEND_RENDER_VULKAN;
 #else
@@ -36,7 +38,7 @@ static se_backend_platform se_backend_platform_current(void) {
 }
 
 static se_shader_profile se_backend_shader_profile_current(void) {
-#if defined(SE_RENDER_BACKEND_OPENGL)
+#if defined(SE_RENDER_BACKEND_OPENGL) || defined(SE_RENDER_BACKEND_SOFTWARE)
 	return SE_SHADER_PROFILE_GLSL_330;
 #elif defined(SE_RENDER_BACKEND_GLES)
 	return SE_SHADER_PROFILE_GLSL_ES_300;
@@ -50,6 +52,8 @@ static se_portability_profile se_backend_portability_profile_current(void) {
 	return SE_PROFILE_GLES3;
 #elif defined(SE_RENDER_BACKEND_GLES)
 	return (se_portability_profile)(SE_PROFILE_GLES3 | SE_PROFILE_WEBGL2);
+#elif defined(SE_RENDER_BACKEND_SOFTWARE)
+	return (se_portability_profile)(SE_PROFILE_GLES3 | SE_PROFILE_SOFTWARE);
 #else
 	return SE_PROFILE_NONE;
 #endif
@@ -69,7 +73,7 @@ se_portability_profile se_get_portability_profile(void) {
 	return se_backend_portability_profile_current();
 }
 
-#if defined(SE_RENDER_BACKEND_OPENGL) || defined(SE_RENDER_BACKEND_GLES)
+#if defined(SE_RENDER_BACKEND_OPENGL) || defined(SE_RENDER_BACKEND_GLES) || defined(SE_RENDER_BACKEND_SOFTWARE)
 static void se_parse_gl_version(const c8 *version, i32 *out_major, i32 *out_minor) {
 	s_assertf(out_major, "se_parse_gl_version :: out_major is null");
 	s_assertf(out_minor, "se_parse_gl_version :: out_minor is null");
@@ -89,7 +93,7 @@ static void se_parse_gl_version(const c8 *version, i32 *out_major, i32 *out_mino
 
 se_capabilities se_capabilities_get(void) {
 	se_capabilities caps = {0};
-#if defined(SE_RENDER_BACKEND_OPENGL) || defined(SE_RENDER_BACKEND_GLES)
+#if defined(SE_RENDER_BACKEND_OPENGL) || defined(SE_RENDER_BACKEND_GLES) || defined(SE_RENDER_BACKEND_SOFTWARE)
 	if (!se_render_has_context()) {
 		return caps;
 	}
@@ -115,7 +119,7 @@ se_capabilities se_capabilities_get(void) {
 	caps.max_texture_size = (u32)max_texture_size;
 	caps.max_texture_units = (u32)max_texture_units;
 
-#if defined(SE_RENDER_BACKEND_OPENGL)
+#if defined(SE_RENDER_BACKEND_OPENGL) || defined(SE_RENDER_BACKEND_SOFTWARE)
 	caps.float_render_targets = true;
 #else
 	const c8 *extensions = (const c8 *)glGetString(GL_EXTENSIONS);
@@ -131,8 +135,13 @@ se_capabilities se_capabilities_get(void) {
 	se_parse_gl_version(version, &major, &minor);
 #if defined(SE_RENDER_BACKEND_GLES)
 	caps.compute_available = major > 3 || (major == 3 && minor >= 1);
+	caps.multi_draw_indirect =
+		se_glMultiDrawElementsIndirect != NULL &&
+		extensions &&
+		strstr(extensions, "GL_EXT_multi_draw_indirect");
 #else
 	caps.compute_available = major > 4 || (major == 4 && minor >= 3);
+	caps.multi_draw_indirect = se_glMultiDrawElementsIndirect != NULL && caps.compute_available;
 #endif
 #else
 	caps.valid = false;
@@ -0,0 +1,482 @@
+// Syphax-Engine - Ougi Washi
+
+#include "se_bvh.h"
+
+#include <float.h>
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define SE_BVH_NULL UINT32_MAX
+#define SE_BVH_STACK_SIZE 256u
+
+typedef struct {
+	se_box_3d box;
+	u64 user;
+	u32 user_index;
+	// Parent while in the tree, next free node while on the free list.
+	u32 parent;
+	u32 child1;
+	u32 child2;
+	// Leaves are 0, free nodes -1.
+	i32 height;
+} se_bvh_node;
+
+struct se_bvh {
+	se_bvh_node* nodes;
+	u32 capacity;
+	u32 node_count;
+	u32 root;
+	u32 free_list;
+	u32 leaf_count;
+	f32 margin;
+	f32 margin_min;
+};
+
+static b8 se_bvh_is_leaf(const se_bvh_node* node) {
+	return node->child1 == SE_BVH_NULL;
+}
+
+static f32 se_bvh_area(const se_box_3d* box) {
+	const f32 dx = box->max.x - box->min.x;
+	const f32 dy = box->max.y - box->min.y;
+	const f32 dz = box->max.z - box->min.z;
+	return 2.0f * (dx * dy + dy * dz + dz * dx) + (dx + dy + dz) * 1e-6f;
+}
+
+static se_box_3d se_bvh_union(const se_box_3d* a, const se_box_3d* b) {
+	se_box_3d out = *a;
+	se_box_3d_merge(&out, b);
+	return out;
+}
+
+static b8 se_bvh_contains(const se_box_3d* outer, const se_box_3d* inner) {
+	return outer->min.x <= inner->min.x && outer->min.y <= inner->min.y && outer->min.z <= inner->min.z &&
+		outer->max.x >= inner->max.x && outer->max.y >= inner->max.y && outer->max.z >= inner->max.z;
+}
+
+static se_box_3d se_bvh_fatten(const se_bvh* bvh, const se_box_3d* box) {
+	const f32 extent = fmaxf(box->max.x - box->min.x, fmaxf(box->max.y - box->min.y, box->max.z - box->min.z));
+	const f32 margin = extent * bvh->margin + bvh->margin_min;
+	se_box_3d out = *box;
+	out.min = s_vec3(box->min.x - margin, box->min.y - margin, box->min.z - margin);
+	out.max = s_vec3(box->max.x + margin, box->max.y + margin, box->max.z + margin);
+	return out;
+}
+
+static b8 se_bvh_grow(se_bvh* bvh, const u32 capacity) {
+	se_bvh_node* nodes = (se_bvh_node*)realloc(bvh->nodes, sizeof(*nodes) * (sz)capacity);
+	if (!nodes) {
+		return false;
+	}
+	for (u32 i = bvh->capacity; i < capacity; ++i) {
+		nodes[i].parent = (i + 1u < capacity) ? i + 1u : bvh->free_list;
+		nodes[i].height = -1;
+	}
+	bvh->free_list = bvh->capacity;
+	bvh->nodes = nodes;
+	bvh->capacity = capacity;
+	return true;
+}
+
+static u32 se_bvh_allocate_node(se_bvh* bvh) {
+	if (bvh->free_list == SE_BVH_NULL && !se_bvh_grow(bvh, bvh->capacity > 0u ? bvh->capacity * 2u : 16u)) {
+		return SE_BVH_NULL;
+	}
+	const u32 index = bvh->free_list;
+	se_bvh_node* node = &bvh->nodes[index];
+	bvh->free_list = node->parent;
+	node->parent = SE_BVH_NULL;
+	node->child1 = SE_BVH_NULL;
+	node->child2 = SE_BVH_NULL;
+	node->height = 0;
+	node->user = 0u;
+	node->user_index = 0u;
+	bvh->node_count++;
+	return index;
+}
+
+static void se_bvh_free_node(se_bvh* bvh, const u32 index) {
+	bvh->nodes[index].parent = bvh->free_list;
+	bvh->nodes[index].height = -1;
+	bvh->free_list = index;
+	bvh->node_count--;
+}
+
+static void se_bvh_refit_node(se_bvh* bvh, const u32 index) {
+	se_bvh_node* node = &bvh->nodes[index];
+	const se_bvh_node* child1 = &bvh->nodes[node->child1];
+	const se_bvh_node* child2 = &bvh->nodes[node->child2];
+	node->box = se_bvh_union(&child1->box, &child2->box);
+	node->height = 1 + (child1->height > child2->height ? child1->height : child2->height);
+}
+
+// Rotates the taller grandchild up when the subtree of `a` is unbalanced; returns the new root.
+static u32 se_bvh_balance(se_bvh* bvh, const u32 ia) {
+	se_bvh_node* a = &bvh->nodes[ia];
+	if (se_bvh_is_leaf(a) || a->height < 2) {
+		return ia;
+	}
+	const u32 ib = a->child1;
+	const u32 ic = a->child2;
+	se_bvh_node* b = &bvh->nodes[ib];
+	se_bvh_node* c = &bvh->nodes[ic];
+	const i32 balance = c->height - b->height;
+	if (balance > 1 || balance < -1) {
+		// Lift the taller child `up` into the place of `a`.
+		const u32 iup = balance > 1 ? ic : ib;
+		se_bvh_node* up = &bvh->nodes[iup];
+		const u32 i1 = up->child1;
+		const u32 i2 = up->child2;
+		se_bvh_node* n1 = &bvh->nodes[i1];
+		se_bvh_node* n2 = &bvh->nodes[i2];
+
+		up->child1 = ia;
+		up->parent = a->parent;
+		a->parent = iup;
+		if (up->parent != SE_BVH_NULL) {
+			se_bvh_node* parent = &bvh->nodes[up->parent];
+			if (parent->child1 == ia) {
+				parent->child1 = iup;
+			} else {
+				parent->child2 = iup;
+			}
+		} else {
+			bvh->root = iup;
+		}
+
+		// The taller grandchild stays under `up`, the shorter one replaces `up` under `a`.
+		const u32 keep = n1->height > n2->height ? i1 : i2;
+		const u32 give = keep == i1 ? i2 : i1;
+		up->child2 = keep;
+		if (balance > 1) {
+			a->child2 = give;
+		} else {
+			a->child1 = give;
+		}
+		bvh->nodes[give].parent = ia;
+		se_bvh_refit_node(bvh, ia);
+		se_bvh_refit_node(bvh, iup);
+		return iup;
+	}
+	return ia;
+}
+
+static void se_bvh_fix_upwards(se_bvh* bvh, u32 index) {
+	while (index != SE_BVH_NULL) {
+		index = se_bvh_balance(bvh, index);
+		se_bvh_refit_node(bvh, index);
+		index = bvh->nodes[index].parent;
+	}
+}
+
+static void se_bvh_insert_leaf(se_bvh* bvh, const u32 leaf) {
+	if (bvh->root == SE_BVH_NULL) {
+		bvh->root = leaf;
+		bvh->nodes[leaf].parent = SE_BVH_NULL;
+		return;
+	}
+
+	// Descend towards the sibling that grows the total area the least.
+	const se_box_3d leaf_box = bvh->nodes[leaf].box;
+	u32 index = bvh->root;
+	while (!se_bvh_is_leaf(&bvh->nodes[index])) {
+		const se_bvh_node* node = &bvh->nodes[index];
+		const f32 area = se_bvh_area(&node->box);
+		const se_box_3d combined = se_bvh_union(&node->box, &leaf_box);
+		const f32 combined_area = se_bvh_area(&combined);
+		const f32 cost = 2.0f * combined_area;
+		const f32 inheritance_cost = 2.0f * (combined_area - area);
+
+		f32 child_cost[2] = {0.0f, 0.0f};
+		const u32 children[2] = {node->child1, node->child2};
+		for (u32 i = 0u; i < 2u; ++i) {
+			const se_bvh_node* child = &bvh->nodes[children[i]];
+			const se_box_3d merged = se_bvh_union(&child->box, &leaf_box);
+			if (se_bvh_is_leaf(child)) {
+				child_cost[i] = se_bvh_area(&merged) + inheritance_cost;
+			} else {
+				child_cost[i] = (se_bvh_area(&merged) - se_bvh_area(&child->box)) + inheritance_cost;
+			}
+		}
+		if (cost < child_cost[0] && cost < child_cost[1]) {
+			break;
+		}
+		index = child_cost[0] < child_cost[1] ? children[0] : children[1];
+	}
+
+	const u32 sibling = index;
+	const u32 old_parent = bvh->nodes[sibling].parent;
+	const u32 new_parent = se_bvh_allocate_node(bvh);
+	se_bvh_node* parent = &bvh->nodes[new_parent];
+	parent->parent = old_parent;
+	parent->child1 = sibling;
+	parent->child2 = leaf;
+	bvh->nodes[sibling].parent = new_parent;
+	bvh->nodes[leaf].parent = new_parent;
+	se_bvh_refit_node(bvh, new_parent);
+	if (old_parent != SE_BVH_NULL) {
+		se_bvh_node* grand = &bvh->nodes[old_parent];
+		if (grand->child1 == sibling) {
+			grand->child1 = new_parent;
+		} else {
+			grand->child2 = new_parent;
+		}
+	} else {
+		bvh->root = new_parent;
+	}
+	se_bvh_fix_upwards(bvh, old_parent);
+}
+
+static void se_bvh_remove_leaf(se_bvh* bvh, const u32 leaf) {
+	if (leaf == bvh->root) {
+		bvh->root = SE_BVH_NULL;
+		return;
+	}
+	const u32 parent = bvh->nodes[leaf].parent;
+	const u32 grand = bvh->nodes[parent].parent;
+	const u32 sibling = bvh->nodes[parent].child1 == leaf ? bvh->nodes[parent].child2 : bvh->nodes[parent].child1;
+	if (grand != SE_BVH_NULL) {
+		se_bvh_node* grand_node = &bvh->nodes[grand];
+		if (grand_node->child1 == parent) {
+			grand_node->child1 = sibling;
+		} else {
+			grand_node->child2 = sibling;
+		}
+		bvh->nodes[sibling].parent = grand;
+		se_bvh_free_node(bvh, parent);
+		se_bvh_fix_upwards(bvh, grand);
+	} else {
+		bvh->root = sibling;
+		bvh->nodes[sibling].parent = SE_BVH_NULL;
+		se_bvh_free_node(bvh, parent);
+	}
+}
+
+se_bvh* se_bvh_create(const se_bvh_config* config) {
+	const se_bvh_config cfg = config ? *config : SE_BVH_CONFIG_DEFAULTS;
+	se_bvh* bvh = (se_bvh*)calloc(1u, sizeof(*bvh));
+	if (!bvh) {
+		return NULL;
+	}
+	bvh->root = SE_BVH_NULL;
+	bvh->free_list = SE_BVH_NULL;
+	bvh->margin = fmaxf(cfg.margin, 0.0f);
+	bvh->margin_min = fmaxf(cfg.margin_min, 0.0f);
+	if (cfg.initial_capacity > 0u && !se_bvh_grow(bvh, cfg.initial_capacity * 2u)) {
+		free(bvh);
+		return NULL;
+	}
+	return bvh;
+}
+
+void se_bvh_destroy(se_bvh* bvh) {
+	if (!bvh) {
+		return;
+	}
+	free(bvh->nodes);
+	free(bvh);
+}
+
+void se_bvh_clear(se_bvh* bvh) {
+	if (!bvh) {
+		return;
+	}
+	const u32 capacity = bvh->capacity;
+	bvh->capacity = 0u;
+	bvh->root = SE_BVH_NULL;
+	bvh->node_count = 0u;
+	bvh->leaf_count = 0u;
+	// Re-threads the free list over the existing allocation.
+	if (capacity > 0u) {
+		se_bvh_node* nodes = bvh->nodes;
+		for (u32 i = 0u; i < capacity; ++i) {
+			nodes[i].parent = (i + 1u < capacity) ? i + 1u : SE_BVH_NULL;
+			nodes[i].height = -1;
+		}
+		bvh->free_list = 0u;
+		bvh->capacity = capacity;
+	} else {
+		bvh->free_list = SE_BVH_NULL;
+	}
+}
+
+se_bvh_proxy se_bvh_insert(se_bvh* bvh, const se_box_3d* box, const u64 user, const u32 user_index) {
+	if (!bvh || !box) {
+		return SE_BVH_PROXY_NULL;
+	}
+	// A leaf insert needs at most one extra internal node; reserve both up front.
+	if (bvh->capacity - bvh->node_count < 2u && !se_bvh_grow(bvh, bvh->capacity > 0u ? bvh->capacity * 2u : 16u)) {
+		return SE_BVH_PROXY_NULL;
+	}
+	const u32 leaf = se_bvh_allocate_node(bvh);
+	se_bvh_node* node = &bvh->nodes[leaf];
+	node->box = se_bvh_fatten(bvh, box);
+	node->user = user;
+	node->user_index = user_index;
+	se_bvh_insert_leaf(bvh, leaf);
+	bvh->leaf_count++;
+	return leaf;
+}
+
+void se_bvh_remove(se_bvh* bvh, const se_bvh_proxy proxy) {
+	if (!bvh || proxy >= bvh->capacity || bvh->nodes[proxy].height != 0) {
+		return;
+	}
+	se_bvh_remove_leaf(bvh, proxy);
+	se_bvh_free_node(bvh, proxy);
+	bvh->leaf_count--;
+}
+
+b8 se_bvh_move(se_bvh* bvh, const se_bvh_proxy proxy, const se_box_3d* box) {
+	if (!bvh || !box || proxy >= bvh->capacity || bvh->nodes[proxy].height != 0) {
+		return false;
+	}
+	if (se_bvh_contains(&bvh->nodes[proxy].box, box)) {
+		return false;
+	}
+	se_bvh_remove_leaf(bvh, proxy);
+	bvh->nodes[proxy].box = se_bvh_fatten(bvh, box);
+	se_bvh_insert_leaf(bvh, proxy);
+	return true;
+}
+
+u32 se_bvh_get_count(const se_bvh* bvh) {
+	return bvh ? bvh->leaf_count : 0u;
+}
+
+u32 se_bvh_get_height(const se_bvh* bvh) {
+	return (bvh && bvh->root != SE_BVH_NULL) ? (u32)bvh->nodes[bvh->root].height : 0u;
+}
+
+// Popping one node and pushing its two children never holds more than height + 1 entries, so the
+// traversal stack is sized from the tree up front and only tall trees pay for a heap stack.
+static u32* se_bvh_stack_acquire(const se_bvh* bvh, u32* local) {
+	const u32 depth = (u32)bvh->nodes[bvh->root].height + 1u;
+	return depth <= SE_BVH_STACK_SIZE ? local : (u32*)malloc(sizeof(u32) * (sz)depth);
+}
+
+static void se_bvh_stack_release(u32* stack, u32* local) {
+	if (stack != local) {
+		free(stack);
+	}
+}
+
+void se_bvh_query_box(const se_bvh* bvh, const se_box_3d* box, se_bvh_query_fn fn, void* user_data) {
+	if (!bvh || !box || !fn || bvh->root == SE_BVH_NULL) {
+		return;
+	}
+	u32 local[SE_BVH_STACK_SIZE];
+	u32* stack = se_bvh_stack_acquire(bvh, local);
+	if (!stack) {
+		return;
+	}
+	u32 count = 0u;
+	stack[count++] = bvh->root;
+	while (count > 0u) {
+		const se_bvh_node* node = &bvh->nodes[stack[--count]];
+		if (!se_box_3d_intersects(&node->box, box)) {
+			continue;
+		}
+		if (se_bvh_is_leaf(node)) {
+			if (!fn(node->user, node->user_index, user_data)) {
+				break;
+			}
+			continue;
+		}
+		stack[count++] = node->child1;
+		stack[count++] = node->child2;
+	}
+	se_bvh_stack_release(stack, local);
+}
+
+void se_bvh_query_frustum(const se_bvh* bvh, const se_frustum* frustum, se_bvh_query_fn fn, void* user_data) {
+	if (!bvh || !frustum || !fn || bvh->root == SE_BVH_NULL) {
+		return;
+	}
+	u32 local[SE_BVH_STACK_SIZE];
+	u32* stack = se_bvh_stack_acquire(bvh, local);
+	if (!stack) {
+		return;
+	}
+	u32 count = 0u;
+	stack[count++] = bvh->root;
+	while (count > 0u) {
+		const se_bvh_node* node = &bvh->nodes[stack[--count]];
+		if (!se_frustum_intersects_box_3d(frustum, &node->box)) {
+			continue;
+		}
+		if (se_bvh_is_leaf(node)) {
+			if (!fn(node->user, node->user_index, user_data)) {
+				break;
+			}
+			continue;
+		}
+		stack[count++] = node->child1;
+		stack[count++] = node->child2;
+	}
+	se_bvh_stack_release(stack, local);
+}
+
+static b8 se_bvh_ray_box(const se_box_3d* box, const f32 radius, const f32 origin[3], const f32 inv_direction[3], const f32 max_distance) {
+	const f32 min[3] = { box->min.x - radius, box->min.y - radius, box->min.z - radius };
+	const f32 max[3] = { box->max.x + radius, box->max.y + radius, box->max.z + radius };
+	f32 t_min = 0.0f;
+	f32 t_max = max_distance;
+	for (u32 axis = 0u; axis < 3u; ++axis) {
+		if (isinf(inv_direction[axis])) {
+			if (origin[axis] < min[axis] || origin[axis] > max[axis]) {
+				return false;
+			}
+			continue;
+		}
+		f32 t0 = (min[axis] - origin[axis]) * inv_direction[axis];
+		f32 t1 = (max[axis] - origin[axis]) * inv_direction[axis];
+		if (t0 > t1) {
+			const f32 t = t0;
+			t0 = t1;
+			t1 = t;
+		}
+		t_min = fmaxf(t_min, t0);
+		t_max = fminf(t_max, t1);
+		if (t_min > t_max) {
+			return false;
+		}
+	}
+	return true;
+}
+
+void se_bvh_query_ray(const se_bvh* bvh, const s_vec3* origin, const s_vec3* direction, f32 max_distance, const f32 radius, se_bvh_ray_fn fn, void* user_data) {
+	if (!bvh || !origin || !direction || !fn || bvh->root == SE_BVH_NULL) {
+		return;
+	}
+	const f32 o[3] = { origin->x, origin->y, origin->z };
+	const f32 inv[3] = {
+		direction->x != 0.0f ? 1.0f / direction->x : INFINITY,
+		direction->y != 0.0f ? 1.0f / direction->y : INFINITY,
+		direction->z != 0.0f ? 1.0f / direction->z : INFINITY
+	};
+	u32 local[SE_BVH_STACK_SIZE];
+	u32* stack = se_bvh_stack_acquire(bvh, local);
+	if (!stack) {
+		return;
+	}
+	u32 count = 0u;
+	stack[count++] = bvh->root;
+	while (count > 0u) {
+		const se_bvh_node* node = &bvh->nodes[stack[--count]];
+		if (!se_bvh_ray_box(&node->box, radius, o, inv, max_distance)) {
+			continue;
+		}
+		if (se_bvh_is_leaf(node)) {
+			const f32 hit = fn(node->user, node->user_index, max_distance, user_data);
+			if (hit < max_distance) {
+				max_distance = hit;
+			}
+			continue;
+		}
+		stack[count++] = node->child1;
+		stack[count++] = node->child2;
+	}
+	se_bvh_stack_release(stack, local);
+}
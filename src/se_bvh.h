@@ -0,0 +1,51 @@
+// Syphax-Engine - Ougi Washi
+
+#ifndef SE_BVH_H
+#define SE_BVH_H
+
+#include "se_defines.h"
+#include "se_math.h"
+
+#define SE_BVH_PROXY_NULL UINT32_MAX
+
+// Dynamic AABB tree: leaves hold fattened boxes so small moves do not touch the tree, and
+// inserts keep it height-balanced with rotations. 2D users store boxes with min.z == max.z.
+typedef struct se_bvh se_bvh;
+typedef u32 se_bvh_proxy;
+
+typedef struct {
+	u32 initial_capacity;
+	// Leaves are grown by this fraction of their largest extent, plus `margin_min`.
+	f32 margin;
+	f32 margin_min;
+} se_bvh_config;
+
+#define SE_BVH_CONFIG_DEFAULTS ((se_bvh_config){ \
+	.initial_capacity = 64u, \
+	.margin = 0.1f, \
+	.margin_min = 0.001f \
+})
+
+// Return false to stop the query.
+typedef b8 (*se_bvh_query_fn)(u64 user, u32 user_index, void* user_data);
+// Returns the hit distance, or `max_distance` to ignore the leaf; nodes beyond the returned
+// distance are skipped afterwards.
+typedef f32 (*se_bvh_ray_fn)(u64 user, u32 user_index, f32 max_distance, void* user_data);
+
+extern se_bvh* se_bvh_create(const se_bvh_config* config);
+extern void se_bvh_destroy(se_bvh* bvh);
+extern void se_bvh_clear(se_bvh* bvh);
+extern se_bvh_proxy se_bvh_insert(se_bvh* bvh, const se_box_3d* box, u64 user, u32 user_index);
+extern void se_bvh_remove(se_bvh* bvh, se_bvh_proxy proxy);
+// Returns true when the box left its fattened bounds and the leaf was reinserted.
+extern b8 se_bvh_move(se_bvh* bvh, se_bvh_proxy proxy, const se_box_3d* box);
+extern u32 se_bvh_get_count(const se_bvh* bvh);
+extern u32 se_bvh_get_height(const se_bvh* bvh);
+
+// Leaves are reported by their fattened boxes, so callers re-test exact bounds.
+extern void se_bvh_query_box(const se_bvh* bvh, const se_box_3d* box, se_bvh_query_fn fn, void* user_data);
+extern void se_bvh_query_frustum(const se_bvh* bvh, const se_frustum* frustum, se_bvh_query_fn fn, void* user_data);
+// Node boxes are grown by `radius` before the slab test, for picking with a tolerance.
+extern void se_bvh_query_ray(const se_bvh* bvh, const s_vec3* origin, const s_vec3* direction, f32 max_distance, f32 radius, se_bvh_ray_fn fn, void* user_data);
+
+#endif // SE_BVH_H
@@ -13,6 +13,8 @@ const char *se_ext_feature_name(const se_ext_feature feature) {
 			return "float_render_target";
 		case SE_EXT_FEATURE_COMPUTE:
 			return "compute";
+		case SE_EXT_FEATURE_MULTI_DRAW_INDIRECT:
+			return "multi_draw_indirect";
 		default:
 			return "unknown";
 	}
@@ -33,6 +35,8 @@ b8 se_ext_is_supported(const se_ext_feature feature) {
 			return caps.float_render_targets;
 		case SE_EXT_FEATURE_COMPUTE:
 			return caps.compute_available;
+		case SE_EXT_FEATURE_MULTI_DRAW_INDIRECT:
+			return caps.multi_draw_indirect;
 		default:
 			return false;
 	}
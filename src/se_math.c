@@ -20,6 +20,66 @@ b8 se_box_2d_intersects(const se_box_2d* a, const se_box_2d* b) {
 		a->min.y <= b->max.y && a->max.y >= b->min.y;
 }
 
+static b8 se_polygon_contains(const s_vec2* points, const u32 point_count, const s_vec2* p) {
+	b8 inside = false;
+	for (u32 i = 0, j = point_count - 1; i < point_count; j = i++) {
+		const s_vec2* a = &points[i];
+		const s_vec2* b = &points[j];
+		if ((a->y > p->y) != (b->y > p->y) && p->x < (b->x - a->x) * (p->y - a->y) / (b->y - a->y) + a->x) {
+			inside = !inside;
+		}
+	}
+	return inside;
+}
+
+// Liang-Barsky clip of segment ab against the box.
+static b8 se_segment_intersects_box_2d(const s_vec2* a, const s_vec2* b, const se_box_2d* box) {
+	const f32 d[2] = { b->x - a->x, b->y - a->y };
+	const f32 o[2] = { a->x, a->y };
+	const f32 lo[2] = { box->min.x, box->min.y };
+	const f32 hi[2] = { box->max.x, box->max.y };
+	f32 t0 = 0.0f;
+	f32 t1 = 1.0f;
+	for (u32 axis = 0; axis < 2; ++axis) {
+		if (fabsf(d[axis]) < 1e-12f) {
+			if (o[axis] < lo[axis] || o[axis] > hi[axis]) {
+				return false;
+			}
+			continue;
+		}
+		const f32 inv = 1.0f / d[axis];
+		f32 near_t = (lo[axis] - o[axis]) * inv;
+		f32 far_t = (hi[axis] - o[axis]) * inv;
+		if (near_t > far_t) {
+			const f32 tmp = near_t;
+			near_t = far_t;
+			far_t = tmp;
+		}
+		t0 = s_max(t0, near_t);
+		t1 = s_min(t1, far_t);
+		if (t0 > t1) {
+			return false;
+		}
+	}
+	return true;
+}
+
+b8 se_box_2d_intersects_polygon(const se_box_2d* box, const s_vec2* points, const u32 point_count) {
+	if (!box || !points || point_count == 0) {
+		return false;
+	}
+	for (u32 i = 0; i < point_count; ++i) {
+		const s_vec2* a = &points[i];
+		const s_vec2* b = &points[(i + 1) % point_count];
+		if (se_segment_intersects_box_2d(a, b, box)) {
+			return true;
+		}
+	}
+	// No edge touches the box, so it is either fully inside the polygon or fully outside.
+	const s_vec2 center = s_vec2((box->min.x + box->max.x) * 0.5f, (box->min.y + box->max.y) * 0.5f);
+	return point_count >= 3 && se_polygon_contains(points, point_count, &center);
+}
+
 b8 se_box_3d_intersects(const se_box_3d* a, const se_box_3d* b) {
 	return a->min.x <= b->max.x && a->max.x >= b->min.x &&
 		a->min.y <= b->max.y && a->max.y >= b->min.y &&
@@ -36,3 +96,171 @@ b8 se_sphere_intersects(const se_sphere* a, const se_sphere* b) {
 		fabs(a->position.y - b->position.y) <= a->radius + b->radius ||
 		fabs(a->position.z - b->position.z) <= a->radius + b->radius;
 }
+
+void se_box_3d_transform(se_box_3d* out_box, const se_box_3d* box, const s_mat4* transform) {
+	const f32 min[3] = { box->min.x, box->min.y, box->min.z };
+	const f32 max[3] = { box->max.x, box->max.y, box->max.z };
+	f32 out_min[3] = { transform->m[3][0], transform->m[3][1], transform->m[3][2] };
+	f32 out_max[3] = { transform->m[3][0], transform->m[3][1], transform->m[3][2] };
+	for (u32 row = 0; row < 3; ++row) {
+		for (u32 col = 0; col < 3; ++col) {
+			const f32 a = transform->m[col][row] * min[col];
+			const f32 b = transform->m[col][row] * max[col];
+			out_min[row] += a < b ? a : b;
+			out_max[row] += a < b ? b : a;
+		}
+	}
+	out_box->min = s_vec3(out_min[0], out_min[1], out_min[2]);
+	out_box->max = s_vec3(out_max[0], out_max[1], out_max[2]);
+}
+
+void se_box_3d_merge(se_box_3d* out_box, const se_box_3d* box) {
+	out_box->min = s_vec3(fminf(out_box->min.x, box->min.x), fminf(out_box->min.y, box->min.y), fminf(out_box->min.z, box->min.z));
+	out_box->max = s_vec3(fmaxf(out_box->max.x, box->max.x), fmaxf(out_box->max.y, box->max.y), fmaxf(out_box->max.z, box->max.z));
+}
+
+void se_frustum_from_matrix(se_frustum* out_frustum, const s_mat4* view_projection) {
+	const s_mat4* m = view_projection;
+	for (u32 i = 0; i < 6; ++i) {
+		const u32 row = i / 2;
+		const f32 sign = (i % 2 == 0) ? 1.0f : -1.0f;
+		s_vec4 plane = s_vec4(
+			m->m[0][3] + sign * m->m[0][row],
+			m->m[1][3] + sign * m->m[1][row],
+			m->m[2][3] + sign * m->m[2][row],
+			m->m[3][3] + sign * m->m[3][row]);
+		const f32 length = sqrtf(plane.x * plane.x + plane.y * plane.y + plane.z * plane.z);
+		if (length > 0.0f) {
+			const f32 inv_length = 1.0f / length;
+			plane = s_vec4(plane.x * inv_length, plane.y * inv_length, plane.z * inv_length, plane.w * inv_length);
+		}
+		out_frustum->planes[i] = plane;
+	}
+}
+
+b8 se_frustum_intersects_box_3d(const se_frustum* frustum, const se_box_3d* box) {
+	for (u32 i = 0; i < 6; ++i) {
+		const s_vec4* plane = &frustum->planes[i];
+		const f32 x = plane->x >= 0.0f ? box->max.x : box->min.x;
+		const f32 y = plane->y >= 0.0f ? box->max.y : box->min.y;
+		const f32 z = plane->z >= 0.0f ? box->max.z : box->min.z;
+		if (plane->x * x + plane->y * y + plane->z * z + plane->w < 0.0f) {
+			return false;
+		}
+	}
+	return true;
+}
+
+// Point where three planes meet, by Cramer's rule on their normals.
+static b8 se_planes_intersect(const s_vec4* a, const s_vec4* b, const s_vec4* c, s_vec3* out_point) {
+	const s_vec3 na = s_vec3(a->x, a->y, a->z);
+	const s_vec3 nb = s_vec3(b->x, b->y, b->z);
+	const s_vec3 nc = s_vec3(c->x, c->y, c->z);
+	const s_vec3 bc = s_vec3_cross(&nb, &nc);
+	const s_vec3 ca = s_vec3_cross(&nc, &na);
+	const s_vec3 ab = s_vec3_cross(&na, &nb);
+	const f32 denom = s_vec3_dot(&na, &bc);
+	if (fabsf(denom) < 1e-12f) {
+		return false;
+	}
+	const f32 inv = -1.0f / denom;
+	*out_point = s_vec3(
+		(a->w * bc.x + b->w * ca.x + c->w * ab.x) * inv,
+		(a->w * bc.y + b->w * ca.y + c->w * ab.y) * inv,
+		(a->w * bc.z + b->w * ca.z + c->w * ab.z) * inv);
+	return true;
+}
+
+b8 se_frustum_get_corners(const se_frustum* frustum, s_vec3 out_corners[8]) {
+	if (!frustum || !out_corners) {
+		return false;
+	}
+	// Side planes per corner: (left or right, bottom or top).
+	static const u32 sides[4][2] = { { 0, 2 }, { 1, 2 }, { 1, 3 }, { 0, 3 } };
+	for (u32 face = 0; face < 2; ++face) {
+		const s_vec4* cap = &frustum->planes[4 + face];
+		for (u32 i = 0; i < 4; ++i) {
+			if (!se_planes_intersect(&frustum->planes[sides[i][0]], &frustum->planes[sides[i][1]], cap, &out_corners[face * 4 + i])) {
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+b8 se_shadow_cascade_splits(const f32 near, const f32 far, const u32 cascade_count, const f32 lambda, f32* out_splits) {
+	if (!out_splits || !(near > 0.0f) || !(far > near) || cascade_count == 0 || cascade_count > SE_SHADOW_MAX_CASCADES || !(lambda >= 0.0f && lambda <= 1.0f)) {
+		return false;
+	}
+	for (u32 i = 0; i <= cascade_count; ++i) {
+		const f32 p = (f32)i / (f32)cascade_count;
+		const f32 logarithmic = near * powf(far / near, p);
+		const f32 uniform = near + (far - near) * p;
+		out_splits[i] = lambda * logarithmic + (1.0f - lambda) * uniform;
+	}
+	// Exact ends, so cascades tile the range without gaps.
+	out_splits[0] = near;
+	out_splits[cascade_count] = far;
+	return true;
+}
+
+static s_vec3 se_shadow_up_hint(const s_vec3* direction) {
+	return fabsf(direction->y) > 0.99f ? s_vec3(0.0f, 0.0f, 1.0f) : s_vec3(0.0f, 1.0f, 0.0f);
+}
+
+b8 se_shadow_fit_directional(const s_vec3 corners[8], const s_vec3* light_direction, const u32 resolution, const f32 caster_distance, s_mat4* out_view_projection) {
+	if (!corners || !light_direction || !out_view_projection || resolution == 0 || !(caster_distance >= 0.0f)) {
+		return false;
+	}
+	if (s_vec3_length(light_direction) < 1e-6f) {
+		return false;
+	}
+	const s_vec3 direction = s_vec3_normalize(light_direction);
+	s_vec3 center = s_vec3(0.0f, 0.0f, 0.0f);
+	for (u32 i = 0; i < 8; ++i) {
+		center = s_vec3_add(&center, &corners[i]);
+	}
+	center = s_vec3_divs(&center, 8.0f);
+	f32 radius = 0.0f;
+	for (u32 i = 0; i < 8; ++i) {
+		const s_vec3 offset = s_vec3_sub(&corners[i], &center);
+		radius = fmaxf(radius, s_vec3_length(&offset));
+	}
+	// Rounded up so float noise in the corners cannot change the texel size.
+	radius = fmaxf(ceilf(radius * 16.0f) / 16.0f, 1.0f / 16.0f);
+
+	const s_vec3 up_hint = se_shadow_up_hint(&direction);
+	const s_vec3 right_cross = s_vec3_cross(&direction, &up_hint);
+	const s_vec3 right = s_vec3_normalize(&right_cross);
+	const s_vec3 up = s_vec3_cross(&right, &direction);
+	const f32 texel = (2.0f * radius) / (f32)resolution;
+	const f32 cx = s_vec3_dot(&center, &right);
+	const f32 cy = s_vec3_dot(&center, &up);
+	const s_vec3 snap_x = s_vec3_muls(&right, floorf(cx / texel) * texel - cx);
+	const s_vec3 snap_y = s_vec3_muls(&up, floorf(cy / texel) * texel - cy);
+	center = s_vec3_add(&center, &snap_x);
+	center = s_vec3_add(&center, &snap_y);
+
+	const s_vec3 back = s_vec3_muls(&direction, radius + caster_distance);
+	const s_vec3 eye = s_vec3_sub(&center, &back);
+	const s_mat4 view = s_mat4_look_at(&eye, &center, &up);
+	const s_mat4 projection = s_mat4_ortho(-radius, radius, -radius, radius, 0.0f, 2.0f * radius + caster_distance);
+	*out_view_projection = s_mat4_mul(&projection, &view);
+	return true;
+}
+
+b8 se_shadow_fit_spot(const s_vec3* position, const s_vec3* direction, const f32 cone_angle, const f32 near, const f32 range, s_mat4* out_view_projection) {
+	if (!position || !direction || !out_view_projection || !(cone_angle > 0.0f && cone_angle < PI) || !(near > 0.0f) || !(range > near)) {
+		return false;
+	}
+	if (s_vec3_length(direction) < 1e-6f) {
+		return false;
+	}
+	const s_vec3 forward = s_vec3_normalize(direction);
+	const s_vec3 target = s_vec3_add(position, &forward);
+	const s_vec3 up_hint = se_shadow_up_hint(&forward);
+	const s_mat4 view = s_mat4_look_at(position, &target, &up_hint);
+	const s_mat4 projection = s_mat4_perspective(cone_angle, 1.0f, near, range);
+	*out_view_projection = s_mat4_mul(&projection, &view);
+	return true;
+}
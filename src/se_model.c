@@ -284,6 +284,7 @@ static b8 se_mesh_finalize(se_mesh *mesh,
 	}
 
 	mesh->matrix = s_mat4_identity;
+	se_mesh_compute_bounds(mesh);
 	mesh->gpu.vertex_count = (u32)s_array_get_size(&mesh->cpu.vertices);
 	mesh->gpu.index_count = (u32)s_array_get_size(&mesh->cpu.indices);
 
@@ -705,6 +706,48 @@ se_shader_handle se_model_get_mesh_shader(const se_model_handle model, const sz
 }
 
 
+b8 se_model_get_bounds(const se_model_handle model, se_box_3d *out_bounds) {
+	se_context *ctx = se_current_context();
+	se_model *model_ptr = se_model_from_handle(ctx, model);
+	if (!model_ptr || !out_bounds) {
+		se_set_last_error(SE_RESULT_INVALID_ARGUMENT);
+		return false;
+	}
+	b8 has_bounds = false;
+	se_mesh *mesh = NULL;
+	s_foreach(&model_ptr->meshes, mesh) {
+		if (!mesh->has_bounds) {
+			continue;
+		}
+		se_box_3d mesh_bounds = {0};
+		se_box_3d_transform(&mesh_bounds, &mesh->bounds, &mesh->matrix);
+		if (has_bounds) {
+			se_box_3d_merge(out_bounds, &mesh_bounds);
+		} else {
+			*out_bounds = mesh_bounds;
+			has_bounds = true;
+		}
+	}
+	se_set_last_error(has_bounds ? SE_RESULT_OK : SE_RESULT_NOT_FOUND);
+	return has_bounds;
+}
+
+void se_mesh_compute_bounds(se_mesh *mesh) {
+	s_assertf(mesh, "se_mesh_compute_bounds :: mesh is null");
+	const sz vertex_count = s_array_get_size(&mesh->cpu.vertices);
+	mesh->has_bounds = vertex_count > 0;
+	if (!mesh->has_bounds) {
+		return;
+	}
+	const se_vertex_3d *vertices = s_array_get_data(&mesh->cpu.vertices);
+	mesh->bounds.min = vertices[0].position;
+	mesh->bounds.max = vertices[0].position;
+	for (sz i = 1; i < vertex_count; ++i) {
+		const se_box_3d point = { vertices[i].position, vertices[i].position };
+		se_box_3d_merge(&mesh->bounds, &point);
+	}
+}
+
 void se_mesh_instance_create(se_mesh_instance *out_instance, const se_mesh *mesh, const u32 instance_count) {
 	s_assertf(out_instance, "se_mesh_instance_create :: out_instance is null");
 	s_assertf(mesh, "se_mesh_instance_create :: mesh is null");
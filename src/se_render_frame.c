@@ -2,9 +2,38 @@
 
 #include "se_render_frame.h"
 
+#include "render/se_gl_stream.h"
 #include "render/se_render_queue.h"
 #include "se_defines.h"
 
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define SE_RENDER_BUCKET_ALIGN_BYTES ((u32)sizeof(void*))
+#define SE_RENDER_BUCKET_RADIX_BITS 8u
+#define SE_RENDER_BUCKET_RADIX_SIZE (1u << SE_RENDER_BUCKET_RADIX_BITS)
+#define SE_RENDER_BUCKET_RADIX_PASSES (64u / SE_RENDER_BUCKET_RADIX_BITS)
+
+typedef struct {
+	se_render_bucket_draw_fn fn;
+	u32 payload_offset;
+} se_render_bucket_draw;
+
+struct se_render_bucket {
+	se_render_bucket_draw* draws;
+	u64* keys;
+	u32* order;
+	// Ping-pong buffers for the radix passes.
+	u64* sort_keys;
+	u32* sort_order;
+	u8* payload_bytes;
+	u32 draw_count;
+	u32 max_draws;
+	u32 payload_used;
+	u32 max_payload_bytes;
+};
+
 void se_render_frame_begin(const se_window_handle window) {
 	if (window == S_HANDLE_NULL) {
 		se_set_last_error(SE_RESULT_INVALID_ARGUMENT);
@@ -18,6 +47,7 @@ void se_render_frame_submit(const se_window_handle window) {
 		se_set_last_error(SE_RESULT_INVALID_ARGUMENT);
 		return;
 	}
+	se_gl_stream_end_frame();
 	se_render_queue_submit_frame(window);
 }
 
@@ -35,3 +65,502 @@ b8 se_render_frame_get_stats(const se_window_handle window, se_render_frame_stat
 	}
 	return se_render_queue_get_frame_stats(window, out_stats);
 }
+
+b8 se_render_frame_secondary_begin(const se_window_handle window, const u32 slot) {
+	if (window == S_HANDLE_NULL) {
+		se_set_last_error(SE_RESULT_INVALID_ARGUMENT);
+		return false;
+	}
+	return se_render_queue_secondary_begin(window, slot);
+}
+
+b8 se_render_frame_secondary_end(void) {
+	return se_render_queue_secondary_end();
+}
+
+b8 se_render_frame_execute_secondary(const se_window_handle window, const u32 slot) {
+	if (window == S_HANDLE_NULL) {
+		se_set_last_error(SE_RESULT_INVALID_ARGUMENT);
+		return false;
+	}
+	return se_render_queue_record_secondary(window, slot);
+}
+
+static u32 se_render_sort_key_depth(const f32 depth, const u32 bits) {
+	// NaN fails every comparison, so test for "not above zero" to map it to the near plane.
+	const f32 clamped = !(depth > 0.0f) ? 0.0f : (depth > 1.0f ? 1.0f : depth);
+	const u64 max_value = (1ull << bits) - 1ull;
+	return (u32)((f64)clamped * (f64)max_value);
+}
+
+u64 se_render_sort_key_opaque(const u32 layer, const u32 pass, const u32 shader, const u32 material, const f32 depth) {
+	return ((u64)(layer & 0xFu) << 60) |
+		((u64)(pass & 0xFu) << 56) |
+		((u64)(shader & 0xFFFFu) << 39) |
+		((u64)(material & 0xFFFFFu) << 19) |
+		(u64)se_render_sort_key_depth(depth, 19u);
+}
+
+u64 se_render_sort_key_translucent(const u32 layer, const u32 pass, const f32 depth, const u32 shader) {
+	const u32 inverted_depth = 0xFFFFFFFFu - se_render_sort_key_depth(depth, 32u);
+	return ((u64)(layer & 0xFu) << 60) |
+		((u64)(pass & 0xFu) << 56) |
+		(1ull << 55) |
+		((u64)inverted_depth << 23) |
+		(u64)(shader & 0x7FFFFFu);
+}
+
+b8 se_render_sort_key_is_translucent(const u64 key) {
+	return (key >> 55) & 1ull;
+}
+
+se_render_bucket* se_render_bucket_create(const se_render_bucket_config* config) {
+	const se_render_bucket_config defaults = SE_RENDER_BUCKET_CONFIG_DEFAULTS;
+	const se_render_bucket_config cfg = config ? *config : defaults;
+	if (cfg.max_draws == 0u) {
+		se_set_last_error(SE_RESULT_INVALID_ARGUMENT);
+		return NULL;
+	}
+	se_render_bucket* bucket = (se_render_bucket*)calloc(1u, sizeof(*bucket));
+	if (!bucket) {
+		se_set_last_error(SE_RESULT_OUT_OF_MEMORY);
+		return NULL;
+	}
+	bucket->max_draws = cfg.max_draws;
+	bucket->max_payload_bytes = cfg.max_payload_bytes;
+	bucket->draws = (se_render_bucket_draw*)malloc(sizeof(*bucket->draws) * (sz)cfg.max_draws);
+	bucket->keys = (u64*)malloc(sizeof(*bucket->keys) * (sz)cfg.max_draws);
+	bucket->order = (u32*)malloc(sizeof(*bucket->order) * (sz)cfg.max_draws);
+	bucket->sort_keys = (u64*)malloc(sizeof(*bucket->sort_keys) * (sz)cfg.max_draws);
+	bucket->sort_order = (u32*)malloc(sizeof(*bucket->sort_order) * (sz)cfg.max_draws);
+	bucket->payload_bytes = cfg.max_payload_bytes > 0u ? (u8*)malloc((sz)cfg.max_payload_bytes) : NULL;
+	if (!bucket->draws || !bucket->keys || !bucket->order || !bucket->sort_keys || !bucket->sort_order ||
+		(cfg.max_payload_bytes > 0u && !bucket->payload_bytes)) {
+		se_render_bucket_destroy(bucket);
+		se_set_last_error(SE_RESULT_OUT_OF_MEMORY);
+		return NULL;
+	}
+	se_set_last_error(SE_RESULT_OK);
+	return bucket;
+}
+
+void se_render_bucket_destroy(se_render_bucket* bucket) {
+	if (!bucket) {
+		return;
+	}
+	free(bucket->draws);
+	free(bucket->keys);
+	free(bucket->order);
+	free(bucket->sort_keys);
+	free(bucket->sort_order);
+	free(bucket->payload_bytes);
+	free(bucket);
+}
+
+b8 se_render_bucket_push(se_render_bucket* bucket, const u64 key, const se_render_bucket_draw_fn fn, const void* payload, const u32 payload_bytes) {
+	if (!bucket || !fn || (payload_bytes > 0u && !payload)) {
+		se_set_last_error(SE_RESULT_INVALID_ARGUMENT);
+		return false;
+	}
+	const u32 align = SE_RENDER_BUCKET_ALIGN_BYTES;
+	const u32 offset = (bucket->payload_used + align - 1u) & ~(align - 1u);
+	if (bucket->draw_count >= bucket->max_draws ||
+		offset > bucket->max_payload_bytes ||
+		payload_bytes > bucket->max_payload_bytes - offset) {
+		se_set_last_error(SE_RESULT_CAPACITY_EXCEEDED);
+		return false;
+	}
+	if (payload_bytes > 0u) {
+		memcpy(bucket->payload_bytes + offset, payload, payload_bytes);
+		bucket->payload_used = offset + payload_bytes;
+	}
+	const u32 index = bucket->draw_count++;
+	bucket->draws[index].fn = fn;
+	bucket->draws[index].payload_offset = payload_bytes > 0u ? offset : 0u;
+	bucket->keys[index] = key;
+	bucket->order[index] = index;
+	se_set_last_error(SE_RESULT_OK);
+	return true;
+}
+
+// LSD radix sort over 8-bit digits; passes whose digit is the same for every key are skipped,
+// so keys that only use a few fields cost only those passes.
+static void se_render_bucket_sort(se_render_bucket* bucket) {
+	const u32 count = bucket->draw_count;
+	if (count < 2u) {
+		return;
+	}
+	u32 histograms[SE_RENDER_BUCKET_RADIX_PASSES][SE_RENDER_BUCKET_RADIX_SIZE];
+	memset(histograms, 0, sizeof(histograms));
+	for (u32 i = 0u; i < count; ++i) {
+		const u64 key = bucket->keys[i];
+		for (u32 pass = 0u; pass < SE_RENDER_BUCKET_RADIX_PASSES; ++pass) {
+			histograms[pass][(key >> (pass * SE_RENDER_BUCKET_RADIX_BITS)) & (SE_RENDER_BUCKET_RADIX_SIZE - 1u)]++;
+		}
+	}
+
+	u64* src_keys = bucket->keys;
+	u32* src_order = bucket->order;
+	u64* dst_keys = bucket->sort_keys;
+	u32* dst_order = bucket->sort_order;
+	for (u32 pass = 0u; pass < SE_RENDER_BUCKET_RADIX_PASSES; ++pass) {
+		u32* histogram = histograms[pass];
+		const u32 shift = pass * SE_RENDER_BUCKET_RADIX_BITS;
+		if (histogram[(src_keys[0] >> shift) & (SE_RENDER_BUCKET_RADIX_SIZE - 1u)] == count) {
+			continue;
+		}
+		u32 sum = 0u;
+		for (u32 digit = 0u; digit < SE_RENDER_BUCKET_RADIX_SIZE; ++digit) {
+			const u32 digit_count = histogram[digit];
+			histogram[digit] = sum;
+			sum += digit_count;
+		}
+		for (u32 i = 0u; i < count; ++i) {
+			const u32 digit = (u32)((src_keys[i] >> shift) & (SE_RENDER_BUCKET_RADIX_SIZE - 1u));
+			const u32 slot = histogram[digit]++;
+			dst_keys[slot] = src_keys[i];
+			dst_order[slot] = src_order[i];
+		}
+		u64* swap_keys = src_keys;
+		src_keys = dst_keys;
+		dst_keys = swap_keys;
+		u32* swap_order = src_order;
+		src_order = dst_order;
+		dst_order = swap_order;
+	}
+	// An odd number of executed passes leaves the result in the scratch buffers.
+	if (src_keys != bucket->keys) {
+		bucket->sort_keys = bucket->keys;
+		bucket->sort_order = bucket->order;
+		bucket->keys = src_keys;
+		bucket->order = src_order;
+	}
+}
+
+b8 se_render_bucket_flush(se_render_bucket* bucket) {
+	if (!bucket) {
+		se_set_last_error(SE_RESULT_INVALID_ARGUMENT);
+		return false;
+	}
+	se_render_bucket_sort(bucket);
+	for (u32 i = 0u; i < bucket->draw_count; ++i) {
+		const se_render_bucket_draw* draw = &bucket->draws[bucket->order[i]];
+		draw->fn(bucket->payload_bytes ? bucket->payload_bytes + draw->payload_offset : NULL);
+	}
+	se_render_bucket_clear(bucket);
+	se_set_last_error(SE_RESULT_OK);
+	return true;
+}
+
+void se_render_bucket_clear(se_render_bucket* bucket) {
+	if (!bucket) {
+		return;
+	}
+	bucket->draw_count = 0u;
+	bucket->payload_used = 0u;
+}
+
+u32 se_render_bucket_get_count(const se_render_bucket* bucket) {
+	return bucket ? bucket->draw_count : 0u;
+}
+
+typedef struct {
+	u32 shader_rank;
+	u32 mesh;
+	u32 instance_count;
+	u32 user;
+} se_draw_batcher_draw;
+
+struct se_draw_batcher {
+	u32 max_meshes;
+	u32 max_draws;
+	se_draw_batch_mesh* meshes;
+	u32 mesh_count;
+	u32 vertex_total;
+	u32 index_total;
+	u32* mesh_table;
+	u32 mesh_table_mask;
+	u32* shader_table;
+	u32 shader_table_mask;
+	se_draw_batcher_draw* draws;
+	se_draw_batcher_draw* sorted_draws;
+	u32 draw_count;
+	u32* counts;
+	se_draw_indirect_command* commands;
+	u32 command_count;
+	se_draw_batch* batches;
+	u32 batch_count;
+	u32* draw_order;
+};
+
+static u32 se_draw_batcher_table_size(const u32 entries) {
+	u32 size = 16u;
+	while (size < entries * 2u) {
+		size <<= 1u;
+	}
+	return size;
+}
+
+static u32 se_draw_batcher_hash(const u64 key) {
+	u64 h = key * 0x9E3779B97F4A7C15ull;
+	return (u32)(h >> 32);
+}
+
+se_draw_batcher* se_draw_batcher_create(const se_draw_batcher_config* config) {
+	const se_draw_batcher_config defaults = SE_DRAW_BATCHER_CONFIG_DEFAULTS;
+	const se_draw_batcher_config cfg = config ? *config : defaults;
+	if (cfg.max_meshes == 0u || cfg.max_draws == 0u || cfg.max_meshes > 0x40000000u || cfg.max_draws > 0x40000000u) {
+		se_set_last_error(SE_RESULT_INVALID_ARGUMENT);
+		return NULL;
+	}
+	se_draw_batcher* batcher = (se_draw_batcher*)calloc(1u, sizeof(*batcher));
+	if (!batcher) {
+		se_set_last_error(SE_RESULT_OUT_OF_MEMORY);
+		return NULL;
+	}
+	const u32 mesh_table_size = se_draw_batcher_table_size(cfg.max_meshes);
+	const u32 shader_table_size = se_draw_batcher_table_size(cfg.max_draws);
+	const u32 count_size = cfg.max_meshes > cfg.max_draws ? cfg.max_meshes : cfg.max_draws;
+	batcher->max_meshes = cfg.max_meshes;
+	batcher->max_draws = cfg.max_draws;
+	batcher->mesh_table_mask = mesh_table_size - 1u;
+	batcher->shader_table_mask = shader_table_size - 1u;
+	batcher->meshes = (se_draw_batch_mesh*)malloc(sizeof(*batcher->meshes) * (sz)cfg.max_meshes);
+	batcher->mesh_table = (u32*)calloc((sz)mesh_table_size, sizeof(*batcher->mesh_table));
+	batcher->shader_table = (u32*)calloc((sz)shader_table_size, sizeof(*batcher->shader_table));
+	batcher->draws = (se_draw_batcher_draw*)malloc(sizeof(*batcher->draws) * (sz)cfg.max_draws);
+	batcher->sorted_draws = (se_draw_batcher_draw*)malloc(sizeof(*batcher->sorted_draws) * (sz)cfg.max_draws);
+	batcher->counts = (u32*)malloc(sizeof(*batcher->counts) * (sz)count_size);
+	batcher->commands = (se_draw_indirect_command*)malloc(sizeof(*batcher->commands) * (sz)cfg.max_draws);
+	batcher->batches = (se_draw_batch*)malloc(sizeof(*batcher->batches) * (sz)cfg.max_draws);
+	batcher->draw_order = (u32*)malloc(sizeof(*batcher->draw_order) * (sz)cfg.max_draws);
+	if (!batcher->meshes || !batcher->mesh_table || !batcher->shader_table || !batcher->draws ||
+		!batcher->sorted_draws || !batcher->counts || !batcher->commands || !batcher->batches || !batcher->draw_order) {
+		se_draw_batcher_destroy(batcher);
+		se_set_last_error(SE_RESULT_OUT_OF_MEMORY);
+		return NULL;
+	}
+	se_set_last_error(SE_RESULT_OK);
+	return batcher;
+}
+
+void se_draw_batcher_destroy(se_draw_batcher* batcher) {
+	if (!batcher) {
+		return;
+	}
+	free(batcher->meshes);
+	free(batcher->mesh_table);
+	free(batcher->shader_table);
+	free(batcher->draws);
+	free(batcher->sorted_draws);
+	free(batcher->counts);
+	free(batcher->commands);
+	free(batcher->batches);
+	free(batcher->draw_order);
+	free(batcher);
+}
+
+u32 se_draw_batcher_add_mesh(se_draw_batcher* batcher, const u64 key, const u32 vertex_count, const u32 index_count) {
+	if (!batcher || vertex_count == 0u || index_count == 0u) {
+		se_set_last_error(SE_RESULT_INVALID_ARGUMENT);
+		return UINT32_MAX;
+	}
+	u32 slot = se_draw_batcher_hash(key) & batcher->mesh_table_mask;
+	while (batcher->mesh_table[slot] != 0u) {
+		const se_draw_batch_mesh* mesh = &batcher->meshes[batcher->mesh_table[slot] - 1u];
+		if (mesh->key == key) {
+			se_set_last_error(SE_RESULT_OK);
+			return batcher->mesh_table[slot] - 1u;
+		}
+		slot = (slot + 1u) & batcher->mesh_table_mask;
+	}
+	if (batcher->mesh_count >= batcher->max_meshes ||
+		vertex_count > UINT32_MAX - batcher->vertex_total ||
+		index_count > UINT32_MAX - batcher->index_total) {
+		se_set_last_error(SE_RESULT_CAPACITY_EXCEEDED);
+		return UINT32_MAX;
+	}
+	const u32 index = batcher->mesh_count++;
+	se_draw_batch_mesh* mesh = &batcher->meshes[index];
+	mesh->key = key;
+	mesh->vertex_count = vertex_count;
+	mesh->index_count = index_count;
+	mesh->first_vertex = batcher->vertex_total;
+	mesh->first_index = batcher->index_total;
+	batcher->vertex_total += vertex_count;
+	batcher->index_total += index_count;
+	batcher->mesh_table[slot] = index + 1u;
+	se_set_last_error(SE_RESULT_OK);
+	return index;
+}
+
+// Shader ranks are handed out in first-use order; batches[rank].shader remembers the shader.
+static u32 se_draw_batcher_shader_rank(se_draw_batcher* batcher, const u64 shader) {
+	u32 slot = se_draw_batcher_hash(shader) & batcher->shader_table_mask;
+	while (batcher->shader_table[slot] != 0u) {
+		const u32 rank = batcher->shader_table[slot] - 1u;
+		if (batcher->batches[rank].shader == shader) {
+			return rank;
+		}
+		slot = (slot + 1u) & batcher->shader_table_mask;
+	}
+	const u32 rank = batcher->batch_count++;
+	memset(&batcher->batches[rank], 0, sizeof(batcher->batches[rank]));
+	batcher->batches[rank].shader = shader;
+	batcher->shader_table[slot] = rank + 1u;
+	return rank;
+}
+
+b8 se_draw_batcher_add_draw(se_draw_batcher* batcher, const u64 shader, const u32 mesh, const u32 instance_count, const u32 user) {
+	if (!batcher || mesh >= batcher->mesh_count || instance_count == 0u) {
+		se_set_last_error(SE_RESULT_INVALID_ARGUMENT);
+		return false;
+	}
+	if (batcher->draw_count >= batcher->max_draws) {
+		se_set_last_error(SE_RESULT_CAPACITY_EXCEEDED);
+		return false;
+	}
+	se_draw_batcher_draw* draw = &batcher->draws[batcher->draw_count++];
+	draw->shader_rank = se_draw_batcher_shader_rank(batcher, shader);
+	draw->mesh = mesh;
+	draw->instance_count = instance_count;
+	draw->user = user;
+	batcher->command_count = 0u;
+	se_set_last_error(SE_RESULT_OK);
+	return true;
+}
+
+// Two stable counting sorts: by mesh, then by shader rank.
+static void se_draw_batcher_sort(se_draw_batcher* batcher) {
+	const u32 count = batcher->draw_count;
+	se_draw_batcher_draw* src = batcher->draws;
+	se_draw_batcher_draw* dst = batcher->sorted_draws;
+	u32* counts = batcher->counts;
+
+	memset(counts, 0, sizeof(*counts) * (sz)batcher->mesh_count);
+	for (u32 i = 0u; i < count; ++i) {
+		counts[src[i].mesh]++;
+	}
+	u32 sum = 0u;
+	for (u32 i = 0u; i < batcher->mesh_count; ++i) {
+		const u32 c = counts[i];
+		counts[i] = sum;
+		sum += c;
+	}
+	for (u32 i = 0u; i < count; ++i) {
+		dst[counts[src[i].mesh]++] = src[i];
+	}
+
+	memset(counts, 0, sizeof(*counts) * (sz)batcher->batch_count);
+	for (u32 i = 0u; i < count; ++i) {
+		counts[dst[i].shader_rank]++;
+	}
+	sum = 0u;
+	for (u32 i = 0u; i < batcher->batch_count; ++i) {
+		const u32 c = counts[i];
+		counts[i] = sum;
+		sum += c;
+	}
+	for (u32 i = 0u; i < count; ++i) {
+		src[counts[dst[i].shader_rank]++] = dst[i];
+	}
+}
+
+b8 se_draw_batcher_build(se_draw_batcher* batcher) {
+	if (!batcher) {
+		se_set_last_error(SE_RESULT_INVALID_ARGUMENT);
+		return false;
+	}
+	se_draw_batcher_sort(batcher);
+	batcher->command_count = 0u;
+	u32 base_instance = 0u;
+	se_draw_indirect_command* command = NULL;
+	u32 command_rank = UINT32_MAX;
+	u32 command_mesh = UINT32_MAX;
+	for (u32 i = 0u; i < batcher->draw_count; ++i) {
+		const se_draw_batcher_draw* draw = &batcher->draws[i];
+		se_draw_batch* batch = &batcher->batches[draw->shader_rank];
+		if (draw->shader_rank != command_rank || draw->mesh != command_mesh) {
+			const se_draw_batch_mesh* mesh = &batcher->meshes[draw->mesh];
+			if (draw->shader_rank != command_rank) {
+				batch->first_command = batcher->command_count;
+				batch->command_count = 0u;
+				batch->instance_count = 0u;
+			}
+			command = &batcher->commands[batcher->command_count++];
+			command->count = mesh->index_count;
+			command->instance_count = 0u;
+			command->first_index = mesh->first_index;
+			command->base_vertex = (i32)mesh->first_vertex;
+			command->base_instance = base_instance;
+			batch->command_count++;
+			command_rank = draw->shader_rank;
+			command_mesh = draw->mesh;
+		}
+		command->instance_count += draw->instance_count;
+		batch->instance_count += draw->instance_count;
+		base_instance += draw->instance_count;
+		batcher->draw_order[i] = draw->user;
+	}
+	se_set_last_error(SE_RESULT_OK);
+	return true;
+}
+
+const se_draw_batch_mesh* se_draw_batcher_get_meshes(const se_draw_batcher* batcher, u32* out_count, u32* out_vertex_total, u32* out_index_total) {
+	if (out_count) {
+		*out_count = batcher ? batcher->mesh_count : 0u;
+	}
+	if (out_vertex_total) {
+		*out_vertex_total = batcher ? batcher->vertex_total : 0u;
+	}
+	if (out_index_total) {
+		*out_index_total = batcher ? batcher->index_total : 0u;
+	}
+	return batcher ? batcher->meshes : NULL;
+}
+
+const se_draw_indirect_command* se_draw_batcher_get_commands(const se_draw_batcher* batcher, u32* out_count) {
+	if (out_count) {
+		*out_count = batcher ? batcher->command_count : 0u;
+	}
+	return batcher ? batcher->commands : NULL;
+}
+
+const se_draw_batch* se_draw_batcher_get_batches(const se_draw_batcher* batcher, u32* out_count) {
+	if (out_count) {
+		*out_count = batcher && batcher->command_count > 0u ? batcher->batch_count : 0u;
+	}
+	return batcher ? batcher->batches : NULL;
+}
+
+const u32* se_draw_batcher_get_draw_order(const se_draw_batcher* batcher, u32* out_count) {
+	if (out_count) {
+		*out_count = batcher && batcher->command_count > 0u ? batcher->draw_count : 0u;
+	}
+	return batcher ? batcher->draw_order : NULL;
+}
+
+void se_draw_batcher_clear_draws(se_draw_batcher* batcher) {
+	if (!batcher) {
+		return;
+	}
+	if (batcher->batch_count > 0u) {
+		memset(batcher->shader_table, 0, sizeof(*batcher->shader_table) * (sz)(batcher->shader_table_mask + 1u));
+	}
+	batcher->draw_count = 0u;
+	batcher->command_count = 0u;
+	batcher->batch_count = 0u;
+}
+
+void se_draw_batcher_clear(se_draw_batcher* batcher) {
+	if (!batcher) {
+		return;
+	}
+	se_draw_batcher_clear_draws(batcher);
+	if (batcher->mesh_count > 0u) {
+		memset(batcher->mesh_table, 0, sizeof(*batcher->mesh_table) * (sz)(batcher->mesh_table_mask + 1u));
+	}
+	batcher->mesh_count = 0u;
+	batcher->vertex_total = 0u;
+	batcher->index_total = 0u;
+}
@@ -2,6 +2,7 @@
 
 #include "se_render_thread.h"
 
+#include "render/se_render_capture.h"
 #include "render/se_render_queue.h"
 #include "se_defines.h"
 
@@ -58,3 +59,34 @@ b8 se_render_thread_get_diagnostics(const se_render_thread_handle thread, se_ren
 	}
 	return se_render_queue_get_diagnostics(window, out_diag);
 }
+
+const c8* se_render_thread_set_caller_tag(const c8* tag) {
+	return se_render_queue_set_caller_tag(tag);
+}
+
+b8 se_render_thread_capture_begin(const se_render_thread_handle thread, const c8* path, const u32 frame_count) {
+	if (thread != SE_RENDER_THREAD_SINGLETON_HANDLE || path == NULL) {
+		se_set_last_error(SE_RESULT_INVALID_ARGUMENT);
+		return false;
+	}
+	const se_window_handle window = se_render_queue_active_window();
+	if (window == S_HANDLE_NULL) {
+		se_set_last_error(SE_RESULT_NOT_FOUND);
+		return false;
+	}
+	return se_render_queue_capture_begin(window, path, frame_count);
+}
+
+void se_render_thread_capture_end(const se_render_thread_handle thread) {
+	if (thread != SE_RENDER_THREAD_SINGLETON_HANDLE) {
+		return;
+	}
+	const se_window_handle window = se_render_queue_active_window();
+	if (window != S_HANDLE_NULL) {
+		se_render_queue_capture_end(window);
+	}
+}
+
+b8 se_render_thread_replay_capture(const c8* path, const u32 iterations, se_render_thread_capture_report* out_report) {
+	return se_render_capture_replay(path, iterations, out_report);
+}
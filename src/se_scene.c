@@ -6,15 +6,22 @@
 #include "se_resource_io.h"
 #include "syphax/s_files.h"
 #include "syphax/s_json.h"
+#include "se_ext.h"
+#include "se_render_frame.h"
+#include "se_bvh.h"
 #include "render/se_gl.h"
+#include "render/se_gl_stream.h"
 #include <float.h>
 #include <math.h>
+#include <stdint.h>
 #include <stdlib.h>
 #include <string.h>
 
 // Scene/object memory is owned by the se_context arrays.
 
 #define SE_OBJECT_2D_VERTEX_SHADER_PATH SE_RESOURCE_INTERNAL("shaders/object_2d_vertex.glsl")
+#define SE_SCENE_3D_DEPTH_VERTEX_SHADER_PATH SE_RESOURCE_INTERNAL("shaders/scene_3d_depth_vert.glsl")
+#define SE_SCENE_3D_DEPTH_FRAGMENT_SHADER_PATH SE_RESOURCE_INTERNAL("shaders/scene_3d_depth_frag.glsl")
 #define SE_SCENE_2D_JSON_FORMAT "se_scene_2d_json"
 #define SE_SCENE_3D_JSON_FORMAT "se_scene_3d_json"
 #define SE_OBJECT_2D_JSON_FORMAT "se_object_2d_json"
@@ -28,6 +35,8 @@ enum {
 	SE_OBJECT_3D_JSON_VERSION = 1u
 };
 
+static void se_scene_spatial_destroy(struct se_scene_spatial* spatial);
+
 static void se_scene_json_serialize_path(const c8* input_path, c8* out_path, const sz out_path_size) {
 	if (!out_path || out_path_size == 0) {
 		return;
@@ -823,6 +832,20 @@ static b8 se_scene_3d_model_get_source_path(const se_model* model, const c8** ou
 	return *out_path != NULL;
 }
 
+static b8 se_scene_3d_object_index_of(const se_objects_3d_ptr* objects, const se_object_3d_handle object, u32* out_index) {
+	if (!objects || !out_index || object == S_HANDLE_NULL) {
+		return false;
+	}
+	for (u32 i = 0; i < (u32)s_array_get_size((se_objects_3d_ptr*)objects); ++i) {
+		const se_object_3d_handle* current = s_array_get((se_objects_3d_ptr*)objects, s_array_handle((se_objects_3d_ptr*)objects, i));
+		if (current && *current == object) {
+			*out_index = i;
+			return true;
+		}
+	}
+	return false;
+}
+
 static b8 se_scene_3d_model_index_of(const se_models_ptr* models, const se_model_handle model, u32* out_index) {
 	if (!models || !out_index) {
 		return false;
@@ -992,44 +1015,226 @@ static b8 se_mat4_near_equal(const s_mat4* a, const s_mat4* b, const f32 epsilon
 	return true;
 }
 
-static void se_instances_push_free_index(se_instance_ids* free_indices, const sz index) {
-	if (!free_indices) {
-		return;
+#define se_instances_slot(array, index) s_array_get((array), s_array_handle((array), (u32)(index)))
+
+// Positions are grown lazily, so slots past the end read as active.
+static i32 se_instances_free_position(se_instance_ids* free_positions, const sz index) {
+	return index < s_array_get_size(free_positions) ? *se_instances_slot(free_positions, index) : -1;
+}
+
+static void se_instances_set_free_position(se_instance_ids* free_positions, const sz index, const i32 position) {
+	while (s_array_get_size(free_positions) <= index) {
+		se_instance_id none = -1;
+		s_array_add(free_positions, none);
 	}
-	for (sz i = 0; i < s_array_get_size(free_indices); ++i) {
-		se_instance_id* existing = s_array_get(free_indices, s_array_handle(free_indices, (u32)i));
-		if (existing && *existing == (se_instance_id)index) {
-			return;
-		}
+	*se_instances_slot(free_positions, index) = position;
+}
+
+static void se_instances_clear_free_indices(se_instance_ids* free_indices, se_instance_ids* free_positions) {
+	se_instance_ids_clear_keep_capacity(free_indices);
+	se_instance_ids_clear_keep_capacity(free_positions);
+}
+
+static void se_instances_push_free_index(se_instance_ids* free_indices, se_instance_ids* free_positions, const sz index) {
+	if (se_instances_free_position(free_positions, index) >= 0) {
+		return;
 	}
 	se_instance_id value = (se_instance_id)index;
+	se_instances_set_free_position(free_positions, index, (i32)s_array_get_size(free_indices));
 	s_array_add(free_indices, value);
 }
 
-static b8 se_instances_pop_free_index(se_instance_ids* free_indices, sz* out_index) {
-	if (!free_indices || !out_index || s_array_get_size(free_indices) == 0) {
+static b8 se_instances_pop_free_index(se_instance_ids* free_indices, se_instance_ids* free_positions, sz* out_index) {
+	if (!out_index || s_array_get_size(free_indices) == 0) {
 		return false;
 	}
 	s_handle handle = s_array_handle(free_indices, (u32)(s_array_get_size(free_indices) - 1));
-	se_instance_id* idx = s_array_get(free_indices, handle);
-	if (!idx) {
-		s_array_remove(free_indices, handle);
-		return false;
-	}
-	*out_index = (sz)s_max(*idx, 0);
+	*out_index = (sz)s_max(*s_array_get(free_indices, handle), 0);
 	s_array_remove(free_indices, handle);
+	se_instances_set_free_position(free_positions, *out_index, -1);
 	return true;
 }
 
-static void se_instances_remove_free_index(se_instance_ids* free_indices, const sz index) {
-	if (!free_indices) {
+// Fills the hole with the last entry so removal does not depend on how many slots are free.
+static void se_instances_remove_free_index(se_instance_ids* free_indices, se_instance_ids* free_positions, const sz index) {
+	const i32 position = se_instances_free_position(free_positions, index);
+	if (position < 0) {
 		return;
 	}
-	for (sz i = 0; i < s_array_get_size(free_indices); ++i) {
-		se_instance_id* value = s_array_get(free_indices, s_array_handle(free_indices, (u32)i));
-		if (value && *value == (se_instance_id)index) {
-			s_array_remove(free_indices, s_array_handle(free_indices, (u32)i));
-			return;
+	const sz last = s_array_get_size(free_indices) - 1;
+	const se_instance_id moved = *se_instances_slot(free_indices, last);
+	*se_instances_slot(free_indices, position) = moved;
+	se_instances_set_free_position(free_positions, (sz)moved, position);
+	s_array_remove(free_indices, s_array_handle(free_indices, (u32)last));
+	se_instances_set_free_position(free_positions, index, -1);
+}
+
+static void se_instances_replace_free_index(se_instance_ids* free_indices, se_instance_ids* free_positions, const sz from, const sz to) {
+	const i32 position = se_instances_free_position(free_positions, from);
+	if (position < 0) {
+		return;
+	}
+	*se_instances_slot(free_indices, position) = (se_instance_id)to;
+	se_instances_set_free_position(free_positions, from, -1);
+	se_instances_set_free_position(free_positions, to, position);
+}
+
+// Ids keep the top bit clear so -1 stays the invalid id: 20 index bits and 11 generation bits.
+#define SE_INSTANCE_ID_INDEX_BITS 20u
+#define SE_INSTANCE_ID_INDEX_MASK ((1u << SE_INSTANCE_ID_INDEX_BITS) - 1u)
+#define SE_INSTANCE_ID_GENERATION_MASK ((1u << (31u - SE_INSTANCE_ID_INDEX_BITS)) - 1u)
+// Fresh indices are preferred while fewer released ones than this are queued.
+#define SE_INSTANCE_ID_MIN_FREE 1024u
+
+static u32 se_instance_id_index(const se_instance_id id) {
+	return (u32)id & SE_INSTANCE_ID_INDEX_MASK;
+}
+
+static u32 se_instance_id_generation(const se_instance_id id) {
+	return ((u32)id >> SE_INSTANCE_ID_INDEX_BITS) & SE_INSTANCE_ID_GENERATION_MASK;
+}
+
+static void se_instances_id_map_init(se_instance_id_map* map) {
+	s_array_init(&map->slots);
+	s_array_init(&map->generations);
+	s_array_init(&map->released);
+	s_array_init(&map->reusable);
+}
+
+static void se_instances_id_map_clear(se_instance_id_map* map) {
+	s_array_clear(&map->slots);
+	s_array_clear(&map->generations);
+	s_array_clear(&map->released);
+	s_array_clear(&map->reusable);
+}
+
+static sz se_instances_id_map_capacity(const se_instance_id_map* map) {
+	return s_array_get_capacity(&map->slots) + s_array_get_capacity(&map->generations) +
+		s_array_get_capacity(&map->released) + s_array_get_capacity(&map->reusable);
+}
+
+static void se_instances_id_map_reserve(se_instance_id_map* map, const u32 index) {
+	while (s_array_get_size(&map->slots) <= index) {
+		se_instance_id none = -1;
+		se_instance_id generation = 0;
+		s_array_add(&map->slots, none);
+		s_array_add(&map->generations, generation);
+	}
+}
+
+static sz se_instances_id_free_count(const se_instance_id_map* map) {
+	return s_array_get_size(&map->released) + s_array_get_size(&map->reusable);
+}
+
+static void se_instances_id_push_free(se_instance_id_map* map, const u32 index) {
+	se_instance_id free_index = (se_instance_id)index;
+	s_array_add(&map->released, free_index);
+}
+
+static se_instance_id se_instances_id_pop_last(se_instance_ids* ids) {
+	const s_handle handle = s_array_handle(ids, (u32)(s_array_get_size(ids) - 1));
+	const se_instance_id value = *s_array_get(ids, handle);
+	s_array_remove(ids, handle);
+	return value;
+}
+
+// Oldest released index; the caller checks that one is queued.
+static u32 se_instances_id_pop_free(se_instance_id_map* map) {
+	if (s_array_get_size(&map->reusable) == 0) {
+		while (s_array_get_size(&map->released) > 0) {
+			se_instance_id index = se_instances_id_pop_last(&map->released);
+			s_array_add(&map->reusable, index);
+		}
+	}
+	return (u32)se_instances_id_pop_last(&map->reusable);
+}
+
+static void se_instances_id_clear_free(se_instance_id_map* map) {
+	se_instance_ids_clear_keep_capacity(&map->released);
+	se_instance_ids_clear_keep_capacity(&map->reusable);
+}
+
+// Returns -1 once every index below the id limit is live.
+static se_instance_id se_instances_id_alloc(se_instance_id_map* map, se_instance_id* next_id, const i32 slot) {
+	u32 index = 0u;
+	const sz free_count = se_instances_id_free_count(map);
+	const b8 fresh_left = (u32)*next_id <= SE_INSTANCE_ID_INDEX_MASK;
+	if (free_count >= SE_INSTANCE_ID_MIN_FREE || (free_count > 0 && !fresh_left)) {
+		index = se_instances_id_pop_free(map);
+	} else if (fresh_left) {
+		index = (u32)(*next_id)++;
+	} else {
+		return -1;
+	}
+	se_instances_id_map_reserve(map, index);
+	*se_instances_slot(&map->slots, index) = slot;
+	return (se_instance_id)(((u32)*se_instances_slot(&map->generations, index) << SE_INSTANCE_ID_INDEX_BITS) | index);
+}
+
+static i32 se_instances_id_lookup(se_instance_id_map* map, const se_instance_id id) {
+	const u32 index = se_instance_id_index(id);
+	if (id < 0 || index >= s_array_get_size(&map->slots) ||
+		(u32)*se_instances_slot(&map->generations, index) != se_instance_id_generation(id)) {
+		return -1;
+	}
+	return *se_instances_slot(&map->slots, index);
+}
+
+static void se_instances_id_move(se_instance_id_map* map, const se_instance_id id, const i32 slot) {
+	if (se_instances_id_lookup(map, id) >= 0) {
+		*se_instances_slot(&map->slots, se_instance_id_index(id)) = slot;
+	}
+}
+
+static void se_instances_id_release(se_instance_id_map* map, const se_instance_id id) {
+	if (se_instances_id_lookup(map, id) < 0) {
+		return;
+	}
+	const u32 index = se_instance_id_index(id);
+	se_instance_id* generation = se_instances_slot(&map->generations, index);
+	*generation = (se_instance_id)(((u32)*generation + 1u) & SE_INSTANCE_ID_GENERATION_MASK);
+	*se_instances_slot(&map->slots, index) = -1;
+	se_instances_id_push_free(map, index);
+}
+
+// Releases every live id, so ids handed out before a bulk reset stop resolving.
+static void se_instances_id_release_all(se_instance_id_map* map) {
+	se_instances_id_clear_free(map);
+	for (sz i = 0; i < s_array_get_size(&map->slots); ++i) {
+		se_instance_id* slot = se_instances_slot(&map->slots, i);
+		if (*slot >= 0) {
+			se_instance_id* generation = se_instances_slot(&map->generations, i);
+			*generation = (se_instance_id)(((u32)*generation + 1u) & SE_INSTANCE_ID_GENERATION_MASK);
+			*slot = -1;
+		}
+		se_instances_id_push_free(map, (u32)i);
+	}
+}
+
+// Restores the map from stored ids. Indices below `next_id` that no slot uses become free.
+static void se_instances_id_rebuild(se_instance_id_map* map, se_instance_ids* ids, se_instance_id* next_id) {
+	se_instance_ids_clear_keep_capacity(&map->slots);
+	se_instance_ids_clear_keep_capacity(&map->generations);
+	se_instances_id_clear_free(map);
+	for (sz i = 0; i < s_array_get_size(ids); ++i) {
+		const se_instance_id id = *se_instances_slot(ids, i);
+		if (id < 0) {
+			continue;
+		}
+		const u32 index = se_instance_id_index(id);
+		se_instances_id_map_reserve(map, index);
+		*se_instances_slot(&map->slots, index) = (i32)i;
+		*se_instances_slot(&map->generations, index) = (se_instance_id)se_instance_id_generation(id);
+		if ((u32)*next_id <= index) {
+			*next_id = (se_instance_id)(index + 1u);
+		}
+	}
+	if (*next_id > 0) {
+		se_instances_id_map_reserve(map, (u32)*next_id - 1u);
+	}
+	for (sz i = 0; i < s_array_get_size(&map->slots); ++i) {
+		if (*se_instances_slot(&map->slots, i) < 0) {
+			se_instances_id_push_free(map, (u32)i);
 		}
 	}
 }
@@ -1079,6 +1284,7 @@ static b8 se_object_3d_reserve_storage(se_object_3d* object_ptr, const sz instan
 	s_array_reserve(&object_ptr->render_transforms, instance_capacity);
 	s_array_reserve(&object_ptr->render_buffers, instance_capacity);
 	s_array_reserve(&object_ptr->render_metadata, instance_capacity);
+	s_array_reserve(&object_ptr->visible_instances, instance_capacity);
 	se_object_3d_refresh_mesh_instance_sources(object_ptr);
 	return true;
 }
@@ -1107,6 +1313,283 @@ static void se_object_2d_sync_render_instances(se_object_2d* object_ptr) {
 	object_ptr->quad.instance_buffers_dirty = true;
 }
 
+// `slot` < 0 marks the whole object, which also drops the moved-slot log. The log is dropped
+// too once it outgrows the instance count, since a full refit is cheaper past that point.
+static void se_spatial_log_mark(se_instance_ids* moved, u32* revision, u32* log_revision, const sz slot_count, const i32 slot) {
+	(*revision)++;
+	if (slot < 0 || s_array_get_size(moved) >= s_max((sz)64, slot_count)) {
+		se_instance_ids_clear_keep_capacity(moved);
+		*log_revision = *revision;
+		return;
+	}
+	s_array_add(moved, (se_instance_id)slot);
+}
+
+static void se_object_2d_mark_spatial(se_object_2d* object_ptr, const i32 slot) {
+	if (object_ptr->is_custom) {
+		object_ptr->spatial_revision++;
+		return;
+	}
+	se_spatial_log_mark(&object_ptr->spatial_moved, &object_ptr->spatial_revision, &object_ptr->spatial_log_revision, s_array_get_size(&object_ptr->instances.ids), slot);
+}
+
+static void se_object_3d_mark_spatial(se_object_3d* object_ptr, const i32 slot) {
+	if (object_ptr->is_custom) {
+		return;
+	}
+	se_spatial_log_mark(&object_ptr->spatial_moved, &object_ptr->spatial_revision, &object_ptr->spatial_log_revision, s_array_get_size(&object_ptr->instances.ids), slot);
+}
+
+// Moves the last slot into `index` and drops the last one, so removal is O(1) and the moved
+// instance keeps its id.
+static void se_object_2d_swap_remove_slot(se_object_2d* object_ptr, const sz index) {
+	se_instances_2d* instances = &object_ptr->instances;
+	const sz last = s_array_get_size(&instances->ids) - 1;
+	const se_instance_id removed_id = *se_instances_slot(&instances->ids, index);
+	if (!*se_instances_slot(&instances->actives, index)) {
+		se_instances_remove_free_index(&instances->free_indices, &instances->free_positions, index);
+	}
+	if (index != last) {
+		const b8 last_active = *se_instances_slot(&instances->actives, last);
+		*se_instances_slot(&instances->ids, index) = *se_instances_slot(&instances->ids, last);
+		*se_instances_slot(&instances->transforms, index) = *se_instances_slot(&instances->transforms, last);
+		*se_instances_slot(&instances->buffers, index) = *se_instances_slot(&instances->buffers, last);
+		*se_instances_slot(&instances->actives, index) = last_active;
+		*se_instances_slot(&instances->metadata, index) = *se_instances_slot(&instances->metadata, last);
+		se_instances_id_move(&instances->id_map, *se_instances_slot(&instances->ids, index), (i32)index);
+		if (!last_active) {
+			se_instances_replace_free_index(&instances->free_indices, &instances->free_positions, last, index);
+		}
+	}
+	s_array_remove(&instances->ids, s_array_handle(&instances->ids, (u32)last));
+	s_array_remove(&instances->transforms, s_array_handle(&instances->transforms, (u32)last));
+	s_array_remove(&instances->buffers, s_array_handle(&instances->buffers, (u32)last));
+	s_array_remove(&instances->actives, s_array_handle(&instances->actives, (u32)last));
+	s_array_remove(&instances->metadata, s_array_handle(&instances->metadata, (u32)last));
+	se_instances_id_release(&instances->id_map, removed_id);
+	se_object_2d_mark_spatial(object_ptr, (i32)index);
+	se_object_2d_mark_spatial(object_ptr, (i32)last);
+}
+
+// Level 0 draws with the object's own model and render arrays; the others own theirs.
+typedef struct {
+	se_model_handle model;
+	f32 threshold;
+	se_mesh_instances mesh_instances;
+	se_transforms render_transforms;
+	se_buffers render_buffers;
+	se_buffers render_metadata;
+	se_instance_ids slots;
+	sz capacity;
+} se_object_3d_lod;
+
+typedef struct se_object_3d_lods {
+	se_object_3d_lod levels[SE_OBJECT_3D_MAX_LODS];
+	u32 level_count;
+	se_lod_metric metric;
+	f32 hysteresis;
+	// Level picked last frame per slot, so hysteresis has something to hold on to.
+	u8* instance_levels;
+	sz instance_level_capacity;
+} se_object_3d_lods;
+
+static void se_object_3d_lod_release(se_object_3d_lod* level) {
+	for (sz i = 0; i < s_array_get_size(&level->mesh_instances); ++i) {
+		se_mesh_instance* mesh_instance = s_array_get(&level->mesh_instances, s_array_handle(&level->mesh_instances, (u32)i));
+		se_mesh_instance_destroy(mesh_instance);
+	}
+	s_array_clear(&level->mesh_instances);
+	s_array_clear(&level->render_transforms);
+	s_array_clear(&level->render_buffers);
+	s_array_clear(&level->render_metadata);
+	s_array_clear(&level->slots);
+	memset(level, 0, sizeof(*level));
+}
+
+static void se_object_3d_lods_destroy(se_object_3d* object_ptr) {
+	se_object_3d_lods* lods = object_ptr->lods;
+	if (!lods) {
+		return;
+	}
+	for (u32 i = 1u; i < lods->level_count; ++i) {
+		se_object_3d_lod_release(&lods->levels[i]);
+	}
+	s_array_clear(&lods->levels[0].slots);
+	free(lods->instance_levels);
+	free(lods);
+	object_ptr->lods = NULL;
+}
+
+// Thresholds grow with coarseness. Moving to a coarser level needs the value to pass the
+// threshold by `hysteresis`, and moving back needs it to drop below by the same fraction.
+static u32 se_lod_select(const f32* thresholds, const u32 count, const f32 value, u32 level, const f32 hysteresis) {
+	if (level >= count) {
+		level = count - 1u;
+	}
+	while (level + 1u < count && value >= thresholds[level + 1u] * (1.0f + hysteresis)) {
+		level++;
+	}
+	while (level > 0u && value < thresholds[level] * (1.0f - hysteresis)) {
+		level--;
+	}
+	return level;
+}
+
+// Moves the last slot into `index` and drops the last one, so removal is O(1) and the moved
+// instance keeps its id.
+static void se_object_3d_swap_remove_slot(se_object_3d* object_ptr, const sz index) {
+	se_instances* instances = &object_ptr->instances;
+	const sz last = s_array_get_size(&instances->ids) - 1;
+	const se_instance_id removed_id = *se_instances_slot(&instances->ids, index);
+	if (!*se_instances_slot(&instances->actives, index)) {
+		se_instances_remove_free_index(&instances->free_indices, &instances->free_positions, index);
+	}
+	if (index != last) {
+		const b8 last_active = *se_instances_slot(&instances->actives, last);
+		*se_instances_slot(&instances->ids, index) = *se_instances_slot(&instances->ids, last);
+		*se_instances_slot(&instances->transforms, index) = *se_instances_slot(&instances->transforms, last);
+		*se_instances_slot(&instances->buffers, index) = *se_instances_slot(&instances->buffers, last);
+		*se_instances_slot(&instances->actives, index) = last_active;
+		*se_instances_slot(&instances->metadata, index) = *se_instances_slot(&instances->metadata, last);
+		se_instances_id_move(&instances->id_map, *se_instances_slot(&instances->ids, index), (i32)index);
+		if (!last_active) {
+			se_instances_replace_free_index(&instances->free_indices, &instances->free_positions, last, index);
+		}
+		if (object_ptr->lods && last < object_ptr->lods->instance_level_capacity) {
+			object_ptr->lods->instance_levels[index] = object_ptr->lods->instance_levels[last];
+		}
+	}
+	s_array_remove(&instances->ids, s_array_handle(&instances->ids, (u32)last));
+	s_array_remove(&instances->transforms, s_array_handle(&instances->transforms, (u32)last));
+	s_array_remove(&instances->buffers, s_array_handle(&instances->buffers, (u32)last));
+	s_array_remove(&instances->actives, s_array_handle(&instances->actives, (u32)last));
+	s_array_remove(&instances->metadata, s_array_handle(&instances->metadata, (u32)last));
+	se_instances_id_release(&instances->id_map, removed_id);
+	se_object_3d_mark_spatial(object_ptr, (i32)index);
+	se_object_3d_mark_spatial(object_ptr, (i32)last);
+}
+
+static se_object_3d* se_object_3d_try_get(se_context* ctx, const se_object_3d_handle object) {
+	return se_object_3d_handle_exists(ctx, object) ? se_object_3d_from_handle(ctx, object) : NULL;
+}
+
+static void se_object_3d_mark_children_dirty(se_context* ctx, se_object_3d* object_ptr);
+
+// Roots take their local transform right away; children are resolved lazily by
+// se_object_3d_update_world. A dirty child always has a dirty subtree, so the walk stops there.
+static void se_object_3d_mark_world_dirty(se_context* ctx, se_object_3d* object_ptr, const se_object_3d_handle object) {
+	if (object_ptr->parent == S_HANDLE_NULL) {
+		object_ptr->transform = object_ptr->local_transform;
+		object_ptr->world_dirty = false;
+	} else {
+		object_ptr->world_dirty = true;
+	}
+	se_object_3d_mark_spatial(object_ptr, -1);
+	se_object_3d_set_instances_dirty(object, true);
+	se_object_3d_mark_children_dirty(ctx, object_ptr);
+}
+
+static void se_object_3d_mark_children_dirty(se_context* ctx, se_object_3d* object_ptr) {
+	for (sz i = 0; i < s_array_get_size(&object_ptr->children); ++i) {
+		const se_object_3d_handle child = *s_array_get(&object_ptr->children, s_array_handle(&object_ptr->children, (u32)i));
+		se_object_3d* child_ptr = se_object_3d_try_get(ctx, child);
+		if (child_ptr && !child_ptr->world_dirty) {
+			se_object_3d_mark_world_dirty(ctx, child_ptr, child);
+		}
+	}
+}
+
+static void se_object_3d_update_world(se_context* ctx, se_object_3d* object_ptr) {
+	if (!object_ptr->world_dirty) {
+		return;
+	}
+	object_ptr->world_dirty = false;
+	se_object_3d* parent_ptr = se_object_3d_try_get(ctx, object_ptr->parent);
+	if (!parent_ptr) {
+		object_ptr->transform = object_ptr->local_transform;
+		return;
+	}
+	se_object_3d_update_world(ctx, parent_ptr);
+	s_mat4 parent_world = parent_ptr->transform;
+	if (object_ptr->parent_instance >= 0 && !parent_ptr->is_custom) {
+		const i32 index = se_object_3d_get_instance_index(object_ptr->parent, object_ptr->parent_instance);
+		const b8* active = index >= 0 ? s_array_get(&parent_ptr->instances.actives, s_array_handle(&parent_ptr->instances.actives, (u32)index)) : NULL;
+		if (active && *active) {
+			s_mat4* instance_transform = s_array_get(&parent_ptr->instances.transforms, s_array_handle(&parent_ptr->instances.transforms, (u32)index));
+			parent_world = s_mat4_mul(&parent_world, instance_transform);
+		}
+	}
+	object_ptr->transform = s_mat4_mul(&parent_world, &object_ptr->local_transform);
+}
+
+static void se_scene_3d_update_world_transforms(se_context* ctx, se_scene_3d* scene_ptr) {
+	for (sz i = 0; i < s_array_get_size(&scene_ptr->objects); ++i) {
+		const se_object_3d_handle object = *s_array_get(&scene_ptr->objects, s_array_handle(&scene_ptr->objects, (u32)i));
+		se_object_3d* object_ptr = se_object_3d_try_get(ctx, object);
+		if (object_ptr) {
+			se_object_3d_update_world(ctx, object_ptr);
+		}
+	}
+}
+
+static void se_object_3d_unlink_child(se_context* ctx, const se_object_3d_handle parent, const se_object_3d_handle child) {
+	se_object_3d* parent_ptr = se_object_3d_try_get(ctx, parent);
+	if (!parent_ptr) {
+		return;
+	}
+	for (sz i = 0; i < s_array_get_size(&parent_ptr->children); ++i) {
+		const s_handle handle = s_array_handle(&parent_ptr->children, (u32)i);
+		if (*s_array_get(&parent_ptr->children, handle) == child) {
+			s_array_remove(&parent_ptr->children, handle);
+			return;
+		}
+	}
+}
+
+// Unlinks the object from its parent and turns its children into roots that keep their world
+// transforms.
+static void se_object_3d_detach_hierarchy(se_context* ctx, se_object_3d* object_ptr, const se_object_3d_handle object) {
+	se_object_3d_unlink_child(ctx, object_ptr->parent, object);
+	object_ptr->parent = S_HANDLE_NULL;
+	for (sz i = 0; i < s_array_get_size(&object_ptr->children); ++i) {
+		const se_object_3d_handle child = *s_array_get(&object_ptr->children, s_array_handle(&object_ptr->children, (u32)i));
+		se_object_3d* child_ptr = se_object_3d_try_get(ctx, child);
+		if (!child_ptr) {
+			continue;
+		}
+		se_object_3d_update_world(ctx, child_ptr);
+		child_ptr->local_transform = child_ptr->transform;
+		child_ptr->parent = S_HANDLE_NULL;
+		child_ptr->parent_instance = -1;
+		se_object_3d_mark_world_dirty(ctx, child_ptr, child);
+	}
+	s_array_clear(&object_ptr->children);
+}
+
+static void se_object_3d_refresh_bounds(se_object_3d* object_ptr) {
+	object_ptr->has_bounds = false;
+	se_box_3d local_bounds = {0};
+	if (object_ptr->model == S_HANDLE_NULL || !se_model_get_bounds(object_ptr->model, &local_bounds)) {
+		return;
+	}
+	for (sz i = 0; i < s_array_get_size(&object_ptr->instances.transforms); ++i) {
+		b8* active = s_array_get(&object_ptr->instances.actives, s_array_handle(&object_ptr->instances.actives, (u32)i));
+		if (!active || !*active) {
+			continue;
+		}
+		s_mat4* instance_transform = s_array_get(&object_ptr->instances.transforms, s_array_handle(&object_ptr->instances.transforms, (u32)i));
+		const s_mat4 world = s_mat4_mul(&object_ptr->transform, instance_transform);
+		se_box_3d instance_bounds = {0};
+		se_box_3d_transform(&instance_bounds, &local_bounds, &world);
+		if (object_ptr->has_bounds) {
+			se_box_3d_merge(&object_ptr->bounds, &instance_bounds);
+		} else {
+			object_ptr->bounds = instance_bounds;
+			object_ptr->has_bounds = true;
+		}
+	}
+}
+
 static void se_object_3d_sync_render_instances(se_object_3d* object_ptr) {
 	if (!object_ptr || object_ptr->is_custom) {
 		return;
@@ -1132,6 +1615,23 @@ static void se_object_3d_sync_render_instances(se_object_3d* object_ptr) {
 		s_array_add(&object_ptr->render_metadata, render_metadata);
 	}
 	se_object_3d_refresh_mesh_instance_sources(object_ptr);
+	se_object_3d_refresh_bounds(object_ptr);
+}
+
+// Objects keep only the bytes the payload uses instead of the full SE_OBJECT_CUSTOM_DATA_SIZE.
+static b8 se_object_custom_data_copy(se_object_custom_data* out, const se_object_custom* custom) {
+	out->render = custom->render;
+	out->data_size = custom->data_size;
+	out->data = NULL;
+	if (custom->data_size == 0) {
+		return true;
+	}
+	out->data = malloc(custom->data_size);
+	if (!out->data) {
+		return false;
+	}
+	memcpy(out->data, custom->data, custom->data_size);
+	return true;
 }
 
 se_object_2d_handle se_object_2d_create(const c8 *fragment_shader_path, const s_mat3 *transform, const sz max_instances_count) {
@@ -1144,7 +1644,7 @@ se_object_2d_handle se_object_2d_create(const c8 *fragment_shader_path, const s_
 		s_array_init(&ctx->objects_2d);
 	}
 	if (s_array_get_size(&ctx->objects_2d) >= SE_MAX_2D_OBJECTS) {
-		se_set_last_error(SE_RESULT_OUT_OF_MEMORY);
+		se_set_last_error(SE_RESULT_CAPACITY_EXCEEDED);
 		return S_HANDLE_NULL;
 	}
 	se_object_2d_handle object_handle = s_array_increment(&ctx->objects_2d);
@@ -1182,9 +1682,12 @@ se_object_2d_handle se_object_2d_create(const c8 *fragment_shader_path, const s_
 	s_array_init(&new_object->instances.buffers);
 	s_array_init(&new_object->instances.actives);
 	s_array_init(&new_object->instances.free_indices);
+	s_array_init(&new_object->instances.free_positions);
 	s_array_init(&new_object->instances.metadata);
+	se_instances_id_map_init(&new_object->instances.id_map);
 	s_array_init(&new_object->render_transforms);
 	s_array_init(&new_object->render_buffers);
+	s_array_init(&new_object->spatial_moved);
 	s_array_reserve(&new_object->instances.ids, instance_capacity);
 	s_array_reserve(&new_object->instances.transforms, instance_capacity);
 	s_array_reserve(&new_object->instances.buffers, instance_capacity);
@@ -1201,6 +1704,12 @@ se_object_2d_handle se_object_2d_create(const c8 *fragment_shader_path, const s_
 							 s_array_get_data(&new_object->render_buffers),
 							 instance_capacity);
 	if (max_instances_count == 0) {
+		const se_instance_id first_id = se_instances_id_alloc(&new_object->instances.id_map, &new_object->instances.next_id, 0);
+		if (first_id < 0) {
+			se_object_2d_destroy(object_handle);
+			se_set_last_error(SE_RESULT_CAPACITY_EXCEEDED);
+			return S_HANDLE_NULL;
+		}
 		s_handle id_handle = s_array_increment(&new_object->instances.ids);
 		s_handle transform_handle = s_array_increment(&new_object->instances.transforms);
 		s_handle buffer_handle = s_array_increment(&new_object->instances.buffers);
@@ -1211,12 +1720,11 @@ se_object_2d_handle se_object_2d_create(const c8 *fragment_shader_path, const s_
 		s_mat4 *new_buffer = s_array_get(&new_object->instances.buffers, buffer_handle);
 		b8 *new_active = s_array_get(&new_object->instances.actives, active_handle);
 		s_mat4 *new_metadata = s_array_get(&new_object->instances.metadata, metadata_handle);
-		*new_instance_id = 0;
+		*new_instance_id = first_id;
 		*new_transform = s_mat3_identity;
 		*new_buffer = s_mat4_identity;
 		*new_active = true;
 		*new_metadata = s_mat4_identity;
-		new_object->instances.next_id = 1;
 		se_object_2d_sync_render_instances(new_object);
 		se_object_2d_set_instances_dirty(object_handle, true);
 	}
@@ -1231,11 +1739,17 @@ se_object_2d_handle se_object_2d_create_custom(se_object_custom *custom, const s
 		return S_HANDLE_NULL;
 	}
 	s_assertf(custom->data_size <= SE_OBJECT_CUSTOM_DATA_SIZE, "se_object_2d_create_custom :: data_size exceeds SE_OBJECT_CUSTOM_DATA_SIZE");
+	se_object_custom_data custom_data = {0};
+	if (!se_object_custom_data_copy(&custom_data, custom)) {
+		se_set_last_error(SE_RESULT_OUT_OF_MEMORY);
+		return S_HANDLE_NULL;
+	}
 	if (s_array_get_capacity(&ctx->objects_2d) == 0) {
 		s_array_init(&ctx->objects_2d);
 	}
 	if (s_array_get_size(&ctx->objects_2d) >= SE_MAX_2D_OBJECTS) {
-		se_set_last_error(SE_RESULT_OUT_OF_MEMORY);
+		free(custom_data.data);
+		se_set_last_error(SE_RESULT_CAPACITY_EXCEEDED);
 		return S_HANDLE_NULL;
 	}
 	se_object_2d_handle object_handle = s_array_increment(&ctx->objects_2d);
@@ -1244,7 +1758,7 @@ se_object_2d_handle se_object_2d_create_custom(se_object_custom *custom, const s
 	new_object->transform = *transform;
 	new_object->is_custom = true;
 	new_object->is_visible = true;
-	memcpy(&new_object->custom, custom, sizeof(se_object_custom));
+	new_object->custom = custom_data;
 	se_set_last_error(SE_RESULT_OK);
 	return object_handle;
 }
@@ -1257,12 +1771,44 @@ void se_object_custom_set_data(se_object_custom *custom, const void *data, const
 	custom->data_size = size;
 }
 
+b8 se_object_2d_get_pool_stats(se_object_pool_stats* out_stats) {
+	se_context* ctx = se_current_context();
+	if (!ctx || !out_stats) {
+		se_set_last_error(SE_RESULT_INVALID_ARGUMENT);
+		return false;
+	}
+	memset(out_stats, 0, sizeof(*out_stats));
+	out_stats->count = (u32)s_array_get_size(&ctx->objects_2d);
+	out_stats->capacity = (u32)s_array_get_capacity(&ctx->objects_2d);
+	out_stats->object_bytes = s_array_get_capacity(&ctx->objects_2d) * sizeof(se_object_2d);
+	for (sz i = 0; i < s_array_get_size(&ctx->objects_2d); ++i) {
+		const se_object_2d* object = s_array_get(&ctx->objects_2d, s_array_handle(&ctx->objects_2d, (u32)i));
+		if (!object) {
+			continue;
+		}
+		if (object->is_custom) {
+			out_stats->custom_data_bytes += object->custom.data_size;
+			continue;
+		}
+		out_stats->instance_bytes +=
+			(s_array_get_capacity(&object->instances.ids) + s_array_get_capacity(&object->instances.free_indices) +
+				s_array_get_capacity(&object->instances.free_positions) + se_instances_id_map_capacity(&object->instances.id_map) + s_array_get_capacity(&object->spatial_moved)) * sizeof(se_instance_id) +
+			(s_array_get_capacity(&object->instances.transforms) + s_array_get_capacity(&object->render_transforms)) * sizeof(s_mat3) +
+			(s_array_get_capacity(&object->instances.buffers) + s_array_get_capacity(&object->instances.metadata) + s_array_get_capacity(&object->render_buffers)) * sizeof(s_mat4) +
+			s_array_get_capacity(&object->instances.actives) * sizeof(b8);
+	}
+	se_set_last_error(SE_RESULT_OK);
+	return true;
+}
+
 void se_object_2d_destroy(const se_object_2d_handle object) {
 	se_context *ctx = se_current_context();
 	s_assertf(ctx, "se_object_2d_destroy :: ctx is null");
 	se_object_2d *object_ptr = se_object_2d_from_handle(ctx, object);
 	s_assertf(object_ptr, "se_object_2d_destroy :: object is null");
 	if (object_ptr->is_custom) {
+		free(object_ptr->custom.data);
+		object_ptr->custom.data = NULL;
 		object_ptr->custom.render = NULL;
 		object_ptr->custom.data_size = 0;
 		object_ptr->is_visible = false;
@@ -1283,7 +1829,10 @@ void se_object_2d_destroy(const se_object_2d_handle object) {
 	s_array_clear(&object_ptr->instances.buffers);
 	s_array_clear(&object_ptr->instances.actives);
 	s_array_clear(&object_ptr->instances.free_indices);
+	s_array_clear(&object_ptr->instances.free_positions);
 	s_array_clear(&object_ptr->instances.metadata);
+	se_instances_id_map_clear(&object_ptr->instances.id_map);
+	s_array_clear(&object_ptr->spatial_moved);
 	object_ptr->is_visible = false;
 
 	s_array_remove(&ctx->objects_2d, object);
@@ -1295,6 +1844,7 @@ void se_object_2d_set_transform(const se_object_2d_handle object, const s_mat3 *
 	s_assertf(object_ptr, "se_object_2d_set_transform :: object is null");
 	s_assertf(transform, "se_object_2d_set_transform :: transform is null");
 	object_ptr->transform = *transform;
+	se_object_2d_mark_spatial(object_ptr, -1);
 	se_object_2d_set_instances_dirty(object, true);
 }
 
@@ -1311,6 +1861,7 @@ void se_object_2d_set_position(const se_object_2d_handle object, const s_vec2 *p
 	s_assertf(object_ptr, "se_object_2d_set_position :: object is null");
 	s_assertf(position, "se_object_2d_set_position :: position is null");
 	s_mat3_set_translation(&object_ptr->transform, position);
+	se_object_2d_mark_spatial(object_ptr, -1);
 	se_object_2d_set_instances_dirty(object, true);
 }
 
@@ -1328,6 +1879,7 @@ void se_object_2d_set_scale(const se_object_2d_handle object, const s_vec2 *scal
 	s_assertf(object_ptr, "se_object_2d_set_scale :: object is null");
 	s_assertf(scale, "se_object_2d_set_scale :: scale is null");
 	s_mat3_set_scale(&object_ptr->transform, scale);
+	se_object_2d_mark_spatial(object_ptr, -1);
 	se_object_2d_set_instances_dirty(object, true);
 }
 
@@ -1375,19 +1927,29 @@ se_instance_id se_object_2d_add_instance(const se_object_2d_handle object, const
 	s_assertf(buffer, "se_object_2d_set_instance_add :: buffer is null");
 	const sz max_capacity = s_array_get_capacity(&object_ptr->instances.ids);
 	sz reuse_index = 0;
-	const b8 has_free_slot = se_instances_pop_free_index(&object_ptr->instances.free_indices, &reuse_index);
+	const b8 has_free_slot = se_instances_pop_free_index(&object_ptr->instances.free_indices, &object_ptr->instances.free_positions, &reuse_index);
 	if (!has_free_slot && max_capacity > 0 && s_array_get_size(&object_ptr->instances.ids) >= max_capacity) {
 		se_set_last_error(SE_RESULT_CAPACITY_EXCEEDED);
 		return -1;
 	}
-	const se_instance_id new_id = object_ptr->instances.next_id++;
-	if (has_free_slot && reuse_index < s_array_get_size(&object_ptr->instances.ids)) {
+	const b8 reuse_slot = has_free_slot && reuse_index < s_array_get_size(&object_ptr->instances.ids);
+	const sz slot_index = reuse_slot ? reuse_index : s_array_get_size(&object_ptr->instances.ids);
+	const se_instance_id new_id = se_instances_id_alloc(&object_ptr->instances.id_map, &object_ptr->instances.next_id, (i32)slot_index);
+	if (new_id < 0) {
+		if (has_free_slot) {
+			se_instances_push_free_index(&object_ptr->instances.free_indices, &object_ptr->instances.free_positions, reuse_index);
+		}
+		se_set_last_error(SE_RESULT_CAPACITY_EXCEEDED);
+		return -1;
+	}
+	if (reuse_slot) {
 		se_instance_id* id = s_array_get(&object_ptr->instances.ids, s_array_handle(&object_ptr->instances.ids, (u32)reuse_index));
 		s_mat3* dst_transform = s_array_get(&object_ptr->instances.transforms, s_array_handle(&object_ptr->instances.transforms, (u32)reuse_index));
 		s_mat4* dst_buffer = s_array_get(&object_ptr->instances.buffers, s_array_handle(&object_ptr->instances.buffers, (u32)reuse_index));
 		b8* dst_active = s_array_get(&object_ptr->instances.actives, s_array_handle(&object_ptr->instances.actives, (u32)reuse_index));
 		s_mat4* dst_metadata = s_array_get(&object_ptr->instances.metadata, s_array_handle(&object_ptr->instances.metadata, (u32)reuse_index));
 		if (id && dst_transform && dst_buffer && dst_active && dst_metadata) {
+			se_instances_id_release(&object_ptr->instances.id_map, *id);
 			*id = new_id;
 			*dst_transform = *transform;
 			*dst_buffer = *buffer;
@@ -1404,6 +1966,7 @@ se_instance_id se_object_2d_add_instance(const se_object_2d_handle object, const
 		s_array_add(&object_ptr->instances.metadata, default_metadata);
 	}
 	se_object_2d_sync_render_instances(object_ptr);
+	se_object_2d_mark_spatial(object_ptr, (i32)slot_index);
 	se_object_2d_set_instances_dirty(object, true);
 
 	return new_id;
@@ -1418,12 +1981,8 @@ b8 se_object_2d_remove_instance(const se_object_2d_handle object, const se_insta
 		se_set_last_error(SE_RESULT_NOT_FOUND);
 		return false;
 	}
-	b8* active = s_array_get(&object_ptr->instances.actives, s_array_handle(&object_ptr->instances.actives, (u32)index));
-	if (active && *active) {
-		*active = false;
-		se_instances_push_free_index(&object_ptr->instances.free_indices, (sz)index);
-		se_object_2d_set_instances_dirty(object, true);
-	}
+	se_object_2d_swap_remove_slot(object_ptr, (sz)index);
+	se_object_2d_set_instances_dirty(object, true);
 	se_set_last_error(SE_RESULT_OK);
 	return true;
 }
@@ -1432,20 +1991,10 @@ i32 se_object_2d_get_instance_index(const se_object_2d_handle object, const se_i
 	se_context *ctx = se_current_context();
 	se_object_2d *object_ptr = se_object_2d_from_handle(ctx, object);
 	s_assertf(object_ptr, "se_object_2d_get_instance_index :: object is null");
-	const sz count = s_array_get_size(&object_ptr->instances.ids);
-	if (instance_id >= 0 && (sz)instance_id < count) {
-		se_instance_id *quick = s_array_get(&object_ptr->instances.ids, s_array_handle(&object_ptr->instances.ids, (u32)instance_id));
-		if (quick && *quick == instance_id) {
-			return instance_id;
-		}
-	}
-	for (sz i = 0; i < s_array_get_size(&object_ptr->instances.ids); ++i) {
-		se_instance_id *found_instance = s_array_get(&object_ptr->instances.ids, s_array_handle(&object_ptr->instances.ids, (u32)i));
-		if (*found_instance == instance_id) {
-			return (i32)i;
-		}
+	if (object_ptr->is_custom) {
+		return -1;
 	}
-	return -1;
+	return se_instances_id_lookup(&object_ptr->instances.id_map, instance_id);
 }
 
 void se_object_2d_set_transform_by_id(const se_object_2d_handle object, const se_instance_id instance_id, const s_mat3 *transform) {
@@ -1457,6 +2006,7 @@ void se_object_2d_set_transform_by_id(const se_object_2d_handle object, const se
 	if (index >= 0) {
 		s_mat3 *current_transform = s_array_get(&object_ptr->instances.transforms, s_array_handle(&object_ptr->instances.transforms, (u32)index));
 		*current_transform = *transform;
+		se_object_2d_mark_spatial(object_ptr, index);
 		se_object_2d_set_instances_dirty(object, true);
 		se_set_last_error(SE_RESULT_OK);
 	} else {
@@ -1496,14 +2046,19 @@ void se_object_2d_set_instances_transforms(const se_object_2d_handle object, con
 	se_transforms_2d_clear_keep_capacity(&object_ptr->instances.transforms);
 	se_buffers_clear_keep_capacity(&object_ptr->instances.buffers);
 	se_instance_actives_clear_keep_capacity(&object_ptr->instances.actives);
-	se_instance_ids_clear_keep_capacity(&object_ptr->instances.free_indices);
+	se_instances_clear_free_indices(&object_ptr->instances.free_indices, &object_ptr->instances.free_positions);
 	se_buffers_clear_keep_capacity(&object_ptr->instances.metadata);
+	se_instances_id_release_all(&object_ptr->instances.id_map);
 	for (sz i = 0; i < count; ++i) {
 		const s_mat3 *src_transform = s_array_get((se_transforms_2d *)transforms, s_array_handle((se_transforms_2d *)transforms, (u32)i));
 		if (!src_transform) {
 			continue;
 		}
-		se_instance_id id = (se_instance_id)i;
+		se_instance_id id = se_instances_id_alloc(&object_ptr->instances.id_map, &object_ptr->instances.next_id, (i32)s_array_get_size(&object_ptr->instances.ids));
+		if (id < 0) {
+			se_set_last_error(SE_RESULT_CAPACITY_EXCEEDED);
+			break;
+		}
 		s_mat4 default_buffer = s_mat4_identity;
 		s_mat4 default_metadata = s_mat4_identity;
 		b8 active = true;
@@ -1513,7 +2068,7 @@ void se_object_2d_set_instances_transforms(const se_object_2d_handle object, con
 		s_array_add(&object_ptr->instances.actives, active);
 		s_array_add(&object_ptr->instances.metadata, default_metadata);
 	}
-	object_ptr->instances.next_id = (se_instance_id)count;
+	se_object_2d_mark_spatial(object_ptr, -1);
 	se_object_2d_set_instances_dirty(object, true);
 }
 
@@ -1551,6 +2106,7 @@ void se_object_2d_set_transforms_by_id(const se_object_2d_handle object, const s
 		s_mat3 *current_transform = s_array_get(&object_ptr->instances.transforms, s_array_handle(&object_ptr->instances.transforms, (u32)index));
 		if (current_transform) {
 			*current_transform = transforms[i];
+			se_object_2d_mark_spatial(object_ptr, index);
 		}
 	}
 	se_object_2d_set_instances_dirty(object, true);
@@ -1592,10 +2148,11 @@ b8 se_object_2d_set_active_by_id(const se_object_2d_handle object, const se_inst
 	}
 	*entry = active;
 	if (active) {
-		se_instances_remove_free_index(&object_ptr->instances.free_indices, (sz)index);
+		se_instances_remove_free_index(&object_ptr->instances.free_indices, &object_ptr->instances.free_positions, (sz)index);
 	} else {
-		se_instances_push_free_index(&object_ptr->instances.free_indices, (sz)index);
+		se_instances_push_free_index(&object_ptr->instances.free_indices, &object_ptr->instances.free_positions, (sz)index);
 	}
+	se_object_2d_mark_spatial(object_ptr, index);
 	se_object_2d_set_instances_dirty(object, true);
 	se_set_last_error(SE_RESULT_OK);
 	return true;
@@ -1854,7 +2411,7 @@ b8 se_object_2d_from_json(const se_object_2d_handle object, const s_json* root)
 		return false;
 	}
 
-	i32 max_instance_id = -1;
+	i32 max_instance_index = -1;
 	for (sz slot_index = 0; slot_index < slot_count; ++slot_index) {
 		const s_json* slot_json = s_json_at(instances_json, slot_index);
 		i32 instance_id = 0;
@@ -1872,10 +2429,10 @@ b8 se_object_2d_from_json(const se_object_2d_handle object, const s_json* root)
 			se_set_last_error(SE_RESULT_INVALID_ARGUMENT);
 			return false;
 		}
-		max_instance_id = s_max(max_instance_id, instance_id);
+		max_instance_index = s_max(max_instance_index, instance_id < 0 ? -1 : (i32)se_instance_id_index(instance_id));
 	}
 
-	if (slot_count > 0 && next_instance_id <= max_instance_id) {
+	if (slot_count > 0 && next_instance_id <= max_instance_index) {
 		se_set_last_error(SE_RESULT_INVALID_ARGUMENT);
 		return false;
 	}
@@ -1897,13 +2454,14 @@ b8 se_object_2d_from_json(const se_object_2d_handle object, const s_json* root)
 	}
 
 	object_ptr->transform = object_transform;
+	se_object_2d_mark_spatial(object_ptr, -1);
 	object_ptr->is_visible = visible;
 	object_ptr->shader = shader_handle;
 	se_instance_ids_clear_keep_capacity(&object_ptr->instances.ids);
 	se_transforms_2d_clear_keep_capacity(&object_ptr->instances.transforms);
 	se_buffers_clear_keep_capacity(&object_ptr->instances.buffers);
 	se_instance_actives_clear_keep_capacity(&object_ptr->instances.actives);
-	se_instance_ids_clear_keep_capacity(&object_ptr->instances.free_indices);
+	se_instances_clear_free_indices(&object_ptr->instances.free_indices, &object_ptr->instances.free_positions);
 	se_buffers_clear_keep_capacity(&object_ptr->instances.metadata);
 	se_transforms_2d_clear_keep_capacity(&object_ptr->render_transforms);
 	se_buffers_clear_keep_capacity(&object_ptr->render_buffers);
@@ -1934,11 +2492,12 @@ b8 se_object_2d_from_json(const se_object_2d_handle object, const s_json* root)
 		s_array_add(&object_ptr->instances.metadata, instance_metadata);
 
 		if (!active) {
-			se_instances_push_free_index(&object_ptr->instances.free_indices, slot_index);
+			se_instances_push_free_index(&object_ptr->instances.free_indices, &object_ptr->instances.free_positions, slot_index);
 		}
 	}
 
 	object_ptr->instances.next_id = (se_instance_id)next_instance_id;
+	se_instances_id_rebuild(&object_ptr->instances.id_map, &object_ptr->instances.ids, &object_ptr->instances.next_id);
 	se_object_2d_set_instances_dirty(object, true);
 	se_set_last_error(SE_RESULT_OK);
 	return true;
@@ -1956,7 +2515,7 @@ b8 se_object_2d_from_json_file(const se_object_2d_handle object, const c8* path)
 
 se_scene_2d_handle se_scene_2d_create(const s_vec2 *size, const u16 object_count) {
 	se_context *ctx = se_current_context();
-	if (!ctx || !size || object_count == 0) {
+	if (!ctx || !size) {
 		se_set_last_error(SE_RESULT_INVALID_ARGUMENT);
 		return S_HANDLE_NULL;
 	}
@@ -1977,7 +2536,9 @@ se_scene_2d_handle se_scene_2d_create(const s_vec2 *size, const u16 object_count
 	}
 	new_scene->output = framebuffer;
 	s_array_init(&new_scene->objects);
-	s_array_reserve(&new_scene->objects, object_count);
+	if (object_count > 0) {
+		s_array_reserve(&new_scene->objects, object_count);
+	}
 	se_set_last_error(SE_RESULT_OK);
 	return scene_handle;
 }
@@ -2044,6 +2605,8 @@ void se_scene_2d_destroy(const se_scene_2d_handle scene) {
 	s_assertf(scene_ptr, "se_scene_2d_destroy :: scene is null");
 	se_framebuffer_destroy(scene_ptr->output);
 	scene_ptr->output = S_HANDLE_NULL;
+	se_scene_spatial_destroy(scene_ptr->spatial);
+	scene_ptr->spatial = NULL;
 	s_array_clear(&scene_ptr->objects);
 	s_array_remove(&ctx->scenes_2d, scene);
 }
@@ -2195,66 +2758,497 @@ void se_scene_2d_remove_object(const se_scene_2d_handle scene, const se_object_2
 	}
 }
 
-b8 se_scene_2d_pick_object(const se_scene_2d_handle scene, const s_vec2* point_ndc, se_scene_pick_filter_2d filter, void* user_data, se_object_2d_handle* out_object) {
-	if (!point_ndc || !out_object) {
-		se_set_last_error(SE_RESULT_INVALID_ARGUMENT);
-		return false;
+typedef struct {
+	s_handle object;
+	se_bvh_proxy* proxies;
+	u32 proxy_count;
+	u32 proxy_capacity;
+	u32 revision;
+	// 3D only: model-space pick sphere shared by the object's instances.
+	s_vec3 local_center;
+	f32 local_radius;
+	b8 synced;
+} se_scene_spatial_entry;
+
+// One leaf per instance slot; leaves carry the entry index as `user` and the slot as
+// `user_index`. 2D scenes store flat boxes at z = 0.
+typedef struct se_scene_spatial {
+	se_bvh* bvh;
+	se_scene_spatial_entry* entries;
+	u32 entry_count;
+	u32 entry_capacity;
+} se_scene_spatial;
+
+static void se_scene_spatial_destroy(se_scene_spatial* spatial) {
+	if (!spatial) {
+		return;
 	}
-	se_context *ctx = se_current_context();
-	se_scene_2d *scene_ptr = se_scene_2d_from_handle(ctx, scene);
-	s_assertf(scene_ptr, "se_scene_2d_pick_object :: scene is null");
-	*out_object = S_HANDLE_NULL;
-	for (sz i = s_array_get_size(&scene_ptr->objects); i > 0; --i) {
-		se_object_2d_handle object_handle = *s_array_get(&scene_ptr->objects, s_array_handle(&scene_ptr->objects, (u32)(i - 1)));
-		if (object_handle == S_HANDLE_NULL) {
-			continue;
-		}
-		if (filter && !filter(object_handle, user_data)) {
-			continue;
-		}
-		se_object_2d *object = se_object_2d_from_handle(ctx, object_handle);
-		if (!object || !object->is_visible) {
-			continue;
-		}
-		se_box_2d box = {0};
-		se_object_2d_get_box_2d(object_handle, &box);
-		if (point_ndc->x >= box.min.x && point_ndc->x <= box.max.x &&
-			point_ndc->y >= box.min.y && point_ndc->y <= box.max.y) {
-			*out_object = object_handle;
-			se_set_last_error(SE_RESULT_OK);
-			return true;
-		}
+	for (u32 i = 0u; i < spatial->entry_capacity; ++i) {
+		free(spatial->entries[i].proxies);
 	}
-	se_set_last_error(SE_RESULT_NOT_FOUND);
-	return false;
+	se_bvh_destroy(spatial->bvh);
+	free(spatial->entries);
+	free(spatial);
 }
 
-s_json* se_scene_2d_to_json(const se_scene_2d_handle scene) {
-	se_context* ctx = se_current_context();
-	if (!ctx || scene == S_HANDLE_NULL) {
-		se_set_last_error(SE_RESULT_INVALID_ARGUMENT);
-		return NULL;
+static se_scene_spatial* se_scene_spatial_require(se_scene_spatial** spatial_slot) {
+	if (*spatial_slot) {
+		return *spatial_slot;
 	}
-	se_scene_2d* scene_ptr = se_scene_2d_from_handle(ctx, scene);
-	if (!scene_ptr) {
-		se_set_last_error(SE_RESULT_NOT_FOUND);
+	se_scene_spatial* spatial = (se_scene_spatial*)calloc(1u, sizeof(*spatial));
+	if (!spatial) {
 		return NULL;
 	}
-	if (scene_ptr->output == S_HANDLE_NULL) {
-		se_set_last_error(SE_RESULT_NOT_FOUND);
+	spatial->bvh = se_bvh_create(NULL);
+	if (!spatial->bvh) {
+		free(spatial);
 		return NULL;
 	}
+	*spatial_slot = spatial;
+	return spatial;
+}
 
-	s_json* root = s_json_object_empty(NULL);
-	if (!root) {
-		se_set_last_error(SE_RESULT_OUT_OF_MEMORY);
-		return NULL;
+// Empties the tree and sizes the entries for a new object list; callers fill entry objects.
+static b8 se_scene_spatial_reset(se_scene_spatial* spatial, const u32 object_count) {
+	if (object_count > spatial->entry_capacity) {
+		se_scene_spatial_entry* entries = (se_scene_spatial_entry*)realloc(spatial->entries, sizeof(*entries) * (sz)object_count);
+		if (!entries) {
+			return false;
+		}
+		memset(entries + spatial->entry_capacity, 0, sizeof(*entries) * (sz)(object_count - spatial->entry_capacity));
+		spatial->entries = entries;
+		spatial->entry_capacity = object_count;
 	}
-	if (!se_scene_2d_json_add_string(root, "format", SE_SCENE_2D_JSON_FORMAT) ||
-		!se_scene_2d_json_add_u32(root, "version", SE_SCENE_2D_JSON_VERSION)) {
-		s_json_free(root);
-		se_set_last_error(SE_RESULT_OUT_OF_MEMORY);
-		return NULL;
+	se_bvh_clear(spatial->bvh);
+	for (u32 i = 0u; i < spatial->entry_capacity; ++i) {
+		se_scene_spatial_entry* entry = &spatial->entries[i];
+		for (u32 j = 0u; j < entry->proxy_capacity; ++j) {
+			entry->proxies[j] = SE_BVH_PROXY_NULL;
+		}
+		entry->object = S_HANDLE_NULL;
+		entry->proxy_count = 0u;
+		entry->synced = false;
+	}
+	spatial->entry_count = object_count;
+	return true;
+}
+
+// Inserts, moves or (with a NULL box) removes the leaf of one instance slot.
+static void se_scene_spatial_set_slot(se_scene_spatial* spatial, const u32 entry_index, const sz slot, const se_box_3d* box) {
+	se_scene_spatial_entry* entry = &spatial->entries[entry_index];
+	if (slot >= entry->proxy_capacity) {
+		if (!box) {
+			return;
+		}
+		const u32 capacity = s_max((u32)slot + 1u, entry->proxy_capacity * 2u);
+		se_bvh_proxy* proxies = (se_bvh_proxy*)realloc(entry->proxies, sizeof(*proxies) * (sz)capacity);
+		if (!proxies) {
+			return;
+		}
+		for (u32 i = entry->proxy_capacity; i < capacity; ++i) {
+			proxies[i] = SE_BVH_PROXY_NULL;
+		}
+		entry->proxies = proxies;
+		entry->proxy_capacity = capacity;
+	}
+	if (slot >= entry->proxy_count) {
+		entry->proxy_count = (u32)slot + 1u;
+	}
+	se_bvh_proxy* proxy = &entry->proxies[slot];
+	if (!box) {
+		if (*proxy != SE_BVH_PROXY_NULL) {
+			se_bvh_remove(spatial->bvh, *proxy);
+			*proxy = SE_BVH_PROXY_NULL;
+		}
+		return;
+	}
+	if (*proxy == SE_BVH_PROXY_NULL) {
+		*proxy = se_bvh_insert(spatial->bvh, box, entry_index, (u32)slot);
+	} else {
+		se_bvh_move(spatial->bvh, *proxy, box);
+	}
+}
+
+static void se_scene_spatial_release_entry(se_scene_spatial* spatial, se_scene_spatial_entry* entry) {
+	for (u32 i = 0u; i < entry->proxy_count; ++i) {
+		if (entry->proxies[i] != SE_BVH_PROXY_NULL) {
+			se_bvh_remove(spatial->bvh, entry->proxies[i]);
+			entry->proxies[i] = SE_BVH_PROXY_NULL;
+		}
+	}
+	entry->proxy_count = 0u;
+	entry->synced = false;
+}
+
+// First moved-slot log index the tree has not replayed yet, or SIZE_MAX when the log no longer
+// reaches back to the entry's revision and every slot has to be refit.
+static sz se_scene_spatial_log_start(const se_scene_spatial_entry* entry, const u32 log_revision) {
+	if (!entry->synced || entry->revision < log_revision) {
+		return SIZE_MAX;
+	}
+	return (sz)(entry->revision - log_revision);
+}
+
+static b8 se_scene_2d_instance_box(const se_object_2d* object, const sz slot, se_box_2d* out_box) {
+	if (object->is_custom) {
+		if (slot != 0) {
+			return false;
+		}
+		se_box_2d_make(out_box, &object->transform);
+		return true;
+	}
+	if (slot >= s_array_get_size(&object->instances.transforms)) {
+		return false;
+	}
+	const b8* active = s_array_get((se_instance_actives*)&object->instances.actives, s_array_handle((se_instance_actives*)&object->instances.actives, (u32)slot));
+	const s_mat3* transform = s_array_get((se_transforms_2d*)&object->instances.transforms, s_array_handle((se_transforms_2d*)&object->instances.transforms, (u32)slot));
+	if (!active || !*active || !transform) {
+		return false;
+	}
+	const s_mat3 world_transform = s_mat3_mul(&object->transform, transform);
+	se_box_2d_make(out_box, &world_transform);
+	return true;
+}
+
+static void se_scene_2d_spatial_update_slot(se_scene_spatial* spatial, const u32 entry_index, const se_object_2d* object, const sz slot) {
+	se_box_2d box = {0};
+	if (!se_scene_2d_instance_box(object, slot, &box)) {
+		se_scene_spatial_set_slot(spatial, entry_index, slot, NULL);
+		return;
+	}
+	const se_box_3d leaf_box = { s_vec3(box.min.x, box.min.y, 0.0f), s_vec3(box.max.x, box.max.y, 0.0f) };
+	se_scene_spatial_set_slot(spatial, entry_index, slot, &leaf_box);
+}
+
+static void se_scene_2d_spatial_sync_entry(se_context* ctx, se_scene_spatial* spatial, const u32 entry_index) {
+	se_scene_spatial_entry* entry = &spatial->entries[entry_index];
+	se_object_2d* object = se_object_2d_handle_exists(ctx, entry->object) ? se_object_2d_from_handle(ctx, entry->object) : NULL;
+	if (!object) {
+		se_scene_spatial_release_entry(spatial, entry);
+		return;
+	}
+	if (entry->synced && entry->revision == object->spatial_revision) {
+		return;
+	}
+	const sz first = object->is_custom ? SIZE_MAX : se_scene_spatial_log_start(entry, object->spatial_log_revision);
+	if (first != SIZE_MAX) {
+		for (sz i = first; i < s_array_get_size(&object->spatial_moved); ++i) {
+			const se_instance_id* slot = s_array_get(&object->spatial_moved, s_array_handle(&object->spatial_moved, (u32)i));
+			if (slot && *slot >= 0) {
+				se_scene_2d_spatial_update_slot(spatial, entry_index, object, (sz)*slot);
+			}
+		}
+	} else {
+		const sz slot_count = object->is_custom ? 1 : s_array_get_size(&object->instances.transforms);
+		for (sz slot = 0; slot < s_max(slot_count, (sz)entry->proxy_count); ++slot) {
+			se_scene_2d_spatial_update_slot(spatial, entry_index, object, slot);
+		}
+	}
+	entry->revision = object->spatial_revision;
+	entry->synced = true;
+}
+
+// Rebuilds the tree when the object list changed, otherwise refits the instances moved since
+// the last query.
+static se_scene_spatial* se_scene_2d_spatial_sync(se_context* ctx, se_scene_2d* scene_ptr) {
+	se_scene_spatial* spatial = se_scene_spatial_require(&scene_ptr->spatial);
+	if (!spatial) {
+		return NULL;
+	}
+	const u32 object_count = (u32)s_array_get_size(&scene_ptr->objects);
+	b8 rebuild = spatial->entry_count != object_count;
+	for (u32 i = 0u; i < spatial->entry_count && !rebuild; ++i) {
+		rebuild = spatial->entries[i].object != *s_array_get(&scene_ptr->objects, s_array_handle(&scene_ptr->objects, i));
+	}
+	if (rebuild) {
+		if (!se_scene_spatial_reset(spatial, object_count)) {
+			return NULL;
+		}
+		for (u32 i = 0u; i < object_count; ++i) {
+			spatial->entries[i].object = *s_array_get(&scene_ptr->objects, s_array_handle(&scene_ptr->objects, i));
+		}
+	}
+	for (u32 i = 0u; i < spatial->entry_count; ++i) {
+		se_scene_2d_spatial_sync_entry(ctx, spatial, i);
+	}
+	return spatial;
+}
+
+static void se_scene_3d_spatial_local_sphere(se_context* ctx, const se_object_3d* object, se_scene_spatial_entry* entry) {
+	entry->local_center = s_vec3(0.0f, 0.0f, 0.0f);
+	entry->local_radius = 0.8660254f;
+	se_model* model = se_model_from_handle(ctx, object->model);
+	if (model) {
+		(void)se_model_estimate_pick_sphere(model, &entry->local_center, &entry->local_radius);
+	}
+}
+
+static void se_scene_3d_instance_sphere(const se_object_3d* object, const se_scene_spatial_entry* entry, const sz slot, s_vec3* out_center, f32* out_radius) {
+	s_mat4* instance_transform = s_array_get((se_transforms*)&object->instances.transforms, s_array_handle((se_transforms*)&object->instances.transforms, (u32)slot));
+	const s_mat4 world_transform = s_mat4_mul(&object->transform, instance_transform);
+	const s_vec3 scale = se_mat4_extract_basis_scale(&world_transform);
+	*out_center = se_mat4_mul_point(&world_transform, &entry->local_center);
+	*out_radius = entry->local_radius * se_max3(scale.x, scale.y, scale.z);
+}
+
+static se_box_3d se_scene_sphere_box(const s_vec3* center, const f32 radius) {
+	return (se_box_3d){
+		s_vec3(center->x - radius, center->y - radius, center->z - radius),
+		s_vec3(center->x + radius, center->y + radius, center->z + radius)
+	};
+}
+
+static void se_scene_3d_spatial_update_slot(se_scene_spatial* spatial, const u32 entry_index, const se_object_3d* object, const sz slot) {
+	const b8* active = slot < s_array_get_size(&object->instances.actives)
+		? s_array_get((se_instance_actives*)&object->instances.actives, s_array_handle((se_instance_actives*)&object->instances.actives, (u32)slot))
+		: NULL;
+	if (!active || !*active) {
+		se_scene_spatial_set_slot(spatial, entry_index, slot, NULL);
+		return;
+	}
+	s_vec3 center = s_vec3(0.0f, 0.0f, 0.0f);
+	f32 radius = 0.0f;
+	se_scene_3d_instance_sphere(object, &spatial->entries[entry_index], slot, &center, &radius);
+	const se_box_3d box = se_scene_sphere_box(&center, radius);
+	se_scene_spatial_set_slot(spatial, entry_index, slot, &box);
+}
+
+static void se_scene_3d_spatial_sync_entry(se_context* ctx, se_scene_spatial* spatial, const u32 entry_index) {
+	se_scene_spatial_entry* entry = &spatial->entries[entry_index];
+	se_object_3d* object = se_object_3d_handle_exists(ctx, entry->object) ? se_object_3d_from_handle(ctx, entry->object) : NULL;
+	if (!object || object->is_custom || object->model == S_HANDLE_NULL) {
+		se_scene_spatial_release_entry(spatial, entry);
+		return;
+	}
+	if (entry->synced && entry->revision == object->spatial_revision) {
+		return;
+	}
+	const sz first = se_scene_spatial_log_start(entry, object->spatial_log_revision);
+	if (first != SIZE_MAX) {
+		for (sz i = first; i < s_array_get_size(&object->spatial_moved); ++i) {
+			const se_instance_id* slot = s_array_get(&object->spatial_moved, s_array_handle(&object->spatial_moved, (u32)i));
+			if (slot && *slot >= 0) {
+				se_scene_3d_spatial_update_slot(spatial, entry_index, object, (sz)*slot);
+			}
+		}
+	} else {
+		se_scene_3d_spatial_local_sphere(ctx, object, entry);
+		const sz slot_count = s_array_get_size(&object->instances.transforms);
+		for (sz slot = 0; slot < s_max(slot_count, (sz)entry->proxy_count); ++slot) {
+			se_scene_3d_spatial_update_slot(spatial, entry_index, object, slot);
+		}
+	}
+	entry->revision = object->spatial_revision;
+	entry->synced = true;
+}
+
+static se_scene_spatial* se_scene_3d_spatial_sync(se_context* ctx, se_scene_3d* scene_ptr) {
+	se_scene_spatial* spatial = se_scene_spatial_require(&scene_ptr->spatial);
+	if (!spatial) {
+		return NULL;
+	}
+	se_scene_3d_update_world_transforms(ctx, scene_ptr);
+	const u32 object_count = (u32)s_array_get_size(&scene_ptr->objects);
+	b8 rebuild = spatial->entry_count != object_count;
+	for (u32 i = 0u; i < spatial->entry_count && !rebuild; ++i) {
+		rebuild = spatial->entries[i].object != *s_array_get(&scene_ptr->objects, s_array_handle(&scene_ptr->objects, i));
+	}
+	if (rebuild) {
+		if (!se_scene_spatial_reset(spatial, object_count)) {
+			return NULL;
+		}
+		for (u32 i = 0u; i < object_count; ++i) {
+			spatial->entries[i].object = *s_array_get(&scene_ptr->objects, s_array_handle(&scene_ptr->objects, i));
+		}
+	}
+	for (u32 i = 0u; i < spatial->entry_count; ++i) {
+		se_scene_3d_spatial_sync_entry(ctx, spatial, i);
+	}
+	return spatial;
+}
+
+typedef struct {
+	se_context* ctx;
+	se_scene_spatial* spatial;
+	const s_vec2* point;
+	const se_box_2d* rect;
+	const s_vec2* points;
+	u32 point_count;
+	se_scene_pick_filter_2d filter;
+	void* user_data;
+	i64 best_entry;
+	se_scene_instance_2d* out_instances;
+	u32 max_instances;
+	u32 count;
+} se_scene_2d_spatial_query;
+
+// Resolves a tree leaf back to its object and the world box of the instance; NULL when the
+// object was filtered out or hidden.
+static const se_object_2d* se_scene_2d_spatial_leaf(const se_scene_2d_spatial_query* query, const u64 user, const u32 slot, se_box_2d* out_box) {
+	const se_object_2d_handle object_handle = query->spatial->entries[user].object;
+	if (query->filter && !query->filter(object_handle, query->user_data)) {
+		return NULL;
+	}
+	se_object_2d* object = se_object_2d_from_handle(query->ctx, object_handle);
+	if (!object || !object->is_visible || !se_scene_2d_instance_box(object, slot, out_box)) {
+		return NULL;
+	}
+	return object;
+}
+
+static b8 se_scene_2d_pick_leaf(u64 user, u32 user_index, void* user_data) {
+	se_scene_2d_spatial_query* query = (se_scene_2d_spatial_query*)user_data;
+	// Later objects draw on top, so the highest scene index wins.
+	if ((i64)user <= query->best_entry) {
+		return true;
+	}
+	se_box_2d box = {0};
+	if (se_scene_2d_spatial_leaf(query, user, user_index, &box) && se_box_2d_is_inside(&box, query->point)) {
+		query->best_entry = (i64)user;
+	}
+	return true;
+}
+
+static b8 se_scene_2d_query_leaf(u64 user, u32 user_index, void* user_data) {
+	se_scene_2d_spatial_query* query = (se_scene_2d_spatial_query*)user_data;
+	se_box_2d box = {0};
+	const se_object_2d* object = se_scene_2d_spatial_leaf(query, user, user_index, &box);
+	if (!object) {
+		return true;
+	}
+	if (query->points ? !se_box_2d_intersects_polygon(&box, query->points, query->point_count) : !se_box_2d_intersects(&box, query->rect)) {
+		return true;
+	}
+	if (query->count < query->max_instances) {
+		se_instance_id instance_id = -1;
+		if (!object->is_custom) {
+			instance_id = *s_array_get((se_instance_ids*)&object->instances.ids, s_array_handle((se_instance_ids*)&object->instances.ids, user_index));
+		}
+		query->out_instances[query->count] = (se_scene_instance_2d){ query->spatial->entries[user].object, instance_id };
+	}
+	query->count++;
+	return true;
+}
+
+b8 se_scene_2d_pick_object(const se_scene_2d_handle scene, const s_vec2* point_ndc, se_scene_pick_filter_2d filter, void* user_data, se_object_2d_handle* out_object) {
+	if (!point_ndc || !out_object) {
+		se_set_last_error(SE_RESULT_INVALID_ARGUMENT);
+		return false;
+	}
+	se_context *ctx = se_current_context();
+	se_scene_2d *scene_ptr = se_scene_2d_from_handle(ctx, scene);
+	s_assertf(scene_ptr, "se_scene_2d_pick_object :: scene is null");
+	*out_object = S_HANDLE_NULL;
+	se_scene_spatial* spatial = se_scene_2d_spatial_sync(ctx, scene_ptr);
+	if (!spatial) {
+		se_set_last_error(SE_RESULT_OUT_OF_MEMORY);
+		return false;
+	}
+	se_scene_2d_spatial_query query = {
+		.ctx = ctx,
+		.spatial = spatial,
+		.point = point_ndc,
+		.filter = filter,
+		.user_data = user_data,
+		.best_entry = -1
+	};
+	const se_box_3d point_box = { s_vec3(point_ndc->x, point_ndc->y, 0.0f), s_vec3(point_ndc->x, point_ndc->y, 0.0f) };
+	se_bvh_query_box(spatial->bvh, &point_box, se_scene_2d_pick_leaf, &query);
+	if (query.best_entry < 0) {
+		se_set_last_error(SE_RESULT_NOT_FOUND);
+		return false;
+	}
+	*out_object = spatial->entries[query.best_entry].object;
+	se_set_last_error(SE_RESULT_OK);
+	return true;
+}
+
+static u32 se_scene_2d_query(const se_scene_2d_handle scene, const se_box_2d* bounds, se_scene_2d_spatial_query* query) {
+	se_context* ctx = se_current_context();
+	se_scene_2d* scene_ptr = se_scene_2d_from_handle(ctx, scene);
+	if (!scene_ptr || (!query->out_instances && query->max_instances > 0u)) {
+		se_set_last_error(SE_RESULT_INVALID_ARGUMENT);
+		return 0u;
+	}
+	se_scene_spatial* spatial = se_scene_2d_spatial_sync(ctx, scene_ptr);
+	if (!spatial) {
+		se_set_last_error(SE_RESULT_OUT_OF_MEMORY);
+		return 0u;
+	}
+	query->ctx = ctx;
+	query->spatial = spatial;
+	const se_box_3d query_box = { s_vec3(bounds->min.x, bounds->min.y, 0.0f), s_vec3(bounds->max.x, bounds->max.y, 0.0f) };
+	se_bvh_query_box(spatial->bvh, &query_box, se_scene_2d_query_leaf, query);
+	se_set_last_error(SE_RESULT_OK);
+	return query->count;
+}
+
+u32 se_scene_2d_query_rect(const se_scene_2d_handle scene, const se_box_2d* rect, se_scene_pick_filter_2d filter, void* user_data, se_scene_instance_2d* out_instances, const u32 max_instances) {
+	if (!rect) {
+		se_set_last_error(SE_RESULT_INVALID_ARGUMENT);
+		return 0u;
+	}
+	const se_box_2d bounds = {
+		s_vec2(s_min(rect->min.x, rect->max.x), s_min(rect->min.y, rect->max.y)),
+		s_vec2(s_max(rect->min.x, rect->max.x), s_max(rect->min.y, rect->max.y))
+	};
+	se_scene_2d_spatial_query query = {
+		.rect = &bounds,
+		.filter = filter,
+		.user_data = user_data,
+		.out_instances = out_instances,
+		.max_instances = max_instances
+	};
+	return se_scene_2d_query(scene, &bounds, &query);
+}
+
+u32 se_scene_2d_query_polygon(const se_scene_2d_handle scene, const s_vec2* points, const u32 point_count, se_scene_pick_filter_2d filter, void* user_data, se_scene_instance_2d* out_instances, const u32 max_instances) {
+	if (!points || point_count < 3u) {
+		se_set_last_error(SE_RESULT_INVALID_ARGUMENT);
+		return 0u;
+	}
+	se_box_2d bounds = { points[0], points[0] };
+	for (u32 i = 1u; i < point_count; ++i) {
+		bounds.min = s_vec2(s_min(bounds.min.x, points[i].x), s_min(bounds.min.y, points[i].y));
+		bounds.max = s_vec2(s_max(bounds.max.x, points[i].x), s_max(bounds.max.y, points[i].y));
+	}
+	se_scene_2d_spatial_query query = {
+		.points = points,
+		.point_count = point_count,
+		.filter = filter,
+		.user_data = user_data,
+		.out_instances = out_instances,
+		.max_instances = max_instances
+	};
+	return se_scene_2d_query(scene, &bounds, &query);
+}
+
+s_json* se_scene_2d_to_json(const se_scene_2d_handle scene) {
+	se_context* ctx = se_current_context();
+	if (!ctx || scene == S_HANDLE_NULL) {
+		se_set_last_error(SE_RESULT_INVALID_ARGUMENT);
+		return NULL;
+	}
+	se_scene_2d* scene_ptr = se_scene_2d_from_handle(ctx, scene);
+	if (!scene_ptr) {
+		se_set_last_error(SE_RESULT_NOT_FOUND);
+		return NULL;
+	}
+	if (scene_ptr->output == S_HANDLE_NULL) {
+		se_set_last_error(SE_RESULT_NOT_FOUND);
+		return NULL;
+	}
+
+	s_json* root = s_json_object_empty(NULL);
+	if (!root) {
+		se_set_last_error(SE_RESULT_OUT_OF_MEMORY);
+		return NULL;
+	}
+	if (!se_scene_2d_json_add_string(root, "format", SE_SCENE_2D_JSON_FORMAT) ||
+		!se_scene_2d_json_add_u32(root, "version", SE_SCENE_2D_JSON_VERSION)) {
+		s_json_free(root);
+		se_set_last_error(SE_RESULT_OUT_OF_MEMORY);
+		return NULL;
 	}
 
 	s_vec2 output_size = s_vec2(0.0f, 0.0f);
@@ -2631,7 +3625,11 @@ s_json* se_scene_3d_to_json(const se_scene_3d_handle scene) {
 			s_json_free(root);
 			return NULL;
 		}
-		if (!se_scene_2d_json_add_u32(object_json, "model_index", model_index)) {
+		u32 parent_index = 0u;
+		const b8 has_parent = se_scene_3d_object_index_of(&scene_ptr->objects, object->parent, &parent_index);
+		if (!se_scene_2d_json_add_u32(object_json, "model_index", model_index) ||
+			(has_parent && (!se_scene_2d_json_add_u32(object_json, "parent_index", parent_index) ||
+				!se_scene_2d_json_add_i32(object_json, "parent_instance", object->parent_instance)))) {
 			s_json_free(object_json);
 			s_array_clear(&model_handles);
 			s_json_free(root);
@@ -2852,6 +3850,27 @@ b8 se_scene_3d_from_json(const se_scene_3d_handle scene, const s_json* root) {
 		}
 	}
 
+	// Parents may come after their children in the array, so links are made once all exist.
+	for (sz object_index = 0; object_index < objects_json->as.children.count; ++object_index) {
+		const s_json* object_json = s_json_at(objects_json, object_index);
+		if (!s_json_get(object_json, "parent_index")) {
+			continue;
+		}
+		u32 parent_index = 0u;
+		i32 parent_instance = -1;
+		if (!se_scene_json_number_to_u32(se_scene_json_get_required(object_json, "parent_index", S_JSON_NUMBER), &parent_index) ||
+			!se_scene_json_number_to_i32(se_scene_json_get_required(object_json, "parent_instance", S_JSON_NUMBER), &parent_instance) ||
+			parent_index >= s_array_get_size(&loaded_objects)) {
+			se_set_last_error(SE_RESULT_INVALID_ARGUMENT);
+			goto fail;
+		}
+		const se_object_3d_handle object_handle = *s_array_get(&loaded_objects, s_array_handle(&loaded_objects, (u32)object_index));
+		const se_object_3d_handle parent_handle = *s_array_get(&loaded_objects, s_array_handle(&loaded_objects, parent_index));
+		if (!se_object_3d_set_parent(object_handle, parent_handle, (se_instance_id)parent_instance)) {
+			goto fail;
+		}
+	}
+
 	se_framebuffer_set_size(scene_ptr->output, &output_size);
 	if (scene_ptr->camera != S_HANDLE_NULL) {
 		se_camera_set_aspect(scene_ptr->camera, output_size.x, output_size.y);
@@ -2897,69 +3916,1232 @@ b8 se_scene_3d_from_json_file(const se_scene_3d_handle scene, const c8* path) {
 	return ok;
 }
 
-se_scene_3d_handle se_scene_3d_create(const s_vec2 *size, const u16 object_count) {
-	se_context *ctx = se_current_context();
-	if (!ctx || !size || object_count == 0) {
-		se_set_last_error(SE_RESULT_INVALID_ARGUMENT);
-		return S_HANDLE_NULL;
+#ifndef GL_DRAW_INDIRECT_BUFFER
+#define GL_DRAW_INDIRECT_BUFFER 0x8F3F
+#endif
+
+#define SE_SCENE_3D_BATCH_ARENA_MIN_BYTES (64u * 1024u)
+
+typedef struct {
+	s_mat4 transform;
+	s_mat4 buffer;
+	s_mat4 metadata;
+} se_scene_3d_batch_instance;
+
+typedef struct {
+	se_object_3d* object;
+	se_mesh* mesh;
+	u32 instance_count;
+	b8 instance_culled;
+} se_scene_3d_batch_draw;
+
+typedef struct se_scene_3d_batch {
+	se_draw_batcher* batcher;
+	se_scene_3d_batch_draw* draws;
+	u32 max_meshes;
+	u32 max_draws;
+	u32 arena_mesh_count;
+	u32 vertex_capacity_bytes;
+	u32 index_capacity_bytes;
+	GLuint vao;
+	GLuint vbo;
+	GLuint ebo;
+	GLuint instance_vbo;
+	GLuint indirect_buffer;
+	u64 generation;
+	b8 available;
+	b8 multi_draw_indirect;
+	b8 layout_dirty;
+	se_scene_3d_batch_stats stats;
+} se_scene_3d_batch;
+
+static void se_scene_3d_batch_release_gl(se_scene_3d_batch* batch) {
+	if (batch->generation == se_render_get_generation() && se_render_has_context()) {
+		GLuint buffers[4] = {batch->vbo, batch->ebo, batch->instance_vbo, batch->indirect_buffer};
+		for (u32 i = 0u; i < 4u; ++i) {
+			if (buffers[i] != 0u) {
+				glDeleteBuffers(1, &buffers[i]);
+			}
+		}
+		if (batch->vao != 0u) {
+			glDeleteVertexArrays(1, &batch->vao);
+		}
 	}
-	if (s_array_get_capacity(&ctx->scenes_3d) == 0) {
-		s_array_init(&ctx->scenes_3d);
+	batch->vao = 0u;
+	batch->vbo = 0u;
+	batch->ebo = 0u;
+	batch->instance_vbo = 0u;
+	batch->indirect_buffer = 0u;
+	batch->vertex_capacity_bytes = 0u;
+	batch->index_capacity_bytes = 0u;
+	batch->arena_mesh_count = 0u;
+	se_draw_batcher_clear(batch->batcher);
+}
+
+static void se_scene_3d_batch_destroy(se_scene_3d_batch* batch) {
+	if (!batch) {
+		return;
 	}
-	if (s_array_get_size(&ctx->scenes_3d) >= SE_MAX_SCENES) {
-		se_set_last_error(SE_RESULT_OUT_OF_MEMORY);
-		return S_HANDLE_NULL;
+	se_scene_3d_batch_release_gl(batch);
+	se_draw_batcher_destroy(batch->batcher);
+	free(batch->draws);
+	free(batch);
+}
+
+static se_scene_3d_batch* se_scene_3d_batch_get(se_scene_3d* scene_ptr) {
+	se_scene_3d_batch* batch = scene_ptr->batch;
+	if (!batch) {
+		const se_draw_batcher_config config = SE_DRAW_BATCHER_CONFIG_DEFAULTS;
+		batch = (se_scene_3d_batch*)calloc(1u, sizeof(*batch));
+		if (!batch) {
+			return NULL;
+		}
+		batch->batcher = se_draw_batcher_create(&config);
+		batch->max_meshes = config.max_meshes;
+		batch->max_draws = config.max_draws;
+		batch->draws = (se_scene_3d_batch_draw*)malloc(sizeof(*batch->draws) * (sz)config.max_draws);
+		if (!batch->batcher || !batch->draws) {
+			se_draw_batcher_destroy(batch->batcher);
+			free(batch->draws);
+			free(batch);
+			return NULL;
+		}
+		batch->generation = se_render_get_generation();
+		batch->available = se_glCopyBufferSubData != NULL && se_glDrawElementsInstancedBaseVertex != NULL;
+		batch->multi_draw_indirect = se_ext_is_supported(SE_EXT_FEATURE_MULTI_DRAW_INDIRECT);
+		scene_ptr->batch = batch;
+	}
+	// A new render generation means the old context took the arena with it.
+	if (batch->generation != se_render_get_generation()) {
+		se_scene_3d_batch_release_gl(batch);
+		batch->generation = se_render_get_generation();
+		batch->available = se_glCopyBufferSubData != NULL && se_glDrawElementsInstancedBaseVertex != NULL;
+		batch->multi_draw_indirect = se_ext_is_supported(SE_EXT_FEATURE_MULTI_DRAW_INDIRECT);
+	}
+	return batch;
+}
+
+// Swaps in a batcher with room for twice the meshes or draws that overflowed. The arena is
+// repacked once into the new one instead of on every frame that would not fit.
+static b8 se_scene_3d_batch_grow_batcher(se_scene_3d_batch* batch, const b8 grow_meshes, const b8 grow_draws) {
+	se_draw_batcher_config config = { .max_meshes = batch->max_meshes, .max_draws = batch->max_draws };
+	if (grow_meshes) {
+		config.max_meshes *= 2u;
+	}
+	if (grow_draws) {
+		config.max_draws *= 2u;
+	}
+	se_draw_batcher* batcher = se_draw_batcher_create(&config);
+	se_scene_3d_batch_draw* draws = (se_scene_3d_batch_draw*)malloc(sizeof(*draws) * (sz)config.max_draws);
+	if (!batcher || !draws) {
+		se_draw_batcher_destroy(batcher);
+		free(draws);
+		return false;
+	}
+	se_scene_3d_batch_release_gl(batch);
+	se_draw_batcher_destroy(batch->batcher);
+	free(batch->draws);
+	batch->batcher = batcher;
+	batch->draws = draws;
+	batch->max_meshes = config.max_meshes;
+	batch->max_draws = config.max_draws;
+	return true;
+}
+
+static void se_scene_3d_batch_grow(GLuint* buffer, u32* capacity_bytes, const u32 used_bytes, const u32 needed_bytes) {
+	if (needed_bytes <= *capacity_bytes && *buffer != 0u) {
+		return;
 	}
-	se_scene_3d_handle scene_handle = s_array_increment(&ctx->scenes_3d);
-	se_scene_3d *new_scene = s_array_get(&ctx->scenes_3d, scene_handle);
-	memset(new_scene, 0, sizeof(*new_scene));
-	se_framebuffer_handle framebuffer = se_framebuffer_create(size);
-	if (framebuffer == S_HANDLE_NULL) {
-		s_array_remove(&ctx->scenes_3d, scene_handle);
-		return S_HANDLE_NULL;
+	u32 capacity = *capacity_bytes > SE_SCENE_3D_BATCH_ARENA_MIN_BYTES ? *capacity_bytes : SE_SCENE_3D_BATCH_ARENA_MIN_BYTES;
+	while (capacity < needed_bytes) {
+		capacity = capacity > 0x7FFFFFFFu ? needed_bytes : capacity * 2u;
 	}
-	new_scene->output = framebuffer;
-	s_array_init(&new_scene->objects);
-	s_array_init(&new_scene->post_process);
-	s_array_init(&new_scene->custom_renders);
-	s_array_reserve(&new_scene->objects, object_count);
-	s_array_reserve(&new_scene->post_process, object_count);
-	s_array_reserve(&new_scene->custom_renders, 8);
-	new_scene->output_shader = S_HANDLE_NULL;
-	se_camera_handle camera = se_camera_create();
-	if (camera == S_HANDLE_NULL) {
-		se_framebuffer_destroy(new_scene->output);
-		s_array_remove(&ctx->scenes_3d, scene_handle);
-		return S_HANDLE_NULL;
+	GLuint next = 0u;
+	glGenBuffers(1, &next);
+	glBindBuffer(GL_COPY_WRITE_BUFFER, next);
+	glBufferData(GL_COPY_WRITE_BUFFER, (GLsizeiptr)capacity, NULL, GL_STATIC_DRAW);
+	if (*buffer != 0u && used_bytes > 0u) {
+		glBindBuffer(GL_COPY_READ_BUFFER, *buffer);
+		glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0, (GLsizeiptr)used_bytes);
 	}
-	new_scene->camera = camera;
-	new_scene->enable_culling = true;
-	new_scene->last_vp = s_mat4_identity;
-	new_scene->has_last_vp = false;
-	if (new_scene->camera != S_HANDLE_NULL) {
-		se_camera_set_aspect(new_scene->camera, size->x, size->y);
+	if (*buffer != 0u) {
+		glDeleteBuffers(1, buffer);
 	}
-	se_set_last_error(SE_RESULT_OK);
-	return scene_handle;
+	*buffer = next;
+	*capacity_bytes = capacity;
 }
 
-se_scene_3d_handle se_scene_3d_create_for_window(const se_window_handle window, const u16 object_count) {
-	se_context *ctx = se_current_context();
-	if (!ctx || window == S_HANDLE_NULL || object_count == 0) {
-		se_set_last_error(SE_RESULT_INVALID_ARGUMENT);
-		return S_HANDLE_NULL;
+// Copies meshes added since the last frame to the end of the arenas; existing offsets stay valid.
+static void se_scene_3d_batch_upload_arena(se_scene_3d_batch* batch) {
+	u32 mesh_count = 0u;
+	u32 vertex_total = 0u;
+	u32 index_total = 0u;
+	const se_draw_batch_mesh* meshes = se_draw_batcher_get_meshes(batch->batcher, &mesh_count, &vertex_total, &index_total);
+	if (mesh_count == batch->arena_mesh_count) {
+		return;
 	}
-	se_window *window_ptr = s_array_get(&ctx->windows, window);
-	const s_vec2 size = s_vec2((f32)window_ptr->width, (f32)window_ptr->height);
-	se_scene_3d_handle scene = se_scene_3d_create(&size, object_count);
-	if (scene == S_HANDLE_NULL) {
-		return S_HANDLE_NULL;
+	const se_draw_batch_mesh* first_new = &meshes[batch->arena_mesh_count];
+	const GLuint previous_vbo = batch->vbo;
+	const GLuint previous_ebo = batch->ebo;
+	se_scene_3d_batch_grow(&batch->vbo, &batch->vertex_capacity_bytes,
+		first_new->first_vertex * (u32)sizeof(se_vertex_3d), vertex_total * (u32)sizeof(se_vertex_3d));
+	se_scene_3d_batch_grow(&batch->ebo, &batch->index_capacity_bytes,
+		first_new->first_index * (u32)sizeof(u32), index_total * (u32)sizeof(u32));
+	batch->layout_dirty = batch->layout_dirty || previous_vbo != batch->vbo || previous_ebo != batch->ebo;
+
+	for (u32 i = batch->arena_mesh_count; i < mesh_count; ++i) {
+		const se_draw_batch_mesh* mesh = &meshes[i];
+		glBindBuffer(GL_COPY_READ_BUFFER, (GLuint)(mesh->key >> 32));
+		glBindBuffer(GL_COPY_WRITE_BUFFER, batch->vbo);
+		glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0,
+			(GLintptr)mesh->first_vertex * (GLintptr)sizeof(se_vertex_3d),
+			(GLsizeiptr)mesh->vertex_count * (GLsizeiptr)sizeof(se_vertex_3d));
+		glBindBuffer(GL_COPY_READ_BUFFER, (GLuint)(mesh->key & 0xFFFFFFFFu));
+		glBindBuffer(GL_COPY_WRITE_BUFFER, batch->ebo);
+		glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0,
+			(GLintptr)mesh->first_index * (GLintptr)sizeof(u32),
+			(GLsizeiptr)mesh->index_count * (GLsizeiptr)sizeof(u32));
+	}
+	glBindBuffer(GL_COPY_READ_BUFFER, 0);
+	glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+	batch->arena_mesh_count = mesh_count;
+}
+
+static void se_scene_3d_batch_set_instance_attributes(const GLuint buffer, const GLintptr offset) {
+	glBindBuffer(GL_ARRAY_BUFFER, buffer);
+	for (u32 i = 0u; i < 12u; ++i) {
+		glVertexAttribPointer(3u + i, 4, GL_FLOAT, GL_FALSE, sizeof(se_scene_3d_batch_instance), (const void*)(offset + (GLintptr)(sizeof(s_vec4) * i)));
+	}
+}
+
+static void se_scene_3d_batch_setup_vao(se_scene_3d_batch* batch) {
+	if (batch->vao == 0u) {
+		glGenVertexArrays(1, &batch->vao);
+		batch->layout_dirty = true;
+	}
+	if (!batch->layout_dirty) {
+		return;
 	}
-
-	const s_vec2 ratio = s_vec2(1.0f, 1.0f);
-	se_scene_3d_set_fit_to_window(scene, window, &ratio);
-	se_set_last_error(SE_RESULT_OK);
-	return scene;
+	glBindVertexArray(batch->vao);
+	glBindBuffer(GL_ARRAY_BUFFER, batch->vbo);
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, batch->ebo);
+	glEnableVertexAttribArray(0);
+	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(se_vertex_3d), (const void *)offsetof(se_vertex_3d, position));
+	glEnableVertexAttribArray(1);
+	glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(se_vertex_3d), (const void *)offsetof(se_vertex_3d, normal));
+	glEnableVertexAttribArray(2);
+	glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(se_vertex_3d), (const void *)offsetof(se_vertex_3d, uv));
+	for (u32 i = 0u; i < 12u; ++i) {
+		glEnableVertexAttribArray(3u + i);
+		glVertexAttribDivisor(3u + i, 1);
+	}
+	glBindVertexArray(0);
+	batch->layout_dirty = false;
+}
+
+// Fills visible_instances with the active slots inside the frustum and compacts their buffers
+// to the front of render_buffers and render_metadata.
+static sz se_object_3d_cull_instances(se_object_3d* object, const se_frustum* frustum, const se_box_3d* local_bounds) {
+	se_instance_ids_clear_keep_capacity(&object->visible_instances);
+	for (sz i = 0; i < s_array_get_size(&object->instances.transforms); ++i) {
+		b8* active = s_array_get(&object->instances.actives, s_array_handle(&object->instances.actives, (u32)i));
+		if (!active || !*active) {
+			continue;
+		}
+		s_mat4* instance_transform = s_array_get(&object->instances.transforms, s_array_handle(&object->instances.transforms, (u32)i));
+		const s_mat4 world = s_mat4_mul(&object->transform, instance_transform);
+		se_box_3d instance_bounds = {0};
+		se_box_3d_transform(&instance_bounds, local_bounds, &world);
+		if (!se_frustum_intersects_box_3d(frustum, &instance_bounds)) {
+			continue;
+		}
+		const u32 visible_index = (u32)s_array_get_size(&object->visible_instances);
+		s_mat4* buffer = s_array_get(&object->instances.buffers, s_array_handle(&object->instances.buffers, (u32)i));
+		s_mat4* metadata = s_array_get(&object->instances.metadata, s_array_handle(&object->instances.metadata, (u32)i));
+		s_mat4* render_buffer = s_array_get(&object->render_buffers, s_array_handle(&object->render_buffers, visible_index));
+		s_mat4* render_metadata = s_array_get(&object->render_metadata, s_array_handle(&object->render_metadata, visible_index));
+		if (render_buffer) {
+			*render_buffer = buffer ? *buffer : s_mat4_identity;
+		}
+		if (render_metadata) {
+			*render_metadata = metadata ? *metadata : s_mat4_identity;
+		}
+		s_array_add(&object->visible_instances, (se_instance_id)i);
+	}
+	return s_array_get_size(&object->visible_instances);
+}
+
+// Returns how many instances of `object` to draw, 0 when it is outside the frustum.
+// `out_instance_culled` is set when the survivors were compacted into visible_instances.
+static sz se_scene_3d_cull_object(se_scene_3d* scene_ptr, se_object_3d* object, const se_frustum* frustum, const sz instance_count, b8* out_instance_culled) {
+	*out_instance_culled = false;
+	if (!scene_ptr->enable_frustum_culling || !object->has_bounds) {
+		return instance_count;
+	}
+	scene_ptr->cull_stats.objects_tested++;
+	if (!se_frustum_intersects_box_3d(frustum, &object->bounds)) {
+		scene_ptr->cull_stats.objects_culled++;
+		scene_ptr->cull_stats.instances_culled += (u32)instance_count;
+		return 0;
+	}
+	se_box_3d local_bounds = {0};
+	if (!scene_ptr->enable_instance_culling || !se_model_get_bounds(object->model, &local_bounds)) {
+		return instance_count;
+	}
+	const sz visible_count = se_object_3d_cull_instances(object, frustum, &local_bounds);
+	scene_ptr->cull_stats.instances_tested += (u32)instance_count;
+	scene_ptr->cull_stats.instances_culled += (u32)(instance_count - visible_count);
+	*out_instance_culled = true;
+	return visible_count;
+}
+
+static sz se_object_3d_instance_slot(const se_object_3d* object, const b8 instance_culled, const sz index) {
+	if (!instance_culled) {
+		return index;
+	}
+	se_instance_id* slot = s_array_get((se_instance_ids*)&object->visible_instances, s_array_handle((se_instance_ids*)&object->visible_instances, (u32)index));
+	return slot ? (sz)*slot : index;
+}
+
+static void se_scene_3d_batch_write_instances(se_scene_3d_batch* batch, const s_mat4* vp, se_scene_3d_batch_instance* out) {
+	u32 order_count = 0u;
+	const u32* order = se_draw_batcher_get_draw_order(batch->batcher, &order_count);
+	for (u32 i = 0u; i < order_count; ++i) {
+		const se_scene_3d_batch_draw* draw = &batch->draws[order[i]];
+		se_object_3d* object = draw->object;
+		u32 active_index = 0u;
+		const sz slot_count = draw->instance_culled ? draw->instance_count : s_array_get_size(&object->instances.transforms);
+		for (sz k = 0; k < slot_count && active_index < draw->instance_count; ++k) {
+			const sz j = se_object_3d_instance_slot(object, draw->instance_culled, k);
+			b8* active = s_array_get(&object->instances.actives, s_array_handle(&object->instances.actives, (u32)j));
+			if (!active || !*active) {
+				continue;
+			}
+			s_mat4* instance_transform = s_array_get(&object->instances.transforms, s_array_handle(&object->instances.transforms, (u32)j));
+			s_mat4* buffer = s_array_get(&object->render_buffers, s_array_handle(&object->render_buffers, active_index));
+			s_mat4* metadata = s_array_get(&object->render_metadata, s_array_handle(&object->render_metadata, active_index));
+			s_mat4 model_matrix = s_mat4_mul(&object->transform, instance_transform);
+			model_matrix = s_mat4_mul(&model_matrix, &draw->mesh->matrix);
+			out->transform = vp ? s_mat4_mul(vp, &model_matrix) : model_matrix;
+			out->buffer = buffer ? *buffer : s_mat4_identity;
+			out->metadata = metadata ? *metadata : s_mat4_identity;
+			out++;
+			active_index++;
+		}
+		// Keep the instance stream aligned with the command's base_instance.
+		for (; active_index < draw->instance_count; ++active_index) {
+			out->transform = s_mat4_identity;
+			out->buffer = s_mat4_identity;
+			out->metadata = s_mat4_identity;
+			out++;
+		}
+	}
+}
+
+// Returns false without drawing anything when the frame cannot be batched; the caller then
+// falls back to one instanced draw per mesh.
+// Views a draw item is seen from: the camera and, per render pass index, its shadow pass.
+#define SE_SCENE_3D_VIEW_CAMERA 1u
+#define SE_SCENE_3D_VIEW_SHADOW(pass_index) (2u << (pass_index))
+
+typedef struct {
+	u64 key;
+	u32 sequence;
+	u32 vao;
+	u32 index_count;
+	u32 instance_count;
+	u32 views;
+	se_shader_handle shader;
+} se_scene_3d_draw_item;
+
+// Per-frame draw list of the unbatched path. Shaders get a frame-local ordinal so they fit the
+// 16-bit shader field of the sort key.
+typedef struct se_scene_3d_draw_list {
+	se_scene_3d_draw_item* items;
+	u32 count;
+	u32 capacity;
+	se_shader_handle* shaders;
+	u32 shader_count;
+	u32 shader_capacity;
+} se_scene_3d_draw_list;
+
+static void se_scene_3d_draw_list_destroy(se_scene_3d_draw_list* list) {
+	if (!list) {
+		return;
+	}
+	free(list->items);
+	free(list->shaders);
+	free(list);
+}
+
+static u32 se_scene_3d_draw_list_shader_ordinal(se_scene_3d_draw_list* list, const se_shader_handle shader) {
+	for (u32 i = list->shader_count; i > 0u; --i) {
+		if (list->shaders[i - 1u] == shader) {
+			return i - 1u;
+		}
+	}
+	if (list->shader_count == list->shader_capacity) {
+		const u32 capacity = s_max(16u, list->shader_capacity * 2u);
+		se_shader_handle* shaders = (se_shader_handle*)realloc(list->shaders, sizeof(*shaders) * (sz)capacity);
+		if (!shaders) {
+			return 0xFFFFu;
+		}
+		list->shaders = shaders;
+		list->shader_capacity = capacity;
+	}
+	list->shaders[list->shader_count] = shader;
+	return list->shader_count++;
+}
+
+static b8 se_scene_3d_draw_list_push(se_scene_3d_draw_list* list, const se_scene_3d_draw_item* item) {
+	if (list->count == list->capacity) {
+		const u32 capacity = s_max(64u, list->capacity * 2u);
+		se_scene_3d_draw_item* items = (se_scene_3d_draw_item*)realloc(list->items, sizeof(*items) * (sz)capacity);
+		if (!items) {
+			return false;
+		}
+		list->items = items;
+		list->capacity = capacity;
+	}
+	list->items[list->count] = *item;
+	list->items[list->count].sequence = list->count;
+	list->count++;
+	return true;
+}
+
+static int se_scene_3d_draw_item_compare(const void* a, const void* b) {
+	const se_scene_3d_draw_item* left = (const se_scene_3d_draw_item*)a;
+	const se_scene_3d_draw_item* right = (const se_scene_3d_draw_item*)b;
+	if (left->key != right->key) {
+		return left->key < right->key ? -1 : 1;
+	}
+	return left->sequence < right->sequence ? -1 : (left->sequence > right->sequence ? 1 : 0);
+}
+
+// Normalized depth of the object's bounds center, used only for ordering.
+static f32 se_scene_3d_object_sort_depth(const se_object_3d* object, const s_mat4* vp) {
+	const s_vec3 center = object->has_bounds
+		? s_vec3((object->bounds.min.x + object->bounds.max.x) * 0.5f, (object->bounds.min.y + object->bounds.max.y) * 0.5f, (object->bounds.min.z + object->bounds.max.z) * 0.5f)
+		: s_vec3(object->transform.m[3][0], object->transform.m[3][1], object->transform.m[3][2]);
+	const f32 w = (vp->m[0][3] * center.x) + (vp->m[1][3] * center.y) + (vp->m[2][3] * center.z) + vp->m[3][3];
+	const f32 z = (vp->m[0][2] * center.x) + (vp->m[1][2] * center.y) + (vp->m[2][2] * center.z) + vp->m[3][2];
+	if (w <= 0.000001f) {
+		return 0.0f;
+	}
+	return s_min(s_max((z / w) * 0.5f + 0.5f, 0.0f), 1.0f);
+}
+
+// Binds `shader` with its uniforms and the global ones, counting the switch for draw stats.
+static void se_scene_3d_use_shader(se_context* ctx, se_scene_3d* scene_ptr, const se_shader_handle shader) {
+	se_shader_use(shader, true, true);
+	se_shader* shader_ptr = s_array_get(&ctx->shaders, shader);
+	scene_ptr->draw_stats.shader_switches++;
+	scene_ptr->draw_stats.uniform_uploads += (u32)s_array_get_size(&ctx->global_uniforms);
+	if (shader_ptr) {
+		scene_ptr->draw_stats.uniform_uploads += (u32)s_array_get_size(&shader_ptr->uniforms);
+	}
+}
+
+// Pass list of a scene with more than the main pass. Shadow targets are created on first use.
+typedef struct se_scene_3d_render_passes {
+	se_render_pass passes[SE_SCENE_3D_MAX_RENDER_PASSES];
+	se_shadow_map shadow_maps[SE_SCENE_3D_MAX_RENDER_PASSES];
+	se_framebuffer_handle shadow_targets[SE_SCENE_3D_MAX_RENDER_PASSES];
+	// Light volume of each cascade, for picking the casters of every shadow pass.
+	se_frustum shadow_frusta[SE_SCENE_3D_MAX_RENDER_PASSES][SE_SHADOW_MAX_CASCADES];
+	// SE_SCENE_3D_VIEW_SHADOW bits of the passes fitted this frame.
+	u32 shadow_views;
+	u32 count;
+	se_shader_handle depth_shader;
+} se_scene_3d_render_passes;
+
+static void se_scene_3d_render_passes_destroy(se_scene_3d_render_passes* passes) {
+	if (!passes) {
+		return;
+	}
+	for (u32 i = 0u; i < SE_SCENE_3D_MAX_RENDER_PASSES; ++i) {
+		if (passes->shadow_targets[i] != S_HANDLE_NULL) {
+			se_framebuffer_destroy(passes->shadow_targets[i]);
+		}
+	}
+	if (passes->depth_shader != S_HANDLE_NULL) {
+		se_shader_destroy(passes->depth_shader);
+	}
+	free(passes);
+}
+
+static b8 se_render_pass_is_shadow(const se_render_pass* pass) {
+	return pass->kind == SE_RENDER_PASS_SHADOW_DIRECTIONAL || pass->kind == SE_RENDER_PASS_SHADOW_SPOT;
+}
+
+static b8 se_render_pass_is_valid(const se_render_pass* pass) {
+	switch (pass->kind) {
+		case SE_RENDER_PASS_MAIN:
+		case SE_RENDER_PASS_DEPTH_PREPASS:
+			return true;
+		case SE_RENDER_PASS_SHADOW_DIRECTIONAL:
+			if (pass->cascade_count == 0u || pass->cascade_count > SE_SHADOW_MAX_CASCADES ||
+				!(pass->cascade_lambda >= 0.0f && pass->cascade_lambda <= 1.0f) ||
+				!(pass->distance >= 0.0f) || !(pass->caster_distance >= 0.0f)) {
+				return false;
+			}
+			break;
+		case SE_RENDER_PASS_SHADOW_SPOT:
+			if (!(pass->spot_angle > 0.0f && pass->spot_angle < PI) || !(pass->spot_near > 0.0f) || !(pass->distance > pass->spot_near)) {
+				return false;
+			}
+			break;
+		default:
+			return false;
+	}
+	// The packed map is never taller than it is wide.
+	const u32 cascades = pass->kind == SE_RENDER_PASS_SHADOW_SPOT ? 1u : pass->cascade_count;
+	return pass->resolution > 0u && pass->resolution <= SE_SHADOW_MAX_RESOLUTION / SE_SHADOW_ATLAS_COLUMNS(cascades) &&
+		pass->slope_bias >= 0.0f && pass->depth_bias >= 0.0f && s_vec3_length(&pass->light_direction) >= 0.000001f;
+}
+
+b8 se_render_passes_validate(const se_render_pass* passes, const u32 pass_count) {
+	if (!passes || pass_count == 0u || pass_count > SE_SCENE_3D_MAX_RENDER_PASSES) {
+		return false;
+	}
+	u32 prepass_count = 0u;
+	for (u32 i = 0u; i < pass_count; ++i) {
+		const se_render_pass* pass = &passes[i];
+		if (!se_render_pass_is_valid(pass)) {
+			return false;
+		}
+		// The main pass comes last and only once.
+		if ((pass->kind == SE_RENDER_PASS_MAIN) != (i + 1u == pass_count)) {
+			return false;
+		}
+		if (pass->kind == SE_RENDER_PASS_DEPTH_PREPASS && ++prepass_count > 1u) {
+			return false;
+		}
+	}
+	return true;
+}
+
+b8 se_render_pass_fit_shadow(const se_render_pass* pass, const s_mat4* camera_view_projection, const f32 camera_near, const f32 camera_far, se_shadow_map* out_shadow_map) {
+	if (!pass || !out_shadow_map || !se_render_pass_is_shadow(pass) || !se_render_pass_is_valid(pass)) {
+		return false;
+	}
+	if (pass->kind == SE_RENDER_PASS_SHADOW_SPOT) {
+		out_shadow_map->cascade_count = 1u;
+		out_shadow_map->cascade_splits[0] = pass->spot_near;
+		out_shadow_map->cascade_splits[1] = pass->distance;
+		return se_shadow_fit_spot(&pass->light_position, &pass->light_direction, pass->spot_angle, pass->spot_near, pass->distance, &out_shadow_map->view_projections[0]);
+	}
+	if (!camera_view_projection || !(camera_far > camera_near)) {
+		return false;
+	}
+	se_frustum frustum = {0};
+	s_vec3 corners[8];
+	se_frustum_from_matrix(&frustum, camera_view_projection);
+	if (!se_frustum_get_corners(&frustum, corners)) {
+		return false;
+	}
+	// Orthographic cameras may start at 0, which logarithmic splits cannot.
+	const f32 near = s_max(camera_near, 0.001f);
+	const f32 far = pass->distance > 0.0f ? s_min(pass->distance, camera_far) : camera_far;
+	if (!(far > near) || !se_shadow_cascade_splits(near, far, pass->cascade_count, pass->cascade_lambda, out_shadow_map->cascade_splits)) {
+		return false;
+	}
+	out_shadow_map->cascade_count = pass->cascade_count;
+	const f32 range = camera_far - camera_near;
+	for (u32 c = 0u; c < pass->cascade_count; ++c) {
+		// Depth along the view axis is linear along each frustum edge.
+		const f32 t0 = (out_shadow_map->cascade_splits[c] - camera_near) / range;
+		const f32 t1 = (out_shadow_map->cascade_splits[c + 1u] - camera_near) / range;
+		s_vec3 slice[8];
+		for (u32 i = 0u; i < 4u; ++i) {
+			slice[i] = s_vec3_lerp(&corners[i], &corners[i + 4u], t0);
+			slice[i + 4u] = s_vec3_lerp(&corners[i], &corners[i + 4u], t1);
+		}
+		if (!se_shadow_fit_directional(slice, &pass->light_direction, pass->resolution, pass->caster_distance, &out_shadow_map->view_projections[c])) {
+			return false;
+		}
+	}
+	return true;
+}
+
+// Draws the opaque items of the sorted draw list seen from `view` with the depth-only shader.
+static void se_scene_3d_draw_depth(se_context* ctx, se_scene_3d* scene_ptr, const se_scene_3d_draw_list* draw_list, const u32 view, const se_shader_handle shader, const s_mat4* view_projection) {
+	se_shader_set_mat4(shader, "u_view_proj", view_projection);
+	se_scene_3d_use_shader(ctx, scene_ptr, shader);
+	u32 current_vao = 0u;
+	for (u32 d = 0u; d < draw_list->count; ++d) {
+		const se_scene_3d_draw_item* item = &draw_list->items[d];
+		if (se_render_sort_key_is_translucent(item->key)) {
+			break;
+		}
+		if (!(item->views & view)) {
+			continue;
+		}
+		if (item->vao != current_vao) {
+			glBindVertexArray(item->vao);
+			current_vao = item->vao;
+			scene_ptr->draw_stats.vao_binds++;
+		}
+		glDrawElementsInstanced(GL_TRIANGLES, item->index_count, GL_UNSIGNED_INT, 0, (GLsizei)item->instance_count);
+		scene_ptr->draw_stats.depth_draws++;
+	}
+}
+
+// Fits every shadow pass to the camera before the draw list is built, so objects can be
+// culled against each light volume. Returns true when the scene has shadow passes, fitted or
+// not, since that decides how instances are culled.
+static b8 se_scene_3d_fit_shadow_passes(se_scene_3d* scene_ptr, const s_mat4* vp) {
+	se_scene_3d_render_passes* passes = scene_ptr->render_passes;
+	if (!passes) {
+		return false;
+	}
+	f32 camera_near = 0.1f;
+	f32 camera_far = 100.0f;
+	se_camera* camera = scene_ptr->camera != S_HANDLE_NULL ? se_camera_get(scene_ptr->camera) : NULL;
+	if (camera) {
+		camera_near = camera->near;
+		camera_far = camera->far;
+	}
+	b8 has_shadow_passes = false;
+	passes->shadow_views = 0u;
+	for (u32 i = 0u; i < passes->count; ++i) {
+		se_shadow_map* shadow_map = &passes->shadow_maps[i];
+		if (!se_render_pass_is_shadow(&passes->passes[i])) {
+			continue;
+		}
+		has_shadow_passes = true;
+		if (!se_render_pass_fit_shadow(&passes->passes[i], vp, camera_near, camera_far, shadow_map)) {
+			continue;
+		}
+		for (u32 c = 0u; c < shadow_map->cascade_count; ++c) {
+			se_frustum_from_matrix(&passes->shadow_frusta[i][c], &shadow_map->view_projections[c]);
+		}
+		passes->shadow_views |= SE_SCENE_3D_VIEW_SHADOW(i);
+	}
+	return has_shadow_passes;
+}
+
+// Views `object` is seen from while shadow passes are set. Casters outside the camera need
+// every instance, so only whole objects are culled and the camera counts are kept as usual.
+static u32 se_scene_3d_cull_object_views(se_scene_3d* scene_ptr, const se_object_3d* object, const se_frustum* frustum, const sz instance_count) {
+	const se_scene_3d_render_passes* passes = scene_ptr->render_passes;
+	const u32 shadow_views = object->is_translucent ? 0u : passes->shadow_views;
+	if (!scene_ptr->enable_frustum_culling || !object->has_bounds) {
+		return SE_SCENE_3D_VIEW_CAMERA | shadow_views;
+	}
+	scene_ptr->cull_stats.objects_tested++;
+	u32 views = 0u;
+	if (se_frustum_intersects_box_3d(frustum, &object->bounds)) {
+		views = SE_SCENE_3D_VIEW_CAMERA;
+	} else {
+		scene_ptr->cull_stats.objects_culled++;
+		scene_ptr->cull_stats.instances_culled += (u32)instance_count;
+	}
+	for (u32 i = 0u; i < passes->count; ++i) {
+		if (!(shadow_views & SE_SCENE_3D_VIEW_SHADOW(i))) {
+			continue;
+		}
+		for (u32 c = 0u; c < passes->shadow_maps[i].cascade_count; ++c) {
+			if (se_frustum_intersects_box_3d(&passes->shadow_frusta[i][c], &object->bounds)) {
+				views |= SE_SCENE_3D_VIEW_SHADOW(i);
+				break;
+			}
+		}
+	}
+	return views;
+}
+
+static b8 se_scene_3d_render_shadow_pass(se_context* ctx, se_scene_3d* scene_ptr, se_scene_3d_render_passes* passes, const u32 index, const se_scene_3d_draw_list* draw_list) {
+	const se_render_pass* pass = &passes->passes[index];
+	se_shadow_map* shadow_map = &passes->shadow_maps[index];
+	const u32 columns = SE_SHADOW_ATLAS_COLUMNS(shadow_map->cascade_count);
+	const s_vec2 size = s_vec2((f32)(pass->resolution * columns), (f32)(pass->resolution * SE_SHADOW_ATLAS_ROWS(shadow_map->cascade_count)));
+	se_framebuffer_handle target = passes->shadow_targets[index];
+	if (target == S_HANDLE_NULL) {
+		target = se_framebuffer_create(&size);
+		if (target == S_HANDLE_NULL) {
+			return false;
+		}
+		passes->shadow_targets[index] = target;
+	} else {
+		s_vec2 current_size = s_vec2(0.0f, 0.0f);
+		se_framebuffer_get_size(target, &current_size);
+		if (current_size.x != size.x || current_size.y != size.y) {
+			se_framebuffer_set_size(target, &size);
+		}
+	}
+	se_framebuffer_get_depth_texture_id(target, &shadow_map->depth_texture);
+	se_framebuffer_bind(target);
+	glDepthMask(GL_TRUE);
+	glClear(GL_DEPTH_BUFFER_BIT);
+	if (draw_list) {
+		// Back faces cast the shadow and the offset grows with the slope, which together keep
+		// lit surfaces from shadowing themselves.
+		if (scene_ptr->enable_culling) {
+			glCullFace(GL_FRONT);
+		}
+		glEnable(GL_POLYGON_OFFSET_FILL);
+		glPolygonOffset(pass->slope_bias, pass->depth_bias);
+		for (u32 c = 0u; c < shadow_map->cascade_count; ++c) {
+			glViewport((GLint)((c % columns) * pass->resolution), (GLint)((c / columns) * pass->resolution), (GLsizei)pass->resolution, (GLsizei)pass->resolution);
+			se_scene_3d_draw_depth(ctx, scene_ptr, draw_list, SE_SCENE_3D_VIEW_SHADOW(index), passes->depth_shader, &shadow_map->view_projections[c]);
+		}
+		glDisable(GL_POLYGON_OFFSET_FILL);
+		if (scene_ptr->enable_culling) {
+			glCullFace(GL_BACK);
+		}
+	}
+	return true;
+}
+
+// Runs every pass before the main one, leaving the scene output bound. Returns true when the
+// output holds prepass depth.
+static b8 se_scene_3d_render_depth_passes(se_context* ctx, se_scene_3d* scene_ptr, const s_mat4* vp, const se_scene_3d_draw_list* draw_list) {
+	se_scene_3d_render_passes* passes = scene_ptr->render_passes;
+	if (!passes) {
+		return false;
+	}
+	if (passes->depth_shader == S_HANDLE_NULL) {
+		passes->depth_shader = se_shader_load(SE_SCENE_3D_DEPTH_VERTEX_SHADER_PATH, SE_SCENE_3D_DEPTH_FRAGMENT_SHADER_PATH);
+		if (passes->depth_shader == S_HANDLE_NULL) {
+			return false;
+		}
+	}
+	b8 depth_prepass = false;
+	b8 output_bound = true;
+	for (u32 i = 0u; i < passes->count; ++i) {
+		const se_render_pass* pass = &passes->passes[i];
+		if (se_render_pass_is_shadow(pass)) {
+			if (passes->shadow_views & SE_SCENE_3D_VIEW_SHADOW(i)) {
+				se_scene_3d_render_shadow_pass(ctx, scene_ptr, passes, i, draw_list);
+				output_bound = false;
+			}
+			continue;
+		}
+		if (pass->kind != SE_RENDER_PASS_DEPTH_PREPASS || !draw_list) {
+			continue;
+		}
+		if (!output_bound) {
+			se_framebuffer_bind(scene_ptr->output);
+			output_bound = true;
+		}
+		const s_mat4 view_projection = scene_ptr->world_space_instances ? *vp : s_mat4_identity;
+		glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
+		se_scene_3d_draw_depth(ctx, scene_ptr, draw_list, SE_SCENE_3D_VIEW_CAMERA, passes->depth_shader, &view_projection);
+		glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+		depth_prepass = true;
+	}
+	if (!output_bound) {
+		se_framebuffer_bind(scene_ptr->output);
+	}
+	return depth_prepass;
+}
+
+// Queues one draw per mesh of `model` for `instance_count` instances. With `upload`, the world
+// matrices of `slots` (every active slot when NULL) are first written to `render_transforms`
+// and uploaded through each mesh instance.
+static void se_scene_3d_queue_model_draws(
+	se_context* ctx,
+	se_scene_3d* scene_ptr,
+	se_scene_3d_draw_list* draw_list,
+	const se_object_3d* object,
+	se_model* model,
+	se_mesh_instances* mesh_instances,
+	se_transforms* render_transforms,
+	se_instance_ids* slots,
+	const sz instance_count,
+	const b8 upload,
+	const u32 views,
+	const s_mat4* vp,
+	const f32 depth
+) {
+	const sz mesh_count = s_array_get_size(mesh_instances);
+	sz mesh_index = 0;
+	for (sz m = 0; m < s_array_get_size(&model->meshes); ++m) {
+		se_mesh *mesh = s_array_get(&model->meshes, s_array_handle(&model->meshes, (u32)m));
+		if (mesh_index >= mesh_count) {
+			break;
+		}
+		se_mesh_instance *mesh_instance = s_array_get(mesh_instances, s_array_handle(mesh_instances, (u32)mesh_index));
+		mesh_index++;
+		if (mesh == NULL || !se_mesh_has_gpu_data(mesh) || mesh->gpu.index_count == 0) {
+			continue;
+		}
+		if (mesh_instance == NULL || mesh_instance->vao == 0) {
+			continue;
+		}
+		if (upload) {
+			sz active_index = 0;
+			const sz slot_count = slots ? instance_count : s_array_get_size(&object->instances.transforms);
+			for (sz k = 0; k < slot_count; ++k) {
+				const sz j = slots ? (sz)*se_instances_slot(slots, k) : k;
+				b8* active = s_array_get((se_instance_actives*)&object->instances.actives, s_array_handle((se_instance_actives*)&object->instances.actives, (u32)j));
+				if (!active || !*active) {
+					continue;
+				}
+				s_mat4 *instance_transform = s_array_get((se_transforms*)&object->instances.transforms, s_array_handle((se_transforms*)&object->instances.transforms, (u32)j));
+				s_mat4 *out_buffer = s_array_get(render_transforms, s_array_handle(render_transforms, (u32)active_index));
+				if (!instance_transform || !out_buffer) {
+					continue;
+				}
+				s_mat4 model_matrix = s_mat4_mul(&object->transform, instance_transform);
+				model_matrix = s_mat4_mul(&model_matrix, &mesh->matrix);
+				*out_buffer = scene_ptr->world_space_instances ? model_matrix : s_mat4_mul(vp, &model_matrix);
+				active_index++;
+			}
+			mesh_instance->instance_buffers_dirty = true;
+			se_mesh_instance_update(mesh_instance);
+		}
+
+		se_shader_handle shader = mesh->shader;
+		if (shader == S_HANDLE_NULL) {
+			se_log("se_scene_3d_render_to_buffer :: mesh->shader is null");
+			continue;
+		}
+		se_scene_3d_draw_item item = {
+			.vao = mesh_instance->vao,
+			.index_count = mesh->gpu.index_count,
+			.instance_count = (u32)instance_count,
+			.views = views,
+			.shader = shader
+		};
+		if (draw_list) {
+			const u32 shader_ordinal = se_scene_3d_draw_list_shader_ordinal(draw_list, shader);
+			item.key = object->is_translucent
+				? se_render_sort_key_translucent(0u, 0u, depth, shader_ordinal)
+				: se_render_sort_key_opaque(0u, 0u, shader_ordinal, mesh_instance->vao, depth);
+		}
+		if ((draw_list && se_scene_3d_draw_list_push(draw_list, &item)) || !(views & SE_SCENE_3D_VIEW_CAMERA)) {
+			continue;
+		}
+		// Out of memory for the draw list: draw in scene order instead.
+		if (scene_ptr->world_space_instances) {
+			se_shader_set_mat4(shader, "u_view_proj", vp);
+		}
+		se_scene_3d_use_shader(ctx, scene_ptr, shader);
+		glBindVertexArray(item.vao);
+		glDrawElementsInstanced(GL_TRIANGLES, item.index_count, GL_UNSIGNED_INT, 0, (GLsizei)item.instance_count);
+		scene_ptr->draw_stats.vao_binds++;
+		scene_ptr->draw_stats.draws++;
+	}
+}
+
+typedef struct {
+	s_vec3 camera_position;
+	// Projection's m[1][1]: 1 / tan(fov / 2) for perspective, 2 / height for orthographic.
+	f32 projection_scale;
+	b8 orthographic;
+} se_scene_3d_lod_view;
+
+// Value compared against LOD thresholds; both metrics grow as the instance gets coarser.
+static f32 se_scene_3d_lod_metric_value(const se_object_3d_lods* lods, const se_scene_3d_lod_view* view, const s_vec3* center, const f32 radius) {
+	const s_vec3 offset = s_vec3_sub(center, &view->camera_position);
+	const f32 distance = s_vec3_length(&offset);
+	if (lods->metric == SE_LOD_METRIC_DISTANCE) {
+		return distance;
+	}
+	// Projected radius in NDC units; its reciprocal keeps thresholds increasing.
+	const f32 size = view->orthographic
+		? radius * view->projection_scale
+		: radius * view->projection_scale / s_max(distance, 0.000001f);
+	return 1.0f / s_max(size, 0.000001f);
+}
+
+// Sizes a level's render arrays to `capacity` and points its mesh instances at them.
+static b8 se_object_3d_lod_prepare(se_context* ctx, se_object_3d_lod* level, const sz capacity) {
+	if (level->capacity >= capacity && s_array_get_size(&level->mesh_instances) > 0) {
+		return true;
+	}
+	se_model* model = se_model_from_handle(ctx, level->model);
+	if (!model) {
+		return false;
+	}
+	s_array_reserve(&level->render_transforms, capacity);
+	s_array_reserve(&level->render_buffers, capacity);
+	s_array_reserve(&level->render_metadata, capacity);
+	while (s_array_get_size(&level->render_transforms) < capacity) {
+		s_array_add(&level->render_transforms, s_mat4_identity);
+		s_array_add(&level->render_buffers, s_mat4_identity);
+		s_array_add(&level->render_metadata, s_mat4_identity);
+	}
+	level->capacity = capacity;
+	if (s_array_get_size(&level->mesh_instances) == 0) {
+		const sz mesh_count = s_array_get_size(&model->meshes);
+		s_array_init(&level->mesh_instances);
+		s_array_reserve(&level->mesh_instances, mesh_count);
+		for (sz i = 0; i < mesh_count; ++i) {
+			se_mesh* mesh = s_array_get(&model->meshes, s_array_handle(&model->meshes, (u32)i));
+			s_handle mesh_inst_handle = s_array_increment(&level->mesh_instances);
+			se_mesh_instance* mesh_instance = s_array_get(&level->mesh_instances, mesh_inst_handle);
+			memset(mesh_instance, 0, sizeof(*mesh_instance));
+			if (!se_mesh_has_gpu_data(mesh)) {
+				continue;
+			}
+			se_mesh_instance_create(mesh_instance, mesh, (u32)capacity);
+			se_mesh_instance_add_buffer(mesh_instance, s_array_get_data(&level->render_transforms), capacity);
+			se_mesh_instance_add_buffer(mesh_instance, s_array_get_data(&level->render_buffers), capacity);
+			se_mesh_instance_add_buffer(mesh_instance, s_array_get_data(&level->render_metadata), capacity);
+		}
+		return true;
+	}
+	for (sz i = 0; i < s_array_get_size(&level->mesh_instances); ++i) {
+		se_mesh_instance* mesh_instance = s_array_get(&level->mesh_instances, s_array_handle(&level->mesh_instances, (u32)i));
+		if (!mesh_instance) {
+			continue;
+		}
+		se_instance_buffer* transform_buffer = s_array_get(&mesh_instance->instance_buffers, s_array_handle(&mesh_instance->instance_buffers, 0u));
+		if (transform_buffer) {
+			transform_buffer->buffer_ptr = s_array_get_data(&level->render_transforms);
+			transform_buffer->buffer_size = sizeof(s_mat4) * capacity;
+		}
+		se_instance_buffer* buffer_buffer = s_array_get(&mesh_instance->instance_buffers, s_array_handle(&mesh_instance->instance_buffers, 1u));
+		if (buffer_buffer) {
+			buffer_buffer->buffer_ptr = s_array_get_data(&level->render_buffers);
+			buffer_buffer->buffer_size = sizeof(s_mat4) * capacity;
+		}
+		se_instance_buffer* metadata_buffer = s_array_get(&mesh_instance->instance_buffers, s_array_handle(&mesh_instance->instance_buffers, 2u));
+		if (metadata_buffer) {
+			metadata_buffer->buffer_ptr = s_array_get_data(&level->render_metadata);
+			metadata_buffer->buffer_size = sizeof(s_mat4) * capacity;
+		}
+		mesh_instance->instance_buffers_dirty = true;
+	}
+	return true;
+}
+
+// Picks a level per instance from its world bounds, then queues each non-empty level as its
+// own instanced draw with the slots compacted into that level's buffers. Those buffers are only
+// rebuilt when `upload` is set or an instance changed level, since level membership is otherwise
+// what it was last frame.
+static void se_scene_3d_queue_lod_draws(
+	se_context* ctx,
+	se_scene_3d* scene_ptr,
+	se_scene_3d_draw_list* draw_list,
+	se_object_3d* object,
+	se_instance_ids* slots,
+	const sz instance_count,
+	const b8 upload,
+	const u32 views,
+	const s_mat4* vp,
+	const se_scene_3d_lod_view* view,
+	const f32 depth
+) {
+	se_object_3d_lods* lods = object->lods;
+	const sz slot_total = s_array_get_size(&object->instances.ids);
+	if (slot_total > lods->instance_level_capacity) {
+		u8* instance_levels = (u8*)realloc(lods->instance_levels, slot_total * sizeof(*instance_levels));
+		if (!instance_levels) {
+			return;
+		}
+		memset(instance_levels + lods->instance_level_capacity, 0, (slot_total - lods->instance_level_capacity) * sizeof(*instance_levels));
+		lods->instance_levels = instance_levels;
+		lods->instance_level_capacity = slot_total;
+	}
+	f32 thresholds[SE_OBJECT_3D_MAX_LODS] = {0};
+	for (u32 l = 0u; l < lods->level_count; ++l) {
+		const f32 threshold = lods->levels[l].threshold;
+		thresholds[l] = (lods->metric == SE_LOD_METRIC_SCREEN_SIZE && l > 0u) ? 1.0f / threshold : threshold;
+		se_instance_ids_clear_keep_capacity(&lods->levels[l].slots);
+	}
+	se_box_3d local_bounds = {0};
+	const b8 has_local_bounds = se_model_get_bounds(object->model, &local_bounds);
+	const sz slot_count = slots ? instance_count : slot_total;
+	b8 switched = false;
+	for (sz k = 0; k < slot_count; ++k) {
+		const sz j = slots ? (sz)*se_instances_slot(slots, k) : k;
+		if (!*se_instances_slot(&object->instances.actives, j)) {
+			continue;
+		}
+		const s_mat4 world = s_mat4_mul(&object->transform, se_instances_slot(&object->instances.transforms, j));
+		s_vec3 center = s_vec3(world.m[3][0], world.m[3][1], world.m[3][2]);
+		f32 radius = 0.0f;
+		if (has_local_bounds) {
+			se_box_3d instance_bounds = {0};
+			se_box_3d_transform(&instance_bounds, &local_bounds, &world);
+			center = s_vec3((instance_bounds.min.x + instance_bounds.max.x) * 0.5f, (instance_bounds.min.y + instance_bounds.max.y) * 0.5f, (instance_bounds.min.z + instance_bounds.max.z) * 0.5f);
+			const s_vec3 half_extent = s_vec3_sub(&instance_bounds.max, &center);
+			radius = s_vec3_length(&half_extent);
+		}
+		const f32 value = se_scene_3d_lod_metric_value(lods, view, &center, radius);
+		const u32 previous = lods->instance_levels[j];
+		const u32 level = se_lod_select(thresholds, lods->level_count, value, previous, lods->hysteresis);
+		if (level != previous) {
+			lods->instance_levels[j] = (u8)level;
+			scene_ptr->lod_stats.switches++;
+			switched = true;
+		}
+		s_array_add(&lods->levels[level].slots, (se_instance_id)j);
+	}
+	for (u32 l = 0u; l < lods->level_count; ++l) {
+		se_object_3d_lod* level = &lods->levels[l];
+		const sz level_count = s_array_get_size(&level->slots);
+		if (level_count == 0) {
+			continue;
+		}
+		se_model* model = se_model_from_handle(ctx, l == 0u ? object->model : level->model);
+		if (!model) {
+			continue;
+		}
+		const sz previous_capacity = level->capacity;
+		if (l > 0u && !se_object_3d_lod_prepare(ctx, level, s_array_get_capacity(&object->instances.ids))) {
+			continue;
+		}
+		// A freshly sized level has never been filled.
+		const b8 level_upload = upload || switched || level->capacity != previous_capacity;
+		se_mesh_instances* mesh_instances = l == 0u ? &object->mesh_instances : &level->mesh_instances;
+		se_transforms* render_transforms = l == 0u ? &object->render_transforms : &level->render_transforms;
+		se_buffers* render_buffers = l == 0u ? &object->render_buffers : &level->render_buffers;
+		se_buffers* render_metadata = l == 0u ? &object->render_metadata : &level->render_metadata;
+		for (sz k = 0; level_upload && k < level_count; ++k) {
+			const sz j = (sz)*se_instances_slot(&level->slots, k);
+			*se_instances_slot(render_buffers, k) = *se_instances_slot(&object->instances.buffers, j);
+			*se_instances_slot(render_metadata, k) = *se_instances_slot(&object->instances.metadata, j);
+		}
+		se_scene_3d_queue_model_draws(ctx, scene_ptr, draw_list, object, model, mesh_instances, render_transforms, &level->slots, level_count, level_upload, views, vp, depth);
+		scene_ptr->lod_stats.instances[l] += (u32)level_count;
+	}
+	scene_ptr->lod_stats.objects++;
+}
+
+static b8 se_scene_3d_render_batched(se_context* ctx, se_scene_3d* scene_ptr, const s_mat4* vp, const se_frustum* frustum) {
+	// Depth and shadow passes replay the per-object draw list.
+	if (scene_ptr->render_passes) {
+		return false;
+	}
+	se_scene_3d_batch* batch = se_scene_3d_batch_get(scene_ptr);
+	if (!batch || !batch->available) {
+		return false;
+	}
+	se_draw_batcher_clear_draws(batch->batcher);
+	u32 draw_count = 0u;
+	u32 instance_total = 0u;
+	for (sz i = 0; i < s_array_get_size(&scene_ptr->objects); ++i) {
+		se_object_3d_handle object_handle = *s_array_get(&scene_ptr->objects, s_array_handle(&scene_ptr->objects, (u32)i));
+		se_object_3d* object = object_handle != S_HANDLE_NULL ? se_object_3d_from_handle(ctx, object_handle) : NULL;
+		if (!object || !object->is_visible || object->is_custom || object->model == S_HANDLE_NULL) {
+			continue;
+		}
+		// LOD levels are drawn through their own mesh instances.
+		if (object->lods && object->lods->level_count > 1u) {
+			return false;
+		}
+		se_model* model = se_model_from_handle(ctx, object->model);
+		if (!model) {
+			continue;
+		}
+		const sz active_count = se_instances_active_count(&object->instances.actives);
+		if (se_object_3d_are_instances_dirty(object_handle) || active_count != s_array_get_size(&object->render_transforms)) {
+			se_object_3d_sync_render_instances(object);
+		}
+		b8 instance_culled = false;
+		const u32 instance_count = (u32)se_scene_3d_cull_object(scene_ptr, object, frustum, s_array_get_size(&object->render_transforms), &instance_culled);
+		if (instance_count == 0u) {
+			continue;
+		}
+		const sz mesh_count = s_array_get_size(&object->mesh_instances);
+		for (sz m = 0; m < s_array_get_size(&model->meshes) && m < mesh_count; ++m) {
+			se_mesh* mesh = s_array_get(&model->meshes, s_array_handle(&model->meshes, (u32)m));
+			se_mesh_instance* mesh_instance = s_array_get(&object->mesh_instances, s_array_handle(&object->mesh_instances, (u32)m));
+			if (mesh == NULL || !se_mesh_has_gpu_data(mesh) || mesh->gpu.index_count == 0 || mesh->shader == S_HANDLE_NULL) {
+				continue;
+			}
+			if (mesh_instance == NULL || mesh_instance->vao == 0) {
+				continue;
+			}
+			const u64 key = ((u64)mesh->gpu.vbo << 32) | (u64)mesh->gpu.ebo;
+			const u32 slot = se_draw_batcher_add_mesh(batch->batcher, key, mesh->gpu.vertex_count, mesh->gpu.index_count);
+			u32 arena_mesh_count = 0u;
+			const se_draw_batch_mesh* arena_meshes = se_draw_batcher_get_meshes(batch->batcher, &arena_mesh_count, NULL, NULL);
+			if (slot == UINT32_MAX) {
+				// Out of mesh slots: grow so the next frame fits. Running out of 32-bit vertex or
+				// index offsets cannot be fixed by growing, so that frame just draws unbatched.
+				if (arena_mesh_count >= batch->max_meshes) {
+					se_scene_3d_batch_grow_batcher(batch, true, false);
+				}
+				return false;
+			}
+			if (arena_meshes[slot].vertex_count != mesh->gpu.vertex_count ||
+				arena_meshes[slot].index_count != mesh->gpu.index_count) {
+				// A buffer name was reused for different geometry: repack next frame.
+				se_scene_3d_batch_release_gl(batch);
+				return false;
+			}
+			if (draw_count >= batch->max_draws) {
+				se_scene_3d_batch_grow_batcher(batch, false, true);
+				return false;
+			}
+			if (!se_draw_batcher_add_draw(batch->batcher, (u64)mesh->shader, slot, instance_count, draw_count)) {
+				return false;
+			}
+			batch->draws[draw_count].object = object;
+			batch->draws[draw_count].mesh = mesh;
+			batch->draws[draw_count].instance_count = instance_count;
+			batch->draws[draw_count].instance_culled = instance_culled;
+			draw_count++;
+			instance_total += instance_count;
+		}
+		for (sz m = 0; m < mesh_count; ++m) {
+			se_mesh_instance* mesh_instance = s_array_get(&object->mesh_instances, s_array_handle(&object->mesh_instances, (u32)m));
+			if (mesh_instance) {
+				mesh_instance->instance_buffers_dirty = false;
+			}
+		}
+	}
+
+	memset(&batch->stats, 0, sizeof(batch->stats));
+	batch->stats.multi_draw_indirect = batch->multi_draw_indirect;
+	if (draw_count == 0u || !se_draw_batcher_build(batch->batcher)) {
+		return true;
+	}
+	se_scene_3d_batch_upload_arena(batch);
+	se_scene_3d_batch_setup_vao(batch);
+
+	const s_mat4* instance_vp = scene_ptr->world_space_instances ? NULL : vp;
+	const GLsizeiptr instance_bytes = (GLsizeiptr)instance_total * (GLsizeiptr)sizeof(se_scene_3d_batch_instance);
+	GLuint instance_buffer = se_gl_stream_buffer();
+	GLintptr instance_offset = 0;
+	se_scene_3d_batch_instance* instances = (se_scene_3d_batch_instance*)se_gl_stream_map(instance_bytes, (GLsizeiptr)sizeof(s_vec4), &instance_offset);
+	if (instances) {
+		se_scene_3d_batch_write_instances(batch, instance_vp, instances);
+		se_gl_stream_commit(instances);
+		instance_buffer = se_gl_stream_buffer();
+	} else {
+		if (batch->instance_vbo == 0u) {
+			glGenBuffers(1, &batch->instance_vbo);
+		}
+		instance_buffer = batch->instance_vbo;
+		instance_offset = 0;
+		glBindBuffer(GL_ARRAY_BUFFER, instance_buffer);
+		instances = (se_scene_3d_batch_instance*)se_gl_buffer_data_reserve(GL_ARRAY_BUFFER, instance_bytes, GL_STREAM_DRAW);
+		if (!instances) {
+			glBindBuffer(GL_ARRAY_BUFFER, 0);
+			return false;
+		}
+		se_scene_3d_batch_write_instances(batch, instance_vp, instances);
+		se_gl_buffer_upload_commit(instances);
+	}
+
+	u32 command_count = 0u;
+	u32 batch_count = 0u;
+	const se_draw_indirect_command* commands = se_draw_batcher_get_commands(batch->batcher, &command_count);
+	const se_draw_batch* batches = se_draw_batcher_get_batches(batch->batcher, &batch_count);
+	glBindVertexArray(batch->vao);
+	scene_ptr->draw_stats.vao_binds++;
+	se_scene_3d_batch_set_instance_attributes(instance_buffer, instance_offset);
+	// GLES reserves the base_instance field, so indirect draws there cannot offset the instances.
+#if defined(SE_RENDER_BACKEND_GLES)
+	const b8 use_indirect = false;
+#else
+	const b8 use_indirect = batch->multi_draw_indirect;
+#endif
+	if (use_indirect) {
+		if (batch->indirect_buffer == 0u) {
+			glGenBuffers(1, &batch->indirect_buffer);
+		}
+		glBindBuffer(GL_DRAW_INDIRECT_BUFFER, batch->indirect_buffer);
+		glBufferData(GL_DRAW_INDIRECT_BUFFER, (GLsizeiptr)(sizeof(*commands) * command_count), commands, GL_STREAM_DRAW);
+	}
+	for (u32 b = 0u; b < batch_count; ++b) {
+		const se_draw_batch* draw_batch = &batches[b];
+		if (scene_ptr->world_space_instances) {
+			se_shader_set_mat4((se_shader_handle)draw_batch->shader, "u_view_proj", vp);
+		}
+		se_scene_3d_use_shader(ctx, scene_ptr, (se_shader_handle)draw_batch->shader);
+		if (use_indirect) {
+			glMultiDrawElementsIndirect(GL_TRIANGLES, GL_UNSIGNED_INT,
+				(const void*)(uintptr_t)(sizeof(*commands) * draw_batch->first_command),
+				(GLsizei)draw_batch->command_count, 0);
+			scene_ptr->draw_stats.draws++;
+			continue;
+		}
+		for (u32 c = 0u; c < draw_batch->command_count; ++c) {
+			const se_draw_indirect_command* command = &commands[draw_batch->first_command + c];
+			se_scene_3d_batch_set_instance_attributes(instance_buffer,
+				instance_offset + (GLintptr)command->base_instance * (GLintptr)sizeof(se_scene_3d_batch_instance));
+			glDrawElementsInstancedBaseVertex(GL_TRIANGLES, (GLsizei)command->count, GL_UNSIGNED_INT,
+				(const void*)(uintptr_t)(sizeof(u32) * command->first_index),
+				(GLsizei)command->instance_count, command->base_vertex);
+			scene_ptr->draw_stats.draws++;
+		}
+	}
+	if (use_indirect) {
+		glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+	}
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+	glBindVertexArray(0);
+
+	batch->stats.batches = batch_count;
+	batch->stats.commands = command_count;
+	batch->stats.instances = instance_total;
+	batch->stats.arena_meshes = batch->arena_mesh_count;
+	return true;
+}
+
+se_scene_3d_handle se_scene_3d_create(const s_vec2 *size, const u16 object_count) {
+	se_context *ctx = se_current_context();
+	if (!ctx || !size) {
+		se_set_last_error(SE_RESULT_INVALID_ARGUMENT);
+		return S_HANDLE_NULL;
+	}
+	if (s_array_get_capacity(&ctx->scenes_3d) == 0) {
+		s_array_init(&ctx->scenes_3d);
+	}
+	if (s_array_get_size(&ctx->scenes_3d) >= SE_MAX_SCENES) {
+		se_set_last_error(SE_RESULT_OUT_OF_MEMORY);
+		return S_HANDLE_NULL;
+	}
+	se_scene_3d_handle scene_handle = s_array_increment(&ctx->scenes_3d);
+	se_scene_3d *new_scene = s_array_get(&ctx->scenes_3d, scene_handle);
+	memset(new_scene, 0, sizeof(*new_scene));
+	se_framebuffer_handle framebuffer = se_framebuffer_create(size);
+	if (framebuffer == S_HANDLE_NULL) {
+		s_array_remove(&ctx->scenes_3d, scene_handle);
+		return S_HANDLE_NULL;
+	}
+	new_scene->output = framebuffer;
+	s_array_init(&new_scene->objects);
+	s_array_init(&new_scene->post_process);
+	s_array_init(&new_scene->custom_renders);
+	if (object_count > 0) {
+		s_array_reserve(&new_scene->objects, object_count);
+		s_array_reserve(&new_scene->post_process, object_count);
+	}
+	s_array_reserve(&new_scene->custom_renders, 8);
+	new_scene->output_shader = S_HANDLE_NULL;
+	se_camera_handle camera = se_camera_create();
+	if (camera == S_HANDLE_NULL) {
+		se_framebuffer_destroy(new_scene->output);
+		s_array_remove(&ctx->scenes_3d, scene_handle);
+		return S_HANDLE_NULL;
+	}
+	new_scene->camera = camera;
+	new_scene->enable_culling = true;
+	new_scene->last_vp = s_mat4_identity;
+	new_scene->has_last_vp = false;
+	if (new_scene->camera != S_HANDLE_NULL) {
+		se_camera_set_aspect(new_scene->camera, size->x, size->y);
+	}
+	se_set_last_error(SE_RESULT_OK);
+	return scene_handle;
+}
+
+se_scene_3d_handle se_scene_3d_create_for_window(const se_window_handle window, const u16 object_count) {
+	se_context *ctx = se_current_context();
+	if (!ctx || window == S_HANDLE_NULL) {
+		se_set_last_error(SE_RESULT_INVALID_ARGUMENT);
+		return S_HANDLE_NULL;
+	}
+	se_window *window_ptr = s_array_get(&ctx->windows, window);
+	const s_vec2 size = s_vec2((f32)window_ptr->width, (f32)window_ptr->height);
+	se_scene_3d_handle scene = se_scene_3d_create(&size, object_count);
+	if (scene == S_HANDLE_NULL) {
+		return S_HANDLE_NULL;
+	}
+
+	const s_vec2 ratio = s_vec2(1.0f, 1.0f);
+	se_scene_3d_set_fit_to_window(scene, window, &ratio);
+	se_set_last_error(SE_RESULT_OK);
+	return scene;
 }
 
 static void se_scene_3d_resize_callback(const se_window_handle window, void *scene_data) {
@@ -3011,6 +5193,14 @@ void se_scene_3d_destroy(const se_scene_3d_handle scene) {
 		se_framebuffer_destroy(scene_ptr->output);
 		scene_ptr->output = S_HANDLE_NULL;
 	}
+	se_scene_3d_batch_destroy(scene_ptr->batch);
+	scene_ptr->batch = NULL;
+	se_scene_3d_draw_list_destroy(scene_ptr->draw_list);
+	scene_ptr->draw_list = NULL;
+	se_scene_3d_render_passes_destroy(scene_ptr->render_passes);
+	scene_ptr->render_passes = NULL;
+	se_scene_spatial_destroy(scene_ptr->spatial);
+	scene_ptr->spatial = NULL;
 	s_array_clear(&scene_ptr->post_process);
 	s_array_clear(&scene_ptr->custom_renders);
 	s_array_clear(&scene_ptr->objects);
@@ -3118,6 +5308,7 @@ void se_scene_3d_render_to_buffer(const se_scene_3d_handle scene) {
 	se_scene_3d *scene_ptr = se_scene_3d_from_handle(ctx, scene);
 	s_assertf(scene_ptr, "se_scene_3d_render_to_buffer :: scene is null");
 	s_assertf(scene_ptr->output != S_HANDLE_NULL, "se_scene_3d_render_to_buffer :: scene output is null");
+	se_scene_3d_update_world_transforms(ctx, scene_ptr);
 
 	se_framebuffer_bind(scene_ptr->output);
 	se_render_clear();
@@ -3142,9 +5333,57 @@ void se_scene_3d_render_to_buffer(const se_scene_3d_handle scene) {
 	if (scene_ptr->has_last_vp) {
 		camera_changed = !se_mat4_near_equal(&scene_ptr->last_vp, &vp, 0.00001f);
 	}
+	// World-space instances only depend on the camera through u_view_proj.
+	b8 refresh_instances = scene_ptr->world_space_instances ? !scene_ptr->has_last_vp : camera_changed;
 	scene_ptr->last_vp = vp;
 	scene_ptr->has_last_vp = true;
+	se_frustum frustum = {0};
+	se_frustum_from_matrix(&frustum, &vp);
+	se_scene_3d_lod_view lod_view = {
+		.camera_position = s_vec3(0.0f, 0.0f, 0.0f),
+		.projection_scale = proj.m[1][1],
+		.orthographic = proj.m[2][3] == 0.0f
+	};
+	if (scene_ptr->camera != S_HANDLE_NULL) {
+		se_camera_get_location(scene_ptr->camera, &lod_view.camera_position);
+	}
+	memset(&scene_ptr->cull_stats, 0, sizeof(scene_ptr->cull_stats));
+	memset(&scene_ptr->draw_stats, 0, sizeof(scene_ptr->draw_stats));
+	memset(&scene_ptr->lod_stats, 0, sizeof(scene_ptr->lod_stats));
+
+	if (scene_ptr->enable_batching) {
+		if (se_scene_3d_render_batched(ctx, scene_ptr, &vp, &frustum)) {
+			for (sz i = 0; i < s_array_get_size(&scene_ptr->objects); ++i) {
+				se_object_3d_handle object_handle = *s_array_get(&scene_ptr->objects, s_array_handle(&scene_ptr->objects, (u32)i));
+				se_object_3d *object = object_handle != S_HANDLE_NULL ? se_object_3d_from_handle(ctx, object_handle) : NULL;
+				if (object && object->is_visible && object->is_custom && object->custom.render) {
+					object->custom.render(object->custom.data);
+				}
+			}
+			se_scene_3d_invoke_custom_renders(scene, scene_ptr);
+			se_framebuffer_unbind(scene_ptr->output);
+			se_debug_trace_end("scene3d_render");
+			return;
+		}
+		// Batching skips the per-mesh instance buffers, so they have to be refreshed here.
+		refresh_instances = true;
+		memset(&scene_ptr->cull_stats, 0, sizeof(scene_ptr->cull_stats));
+		memset(&scene_ptr->draw_stats, 0, sizeof(scene_ptr->draw_stats));
+	}
+
+	se_scene_3d_draw_list* draw_list = scene_ptr->draw_list;
+	if (!draw_list) {
+		draw_list = (se_scene_3d_draw_list*)calloc(1u, sizeof(*draw_list));
+		scene_ptr->draw_list = draw_list;
+	}
+	if (draw_list) {
+		draw_list->count = 0u;
+		draw_list->shader_count = 0u;
+	}
 
+	const b8 shadow_casters = se_scene_3d_fit_shadow_passes(scene_ptr, &vp);
+	// Custom objects keep their scene order and draw between the opaque and translucent meshes.
+	b8 has_custom_objects = false;
 	for (sz i = 0; i < s_array_get_size(&scene_ptr->objects); ++i) {
 		se_object_3d_handle object_handle = *s_array_get(&scene_ptr->objects, s_array_handle(&scene_ptr->objects, (u32)i));
 		if (object_handle == S_HANDLE_NULL) {
@@ -3155,9 +5394,7 @@ void se_scene_3d_render_to_buffer(const se_scene_3d_handle scene) {
 			continue;
 		}
 		if (object->is_custom) {
-			if (object->custom.render) {
-				object->custom.render(object->custom.data);
-			}
+			has_custom_objects = has_custom_objects || object->custom.render != NULL;
 			continue;
 		}
 		if (object->model == S_HANDLE_NULL) {
@@ -3168,63 +5405,101 @@ void se_scene_3d_render_to_buffer(const se_scene_3d_handle scene) {
 			continue;
 		}
 		const sz active_count = se_instances_active_count(&object->instances.actives);
-		const b8 object_dirty = se_object_3d_are_instances_dirty(object_handle);
-		if (object_dirty || active_count != s_array_get_size(&object->render_transforms)) {
+		const b8 object_dirty = se_object_3d_are_instances_dirty(object_handle) || active_count != s_array_get_size(&object->render_transforms);
+		if (object_dirty) {
 			se_object_3d_sync_render_instances(object);
 		}
-		const sz instance_count = s_array_get_size(&object->render_transforms);
+		b8 instance_culled = false;
+		u32 views = SE_SCENE_3D_VIEW_CAMERA;
+		sz instance_count = s_array_get_size(&object->render_transforms);
+		if (shadow_casters) {
+			views = se_scene_3d_cull_object_views(scene_ptr, object, &frustum, instance_count);
+			instance_count = views ? instance_count : 0;
+		} else {
+			instance_count = se_scene_3d_cull_object(scene_ptr, object, &frustum, instance_count, &instance_culled);
+		}
 		if (instance_count == 0) {
 			continue;
 		}
-		const b8 object_requires_upload = camera_changed || object_dirty;
-
-		const sz mesh_count = s_array_get_size(&object->mesh_instances);
-		sz mesh_index = 0;
-		for (sz m = 0; m < s_array_get_size(&model->meshes); ++m) {
-			se_mesh *mesh = s_array_get(&model->meshes, s_array_handle(&model->meshes, (u32)m));
-			if (mesh_index >= mesh_count) {
-				break;
-			}
-			se_mesh_instance *mesh_instance = s_array_get(&object->mesh_instances, s_array_handle(&object->mesh_instances, (u32)mesh_index));
-			mesh_index++;
-			if (mesh == NULL || !se_mesh_has_gpu_data(mesh) || mesh->gpu.index_count == 0) {
-				continue;
-			}
-			if (mesh_instance == NULL || mesh_instance->vao == 0) {
-				continue;
+		const f32 depth = se_scene_3d_object_sort_depth(object, &vp);
+		se_instance_ids* slots = instance_culled ? &object->visible_instances : NULL;
+		const b8 object_requires_upload = refresh_instances || object_dirty || instance_culled;
+		if (object->lods && object->lods->level_count > 1u) {
+			se_scene_3d_queue_lod_draws(ctx, scene_ptr, draw_list, object, slots, instance_count, object_requires_upload, views, &vp, &lod_view, depth);
+			continue;
+		}
+		se_scene_3d_queue_model_draws(ctx, scene_ptr, draw_list, object, model, &object->mesh_instances, &object->render_transforms, slots, instance_count, object_requires_upload, views, &vp, depth);
+	}
+
+	const u32 draw_count = draw_list ? draw_list->count : 0u;
+	if (draw_count > 1u) {
+		qsort(draw_list->items, draw_count, sizeof(*draw_list->items), se_scene_3d_draw_item_compare);
+	}
+	const b8 depth_prepass = se_scene_3d_render_depth_passes(ctx, scene_ptr, &vp, draw_list);
+	if (depth_prepass) {
+		// Early-z: only fragments that won the prepass get shaded.
+		glDepthFunc(GL_LEQUAL);
+		glDepthMask(GL_FALSE);
+	}
+	se_shader_handle current_shader = S_HANDLE_NULL;
+	u32 current_vao = 0u;
+	b8 translucent_pass = false;
+	for (u32 d = 0u; d <= draw_count; ++d) {
+		const se_scene_3d_draw_item* item = d < draw_count ? &draw_list->items[d] : NULL;
+		const b8 translucent = item && se_render_sort_key_is_translucent(item->key);
+		if (!translucent_pass && (!item || translucent)) {
+			translucent_pass = true;
+			if (depth_prepass) {
+				glDepthFunc(GL_LESS);
+				glDepthMask(GL_TRUE);
 			}
-			if (object_requires_upload) {
-				sz active_index = 0;
-				for (sz j = 0; j < s_array_get_size(&object->instances.transforms); ++j) {
-					b8* active = s_array_get(&object->instances.actives, s_array_handle(&object->instances.actives, (u32)j));
-					if (!active || !*active) {
-						continue;
-					}
-					s_mat4 *instance_transform = s_array_get(&object->instances.transforms, s_array_handle(&object->instances.transforms, (u32)j));
-					s_mat4 *out_buffer = s_array_get(&object->render_transforms, s_array_handle(&object->render_transforms, (u32)active_index));
-					if (!instance_transform || !out_buffer) {
-						continue;
+			if (has_custom_objects) {
+				for (sz i = 0; i < s_array_get_size(&scene_ptr->objects); ++i) {
+					se_object_3d_handle object_handle = *s_array_get(&scene_ptr->objects, s_array_handle(&scene_ptr->objects, (u32)i));
+					se_object_3d *object = object_handle != S_HANDLE_NULL ? se_object_3d_from_handle(ctx, object_handle) : NULL;
+					if (object && object->is_visible && object->is_custom && object->custom.render) {
+						object->custom.render(object->custom.data);
 					}
-					s_mat4 model_matrix = s_mat4_mul(&object->transform, instance_transform);
-					model_matrix = s_mat4_mul(&model_matrix, &mesh->matrix);
-					*out_buffer = s_mat4_mul(&vp, &model_matrix);
-					active_index++;
 				}
-				mesh_instance->instance_buffers_dirty = true;
-				se_mesh_instance_update(mesh_instance);
+				// Custom renders may change any GL state.
+				current_shader = S_HANDLE_NULL;
+				current_vao = 0u;
 			}
-
-			se_shader_handle shader = mesh->shader;
-			if (shader == S_HANDLE_NULL) {
-				se_log("se_scene_3d_render_to_buffer :: mesh->shader is null");
-				continue;
+			// Not se_render_set_blending: it turns the depth test off, and translucent meshes
+			// still have to be hidden behind opaque ones.
+			if (translucent) {
+				glEnable(GL_BLEND);
+				glBlendEquation(GL_FUNC_ADD);
+				glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+				glDepthMask(GL_FALSE);
 			}
-
-			se_shader_use(shader, true, true);
-			glBindVertexArray(mesh_instance->vao);
-			glDrawElementsInstanced(GL_TRIANGLES, mesh->gpu.index_count, GL_UNSIGNED_INT, 0, (GLsizei)instance_count);
 		}
+		if (!item) {
+			break;
+		}
+		if (!(item->views & SE_SCENE_3D_VIEW_CAMERA)) {
+			continue;
+		}
+		if (item->shader != current_shader) {
+			if (scene_ptr->world_space_instances) {
+				se_shader_set_mat4(item->shader, "u_view_proj", &vp);
+			}
+			se_scene_3d_use_shader(ctx, scene_ptr, item->shader);
+			current_shader = item->shader;
+		}
+		if (item->vao != current_vao) {
+			glBindVertexArray(item->vao);
+			current_vao = item->vao;
+			scene_ptr->draw_stats.vao_binds++;
+		}
+		glDrawElementsInstanced(GL_TRIANGLES, item->index_count, GL_UNSIGNED_INT, 0, (GLsizei)item->instance_count);
+		scene_ptr->draw_stats.draws++;
 	}
+	if (draw_count > 0u && se_render_sort_key_is_translucent(draw_list->items[draw_count - 1u].key)) {
+		glDepthMask(GL_TRUE);
+		glDisable(GL_BLEND);
+	}
+	glBindVertexArray(0);
 
 	se_scene_3d_invoke_custom_renders(scene, scene_ptr);
 	se_framebuffer_unbind(scene_ptr->output);
@@ -3330,6 +5605,76 @@ static b8 se_scene_ray_intersects_sphere(
 	return true;
 }
 
+typedef struct {
+	se_context* ctx;
+	se_scene_spatial* spatial;
+	const s_vec3* origin;
+	const s_vec3* direction;
+	f32 radius_padding;
+	se_scene_pick_filter_3d filter;
+	void* user_data;
+	se_scene_pick_hit_3d* hit;
+} se_scene_3d_pick_query;
+
+typedef struct {
+	se_context* ctx;
+	se_scene_spatial* spatial;
+	const se_box_3d* box;
+	const se_frustum* frustum;
+	// Screen queries: bounds are projected with `view_proj` and tested in NDC against the
+	// rect, or the polygon when `points` is set.
+	const s_mat4* view_proj;
+	const se_box_2d* screen_rect;
+	const s_vec2* points;
+	u32 point_count;
+	se_scene_pick_filter_3d filter;
+	void* user_data;
+	se_scene_instance_3d* out_instances;
+	u32 max_instances;
+	u32 count;
+} se_scene_3d_spatial_query;
+
+// Resolves a tree leaf back to a pickable instance; NULL when the object was filtered out,
+// hidden or the slot went inactive.
+static const se_object_3d* se_scene_3d_spatial_leaf_object(se_context* ctx, const se_scene_spatial* spatial, const u64 user, const u32 slot, se_scene_pick_filter_3d filter, void* user_data, se_instance_id* out_instance_id) {
+	const se_object_3d_handle object_handle = spatial->entries[user].object;
+	if (filter && !filter(object_handle, user_data)) {
+		return NULL;
+	}
+	se_object_3d* object = se_object_3d_from_handle(ctx, object_handle);
+	if (!object || !object->is_visible || slot >= s_array_get_size(&object->instances.ids)) {
+		return NULL;
+	}
+	b8* active = s_array_get(&object->instances.actives, s_array_handle(&object->instances.actives, slot));
+	se_instance_id* instance_id = s_array_get(&object->instances.ids, s_array_handle(&object->instances.ids, slot));
+	if (!active || !*active || !instance_id) {
+		return NULL;
+	}
+	*out_instance_id = *instance_id;
+	return object;
+}
+
+static f32 se_scene_3d_pick_leaf(u64 user, u32 user_index, f32 max_distance, void* user_data) {
+	se_scene_3d_pick_query* query = (se_scene_3d_pick_query*)user_data;
+	se_instance_id instance_id = -1;
+	const se_object_3d* object = se_scene_3d_spatial_leaf_object(query->ctx, query->spatial, user, user_index, query->filter, query->user_data, &instance_id);
+	if (!object) {
+		return max_distance;
+	}
+	s_vec3 world_center = s_vec3(0.0f, 0.0f, 0.0f);
+	f32 world_radius = 0.0f;
+	se_scene_3d_instance_sphere(object, &query->spatial->entries[user], user_index, &world_center, &world_radius);
+	f32 hit_distance = 0.0f;
+	if (!se_scene_ray_intersects_sphere(query->origin, query->direction, &world_center, world_radius + query->radius_padding, &hit_distance) || hit_distance >= query->hit->distance) {
+		return max_distance;
+	}
+	query->hit->object = query->spatial->entries[user].object;
+	query->hit->instance_id = instance_id;
+	query->hit->distance = hit_distance;
+	query->hit->point = s_vec3_add(query->origin, &s_vec3_muls(query->direction, hit_distance));
+	return hit_distance;
+}
+
 b8 se_scene_3d_pick_instance_screen(const se_scene_3d_handle scene, const f32 screen_x, const f32 screen_y, const f32 viewport_width, const f32 viewport_height, const f32 pick_radius, se_scene_pick_filter_3d filter, void* user_data, se_scene_pick_hit_3d* out_hit) {
 	if (!out_hit || viewport_width <= 1.0f || viewport_height <= 1.0f) {
 		se_set_last_error(SE_RESULT_INVALID_ARGUMENT);
@@ -3353,52 +5698,24 @@ b8 se_scene_3d_pick_instance_screen(const se_scene_3d_handle scene, const f32 sc
 		se_set_last_error(SE_RESULT_INVALID_ARGUMENT);
 		return false;
 	}
-
-	const f32 radius_padding = s_max(pick_radius, 0.0001f);
-	for (sz i = 0; i < s_array_get_size(&scene_ptr->objects); ++i) {
-		se_object_3d_handle object_handle = *s_array_get(&scene_ptr->objects, s_array_handle(&scene_ptr->objects, (u32)i));
-		if (object_handle == S_HANDLE_NULL) {
-			continue;
-		}
-		if (filter && !filter(object_handle, user_data)) {
-			continue;
-		}
-		se_object_3d *object = se_object_3d_from_handle(ctx, object_handle);
-		if (!object || !object->is_visible || object->is_custom || object->model == S_HANDLE_NULL) {
-			continue;
-		}
-		se_model *model = se_model_from_handle(ctx, object->model);
-		if (!model) {
-			continue;
-		}
-		s_vec3 local_center = s_vec3(0.0f, 0.0f, 0.0f);
-		f32 local_radius = 0.8660254f;
-		(void)se_model_estimate_pick_sphere(model, &local_center, &local_radius);
-		for (sz j = 0; j < s_array_get_size(&object->instances.transforms); ++j) {
-			b8* active = s_array_get(&object->instances.actives, s_array_handle(&object->instances.actives, (u32)j));
-			se_instance_id* instance_id = s_array_get(&object->instances.ids, s_array_handle(&object->instances.ids, (u32)j));
-			s_mat4 *instance_transform = s_array_get(&object->instances.transforms, s_array_handle(&object->instances.transforms, (u32)j));
-			if (!active || !*active || !instance_id || !instance_transform) {
-				continue;
-			}
-			s_mat4 world_transform = s_mat4_mul(&object->transform, instance_transform);
-			const s_vec3 world_center = se_mat4_mul_point(&world_transform, &local_center);
-			const s_vec3 scale = se_mat4_extract_basis_scale(&world_transform);
-			const f32 world_radius = (local_radius * se_max3(scale.x, scale.y, scale.z)) + radius_padding;
-			f32 hit_distance = 0.0f;
-			if (!se_scene_ray_intersects_sphere(&ray_origin, &ray_direction, &world_center, world_radius, &hit_distance)) {
-				continue;
-			}
-			if (hit_distance >= out_hit->distance) {
-				continue;
-			}
-			out_hit->object = object_handle;
-			out_hit->instance_id = *instance_id;
-			out_hit->distance = hit_distance;
-			out_hit->point = s_vec3_add(&ray_origin, &s_vec3_muls(&ray_direction, hit_distance));
-		}
+	se_scene_spatial* spatial = se_scene_3d_spatial_sync(ctx, scene_ptr);
+	if (!spatial) {
+		se_set_last_error(SE_RESULT_OUT_OF_MEMORY);
+		return false;
 	}
 
+	se_scene_3d_pick_query query = {
+		.ctx = ctx,
+		.spatial = spatial,
+		.origin = &ray_origin,
+		.direction = &ray_direction,
+		.radius_padding = s_max(pick_radius, 0.0001f),
+		.filter = filter,
+		.user_data = user_data,
+		.hit = out_hit
+	};
+	se_bvh_query_ray(spatial->bvh, &ray_origin, &ray_direction, FLT_MAX, query.radius_padding, se_scene_3d_pick_leaf, &query);
+
 	if (out_hit->object == S_HANDLE_NULL) {
 		se_set_last_error(SE_RESULT_NOT_FOUND);
 		return false;
@@ -3428,7 +5745,195 @@ b8 se_scene_3d_pick_object_screen(const se_scene_3d_handle scene, const f32 scre
 	if (out_distance) {
 		*out_distance = ok ? hit.distance : FLT_MAX;
 	}
-	return ok;
+	return ok;
+}
+
+// NDC bounds of the projected box corners; false when a corner is behind the eye, in which
+// case the caller keeps the frustum result.
+static b8 se_scene_project_box(const s_mat4* view_proj, const se_box_3d* box, se_box_2d* out_ndc) {
+	out_ndc->min = s_vec2(FLT_MAX, FLT_MAX);
+	out_ndc->max = s_vec2(-FLT_MAX, -FLT_MAX);
+	for (u32 corner = 0u; corner < 8u; ++corner) {
+		const f32 x = (corner & 1u) ? box->max.x : box->min.x;
+		const f32 y = (corner & 2u) ? box->max.y : box->min.y;
+		const f32 z = (corner & 4u) ? box->max.z : box->min.z;
+		const f32 w = (view_proj->m[0][3] * x) + (view_proj->m[1][3] * y) + (view_proj->m[2][3] * z) + view_proj->m[3][3];
+		if (w <= 0.000001f) {
+			return false;
+		}
+		const f32 inv_w = 1.0f / w;
+		const f32 ndc_x = ((view_proj->m[0][0] * x) + (view_proj->m[1][0] * y) + (view_proj->m[2][0] * z) + view_proj->m[3][0]) * inv_w;
+		const f32 ndc_y = ((view_proj->m[0][1] * x) + (view_proj->m[1][1] * y) + (view_proj->m[2][1] * z) + view_proj->m[3][1]) * inv_w;
+		out_ndc->min = s_vec2(s_min(out_ndc->min.x, ndc_x), s_min(out_ndc->min.y, ndc_y));
+		out_ndc->max = s_vec2(s_max(out_ndc->max.x, ndc_x), s_max(out_ndc->max.y, ndc_y));
+	}
+	return true;
+}
+
+static b8 se_scene_3d_query_leaf(u64 user, u32 user_index, void* user_data) {
+	se_scene_3d_spatial_query* query = (se_scene_3d_spatial_query*)user_data;
+	se_instance_id instance_id = -1;
+	const se_object_3d* object = se_scene_3d_spatial_leaf_object(query->ctx, query->spatial, user, user_index, query->filter, query->user_data, &instance_id);
+	if (!object) {
+		return true;
+	}
+	s_vec3 center = s_vec3(0.0f, 0.0f, 0.0f);
+	f32 radius = 0.0f;
+	se_scene_3d_instance_sphere(object, &query->spatial->entries[user], user_index, &center, &radius);
+	const se_box_3d bounds = se_scene_sphere_box(&center, radius);
+	if (query->box && !se_box_3d_intersects(&bounds, query->box)) {
+		return true;
+	}
+	if (query->frustum && !se_frustum_intersects_box_3d(query->frustum, &bounds)) {
+		return true;
+	}
+	se_box_2d projected = {0};
+	if (query->view_proj && se_scene_project_box(query->view_proj, &bounds, &projected)) {
+		if (query->points ? !se_box_2d_intersects_polygon(&projected, query->points, query->point_count) : !se_box_2d_intersects(&projected, query->screen_rect)) {
+			return true;
+		}
+	}
+	if (query->count < query->max_instances) {
+		query->out_instances[query->count] = (se_scene_instance_3d){ query->spatial->entries[user].object, instance_id };
+	}
+	query->count++;
+	return true;
+}
+
+static u32 se_scene_3d_query(const se_scene_3d_handle scene, se_scene_3d_spatial_query* query) {
+	se_context* ctx = se_current_context();
+	se_scene_3d* scene_ptr = se_scene_3d_from_handle(ctx, scene);
+	if (!scene_ptr || (!query->out_instances && query->max_instances > 0u)) {
+		se_set_last_error(SE_RESULT_INVALID_ARGUMENT);
+		return 0u;
+	}
+	se_scene_spatial* spatial = se_scene_3d_spatial_sync(ctx, scene_ptr);
+	if (!spatial) {
+		se_set_last_error(SE_RESULT_OUT_OF_MEMORY);
+		return 0u;
+	}
+	query->ctx = ctx;
+	query->spatial = spatial;
+	if (query->frustum) {
+		se_bvh_query_frustum(spatial->bvh, query->frustum, se_scene_3d_query_leaf, query);
+	} else {
+		se_bvh_query_box(spatial->bvh, query->box, se_scene_3d_query_leaf, query);
+	}
+	se_set_last_error(SE_RESULT_OK);
+	return query->count;
+}
+
+u32 se_scene_3d_query_box(const se_scene_3d_handle scene, const se_box_3d* box, se_scene_pick_filter_3d filter, void* user_data, se_scene_instance_3d* out_instances, const u32 max_instances) {
+	if (!box) {
+		se_set_last_error(SE_RESULT_INVALID_ARGUMENT);
+		return 0u;
+	}
+	se_scene_3d_spatial_query query = {
+		.box = box,
+		.filter = filter,
+		.user_data = user_data,
+		.out_instances = out_instances,
+		.max_instances = max_instances
+	};
+	return se_scene_3d_query(scene, &query);
+}
+
+u32 se_scene_3d_query_frustum(const se_scene_3d_handle scene, const se_frustum* frustum, se_scene_pick_filter_3d filter, void* user_data, se_scene_instance_3d* out_instances, const u32 max_instances) {
+	if (!frustum) {
+		se_set_last_error(SE_RESULT_INVALID_ARGUMENT);
+		return 0u;
+	}
+	se_scene_3d_spatial_query query = {
+		.frustum = frustum,
+		.filter = filter,
+		.user_data = user_data,
+		.out_instances = out_instances,
+		.max_instances = max_instances
+	};
+	return se_scene_3d_query(scene, &query);
+}
+
+// Narrows the camera frustum to an NDC rect by remapping that rect to the full clip range, so
+// the tree is walked only for what the rect can see.
+static u32 se_scene_3d_query_screen(const se_scene_3d_handle scene, const se_box_2d* ndc_bounds, se_scene_3d_spatial_query* query) {
+	se_context* ctx = se_current_context();
+	se_scene_3d* scene_ptr = se_scene_3d_from_handle(ctx, scene);
+	if (!scene_ptr) {
+		se_set_last_error(SE_RESULT_INVALID_ARGUMENT);
+		return 0u;
+	}
+	if (scene_ptr->camera == S_HANDLE_NULL) {
+		se_set_last_error(SE_RESULT_NOT_FOUND);
+		return 0u;
+	}
+	const s_mat4 view = se_camera_get_view_matrix(scene_ptr->camera);
+	const s_mat4 proj = se_camera_get_projection_matrix(scene_ptr->camera);
+	const s_mat4 vp = s_mat4_mul(&proj, &view);
+	const f32 width = s_max(ndc_bounds->max.x - ndc_bounds->min.x, 0.00001f);
+	const f32 height = s_max(ndc_bounds->max.y - ndc_bounds->min.y, 0.00001f);
+	s_mat4 remap = s_mat4_identity;
+	remap.m[0][0] = 2.0f / width;
+	remap.m[3][0] = -(ndc_bounds->min.x + ndc_bounds->max.x) / width;
+	remap.m[1][1] = 2.0f / height;
+	remap.m[3][1] = -(ndc_bounds->min.y + ndc_bounds->max.y) / height;
+	const s_mat4 rect_vp = s_mat4_mul(&remap, &vp);
+	se_frustum frustum = {0};
+	se_frustum_from_matrix(&frustum, &rect_vp);
+	query->frustum = &frustum;
+	query->view_proj = &vp;
+	return se_scene_3d_query(scene, query);
+}
+
+u32 se_scene_3d_query_screen_rect(const se_scene_3d_handle scene, const f32 x0, const f32 y0, const f32 x1, const f32 y1, const f32 viewport_width, const f32 viewport_height, se_scene_pick_filter_3d filter, void* user_data, se_scene_instance_3d* out_instances, const u32 max_instances) {
+	if (viewport_width <= 1.0f || viewport_height <= 1.0f) {
+		se_set_last_error(SE_RESULT_INVALID_ARGUMENT);
+		return 0u;
+	}
+	const f32 ndc_x0 = (x0 / viewport_width) * 2.0f - 1.0f;
+	const f32 ndc_x1 = (x1 / viewport_width) * 2.0f - 1.0f;
+	const f32 ndc_y0 = 1.0f - (y0 / viewport_height) * 2.0f;
+	const f32 ndc_y1 = 1.0f - (y1 / viewport_height) * 2.0f;
+	const se_box_2d rect = {
+		s_vec2(s_min(ndc_x0, ndc_x1), s_min(ndc_y0, ndc_y1)),
+		s_vec2(s_max(ndc_x0, ndc_x1), s_max(ndc_y0, ndc_y1))
+	};
+	se_scene_3d_spatial_query query = {
+		.screen_rect = &rect,
+		.filter = filter,
+		.user_data = user_data,
+		.out_instances = out_instances,
+		.max_instances = max_instances
+	};
+	return se_scene_3d_query_screen(scene, &rect, &query);
+}
+
+u32 se_scene_3d_query_screen_polygon(const se_scene_3d_handle scene, const s_vec2* points, const u32 point_count, const f32 viewport_width, const f32 viewport_height, se_scene_pick_filter_3d filter, void* user_data, se_scene_instance_3d* out_instances, const u32 max_instances) {
+	if (!points || point_count < 3u || viewport_width <= 1.0f || viewport_height <= 1.0f) {
+		se_set_last_error(SE_RESULT_INVALID_ARGUMENT);
+		return 0u;
+	}
+	s_vec2* ndc_points = (s_vec2*)malloc(sizeof(*ndc_points) * (sz)point_count);
+	if (!ndc_points) {
+		se_set_last_error(SE_RESULT_OUT_OF_MEMORY);
+		return 0u;
+	}
+	se_box_2d bounds = { s_vec2(FLT_MAX, FLT_MAX), s_vec2(-FLT_MAX, -FLT_MAX) };
+	for (u32 i = 0u; i < point_count; ++i) {
+		ndc_points[i] = s_vec2((points[i].x / viewport_width) * 2.0f - 1.0f, 1.0f - (points[i].y / viewport_height) * 2.0f);
+		bounds.min = s_vec2(s_min(bounds.min.x, ndc_points[i].x), s_min(bounds.min.y, ndc_points[i].y));
+		bounds.max = s_vec2(s_max(bounds.max.x, ndc_points[i].x), s_max(bounds.max.y, ndc_points[i].y));
+	}
+	se_scene_3d_spatial_query query = {
+		.points = ndc_points,
+		.point_count = point_count,
+		.filter = filter,
+		.user_data = user_data,
+		.out_instances = out_instances,
+		.max_instances = max_instances
+	};
+	const u32 count = se_scene_3d_query_screen(scene, &bounds, &query);
+	free(ndc_points);
+	return count;
 }
 
 void se_scene_3d_set_camera(const se_scene_3d_handle scene, const se_camera_handle camera) {
@@ -3470,6 +5975,217 @@ void se_scene_3d_set_culling(const se_scene_3d_handle scene, const b8 enabled) {
 	scene_ptr->enable_culling = enabled;
 }
 
+void se_scene_3d_set_batching(const se_scene_3d_handle scene, const b8 enabled) {
+	se_context *ctx = se_current_context();
+	se_scene_3d *scene_ptr = se_scene_3d_from_handle(ctx, scene);
+	s_assertf(scene_ptr, "se_scene_3d_set_batching :: scene is null");
+	if (scene_ptr->enable_batching && !enabled) {
+		scene_ptr->has_last_vp = false;
+	}
+	scene_ptr->enable_batching = enabled;
+}
+
+// Compacted instance buffers have to be rebuilt from the full instance set.
+static void se_scene_3d_mark_instances_dirty(se_context* ctx, se_scene_3d* scene_ptr) {
+	for (sz i = 0; i < s_array_get_size(&scene_ptr->objects); ++i) {
+		se_object_3d_handle object_handle = *s_array_get(&scene_ptr->objects, s_array_handle(&scene_ptr->objects, (u32)i));
+		if (object_handle != S_HANDLE_NULL && se_object_3d_from_handle(ctx, object_handle)) {
+			se_object_3d_set_instances_dirty(object_handle, true);
+		}
+	}
+}
+
+void se_scene_3d_set_frustum_culling(const se_scene_3d_handle scene, const b8 enabled, const b8 per_instance) {
+	se_context *ctx = se_current_context();
+	se_scene_3d *scene_ptr = se_scene_3d_from_handle(ctx, scene);
+	s_assertf(scene_ptr, "se_scene_3d_set_frustum_culling :: scene is null");
+	const b8 instance_culling = enabled && per_instance;
+	if (scene_ptr->enable_instance_culling && !instance_culling) {
+		se_scene_3d_mark_instances_dirty(ctx, scene_ptr);
+	}
+	scene_ptr->enable_frustum_culling = enabled;
+	scene_ptr->enable_instance_culling = instance_culling;
+}
+
+b8 se_scene_3d_get_cull_stats(const se_scene_3d_handle scene, se_scene_3d_cull_stats* out_stats) {
+	se_context *ctx = se_current_context();
+	se_scene_3d *scene_ptr = se_scene_3d_from_handle(ctx, scene);
+	if (!scene_ptr || !out_stats) {
+		se_set_last_error(SE_RESULT_INVALID_ARGUMENT);
+		return false;
+	}
+	*out_stats = scene_ptr->cull_stats;
+	se_set_last_error(SE_RESULT_OK);
+	return true;
+}
+
+b8 se_scene_3d_get_draw_stats(const se_scene_3d_handle scene, se_scene_3d_draw_stats* out_stats) {
+	se_context *ctx = se_current_context();
+	se_scene_3d *scene_ptr = se_scene_3d_from_handle(ctx, scene);
+	if (!scene_ptr || !out_stats) {
+		se_set_last_error(SE_RESULT_INVALID_ARGUMENT);
+		return false;
+	}
+	*out_stats = scene_ptr->draw_stats;
+	se_set_last_error(SE_RESULT_OK);
+	return true;
+}
+
+b8 se_scene_3d_get_lod_stats(const se_scene_3d_handle scene, se_scene_3d_lod_stats* out_stats) {
+	se_context *ctx = se_current_context();
+	se_scene_3d *scene_ptr = se_scene_3d_from_handle(ctx, scene);
+	if (!scene_ptr || !out_stats) {
+		se_set_last_error(SE_RESULT_INVALID_ARGUMENT);
+		return false;
+	}
+	*out_stats = scene_ptr->lod_stats;
+	se_set_last_error(SE_RESULT_OK);
+	return true;
+}
+
+static b8 se_scene_3d_has_shadow_passes(const se_scene_3d* scene_ptr) {
+	const se_scene_3d_render_passes* passes = scene_ptr->render_passes;
+	for (u32 i = 0u; passes && i < passes->count; ++i) {
+		if (se_render_pass_is_shadow(&passes->passes[i])) {
+			return true;
+		}
+	}
+	return false;
+}
+
+// Shadow passes draw from a light and the depth prepass must match the main pass bit for bit,
+// so both need the instance world matrices and u_view_proj rather than baked camera matrices.
+static b8 se_scene_3d_has_world_space_passes(const se_scene_3d* scene_ptr) {
+	const se_scene_3d_render_passes* passes = scene_ptr->render_passes;
+	for (u32 i = 0u; passes && i < passes->count; ++i) {
+		if (se_render_pass_is_shadow(&passes->passes[i]) || passes->passes[i].kind == SE_RENDER_PASS_DEPTH_PREPASS) {
+			return true;
+		}
+	}
+	return false;
+}
+
+b8 se_scene_3d_set_render_passes(const se_scene_3d_handle scene, const se_render_pass* passes, const u32 pass_count) {
+	se_context *ctx = se_current_context();
+	se_scene_3d *scene_ptr = ctx ? se_scene_3d_from_handle(ctx, scene) : NULL;
+	if (!scene_ptr || !se_render_passes_validate(passes, pass_count)) {
+		se_set_last_error(SE_RESULT_INVALID_ARGUMENT);
+		return false;
+	}
+	b8 has_shadow_passes = false;
+	b8 has_depth_prepass = false;
+	for (u32 i = 0u; i < pass_count; ++i) {
+		has_shadow_passes = has_shadow_passes || se_render_pass_is_shadow(&passes[i]);
+		has_depth_prepass = has_depth_prepass || passes[i].kind == SE_RENDER_PASS_DEPTH_PREPASS;
+	}
+	// Legacy instance buffers hold camera matrices, which a light cannot reuse, and the legacy
+	// mesh shader's gl_Position is not guaranteed to match the prepass depth shader's.
+	if ((has_shadow_passes || has_depth_prepass) && !scene_ptr->world_space_instances) {
+		se_set_last_error(SE_RESULT_INVALID_ARGUMENT);
+		return false;
+	}
+	// Shadow casters draw every instance, so buffers compacted by instance culling are refilled.
+	if (has_shadow_passes && !se_scene_3d_has_shadow_passes(scene_ptr)) {
+		se_scene_3d_mark_instances_dirty(ctx, scene_ptr);
+	}
+	// Only the main pass: nothing to keep around.
+	if (pass_count == 1u) {
+		se_scene_3d_render_passes_destroy(scene_ptr->render_passes);
+		scene_ptr->render_passes = NULL;
+		se_set_last_error(SE_RESULT_OK);
+		return true;
+	}
+	se_scene_3d_render_passes* render_passes = scene_ptr->render_passes;
+	if (!render_passes) {
+		render_passes = (se_scene_3d_render_passes*)calloc(1u, sizeof(*render_passes));
+		if (!render_passes) {
+			se_set_last_error(SE_RESULT_OUT_OF_MEMORY);
+			return false;
+		}
+		scene_ptr->render_passes = render_passes;
+	}
+	for (u32 i = 0u; i < SE_SCENE_3D_MAX_RENDER_PASSES; ++i) {
+		// Targets stay with their index while it still holds a shadow pass.
+		const b8 keep_target = i < pass_count && se_render_pass_is_shadow(&passes[i]);
+		if (!keep_target && render_passes->shadow_targets[i] != S_HANDLE_NULL) {
+			se_framebuffer_destroy(render_passes->shadow_targets[i]);
+			render_passes->shadow_targets[i] = S_HANDLE_NULL;
+		}
+		memset(&render_passes->shadow_maps[i], 0, sizeof(render_passes->shadow_maps[i]));
+		if (i < pass_count) {
+			render_passes->passes[i] = passes[i];
+		}
+	}
+	render_passes->count = pass_count;
+	render_passes->shadow_views = 0u;
+	se_set_last_error(SE_RESULT_OK);
+	return true;
+}
+
+u32 se_scene_3d_get_render_passes(const se_scene_3d_handle scene, se_render_pass* out_passes, const u32 max_passes) {
+	se_context *ctx = se_current_context();
+	se_scene_3d *scene_ptr = ctx ? se_scene_3d_from_handle(ctx, scene) : NULL;
+	if (!scene_ptr) {
+		se_set_last_error(SE_RESULT_INVALID_ARGUMENT);
+		return 0u;
+	}
+	const se_scene_3d_render_passes* render_passes = scene_ptr->render_passes;
+	const u32 pass_count = render_passes ? render_passes->count : 1u;
+	for (u32 i = 0u; out_passes && i < pass_count && i < max_passes; ++i) {
+		out_passes[i] = render_passes ? render_passes->passes[i] : SE_RENDER_PASS_MAIN_DEFAULTS;
+	}
+	se_set_last_error(SE_RESULT_OK);
+	return pass_count;
+}
+
+b8 se_scene_3d_get_shadow_map(const se_scene_3d_handle scene, const u32 pass_index, se_shadow_map* out_shadow_map) {
+	se_context *ctx = se_current_context();
+	se_scene_3d *scene_ptr = ctx ? se_scene_3d_from_handle(ctx, scene) : NULL;
+	const se_scene_3d_render_passes* render_passes = scene_ptr ? scene_ptr->render_passes : NULL;
+	if (!render_passes || !out_shadow_map || pass_index >= render_passes->count || !se_render_pass_is_shadow(&render_passes->passes[pass_index])) {
+		se_set_last_error(SE_RESULT_INVALID_ARGUMENT);
+		return false;
+	}
+	if (render_passes->shadow_targets[pass_index] == S_HANDLE_NULL) {
+		se_set_last_error(SE_RESULT_NOT_FOUND);
+		return false;
+	}
+	*out_shadow_map = render_passes->shadow_maps[pass_index];
+	se_set_last_error(SE_RESULT_OK);
+	return true;
+}
+
+void se_scene_3d_set_world_space_instances(const se_scene_3d_handle scene, const b8 enabled) {
+	se_context *ctx = se_current_context();
+	se_scene_3d *scene_ptr = se_scene_3d_from_handle(ctx, scene);
+	s_assertf(scene_ptr, "se_scene_3d_set_world_space_instances :: scene is null");
+	if (!enabled && se_scene_3d_has_world_space_passes(scene_ptr)) {
+		se_set_last_error(SE_RESULT_INVALID_ARGUMENT);
+		return;
+	}
+	if (scene_ptr->world_space_instances != enabled) {
+		scene_ptr->has_last_vp = false;
+	}
+	scene_ptr->world_space_instances = enabled;
+	se_set_last_error(SE_RESULT_OK);
+}
+
+b8 se_scene_3d_get_batch_stats(const se_scene_3d_handle scene, se_scene_3d_batch_stats* out_stats) {
+	se_context *ctx = se_current_context();
+	se_scene_3d *scene_ptr = se_scene_3d_from_handle(ctx, scene);
+	if (!scene_ptr || !out_stats) {
+		se_set_last_error(SE_RESULT_INVALID_ARGUMENT);
+		return false;
+	}
+	if (scene_ptr->batch) {
+		*out_stats = scene_ptr->batch->stats;
+	} else {
+		memset(out_stats, 0, sizeof(*out_stats));
+	}
+	se_set_last_error(SE_RESULT_OK);
+	return true;
+}
+
 void se_scene_3d_add_post_process_buffer(const se_scene_3d_handle scene, const se_render_buffer_handle buffer) {
 	se_context *ctx = se_current_context();
 	se_scene_3d *scene_ptr = se_scene_3d_from_handle(ctx, scene);
@@ -3551,7 +6267,7 @@ se_object_3d_handle se_object_3d_create(const se_model_handle model, const s_mat
 		s_array_init(&ctx->objects_3d);
 	}
 	if (s_array_get_size(&ctx->objects_3d) >= SE_MAX_3D_OBJECTS) {
-		se_set_last_error(SE_RESULT_OUT_OF_MEMORY);
+		se_set_last_error(SE_RESULT_CAPACITY_EXCEEDED);
 		return S_HANDLE_NULL;
 	}
 	se_object_3d_handle object_handle = s_array_increment(&ctx->objects_3d);
@@ -3559,6 +6275,10 @@ se_object_3d_handle se_object_3d_create(const se_model_handle model, const s_mat
 	memset(new_object, 0, sizeof(*new_object));
 	new_object->model = model;
 	new_object->transform = *transform;
+	new_object->local_transform = *transform;
+	new_object->parent = S_HANDLE_NULL;
+	new_object->parent_instance = -1;
+	s_array_init(&new_object->children);
 	new_object->is_custom = false;
 	new_object->is_visible = true;
 	const sz instance_capacity = (max_instances_count > 0) ? max_instances_count : 1;
@@ -3567,10 +6287,14 @@ se_object_3d_handle se_object_3d_create(const se_model_handle model, const s_mat
 	s_array_init(&new_object->instances.buffers);
 	s_array_init(&new_object->instances.actives);
 	s_array_init(&new_object->instances.free_indices);
+	s_array_init(&new_object->instances.free_positions);
 	s_array_init(&new_object->instances.metadata);
+	se_instances_id_map_init(&new_object->instances.id_map);
 	s_array_init(&new_object->render_transforms);
 	s_array_init(&new_object->render_buffers);
 	s_array_init(&new_object->render_metadata);
+	s_array_init(&new_object->visible_instances);
+	s_array_init(&new_object->spatial_moved);
 	se_object_3d_reserve_storage(new_object, instance_capacity);
 	new_object->instances.next_id = 0;
 
@@ -3595,6 +6319,12 @@ se_object_3d_handle se_object_3d_create(const se_model_handle model, const s_mat
 	}
 
 	if (max_instances_count == 0) {
+		const se_instance_id first_id = se_instances_id_alloc(&new_object->instances.id_map, &new_object->instances.next_id, 0);
+		if (first_id < 0) {
+			se_object_3d_destroy(object_handle);
+			se_set_last_error(SE_RESULT_CAPACITY_EXCEEDED);
+			return S_HANDLE_NULL;
+		}
 		s_handle id_handle = s_array_increment(&new_object->instances.ids);
 		s_handle transform_handle = s_array_increment(&new_object->instances.transforms);
 		s_handle buffer_handle = s_array_increment(&new_object->instances.buffers);
@@ -3611,7 +6341,7 @@ se_object_3d_handle se_object_3d_create(const se_model_handle model, const s_mat
 		s_mat4 *new_render_transform = s_array_get(&new_object->render_transforms, render_handle);
 		s_mat4 *new_render_buffer = s_array_get(&new_object->render_buffers, render_buffer_handle);
 		s_mat4 *new_render_metadata = s_array_get(&new_object->render_metadata, render_metadata_handle);
-		*new_instance_id = 0;
+		*new_instance_id = first_id;
 		*new_transform = s_mat4_identity;
 		*new_buffer = s_mat4_identity;
 		*new_active = true;
@@ -3619,7 +6349,6 @@ se_object_3d_handle se_object_3d_create(const se_model_handle model, const s_mat
 		*new_render_transform = s_mat4_identity;
 		*new_render_buffer = s_mat4_identity;
 		*new_render_metadata = s_mat4_identity;
-		new_object->instances.next_id = 1;
 		se_object_3d_refresh_mesh_instance_sources(new_object);
 		se_object_3d_set_instances_dirty(object_handle, true);
 	}
@@ -3635,20 +6364,30 @@ se_object_3d_handle se_object_3d_create_custom(se_object_custom *custom, const s
 		return S_HANDLE_NULL;
 	}
 	s_assertf(custom->data_size <= SE_OBJECT_CUSTOM_DATA_SIZE, "se_object_3d_create_custom :: data_size exceeds SE_OBJECT_CUSTOM_DATA_SIZE");
+	se_object_custom_data custom_data = {0};
+	if (!se_object_custom_data_copy(&custom_data, custom)) {
+		se_set_last_error(SE_RESULT_OUT_OF_MEMORY);
+		return S_HANDLE_NULL;
+	}
 	if (s_array_get_capacity(&ctx->objects_3d) == 0) {
 		s_array_init(&ctx->objects_3d);
 	}
 	if (s_array_get_size(&ctx->objects_3d) >= SE_MAX_3D_OBJECTS) {
-		se_set_last_error(SE_RESULT_OUT_OF_MEMORY);
+		free(custom_data.data);
+		se_set_last_error(SE_RESULT_CAPACITY_EXCEEDED);
 		return S_HANDLE_NULL;
 	}
 	se_object_3d_handle object_handle = s_array_increment(&ctx->objects_3d);
 	se_object_3d *new_object = s_array_get(&ctx->objects_3d, object_handle);
 	memset(new_object, 0, sizeof(*new_object));
 	new_object->transform = *transform;
+	new_object->local_transform = *transform;
+	new_object->parent = S_HANDLE_NULL;
+	new_object->parent_instance = -1;
+	s_array_init(&new_object->children);
 	new_object->is_custom = true;
 	new_object->is_visible = true;
-	memcpy(&new_object->custom, custom, sizeof(se_object_custom));
+	new_object->custom = custom_data;
 	se_set_last_error(SE_RESULT_OK);
 	return object_handle;
 }
@@ -3658,13 +6397,17 @@ void se_object_3d_destroy(const se_object_3d_handle object) {
 	s_assertf(ctx, "se_object_3d_destroy :: ctx is null");
 	se_object_3d *object_ptr = se_object_3d_from_handle(ctx, object);
 	s_assertf(object_ptr, "se_object_3d_destroy :: object is null");
+	se_object_3d_detach_hierarchy(ctx, object_ptr, object);
 	if (object_ptr->is_custom) {
+		free(object_ptr->custom.data);
+		object_ptr->custom.data = NULL;
 		object_ptr->custom.render = NULL;
 		object_ptr->custom.data_size = 0;
 		object_ptr->is_visible = false;
 		s_array_remove(&ctx->objects_3d, object);
 		return;
 	}
+	se_object_3d_lods_destroy(object_ptr);
 	for (sz i = 0; i < s_array_get_size(&object_ptr->mesh_instances); ++i) {
 		se_mesh_instance *mesh_instance = s_array_get(&object_ptr->mesh_instances, s_array_handle(&object_ptr->mesh_instances, (u32)i));
 		se_mesh_instance_destroy(mesh_instance);
@@ -3673,24 +6416,60 @@ void se_object_3d_destroy(const se_object_3d_handle object) {
 	s_array_clear(&object_ptr->render_transforms);
 	s_array_clear(&object_ptr->render_buffers);
 	s_array_clear(&object_ptr->render_metadata);
+	s_array_clear(&object_ptr->visible_instances);
+	s_array_clear(&object_ptr->spatial_moved);
 	s_array_clear(&object_ptr->instances.ids);
 	s_array_clear(&object_ptr->instances.transforms);
 	s_array_clear(&object_ptr->instances.buffers);
 	s_array_clear(&object_ptr->instances.actives);
 	s_array_clear(&object_ptr->instances.free_indices);
+	s_array_clear(&object_ptr->instances.free_positions);
 	s_array_clear(&object_ptr->instances.metadata);
+	se_instances_id_map_clear(&object_ptr->instances.id_map);
 	object_ptr->model = S_HANDLE_NULL;
 	object_ptr->is_visible = false;
 	s_array_remove(&ctx->objects_3d, object);
 }
 
+b8 se_object_3d_get_pool_stats(se_object_pool_stats* out_stats) {
+	se_context* ctx = se_current_context();
+	if (!ctx || !out_stats) {
+		se_set_last_error(SE_RESULT_INVALID_ARGUMENT);
+		return false;
+	}
+	memset(out_stats, 0, sizeof(*out_stats));
+	out_stats->count = (u32)s_array_get_size(&ctx->objects_3d);
+	out_stats->capacity = (u32)s_array_get_capacity(&ctx->objects_3d);
+	out_stats->object_bytes = s_array_get_capacity(&ctx->objects_3d) * sizeof(se_object_3d);
+	for (sz i = 0; i < s_array_get_size(&ctx->objects_3d); ++i) {
+		const se_object_3d* object = s_array_get(&ctx->objects_3d, s_array_handle(&ctx->objects_3d, (u32)i));
+		if (!object) {
+			continue;
+		}
+		out_stats->instance_bytes += s_array_get_capacity(&object->children) * sizeof(se_object_3d_handle);
+		if (object->is_custom) {
+			out_stats->custom_data_bytes += object->custom.data_size;
+			continue;
+		}
+		out_stats->instance_bytes +=
+			(s_array_get_capacity(&object->instances.ids) + s_array_get_capacity(&object->instances.free_indices) +
+				s_array_get_capacity(&object->instances.free_positions) + se_instances_id_map_capacity(&object->instances.id_map) + s_array_get_capacity(&object->visible_instances) +
+				s_array_get_capacity(&object->spatial_moved)) * sizeof(se_instance_id) +
+			(s_array_get_capacity(&object->instances.transforms) + s_array_get_capacity(&object->instances.buffers) + s_array_get_capacity(&object->instances.metadata) +
+				s_array_get_capacity(&object->render_transforms) + s_array_get_capacity(&object->render_buffers) + s_array_get_capacity(&object->render_metadata)) * sizeof(s_mat4) +
+			s_array_get_capacity(&object->instances.actives) * sizeof(b8);
+	}
+	se_set_last_error(SE_RESULT_OK);
+	return true;
+}
+
 void se_object_3d_set_transform(const se_object_3d_handle object, const s_mat4 *transform) {
 	se_context *ctx = se_current_context();
 	se_object_3d *object_ptr = se_object_3d_from_handle(ctx, object);
 	s_assertf(object_ptr, "se_object_3d_set_transform :: object is null");
 	s_assertf(transform, "se_object_3d_set_transform :: transform is null");
-	object_ptr->transform = *transform;
-	se_object_3d_set_instances_dirty(object, true);
+	object_ptr->local_transform = *transform;
+	se_object_3d_mark_world_dirty(ctx, object_ptr, object);
 }
 
 void se_object_3d_set_location(const se_object_3d_handle object, const s_vec3 *location) {
@@ -3698,8 +6477,8 @@ void se_object_3d_set_location(const se_object_3d_handle object, const s_vec3 *l
 	se_object_3d *object_ptr = se_object_3d_from_handle(ctx, object);
 	s_assertf(object_ptr, "se_object_3d_set_location :: object is null");
 	s_assertf(location, "se_object_3d_set_location :: location is null");
-	s_mat4_set_translation(&object_ptr->transform, location);
-	se_object_3d_set_instances_dirty(object, true);
+	s_mat4_set_translation(&object_ptr->local_transform, location);
+	se_object_3d_mark_world_dirty(ctx, object_ptr, object);
 }
 
 void se_object_3d_set_rotation(const se_object_3d_handle object, const s_vec3 *rotation) {
@@ -3708,14 +6487,14 @@ void se_object_3d_set_rotation(const se_object_3d_handle object, const s_vec3 *r
 	s_assertf(object_ptr, "se_object_3d_set_rotation :: object is null");
 	s_assertf(rotation, "se_object_3d_set_rotation :: rotation is null");
 
-	const s_vec3 location = s_mat4_get_translation(&object_ptr->transform);
-	const s_vec3 current_scale = se_mat4_extract_basis_scale(&object_ptr->transform);
+	const s_vec3 location = s_mat4_get_translation(&object_ptr->local_transform);
+	const s_vec3 current_scale = se_mat4_extract_basis_scale(&object_ptr->local_transform);
 	s_mat4 transform = se_mat4_rotation_xyz(rotation);
 	se_mat4_apply_basis_scale(&transform, &current_scale);
 	s_mat4_set_translation(&transform, &location);
 
-	object_ptr->transform = transform;
-	se_object_3d_set_instances_dirty(object, true);
+	object_ptr->local_transform = transform;
+	se_object_3d_mark_world_dirty(ctx, object_ptr, object);
 }
 
 void se_object_3d_set_scale(const se_object_3d_handle object, const s_vec3 *scale) {
@@ -3724,23 +6503,81 @@ void se_object_3d_set_scale(const se_object_3d_handle object, const s_vec3 *scal
 	s_assertf(object_ptr, "se_object_3d_set_scale :: object is null");
 	s_assertf(scale, "se_object_3d_set_scale :: scale is null");
 
-	const s_vec3 location = s_mat4_get_translation(&object_ptr->transform);
-	const s_vec3 current_scale = se_mat4_extract_basis_scale(&object_ptr->transform);
-	s_mat4 transform = se_mat4_extract_rotation(&object_ptr->transform, &current_scale);
+	const s_vec3 location = s_mat4_get_translation(&object_ptr->local_transform);
+	const s_vec3 current_scale = se_mat4_extract_basis_scale(&object_ptr->local_transform);
+	s_mat4 transform = se_mat4_extract_rotation(&object_ptr->local_transform, &current_scale);
 	se_mat4_apply_basis_scale(&transform, scale);
 	s_mat4_set_translation(&transform, &location);
 
-	object_ptr->transform = transform;
-	se_object_3d_set_instances_dirty(object, true);
+	object_ptr->local_transform = transform;
+	se_object_3d_mark_world_dirty(ctx, object_ptr, object);
 }
 
 s_mat4 se_object_3d_get_transform(const se_object_3d_handle object) {
 	se_context *ctx = se_current_context();
 	se_object_3d *object_ptr = se_object_3d_from_handle(ctx, object);
 	s_assertf(object_ptr, "se_object_3d_get_transform :: object is null");
+	se_object_3d_update_world(ctx, object_ptr);
 	return object_ptr->transform;
 }
 
+s_mat4 se_object_3d_get_local_transform(const se_object_3d_handle object) {
+	se_context *ctx = se_current_context();
+	se_object_3d *object_ptr = se_object_3d_from_handle(ctx, object);
+	s_assertf(object_ptr, "se_object_3d_get_local_transform :: object is null");
+	return object_ptr->local_transform;
+}
+
+b8 se_object_3d_set_parent(const se_object_3d_handle object, const se_object_3d_handle parent, const se_instance_id parent_instance_id) {
+	se_context *ctx = se_current_context();
+	se_object_3d *object_ptr = ctx ? se_object_3d_try_get(ctx, object) : NULL;
+	if (!object_ptr) {
+		se_set_last_error(SE_RESULT_NOT_FOUND);
+		return false;
+	}
+	if (parent != S_HANDLE_NULL) {
+		se_object_3d* parent_ptr = se_object_3d_try_get(ctx, parent);
+		if (!parent_ptr) {
+			se_set_last_error(SE_RESULT_NOT_FOUND);
+			return false;
+		}
+		if (parent_instance_id >= 0 && (parent_ptr->is_custom || se_object_3d_get_instance_index(parent, parent_instance_id) < 0)) {
+			se_set_last_error(SE_RESULT_NOT_FOUND);
+			return false;
+		}
+		for (se_object_3d_handle ancestor = parent; ancestor != S_HANDLE_NULL; ) {
+			if (ancestor == object) {
+				se_set_last_error(SE_RESULT_INVALID_ARGUMENT);
+				return false;
+			}
+			se_object_3d* ancestor_ptr = se_object_3d_try_get(ctx, ancestor);
+			ancestor = ancestor_ptr ? ancestor_ptr->parent : S_HANDLE_NULL;
+		}
+	}
+	if (object_ptr->parent != parent) {
+		se_object_3d_unlink_child(ctx, object_ptr->parent, object);
+		if (parent != S_HANDLE_NULL) {
+			se_object_3d* parent_ptr = se_object_3d_from_handle(ctx, parent);
+			s_array_add(&parent_ptr->children, object);
+		}
+	}
+	object_ptr->parent = parent;
+	object_ptr->parent_instance = parent != S_HANDLE_NULL && parent_instance_id >= 0 ? parent_instance_id : -1;
+	se_object_3d_mark_world_dirty(ctx, object_ptr, object);
+	se_set_last_error(SE_RESULT_OK);
+	return true;
+}
+
+se_object_3d_handle se_object_3d_get_parent(const se_object_3d_handle object, se_instance_id* out_parent_instance_id) {
+	se_context *ctx = se_current_context();
+	se_object_3d *object_ptr = se_object_3d_from_handle(ctx, object);
+	s_assertf(object_ptr, "se_object_3d_get_parent :: object is null");
+	if (out_parent_instance_id) {
+		*out_parent_instance_id = object_ptr->parent_instance;
+	}
+	return object_ptr->parent;
+}
+
 b8 se_object_3d_reserve_instances(const se_object_3d_handle object, const sz instance_capacity) {
 	se_context *ctx = se_current_context();
 	se_object_3d *object_ptr = se_object_3d_from_handle(ctx, object);
@@ -3764,7 +6601,7 @@ se_instance_id se_object_3d_add_instance(const se_object_3d_handle object, const
 	s_assertf(buffer, "se_object_3d_add_instance :: buffer is null");
 	const sz max_capacity = s_array_get_capacity(&object_ptr->instances.ids);
 	sz reuse_index = 0;
-	const b8 has_free_slot = se_instances_pop_free_index(&object_ptr->instances.free_indices, &reuse_index);
+	const b8 has_free_slot = se_instances_pop_free_index(&object_ptr->instances.free_indices, &object_ptr->instances.free_positions, &reuse_index);
 	if (!has_free_slot && max_capacity > 0 && s_array_get_size(&object_ptr->instances.ids) >= max_capacity) {
 		const sz next_capacity = s_max(max_capacity + 1, max_capacity * 2);
 		if (!se_object_3d_reserve_storage(object_ptr, next_capacity)) {
@@ -3773,14 +6610,24 @@ se_instance_id se_object_3d_add_instance(const se_object_3d_handle object, const
 		}
 	}
 
-	const se_instance_id new_id = object_ptr->instances.next_id++;
-	if (has_free_slot && reuse_index < s_array_get_size(&object_ptr->instances.ids)) {
+	const b8 reuse_slot = has_free_slot && reuse_index < s_array_get_size(&object_ptr->instances.ids);
+	const sz slot_index = reuse_slot ? reuse_index : s_array_get_size(&object_ptr->instances.ids);
+	const se_instance_id new_id = se_instances_id_alloc(&object_ptr->instances.id_map, &object_ptr->instances.next_id, (i32)slot_index);
+	if (new_id < 0) {
+		if (has_free_slot) {
+			se_instances_push_free_index(&object_ptr->instances.free_indices, &object_ptr->instances.free_positions, reuse_index);
+		}
+		se_set_last_error(SE_RESULT_CAPACITY_EXCEEDED);
+		return -1;
+	}
+	if (reuse_slot) {
 		se_instance_id* id = s_array_get(&object_ptr->instances.ids, s_array_handle(&object_ptr->instances.ids, (u32)reuse_index));
 		s_mat4* dst_transform = s_array_get(&object_ptr->instances.transforms, s_array_handle(&object_ptr->instances.transforms, (u32)reuse_index));
 		s_mat4* dst_buffer = s_array_get(&object_ptr->instances.buffers, s_array_handle(&object_ptr->instances.buffers, (u32)reuse_index));
 		b8* dst_active = s_array_get(&object_ptr->instances.actives, s_array_handle(&object_ptr->instances.actives, (u32)reuse_index));
 		s_mat4* dst_metadata = s_array_get(&object_ptr->instances.metadata, s_array_handle(&object_ptr->instances.metadata, (u32)reuse_index));
 		if (id && dst_transform && dst_buffer && dst_active && dst_metadata) {
+			se_instances_id_release(&object_ptr->instances.id_map, *id);
 			*id = new_id;
 			*dst_transform = *transform;
 			*dst_buffer = *buffer;
@@ -3796,6 +6643,7 @@ se_instance_id se_object_3d_add_instance(const se_object_3d_handle object, const
 		s_array_add(&object_ptr->instances.actives, active);
 		s_array_add(&object_ptr->instances.metadata, metadata);
 	}
+	se_object_3d_mark_spatial(object_ptr, (i32)slot_index);
 	se_object_3d_set_instances_dirty(object, true);
 
 	return new_id;
@@ -3810,12 +6658,9 @@ b8 se_object_3d_remove_instance(const se_object_3d_handle object, const se_insta
 		se_set_last_error(SE_RESULT_NOT_FOUND);
 		return false;
 	}
-	b8* active = s_array_get(&object_ptr->instances.actives, s_array_handle(&object_ptr->instances.actives, (u32)index));
-	if (active && *active) {
-		*active = false;
-		se_instances_push_free_index(&object_ptr->instances.free_indices, (sz)index);
-		se_object_3d_set_instances_dirty(object, true);
-	}
+	se_object_3d_swap_remove_slot(object_ptr, (sz)index);
+	se_object_3d_set_instances_dirty(object, true);
+	se_object_3d_mark_children_dirty(ctx, object_ptr);
 	se_set_last_error(SE_RESULT_OK);
 	return true;
 }
@@ -3824,20 +6669,10 @@ i32 se_object_3d_get_instance_index(const se_object_3d_handle object, const se_i
 	se_context *ctx = se_current_context();
 	se_object_3d *object_ptr = se_object_3d_from_handle(ctx, object);
 	s_assertf(object_ptr, "se_object_3d_get_instance_index :: object is null");
-	const sz count = s_array_get_size(&object_ptr->instances.ids);
-	if (instance_id >= 0 && (sz)instance_id < count) {
-		se_instance_id *quick = s_array_get(&object_ptr->instances.ids, s_array_handle(&object_ptr->instances.ids, (u32)instance_id));
-		if (quick && *quick == instance_id) {
-			return instance_id;
-		}
-	}
-	for (sz i = 0; i < s_array_get_size(&object_ptr->instances.ids); ++i) {
-		se_instance_id *found_instance = s_array_get(&object_ptr->instances.ids, s_array_handle(&object_ptr->instances.ids, (u32)i));
-		if (*found_instance == instance_id) {
-			return (i32)i;
-		}
+	if (object_ptr->is_custom) {
+		return -1;
 	}
-	return -1;
+	return se_instances_id_lookup(&object_ptr->instances.id_map, instance_id);
 }
 
 void se_object_3d_set_transform_by_id(const se_object_3d_handle object, const se_instance_id instance_id, const s_mat4 *transform) {
@@ -3849,7 +6684,9 @@ void se_object_3d_set_transform_by_id(const se_object_3d_handle object, const se
 	if (index >= 0) {
 		s_mat4 *current_transform = s_array_get(&object_ptr->instances.transforms, s_array_handle(&object_ptr->instances.transforms, (u32)index));
 		*current_transform = *transform;
+		se_object_3d_mark_spatial(object_ptr, index);
 		se_object_3d_set_instances_dirty(object, true);
+		se_object_3d_mark_children_dirty(ctx, object_ptr);
 		se_set_last_error(SE_RESULT_OK);
 	} else {
 		se_set_last_error(SE_RESULT_NOT_FOUND);
@@ -3887,9 +6724,11 @@ void se_object_3d_set_transforms_by_id(const se_object_3d_handle object, const s
 		s_mat4 *current_transform = s_array_get(&object_ptr->instances.transforms, s_array_handle(&object_ptr->instances.transforms, (u32)index));
 		if (current_transform) {
 			*current_transform = transforms[i];
+			se_object_3d_mark_spatial(object_ptr, index);
 		}
 	}
 	se_object_3d_set_instances_dirty(object, true);
+	se_object_3d_mark_children_dirty(ctx, object_ptr);
 }
 
 void se_object_3d_set_buffers_by_id(const se_object_3d_handle object, const se_instance_id* instance_ids, const s_mat4* buffers, const sz count) {
@@ -3928,11 +6767,13 @@ b8 se_object_3d_set_active_by_id(const se_object_3d_handle object, const se_inst
 	}
 	*entry = active;
 	if (active) {
-		se_instances_remove_free_index(&object_ptr->instances.free_indices, (sz)index);
+		se_instances_remove_free_index(&object_ptr->instances.free_indices, &object_ptr->instances.free_positions, (sz)index);
 	} else {
-		se_instances_push_free_index(&object_ptr->instances.free_indices, (sz)index);
+		se_instances_push_free_index(&object_ptr->instances.free_indices, &object_ptr->instances.free_positions, (sz)index);
 	}
+	se_object_3d_mark_spatial(object_ptr, index);
 	se_object_3d_set_instances_dirty(object, true);
+	se_object_3d_mark_children_dirty(ctx, object_ptr);
 	se_set_last_error(SE_RESULT_OK);
 	return true;
 }
@@ -4036,6 +6877,120 @@ sz se_object_3d_get_instance_count(const se_object_3d_handle object) {
 	return se_instances_active_count(&object_ptr->instances.actives);
 }
 
+void se_object_3d_set_translucent(const se_object_3d_handle object, const b8 translucent) {
+	se_context *ctx = se_current_context();
+	se_object_3d *object_ptr = se_object_3d_from_handle(ctx, object);
+	s_assertf(object_ptr, "se_object_3d_set_translucent :: object is null");
+	object_ptr->is_translucent = translucent;
+}
+
+static se_object_3d_lods* se_object_3d_lods_get(se_object_3d* object_ptr) {
+	if (!object_ptr->lods) {
+		object_ptr->lods = (se_object_3d_lods*)calloc(1u, sizeof(*object_ptr->lods));
+		if (!object_ptr->lods) {
+			return NULL;
+		}
+		object_ptr->lods->level_count = 1u;
+		object_ptr->lods->metric = SE_LOD_METRIC_DISTANCE;
+		object_ptr->lods->hysteresis = 0.1f;
+	}
+	return object_ptr->lods;
+}
+
+// Drops every level past 0; instances go back to the object's model on the next render.
+static void se_object_3d_lods_reset(const se_object_3d_handle object, se_object_3d* object_ptr) {
+	se_object_3d_lods* lods = object_ptr->lods;
+	if (!lods) {
+		return;
+	}
+	for (u32 i = 1u; i < lods->level_count; ++i) {
+		se_object_3d_lod_release(&lods->levels[i]);
+	}
+	lods->level_count = 1u;
+	if (lods->instance_levels) {
+		memset(lods->instance_levels, 0, lods->instance_level_capacity * sizeof(*lods->instance_levels));
+	}
+	// Level 0 drew into the object's buffers in LOD order, so they need a fresh sync.
+	se_object_3d_set_instances_dirty(object, true);
+}
+
+b8 se_object_3d_add_lod(const se_object_3d_handle object, const se_model_handle model, const f32 threshold) {
+	se_context *ctx = se_current_context();
+	se_object_3d *object_ptr = ctx ? se_object_3d_try_get(ctx, object) : NULL;
+	if (!object_ptr || object_ptr->is_custom || model == S_HANDLE_NULL || !se_model_from_handle(ctx, model) || !(threshold > 0.0f)) {
+		se_set_last_error(SE_RESULT_INVALID_ARGUMENT);
+		return false;
+	}
+	se_object_3d_lods* lods = se_object_3d_lods_get(object_ptr);
+	if (!lods) {
+		se_set_last_error(SE_RESULT_OUT_OF_MEMORY);
+		return false;
+	}
+	if (lods->level_count >= SE_OBJECT_3D_MAX_LODS) {
+		se_set_last_error(SE_RESULT_CAPACITY_EXCEEDED);
+		return false;
+	}
+	if (lods->level_count > 1u) {
+		const f32 previous = lods->levels[lods->level_count - 1u].threshold;
+		const b8 coarser = lods->metric == SE_LOD_METRIC_SCREEN_SIZE ? threshold < previous : threshold > previous;
+		if (!coarser) {
+			se_set_last_error(SE_RESULT_INVALID_ARGUMENT);
+			return false;
+		}
+	}
+	se_object_3d_lod* level = &lods->levels[lods->level_count];
+	memset(level, 0, sizeof(*level));
+	level->model = model;
+	level->threshold = threshold;
+	lods->level_count++;
+	// The LOD path only refills level buffers when something changed, so start from a fill.
+	se_object_3d_set_instances_dirty(object, true);
+	se_set_last_error(SE_RESULT_OK);
+	return true;
+}
+
+void se_object_3d_clear_lods(const se_object_3d_handle object) {
+	se_context *ctx = se_current_context();
+	se_object_3d *object_ptr = se_object_3d_from_handle(ctx, object);
+	s_assertf(object_ptr, "se_object_3d_clear_lods :: object is null");
+	if (object_ptr->is_custom) {
+		return;
+	}
+	se_object_3d_lods_reset(object, object_ptr);
+}
+
+u32 se_object_3d_get_lod_count(const se_object_3d_handle object) {
+	se_context *ctx = se_current_context();
+	se_object_3d *object_ptr = se_object_3d_from_handle(ctx, object);
+	s_assertf(object_ptr, "se_object_3d_get_lod_count :: object is null");
+	if (object_ptr->is_custom || !object_ptr->lods) {
+		return 1u;
+	}
+	return object_ptr->lods->level_count;
+}
+
+b8 se_object_3d_set_lod_metric(const se_object_3d_handle object, const se_lod_metric metric, const f32 hysteresis) {
+	se_context *ctx = se_current_context();
+	se_object_3d *object_ptr = ctx ? se_object_3d_try_get(ctx, object) : NULL;
+	if (!object_ptr || object_ptr->is_custom || (metric != SE_LOD_METRIC_DISTANCE && metric != SE_LOD_METRIC_SCREEN_SIZE) || !(hysteresis >= 0.0f && hysteresis < 1.0f)) {
+		se_set_last_error(SE_RESULT_INVALID_ARGUMENT);
+		return false;
+	}
+	se_object_3d_lods* lods = se_object_3d_lods_get(object_ptr);
+	if (!lods) {
+		se_set_last_error(SE_RESULT_OUT_OF_MEMORY);
+		return false;
+	}
+	// Thresholds of one metric mean nothing to the other.
+	if (lods->metric != metric) {
+		se_object_3d_lods_reset(object, object_ptr);
+		lods->metric = metric;
+	}
+	lods->hysteresis = hysteresis;
+	se_set_last_error(SE_RESULT_OK);
+	return true;
+}
+
 s_json* se_object_3d_to_json(const se_object_3d_handle object) {
 	se_context* ctx = se_current_context();
 	if (!ctx || object == S_HANDLE_NULL) {
@@ -4072,7 +7027,7 @@ s_json* se_object_3d_to_json(const se_object_3d_handle object) {
 	}
 	if (!se_scene_2d_json_add_string(root, "format", SE_OBJECT_3D_JSON_FORMAT) ||
 		!se_scene_2d_json_add_u32(root, "version", SE_OBJECT_3D_JSON_VERSION) ||
-		!se_scene_json_add_mat4(root, "transform", &object_ptr->transform) ||
+		!se_scene_json_add_mat4(root, "transform", &object_ptr->local_transform) ||
 		!se_scene_2d_json_add_bool(root, "visible", object_ptr->is_visible) ||
 		!se_scene_2d_json_add_u32(root, "instance_capacity", (u32)s_array_get_capacity(&object_ptr->instances.ids)) ||
 		!se_scene_2d_json_add_i32(root, "next_instance_id", object_ptr->instances.next_id)) {
@@ -4201,7 +7156,7 @@ b8 se_object_3d_from_json(const se_object_3d_handle object, const s_json* root)
 		return false;
 	}
 
-	i32 max_instance_id = -1;
+	i32 max_instance_index = -1;
 	for (sz slot_index = 0; slot_index < slot_count; ++slot_index) {
 		const s_json* slot_json = s_json_at(instances_json, slot_index);
 		i32 instance_id = 0;
@@ -4219,21 +7174,21 @@ b8 se_object_3d_from_json(const se_object_3d_handle object, const s_json* root)
 			se_set_last_error(SE_RESULT_INVALID_ARGUMENT);
 			return false;
 		}
-		max_instance_id = s_max(max_instance_id, instance_id);
+		max_instance_index = s_max(max_instance_index, instance_id < 0 ? -1 : (i32)se_instance_id_index(instance_id));
 	}
 
-	if (slot_count > 0 && next_instance_id <= max_instance_id) {
+	if (slot_count > 0 && next_instance_id <= max_instance_index) {
 		se_set_last_error(SE_RESULT_INVALID_ARGUMENT);
 		return false;
 	}
 
-	object_ptr->transform = object_transform;
+	object_ptr->local_transform = object_transform;
 	object_ptr->is_visible = visible;
 	se_instance_ids_clear_keep_capacity(&object_ptr->instances.ids);
 	se_transforms_clear_keep_capacity(&object_ptr->instances.transforms);
 	se_buffers_clear_keep_capacity(&object_ptr->instances.buffers);
 	se_instance_actives_clear_keep_capacity(&object_ptr->instances.actives);
-	se_instance_ids_clear_keep_capacity(&object_ptr->instances.free_indices);
+	se_instances_clear_free_indices(&object_ptr->instances.free_indices, &object_ptr->instances.free_positions);
 	se_buffers_clear_keep_capacity(&object_ptr->instances.metadata);
 	se_transforms_clear_keep_capacity(&object_ptr->render_transforms);
 	se_buffers_clear_keep_capacity(&object_ptr->render_buffers);
@@ -4265,13 +7220,14 @@ b8 se_object_3d_from_json(const se_object_3d_handle object, const s_json* root)
 		s_array_add(&object_ptr->instances.metadata, instance_metadata);
 
 		if (!active) {
-			se_instances_push_free_index(&object_ptr->instances.free_indices, slot_index);
+			se_instances_push_free_index(&object_ptr->instances.free_indices, &object_ptr->instances.free_positions, slot_index);
 		}
 	}
 
 	object_ptr->instances.next_id = (se_instance_id)next_instance_id;
+	se_instances_id_rebuild(&object_ptr->instances.id_map, &object_ptr->instances.ids, &object_ptr->instances.next_id);
 	se_object_3d_refresh_mesh_instance_sources(object_ptr);
-	se_object_3d_set_instances_dirty(object, true);
+	se_object_3d_mark_world_dirty(ctx, object_ptr, object);
 	se_set_last_error(SE_RESULT_OK);
 	return true;
 }
@@ -9,6 +9,7 @@
 #include "se_texture.h"
 #include "se_window.h"
 #include "render/se_gl.h"
+#include "render/se_gl_stream.h"
 
 #include <math.h>
 #include <stddef.h>
@@ -64,6 +65,7 @@ typedef struct {
 	u32 color_vbo;
 	u32 index_count;
 	u32 mesh_index;
+	b8 streamed;
 } se_vfx_mesh_draw;
 typedef s_array(se_vfx_mesh_draw, se_vfx_mesh_draws);
 
@@ -681,12 +683,43 @@ static b8 se_vfx_emitter_3d_create_mesh_draws(se_context* ctx, se_vfx_emitter_3d
 	return true;
 }
 
-static void se_vfx_mesh_draw_upload(const se_vfx_mesh_draw* draw, const se_vfx_render_instances_3d* transforms, const se_vfx_render_colors_3d* colors, const sz instance_count) {
+static void se_vfx_mesh_draw_set_instance_attributes(const GLuint transform_buffer, const GLintptr transform_offset, const GLuint color_buffer, const GLintptr color_offset) {
+	glBindBuffer(GL_ARRAY_BUFFER, transform_buffer);
+	for (u32 col = 0u; col < 4u; ++col) {
+		glVertexAttribPointer(3u + col, 4, GL_FLOAT, GL_FALSE, sizeof(s_mat4), (const void*)(transform_offset + (GLintptr)(sizeof(s_vec4) * col)));
+	}
+	glBindBuffer(GL_ARRAY_BUFFER, color_buffer);
+	glVertexAttribPointer(7, 4, GL_FLOAT, GL_FALSE, sizeof(s_vec4), (const void*)color_offset);
+}
+
+// Binds the draw's VAO. Instances go through the shared streaming ring when it has room and
+// fall back to the draw's own buffers otherwise.
+static void se_vfx_mesh_draw_upload(se_vfx_mesh_draw* draw, const se_vfx_render_instances_3d* transforms, const se_vfx_render_colors_3d* colors, const sz instance_count) {
 	if (!draw || instance_count == 0) {
 		return;
 	}
 	const s_mat4* transform_data = s_array_get_data((se_vfx_render_instances_3d*)transforms);
 	const s_vec4* color_data = s_array_get_data((se_vfx_render_colors_3d*)colors);
+	const GLsizeiptr transform_bytes = (GLsizeiptr)(sizeof(s_mat4) * instance_count);
+	const GLsizeiptr color_bytes = (GLsizeiptr)(sizeof(s_vec4) * instance_count);
+	GLintptr stream_offset = 0;
+	u8* stream = (u8*)se_gl_stream_map(transform_bytes + color_bytes, (GLsizeiptr)sizeof(s_vec4), &stream_offset);
+	if (stream) {
+		memcpy(stream, transform_data, (sz)transform_bytes);
+		memcpy(stream + transform_bytes, color_data, (sz)color_bytes);
+		se_gl_stream_commit(stream);
+		const GLuint stream_buffer = se_gl_stream_buffer();
+		glBindVertexArray(draw->vao);
+		se_vfx_mesh_draw_set_instance_attributes(stream_buffer, stream_offset, stream_buffer, stream_offset + transform_bytes);
+		glBindBuffer(GL_ARRAY_BUFFER, 0);
+		draw->streamed = true;
+		return;
+	}
+	glBindVertexArray(draw->vao);
+	if (draw->streamed) {
+		se_vfx_mesh_draw_set_instance_attributes(draw->transform_vbo, 0, draw->color_vbo, 0);
+		draw->streamed = false;
+	}
 	glBindBuffer(GL_ARRAY_BUFFER, draw->transform_vbo);
 	glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(s_mat4) * instance_count, transform_data);
 	glBindBuffer(GL_ARRAY_BUFFER, draw->color_vbo);
@@ -1441,7 +1474,6 @@ static void se_vfx_render_emitters_3d(struct se_vfx_3d* vfx, const se_camera_han
 					continue;
 				}
 				se_vfx_mesh_draw_upload(draw, &emitter->render_instances, &emitter->render_colors, alive_count);
-				glBindVertexArray(draw->vao);
 				glDrawElementsInstanced(GL_TRIANGLES, draw->index_count, GL_UNSIGNED_INT, 0, (GLsizei)alive_count);
 			}
 			glBindVertexArray(0);
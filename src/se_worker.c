@@ -7,6 +7,15 @@
 #include <stdlib.h>
 #include <string.h>
 
+#if defined(__linux__) && !defined(__ANDROID__)
+#define SE_WORKER_FIBERS_SUPPORTED 1
+#include <sys/mman.h>
+#include <ucontext.h>
+#include <unistd.h>
+#else
+#define SE_WORKER_FIBERS_SUPPORTED 0
+#endif
+
 typedef enum {
 	SE_WORKER_TASK_STATE_QUEUED = 0,
 	SE_WORKER_TASK_STATE_RUNNING,
@@ -25,12 +34,29 @@ typedef struct {
 	se_worker_task_fn fn;
 	void* user_data;
 	void* result;
+	se_worker_group group;
 	se_worker_task_state state;
 } se_worker_task_record;
 
+typedef struct {
+	se_worker_task* tasks;
+	u32 count;
+	u32 remaining;
+} se_worker_group_record;
+
+typedef struct se_worker_fiber se_worker_fiber;
+
 typedef struct {
 	se_worker_pool* pool;
 	u32 index;
+	se_worker_fiber* current_fiber;
+	se_worker_fiber* ready_fibers;
+	se_worker_fiber* free_fibers;
+	// Every fiber this thread created, whatever its state, so the pool can free them all.
+	se_worker_fiber* all_fibers;
+#if SE_WORKER_FIBERS_SUPPORTED
+	ucontext_t scheduler_context;
+#endif
 } se_worker_thread_context;
 
 typedef struct {
@@ -40,6 +66,25 @@ typedef struct {
 	b8 valid;
 } se_worker_task_claim;
 
+#if SE_WORKER_FIBERS_SUPPORTED
+// Fibers are pinned to the worker thread that started them and only resumed there.
+struct se_worker_fiber {
+	ucontext_t context;
+	// Usable stack above its guard page; `stack_bytes` is a whole number of pages.
+	void* stack;
+	sz stack_bytes;
+	se_worker_fiber* next;
+	se_worker_fiber* all_next;
+	se_worker_thread_context* owner;
+	se_worker_task_claim claim;
+	se_worker_pool* saved_tls_pool;
+	se_worker_task saved_tls_task;
+	se_worker_task wait_task;
+	se_worker_group wait_group;
+	b8 finished;
+};
+#endif
+
 typedef struct {
 	se_worker_for_fn fn;
 	void* user_data;
@@ -50,18 +95,25 @@ typedef struct {
 } se_worker_parallel_for_state;
 
 typedef s_array(se_worker_task_record, se_worker_task_records);
+typedef s_array(se_worker_group_record, se_worker_group_records);
 
 struct se_worker_pool {
 	se_worker_config config;
 	se_worker_task_records tasks;
+	se_worker_group_records groups;
 	s_thread* threads;
 	se_worker_thread_context* thread_contexts;
 	se_worker_task* queue;
+	se_worker_fiber* suspended_fibers;
 	s_mutex mutex;
 	s_cond work_ready;
 	s_cond state_changed;
 	u64 submitted_tasks;
+	u64 submitted_batches;
 	u64 completed_tasks;
+	u64 fiber_yields;
+	u32 fiber_count;
+	u32 suspended_fiber_count;
 	u32 active_tasks;
 	u32 queue_head;
 	u32 queue_count;
@@ -75,15 +127,29 @@ struct se_worker_pool {
 
 static SE_THREAD_LOCAL se_worker_pool* g_se_worker_tls_pool = NULL;
 static SE_THREAD_LOCAL se_worker_task g_se_worker_tls_task = SE_WORKER_TASK_NULL;
+static SE_THREAD_LOCAL se_worker_thread_context* g_se_worker_tls_thread = NULL;
 
 static se_worker_config se_worker_resolve_config(const se_worker_config* config);
 static se_result se_worker_submit_result_to_error(se_worker_submit_result result);
+static se_worker_task se_worker_enqueue_locked(se_worker_pool* pool, se_worker_task_fn fn, void* user_data, se_worker_group group);
 static se_worker_submit_result se_worker_submit_locked(se_worker_pool* pool, se_worker_task_fn fn, void* user_data, se_worker_task* out_task);
+static se_worker_submit_result se_worker_submit_batch_locked(se_worker_pool* pool, se_worker_task_fn fn, void** user_data_array, void* shared_user_data, u32 count, se_worker_task* group_tasks, se_worker_group* out_group);
+static void se_worker_release_group_locked(se_worker_pool* pool, se_worker_group group);
 static b8 se_worker_try_claim_task_locked(se_worker_pool* pool, se_worker_task_claim* out_claim);
 static void se_worker_execute_claim(se_worker_pool* pool, const se_worker_task_claim* claim);
+#if SE_WORKER_FIBERS_SUPPORTED
+static b8 se_worker_wait_target_done_locked(se_worker_pool* pool, se_worker_task task, se_worker_group group);
+#endif
+static se_worker_fiber* se_worker_fiber_current(se_worker_pool* pool);
+static se_worker_fiber* se_worker_fiber_pop_ready_locked(se_worker_thread_context* thread);
+static se_worker_fiber* se_worker_fiber_acquire_locked(se_worker_thread_context* thread, const se_worker_task_claim* claim);
+static void se_worker_fiber_run(se_worker_thread_context* thread, se_worker_fiber* fiber);
+static void se_worker_fiber_yield_locked(se_worker_pool* pool, se_worker_fiber* fiber, se_worker_task task, se_worker_group group);
+static void se_worker_fiber_wake_locked(se_worker_pool* pool);
+static void se_worker_fiber_free_all(se_worker_pool* pool);
+static b8 se_worker_fiber_resume_ready_locked(se_worker_pool* pool);
 static void* se_worker_thread_main(void* user_data);
 static void* se_worker_parallel_for_task(void* user_data);
-static b8 se_worker_wait_for_queue_room(se_worker_pool* pool);
 static void se_worker_shutdown_threads(se_worker_pool* pool);
 static void se_worker_cleanup_pool(se_worker_pool* pool);
 
@@ -101,7 +167,13 @@ static se_worker_config se_worker_resolve_config(const se_worker_config* config)
 		if (resolved.max_tasks == 0u) {
 			resolved.max_tasks = defaults.max_tasks;
 		}
+		if (resolved.fiber_stack_size == 0u) {
+			resolved.fiber_stack_size = defaults.fiber_stack_size;
+		}
 	}
+#if !SE_WORKER_FIBERS_SUPPORTED
+	resolved.use_fibers = false;
+#endif
 	return resolved;
 }
 
@@ -134,9 +206,22 @@ static se_worker_submit_result se_worker_submit_locked(
 		return SE_WORKER_SUBMIT_QUEUE_FULL;
 	}
 
+	*out_task = se_worker_enqueue_locked(pool, fn, user_data, SE_WORKER_GROUP_NULL);
+
+	s_cond_signal(&pool->work_ready);
+	s_cond_broadcast(&pool->state_changed);
+	return SE_WORKER_SUBMIT_OK;
+}
+
+static se_worker_task se_worker_enqueue_locked(
+	se_worker_pool* pool,
+	se_worker_task_fn fn,
+	void* user_data,
+	const se_worker_group group) {
 	se_worker_task_record record = {0};
 	record.fn = fn;
 	record.user_data = user_data;
+	record.group = group;
 	record.state = SE_WORKER_TASK_STATE_QUEUED;
 
 	const se_worker_task task = s_array_add(&pool->tasks, record);
@@ -144,13 +229,69 @@ static se_worker_submit_result se_worker_submit_locked(
 	pool->queue[tail] = task;
 	pool->queue_count++;
 	pool->submitted_tasks++;
-	*out_task = task;
+	return task;
+}
 
-	s_cond_signal(&pool->work_ready);
+// Takes ownership of `group_tasks` on success. Each task receives `user_data_array[i]`
+// when an array is given, otherwise `shared_user_data`.
+static se_worker_submit_result se_worker_submit_batch_locked(
+	se_worker_pool* pool,
+	se_worker_task_fn fn,
+	void** user_data_array,
+	void* shared_user_data,
+	const u32 count,
+	se_worker_task* group_tasks,
+	se_worker_group* out_group) {
+	if (!pool || !fn || count == 0u || !group_tasks || !out_group) {
+		return SE_WORKER_SUBMIT_INVALID;
+	}
+	if (!pool->running || pool->stopping) {
+		return SE_WORKER_SUBMIT_STOPPING;
+	}
+	const sz tracked_tasks = s_array_get_size(&pool->tasks);
+	if (tracked_tasks >= pool->config.max_tasks || pool->config.max_tasks - tracked_tasks < count) {
+		return SE_WORKER_SUBMIT_TASKS_FULL;
+	}
+	if (pool->config.queue_capacity - pool->queue_count < count) {
+		return SE_WORKER_SUBMIT_QUEUE_FULL;
+	}
+
+	se_worker_group_record group_record = {0};
+	group_record.tasks = group_tasks;
+	group_record.count = count;
+	group_record.remaining = count;
+	const se_worker_group group = s_array_add(&pool->groups, group_record);
+
+	for (u32 i = 0u; i < count; ++i) {
+		void* user_data = user_data_array ? user_data_array[i] : shared_user_data;
+		group_tasks[i] = se_worker_enqueue_locked(pool, fn, user_data, group);
+	}
+	pool->submitted_batches++;
+	*out_group = group;
+
+	if (count == 1u) {
+		s_cond_signal(&pool->work_ready);
+	} else {
+		s_cond_broadcast(&pool->work_ready);
+	}
 	s_cond_broadcast(&pool->state_changed);
 	return SE_WORKER_SUBMIT_OK;
 }
 
+static void se_worker_release_group_locked(se_worker_pool* pool, const se_worker_group group) {
+	se_worker_group_record* group_record = s_array_get(&pool->groups, group);
+	if (!group_record) {
+		return;
+	}
+
+	for (u32 i = 0u; i < group_record->count; ++i) {
+		(void)s_array_remove(&pool->tasks, group_record->tasks[i]);
+	}
+	free(group_record->tasks);
+	(void)s_array_remove(&pool->groups, group);
+	s_cond_broadcast(&pool->state_changed);
+}
+
 static b8 se_worker_try_claim_task_locked(se_worker_pool* pool, se_worker_task_claim* out_claim) {
 	if (!pool || !out_claim) {
 		return false;
@@ -201,6 +342,15 @@ static void se_worker_execute_claim(se_worker_pool* pool, const se_worker_task_c
 	if (record) {
 		record->result = result;
 		record->state = SE_WORKER_TASK_STATE_DONE;
+		if (record->group != SE_WORKER_GROUP_NULL) {
+			se_worker_group_record* group_record = s_array_get(&pool->groups, record->group);
+			if (group_record && group_record->remaining > 0u) {
+				group_record->remaining--;
+			}
+		}
+	}
+	if (pool->suspended_fibers) {
+		se_worker_fiber_wake_locked(pool);
 	}
 	if (pool->active_tasks > 0u) {
 		pool->active_tasks--;
@@ -210,6 +360,257 @@ static void se_worker_execute_claim(se_worker_pool* pool, const se_worker_task_c
 	s_mutex_unlock(&pool->mutex);
 }
 
+#if SE_WORKER_FIBERS_SUPPORTED
+static b8 se_worker_wait_target_done_locked(se_worker_pool* pool, const se_worker_task task, const se_worker_group group) {
+	if (task != SE_WORKER_TASK_NULL) {
+		const se_worker_task_record* record = s_array_get(&pool->tasks, task);
+		return !record || record->state == SE_WORKER_TASK_STATE_DONE;
+	}
+	const se_worker_group_record* group_record = s_array_get(&pool->groups, group);
+	return !group_record || group_record->remaining == 0u;
+}
+
+static void se_worker_fiber_entry(void) {
+	se_worker_thread_context* thread = g_se_worker_tls_thread;
+	se_worker_fiber* fiber = thread->current_fiber;
+	se_worker_execute_claim(thread->pool, &fiber->claim);
+	fiber->finished = true;
+}
+
+static se_worker_fiber* se_worker_fiber_current(se_worker_pool* pool) {
+	se_worker_thread_context* thread = g_se_worker_tls_thread;
+	if (!thread || thread->pool != pool) {
+		return NULL;
+	}
+	return thread->current_fiber;
+}
+
+static se_worker_fiber* se_worker_fiber_pop_ready_locked(se_worker_thread_context* thread) {
+	se_worker_fiber* fiber = thread->ready_fibers;
+	if (fiber) {
+		thread->ready_fibers = fiber->next;
+		fiber->next = NULL;
+	}
+	return fiber;
+}
+
+static sz se_worker_fiber_page_size(void) {
+	const long page_size = sysconf(_SC_PAGESIZE);
+	return page_size > 0 ? (sz)page_size : 4096u;
+}
+
+// Stacks grow down, so a PROT_NONE page under each one turns an overflow into a fault instead
+// of silent corruption of whatever the allocator put next to it.
+static b8 se_worker_fiber_stack_alloc(se_worker_fiber* fiber, const u32 stack_size) {
+	const sz page_size = se_worker_fiber_page_size();
+	const sz stack_bytes = (((sz)stack_size + page_size - 1u) / page_size) * page_size;
+	u8* mapping = mmap(NULL, stack_bytes + page_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_STACK, -1, 0);
+	if (mapping == MAP_FAILED) {
+		return false;
+	}
+	if (mprotect(mapping, page_size, PROT_NONE) != 0) {
+		munmap(mapping, stack_bytes + page_size);
+		return false;
+	}
+	fiber->stack = mapping + page_size;
+	fiber->stack_bytes = stack_bytes;
+	return true;
+}
+
+static void se_worker_fiber_stack_free(se_worker_fiber* fiber) {
+	if (!fiber->stack) {
+		return;
+	}
+	const sz page_size = se_worker_fiber_page_size();
+	munmap((u8*)fiber->stack - page_size, fiber->stack_bytes + page_size);
+	fiber->stack = NULL;
+	fiber->stack_bytes = 0u;
+}
+
+static se_worker_fiber* se_worker_fiber_acquire_locked(se_worker_thread_context* thread, const se_worker_task_claim* claim) {
+	se_worker_pool* pool = thread->pool;
+	if (!pool->config.use_fibers) {
+		return NULL;
+	}
+
+	se_worker_fiber* fiber = thread->free_fibers;
+	if (fiber) {
+		thread->free_fibers = fiber->next;
+	} else {
+		fiber = calloc(1, sizeof(*fiber));
+		if (!fiber) {
+			return NULL;
+		}
+		if (!se_worker_fiber_stack_alloc(fiber, pool->config.fiber_stack_size)) {
+			free(fiber);
+			return NULL;
+		}
+		fiber->owner = thread;
+		fiber->all_next = thread->all_fibers;
+		thread->all_fibers = fiber;
+		pool->fiber_count++;
+	}
+
+	if (getcontext(&fiber->context) != 0) {
+		fiber->next = thread->free_fibers;
+		thread->free_fibers = fiber;
+		return NULL;
+	}
+	fiber->context.uc_stack.ss_sp = fiber->stack;
+	fiber->context.uc_stack.ss_size = fiber->stack_bytes;
+	fiber->context.uc_link = &thread->scheduler_context;
+	makecontext(&fiber->context, se_worker_fiber_entry, 0);
+
+	fiber->next = NULL;
+	fiber->claim = *claim;
+	fiber->wait_task = SE_WORKER_TASK_NULL;
+	fiber->wait_group = SE_WORKER_GROUP_NULL;
+	fiber->finished = false;
+	return fiber;
+}
+
+static void se_worker_fiber_run(se_worker_thread_context* thread, se_worker_fiber* fiber) {
+	thread->current_fiber = fiber;
+	(void)swapcontext(&thread->scheduler_context, &fiber->context);
+	thread->current_fiber = NULL;
+	g_se_worker_tls_pool = NULL;
+	g_se_worker_tls_task = SE_WORKER_TASK_NULL;
+
+	// Unfinished fibers were parked on the suspended list before switching back.
+	if (fiber->finished) {
+		fiber->next = thread->free_fibers;
+		thread->free_fibers = fiber;
+	}
+}
+
+// Parks the calling fiber until the target completes. Returns unlocked, after the owner
+// thread resumed the fiber.
+static void se_worker_fiber_yield_locked(
+	se_worker_pool* pool,
+	se_worker_fiber* fiber,
+	const se_worker_task task,
+	const se_worker_group group) {
+	fiber->wait_task = task;
+	fiber->wait_group = group;
+	fiber->next = pool->suspended_fibers;
+	pool->suspended_fibers = fiber;
+	pool->suspended_fiber_count++;
+	pool->fiber_yields++;
+	fiber->saved_tls_pool = g_se_worker_tls_pool;
+	fiber->saved_tls_task = g_se_worker_tls_task;
+	s_mutex_unlock(&pool->mutex);
+
+	(void)swapcontext(&fiber->context, &fiber->owner->scheduler_context);
+
+	g_se_worker_tls_pool = fiber->saved_tls_pool;
+	g_se_worker_tls_task = fiber->saved_tls_task;
+}
+
+static void se_worker_fiber_wake_locked(se_worker_pool* pool) {
+	b8 woke = false;
+	se_worker_fiber** link = &pool->suspended_fibers;
+	while (*link) {
+		se_worker_fiber* fiber = *link;
+		if (!se_worker_wait_target_done_locked(pool, fiber->wait_task, fiber->wait_group)) {
+			link = &fiber->next;
+			continue;
+		}
+		*link = fiber->next;
+		fiber->next = fiber->owner->ready_fibers;
+		fiber->owner->ready_fibers = fiber;
+		pool->suspended_fiber_count--;
+		woke = true;
+	}
+	if (woke) {
+		s_cond_broadcast(&pool->work_ready);
+	}
+}
+
+static void se_worker_fiber_free_all(se_worker_pool* pool) {
+	if (!pool->thread_contexts) {
+		return;
+	}
+	for (u32 i = 0u; i < pool->config.thread_count; ++i) {
+		// Fibers still suspended or ready at destroy are freed with the rest; their tasks never finish.
+		se_worker_fiber* fiber = pool->thread_contexts[i].all_fibers;
+		while (fiber) {
+			se_worker_fiber* next = fiber->all_next;
+			se_worker_fiber_stack_free(fiber);
+			free(fiber);
+			fiber = next;
+		}
+		pool->thread_contexts[i].all_fibers = NULL;
+		pool->thread_contexts[i].free_fibers = NULL;
+		pool->thread_contexts[i].ready_fibers = NULL;
+	}
+	pool->suspended_fibers = NULL;
+	pool->suspended_fiber_count = 0u;
+	pool->fiber_count = 0u;
+}
+
+// A task that had to run on the thread stack blocks its thread while it waits, and fibers
+// are pinned to their thread, so the wait resumes this thread's ready fibers itself. Returns
+// unlocked when it ran one.
+static b8 se_worker_fiber_resume_ready_locked(se_worker_pool* pool) {
+	se_worker_thread_context* thread = g_se_worker_tls_thread;
+	if (!thread || thread->pool != pool || thread->current_fiber) {
+		return false;
+	}
+	se_worker_fiber* fiber = se_worker_fiber_pop_ready_locked(thread);
+	if (!fiber) {
+		return false;
+	}
+	s_mutex_unlock(&pool->mutex);
+	se_worker_pool* previous_pool = g_se_worker_tls_pool;
+	const se_worker_task previous_task = g_se_worker_tls_task;
+	se_worker_fiber_run(thread, fiber);
+	g_se_worker_tls_pool = previous_pool;
+	g_se_worker_tls_task = previous_task;
+	return true;
+}
+#else
+static se_worker_fiber* se_worker_fiber_current(se_worker_pool* pool) {
+	(void)pool;
+	return NULL;
+}
+
+static se_worker_fiber* se_worker_fiber_pop_ready_locked(se_worker_thread_context* thread) {
+	(void)thread;
+	return NULL;
+}
+
+static se_worker_fiber* se_worker_fiber_acquire_locked(se_worker_thread_context* thread, const se_worker_task_claim* claim) {
+	(void)thread;
+	(void)claim;
+	return NULL;
+}
+
+static void se_worker_fiber_run(se_worker_thread_context* thread, se_worker_fiber* fiber) {
+	(void)thread;
+	(void)fiber;
+}
+
+static void se_worker_fiber_yield_locked(se_worker_pool* pool, se_worker_fiber* fiber, se_worker_task task, se_worker_group group) {
+	(void)fiber;
+	(void)task;
+	(void)group;
+	s_mutex_unlock(&pool->mutex);
+}
+
+static void se_worker_fiber_wake_locked(se_worker_pool* pool) {
+	(void)pool;
+}
+
+static void se_worker_fiber_free_all(se_worker_pool* pool) {
+	(void)pool;
+}
+
+static b8 se_worker_fiber_resume_ready_locked(se_worker_pool* pool) {
+	(void)pool;
+	return false;
+}
+#endif
+
 static void* se_worker_thread_main(void* user_data) {
 	se_worker_thread_context* context = (se_worker_thread_context*)user_data;
 	if (!context || !context->pool) {
@@ -217,28 +618,39 @@ static void* se_worker_thread_main(void* user_data) {
 	}
 
 	se_worker_pool* pool = context->pool;
-	(void)context->index;
+	g_se_worker_tls_thread = context;
 
 	for (;;) {
 		se_worker_task_claim claim = {0};
+		se_worker_fiber* fiber = NULL;
 
 		s_mutex_lock(&pool->mutex);
-		while (pool->queue_count == 0u && pool->running) {
+		while (pool->queue_count == 0u && !context->ready_fibers && pool->running) {
 			s_cond_wait(&pool->work_ready, &pool->mutex);
 		}
-		if (pool->queue_count == 0u && !pool->running) {
+		if (pool->queue_count == 0u && !context->ready_fibers && !pool->running) {
 			s_mutex_unlock(&pool->mutex);
 			break;
 		}
-		if (!se_worker_try_claim_task_locked(pool, &claim)) {
-			s_mutex_unlock(&pool->mutex);
-			continue;
+		fiber = se_worker_fiber_pop_ready_locked(context);
+		if (!fiber) {
+			if (!se_worker_try_claim_task_locked(pool, &claim)) {
+				s_mutex_unlock(&pool->mutex);
+				continue;
+			}
+			fiber = se_worker_fiber_acquire_locked(context, &claim);
 		}
 		s_mutex_unlock(&pool->mutex);
 
-		se_worker_execute_claim(pool, &claim);
+		if (fiber) {
+			se_worker_fiber_run(context, fiber);
+		} else {
+			// No fiber to spare: waits inside the task resume this thread's ready fibers.
+			se_worker_execute_claim(pool, &claim);
+		}
 	}
 
+	g_se_worker_tls_thread = NULL;
 	return NULL;
 }
 
@@ -273,20 +685,6 @@ static void* se_worker_parallel_for_task(void* user_data) {
 	return NULL;
 }
 
-static b8 se_worker_wait_for_queue_room(se_worker_pool* pool) {
-	if (!pool) {
-		return false;
-	}
-
-	s_mutex_lock(&pool->mutex);
-	while (pool->running && !pool->stopping && pool->queue_count >= pool->config.queue_capacity) {
-		s_cond_wait(&pool->state_changed, &pool->mutex);
-	}
-	const b8 ok = pool->running && !pool->stopping && pool->queue_count < pool->config.queue_capacity;
-	s_mutex_unlock(&pool->mutex);
-	return ok;
-}
-
 static void se_worker_shutdown_threads(se_worker_pool* pool) {
 	if (!pool || !pool->mutex_ready) {
 		return;
@@ -327,6 +725,12 @@ static void se_worker_cleanup_pool(se_worker_pool* pool) {
 		s_mutex_destroy(&pool->mutex);
 		pool->mutex_ready = false;
 	}
+	se_worker_fiber_free_all(pool);
+	se_worker_group_record* group_record = NULL;
+	s_foreach(&pool->groups, group_record) {
+		free(group_record->tasks);
+	}
+	s_array_clear(&pool->groups);
 	s_array_clear(&pool->tasks);
 	free(pool->queue);
 	free(pool->thread_contexts);
@@ -346,6 +750,7 @@ se_worker_pool* se_worker_create(const se_worker_config* config) {
 	pool->config = resolved;
 	s_array_init(&pool->tasks);
 	s_array_reserve(&pool->tasks, pool->config.max_tasks);
+	s_array_init(&pool->groups);
 
 	pool->threads = calloc(pool->config.thread_count, sizeof(*pool->threads));
 	pool->thread_contexts = calloc(pool->config.thread_count, sizeof(*pool->thread_contexts));
@@ -497,6 +902,14 @@ b8 se_worker_wait(se_worker_pool* pool, se_worker_task task, void** out_result)
 			se_set_last_error(SE_RESULT_OK);
 			return true;
 		}
+		se_worker_fiber* fiber = se_worker_fiber_current(pool);
+		if (fiber) {
+			se_worker_fiber_yield_locked(pool, fiber, task, SE_WORKER_GROUP_NULL);
+			continue;
+		}
+		if (se_worker_fiber_resume_ready_locked(pool)) {
+			continue;
+		}
 		if (g_se_worker_tls_pool == pool && se_worker_try_claim_task_locked(pool, &claim)) {
 			s_mutex_unlock(&pool->mutex);
 			se_worker_execute_claim(pool, &claim);
@@ -520,7 +933,7 @@ b8 se_worker_release(se_worker_pool* pool, se_worker_task task) {
 		se_set_last_error(SE_RESULT_NOT_FOUND);
 		return false;
 	}
-	if (record->state != SE_WORKER_TASK_STATE_DONE) {
+	if (record->state != SE_WORKER_TASK_STATE_DONE || record->group != SE_WORKER_GROUP_NULL) {
 		s_mutex_unlock(&pool->mutex);
 		se_set_last_error(SE_RESULT_INVALID_ARGUMENT);
 		return false;
@@ -554,6 +967,90 @@ b8 se_worker_wait_idle(se_worker_pool* pool) {
 	return true;
 }
 
+se_worker_group se_worker_submit_batch(
+	se_worker_pool* pool,
+	se_worker_task_fn fn,
+	void** user_data_array,
+	const u32 count,
+	se_worker_task* out_tasks) {
+	if (!pool || !fn || count == 0u) {
+		se_set_last_error(SE_RESULT_INVALID_ARGUMENT);
+		return SE_WORKER_GROUP_NULL;
+	}
+
+	se_worker_task* group_tasks = calloc(count, sizeof(*group_tasks));
+	if (!group_tasks) {
+		se_set_last_error(SE_RESULT_OUT_OF_MEMORY);
+		return SE_WORKER_GROUP_NULL;
+	}
+
+	se_worker_group group = SE_WORKER_GROUP_NULL;
+	s_mutex_lock(&pool->mutex);
+	const se_worker_submit_result result =
+		se_worker_submit_batch_locked(pool, fn, user_data_array, NULL, count, group_tasks, &group);
+	if (result == SE_WORKER_SUBMIT_OK && out_tasks) {
+		memcpy(out_tasks, group_tasks, sizeof(*group_tasks) * count);
+	}
+	s_mutex_unlock(&pool->mutex);
+
+	if (result != SE_WORKER_SUBMIT_OK) {
+		free(group_tasks);
+		se_set_last_error(se_worker_submit_result_to_error(result));
+		return SE_WORKER_GROUP_NULL;
+	}
+
+	se_set_last_error(SE_RESULT_OK);
+	return group;
+}
+
+b8 se_worker_wait_group(se_worker_pool* pool, se_worker_group group) {
+	if (!pool || group == SE_WORKER_GROUP_NULL) {
+		se_set_last_error(SE_RESULT_INVALID_ARGUMENT);
+		return false;
+	}
+
+	for (;;) {
+		se_worker_task_claim claim = {0};
+
+		s_mutex_lock(&pool->mutex);
+		se_worker_group_record* group_record = s_array_get(&pool->groups, group);
+		if (!group_record) {
+			s_mutex_unlock(&pool->mutex);
+			se_set_last_error(SE_RESULT_NOT_FOUND);
+			return false;
+		}
+		if (group_record->remaining == 0u) {
+			se_worker_release_group_locked(pool, group);
+			s_mutex_unlock(&pool->mutex);
+			se_set_last_error(SE_RESULT_OK);
+			return true;
+		}
+		if (g_se_worker_tls_pool == pool) {
+			const se_worker_task_record* current = s_array_get(&pool->tasks, g_se_worker_tls_task);
+			if (current && current->group == group) {
+				s_mutex_unlock(&pool->mutex);
+				se_set_last_error(SE_RESULT_UNSUPPORTED);
+				return false;
+			}
+			se_worker_fiber* fiber = se_worker_fiber_current(pool);
+			if (fiber) {
+				se_worker_fiber_yield_locked(pool, fiber, SE_WORKER_TASK_NULL, group);
+				continue;
+			}
+			if (se_worker_fiber_resume_ready_locked(pool)) {
+				continue;
+			}
+			if (se_worker_try_claim_task_locked(pool, &claim)) {
+				s_mutex_unlock(&pool->mutex);
+				se_worker_execute_claim(pool, &claim);
+				continue;
+			}
+		}
+		s_cond_wait(&pool->state_changed, &pool->mutex);
+		s_mutex_unlock(&pool->mutex);
+	}
+}
+
 b8 se_worker_parallel_for(se_worker_pool* pool, u32 count, u32 batch_size, se_worker_for_fn fn, void* user_data) {
 	if (!pool || !fn) {
 		se_set_last_error(SE_RESULT_INVALID_ARGUMENT);
@@ -583,63 +1080,66 @@ b8 se_worker_parallel_for(se_worker_pool* pool, u32 count, u32 batch_size, se_wo
 	if (target_jobs > pool->config.max_tasks) {
 		target_jobs = pool->config.max_tasks;
 	}
+	if (target_jobs > pool->config.queue_capacity) {
+		target_jobs = pool->config.queue_capacity;
+	}
 	if (target_jobs == 0u) {
 		s_mutex_destroy(&state.mutex);
 		se_set_last_error(SE_RESULT_CAPACITY_EXCEEDED);
 		return false;
 	}
 
-	se_worker_task* tasks = calloc(target_jobs, sizeof(*tasks));
-	if (!tasks) {
+	se_worker_task* group_tasks = calloc(target_jobs, sizeof(*group_tasks));
+	if (!group_tasks) {
 		s_mutex_destroy(&state.mutex);
 		se_set_last_error(SE_RESULT_OUT_OF_MEMORY);
 		return false;
 	}
 
-	u32 submitted = 0u;
-	b8 ok = true;
-	se_result failure = SE_RESULT_OK;
-
-	while (submitted < target_jobs) {
-		s_mutex_lock(&pool->mutex);
-		const se_worker_submit_result submit_result =
-			se_worker_submit_locked(pool, se_worker_parallel_for_task, &state, &tasks[submitted]);
-		s_mutex_unlock(&pool->mutex);
-
-		if (submit_result == SE_WORKER_SUBMIT_OK) {
-			submitted++;
-			continue;
+	// Jobs pull index ranges from the shared state, so any job count works; submit as many
+	// as currently fit in one batch and only block while the queue has no room at all.
+	se_worker_group group = SE_WORKER_GROUP_NULL;
+	se_worker_submit_result submit_result = SE_WORKER_SUBMIT_OK;
+	s_mutex_lock(&pool->mutex);
+	for (;;) {
+		if (!pool->running || pool->stopping) {
+			submit_result = SE_WORKER_SUBMIT_STOPPING;
+			break;
 		}
-		if (submit_result == SE_WORKER_SUBMIT_QUEUE_FULL) {
-			if (!se_worker_wait_for_queue_room(pool)) {
-				ok = false;
-				failure = SE_RESULT_UNSUPPORTED;
-				break;
-			}
+		const sz tracked_tasks = s_array_get_size(&pool->tasks);
+		if (tracked_tasks >= pool->config.max_tasks) {
+			submit_result = SE_WORKER_SUBMIT_TASKS_FULL;
+			break;
+		}
+		const u32 queue_room = pool->config.queue_capacity - pool->queue_count;
+		if (queue_room == 0u) {
+			s_cond_wait(&pool->state_changed, &pool->mutex);
 			continue;
 		}
-		if (submit_result == SE_WORKER_SUBMIT_TASKS_FULL && submitted > 0u) {
-			break;
+
+		u32 jobs = target_jobs;
+		if (jobs > queue_room) {
+			jobs = queue_room;
+		}
+		if ((sz)jobs > pool->config.max_tasks - tracked_tasks) {
+			jobs = (u32)(pool->config.max_tasks - tracked_tasks);
 		}
-		ok = false;
-		failure = se_worker_submit_result_to_error(submit_result);
+		submit_result = se_worker_submit_batch_locked(pool, se_worker_parallel_for_task, NULL, &state, jobs, group_tasks, &group);
 		break;
 	}
+	s_mutex_unlock(&pool->mutex);
 
-	for (u32 i = 0u; i < submitted; ++i) {
-		if (!se_worker_wait(pool, tasks[i], NULL) && ok) {
-			ok = false;
-			failure = se_get_last_error();
-		}
-	}
-	for (u32 i = 0u; i < submitted; ++i) {
-		if (tasks[i] != SE_WORKER_TASK_NULL && !se_worker_release(pool, tasks[i]) && ok) {
+	b8 ok = submit_result == SE_WORKER_SUBMIT_OK;
+	se_result failure = se_worker_submit_result_to_error(submit_result);
+	if (ok) {
+		if (!se_worker_wait_group(pool, group)) {
 			ok = false;
 			failure = se_get_last_error();
 		}
+	} else {
+		free(group_tasks);
 	}
 
-	free(tasks);
 	s_mutex_destroy(&state.mutex);
 
 	se_set_last_error(ok ? SE_RESULT_OK : failure);
@@ -660,10 +1160,16 @@ b8 se_worker_get_diagnostics(se_worker_pool* pool, se_worker_diagnostics* out_di
 	out_diagnostics->pending_tasks = pool->queue_count;
 	out_diagnostics->active_tasks = pool->active_tasks;
 	out_diagnostics->tracked_tasks = (u32)s_array_get_size(&pool->tasks);
+	out_diagnostics->tracked_groups = (u32)s_array_get_size(&pool->groups);
 	out_diagnostics->submitted_tasks = pool->submitted_tasks;
+	out_diagnostics->submitted_batches = pool->submitted_batches;
 	out_diagnostics->completed_tasks = pool->completed_tasks;
+	out_diagnostics->fiber_count = pool->fiber_count;
+	out_diagnostics->suspended_fibers = pool->suspended_fiber_count;
+	out_diagnostics->fiber_yields = pool->fiber_yields;
 	out_diagnostics->running = pool->running;
 	out_diagnostics->stopping = pool->stopping;
+	out_diagnostics->fibers = pool->config.use_fibers;
 	s_mutex_unlock(&pool->mutex);
 
 	se_set_last_error(SE_RESULT_OK);
@@ -6,6 +6,7 @@
 #include "se_debug.h"
 #include "se_graphics.h"
 #include "render/se_gl.h"
+#include "render/se_gl_stream.h"
 #include "window/se_android_internal.h"
 #include "window/se_window_backend_internal.h"
 
@@ -271,7 +272,9 @@ static b8 se_android_backend_make_current(const b8 allow_fallback_surface) {
 		return false;
 	}
 
-	return eglMakeCurrent(g_android.display, draw_surface, draw_surface, g_android.context) == EGL_TRUE;
+	const b8 made_current = eglMakeCurrent(g_android.display, draw_surface, draw_surface, g_android.context) == EGL_TRUE;
+	se_gl_state_cache_invalidate();
+	return made_current;
 }
 
 static b8 se_android_backend_create_fallback_surface(void) {
@@ -859,6 +862,7 @@ static void se_window_render_screen_internal(const se_window_handle window, se_w
 	se_debug_trace_begin("window_present_overlay");
 	se_debug_render_overlay(window, NULL);
 	se_debug_trace_end("window_present_overlay");
+	se_gl_stream_end_frame();
 	se_debug_trace_begin("window_present_swap");
 	se_debug_trace_begin_channel("window_present_gpu", SE_DEBUG_TRACE_CHANNEL_GPU);
 	if (g_android.surface_initialized && g_android.surface != EGL_NO_SURFACE) {
@@ -8,6 +8,7 @@
 #include "se_render_thread.h"
 #include "se_graphics.h"
 #include "render/se_gl.h"
+#include "render/se_gl_stream.h"
 #include "render/se_render_queue.h"
 #include "window/se_window_backend_internal.h"
 #include <GLFW/glfw3.h>
@@ -1594,6 +1595,7 @@ static void se_window_render_screen_internal(const se_window_handle window, se_w
 	se_debug_trace_begin("window_present_overlay");
 	se_debug_render_overlay(window, NULL);
 	se_debug_trace_end("window_present_overlay");
+	se_gl_stream_end_frame();
 	se_debug_trace_begin("window_present_swap");
 	se_debug_trace_begin_channel("window_present_gpu", SE_DEBUG_TRACE_CHANNEL_GPU);
 	glfwSwapBuffers((GLFWwindow*)window_ptr->handle);
@@ -1620,6 +1622,7 @@ void se_window_set_current_context(const se_window_handle window) {
 	se_window* window_ptr = se_window_from_handle(context, window);
 	current_conext_window = (GLFWwindow*)window_ptr->handle;
 	glfwMakeContextCurrent((GLFWwindow*)window_ptr->handle);
+	se_gl_state_cache_invalidate();
 	se_set_last_error(SE_RESULT_OK);
 }
 
@@ -18,6 +18,13 @@
 #include <termios.h>
 #include <time.h>
 #include <unistd.h>
+#if defined(SE_RENDER_BACKEND_SOFTWARE)
+#include "render/se_gl_soft.h"
+#include <limits.h>
+
+#define STB_IMAGE_WRITE_IMPLEMENTATION
+#include "stb_image_write.h"
+#endif
 
 typedef s_array(se_window_handle, se_windows_registry);
 static se_windows_registry windows_registry = {0};
@@ -60,6 +67,19 @@ typedef struct {
 	sz csi_len;
 } se_window_terminal_input_parser;
 
+#if defined(SE_RENDER_BACKEND_SOFTWARE)
+typedef struct {
+	b8 configured;
+	b8 enabled;
+	b8 captured;
+	b8 auto_exit;
+	u32 target_frame;
+	c8 output_path[PATH_MAX];
+} se_window_docs_capture_state;
+
+static se_window_docs_capture_state g_docs_capture = {0};
+#endif
+
 static se_window_terminal_io_state g_terminal_io = {0};
 static se_window_terminal_input_parser g_terminal_parser = {0};
 static volatile sig_atomic_t g_terminal_restore_emitted = 0;
@@ -301,6 +321,9 @@ static void se_window_terminal_sync_size(se_window* window_ptr) {
 	window_ptr->width = resolved_width;
 	window_ptr->height = resolved_height;
 	se_window_terminal_surface_resize(window_ptr, resolved_width, resolved_height);
+#if defined(SE_RENDER_BACKEND_SOFTWARE)
+	(void)se_gl_soft_set_surface_size(resolved_width, resolved_height);
+#endif
 }
 
 static void se_window_terminal_clear(se_window* window_ptr, const s_vec4* bg_color) {
@@ -321,6 +344,7 @@ static void se_window_terminal_clear(se_window* window_ptr, const s_vec4* bg_col
 	}
 }
 
+#if !defined(SE_RENDER_BACKEND_SOFTWARE)
 static b8 se_window_terminal_surface_is_blank(const se_window_terminal_surface* surface) {
 	if (!surface) {
 		return true;
@@ -393,12 +417,39 @@ static void se_window_terminal_overlay_blank_surface_hint(se_window_terminal_sur
 		se_window_terminal_surface_write_text(surface, start_row + i, start_column, lines[i], &fg, &bg);
 	}
 }
+#else
+// One framebuffer pixel per cell; framebuffer rows run bottom-up, cell rows top-down.
+static void se_window_terminal_copy_software_surface(se_window_terminal_surface* surface) {
+	u32 width = 0u;
+	u32 height = 0u;
+	const u8* pixels = se_gl_soft_surface_pixels(&width, &height);
+	if (!pixels || width != surface->columns || height != surface->rows) {
+		return;
+	}
+	for (u32 row = 0; row < surface->rows; ++row) {
+		const u8* source = pixels + (sz)(height - 1u - row) * width * 4u;
+		for (u32 column = 0; column < surface->columns; ++column) {
+			const u32 index = row * surface->columns + column;
+			se_window_terminal_cell* cell = s_array_get(&surface->cells, s_array_handle(&surface->cells, index));
+			if (!cell) {
+				continue;
+			}
+			const u8* texel = source + (sz)column * 4u;
+			cell->glyph = ' ';
+			cell->bg_color = s_vec4(texel[0] / 255.0f, texel[1] / 255.0f, texel[2] / 255.0f, 1.0f);
+		}
+	}
+}
+#endif
 
 static void se_window_terminal_present(se_window* window_ptr) {
 	se_window_terminal_surface* surface = se_window_terminal_surface_get_or_create(window_ptr);
 	if (!surface) {
 		return;
 	}
+#if defined(SE_RENDER_BACKEND_SOFTWARE)
+	se_window_terminal_copy_software_surface(surface);
+#else
 	if (se_window_terminal_surface_is_blank(surface)) {
 		surface->blank_frame_count++;
 		if (surface->blank_frame_count >= 2u) {
@@ -407,6 +458,7 @@ static void se_window_terminal_present(se_window* window_ptr) {
 	} else {
 		surface->blank_frame_count = 0u;
 	}
+#endif
 	if (!surface->present_initialized) {
 		fputs("\033[2J", stdout);
 		surface->present_initialized = true;
@@ -468,6 +520,148 @@ static void se_window_terminal_present(se_window* window_ptr) {
 	fflush(stdout);
 }
 
+#if defined(SE_RENDER_BACKEND_SOFTWARE)
+static b8 se_window_string_equal_ci(const c8* lhs, const c8* rhs) {
+	if (!lhs || !rhs) {
+		return false;
+	}
+	while (*lhs && *rhs) {
+		if (tolower((unsigned char)*lhs) != tolower((unsigned char)*rhs)) {
+			return false;
+		}
+		++lhs;
+		++rhs;
+	}
+	return *lhs == '\0' && *rhs == '\0';
+}
+
+static b8 se_window_env_flag_value(const c8* key, const b8 fallback) {
+	const c8* value = getenv(key);
+	if (!value || value[0] == '\0') {
+		return fallback;
+	}
+	if (strcmp(value, "0") == 0 ||
+		se_window_string_equal_ci(value, "false") ||
+		se_window_string_equal_ci(value, "off") ||
+		se_window_string_equal_ci(value, "no")) {
+		return false;
+	}
+	return true;
+}
+
+static u32 se_window_env_u32(const c8* key, const u32 fallback, const u32 min_value, const u32 max_value) {
+	const c8* value = getenv(key);
+	if (!value || value[0] == '\0') {
+		return fallback;
+	}
+	errno = 0;
+	c8* end_ptr = NULL;
+	unsigned long parsed = strtoul(value, &end_ptr, 10);
+	if (errno != 0 || end_ptr == value || (end_ptr && *end_ptr != '\0')) {
+		return fallback;
+	}
+	if (parsed < min_value) {
+		return min_value;
+	}
+	if (parsed > max_value) {
+		return max_value;
+	}
+	return (u32)parsed;
+}
+
+static void se_window_docs_capture_configure(void) {
+	if (g_docs_capture.configured) {
+		return;
+	}
+	memset(&g_docs_capture, 0, sizeof(g_docs_capture));
+	g_docs_capture.configured = true;
+
+	const c8* output_path = getenv("SE_DOCS_CAPTURE_PATH");
+	if (!output_path || output_path[0] == '\0') {
+		return;
+	}
+	if (strlen(output_path) >= sizeof(g_docs_capture.output_path)) {
+		se_debug_log(
+			SE_DEBUG_LEVEL_WARN,
+			SE_DEBUG_CATEGORY_WINDOW,
+			"se_window_docs_capture_configure :: capture path too long");
+		return;
+	}
+
+	snprintf(g_docs_capture.output_path, sizeof(g_docs_capture.output_path), "%s", output_path);
+	g_docs_capture.target_frame = se_window_env_u32("SE_DOCS_CAPTURE_FRAME", 20u, 1u, 10000u);
+	g_docs_capture.auto_exit = se_window_env_flag_value("SE_DOCS_CAPTURE_EXIT", true);
+	g_docs_capture.enabled = true;
+}
+
+// Writes the software framebuffer at full precision, so captures work as golden images.
+static void se_window_docs_capture_present(se_window* window_ptr) {
+	if (!g_docs_capture.enabled || g_docs_capture.captured || !window_ptr) {
+		return;
+	}
+	if (window_ptr->frame_count < (u64)g_docs_capture.target_frame) {
+		return;
+	}
+
+	u32 fb_width = 0u;
+	u32 fb_height = 0u;
+	const u8* source = se_gl_soft_surface_pixels(&fb_width, &fb_height);
+	if (!source || fb_width == 0u || fb_height == 0u) {
+		return;
+	}
+
+	const sz row_stride = (sz)fb_width * 3;
+	u8* pixels = malloc(row_stride * (sz)fb_height);
+	if (!pixels) {
+		g_docs_capture.captured = true;
+		se_debug_log(
+			SE_DEBUG_LEVEL_WARN,
+			SE_DEBUG_CATEGORY_WINDOW,
+			"se_window_docs_capture_present :: failed to allocate pixel buffer");
+		return;
+	}
+	for (u32 y = 0; y < fb_height; ++y) {
+		const u8* source_row = source + (sz)(fb_height - 1u - y) * fb_width * 4u;
+		u8* row = pixels + (sz)y * row_stride;
+		for (u32 x = 0; x < fb_width; ++x) {
+			row[x * 3u + 0u] = source_row[x * 4u + 0u];
+			row[x * 3u + 1u] = source_row[x * 4u + 1u];
+			row[x * 3u + 2u] = source_row[x * 4u + 2u];
+		}
+	}
+
+	const i32 write_result = stbi_write_png(
+		g_docs_capture.output_path,
+		(i32)fb_width,
+		(i32)fb_height,
+		3,
+		pixels,
+		(i32)row_stride);
+
+	free(pixels);
+	g_docs_capture.captured = true;
+
+	if (write_result != 0) {
+		se_debug_log(
+			SE_DEBUG_LEVEL_INFO,
+			SE_DEBUG_CATEGORY_WINDOW,
+			"se_window_docs_capture_present :: wrote %s (frame=%llu)",
+			g_docs_capture.output_path,
+			(unsigned long long)window_ptr->frame_count);
+	} else {
+		se_debug_log(
+			SE_DEBUG_LEVEL_WARN,
+			SE_DEBUG_CATEGORY_WINDOW,
+			"se_window_docs_capture_present :: failed to write %s",
+			g_docs_capture.output_path);
+	}
+
+	if (g_docs_capture.auto_exit) {
+		window_ptr->should_close = true;
+	}
+}
+#endif
+
 static void se_window_terminal_shutdown_surface(se_window* window_ptr) {
 	if (!window_ptr || !window_ptr->handle) {
 		return;
@@ -829,7 +1023,12 @@ se_window_handle se_window_create(const char* title, const u32 width, const u32
 		s_array_init(&windows_registry);
 	}
 	s_array_add(&windows_registry, window_handle);
-	if (!se_render_init()) {
+	b8 render_ready = se_render_init();
+#if defined(SE_RENDER_BACKEND_SOFTWARE)
+	render_ready = render_ready && se_gl_soft_set_surface_size(new_window->width, new_window->height);
+	se_window_docs_capture_configure();
+#endif
+	if (!render_ready) {
 		s_array_remove(&windows_registry, s_array_handle(&windows_registry, (u32)(s_array_get_size(&windows_registry) - 1)));
 		s_array_remove(&context->windows, window_handle);
 		se_set_last_error(SE_RESULT_BACKEND_FAILURE);
@@ -926,6 +1125,9 @@ void se_window_render_screen(const se_window_handle window) {
 	se_debug_trace_begin("window_present_terminal");
 	se_window_terminal_present(window_ptr);
 	se_debug_trace_end("window_present_terminal");
+#if defined(SE_RENDER_BACKEND_SOFTWARE)
+	se_window_docs_capture_present(window_ptr);
+#endif
 	window_ptr->diagnostics.frames_presented++;
 	window_ptr->diagnostics.last_present_duration = s_max(0.0, se_window_terminal_now_seconds() - present_begin);
 	se_debug_trace_end("window_present");
@@ -0,0 +1,79 @@
+// Syphax-Engine - Ougi Washi
+
+#include "se_render_thread.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Replays a render queue capture and prints one line per command type.
+// Build with SE_BACKEND_PLATFORM=terminal to run headless; --no-timing keeps the output diffable.
+static int se_render_replay_compare(const void* a, const void* b) {
+	const se_render_thread_capture_command_stats* lhs = (const se_render_thread_capture_command_stats*)a;
+	const se_render_thread_capture_command_stats* rhs = (const se_render_thread_capture_command_stats*)b;
+	if (lhs->count != rhs->count) {
+		return lhs->count > rhs->count ? -1 : 1;
+	}
+	return strcmp(lhs->name, rhs->name);
+}
+
+int main(int argc, char** argv) {
+	const c8* path = NULL;
+	u32 iterations = 1u;
+	b8 timing = true;
+	for (int i = 1; i < argc; ++i) {
+		if (strcmp(argv[i], "--iterations") == 0 && i + 1 < argc) {
+			iterations = (u32)strtoul(argv[++i], NULL, 10);
+		} else if (strcmp(argv[i], "--no-timing") == 0) {
+			timing = false;
+		} else {
+			path = argv[i];
+		}
+	}
+	if (!path) {
+		printf("usage: se_render_replay [--iterations N] [--no-timing] capture.bin\n");
+		return 2;
+	}
+
+	se_context* context = se_context_create();
+	se_render_thread_capture_report* report = (se_render_thread_capture_report*)calloc(1u, sizeof(*report));
+	if (!report || !se_render_thread_replay_capture(path, iterations, report)) {
+		printf("se_render_replay :: replay failed (%s)\n", se_result_str(se_get_last_error()));
+		free(report);
+		se_context_destroy(context);
+		return 1;
+	}
+
+	printf("frames %u commands %llu payload_bytes %llu blob_bytes %llu skipped %llu rejected %llu\n",
+		report->frame_count,
+		(unsigned long long)report->command_count,
+		(unsigned long long)report->payload_bytes,
+		(unsigned long long)report->blob_bytes,
+		(unsigned long long)report->skipped_commands,
+		(unsigned long long)report->rejected_commands);
+	if (timing) {
+		printf("iterations %u replay_ms %.3f captured_execute_ms %.3f\n",
+			report->iterations,
+			report->total_ms,
+			report->captured_execute_ms);
+	}
+
+	qsort(report->command_types, report->command_type_count, sizeof(report->command_types[0]), se_render_replay_compare);
+	for (u32 i = 0u; i < report->command_type_count; ++i) {
+		const se_render_thread_capture_command_stats* stats = &report->command_types[i];
+		const u64 count = stats->count / report->iterations;
+		printf("%-40s count %8llu payload %10llu blob %10llu",
+			stats->name,
+			(unsigned long long)count,
+			(unsigned long long)stats->payload_bytes,
+			(unsigned long long)stats->blob_bytes);
+		if (timing && stats->count > 0u) {
+			printf(" avg_us %9.3f max_us %9.3f", stats->total_ms * 1000.0 / (f64)stats->count, stats->max_ms * 1000.0);
+		}
+		printf("\n");
+	}
+
+	free(report);
+	se_context_destroy(context);
+	return 0;
+}